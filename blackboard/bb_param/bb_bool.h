@@ -21,6 +21,9 @@ protected:
 	static void _bind_methods() {}
 
 	virtual Variant::Type get_type() const override { return Variant::BOOL; }
+
+public:
+	_FORCE_INLINE_ bool get_bool(const Ref<Blackboard> &p_blackboard) { return get_typed<bool>(p_blackboard); }
 };
 
 #endif // BB_BOOL_H
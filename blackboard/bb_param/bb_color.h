@@ -21,6 +21,9 @@ protected:
 	static void _bind_methods() {}
 
 	virtual Variant::Type get_type() const override { return Variant::COLOR; }
+
+public:
+	_FORCE_INLINE_ Color get_color(const Ref<Blackboard> &p_blackboard) { return get_typed<Color>(p_blackboard); }
 };
 
 #endif // BB_COLOR_H
@@ -21,6 +21,9 @@ protected:
 	static void _bind_methods() {}
 
 	virtual Variant::Type get_type() const override { return Variant::FLOAT; }
+
+public:
+	_FORCE_INLINE_ double get_float(const Ref<Blackboard> &p_blackboard) { return get_typed<double>(p_blackboard); }
 };
 
 #endif // BB_FLOAT_H
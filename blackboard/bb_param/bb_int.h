@@ -21,6 +21,9 @@ protected:
 	static void _bind_methods() {}
 
 	virtual Variant::Type get_type() const override { return Variant::INT; }
+
+public:
+	_FORCE_INLINE_ int64_t get_int(const Ref<Blackboard> &p_blackboard) { return get_typed<int64_t>(p_blackboard); }
 };
 
 #endif // BB_INT_H
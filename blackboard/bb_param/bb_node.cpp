@@ -11,19 +11,53 @@
 
 #include "bb_node.h"
 
+#include "../../util/limbo_compat.h"
+
+Node *BBNode::_get_node(Node *p_scene_root, const NodePath &p_path) {
+	const uint64_t root_id = uint64_t(p_scene_root->get_instance_id());
+	if (cached_node_id != 0 && cached_root_id == root_id && cached_path == p_path) {
+		Node *node = Object::cast_to<Node>(OBJECT_DB_GET_INSTANCE(cached_node_id));
+		// A node removed from the tree may have been replaced at the same path.
+		if (node && (node->is_inside_tree() || !p_scene_root->is_inside_tree())) {
+			return node;
+		}
+	}
+	Node *node = p_scene_root->get_node_or_null(p_path);
+	// Failed lookups are not cached - the node may be added later.
+	cached_root_id = root_id;
+	cached_path = p_path;
+	cached_node_id = node ? uint64_t(node->get_instance_id()) : 0;
+	return node;
+}
+
+bool BBNode::resolves_node_path(const Ref<Blackboard> &p_blackboard) const {
+	if (get_value_source() == SAVED_VALUE) {
+		return get_saved_value().get_type() == Variant::NODE_PATH;
+	}
+	// * Unknown until the variable exists - assume the worst.
+	if (p_blackboard.is_null() || !p_blackboard->has_var(get_variable())) {
+		return true;
+	}
+	return p_blackboard->get_var(get_variable(), Variant(), false).get_type() == Variant::NODE_PATH;
+}
+
 Variant BBNode::get_value(Node *p_scene_root, const Ref<Blackboard> &p_blackboard, const Variant &p_default) {
-	ERR_FAIL_NULL_V_MSG(p_scene_root, Variant(), "BBNode: get_value() failed - scene_root is null.");
 	ERR_FAIL_NULL_V_MSG(p_blackboard, Variant(), "BBNode: get_value() failed - blackboard is null.");
 
 	Variant val;
 	if (get_value_source() == SAVED_VALUE) {
 		val = get_saved_value();
 	} else {
-		val = p_blackboard->get_var(get_variable(), p_default);
+		// * Uses the cached handle of the parameter, rather than hashing the name on every call.
+		const Variant *value = _get_value_ptr(p_blackboard);
+		LIMBO_ERR_FAIL_NULL_V_MSG(value, p_default, vformat("BBNode: Blackboard variable \"%s\" doesn't exist.", get_variable()));
+		val = *value;
 	}
 
 	if (val.get_type() == Variant::NODE_PATH) {
-		return p_scene_root->get_node_or_null(val);
+		// * Objects stored in the blackboard don't need a scene root, e.g. in headless instances.
+		ERR_FAIL_NULL_V_MSG(p_scene_root, Variant(), "BBNode: get_value() failed - scene_root is null.");
+		return _get_node(p_scene_root, val);
 	} else if (val.get_type() == Variant::OBJECT || val.get_type() == Variant::NIL) {
 		return val;
 	} else {
@@ -17,12 +17,24 @@
 class BBNode : public BBParam {
 	GDCLASS(BBNode, BBParam);
 
+private:
+	// Last resolved node path: kept while the node is alive and the same scene root and path are requested.
+	uint64_t cached_root_id = 0;
+	NodePath cached_path;
+	uint64_t cached_node_id = 0;
+
+	Node *_get_node(Node *p_scene_root, const NodePath &p_path);
+
 protected:
 	static void _bind_methods() {}
 
 public:
 	virtual Variant::Type get_type() const override { return Variant::NODE_PATH; }
+	// * Resolved nodes are cached for any value source.
+	virtual bool has_read_cache() const override { return true; }
 	virtual Variant get_value(Node *p_scene_root, const Ref<Blackboard> &p_blackboard, const Variant &p_default = Variant()) override;
+	// True if get_value() would look up a node path in the scene tree, which is only allowed on the main thread.
+	bool resolves_node_path(const Ref<Blackboard> &p_blackboard) const;
 };
 
 #endif // BB_NODE_H
@@ -29,7 +29,7 @@ void BBParam::set_value_source(ValueSource p_value) {
 	emit_changed();
 }
 
-Variant BBParam::get_saved_value() {
+Variant BBParam::get_saved_value() const {
 	return saved_value;
 }
 
@@ -75,18 +75,43 @@ String BBParam::_to_string() {
 	}
 }
 
-Variant BBParam::get_value(Node *p_scene_root, const Ref<Blackboard> &p_blackboard, const Variant &p_default) {
-	ERR_FAIL_COND_V(!p_blackboard.is_valid(), p_default);
-
+const Variant *BBParam::_get_value_ptr(const Ref<Blackboard> &p_blackboard) {
 	if (value_source == SAVED_VALUE) {
-		if (saved_value == Variant()) {
+		if (unlikely(saved_value.get_type() == Variant::NIL)) {
 			_assign_default_value();
 		}
-		return saved_value;
-	} else {
-		ERR_FAIL_COND_V_MSG(!p_blackboard->has_var(variable), p_default, vformat("BBParam: Blackboard variable \"%s\" doesn't exist.", variable));
-		return p_blackboard->get_var(variable, p_default);
+		return &saved_value;
+	}
+
+	ERR_FAIL_COND_V(!p_blackboard.is_valid(), nullptr);
+	const uint64_t blackboard_id = uint64_t(p_blackboard->get_instance_id());
+	if (unlikely(blackboard_id != cached_blackboard_id || var_handle.name != variable)) {
+		// Handles are only valid for the blackboard they were resolved with.
+		cached_blackboard_id = blackboard_id;
+		var_handle = BBVarHandle();
+		var_handle.name = variable;
+		cached_version = -1;
 	}
+	const int64_t version = p_blackboard->get_var_version(var_handle);
+	if (likely(version != -1 && version == cached_version && var_handle.epoch == cached_epoch)) {
+		return &cached_value;
+	}
+	// Version is -1 for a missing variable, and also for a bound one, which has to be read every time.
+	if (!p_blackboard->try_get_var_by_handle(var_handle, cached_value)) {
+		cached_version = -1;
+		cached_value = Variant();
+		return nullptr;
+	}
+	cached_version = version;
+	cached_epoch = var_handle.epoch;
+	return &cached_value;
+}
+
+Variant BBParam::get_value(Node *p_scene_root, const Ref<Blackboard> &p_blackboard, const Variant &p_default) {
+	ERR_FAIL_COND_V(!p_blackboard.is_valid(), p_default);
+	const Variant *value = _get_value_ptr(p_blackboard);
+	LIMBO_ERR_FAIL_NULL_V_MSG(value, p_default, vformat("BBParam: Blackboard variable \"%s\" doesn't exist.", variable));
+	return *value;
 }
 
 void BBParam::_get_property_list(List<PropertyInfo> *p_list) const {
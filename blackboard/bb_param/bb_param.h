@@ -13,6 +13,7 @@
 #define BB_PARAM_H
 
 #include "../../blackboard/blackboard.h"
+#include "../../util/limbo_error_reporter.h"
 #include "../../util/limbo_utility.h"
 
 #ifdef LIMBOAI_MODULE
@@ -37,6 +38,13 @@ private:
 	Variant saved_value;
 	StringName variable;
 
+	// Last value read from the blackboard variable - reused while the variable version stays the same.
+	BBVarHandle var_handle;
+	uint64_t cached_blackboard_id = 0;
+	uint64_t cached_epoch = 0;
+	int64_t cached_version = -1;
+	Variant cached_value;
+
 	_FORCE_INLINE_ void _update_name() {
 		set_name((value_source == SAVED_VALUE) ? String(saved_value) : LimboUtility::get_singleton()->decorate_var(variable));
 	}
@@ -48,16 +56,23 @@ protected:
 
 	void _get_property_list(List<PropertyInfo> *p_list) const;
 
+	// Returns the saved value or the blackboard variable without copying it, or nullptr if the variable doesn't exist.
+	const Variant *_get_value_ptr(const Ref<Blackboard> &p_blackboard);
+
 public:
 	void set_value_source(ValueSource p_value);
 	ValueSource get_value_source() const { return value_source; }
 
 	void set_saved_value(Variant p_value);
-	Variant get_saved_value();
+	Variant get_saved_value() const;
 
 	void set_variable(const StringName &p_variable);
 	StringName get_variable() const { return variable; }
 
+	// True if reads keep a cache on the parameter itself. Runtime clones of tasks get their own copy of such
+	// parameters (see BTTask::clone()), the others are shared.
+	virtual bool has_read_cache() const { return value_source == BLACKBOARD_VAR; }
+
 #ifdef LIMBOAI_MODULE
 	virtual String to_string() override;
 #elif LIMBOAI_GDEXTENSION
@@ -68,6 +83,15 @@ public:
 	virtual Variant::Type get_variable_expected_type() const { return get_type(); }
 	virtual Variant get_value(Node *p_scene_root, const Ref<Blackboard> &p_blackboard, const Variant &p_default = Variant());
 
+	// Native typed access, e.g. get_typed<double>(bb): converts the value in place instead of returning a Variant.
+	// Not valid for BBNode, which resolves node paths in get_value().
+	template <typename T>
+	T get_typed(const Ref<Blackboard> &p_blackboard, const T &p_default = T()) {
+		const Variant *value = _get_value_ptr(p_blackboard);
+		LIMBO_ERR_FAIL_NULL_V_MSG(value, p_default, vformat("BBParam: Blackboard variable \"%s\" doesn't exist.", variable));
+		return *value;
+	}
+
 	BBParam();
 };
 
@@ -21,6 +21,9 @@ protected:
 	static void _bind_methods() {}
 
 	virtual Variant::Type get_type() const override { return Variant::STRING; }
+
+public:
+	_FORCE_INLINE_ String get_string(const Ref<Blackboard> &p_blackboard) { return get_typed<String>(p_blackboard); }
 };
 
 #endif // BB_STRING_H
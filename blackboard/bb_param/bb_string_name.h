@@ -21,6 +21,9 @@ protected:
 	static void _bind_methods() {}
 
 	virtual Variant::Type get_type() const override { return Variant::STRING_NAME; }
+
+public:
+	_FORCE_INLINE_ StringName get_string_name(const Ref<Blackboard> &p_blackboard) { return get_typed<StringName>(p_blackboard); }
 };
 
 #endif // BB_STRING_H
@@ -21,6 +21,9 @@ protected:
 	static void _bind_methods() {}
 
 	virtual Variant::Type get_type() const override { return Variant::VECTOR2; }
+
+public:
+	_FORCE_INLINE_ Vector2 get_vector2(const Ref<Blackboard> &p_blackboard) { return get_typed<Vector2>(p_blackboard); }
 };
 
 #endif // BB_VECTOR2_H
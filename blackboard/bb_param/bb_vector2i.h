@@ -21,6 +21,9 @@ protected:
 	static void _bind_methods() {}
 
 	virtual Variant::Type get_type() const override { return Variant::VECTOR2I; }
+
+public:
+	_FORCE_INLINE_ Vector2i get_vector2i(const Ref<Blackboard> &p_blackboard) { return get_typed<Vector2i>(p_blackboard); }
 };
 
 #endif // BB_VECTOR2I_H
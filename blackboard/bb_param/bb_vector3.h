@@ -21,6 +21,9 @@ protected:
 	static void _bind_methods() {}
 
 	virtual Variant::Type get_type() const override { return Variant::VECTOR3; }
+
+public:
+	_FORCE_INLINE_ Vector3 get_vector3(const Ref<Blackboard> &p_blackboard) { return get_typed<Vector3>(p_blackboard); }
 };
 
 #endif // BB_VECTOR3_H
@@ -21,6 +21,9 @@ protected:
 	static void _bind_methods() {}
 
 	virtual Variant::Type get_type() const override { return Variant::VECTOR3I; }
+
+public:
+	_FORCE_INLINE_ Vector3i get_vector3i(const Ref<Blackboard> &p_blackboard) { return get_typed<Vector3i>(p_blackboard); }
 };
 
 #endif // BB_VECTOR3I_H
@@ -21,6 +21,9 @@ protected:
 	static void _bind_methods() {}
 
 	virtual Variant::Type get_type() const override { return Variant::VECTOR4; }
+
+public:
+	_FORCE_INLINE_ Vector4 get_vector4(const Ref<Blackboard> &p_blackboard) { return get_typed<Vector4>(p_blackboard); }
 };
 
 #endif // BB_VECTOR4_H
@@ -0,0 +1,67 @@
+/**
+ * bb_typed_var.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef BB_TYPED_VAR_H
+#define BB_TYPED_VAR_H
+
+#include "blackboard.h"
+
+// Typed blackboard variable for native tasks. Keep it as a task member, resolve it in _setup(), and read
+// or write the variable with get()/set() in _tick() - hashing the name only when the blackboard changes structure.
+//
+//     BBTypedVar<double> speed;
+//     void _setup() override { speed.resolve(get_blackboard(), "speed"); }
+//     Status _tick(double p_delta) override { position += speed.get(get_blackboard()) * p_delta; ... }
+//
+// Handles are resolved against a specific blackboard: always pass the blackboard of the task owning the member.
+template <typename T>
+class BBTypedVar {
+private:
+	BBVarHandle handle;
+
+public:
+	_FORCE_INLINE_ StringName get_name() const { return handle.name; }
+
+	// Returns false if the variable doesn't exist yet (it is looked up again on each access until it does).
+	bool resolve(const Ref<Blackboard> &p_blackboard, const StringName &p_name) {
+		ERR_FAIL_COND_V(p_blackboard.is_null(), false);
+		handle = p_blackboard->get_var_handle(p_name);
+		return handle.depth >= 0;
+	}
+
+	_FORCE_INLINE_ bool exists(const Ref<Blackboard> &p_blackboard) {
+		return p_blackboard->has_var_by_handle(handle);
+	}
+
+	// Converts the stored Variant in place: one lookup, and no Variant copy unless the variable is bound to a property.
+	_FORCE_INLINE_ T get(const Ref<Blackboard> &p_blackboard, const T &p_default = T()) {
+		const BBVariable *var = p_blackboard->get_variable_by_handle(handle);
+		if (unlikely(var == nullptr)) {
+			return p_default;
+		}
+		const Variant *value = var->get_value_ptr();
+		if (likely(value != nullptr)) {
+			return *value;
+		}
+		return var->get_value();
+	}
+
+	_FORCE_INLINE_ void set(const Ref<Blackboard> &p_blackboard, const T &p_value) {
+		p_blackboard->set_var_by_handle(handle, p_value);
+	}
+
+	// See Blackboard::get_var_version(): lets a task skip work while its input is unchanged.
+	_FORCE_INLINE_ int64_t get_version(const Ref<Blackboard> &p_blackboard) {
+		return p_blackboard->get_var_version(handle);
+	}
+};
+
+#endif // BB_TYPED_VAR_H
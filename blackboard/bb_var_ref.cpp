@@ -0,0 +1,48 @@
+/**
+ * bb_var_ref.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "bb_var_ref.h"
+
+void BBVarRef::setup(const Ref<Blackboard> &p_blackboard, const StringName &p_name) {
+	blackboard = p_blackboard;
+	handle = p_blackboard.is_valid() ? p_blackboard->get_var_handle(p_name) : BBVarHandle();
+	handle.name = p_name;
+}
+
+Variant BBVarRef::get_value() const {
+	ERR_FAIL_COND_V_MSG(blackboard.is_null(), Variant(), "BBVarRef: Not bound to a blackboard.");
+	return blackboard->get_var_by_handle(handle, Variant());
+}
+
+void BBVarRef::set_value(const Variant &p_value) {
+	ERR_FAIL_COND_MSG(blackboard.is_null(), "BBVarRef: Not bound to a blackboard.");
+	blackboard->set_var_by_handle(handle, p_value);
+}
+
+bool BBVarRef::exists() const {
+	return blackboard.is_valid() && blackboard->has_var_by_handle(handle);
+}
+
+int64_t BBVarRef::get_version() const {
+	return blackboard.is_valid() ? blackboard->get_var_version(handle) : -1;
+}
+
+void BBVarRef::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("get_var_name"), &BBVarRef::get_var_name);
+	ClassDB::bind_method(D_METHOD("get_blackboard"), &BBVarRef::get_blackboard);
+	ClassDB::bind_method(D_METHOD("get_value"), &BBVarRef::get_value);
+	ClassDB::bind_method(D_METHOD("set_value", "value"), &BBVarRef::set_value);
+	ClassDB::bind_method(D_METHOD("exists"), &BBVarRef::exists);
+	ClassDB::bind_method(D_METHOD("get_version"), &BBVarRef::get_version);
+
+	ADD_PROPERTY(PropertyInfo(Variant::NIL, "value", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NIL_IS_VARIANT), "set_value", "get_value");
+	ADD_PROPERTY(PropertyInfo(Variant::STRING_NAME, "var_name", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NONE), "", "get_var_name");
+}
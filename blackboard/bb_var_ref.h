@@ -0,0 +1,55 @@
+/**
+ * bb_var_ref.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef BB_VAR_REF_H
+#define BB_VAR_REF_H
+
+#include "blackboard.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/object/ref_counted.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/ref_counted.hpp>
+using namespace godot;
+#endif // LIMBOAI_GDEXTENSION
+
+// Reference to a blackboard variable for scripts, holding a resolved BBVarHandle.
+// Fetched once, e.g. in _setup(), it reads and writes the variable without hashing its name or walking the scopes.
+class BBVarRef : public RefCounted {
+	GDCLASS(BBVarRef, RefCounted);
+
+private:
+	Ref<Blackboard> blackboard;
+	// Re-resolved by the blackboard when its scopes change, also from const accessors.
+	mutable BBVarHandle handle;
+
+protected:
+	static void _bind_methods();
+
+#ifdef LIMBOAI_GDEXTENSION
+	String _to_string() const { return "<" + get_class() + "#" + itos(get_instance_id()) + ">"; }
+#endif
+
+public:
+	void setup(const Ref<Blackboard> &p_blackboard, const StringName &p_name);
+
+	StringName get_var_name() const { return handle.name; }
+	Ref<Blackboard> get_blackboard() const { return blackboard; }
+
+	Variant get_value() const;
+	void set_value(const Variant &p_value);
+	bool exists() const;
+	int64_t get_version() const;
+};
+
+#endif // BB_VAR_REF_H
@@ -15,25 +15,55 @@
 
 void BBVariable::unref() {
 	if (data && data->refcount.unref()) {
-		memdelete(data);
+		if (data->block_refcount) {
+			// Block memory is released together with the last variable in it.
+			SafeRefCount *block_refcount = data->block_refcount;
+			data->~Data();
+			if (block_refcount->unref()) {
+				block_refcount->~SafeRefCount();
+				memfree(block_refcount);
+			}
+		} else {
+			memdelete(data);
+		}
 	}
 	data = nullptr;
 }
 
-void BBVariable::set_value(const Variant &p_value) {
+void BBVariable::_set_bound_value(const Variant &p_value) {
+	Object *obj = OBJECT_DB_GET_INSTANCE(data->bound_object);
+	ERR_FAIL_COND_MSG(!obj, "Blackboard: Failed to get bound object.");
+	ERR_FAIL_COND_MSG(!data->bound_property.set(obj, p_value), vformat("Blackboard: Failed to set bound property `%s` on %s", data->bound_property.get_property(), obj));
+}
+
+void BBVariable::set_value(const Variant &p_value, bool p_notify) {
 	data->value = p_value; // Setting value even when bound as a fallback in case the binding fails.
 	data->value_changed = true;
+	data->version += 1;
 
 	if (is_bound()) {
-		Object *obj = OBJECT_DB_GET_INSTANCE(data->bound_object);
-		ERR_FAIL_COND_MSG(!obj, "Blackboard: Failed to get bound object.");
-#ifdef LIMBOAI_MODULE
-		bool r_valid;
-		obj->set(data->bound_property, p_value, &r_valid);
-		ERR_FAIL_COND_MSG(!r_valid, vformat("Blackboard: Failed to set bound property `%s` on %s", data->bound_property, obj));
-#elif LIMBOAI_GDEXTENSION
-		obj->set(data->bound_property, p_value);
-#endif
+		_set_bound_value(p_value);
+	}
+
+	if (unlikely(data->listeners != nullptr) && p_notify) {
+		// Iterating over a copy, so that listeners can unsubscribe in the callback.
+		const LocalVector<Callable> listeners = *data->listeners;
+		for (const Callable &listener : listeners) {
+			listener.call(p_value);
+		}
+	}
+}
+
+void BBVariable::notify_value_changed() {
+	data->value_changed = true;
+	data->version += 1;
+
+	if (unlikely(data->listeners != nullptr)) {
+		const LocalVector<Callable> listeners = *data->listeners;
+		const Variant value = data->value;
+		for (const Callable &listener : listeners) {
+			listener.call(value);
+		}
 	}
 }
 
@@ -41,18 +71,26 @@ Variant BBVariable::get_value() const {
 	if (is_bound()) {
 		Object *obj = OBJECT_DB_GET_INSTANCE(data->bound_object);
 		ERR_FAIL_COND_V_MSG(!obj, data->value, "Blackboard: Failed to get bound object.");
-#ifdef LIMBOAI_MODULE
-		bool r_valid;
-		Variant ret = obj->get(data->bound_property, &r_valid);
-		ERR_FAIL_COND_V_MSG(!r_valid, data->value, vformat("Blackboard: Failed to get bound property `%s` on %s", data->bound_property, obj));
-#elif LIMBOAI_GDEXTENSION
-		Variant ret = obj->get(data->bound_property);
-#endif
+		Variant ret;
+		ERR_FAIL_COND_V_MSG(!data->bound_property.get(obj, ret), data->value, vformat("Blackboard: Failed to get bound property `%s` on %s", data->bound_property.get_property(), obj));
 		return ret;
 	}
 	return data->value;
 }
 
+void BBVariable::add_listener(const Callable &p_callable) {
+	ERR_FAIL_COND(!p_callable.is_valid());
+	if (data->listeners == nullptr) {
+		data->listeners = memnew(LocalVector<Callable>);
+	}
+	data->listeners->push_back(p_callable);
+}
+
+void BBVariable::remove_listener(const Callable &p_callable) {
+	ERR_FAIL_NULL(data->listeners);
+	data->listeners->erase(p_callable);
+}
+
 void BBVariable::set_type(Variant::Type p_type) {
 	data->type = p_type;
 	data->value = VARIANT_DEFAULT(p_type);
@@ -62,46 +100,170 @@ Variant::Type BBVariable::get_type() const {
 	return data->type;
 }
 
+BBVariable::EditorInfo *BBVariable::_get_editor_info() {
+	if (data->editor_info == nullptr) {
+		data->editor_info = memnew(EditorInfo);
+	}
+	return data->editor_info;
+}
+
 void BBVariable::set_hint(PropertyHint p_hint) {
-	data->hint = p_hint;
+	if (p_hint != PROPERTY_HINT_NONE || data->editor_info) {
+		_get_editor_info()->hint = p_hint;
+	}
 }
 
 PropertyHint BBVariable::get_hint() const {
-	return data->hint;
+	return data->editor_info ? data->editor_info->hint : PROPERTY_HINT_NONE;
 }
 
 void BBVariable::set_hint_string(const String &p_hint_string) {
-	data->hint_string = p_hint_string;
+	if (!p_hint_string.is_empty() || data->editor_info) {
+		_get_editor_info()->hint_string = p_hint_string;
+	}
 }
 
 String BBVariable::get_hint_string() const {
-	return data->hint_string;
+	return data->editor_info ? data->editor_info->hint_string : String();
 }
 
-BBVariable BBVariable::duplicate(bool p_deep) const {
-	BBVariable var;
-	var.data->hint = data->hint;
-	var.data->hint_string = data->hint_string;
-	var.data->type = data->type;
-	if (p_deep) {
-		var.data->value = data->value.duplicate(p_deep);
+void BBVariable::set_binding_path(const NodePath &p_binding_path) {
+	if (!p_binding_path.is_empty() || data->editor_info) {
+		_get_editor_info()->binding_path = p_binding_path;
+	}
+}
+
+bool BBVariable::_is_mutable_container(const Variant &p_value) {
+	switch (p_value.get_type()) {
+		case Variant::ARRAY: {
+			return !Array(p_value).is_read_only();
+		}
+		case Variant::DICTIONARY: {
+			return !Dictionary(p_value).is_read_only();
+		}
+		default: {
+			return false;
+		}
+	}
+}
+
+void BBVariable::_copy_data(const Data *p_src, Data *p_dst, bool p_deep, bool p_editor_info) {
+	if (p_editor_info && p_src->editor_info) {
+		if (p_dst->editor_info == nullptr) {
+			p_dst->editor_info = memnew(EditorInfo);
+		}
+		*p_dst->editor_info = *p_src->editor_info;
+	}
+	p_dst->type = p_src->type;
+	if (p_deep && _is_mutable_container(p_src->value)) {
+		// Other types are either copy-on-write (like packed arrays), read-only, or not duplicated by Variant anyway.
+		p_dst->value = p_src->value.duplicate(p_deep);
 	} else {
-		var.data->value = data->value;
+		p_dst->value = p_src->value;
 	}
-	var.data->binding_path = data->binding_path;
-	var.data->bound_object = data->bound_object;
-	var.data->bound_property = data->bound_property;
+	p_dst->bound_object = p_src->bound_object;
+	p_dst->bound_property = p_src->bound_property;
+}
+
+BBVariable BBVariable::duplicate(bool p_deep) const {
+	BBVariable var;
+	_copy_data(data, var.data, p_deep);
 	return var;
 }
 
+void BBVariable::duplicate_batch(const LocalVector<BBVariable> &p_src, LocalVector<BBVariable> &r_dst, bool p_deep, bool p_strip_editor_info) {
+	r_dst.clear();
+	const uint32_t count = p_src.size();
+	if (count == 0) {
+		return;
+	}
+
+	// Layout: block refcount, then data of each variable.
+	const size_t header_size = ((sizeof(SafeRefCount) + alignof(Data) - 1) / alignof(Data)) * alignof(Data);
+	uint8_t *mem = (uint8_t *)memalloc(header_size + sizeof(Data) * count);
+	ERR_FAIL_NULL(mem);
+	SafeRefCount *block_refcount = memnew_placement(mem, SafeRefCount);
+	block_refcount->init(count);
+
+	r_dst.reserve(count);
+	for (uint32_t i = 0; i < count; i++) {
+		Data *var_data = memnew_placement(mem + header_size + sizeof(Data) * i, Data);
+		var_data->refcount.init();
+		var_data->block_refcount = block_refcount;
+		_copy_data(p_src[i].data, var_data, p_deep, !p_strip_editor_info);
+		r_dst.push_back(BBVariable(var_data));
+	}
+}
+
+uint64_t BBVariable::get_memory_usage() const {
+	uint64_t usage = sizeof(Data) + get_value_memory_usage(data->value);
+	if (data->editor_info) {
+		usage += sizeof(EditorInfo) + data->editor_info->hint_string.length() * sizeof(char32_t);
+	}
+	if (data->listeners) {
+		usage += sizeof(LocalVector<Callable>) + data->listeners->size() * sizeof(Callable);
+	}
+	return usage;
+}
+
+// Rough estimate of what the value allocates besides the Variant itself: string and array buffers, and container elements.
+uint64_t BBVariable::get_value_memory_usage(const Variant &p_value) {
+#define PACKED_USAGE_CASE(m_type, m_class, m_element) \
+	case Variant::m_type: {                             \
+		const m_class arr = p_value;                    \
+		return arr.size() * sizeof(m_element);          \
+	}
+	switch (p_value.get_type()) {
+		case Variant::STRING: {
+			return String(p_value).length() * sizeof(char32_t);
+		}
+		case Variant::ARRAY: {
+			const Array arr = p_value;
+			uint64_t usage = arr.size() * sizeof(Variant);
+			for (int i = 0; i < arr.size(); i++) {
+				usage += get_value_memory_usage(arr[i]);
+			}
+			return usage;
+		}
+		case Variant::DICTIONARY: {
+			const Dictionary dict = p_value;
+			const Array keys = dict.keys();
+			// Each entry holds a key and a value, plus hash map and ordering links.
+			uint64_t usage = dict.size() * (2 * sizeof(Variant) + 4 * sizeof(void *));
+			for (int i = 0; i < keys.size(); i++) {
+				usage += get_value_memory_usage(keys[i]) + get_value_memory_usage(dict[keys[i]]);
+			}
+			return usage;
+		}
+		PACKED_USAGE_CASE(PACKED_BYTE_ARRAY, PackedByteArray, uint8_t);
+		PACKED_USAGE_CASE(PACKED_INT32_ARRAY, PackedInt32Array, int32_t);
+		PACKED_USAGE_CASE(PACKED_INT64_ARRAY, PackedInt64Array, int64_t);
+		PACKED_USAGE_CASE(PACKED_FLOAT32_ARRAY, PackedFloat32Array, float);
+		PACKED_USAGE_CASE(PACKED_FLOAT64_ARRAY, PackedFloat64Array, double);
+		PACKED_USAGE_CASE(PACKED_STRING_ARRAY, PackedStringArray, String);
+		PACKED_USAGE_CASE(PACKED_VECTOR2_ARRAY, PackedVector2Array, Vector2);
+		PACKED_USAGE_CASE(PACKED_VECTOR3_ARRAY, PackedVector3Array, Vector3);
+		PACKED_USAGE_CASE(PACKED_VECTOR4_ARRAY, PackedVector4Array, Vector4);
+		PACKED_USAGE_CASE(PACKED_COLOR_ARRAY, PackedColorArray, Color);
+		default: {
+			// Stored inline, shared (like StringName), or an object that isn't owned by the variable.
+			return 0;
+		}
+	}
+#undef PACKED_USAGE_CASE
+}
+
 bool BBVariable::is_same_prop_info(const BBVariable &p_other) const {
 	if (data->type != p_other.data->type) {
 		return false;
 	}
-	if (data->hint != p_other.data->hint) {
+	if (get_hint() != p_other.get_hint()) {
 		return false;
 	}
-	if (data->hint_string != p_other.data->hint_string) {
+	if (get_hint_string() != p_other.get_hint_string()) {
+		return false;
+	}
+	if (get_binding_path() != p_other.get_binding_path()) {
 		return false;
 	}
 	return true;
@@ -109,8 +271,9 @@ bool BBVariable::is_same_prop_info(const BBVariable &p_other) const {
 
 void BBVariable::copy_prop_info(const BBVariable &p_other) {
 	data->type = p_other.data->type;
-	data->hint = p_other.data->hint;
-	data->hint_string = p_other.data->hint_string;
+	set_hint(p_other.get_hint());
+	set_hint_string(p_other.get_hint_string());
+	set_binding_path(p_other.get_binding_path());
 }
 
 void BBVariable::bind(Object *p_object, const StringName &p_property) {
@@ -118,12 +281,21 @@ void BBVariable::bind(Object *p_object, const StringName &p_property) {
 	ERR_FAIL_COND_MSG(p_property == StringName(), "Blackboard: Binding failed - property name is empty.");
 	ERR_FAIL_COND_MSG(!OBJECT_HAS_PROPERTY(p_object, p_property), vformat("Blackboard: Binding failed - %s has no property `%s`.", p_object, p_property));
 	data->bound_object = p_object->get_instance_id();
-	data->bound_property = p_property;
+	data->bound_property.set_path(p_property);
+}
+
+void BBVariable::bind(Object *p_object, const LimboPropertyAccessor &p_accessor) {
+	ERR_FAIL_NULL_MSG(p_object, "Blackboard: Binding failed - object is null.");
+#ifdef DEBUG_ENABLED
+	ERR_FAIL_COND_MSG(!OBJECT_HAS_PROPERTY(p_object, p_accessor.get_property()), vformat("Blackboard: Binding failed - %s has no property `%s`.", p_object, p_accessor.get_property()));
+#endif
+	data->bound_object = p_object->get_instance_id();
+	data->bound_property = p_accessor;
 }
 
 void BBVariable::unbind() {
 	data->bound_object = 0;
-	data->bound_property = StringName();
+	data->bound_property = LimboPropertyAccessor();
 }
 
 bool BBVariable::operator==(const BBVariable &p_var) const {
@@ -139,11 +311,11 @@ bool BBVariable::operator==(const BBVariable &p_var) const {
 		return false;
 	}
 
-	if (data->hint != p_var.data->hint) {
+	if (get_hint() != p_var.get_hint()) {
 		return false;
 	}
 
-	if (data->hint_string != p_var.data->hint_string) {
+	if (get_hint_string() != p_var.get_hint_string()) {
 		return false;
 	}
 
@@ -181,8 +353,8 @@ BBVariable::BBVariable(Variant::Type p_type, PropertyHint p_hint, const String &
 	data->refcount.init();
 
 	set_type(p_type);
-	data->hint = p_hint;
-	data->hint_string = p_hint_string;
+	set_hint(p_hint);
+	set_hint_string(p_hint_string);
 }
 
 BBVariable::~BBVariable() {
@@ -12,38 +12,77 @@
 #ifndef BB_VARIABLE_H
 #define BB_VARIABLE_H
 
+#include "../util/limbo_property_accessor.h"
+
 #ifdef LIMBOAI_MODULE
 #include "core/object/object.h"
+#include "core/templates/local_vector.h"
 #endif // LIMBOAI_MODULE
 
 #ifdef LIMBOAI_GDEXTENSION
 #include "godot_cpp/core/object.hpp"
+#include "godot_cpp/templates/local_vector.hpp"
 using namespace godot;
 #endif // LIMBOAI_GDEXTENSION
 
 class BBVariable {
 private:
+	// Only needed by the editor and plans. Not copied into blackboards at runtime (see duplicate_batch()).
+	struct EditorInfo {
+		PropertyHint hint = PropertyHint::PROPERTY_HINT_NONE;
+		String hint_string;
+		NodePath binding_path;
+	};
+
 	struct Data {
 		// Is used to decide if the value needs to be synced in a derived plan.
 		bool value_changed = false;
+		// Incremented on every set_value(), so readers can detect changes without comparing values.
+		uint32_t version = 0;
+		LocalVector<Callable> *listeners = nullptr;
 
+		// Atomic, since variables are shared between scopes and plans that may be released on other threads.
+		// Only copies of BBVariable touch it - reads go through references to the stored variable.
 		SafeRefCount refcount;
 		Variant value;
 		Variant::Type type = Variant::NIL;
-		PropertyHint hint = PropertyHint::PROPERTY_HINT_NONE;
-		String hint_string;
+		EditorInfo *editor_info = nullptr;
 
-		NodePath binding_path;
 		uint64_t bound_object = 0;
-		StringName bound_property;
+		LimboPropertyAccessor bound_property;
+
+		// Not null if the data was allocated in a block together with other variables.
+		SafeRefCount *block_refcount = nullptr;
+
+		~Data() {
+			if (listeners) {
+				memdelete(listeners);
+			}
+			if (editor_info) {
+				memdelete(editor_info);
+			}
+		}
 	};
 
 	Data *data = nullptr;
 	void unref();
+	void _set_bound_value(const Variant &p_value);
+
+	static bool _is_mutable_container(const Variant &p_value);
+	static void _copy_data(const Data *p_src, Data *p_dst, bool p_deep, bool p_editor_info = true);
+	EditorInfo *_get_editor_info();
+	explicit BBVariable(Data *p_data) { data = p_data; }
 
 public:
-	void set_value(const Variant &p_value);
+	// Listeners are not called if p_notify is false.
+	void set_value(const Variant &p_value, bool p_notify = true);
 	Variant get_value() const;
+	// Stored value without a copy, or nullptr if the variable is bound to a property (see get_value()).
+	_FORCE_INLINE_ const Variant *get_value_ptr() const { return is_bound() ? nullptr : &data->value; }
+	// Same for native code that modifies the value in place, e.g. a packed array. Call notify_value_changed() afterwards.
+	_FORCE_INLINE_ Variant *get_value_ptrw() { return is_bound() ? nullptr : &data->value; }
+	// Counts the value as changed and calls the listeners, as set_value() does.
+	void notify_value_changed();
 
 	void set_type(Variant::Type p_type);
 	Variant::Type get_type() const;
@@ -55,21 +94,40 @@ public:
 	String get_hint_string() const;
 
 	BBVariable duplicate(bool p_deep = false) const;
+	// Exchanges the data with p_other without touching the reference counts, unlike a copy.
+	_FORCE_INLINE_ void swap(BBVariable &p_other) {
+		Data *tmp = data;
+		data = p_other.data;
+		p_other.data = tmp;
+	}
+	// Duplicates all variables in p_src, allocating their data in a single memory block.
+	// With p_strip_editor_info, hints and binding paths are not copied: runtime blackboards never read them.
+	static void duplicate_batch(const LocalVector<BBVariable> &p_src, LocalVector<BBVariable> &r_dst, bool p_deep = false, bool p_strip_editor_info = false);
+
+	_FORCE_INLINE_ uint32_t get_version() const { return data->version; }
+	void add_listener(const Callable &p_callable);
+	void remove_listener(const Callable &p_callable);
 
 	_FORCE_INLINE_ bool is_value_changed() const { return data->value_changed; }
 	_FORCE_INLINE_ void reset_value_changed() { data->value_changed = false; }
 
+	// Estimated heap memory of the variable data, including the value. Objects referenced by the value are not counted.
+	uint64_t get_memory_usage() const;
+	static uint64_t get_value_memory_usage(const Variant &p_value);
+
 	bool is_same_prop_info(const BBVariable &p_other) const;
 	void copy_prop_info(const BBVariable &p_other);
 
 	// * Editor binding methods
-	NodePath get_binding_path() const { return data->binding_path; }
-	void set_binding_path(const NodePath &p_binding_path) { data->binding_path = p_binding_path; }
-	bool has_binding() { return data->binding_path.is_empty(); }
+	NodePath get_binding_path() const { return data->editor_info ? data->editor_info->binding_path : NodePath(); }
+	void set_binding_path(const NodePath &p_binding_path);
+	bool has_binding() const { return !get_binding_path().is_empty(); }
 
 	// * Runtime binding methods
 	_FORCE_INLINE_ bool is_bound() const { return data->bound_object != 0; }
 	void bind(Object *p_object, const StringName &p_property);
+	// Binds with an accessor prepared ahead of time, e.g. by BlackboardPlan for each of its planned bindings.
+	void bind(Object *p_object, const LimboPropertyAccessor &p_accessor);
 	void unbind();
 
 	bool operator==(const BBVariable &p_var) const;
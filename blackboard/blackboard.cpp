@@ -11,6 +11,11 @@
 
 #include "blackboard.h"
 
+#include "../util/limbo_compat.h"
+#include "../util/limbo_string_names.h"
+#include "../util/limbo_timer_wheel.h"
+#include "bb_var_ref.h"
+
 #ifdef LIMBOAI_MODULE
 #include "core/variant/variant.h"
 #include "scene/main/node.h"
@@ -24,6 +29,115 @@
 using namespace godot;
 #endif
 
+SafeNumeric<uint64_t> Blackboard::structure_stamps;
+thread_local bool Blackboard::outer_vars_frozen = false;
+
+uint64_t Blackboard::_get_chain_stamp() const {
+	uint64_t stamp = structure_stamp;
+	for (const Blackboard *bb = parent.ptr(); bb != nullptr; bb = bb->parent.ptr()) {
+		stamp = MAX(stamp, bb->structure_stamp);
+	}
+	return stamp;
+}
+
+void Blackboard::_insert_var(const StringName &p_name, const BBVariable &p_var) {
+	Slot slot;
+	slot.name = p_name;
+	slot.var = p_var;
+	slot_map.insert(p_name, slots.size());
+	slots.push_back(slot);
+	_restamp_structure();
+}
+
+void Blackboard::_compact_slots() {
+	uint32_t j = 0;
+	for (uint32_t i = 0; i < slots.size(); i++) {
+		if (slots[i].name != StringName()) {
+			if (i != j) {
+				// * Swapped rather than copied: the erased slot's variable ends up at the tail and is released below.
+				slots[j].name = slots[i].name;
+				slots[j].var.swap(slots[i].var);
+				slots[j].exported_version = slots[i].exported_version;
+				slot_map[slots[j].name] = j;
+			}
+			j++;
+		}
+	}
+	slots.resize(j);
+	num_erased = 0;
+	_restamp_structure();
+}
+
+const BBVariable *Blackboard::_find_var(const StringName &p_name) const {
+	const uint32_t *idx = slot_map.getptr(p_name);
+	if (idx) {
+		return &slots[*idx].var;
+	}
+	if (parent.is_null()) {
+		return nullptr;
+	}
+
+	// * Not synchronized: a scope is accessed by one thread at a time, like the tree that owns it, except for
+	// concurrent branches, which don't modify the cache.
+	const uint64_t epoch = _get_chain_stamp();
+	const bool cache_valid = outer_vars_epoch == epoch;
+	if (unlikely((!cache_valid || outer_vars.size() > 256) && !outer_vars_frozen)) {
+		// Some scope of the chain has changed its variables, or too many missing names were looked up.
+		outer_vars.clear();
+		outer_vars_epoch = epoch;
+	}
+	if (likely(cache_valid || !outer_vars_frozen)) {
+		const OuterVar *cached = outer_vars.getptr(p_name);
+		if (cached) {
+			return cached->owner ? &cached->owner->slots[cached->slot].var : nullptr;
+		}
+	}
+
+	OuterVar outer;
+	for (const Blackboard *bb = parent.ptr(); bb != nullptr; bb = bb->parent.ptr()) {
+		idx = bb->slot_map.getptr(p_name);
+		if (idx) {
+			outer.owner = bb;
+			outer.slot = *idx;
+			break;
+		}
+	}
+	if (!outer_vars_frozen) {
+		outer_vars.insert(p_name, outer);
+	}
+	return outer.owner ? &outer.owner->slots[outer.slot].var : nullptr;
+}
+
+BBVariable *Blackboard::_resolve_handle(BBVarHandle &p_handle) const {
+	const uint64_t epoch = _get_chain_stamp();
+	if (likely(p_handle.depth >= 0 && p_handle.epoch == epoch)) {
+		Blackboard *bb = const_cast<Blackboard *>(this);
+		for (int i = 0; i < p_handle.depth && bb != nullptr; i++) {
+			bb = bb->parent.ptr();
+		}
+		// * The chain stamp is the highest stamp of its scopes, so another chain can match it - verify the slot.
+		if (likely(bb != nullptr && p_handle.slot < bb->slots.size() && bb->slots[p_handle.slot].name == p_handle.name)) {
+			return &bb->slots[p_handle.slot].var;
+		}
+	}
+
+	p_handle.depth = -1;
+	Blackboard *bb = const_cast<Blackboard *>(this);
+	int depth = 0;
+	while (bb != nullptr) {
+		const uint32_t *idx = bb->slot_map.getptr(p_handle.name);
+		if (idx) {
+			p_handle.epoch = epoch;
+			p_handle.depth = depth;
+			p_handle.slot = *idx;
+			return &bb->slots[*idx].var;
+		}
+		bb = bb->parent.ptr();
+		depth += 1;
+	}
+	return nullptr;
+}
+
 Ref<Blackboard> Blackboard::top() const {
 	Ref<Blackboard> bb(this);
 	while (bb->get_parent().is_valid()) {
@@ -32,57 +146,217 @@ Ref<Blackboard> Blackboard::top() const {
 	return bb;
 }
 
+void Blackboard::set_parent(const Ref<Blackboard> &p_blackboard) {
+	parent = p_blackboard;
+	_restamp_structure();
+}
+
 Variant Blackboard::get_var(const StringName &p_name, const Variant &p_default, bool p_complain) const {
-	if (data.has(p_name)) {
-		return data.get(p_name).get_value();
-	} else if (parent.is_valid()) {
-		return parent->get_var(p_name, p_default, p_complain);
-	} else {
-		if (p_complain) {
-			ERR_PRINT(vformat("Blackboard: Variable \"%s\" not found.", p_name));
-		}
-		return p_default;
+	const BBVariable *var = _find_var(p_name);
+	if (var) {
+		return var->get_value();
+	}
+	if (p_complain) {
+		ERR_PRINT(vformat("Blackboard: Variable \"%s\" not found.", p_name));
 	}
+	return p_default;
 }
 
 void Blackboard::set_var(const StringName &p_name, const Variant &p_value) {
-	if (data.has(p_name)) {
+	change_count.increment();
+	const uint32_t *idx = slot_map.getptr(p_name);
+	if (idx) {
 		// Not checking type - allowing duck-typing.
-		data[p_name].set_value(p_value);
+		slots[*idx].var.set_value(p_value);
 	} else {
 		BBVariable var(p_value.get_type());
 		var.set_value(p_value);
-		data.insert(p_name, var);
+		_insert_var(p_name, var);
+	}
+}
+
+// Looks up the variable in a single pass over the scopes, unlike has_var() followed by get_var().
+bool Blackboard::try_get_var(const StringName &p_name, Variant &r_value) const {
+	const BBVariable *var = _find_var(p_name);
+	if (var) {
+		r_value = var->get_value();
+		return true;
 	}
+	return false;
 }
 
 bool Blackboard::has_var(const StringName &p_name) const {
-	return data.has(p_name) || (parent.is_valid() && parent->has_var(p_name));
+	return _find_var(p_name) != nullptr;
 }
 
 void Blackboard::erase_var(const StringName &p_name) {
-	data.erase(p_name);
+	const uint32_t *idx = slot_map.getptr(p_name);
+	if (!idx) {
+		return;
+	}
+	// Slots are not shifted, so that handles to other variables stay valid.
+	Slot &slot = slots[*idx];
+	if (delta_tracking) {
+		erased_since_export.push_back(p_name);
+	}
+	slot.name = StringName();
+	slot.var = BBVariable();
+	slot_map.erase(p_name);
+	clear_var_ttl(p_name);
+	num_erased += 1;
+	change_count.increment();
+	_restamp_structure();
+	if (num_erased > 16 && num_erased * 2 > slots.size()) {
+		_compact_slots();
+	}
+}
+
+void Blackboard::clear() {
+	if (delta_tracking) {
+		for (const Slot &slot : slots) {
+			if (slot.name != StringName()) {
+				erased_since_export.push_back(slot.name);
+			}
+		}
+	}
+	slot_map.clear();
+	slots.clear();
+	expiring_vars.clear();
+	num_erased = 0;
+	change_count.increment();
+	_restamp_structure();
+}
+
+// Preallocates storage for p_extra more variables.
+void Blackboard::reserve_vars(uint32_t p_extra) {
+	slots.reserve(slots.size() + p_extra);
+	slot_map.reserve(slot_map.size() + p_extra);
 }
 
 TypedArray<StringName> Blackboard::list_vars() const {
 	TypedArray<StringName> var_names;
-	var_names.resize(data.size());
+	var_names.resize(slot_map.size());
 	int idx = 0;
-	for (const KeyValue<StringName, BBVariable> &kv : data) {
-		var_names[idx] = kv.key;
-		idx += 1;
+	for (const Slot &slot : slots) {
+		if (slot.name != StringName()) {
+			var_names[idx] = slot.name;
+			idx += 1;
+		}
 	}
 	return var_names;
 }
 
 Dictionary Blackboard::get_vars_as_dict() const {
 	Dictionary dict;
-	for (const KeyValue<StringName, BBVariable> &kv : data) {
-		dict[kv.key] = kv.value.get_value();
+	for (const Slot &slot : slots) {
+		if (slot.name != StringName()) {
+			dict[slot.name] = slot.var.get_value();
+		}
 	}
 	return dict;
 }
 
+BBVarHandle Blackboard::get_var_handle(const StringName &p_name) const {
+	BBVarHandle handle;
+	handle.name = p_name;
+	_resolve_handle(handle);
+	return handle;
+}
+
+Ref<BBVarRef> Blackboard::get_var_ref(const StringName &p_name) {
+	Ref<BBVarRef> ref;
+	ref.instantiate();
+	ref->setup(Ref<Blackboard>(this), p_name);
+	return ref;
+}
+
+Variant Blackboard::get_var_by_handle(BBVarHandle &p_handle, const Variant &p_default, bool p_complain) const {
+	const BBVariable *var = _resolve_handle(p_handle);
+	if (var) {
+		return var->get_value();
+	}
+	if (p_complain) {
+		ERR_PRINT(vformat("Blackboard: Variable \"%s\" not found.", p_handle.name));
+	}
+	return p_default;
+}
+
+void Blackboard::set_var_by_handle(BBVarHandle &p_handle, const Variant &p_value) {
+	if (!try_set_var_by_handle(p_handle, p_value)) {
+		// Same as set_var(): outer scope variables are shadowed, not written to.
+		set_var(p_handle.name, p_value);
+	}
+}
+
+uint64_t Blackboard::get_memory_usage() const {
+	// Hash map entries hold a key, a value, and links, plus a hash and an index in the bucket arrays.
+	const uint64_t map_entry_size = sizeof(StringName) + sizeof(uint32_t) + 2 * sizeof(void *) + 2 * sizeof(uint32_t);
+	uint64_t usage = sizeof(Blackboard) + slots.size() * sizeof(Slot) + slot_map.size() * map_entry_size;
+	usage += outer_vars.size() * (sizeof(StringName) + sizeof(OuterVar) + 2 * sizeof(void *) + 2 * sizeof(uint32_t));
+	usage += erased_since_export.size() * sizeof(StringName);
+	for (const Slot &slot : slots) {
+		if (slot.name != StringName()) {
+			usage += slot.var.get_memory_usage();
+		}
+	}
+	return usage;
+}
+
+uint64_t Blackboard::get_change_count() const {
+	uint64_t count = change_count.get();
+	for (const Blackboard *bb = parent.ptr(); bb != nullptr; bb = bb->parent.ptr()) {
+		count += bb->change_count.get();
+	}
+	return count;
+}
+
+void Blackboard::add_var_listener(const StringName &p_name, const Callable &p_callable) {
+	// * Counted in the scope that owns the variable.
+	for (Blackboard *bb = this; bb != nullptr; bb = bb->parent.ptr()) {
+		const uint32_t *idx = bb->slot_map.getptr(p_name);
+		if (idx) {
+			bb->slots[*idx].var.add_listener(p_callable);
+			bb->num_listeners += 1;
+			return;
+		}
+	}
+	ERR_FAIL_MSG("Blackboard: Can't add listener to a variable that doesn't exist (var: " + p_name + ").");
+}
+
+void Blackboard::remove_var_listener(const StringName &p_name, const Callable &p_callable) {
+	for (Blackboard *bb = this; bb != nullptr; bb = bb->parent.ptr()) {
+		const uint32_t *idx = bb->slot_map.getptr(p_name);
+		if (idx) {
+			bb->slots[*idx].var.remove_listener(p_callable);
+			if (bb->num_listeners > 0) {
+				bb->num_listeners -= 1;
+			}
+			return;
+		}
+	}
+	ERR_FAIL_MSG("Blackboard: Can't remove listener from a variable that doesn't exist (var: " + p_name + ").");
+}
+
+bool Blackboard::has_var_listeners() const {
+	for (const Blackboard *bb = this; bb != nullptr; bb = bb->parent.ptr()) {
+		if (bb->num_listeners > 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool Blackboard::has_bound_vars() const {
+	for (const Blackboard *bb = this; bb != nullptr; bb = bb->parent.ptr()) {
+		for (const Slot &slot : bb->slots) {
+			if (slot.name != StringName() && slot.var.is_bound()) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
 void Blackboard::populate_from_dict(const Dictionary &p_dictionary) {
 	Array keys = p_dictionary.keys();
 	for (int i = 0; i < keys.size(); i++) {
@@ -94,43 +368,323 @@ void Blackboard::populate_from_dict(const Dictionary &p_dictionary) {
 	}
 }
 
+// Returns local variables written since the previous call, with the names of erased variables.
+// Changes are detected with variable versions, so writes through linked variables are included too.
+Dictionary Blackboard::export_delta() {
+	delta_tracking = true;
+	delta_sequence += 1;
+
+	Dictionary values;
+	for (Slot &slot : slots) {
+		if (slot.name == StringName()) {
+			continue;
+		}
+		const int64_t version = slot.var.get_version();
+		// Bound variables are always exported: writes to the property can't be detected.
+		if (version != slot.exported_version || slot.var.is_bound()) {
+			slot.exported_version = version;
+			values[slot.name] = slot.var.get_value();
+		}
+	}
+
+	TypedArray<StringName> erased;
+	for (const StringName &name : erased_since_export) {
+		erased.push_back(name);
+	}
+	erased_since_export.clear();
+
+	Dictionary delta;
+	delta[LW_NAME(sequence)] = int64_t(delta_sequence);
+	delta[LW_NAME(values)] = values;
+	delta[LW_NAME(erased)] = erased;
+	return delta;
+}
+
+// Makes the next export_delta() include every variable, e.g. when a new peer needs the full state.
+void Blackboard::reset_delta() {
+	for (Slot &slot : slots) {
+		slot.exported_version = -1;
+	}
+}
+
+void Blackboard::diff_vars(LocalVector<StringName> &r_names, LocalVector<int64_t> &r_versions, Array &r_changed, Array &r_erased) const {
+	const uint32_t old_size = r_names.size();
+	// * Compaction moves variables to other slots - a name that's still present was moved, not erased.
+	for (uint32_t i = slots.size(); i < old_size; i++) {
+		if (r_names[i] != StringName() && !slot_map.has(r_names[i])) {
+			r_erased.push_back(r_names[i]);
+		}
+	}
+	r_names.resize(slots.size());
+	r_versions.resize(slots.size());
+	for (uint32_t i = old_size; i < slots.size(); i++) {
+		r_versions[i] = -1;
+	}
+
+	for (uint32_t i = 0; i < slots.size(); i++) {
+		const Slot &slot = slots[i];
+		if (slot.name != r_names[i]) {
+			if (r_names[i] != StringName() && !slot_map.has(r_names[i])) {
+				r_erased.push_back(r_names[i]);
+			}
+			r_names[i] = slot.name;
+			r_versions[i] = -1;
+		}
+		if (slot.name == StringName()) {
+			continue;
+		}
+		const int64_t version = slot.var.get_version();
+		// Bound variables are always reported: writes to the property can't be detected.
+		if (version != r_versions[i] || slot.var.is_bound()) {
+			r_versions[i] = version;
+			r_changed.push_back(slot.name);
+			r_changed.push_back(slot.var.get_value());
+		}
+	}
+}
+
+void Blackboard::save_vars(LimboSnapshotWriter &p_writer) const {
+	p_writer.put_u32(slot_map.size());
+	for (uint32_t i = 0; i < slots.size(); i++) {
+		if (slots[i].name != StringName()) {
+			p_writer.put_u32(i);
+			p_writer.put_string_name(slots[i].name);
+			p_writer.put_variant(slots[i].var.get_value());
+		}
+	}
+}
+
+void Blackboard::load_vars(LimboSnapshotReader &p_reader) {
+	const uint32_t count = p_reader.get_u32();
+	for (uint32_t i = 0; i < count && !p_reader.has_failed(); i++) {
+		const uint32_t slot = p_reader.get_u32();
+		const StringName name = p_reader.get_string_name();
+		const Variant value = p_reader.get_variant();
+		if (p_reader.has_failed()) {
+			break;
+		}
+		if (slot < slots.size() && slots[slot].name == name) {
+			// Same layout as when the snapshot was taken - no need to hash the name.
+			slots[slot].var.set_value(value);
+		} else {
+			set_var(name, value);
+		}
+	}
+	change_count.increment();
+}
+
+void Blackboard::skip_vars(LimboSnapshotReader &p_reader) {
+	const uint32_t count = p_reader.get_u32();
+	for (uint32_t i = 0; i < count && !p_reader.has_failed(); i++) {
+		p_reader.get_u32();
+		p_reader.get_string_name();
+		p_reader.get_variant();
+	}
+}
+
+PackedByteArray Blackboard::create_snapshot(bool p_include_parents) const {
+	LimboSnapshotWriter writer;
+	writer.put_u32(SNAPSHOT_MAGIC);
+	uint32_t num_scopes = 1;
+	if (p_include_parents) {
+		for (const Blackboard *bb = parent.ptr(); bb != nullptr; bb = bb->parent.ptr()) {
+			num_scopes += 1;
+		}
+	}
+	writer.put_u32(num_scopes);
+	const Blackboard *bb = this;
+	for (uint32_t i = 0; i < num_scopes; i++) {
+		bb->save_vars(writer);
+		bb = bb->parent.ptr();
+	}
+	return writer.to_bytes();
+}
+
+// Variables that were added after the snapshot was taken are kept as they are.
+Error Blackboard::restore_snapshot(const PackedByteArray &p_snapshot) {
+	LimboSnapshotReader reader(p_snapshot);
+	ERR_FAIL_COND_V_MSG(reader.get_u32() != SNAPSHOT_MAGIC, ERR_INVALID_DATA, "Blackboard: Not a blackboard snapshot.");
+	const uint32_t num_scopes = reader.get_u32();
+	Blackboard *bb = this;
+	for (uint32_t i = 0; i < num_scopes; i++) {
+		ERR_FAIL_NULL_V_MSG(bb, ERR_INVALID_DATA, "Blackboard: Snapshot has more scopes than this blackboard.");
+		bb->load_vars(reader);
+		bb = bb->parent.ptr();
+	}
+	ERR_FAIL_COND_V_MSG(reader.has_failed() || !reader.is_at_end(), ERR_INVALID_DATA, "Blackboard: Snapshot data is corrupted.");
+	return OK;
+}
+
 void Blackboard::bind_var_to_property(const StringName &p_name, Object *p_object, const StringName &p_property, bool p_create) {
-	if (!data.has(p_name)) {
+	if (!slot_map.has(p_name)) {
 		if (p_create) {
-			data.insert(p_name, BBVariable());
+			_insert_var(p_name, BBVariable());
 		} else {
 			ERR_FAIL_MSG("Blackboard: Can't bind variable that doesn't exist (var: " + p_name + ").");
 		}
 	}
-	data[p_name].bind(p_object, p_property);
+	slots[slot_map[p_name]].var.bind(p_object, p_property);
 }
 
 void Blackboard::unbind_var(const StringName &p_name) {
-	ERR_FAIL_COND_MSG(!data.has(p_name), "Blackboard: Can't unbind variable that doesn't exist (var: " + p_name + ").");
-	data[p_name].unbind();
+	ERR_FAIL_COND_MSG(!slot_map.has(p_name), "Blackboard: Can't unbind variable that doesn't exist (var: " + p_name + ").");
+	slots[slot_map[p_name]].var.unbind();
 }
 
 void Blackboard::assign_var(const StringName &p_name, const BBVariable &p_var) {
-	data.insert(p_name, p_var);
+	const uint32_t *idx = slot_map.getptr(p_name);
+	if (idx) {
+		slots[*idx].var = p_var;
+		slots[*idx].exported_version = -1;
+	} else {
+		_insert_var(p_name, p_var);
+	}
 }
 
 void Blackboard::link_var(const StringName &p_name, const Ref<Blackboard> &p_target_blackboard, const StringName &p_target_var, bool p_create) {
-	if (!data.has(p_name)) {
+	if (!slot_map.has(p_name)) {
 		if (p_create) {
-			data.insert(p_name, BBVariable());
+			_insert_var(p_name, BBVariable());
 		} else {
 			ERR_FAIL_MSG("Blackboard: Can't link variable that doesn't exist (var: " + p_name + ").");
 		}
 	}
 	ERR_FAIL_COND_MSG(p_target_blackboard.is_null(), "Blackboard: Can't link variable to target blackboard that is null (var: " + p_name + ").");
-	ERR_FAIL_COND_MSG(!p_target_blackboard->data.has(p_target_var), "Blackboard: Can't link variable to non-existent target (var: " + p_name + ", target: " + p_target_var + ").");
-	data[p_name] = p_target_blackboard->data[p_target_var];
+	ERR_FAIL_COND_MSG(!p_target_blackboard->slot_map.has(p_target_var), "Blackboard: Can't link variable to non-existent target (var: " + p_name + ", target: " + p_target_var + ").");
+	Slot &slot = slots[slot_map[p_name]];
+	slot.var = p_target_blackboard->slots[p_target_blackboard->slot_map[p_target_var]].var;
+	slot.exported_version = -1;
+}
+
+int Blackboard::_find_expiring_var(const StringName &p_name) const {
+	for (uint32_t i = 0; i < expiring_vars.size(); i++) {
+		if (expiring_vars[i].name == p_name) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+void Blackboard::_expire_timeout(Object *p_owner, uint32_t p_timer_id) {
+	Blackboard *bb = Object::cast_to<Blackboard>(p_owner);
+	if (bb == nullptr) {
+		return;
+	}
+	// * Timers can't be cancelled: ones that were replaced or cleared are not found.
+	for (uint32_t i = 0; i < bb->expiring_vars.size(); i++) {
+		if (bb->expiring_vars[i].timer_id != p_timer_id) {
+			continue;
+		}
+		const ExpiringVar expired = bb->expiring_vars[i];
+		bb->expiring_vars.remove_at_unordered(i);
+		const uint32_t *idx = bb->slot_map.getptr(expired.name);
+		if (idx) {
+			BBVariable &var = bb->slots[*idx].var;
+			bb->change_count.increment();
+			var.set_value(VARIANT_DEFAULT(var.get_type()), expired.notify);
+		}
+		return;
+	}
+}
+
+void Blackboard::set_var_ttl(const StringName &p_name, double p_ttl, bool p_notify) {
+	ERR_FAIL_COND_MSG(!slot_map.has(p_name), "Blackboard: Can't set time-to-live of a variable that doesn't exist in this scope (var: " + p_name + ").");
+	if (p_ttl <= 0.0) {
+		clear_var_ttl(p_name);
+		return;
+	}
+	LimboTimerWheel *wheel = LimboTimerWheel::get(false);
+	int idx = _find_expiring_var(p_name);
+	if (idx == -1) {
+		idx = expiring_vars.size();
+		expiring_vars.push_back(ExpiringVar());
+		expiring_vars[idx].name = p_name;
+	}
+	ExpiringVar &entry = expiring_vars[idx];
+	entry.expiry_time = wheel->get_time() + p_ttl;
+	entry.notify = p_notify;
+	entry.timer_id = wheel->schedule(p_ttl, this, &Blackboard::_expire_timeout);
+}
+
+void Blackboard::set_var_with_ttl(const StringName &p_name, const Variant &p_value, double p_ttl, bool p_notify) {
+	set_var(p_name, p_value);
+	set_var_ttl(p_name, p_ttl, p_notify);
+}
+
+void Blackboard::clear_var_ttl(const StringName &p_name) {
+	const int idx = _find_expiring_var(p_name);
+	if (idx != -1) {
+		expiring_vars.remove_at_unordered(idx);
+	}
+}
+
+double Blackboard::get_var_ttl(const StringName &p_name) const {
+	const int idx = _find_expiring_var(p_name);
+	if (idx == -1) {
+		return -1.0;
+	}
+	return MAX(0.0, expiring_vars[idx].expiry_time - LimboTimerWheel::get(false)->get_time());
+}
+
+void Blackboard::add_trigger(const StringName &p_name) {
+	ERR_FAIL_COND_MSG(p_name == StringName(), "Blackboard: Trigger name can't be empty.");
+	if (trigger_names.find(p_name) != -1) {
+		return;
+	}
+	ERR_FAIL_COND_MSG(trigger_names.size() >= (uint32_t)MAX_TRIGGERS, vformat("Blackboard: Can't add trigger %s - a scope holds at most %d triggers.", p_name, MAX_TRIGGERS));
+	trigger_names.push_back(p_name);
+}
+
+bool Blackboard::has_trigger(const StringName &p_name) const {
+	Blackboard *scope = nullptr;
+	return find_trigger(p_name, scope) != 0;
+}
+
+TypedArray<StringName> Blackboard::list_triggers() const {
+	TypedArray<StringName> names;
+	for (const StringName &name : trigger_names) {
+		names.push_back(name);
+	}
+	return names;
+}
+
+uint64_t Blackboard::find_trigger(const StringName &p_name, Blackboard *&r_scope) const {
+	for (const Blackboard *bb = this; bb != nullptr; bb = bb->parent.ptr()) {
+		const int64_t idx = bb->trigger_names.find(p_name);
+		if (idx != -1) {
+			r_scope = const_cast<Blackboard *>(bb);
+			return uint64_t(1) << idx;
+		}
+	}
+	r_scope = nullptr;
+	return 0;
+}
+
+void Blackboard::fire_trigger(const StringName &p_name) {
+	Blackboard *scope = nullptr;
+	const uint64_t mask = find_trigger(p_name, scope);
+	ERR_FAIL_COND_MSG(mask == 0, "Blackboard: Can't fire trigger that doesn't exist (trigger: " + p_name + ").");
+	scope->fire_trigger_mask(mask);
+}
+
+bool Blackboard::consume_trigger(const StringName &p_name) {
+	Blackboard *scope = nullptr;
+	const uint64_t mask = find_trigger(p_name, scope);
+	ERR_FAIL_COND_V_MSG(mask == 0, false, "Blackboard: Can't consume trigger that doesn't exist (trigger: " + p_name + ").");
+	return scope->consume_trigger_mask(mask);
+}
+
+bool Blackboard::is_trigger_set(const StringName &p_name) const {
+	Blackboard *scope = nullptr;
+	const uint64_t mask = find_trigger(p_name, scope);
+	return mask != 0 && (scope->trigger_bits.get() & mask) != 0;
 }
 
 void Blackboard::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_var", "var_name", "default", "complain"), &Blackboard::get_var, DEFVAL(Variant()), DEFVAL(true));
 	ClassDB::bind_method(D_METHOD("set_var", "var_name", "value"), &Blackboard::set_var);
 	ClassDB::bind_method(D_METHOD("has_var", "var_name"), &Blackboard::has_var);
+	ClassDB::bind_method(D_METHOD("get_var_ref", "var_name"), &Blackboard::get_var_ref);
 	ClassDB::bind_method(D_METHOD("set_parent", "blackboard"), &Blackboard::set_parent);
 	ClassDB::bind_method(D_METHOD("get_parent"), &Blackboard::get_parent);
 	ClassDB::bind_method(D_METHOD("erase_var", "var_name"), &Blackboard::erase_var);
@@ -138,8 +692,25 @@ void Blackboard::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("list_vars"), &Blackboard::list_vars);
 	ClassDB::bind_method(D_METHOD("get_vars_as_dict"), &Blackboard::get_vars_as_dict);
 	ClassDB::bind_method(D_METHOD("populate_from_dict", "dictionary"), &Blackboard::populate_from_dict);
+	ClassDB::bind_method(D_METHOD("export_delta"), &Blackboard::export_delta);
+	ClassDB::bind_method(D_METHOD("reset_delta"), &Blackboard::reset_delta);
+	ClassDB::bind_method(D_METHOD("get_delta_sequence"), &Blackboard::get_delta_sequence);
+	ClassDB::bind_method(D_METHOD("create_snapshot", "include_parents"), &Blackboard::create_snapshot, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("restore_snapshot", "snapshot"), &Blackboard::restore_snapshot);
 	ClassDB::bind_method(D_METHOD("top"), &Blackboard::top);
 	ClassDB::bind_method(D_METHOD("bind_var_to_property", "var_name", "object", "property", "create"), &Blackboard::bind_var_to_property, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("unbind_var", "var_name"), &Blackboard::unbind_var);
 	ClassDB::bind_method(D_METHOD("link_var", "var_name", "target_blackboard", "target_var", "create"), &Blackboard::link_var, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("add_var_listener", "var_name", "callable"), &Blackboard::add_var_listener);
+	ClassDB::bind_method(D_METHOD("remove_var_listener", "var_name", "callable"), &Blackboard::remove_var_listener);
+	ClassDB::bind_method(D_METHOD("set_var_ttl", "var_name", "ttl", "notify"), &Blackboard::set_var_ttl, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("set_var_with_ttl", "var_name", "value", "ttl", "notify"), &Blackboard::set_var_with_ttl, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("clear_var_ttl", "var_name"), &Blackboard::clear_var_ttl);
+	ClassDB::bind_method(D_METHOD("get_var_ttl", "var_name"), &Blackboard::get_var_ttl);
+	ClassDB::bind_method(D_METHOD("add_trigger", "trigger_name"), &Blackboard::add_trigger);
+	ClassDB::bind_method(D_METHOD("has_trigger", "trigger_name"), &Blackboard::has_trigger);
+	ClassDB::bind_method(D_METHOD("list_triggers"), &Blackboard::list_triggers);
+	ClassDB::bind_method(D_METHOD("fire_trigger", "trigger_name"), &Blackboard::fire_trigger);
+	ClassDB::bind_method(D_METHOD("consume_trigger", "trigger_name"), &Blackboard::consume_trigger);
+	ClassDB::bind_method(D_METHOD("is_trigger_set", "trigger_name"), &Blackboard::is_trigger_set);
 }
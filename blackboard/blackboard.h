@@ -12,11 +12,16 @@
 #ifndef BLACKBOARD_H
 #define BLACKBOARD_H
 
+#include "../util/limbo_snapshot.h"
 #include "bb_variable.h"
 
 #ifdef LIMBOAI_MODULE
 #include "core/object/object.h"
 #include "core/object/ref_counted.h"
+#include "core/os/spin_lock.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
 #include "core/variant/variant.h"
 #include "scene/main/node.h"
 #endif // LIMBOAI_MODULE
@@ -27,16 +32,95 @@
 #include <godot_cpp/classes/ref_counted.hpp>
 #include <godot_cpp/core/object.hpp>
 #include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/templates/safe_refcount.hpp>
+#include <godot_cpp/templates/spin_lock.hpp>
 using namespace godot;
 #endif // LIMBOAI_GDEXTENSION
 
+class BBVarRef;
+
+// Resolved location of a blackboard variable: scope depth and slot index.
+// Obtain with Blackboard::get_var_handle() once, then access the variable without hashing.
+struct BBVarHandle {
+	StringName name;
+	uint64_t epoch = 0; // Stamp of the scope chain it was resolved in.
+	int depth = -1; // -1 if not resolved.
+	uint32_t slot = 0;
+};
+
 class Blackboard : public RefCounted {
 	GDCLASS(Blackboard, RefCounted);
+	friend class BTTask;
 
 private:
-	HashMap<StringName, BBVariable> data;
+	static constexpr uint32_t SNAPSHOT_MAGIC = 0x5342424c; // "LBBS"
+
+	struct Slot {
+		StringName name; // Empty if the variable was erased.
+		BBVariable var;
+		int64_t exported_version = -1; // Variable version included in the last delta export; -1 if never exported.
+	};
+
+	// Source of structure stamps, unique across blackboards.
+	static SafeNumeric<uint64_t> structure_stamps;
+	// Restamped whenever variables are added to or removed from this scope, or its parent changes. The newest stamp
+	// in a scope chain identifies its layout: any change in the chain makes it newer (see _get_chain_stamp()).
+	uint64_t structure_stamp = 0;
+
+	HashMap<StringName, uint32_t> slot_map;
+	LocalVector<Slot> slots;
+	uint32_t num_erased = 0;
+	// Incremented on writes through this blackboard - doesn't cover linked variables written elsewhere.
+	// Atomic, since concurrent branches of BTParallel write their own variables of the same scope.
+	SafeNumeric<uint64_t> change_count;
+	// Listeners added to variables of this scope. Not decremented when variables are erased.
+	uint32_t num_listeners = 0;
 	Ref<Blackboard> parent;
 
+	// Delta export state: names are remembered on erase only after the first export_delta() call.
+	bool delta_tracking = false;
+	uint64_t delta_sequence = 0;
+	LocalVector<StringName> erased_since_export;
+
+	// Where names that aren't local were last found in the outer scopes (owner is null if nowhere),
+	// so that repeated lookups don't walk the scope chain. Valid while the stamp of the chain is unchanged.
+	struct OuterVar {
+		const Blackboard *owner = nullptr;
+		uint32_t slot = 0;
+	};
+	mutable HashMap<StringName, OuterVar> outer_vars;
+	mutable uint64_t outer_vars_epoch = 0;
+	// Set on threads that execute concurrent branches of a task (see BTTask::_execute_concurrently()). The branches share
+	// the scope of their parent, so lookups only read outer_vars then, and walk the scope chain on a miss.
+	static thread_local bool outer_vars_frozen;
+
+	// Triggers are one-shot flags stored as bits, so that they can be fired from any thread and consumed
+	// without a variable lookup. Declared in this scope by name - the bit of a trigger is its index.
+	LocalVector<StringName> trigger_names;
+	// Read without locking, changed under trigger_lock.
+	SafeNumeric<uint64_t> trigger_bits;
+	SpinLock trigger_lock;
+
+	// Local variables with a time-to-live, reset when their timer on the LimboTimerWheel fires.
+	struct ExpiringVar {
+		StringName name;
+		uint32_t timer_id = 0;
+		double expiry_time = 0.0;
+		bool notify = true;
+	};
+	LocalVector<ExpiringVar> expiring_vars;
+
+	static void _expire_timeout(Object *p_owner, uint32_t p_timer_id);
+	int _find_expiring_var(const StringName &p_name) const;
+
+	_FORCE_INLINE_ void _restamp_structure() { structure_stamp = structure_stamps.increment(); }
+	uint64_t _get_chain_stamp() const;
+	void _insert_var(const StringName &p_name, const BBVariable &p_var);
+	void _compact_slots();
+	const BBVariable *_find_var(const StringName &p_name) const;
+	BBVariable *_resolve_handle(BBVarHandle &p_handle) const;
+
 protected:
 	static void _bind_methods();
 
@@ -45,28 +129,145 @@ protected:
 #endif
 
 public:
-	void set_parent(const Ref<Blackboard> &p_blackboard) { parent = p_blackboard; }
+	void set_parent(const Ref<Blackboard> &p_blackboard);
 	Ref<Blackboard> get_parent() const { return parent; }
 
 	Ref<Blackboard> top() const;
 
 	Variant get_var(const StringName &p_name, const Variant &p_default = Variant(), bool p_complain = true) const;
 	void set_var(const StringName &p_name, const Variant &p_value);
+	bool try_get_var(const StringName &p_name, Variant &r_value) const;
 	bool has_var(const StringName &p_name) const;
-	_FORCE_INLINE_ bool has_local_var(const StringName &p_name) const { return data.has(p_name); }
+	_FORCE_INLINE_ bool has_local_var(const StringName &p_name) const { return slot_map.has(p_name); }
 	void erase_var(const StringName &p_name);
-	void clear() { data.clear(); }
+	void clear();
+	void reserve_vars(uint32_t p_extra);
 	TypedArray<StringName> list_vars() const;
 
+	BBVarHandle get_var_handle(const StringName &p_name) const;
+	// Handle wrapped for scripts.
+	Ref<BBVarRef> get_var_ref(const StringName &p_name);
+	Variant get_var_by_handle(BBVarHandle &p_handle, const Variant &p_default = Variant(), bool p_complain = true) const;
+	void set_var_by_handle(BBVarHandle &p_handle, const Variant &p_value);
+	// Writes the variable only if it exists in this scope, without inserting or constructing names - safe on worker
+	// threads as long as no other thread writes the same variable. Returns false if set_var() would insert the variable.
+	_FORCE_INLINE_ bool try_set_var_by_handle(BBVarHandle &p_handle, const Variant &p_value) {
+		BBVariable *var = _resolve_handle(p_handle);
+		if (unlikely(var == nullptr || p_handle.depth != 0)) {
+			return false;
+		}
+		change_count.increment();
+		var->set_value(p_value);
+		return true;
+	}
+	// The local variable for native code that modifies its value in place - counted as a write. Returns nullptr if
+	// try_set_var_by_handle() would fail. Call BBVariable::notify_value_changed() after modifying it.
+	_FORCE_INLINE_ BBVariable *get_variable_for_write(BBVarHandle &p_handle) {
+		BBVariable *var = _resolve_handle(p_handle);
+		if (unlikely(var == nullptr || p_handle.depth != 0)) {
+			return nullptr;
+		}
+		change_count.increment();
+		return var;
+	}
+	_FORCE_INLINE_ bool has_var_by_handle(BBVarHandle &p_handle) const { return _resolve_handle(p_handle) != nullptr; }
+	// Resolves the handle once, unlike has_var_by_handle() followed by get_var_by_handle(). Returns false if the variable doesn't exist.
+	_FORCE_INLINE_ bool try_get_var_by_handle(BBVarHandle &p_handle, Variant &r_value) const {
+		const BBVariable *var = _resolve_handle(p_handle);
+		if (unlikely(var == nullptr)) {
+			return false;
+		}
+		r_value = var->get_value();
+		return true;
+	}
+	// The variable itself, for native code that reads it in place (see BBTypedVar). Returns nullptr if it doesn't exist.
+	_FORCE_INLINE_ const BBVariable *get_variable_by_handle(BBVarHandle &p_handle) const { return _resolve_handle(p_handle); }
+	// Returns the change counter of the variable, or -1 if it doesn't exist or is bound to a property (changes can't be tracked).
+	_FORCE_INLINE_ int64_t get_var_version(BBVarHandle &p_handle) const {
+		const BBVariable *var = _resolve_handle(p_handle);
+		return (var && !var->is_bound()) ? int64_t(var->get_version()) : -1;
+	}
+
+	// Estimated memory of this scope's storage and variables, excluding parent scopes. Linked variables are counted in each scope.
+	uint64_t get_memory_usage() const;
+
+	// Sum of the change counters of this blackboard and its parent scopes - differs whenever a variable was written.
+	uint64_t get_change_count() const;
+
+	void add_var_listener(const StringName &p_name, const Callable &p_callable);
+	void remove_var_listener(const StringName &p_name, const Callable &p_callable);
+	// True if variables of this scope or its parents may have listeners, which are called by the writing thread.
+	bool has_var_listeners() const;
+	// True if variables of this scope or its parents are bound to object properties, which are accessed by the reading or writing thread.
+	bool has_bound_vars() const;
+
 	Dictionary get_vars_as_dict() const;
 	void populate_from_dict(const Dictionary &p_dictionary);
 
+	Dictionary export_delta();
+	void reset_delta();
+	_FORCE_INLINE_ uint64_t get_delta_sequence() const { return delta_sequence; }
+	// Reports local variables that changed since the previous call with the same state - used by the debugger,
+	// independently of export_delta(). r_names and r_versions mirror the slots as last reported; pass empty ones
+	// to report everything. Changes are appended to r_changed as name/value pairs.
+	void diff_vars(LocalVector<StringName> &r_names, LocalVector<int64_t> &r_versions, Array &r_changed, Array &r_erased) const;
+
+	PackedByteArray create_snapshot(bool p_include_parents = true) const;
+	Error restore_snapshot(const PackedByteArray &p_snapshot);
+	// Local variables only - used to build snapshots of several scopes, e.g. in BTInstance.
+	void save_vars(LimboSnapshotWriter &p_writer) const;
+	void load_vars(LimboSnapshotReader &p_reader);
+	// Reads what save_vars() wrote without applying it, e.g. to check a snapshot before restoring it.
+	static void skip_vars(LimboSnapshotReader &p_reader);
+
 	void bind_var_to_property(const StringName &p_name, Object *p_object, const StringName &p_property, bool p_create = false);
 	void unbind_var(const StringName &p_name);
 
 	void assign_var(const StringName &p_name, const BBVariable &p_var);
 
 	void link_var(const StringName &p_name, const Ref<Blackboard> &p_target_blackboard, const StringName &p_target_var, bool p_create = false);
+
+	// Resets the local variable to the default value of its type after p_ttl seconds of game time, unless its
+	// time-to-live is set again or cleared before that. Listeners are called on expiry if p_notify is true.
+	// Main thread only, like the LimboTimerWheel.
+	void set_var_ttl(const StringName &p_name, double p_ttl, bool p_notify = true);
+	void set_var_with_ttl(const StringName &p_name, const Variant &p_value, double p_ttl, bool p_notify = true);
+	void clear_var_ttl(const StringName &p_name);
+	// Seconds left until the variable expires, or -1 if it doesn't expire.
+	double get_var_ttl(const StringName &p_name) const;
+
+	static constexpr int MAX_TRIGGERS = 64;
+
+	// Triggers must be declared before they are fired from other threads: declaring isn't thread-safe.
+	void add_trigger(const StringName &p_name);
+	bool has_trigger(const StringName &p_name) const;
+	TypedArray<StringName> list_triggers() const;
+	// Finds the scope that declares p_name, starting with this one. Returns the bit mask of the trigger in r_scope,
+	// or 0 if it isn't declared anywhere.
+	uint64_t find_trigger(const StringName &p_name, Blackboard *&r_scope) const;
+	// Thread-safe.
+	void fire_trigger(const StringName &p_name);
+	// Clears the trigger and returns whether it was set, atomically. Thread-safe.
+	bool consume_trigger(const StringName &p_name);
+	bool is_trigger_set(const StringName &p_name) const;
+
+	// Fast paths with the mask returned by find_trigger(), called on the scope that declares the trigger.
+	_FORCE_INLINE_ void fire_trigger_mask(uint64_t p_mask) {
+		trigger_lock.lock();
+		trigger_bits.set(trigger_bits.get() | p_mask);
+		trigger_lock.unlock();
+	}
+	_FORCE_INLINE_ bool consume_trigger_mask(uint64_t p_mask) {
+		// * Unlocked read first: most ticks find the trigger unset and shouldn't pay for the lock.
+		if ((trigger_bits.get() & p_mask) == 0) {
+			return false;
+		}
+		trigger_lock.lock();
+		const uint64_t bits = trigger_bits.get();
+		trigger_bits.set(bits & ~p_mask);
+		trigger_lock.unlock();
+		return (bits & p_mask) != 0;
+	}
 };
 
 #endif // BLACKBOARD_H
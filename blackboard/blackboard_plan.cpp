@@ -11,16 +11,22 @@
 
 #include "blackboard_plan.h"
 
+#include "../util/limbo_profiling.h"
+#include "../util/limbo_string_names.h"
 #include "../util/limbo_utility.h"
 
 bool BlackboardPlan::_set(const StringName &p_name, const Variant &p_value) {
 	String name_str = p_name;
+	// Type and mapping changes don't emit `changed`.
+	_invalidate_initializer();
 
 	// * Editor
-	if (var_map.has(p_name)) {
-		BBVariable &var = var_map[p_name];
+	BBVariable *editor_var = _find_var(p_name);
+	if (editor_var) {
+		BBVariable &var = *editor_var;
 		var.set_value(p_value);
-		if (base.is_valid() && p_value == base->get_var(p_name).get_value()) {
+		const BBVariable *base_var = base.is_valid() ? base->_find_var(p_name) : nullptr;
+		if (base_var && p_value == base_var->get_value()) {
 			// When user pressed reset property button in inspector...
 			var.reset_value_changed();
 		}
@@ -58,14 +64,20 @@ bool BlackboardPlan::_set(const StringName &p_name, const Variant &p_value) {
 		}
 		if (what == "name") {
 			// We don't store variable name with the variable.
-		} else if (what == "type") {
-			var_map[var_name].set_type((Variant::Type)(int)p_value);
+			return true;
+		}
+		BBVariable *var = _find_var(var_name);
+		ERR_FAIL_NULL_V(var, false);
+		if (what == "type") {
+			var->set_type((Variant::Type)(int)p_value);
 		} else if (what == "value") {
-			var_map[var_name].set_value(p_value);
+			var->set_value(p_value);
 		} else if (what == "hint") {
-			var_map[var_name].set_hint((PropertyHint)(int)p_value);
+			var->set_hint((PropertyHint)(int)p_value);
 		} else if (what == "hint_string") {
-			var_map[var_name].set_hint_string(p_value);
+			var->set_hint_string(p_value);
+		} else if (what == "binding") {
+			var->set_binding_path(p_value);
 		} else {
 			return false;
 		}
@@ -79,11 +91,12 @@ bool BlackboardPlan::_get(const StringName &p_name, Variant &r_ret) const {
 	String name_str = p_name;
 
 	// * Editor
-	if (var_map.has(p_name)) {
+	const BBVariable *editor_var = _find_var(p_name);
+	if (editor_var) {
 		if (has_mapping(p_name)) {
 			r_ret = "Mapped to " + LimboUtility::get_singleton()->decorate_var(parent_scope_mapping[p_name]);
 		} else {
-			r_ret = var_map[p_name].get_value();
+			r_ret = editor_var->get_value();
 		}
 		return true;
 	}
@@ -106,29 +119,53 @@ bool BlackboardPlan::_get(const StringName &p_name, Variant &r_ret) const {
 	}
 	StringName var_name = name_str.get_slicec('/', 1);
 	String what = name_str.get_slicec('/', 2);
-	ERR_FAIL_COND_V(!var_map.has(var_name), false);
+	const BBVariable *var = _find_var(var_name);
+	ERR_FAIL_NULL_V(var, false);
 
 	if (what == "name") {
 		r_ret = var_name;
 	} else if (what == "type") {
-		r_ret = var_map[var_name].get_type();
+		r_ret = var->get_type();
 	} else if (what == "value") {
-		r_ret = var_map[var_name].get_value();
+		r_ret = var->get_value();
 	} else if (what == "hint") {
-		r_ret = var_map[var_name].get_hint();
+		r_ret = var->get_hint();
 	} else if (what == "hint_string") {
-		r_ret = var_map[var_name].get_hint_string();
+		r_ret = var->get_hint_string();
+	} else if (what == "binding") {
+		r_ret = var->get_binding_path();
 	}
 	return true;
 }
 
+const BlackboardPlan::PropertyNames &BlackboardPlan::_get_property_names(uint32_t p_index) const {
+	if (property_names.size() < var_list.size()) {
+		property_names.resize(var_list.size());
+	}
+	PropertyNames &names = property_names[p_index];
+	const StringName &var_name = var_list[p_index].first;
+	if (names.var_name != var_name || names.name.is_empty()) {
+		const String prefix = "var/" + String(var_name);
+		names.var_name = var_name;
+		names.name = prefix + "/name";
+		names.type = prefix + "/type";
+		names.value = prefix + "/value";
+		names.hint = prefix + "/hint";
+		names.hint_string = prefix + "/hint_string";
+		names.binding = prefix + "/binding";
+		names.mapping = "mapping/" + String(var_name);
+	}
+	return names;
+}
+
 void BlackboardPlan::_get_property_list(List<PropertyInfo> *p_list) const {
-	for (const Pair<StringName, BBVariable> &p : var_list) {
-		String var_name = p.first;
-		BBVariable var = p.second;
+	const bool derived = is_derived();
+	for (uint32_t i = 0; i < var_list.size(); i++) {
+		const StringName &var_name = var_list[i].first;
+		const BBVariable &var = var_list[i].second;
 
 		// * Editor
-		if (var.get_type() != Variant::NIL && (!is_derived() || !var_name.begins_with("_"))) {
+		if (var.get_type() != Variant::NIL && (!derived || !String(var_name).begins_with("_"))) {
 			if (has_mapping(var_name)) {
 				p_list->push_back(PropertyInfo(Variant::STRING, var_name, PROPERTY_HINT_NONE, "", PROPERTY_USAGE_EDITOR | PROPERTY_USAGE_READ_ONLY));
 			} else {
@@ -137,25 +174,29 @@ void BlackboardPlan::_get_property_list(List<PropertyInfo> *p_list) const {
 		}
 
 		// * Storage
-		if (is_derived() && (!var.is_value_changed() || var.get_value() == base->var_map[var_name].get_value())) {
+		if (derived && (!var.is_value_changed() || var.get_value() == base->_find_var(var_name)->get_value())) {
 			// Don't store variable if it's not modified in a derived plan.
 			// Variable is considered modified when it's marked as changed and its value is different from the base plan.
 			continue;
 		}
-		p_list->push_back(PropertyInfo(Variant::STRING, "var/" + var_name + "/name", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
-		p_list->push_back(PropertyInfo(Variant::INT, "var/" + var_name + "/type", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
-		p_list->push_back(PropertyInfo(var.get_type(), "var/" + var_name + "/value", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
-		p_list->push_back(PropertyInfo(Variant::INT, "var/" + var_name + "/hint", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
-		p_list->push_back(PropertyInfo(Variant::STRING, "var/" + var_name + "/hint_string", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
+		const PropertyNames &names = _get_property_names(i);
+		p_list->push_back(PropertyInfo(Variant::STRING, names.name, PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
+		p_list->push_back(PropertyInfo(Variant::INT, names.type, PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
+		p_list->push_back(PropertyInfo(var.get_type(), names.value, PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
+		p_list->push_back(PropertyInfo(Variant::INT, names.hint, PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
+		p_list->push_back(PropertyInfo(Variant::STRING, names.hint_string, PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
+		if (var.has_binding()) {
+			p_list->push_back(PropertyInfo(Variant::NODE_PATH, names.binding, PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
+		}
 	}
 
 	// * Mapping
 	if (is_mapping_enabled()) {
 		p_list->push_back(PropertyInfo(Variant::NIL, "Mapping", PROPERTY_HINT_NONE, "mapping/", PROPERTY_USAGE_GROUP));
-		for (const Pair<StringName, BBVariable> &p : var_list) {
+		for (uint32_t i = 0; i < var_list.size(); i++) {
 			// Serialize only non-empty mappings.
-			PropertyUsageFlags usage = has_mapping(p.first) ? PROPERTY_USAGE_DEFAULT : PROPERTY_USAGE_EDITOR;
-			p_list->push_back(PropertyInfo(Variant::STRING_NAME, "mapping/" + p.first, PROPERTY_HINT_NONE, "", usage));
+			PropertyUsageFlags usage = has_mapping(var_list[i].first) ? PROPERTY_USAGE_DEFAULT : PROPERTY_USAGE_EDITOR;
+			p_list->push_back(PropertyInfo(Variant::STRING_NAME, _get_property_names(i).mapping, PROPERTY_HINT_NONE, "", usage));
 		}
 	}
 }
@@ -172,8 +213,9 @@ bool BlackboardPlan::_property_get_revert(const StringName &p_name, Variant &r_p
 		r_property = StringName();
 		return true;
 	}
-	if (base->var_map.has(p_name)) {
-		r_property = base->var_map[p_name].get_value();
+	const BBVariable *base_var = base->_find_var(p_name);
+	if (base_var) {
+		r_property = base_var->get_value();
 		return true;
 	}
 	return false;
@@ -212,10 +254,44 @@ bool BlackboardPlan::is_prefetching_nodepath_vars() const {
 	}
 }
 
+void BlackboardPlan::set_share_container_defaults(bool p_enable) {
+	share_container_defaults = p_enable;
+	emit_changed();
+}
+
+bool BlackboardPlan::is_sharing_container_defaults() const {
+	if (is_derived()) {
+		return base->is_sharing_container_defaults();
+	} else {
+		return share_container_defaults;
+	}
+}
+
+void BlackboardPlan::set_triggers(const TypedArray<StringName> &p_triggers) {
+	ERR_FAIL_COND_MSG(p_triggers.size() > Blackboard::MAX_TRIGGERS, vformat("BlackboardPlan: A plan can declare at most %d triggers.", Blackboard::MAX_TRIGGERS));
+	triggers = p_triggers;
+	emit_changed();
+}
+
+TypedArray<StringName> BlackboardPlan::get_triggers() const {
+	if (is_derived()) {
+		return base->get_triggers();
+	} else {
+		return triggers;
+	}
+}
+
+// Refreshes the name-to-index map for variables in [p_from, p_to), after they were shifted.
+void BlackboardPlan::_update_indices(uint32_t p_from, uint32_t p_to) {
+	for (uint32_t i = p_from; i < p_to; i++) {
+		var_map[var_list[i].first] = i;
+	}
+}
+
 void BlackboardPlan::add_var(const StringName &p_name, const BBVariable &p_var) {
 	ERR_FAIL_COND(p_name == StringName());
 	ERR_FAIL_COND(var_map.has(p_name));
-	var_map.insert(p_name, p_var);
+	var_map.insert(p_name, var_list.size());
 	var_list.push_back(Pair<StringName, BBVariable>(p_name, p_var));
 	notify_property_list_changed();
 	emit_changed();
@@ -223,21 +299,24 @@ void BlackboardPlan::add_var(const StringName &p_name, const BBVariable &p_var)
 
 void BlackboardPlan::remove_var(const StringName &p_name) {
 	ERR_FAIL_COND(!var_map.has(p_name));
-	var_list.erase(Pair<StringName, BBVariable>(p_name, var_map[p_name]));
+	const uint32_t idx = var_map[p_name];
+	var_list.remove_at(idx);
 	var_map.erase(p_name);
+	_update_indices(idx, var_list.size());
 	notify_property_list_changed();
 	emit_changed();
 }
 
 BBVariable BlackboardPlan::get_var(const StringName &p_name) {
-	ERR_FAIL_COND_V(!var_map.has(p_name), BBVariable());
-	return var_map.get(p_name);
+	const BBVariable *var = _find_var(p_name);
+	ERR_FAIL_NULL_V(var, BBVariable());
+	return *var;
 }
 
 Pair<StringName, BBVariable> BlackboardPlan::get_var_by_index(int p_index) {
 	Pair<StringName, BBVariable> ret;
-	ERR_FAIL_INDEX_V(p_index, (int)var_map.size(), ret);
-	return var_list.get(p_index);
+	ERR_FAIL_INDEX_V(p_index, (int)var_list.size(), ret);
+	return var_list[p_index];
 }
 
 TypedArray<StringName> BlackboardPlan::list_vars() const {
@@ -274,13 +353,10 @@ void BlackboardPlan::rename_var(const StringName &p_name, const StringName &p_ne
 	ERR_FAIL_COND(!var_map.has(p_name));
 	ERR_FAIL_COND(var_map.has(p_new_name));
 
-	BBVariable var = var_map[p_name];
-	Pair<StringName, BBVariable> new_entry(p_new_name, var);
-	Pair<StringName, BBVariable> old_entry(p_name, var);
-	var_list.find(old_entry)->set(new_entry);
-
+	const uint32_t idx = var_map[p_name];
+	var_list[idx].first = p_new_name;
 	var_map.erase(p_name);
-	var_map.insert(p_new_name, var);
+	var_map.insert(p_new_name, idx);
 
 	if (parent_scope_mapping.has(p_name)) {
 		parent_scope_mapping[p_new_name] = parent_scope_mapping[p_name];
@@ -299,19 +375,10 @@ void BlackboardPlan::move_var(int p_index, int p_new_index) {
 		return;
 	}
 
-	List<Pair<StringName, BBVariable>>::Element *E = var_list.front();
-	for (int i = 0; i < p_index; i++) {
-		E = E->next();
-	}
-	List<Pair<StringName, BBVariable>>::Element *E2 = var_list.front();
-	for (int i = 0; i < p_new_index; i++) {
-		E2 = E2->next();
-	}
-
-	var_list.move_before(E, E2);
-	if (p_new_index > p_index) {
-		var_list.move_before(E2, E);
-	}
+	const Pair<StringName, BBVariable> entry = var_list[p_index];
+	var_list.remove_at(p_index);
+	var_list.insert(p_new_index, entry);
+	_update_indices(MIN(p_index, p_new_index), MAX(p_index, p_new_index) + 1);
 
 	notify_property_list_changed();
 	emit_changed();
@@ -335,7 +402,7 @@ void BlackboardPlan::sync_with_base_plan() {
 			continue;
 		}
 
-		BBVariable var = var_map[base_name];
+		BBVariable &var = *_find_var(base_name);
 		if (!var.is_same_prop_info(base_var)) {
 			var.copy_prop_info(base_var);
 			changed = true;
@@ -350,35 +417,31 @@ void BlackboardPlan::sync_with_base_plan() {
 	}
 
 	// Erase variables that do not exist in the base plan.
-	List<StringName> erase_list;
+	LocalVector<StringName> erase_list;
 	for (const Pair<StringName, BBVariable> &p : var_list) {
 		if (!base->has_var(p.first)) {
 			erase_list.push_back(p.first);
 			changed = true;
 		}
 	}
-	while (erase_list.size()) {
-		remove_var(erase_list.front()->get());
-		erase_list.pop_front();
+	for (const StringName &var_name : erase_list) {
+		remove_var(var_name);
 	}
 
-	// Sync order of variables.
-	// Glossary: E - element of current plan, B - element of base plan, F - element of current plan (used for forward search).
+	// Sync order of variables: both plans have the same names now, so take them in the order of the base plan.
 	ERR_FAIL_COND(base->var_list.size() != var_list.size());
-	List<Pair<StringName, BBVariable>>::Element *B = base->var_list.front();
-	for (List<Pair<StringName, BBVariable>>::Element *E = var_list.front(); E; E = E->next()) {
-		if (E->get().first != B->get().first) {
-			List<Pair<StringName, BBVariable>>::Element *F = E->next();
-			while (F) {
-				if (F->get().first == B->get().first) {
-					var_list.move_before(F, E);
-					E = F;
-					break;
-				}
-				F = F->next();
+	for (uint32_t i = 0; i < var_list.size(); i++) {
+		if (var_list[i].first != base->var_list[i].first) {
+			LocalVector<Pair<StringName, BBVariable>> ordered;
+			ordered.resize(var_list.size());
+			for (uint32_t j = 0; j < base->var_list.size(); j++) {
+				ordered[j] = var_list[var_map[base->var_list[j].first]];
 			}
+			var_list = ordered;
+			_update_indices(0, var_list.size());
+			changed = true;
+			break;
 		}
-		B = B->next();
 	}
 
 	if (changed) {
@@ -388,6 +451,7 @@ void BlackboardPlan::sync_with_base_plan() {
 }
 
 Ref<Blackboard> BlackboardPlan::create_blackboard(Node *p_prefetch_root, const Ref<Blackboard> &p_parent_scope, Node *p_prefetch_root_for_base_plan) {
+	LIMBO_PROFILE_ZONE("BlackboardPlan::create_blackboard");
 	ERR_FAIL_COND_V(p_prefetch_root == nullptr && prefetch_nodepath_vars, memnew(Blackboard));
 	Ref<Blackboard> bb = memnew(Blackboard);
 	bb->set_parent(p_parent_scope);
@@ -395,52 +459,279 @@ Ref<Blackboard> BlackboardPlan::create_blackboard(Node *p_prefetch_root, const R
 	return bb;
 }
 
+// Returns the step that resolves p_path, adding steps for the segments that aren't shared with earlier paths.
+uint32_t BlackboardPlan::_add_prefetch_steps(const NodePath &p_path) {
+	LocalVector<Initializer::PrefetchStep> &steps = initializer.prefetch_steps;
+	if (p_path.is_absolute() || p_path.get_name_count() == 0) {
+		Initializer::PrefetchStep step;
+		step.path = p_path;
+		steps.push_back(step);
+		return steps.size() - 1;
+	}
+
+	int parent = -1;
+	for (int i = 0; i < p_path.get_name_count(); i++) {
+		const StringName segment = p_path.get_name(i);
+		if (segment == StringName(".")) {
+			if (parent == -1 && i == p_path.get_name_count() - 1) {
+				// The root itself: there must be a step to point at.
+				Initializer::PrefetchStep step;
+				step.path = p_path;
+				steps.push_back(step);
+				return steps.size() - 1;
+			}
+			continue;
+		}
+		int found = -1;
+		for (uint32_t j = 0; j < steps.size(); j++) {
+			if (steps[j].parent == parent && steps[j].path.get_name_count() == 1 && !steps[j].path.is_absolute() && steps[j].path.get_name(0) == segment) {
+				found = j;
+				break;
+			}
+		}
+		if (found == -1) {
+			Initializer::PrefetchStep step;
+			step.parent = parent;
+			step.path = NodePath(String(segment));
+			steps.push_back(step);
+			found = steps.size() - 1;
+		}
+		parent = found;
+	}
+	return parent;
+}
+
+// Steps are stored after the steps they depend on, so a single forward pass resolves all of them.
+void BlackboardPlan::_resolve_prefetch_steps(Node *p_root, LocalVector<Node *> &r_nodes) const {
+	const LocalVector<Initializer::PrefetchStep> &steps = initializer.prefetch_steps;
+	r_nodes.resize(steps.size());
+	for (uint32_t i = 0; i < steps.size(); i++) {
+		Node *base_node = steps[i].parent < 0 ? p_root : r_nodes[steps[i].parent];
+		r_nodes[i] = base_node ? base_node->get_node_or_null(steps[i].path) : nullptr;
+	}
+}
+
+void BlackboardPlan::_compile_initializer() {
+	initializer.names.clear();
+	initializer.templates.clear();
+	initializer.prefetch_vars.clear();
+	initializer.prefetch_var_steps.clear();
+	initializer.prefetch_paths.clear();
+	initializer.prefetch_steps.clear();
+	initializer.shared_containers.clear();
+	initializer.linked_vars.clear();
+	initializer.bindings.clear();
+	initializer.share_containers = is_sharing_container_defaults();
+	initializer.names.reserve(var_list.size());
+	initializer.templates.reserve(var_list.size());
+
+	for (uint32_t i = 0; i < var_list.size(); i++) {
+		const Pair<StringName, BBVariable> &p = var_list[i];
+		initializer.names.push_back(p.first);
+		const Variant::Type value_type = p.second.get_value().get_type();
+		if (initializer.share_containers && (value_type == Variant::ARRAY || value_type == Variant::DICTIONARY)) {
+			// Read-only containers are not duplicated with the variables, see BBVariable::duplicate_batch().
+			BBVariable shared = p.second.duplicate(true);
+			if (value_type == Variant::ARRAY) {
+				Array arr = shared.get_value();
+				arr.make_read_only();
+			} else {
+				Dictionary dict = shared.get_value();
+				dict.make_read_only();
+			}
+			initializer.templates.push_back(shared);
+			initializer.shared_containers.push_back(Pair<uint32_t, uint32_t>(i, p.second.get_version()));
+		} else {
+			initializer.templates.push_back(p.second);
+		}
+		const StringName *target_var = parent_scope_mapping.getptr(p.first);
+		if (target_var) {
+			// Mapped variables are never prefetched, even if the mapping is empty.
+			if (*target_var != StringName()) {
+				initializer.linked_vars.push_back(Pair<uint32_t, StringName>(i, *target_var));
+			}
+		} else if (prefetch_nodepath_vars && p.second.get_type() == Variant::NODE_PATH) {
+			initializer.prefetch_vars.push_back(i);
+			const NodePath path = p.second.get_value();
+			initializer.prefetch_var_steps.push_back(_add_prefetch_steps(path));
+			initializer.prefetch_paths.push_back(path);
+		}
+		if (p.second.has_binding()) {
+			// * "Body/Arm:rotation:y" - the node part shares steps with prefetched paths.
+			const String binding_path = p.second.get_binding_path();
+			const int colon = binding_path.find(":");
+			ERR_CONTINUE_MSG(colon == -1, vformat("BlackboardPlan: Binding of %s doesn't specify a property: %s", LimboUtility::get_singleton()->decorate_var(p.first), binding_path));
+			Initializer::Binding binding;
+			binding.var = i;
+			binding.step = _add_prefetch_steps(NodePath(colon == 0 ? String(".") : binding_path.substr(0, colon)));
+			binding.accessor.set_path(binding_path.substr(colon + 1));
+			initializer.bindings.push_back(binding);
+		}
+	}
+	initializer.valid = true;
+}
+
+void BlackboardPlan::_ensure_initializer() {
+	bool valid = initializer.valid && initializer.share_containers == is_sharing_container_defaults();
+	// Shared containers are copies, so changes to the plan values have to be checked for.
+	for (uint32_t i = 0; valid && i < initializer.shared_containers.size(); i++) {
+		const Pair<uint32_t, uint32_t> &shared = initializer.shared_containers[i];
+		valid = var_list[shared.first].second.get_version() == shared.second;
+	}
+	// Values can be changed through variables returned by get_var() without notice - steps depend on them.
+	for (uint32_t i = 0; valid && i < initializer.prefetch_vars.size(); i++) {
+		const BBVariable &var = initializer.templates[initializer.prefetch_vars[i]];
+		valid = NodePath(var.get_value()) == initializer.prefetch_paths[i];
+	}
+	if (unlikely(!valid)) {
+		_compile_initializer();
+	}
+}
+
+void BlackboardPlan::warm_up() {
+	if (base.is_valid()) {
+		base->warm_up();
+	}
+	_ensure_initializer();
+}
+
 void BlackboardPlan::populate_blackboard(const Ref<Blackboard> &p_blackboard, bool overwrite, Node *p_prefetch_root, Node *p_prefetch_root_for_base_plan) {
 	ERR_FAIL_COND(p_prefetch_root == nullptr && prefetch_nodepath_vars);
 	ERR_FAIL_COND(p_blackboard.is_null());
-	for (const Pair<StringName, BBVariable> &p : var_list) {
-		if (p_blackboard->has_local_var(p.first) && !overwrite) {
+	_ensure_initializer();
+	_populate_blackboard(p_blackboard, overwrite, p_prefetch_root, p_prefetch_root_for_base_plan, nullptr);
+}
+
+// Creates a blackboard for each of the prefetch roots - e.g. agents instantiated from the same scene.
+// Nodes are resolved from the base plan prefetch root only once for the whole batch.
+TypedArray<Blackboard> BlackboardPlan::create_blackboards(const TypedArray<Node> &p_prefetch_roots, const Ref<Blackboard> &p_parent_scope, Node *p_prefetch_root_for_base_plan) {
+	TypedArray<Blackboard> ret;
+	_ensure_initializer();
+	LocalVector<Node *> base_plan_nodes;
+	if (p_prefetch_root_for_base_plan && !initializer.prefetch_vars.is_empty()) {
+		_resolve_prefetch_steps(p_prefetch_root_for_base_plan, base_plan_nodes);
+	}
+
+	ret.resize(p_prefetch_roots.size());
+	for (int i = 0; i < p_prefetch_roots.size(); i++) {
+		Node *prefetch_root = Object::cast_to<Node>(p_prefetch_roots[i]);
+		ERR_FAIL_COND_V_MSG(prefetch_root == nullptr && prefetch_nodepath_vars, TypedArray<Blackboard>(), "BlackboardPlan: Prefetch root can't be null.");
+		Ref<Blackboard> bb = memnew(Blackboard);
+		bb->set_parent(p_parent_scope);
+		_populate_blackboard(bb, true, prefetch_root, p_prefetch_root_for_base_plan, p_prefetch_root_for_base_plan ? &base_plan_nodes : nullptr);
+		ret[i] = bb;
+	}
+	return ret;
+}
+
+void BlackboardPlan::_populate_blackboard(const Ref<Blackboard> &p_blackboard, bool p_overwrite, Node *p_prefetch_root, Node *p_prefetch_root_for_base_plan, const LocalVector<Node *> *p_base_plan_nodes) {
+	const uint32_t count = initializer.names.size();
+
+	// Variable duplicates share a single allocation - one per blackboard instead of one per variable.
+	// Only mutable arrays and dictionaries are copied deeply: other values, including packed arrays, are copy-on-write.
+	// Hints and binding paths only matter to the plan, so they are left out.
+	LocalVector<BBVariable> vars;
+	LocalVector<bool> kept;
+	if (p_overwrite) {
+		BBVariable::duplicate_batch(initializer.templates, vars, true, true);
+	} else {
+		// Same indices as in the initializer, with empty placeholders for variables that already exist.
+		LocalVector<BBVariable> templates = initializer.templates;
+		kept.resize(count);
+		for (uint32_t i = 0; i < count; i++) {
+			kept[i] = p_blackboard->has_local_var(initializer.names[i]);
+			if (!kept[i]) {
+				continue;
+			}
 #ifdef DEBUG_ENABLED
-			Variant::Type existing_type = p_blackboard->get_var(p.first).get_type();
-			Variant::Type planned_type = p.second.get_type();
+			Variant::Type existing_type = p_blackboard->get_var(initializer.names[i]).get_type();
+			Variant::Type planned_type = templates[i].get_type();
 			if (existing_type != planned_type && existing_type != Variant::NIL && planned_type != Variant::NIL && !(existing_type == Variant::OBJECT && planned_type == Variant::NODE_PATH)) {
 				WARN_PRINT(vformat("BlackboardPlan: Not overwriting %s as it already exists in the blackboard, but it has a different type than planned (%s vs %s). File: %s",
-						LimboUtility::get_singleton()->decorate_var(p.first), Variant::get_type_name(existing_type), Variant::get_type_name(planned_type), get_path()));
+						LimboUtility::get_singleton()->decorate_var(initializer.names[i]), Variant::get_type_name(existing_type), Variant::get_type_name(planned_type), get_path()));
 			}
 #endif
-			continue;
+			templates[i] = BBVariable();
 		}
-		bool has_mapping = parent_scope_mapping.has(p.first);
-		bool do_prefetch = !has_mapping && prefetch_nodepath_vars;
+		BBVariable::duplicate_batch(templates, vars, true, true);
+	}
 
-		// Add a variable duplicate to the blackboard, optionally with NodePath prefetch.
-		BBVariable var = p.second.duplicate(true);
-		if (unlikely(do_prefetch && p.second.get_type() == Variant::NODE_PATH)) {
-			Node *prefetch_root = !p_prefetch_root_for_base_plan || !is_derived() || is_derived_var_changed(p.first) ? p_prefetch_root : p_prefetch_root_for_base_plan;
-			Node *n = prefetch_root->get_node_or_null(p.second.get_value());
-			if (n != nullptr) {
-				var.set_value(n);
-			} else {
-				ERR_PRINT(vformat("BlackboardPlan: Prefetch failed for variable $%s with value: %s", p.first, p.second.get_value()));
-				var.set_value(Variant());
+	LocalVector<Node *> root_nodes;
+	LocalVector<Node *> base_plan_nodes;
+	for (uint32_t i = 0; i < initializer.prefetch_vars.size(); i++) {
+		const uint32_t idx = initializer.prefetch_vars[i];
+		if (!kept.is_empty() && kept[idx]) {
+			continue;
+		}
+		const StringName &var_name = initializer.names[idx];
+		const bool from_base_plan_root = p_prefetch_root_for_base_plan && is_derived() && !is_derived_var_changed(var_name);
+		const LocalVector<Node *> *nodes = &root_nodes;
+		if (from_base_plan_root) {
+			if (p_base_plan_nodes == nullptr) {
+				_resolve_prefetch_steps(p_prefetch_root_for_base_plan, base_plan_nodes);
+				p_base_plan_nodes = &base_plan_nodes;
 			}
+			nodes = p_base_plan_nodes;
+		} else if (root_nodes.is_empty()) {
+			_resolve_prefetch_steps(p_prefetch_root, root_nodes);
 		}
-		p_blackboard->assign_var(p.first, var);
 
-		if (has_mapping) {
-			StringName target_var = parent_scope_mapping[p.first];
-			if (target_var != StringName()) {
-				ERR_CONTINUE_MSG(p_blackboard->get_parent() == nullptr, vformat("BlackboardPlan: Cannot link variable %s to parent scope because the parent scope is not set.", LimboUtility::get_singleton()->decorate_var(p.first)));
-				p_blackboard->link_var(p.first, p_blackboard->get_parent(), target_var);
-			}
+		Node *n = (*nodes)[initializer.prefetch_var_steps[i]];
+		if (n != nullptr) {
+			vars[idx].set_value(n);
+		} else {
+			ERR_PRINT(vformat("BlackboardPlan: Prefetch failed for variable $%s with value: %s", var_name, initializer.templates[idx].get_value()));
+			vars[idx].set_value(Variant());
 		}
 	}
+
+	for (const Initializer::Binding &binding : initializer.bindings) {
+		if (!kept.is_empty() && kept[binding.var]) {
+			continue;
+		}
+		if (root_nodes.is_empty() && p_prefetch_root) {
+			_resolve_prefetch_steps(p_prefetch_root, root_nodes);
+		}
+		Node *n = root_nodes.is_empty() ? nullptr : root_nodes[binding.step];
+		if (n == nullptr) {
+			ERR_PRINT(vformat("BlackboardPlan: Binding failed for variable %s - node not found.", LimboUtility::get_singleton()->decorate_var(initializer.names[binding.var])));
+			continue;
+		}
+		vars[binding.var].bind(n, binding.accessor);
+	}
+
+	p_blackboard->reserve_vars(count);
+	for (uint32_t i = 0; i < count; i++) {
+		if (kept.is_empty() || !kept[i]) {
+			p_blackboard->assign_var(initializer.names[i], vars[i]);
+		}
+	}
+
+	for (const Pair<uint32_t, StringName> &link : initializer.linked_vars) {
+		if (!kept.is_empty() && kept[link.first]) {
+			continue;
+		}
+		const StringName &var_name = initializer.names[link.first];
+		ERR_CONTINUE_MSG(p_blackboard->get_parent() == nullptr, vformat("BlackboardPlan: Cannot link variable %s to parent scope because the parent scope is not set.", LimboUtility::get_singleton()->decorate_var(var_name)));
+		p_blackboard->link_var(var_name, p_blackboard->get_parent(), link.second);
+	}
+
+	const TypedArray<StringName> plan_triggers = get_triggers();
+	for (int i = 0; i < plan_triggers.size(); i++) {
+		p_blackboard->add_trigger(plan_triggers[i]);
+	}
 }
 
 void BlackboardPlan::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_prefetch_nodepath_vars", "enable"), &BlackboardPlan::set_prefetch_nodepath_vars);
 	ClassDB::bind_method(D_METHOD("is_prefetching_nodepath_vars"), &BlackboardPlan::is_prefetching_nodepath_vars);
 
+	ClassDB::bind_method(D_METHOD("set_share_container_defaults", "enable"), &BlackboardPlan::set_share_container_defaults);
+	ClassDB::bind_method(D_METHOD("is_sharing_container_defaults"), &BlackboardPlan::is_sharing_container_defaults);
+
+	ClassDB::bind_method(D_METHOD("set_triggers", "triggers"), &BlackboardPlan::set_triggers);
+	ClassDB::bind_method(D_METHOD("get_triggers"), &BlackboardPlan::get_triggers);
+
 	ClassDB::bind_method(D_METHOD("set_base_plan", "blackboard_plan"), &BlackboardPlan::set_base_plan);
 	ClassDB::bind_method(D_METHOD("get_base_plan"), &BlackboardPlan::get_base_plan);
 	ClassDB::bind_method(D_METHOD("is_derived"), &BlackboardPlan::is_derived);
@@ -448,11 +739,15 @@ void BlackboardPlan::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_parent_scope_plan_provider", "callable"), &BlackboardPlan::set_parent_scope_plan_provider);
 	ClassDB::bind_method(D_METHOD("get_parent_scope_plan_provider"), &BlackboardPlan::get_parent_scope_plan_provider);
 	ClassDB::bind_method(D_METHOD("create_blackboard", "prefetch_root", "parent_scope", "prefetch_root_for_base_plan"), &BlackboardPlan::create_blackboard, DEFVAL(Ref<Blackboard>()), DEFVAL(Variant()));
+	ClassDB::bind_method(D_METHOD("create_blackboards", "prefetch_roots", "parent_scope", "prefetch_root_for_base_plan"), &BlackboardPlan::create_blackboards, DEFVAL(Ref<Blackboard>()), DEFVAL(Variant()));
 	ClassDB::bind_method(D_METHOD("populate_blackboard", "blackboard", "overwrite", "prefetch_root", "prefetch_root_for_base_plan"), &BlackboardPlan::populate_blackboard, DEFVAL(Variant()));
 
 	// To avoid cluttering the member namespace, we do not export unnecessary properties in this class.
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "prefetch_nodepath_vars", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_STORAGE), "set_prefetch_nodepath_vars", "is_prefetching_nodepath_vars");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "share_container_defaults", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_STORAGE), "set_share_container_defaults", "is_sharing_container_defaults");
+	ADD_PROPERTY(PropertyInfo(Variant::ARRAY, "triggers", PROPERTY_HINT_ARRAY_TYPE, "StringName"), "set_triggers", "get_triggers");
 }
 
 BlackboardPlan::BlackboardPlan() {
+	connect(LW_NAME(changed), callable_mp(this, &BlackboardPlan::_invalidate_initializer));
 }
@@ -28,8 +28,9 @@ class BlackboardPlan : public Resource {
 	GDCLASS(BlackboardPlan, Resource);
 
 private:
-	List<Pair<StringName, BBVariable>> var_list;
-	HashMap<StringName, BBVariable> var_map;
+	// Variables in order, and the index of each variable by name.
+	LocalVector<Pair<StringName, BBVariable>> var_list;
+	HashMap<StringName, uint32_t> var_map;
 
 	// When base is not null, the plan is considered to be derived from the base plan.
 	// A derived plan can only have variables that exist in the base plan,
@@ -46,6 +47,75 @@ private:
 	// If true, NodePath variables will be prefetched, so that the vars will contain node pointers instead (upon BB creation/population).
 	bool prefetch_nodepath_vars = true;
 
+	// If true, array and dictionary defaults are made read-only and shared by all blackboards created from the plan.
+	bool share_container_defaults = false;
+
+	// Names of triggers declared in blackboards created from the plan (see Blackboard::add_trigger()).
+	TypedArray<StringName> triggers;
+
+	_FORCE_INLINE_ BBVariable *_find_var(const StringName &p_name) {
+		const uint32_t *idx = var_map.getptr(p_name);
+		return idx ? &var_list[*idx].second : nullptr;
+	}
+	_FORCE_INLINE_ const BBVariable *_find_var(const StringName &p_name) const {
+		const uint32_t *idx = var_map.getptr(p_name);
+		return idx ? &var_list[*idx].second : nullptr;
+	}
+	void _update_indices(uint32_t p_from, uint32_t p_to);
+
+	// Names of the properties of each variable, by index, so that listing properties of a large plan
+	// doesn't build the same strings over and over in the inspector. Entries are rebuilt when the name changes.
+	struct PropertyNames {
+		StringName var_name;
+		String name;
+		String type;
+		String value;
+		String hint;
+		String hint_string;
+		String binding;
+		String mapping;
+	};
+	mutable LocalVector<PropertyNames> property_names;
+	const PropertyNames &_get_property_names(uint32_t p_index) const;
+
+	// What populate_blackboard() needs from the plan, compiled on first use and discarded when the plan changes.
+	// Templates share data with the plan variables, so edited values are picked up without recompiling.
+	struct Initializer {
+		// Prefetched paths are split into a tree of single-segment steps, so that a common prefix
+		// such as "Body/Arm" is looked up once per prefetch root, not once per variable.
+		struct PrefetchStep {
+			int parent = -1; // Earlier step this one is relative to, or -1 for the prefetch root.
+			NodePath path; // One segment, or the whole path if it is absolute or empty.
+		};
+
+		bool valid = false;
+		LocalVector<StringName> names;
+		LocalVector<BBVariable> templates;
+		LocalVector<uint32_t> prefetch_vars; // Indices of NodePath variables to prefetch.
+		LocalVector<uint32_t> prefetch_var_steps; // Step that resolves each variable in prefetch_vars.
+		LocalVector<NodePath> prefetch_paths; // Paths the steps were compiled from.
+		bool share_containers = false;
+		// Indices of variables with a shared read-only container, and the version of the plan variable it was copied from.
+		LocalVector<Pair<uint32_t, uint32_t>> shared_containers;
+		LocalVector<PrefetchStep> prefetch_steps;
+		LocalVector<Pair<uint32_t, StringName>> linked_vars; // Indices of variables mapped to the parent scope, with target names.
+		// Variables bound to a property of a node, resolved with the prefetch steps - relative to the prefetch root.
+		struct Binding {
+			uint32_t var = 0;
+			uint32_t step = 0;
+			LimboPropertyAccessor accessor;
+		};
+		LocalVector<Binding> bindings;
+	};
+	Initializer initializer;
+
+	void _compile_initializer();
+	void _ensure_initializer();
+	uint32_t _add_prefetch_steps(const NodePath &p_path);
+	void _resolve_prefetch_steps(Node *p_root, LocalVector<Node *> &r_nodes) const;
+	void _populate_blackboard(const Ref<Blackboard> &p_blackboard, bool p_overwrite, Node *p_prefetch_root, Node *p_prefetch_root_for_base_plan, const LocalVector<Node *> *p_base_plan_nodes);
+	void _invalidate_initializer() { initializer.valid = false; }
+
 protected:
 	static void _bind_methods();
 
@@ -72,6 +142,12 @@ public:
 	void set_prefetch_nodepath_vars(bool p_enable);
 	bool is_prefetching_nodepath_vars() const;
 
+	void set_share_container_defaults(bool p_enable);
+	bool is_sharing_container_defaults() const;
+
+	void set_triggers(const TypedArray<StringName> &p_triggers);
+	TypedArray<StringName> get_triggers() const;
+
 	void add_var(const StringName &p_name, const BBVariable &p_var);
 	void remove_var(const StringName &p_name);
 	BBVariable get_var(const StringName &p_name);
@@ -88,10 +164,17 @@ public:
 
 	void sync_with_base_plan();
 	_FORCE_INLINE_ bool is_derived() const { return base.is_valid(); }
-	_FORCE_INLINE_ bool is_derived_var_changed(const StringName &p_name) const { return base.is_valid() && var_map.has(p_name) && var_map[p_name].is_value_changed(); }
+	_FORCE_INLINE_ bool is_derived_var_changed(const StringName &p_name) const {
+		const BBVariable *var = base.is_valid() ? _find_var(p_name) : nullptr;
+		return var && var->is_value_changed();
+	}
+
+	// Compiles the initializer used to populate blackboards ahead of time, including the ones of base plans.
+	void warm_up();
 
 	Ref<Blackboard> create_blackboard(Node *p_prefetch_root, const Ref<Blackboard> &p_parent_scope = Ref<Blackboard>(), Node *p_prefetch_root_for_base_plan = nullptr);
 	void populate_blackboard(const Ref<Blackboard> &p_blackboard, bool overwrite, Node *p_prefetch_root, Node *p_prefetch_root_for_base_plan = nullptr);
+	TypedArray<Blackboard> create_blackboards(const TypedArray<Node> &p_prefetch_roots, const Ref<Blackboard> &p_parent_scope = Ref<Blackboard>(), Node *p_prefetch_root_for_base_plan = nullptr);
 
 	BlackboardPlan();
 };
@@ -0,0 +1,169 @@
+/**
+ * shared_blackboard.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "shared_blackboard.h"
+
+#include "../util/limbo_compat.h"
+#include "../util/limbo_string_names.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/os/thread.h"
+#include "scene/main/scene_tree.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/os.hpp>
+#include <godot_cpp/classes/scene_tree.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+SpinLock SharedBlackboard::registry_lock;
+LocalVector<SharedBlackboard *> SharedBlackboard::registry;
+uint64_t SharedBlackboard::connected_tree_id = 0;
+Ref<SharedBlackboard> SharedBlackboard::world;
+
+void SharedBlackboard::set_var(const StringName &p_name, const Variant &p_value) {
+	ERR_FAIL_COND_MSG(p_name == StringName(), "SharedBlackboard: Variable name is empty.");
+	write_lock.lock();
+	pending_writes.push_back(Write{ p_name, p_value });
+	write_lock.unlock();
+}
+
+int SharedBlackboard::get_pending_write_count() const {
+	write_lock.lock();
+	const int count = pending_writes.size();
+	write_lock.unlock();
+	return count;
+}
+
+int SharedBlackboard::publish() {
+	// Swapped out under the lock, so that writers aren't blocked while the values are updated.
+	LocalVector<Write> writes;
+	write_lock.lock();
+	SWAP(writes, pending_writes);
+	write_lock.unlock();
+
+	for (const Write &write : writes) {
+		const uint32_t *slot = slot_map.getptr(write.name);
+		if (slot) {
+			values[*slot] = write.value;
+			versions[*slot] += 1;
+		} else {
+			slot_map.insert(write.name, values.size());
+			values.push_back(write.value);
+			versions.push_back(1);
+		}
+	}
+	if (!writes.is_empty()) {
+		publish_count += 1;
+	}
+	return writes.size();
+}
+
+TypedArray<StringName> SharedBlackboard::list_vars() const {
+	TypedArray<StringName> var_names;
+	var_names.resize(slot_map.size());
+	int idx = 0;
+	for (const KeyValue<StringName, uint32_t> &kv : slot_map) {
+		var_names[idx] = kv.key;
+		idx += 1;
+	}
+	return var_names;
+}
+
+void SharedBlackboard::bind_to(const Ref<Blackboard> &p_blackboard, const StringName &p_name) {
+	ERR_FAIL_COND(p_blackboard.is_null());
+	ERR_FAIL_COND_MSG(!has_var(p_name), vformat("SharedBlackboard: Variable \"%s\" is not published yet.", p_name));
+	p_blackboard->bind_var_to_property(p_name, this, p_name, true);
+}
+
+bool SharedBlackboard::_set(const StringName &p_name, const Variant &p_value) {
+	if (!has_var(p_name)) {
+		return false;
+	}
+	set_var(p_name, p_value);
+	return true;
+}
+
+bool SharedBlackboard::_get(const StringName &p_name, Variant &r_ret) const {
+	const uint32_t *slot = slot_map.getptr(p_name);
+	if (slot == nullptr) {
+		return false;
+	}
+	r_ret = values[*slot];
+	return true;
+}
+
+void SharedBlackboard::_get_property_list(List<PropertyInfo> *p_list) const {
+	for (const KeyValue<StringName, uint32_t> &kv : slot_map) {
+		p_list->push_back(PropertyInfo(values[kv.value].get_type(), kv.key, PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NONE));
+	}
+}
+
+Ref<SharedBlackboard> SharedBlackboard::get_world() {
+	if (unlikely(world.is_null())) {
+		ERR_FAIL_COND_V_MSG(!_is_main_thread(), Ref<SharedBlackboard>(), "SharedBlackboard: The world blackboard must be created on the main thread - access it there first.");
+		world.instantiate();
+	}
+	return world;
+}
+
+bool SharedBlackboard::_is_main_thread() {
+#ifdef LIMBOAI_MODULE
+	return Thread::is_main_thread();
+#elif LIMBOAI_GDEXTENSION
+	return OS::get_singleton()->get_thread_caller_id() == OS::get_singleton()->get_main_thread_id();
+#endif
+}
+
+void SharedBlackboard::_ensure_processing() {
+	SceneTree *tree = SCENE_TREE();
+	if (tree == nullptr || uint64_t(tree->get_instance_id()) == connected_tree_id) {
+		return;
+	}
+	tree->connect(LW_NAME(process_frame), callable_mp_static(&SharedBlackboard::_on_process_frame));
+	connected_tree_id = tree->get_instance_id();
+}
+
+void SharedBlackboard::_on_process_frame() {
+	registry_lock.lock();
+	for (SharedBlackboard *shared : registry) {
+		shared->publish();
+	}
+	registry_lock.unlock();
+}
+
+void SharedBlackboard::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("get_var", "var_name", "default"), &SharedBlackboard::get_var, DEFVAL(Variant()));
+	ClassDB::bind_method(D_METHOD("set_var", "var_name", "value"), &SharedBlackboard::set_var);
+	ClassDB::bind_method(D_METHOD("has_var", "var_name"), &SharedBlackboard::has_var);
+	ClassDB::bind_method(D_METHOD("list_vars"), &SharedBlackboard::list_vars);
+	ClassDB::bind_method(D_METHOD("get_var_version", "var_name"), &SharedBlackboard::get_var_version);
+	ClassDB::bind_method(D_METHOD("publish"), &SharedBlackboard::publish);
+	ClassDB::bind_method(D_METHOD("get_publish_count"), &SharedBlackboard::get_publish_count);
+	ClassDB::bind_method(D_METHOD("get_pending_write_count"), &SharedBlackboard::get_pending_write_count);
+	ClassDB::bind_method(D_METHOD("bind_to", "blackboard", "var_name"), &SharedBlackboard::bind_to);
+	ClassDB::bind_static_method("SharedBlackboard", D_METHOD("get_world"), &SharedBlackboard::get_world);
+}
+
+SharedBlackboard::SharedBlackboard() {
+	registry_lock.lock();
+	registry.push_back(this);
+	registry_lock.unlock();
+	if (_is_main_thread()) {
+		_ensure_processing(); // Otherwise, published by the first shared blackboard created on the main thread.
+	}
+}
+
+SharedBlackboard::~SharedBlackboard() {
+	registry_lock.lock();
+	registry.erase(this);
+	registry_lock.unlock();
+}
@@ -0,0 +1,120 @@
+/**
+ * shared_blackboard.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef SHARED_BLACKBOARD_H
+#define SHARED_BLACKBOARD_H
+
+#include "blackboard.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/object/ref_counted.h"
+#include "core/os/spin_lock.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/templates/spin_lock.hpp>
+using namespace godot;
+#endif // LIMBOAI_GDEXTENSION
+
+// Variables shared by many agents, e.g. a squad, that are read far more often than written.
+// Reads return the values published at the start of the frame and don't lock, so they are safe from
+// the worker threads of BTScheduler. Writes are queued, from any thread, and applied together when
+// the values are published - automatically on each process frame, before the scene is processed.
+// The world blackboard, returned by get_world(), holds the facts visible to all agents.
+class SharedBlackboard : public RefCounted {
+	GDCLASS(SharedBlackboard, RefCounted);
+
+private:
+	struct Write {
+		StringName name;
+		Variant value;
+	};
+
+	// Published values - only modified by publish(), on the main thread. Slots are never removed, so their indices
+	// stay valid. Each slot counts the writes applied to it.
+	HashMap<StringName, uint32_t> slot_map;
+	LocalVector<Variant> values;
+	LocalVector<uint64_t> versions;
+	uint64_t publish_count = 0;
+
+	// Writes queued since the last publish().
+	mutable SpinLock write_lock;
+	LocalVector<Write> pending_writes;
+
+	// Live shared blackboards published on each process frame.
+	static SpinLock registry_lock;
+	static LocalVector<SharedBlackboard *> registry;
+	static uint64_t connected_tree_id;
+
+	static Ref<SharedBlackboard> world;
+
+	static bool _is_main_thread();
+	static void _ensure_processing();
+	static void _on_process_frame();
+
+protected:
+	static void _bind_methods();
+
+	bool _set(const StringName &p_name, const Variant &p_value);
+	bool _get(const StringName &p_name, Variant &r_ret) const;
+	void _get_property_list(List<PropertyInfo> *p_list) const;
+
+#ifdef LIMBOAI_GDEXTENSION
+	String _to_string() const { return "<" + get_class() + "#" + itos(get_instance_id()) + ">"; }
+#endif
+
+public:
+	// Published value of the variable.
+	_FORCE_INLINE_ Variant get_var(const StringName &p_name, const Variant &p_default = Variant()) const {
+		const uint32_t *slot = slot_map.getptr(p_name);
+		return slot ? values[*slot] : p_default;
+	}
+	_FORCE_INLINE_ bool has_var(const StringName &p_name) const { return slot_map.has(p_name); }
+	TypedArray<StringName> list_vars() const;
+
+	// Returns how many writes were applied to the variable, or -1 if it hasn't been published.
+	_FORCE_INLINE_ int64_t get_var_version(const StringName &p_name) const {
+		const uint32_t *slot = slot_map.getptr(p_name);
+		return slot ? int64_t(versions[*slot]) : -1;
+	}
+	// For native code that reads a variable often: the slot is looked up once, and stays valid. Returns -1 if not published.
+	_FORCE_INLINE_ int get_var_slot(const StringName &p_name) const {
+		const uint32_t *slot = slot_map.getptr(p_name);
+		return slot ? int(*slot) : -1;
+	}
+	_FORCE_INLINE_ const Variant &get_var_by_slot(int p_slot) const { return values[p_slot]; }
+	_FORCE_INLINE_ uint64_t get_version_by_slot(int p_slot) const { return versions[p_slot]; }
+
+	// Queues a write, applied on the next publish(). If a variable is written several times, the last write wins.
+	void set_var(const StringName &p_name, const Variant &p_value);
+	// Applies queued writes. Must not run while other threads read from this blackboard. Returns the number of writes applied.
+	int publish();
+	_FORCE_INLINE_ uint64_t get_publish_count() const { return publish_count; }
+	int get_pending_write_count() const;
+
+	// Binds a variable of p_blackboard to the published value, so that tasks using p_blackboard read it as any other variable.
+	// Variables written through the binding are queued, same as set_var().
+	void bind_to(const Ref<Blackboard> &p_blackboard, const StringName &p_name);
+
+	// Blackboard of world-level facts, shared by all agents. Created on the first call, which must be on the main thread.
+	static Ref<SharedBlackboard> get_world();
+	static void free_world() { world.unref(); }
+
+	SharedBlackboard();
+	~SharedBlackboard();
+};
+
+#endif // SHARED_BLACKBOARD_H
@@ -11,19 +11,44 @@
 
 #include "behavior_tree.h"
 
+#include "../util/limbo_compat.h"
+#include "../util/limbo_profiling.h"
 #include "../util/limbo_string_names.h"
+#include "bt_cost_analyzer.h"
+#include "bt_memory_stats.h"
+#include "bt_template_cache.h"
+#include "bt_validator.h"
+#include "tasks/bt_comment.h"
+#include "tasks/composites/bt_selector.h"
+#include "tasks/composites/bt_sequence.h"
+#include "tasks/decorators/bt_always_fail.h"
+#include "tasks/decorators/bt_always_succeed.h"
+#include "tasks/decorators/bt_invert.h"
+#include "tasks/decorators/bt_subtree.h"
 
 #ifdef LIMBOAI_MODULE
 #include "core/error/error_macros.h"
 #include "core/object/class_db.h"
+#include "core/object/script_language.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/templates/hashfuncs.h"
 #include "core/templates/list.h"
 #include "core/variant/variant.h"
+#include "scene/main/scene_tree.h"
 #endif // ! LIMBOAI_MODULE
 
 #ifdef LIMBOAI_GDEXTENSION
 #include "godot_cpp/core/error_macros.hpp"
+#include <godot_cpp/classes/scene_tree.hpp>
+#include <godot_cpp/classes/script.hpp>
+#include <godot_cpp/classes/worker_thread_pool.hpp>
+#include <godot_cpp/templates/hashfuncs.hpp>
 #endif // ! LIMBOAI_GDEXTENSION
 
+LocalVector<BehaviorTree::AsyncInstantiation *> BehaviorTree::async_instantiations;
+LocalVector<BehaviorTree::AsyncPreload *> BehaviorTree::async_preloads;
+uint64_t BehaviorTree::async_tree_id = 0;
+
 void BehaviorTree::set_description(const String &p_value) {
 	description = p_value;
 	emit_changed();
@@ -56,12 +81,167 @@ void BehaviorTree::set_root_task(const Ref<BTTask> &p_value) {
 	_unset_editor_behavior_tree_hint();
 #endif // TOOLS_ENABLED
 	root_task = p_value;
+	recorder_lock.lock();
+	profile.unref();
+	telemetry.unref();
+	recorder_lock.unlock();
+	instance_template.unref();
 #ifdef TOOLS_ENABLED
 	_set_editor_behavior_tree_hint();
 #endif // TOOLS_ENABLED
 	emit_changed();
 }
 
+void BehaviorTree::set_cache_template(bool p_enable) {
+	cache_template = p_enable;
+	instance_template.unref();
+	emit_changed();
+}
+
+// Clones the tasks of all non-lazy subtrees under p_root, unless already present.
+static void _expand_subtrees(BTTask *p_root) {
+	LocalVector<BTTask *> stack;
+	stack.push_back(p_root);
+	while (!stack.is_empty()) {
+		BTTask *task = stack[stack.size() - 1];
+		stack.remove_at(stack.size() - 1);
+		BTSubtree *subtree = Object::cast_to<BTSubtree>(task);
+		if (subtree && !subtree->is_lazy()) {
+			subtree->instantiate_subtree();
+		}
+		for (int i = 0; i < task->get_child_count(); i++) {
+			stack.push_back(task->get_child(i).ptr());
+		}
+	}
+}
+
+Ref<BTTask> BehaviorTree::get_instance_template() const {
+	if (!cache_template || root_task.is_null() || Engine::get_singleton()->is_editor_hint()) {
+		return root_task;
+	}
+	if (instance_template.is_null()) {
+		Ref<BTTask> tmpl = BTTemplateCache::is_enabled() ? BTTemplateCache::load(this) : Ref<BTTask>();
+		if (tmpl.is_null()) {
+			tmpl = root_task->clone();
+			ERR_FAIL_COND_V(tmpl.is_null(), root_task);
+			_expand_subtrees(tmpl.ptr());
+			if (BTTemplateCache::is_enabled()) {
+				BTTemplateCache::store(this, tmpl);
+			}
+		}
+		instance_template = tmpl;
+	}
+	return instance_template;
+}
+
+// Builds the cached templates used by p_task and its subtrees, so that worker threads only read them.
+static void _prepare_templates(const Ref<BTTask> &p_task) {
+	BTSubtree *subtree = Object::cast_to<BTSubtree>(p_task.ptr());
+	if (subtree && subtree->get_subtree().is_valid()) {
+		subtree->get_subtree()->get_instance_template();
+		if (subtree->get_subtree()->get_root_task().is_valid()) {
+			_prepare_templates(subtree->get_subtree()->get_root_task());
+		}
+	}
+	for (int i = 0; i < p_task->get_child_count(); i++) {
+		_prepare_templates(p_task->get_child(i));
+	}
+}
+
+void BehaviorTree::set_compile_instances(bool p_enable) {
+	compile_instances = p_enable;
+	emit_changed();
+}
+
+void BehaviorTree::set_share_identical_updates(bool p_enable) {
+	share_identical_updates = p_enable;
+	emit_changed();
+}
+
+// True if p_task is exactly of class p_class, without a script that could change its behavior.
+static bool _is_plain_task(const Ref<BTTask> &p_task, const StringName &p_class) {
+	Ref<Script> sc = GET_SCRIPT(p_task);
+	return sc.is_null() && p_task->get_class() == p_class;
+}
+
+static int _count_tasks(const Ref<BTTask> &p_task) {
+	int count = 1;
+	for (int i = 0; i < p_task->get_child_count(); i++) {
+		count += _count_tasks(p_task->get_child(i));
+	}
+	return count;
+}
+
+// Detaches and returns the only child of p_task.
+static Ref<BTTask> _take_only_child(const Ref<BTTask> &p_task) {
+	Ref<BTTask> child = p_task->get_child(0);
+	p_task->remove_child_at_index(0);
+	return child;
+}
+
+// Optimizes the subtree of p_task bottom-up, and returns the task that should take its place.
+static Ref<BTTask> _optimize_task(const Ref<BTTask> &p_task, int &r_removed) {
+	for (int i = p_task->get_child_count() - 1; i >= 0; i--) {
+		Ref<BTTask> child = p_task->get_child(i);
+		if (IS_CLASS(child, BTComment)) {
+			r_removed += _count_tasks(child);
+			p_task->remove_child_at_index(i);
+			continue;
+		}
+		Ref<BTTask> replacement = _optimize_task(child, r_removed);
+		if (replacement != child) {
+			p_task->remove_child_at_index(i);
+			p_task->add_child_at_index(replacement, i);
+		}
+	}
+
+	if (p_task->get_child_count() != 1) {
+		return p_task;
+	}
+
+	// A sequence or selector with one child returns whatever the child returns.
+	if (_is_plain_task(p_task, BTSequence::get_class_static()) || _is_plain_task(p_task, BTSelector::get_class_static())) {
+		r_removed += 1;
+		return _take_only_child(p_task);
+	}
+
+	// Two inversions cancel out.
+	if (_is_plain_task(p_task, BTInvert::get_class_static())) {
+		Ref<BTTask> inner = p_task->get_child(0);
+		if (_is_plain_task(inner, BTInvert::get_class_static()) && inner->get_child_count() == 1) {
+			r_removed += 2;
+			p_task->remove_child_at_index(0);
+			return _take_only_child(inner);
+		}
+		return p_task;
+	}
+
+	// The outcome of a status-overriding decorator doesn't depend on inner decorators that only remap SUCCESS and FAILURE.
+	if (_is_plain_task(p_task, BTAlwaysSucceed::get_class_static()) || _is_plain_task(p_task, BTAlwaysFail::get_class_static())) {
+		while (p_task->get_child_count() == 1) {
+			Ref<BTTask> inner = p_task->get_child(0);
+			if (inner->get_child_count() != 1 ||
+					!(_is_plain_task(inner, BTAlwaysSucceed::get_class_static()) || _is_plain_task(inner, BTAlwaysFail::get_class_static()) || _is_plain_task(inner, BTInvert::get_class_static()))) {
+				break;
+			}
+			r_removed += 1;
+			p_task->remove_child_at_index(0);
+			p_task->add_child(_take_only_child(inner));
+		}
+	}
+	return p_task;
+}
+
+int BehaviorTree::optimize() {
+	ERR_FAIL_COND_V_MSG(root_task.is_null(), 0, "BehaviorTree: Root task is not assigned.");
+	int removed = 0;
+	Ref<BTTask> new_root = _optimize_task(root_task, removed);
+	if (removed > 0) {
+		set_root_task(new_root);
+	}
+	return removed;
+}
+
 Ref<BehaviorTree> BehaviorTree::clone() const {
 	Ref<BehaviorTree> copy = duplicate(false);
 	copy->set_path("");
@@ -75,18 +255,413 @@ void BehaviorTree::copy_other(const Ref<BehaviorTree> &p_other) {
 	ERR_FAIL_COND(p_other.is_null());
 	description = p_other->get_description();
 	root_task = p_other->get_root_task();
+	compile_instances = p_other->get_compile_instances();
+	share_identical_updates = p_other->get_share_identical_updates();
+	cache_template = p_other->get_cache_template();
+	instance_template.unref();
 }
 
 Ref<BTInstance> BehaviorTree::instantiate(Node *p_agent, const Ref<Blackboard> &p_blackboard, Node *p_instance_owner, Node *p_custom_scene_root) const {
+	LIMBO_PROFILE_ZONE("BehaviorTree::instantiate");
 	ERR_FAIL_COND_V_MSG(root_task == nullptr, nullptr, "BehaviorTree: Instantiation failed - BT has no valid root task.");
 	ERR_FAIL_NULL_V_MSG(p_agent, nullptr, "BehaviorTree: Instantiation failed - agent can't be null.");
 	ERR_FAIL_NULL_V_MSG(p_instance_owner, nullptr, "BehaviorTree: Instantiation failed -- instance owner can't be null.");
 	ERR_FAIL_NULL_V_MSG(p_blackboard, nullptr, "BehaviorTree: Instantiation failed - blackboard can't be null.");
 	Node *scene_root = p_custom_scene_root ? p_custom_scene_root : p_instance_owner->get_owner();
 	ERR_FAIL_NULL_V_MSG(scene_root, nullptr, "BehaviorTree: Instantiation failed - unable to establish scene root. This is likely due to the instance owner not being owned by a scene node and custom_scene_root being null.");
-	Ref<BTTask> root_copy = root_task->clone();
-	root_copy->initialize(p_agent, p_blackboard, scene_root);
-	return BTInstance::create(root_copy, get_path(), p_instance_owner);
+	const Ref<BTTask> tmpl = get_instance_template();
+	return _create_instance(tmpl->clone(), tmpl->get_instance_id(), p_agent, p_blackboard, p_instance_owner, scene_root);
+}
+
+Ref<BTInstance> BehaviorTree::instantiate_headless(const Ref<Blackboard> &p_blackboard) const {
+	LIMBO_PROFILE_ZONE("BehaviorTree::instantiate_headless");
+	ERR_FAIL_COND_V_MSG(root_task == nullptr, nullptr, "BehaviorTree: Instantiation failed - BT has no valid root task.");
+	ERR_FAIL_NULL_V_MSG(p_blackboard, nullptr, "BehaviorTree: Instantiation failed - blackboard can't be null.");
+	const Ref<BTTask> tmpl = get_instance_template();
+	return _create_instance(tmpl->clone(), tmpl->get_instance_id(), nullptr, p_blackboard, nullptr, nullptr);
+}
+
+void BehaviorTree::instantiate_async(Node *p_agent, const Ref<Blackboard> &p_blackboard, Node *p_instance_owner, const Callable &p_callback, Node *p_custom_scene_root) {
+	ERR_FAIL_COND_MSG(root_task == nullptr, "BehaviorTree: Instantiation failed - BT has no valid root task.");
+	ERR_FAIL_NULL_MSG(p_agent, "BehaviorTree: Instantiation failed - agent can't be null.");
+	ERR_FAIL_NULL_MSG(p_instance_owner, "BehaviorTree: Instantiation failed -- instance owner can't be null.");
+	ERR_FAIL_NULL_MSG(p_blackboard, "BehaviorTree: Instantiation failed - blackboard can't be null.");
+	Node *scene_root = p_custom_scene_root ? p_custom_scene_root : p_instance_owner->get_owner();
+	ERR_FAIL_NULL_MSG(scene_root, "BehaviorTree: Instantiation failed - unable to establish scene root. This is likely due to the instance owner not being owned by a scene node and custom_scene_root being null.");
+
+	AsyncInstantiation *async = memnew(AsyncInstantiation);
+	async->behavior_tree = Ref<BehaviorTree>(this);
+	async->source_root = get_instance_template();
+	_prepare_templates(async->source_root);
+	async->blackboard = p_blackboard;
+	async->agent_id = p_agent->get_instance_id();
+	async->instance_owner_id = p_instance_owner->get_instance_id();
+	async->scene_root_id = scene_root->get_instance_id();
+	async->callback = p_callback;
+#ifdef LIMBOAI_MODULE
+	async->task_id = WorkerThreadPool::get_singleton()->add_native_task(&BehaviorTree::_clone_async, async, false, "BehaviorTree instantiation");
+#elif LIMBOAI_GDEXTENSION
+	async->task_id = WorkerThreadPool::get_singleton()->add_task(callable_mp_static(&BehaviorTree::_clone_async_bound).bind(uint64_t(async)), false, "BehaviorTree instantiation");
+#endif
+	async_instantiations.push_back(async);
+	_connect_async_processing();
+}
+
+void BehaviorTree::_clone_many(void *p_userdata, uint32_t p_index) {
+	BulkClone *bulk = (BulkClone *)p_userdata;
+	Ref<BTTask> root_copy = bulk->source_root->clone();
+	if (root_copy.is_valid()) {
+		_expand_subtrees(root_copy.ptr());
+	}
+	bulk->root_copies[p_index] = root_copy;
+}
+
+// Clones the tasks of all instances in parallel on the WorkerThreadPool, then initializes them on this thread.
+// If p_blackboards is empty, each agent gets a new blackboard created from the blackboard plan.
+TypedArray<BTInstance> BehaviorTree::instantiate_many(const TypedArray<Node> &p_agents, const TypedArray<Blackboard> &p_blackboards, Node *p_instance_owner, Node *p_custom_scene_root) const {
+	LIMBO_PROFILE_ZONE("BehaviorTree::instantiate_many");
+	TypedArray<BTInstance> instances;
+	ERR_FAIL_COND_V_MSG(root_task == nullptr, instances, "BehaviorTree: Instantiation failed - BT has no valid root task.");
+	ERR_FAIL_NULL_V_MSG(p_instance_owner, instances, "BehaviorTree: Instantiation failed -- instance owner can't be null.");
+	ERR_FAIL_COND_V_MSG(!p_blackboards.is_empty() && p_blackboards.size() != p_agents.size(), instances, "BehaviorTree: Instantiation failed - expected one blackboard per agent, or none.");
+	Node *scene_root = p_custom_scene_root ? p_custom_scene_root : p_instance_owner->get_owner();
+	ERR_FAIL_NULL_V_MSG(scene_root, instances, "BehaviorTree: Instantiation failed - unable to establish scene root. This is likely due to the instance owner not being owned by a scene node and custom_scene_root being null.");
+	for (int i = 0; i < p_agents.size(); i++) {
+		ERR_FAIL_NULL_V_MSG(Object::cast_to<Node>(p_agents[i]), instances, vformat("BehaviorTree: Instantiation failed - agent %d is not a valid node.", i));
+		ERR_FAIL_COND_V_MSG(!p_blackboards.is_empty() && Ref<Blackboard>(p_blackboards[i]).is_null(), instances, vformat("BehaviorTree: Instantiation failed - blackboard %d can't be null.", i));
+	}
+	const int count = p_agents.size();
+	if (count == 0) {
+		return instances;
+	}
+
+	TypedArray<Blackboard> blackboards = p_blackboards;
+	if (blackboards.is_empty()) {
+		blackboards.resize(count);
+		for (int i = 0; i < count; i++) {
+			Node *agent = Object::cast_to<Node>(p_agents[i]);
+			blackboards[i] = blackboard_plan.is_valid() ? blackboard_plan->create_blackboard(agent, Ref<Blackboard>(), agent) : Ref<Blackboard>(memnew(Blackboard));
+		}
+	}
+
+	// * Templates are built once here, so that the worker threads only read them.
+	BulkClone bulk;
+	bulk.source_root = get_instance_template();
+	_prepare_templates(bulk.source_root);
+	bulk.root_copies.resize(count);
+	if (count == 1) {
+		_clone_many(&bulk, 0);
+	} else {
+#ifdef LIMBOAI_MODULE
+		const WorkerThreadPool::GroupID group_id = WorkerThreadPool::get_singleton()->add_native_group_task(&BehaviorTree::_clone_many, &bulk, count, -1, true, "BehaviorTree instantiation");
+#elif LIMBOAI_GDEXTENSION
+		const int64_t group_id = WorkerThreadPool::get_singleton()->add_group_task(callable_mp_static(&BehaviorTree::_clone_many_bound).bind(uint64_t(&bulk)), count, -1, true, "BehaviorTree instantiation");
+#endif
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_id);
+	}
+
+	// Initialization calls _setup() of the tasks and may touch the scene, so it stays on this thread.
+	instances.resize(count);
+	for (int i = 0; i < count; i++) {
+		if (bulk.root_copies[i].is_valid()) {
+			instances[i] = _create_instance(bulk.root_copies[i], bulk.source_root->get_instance_id(), Object::cast_to<Node>(p_agents[i]), blackboards[i], p_instance_owner, scene_root);
+		}
+	}
+	return instances;
+}
+
+void BehaviorTree::_connect_async_processing() {
+	SceneTree *tree = SCENE_TREE();
+	if (tree && uint64_t(tree->get_instance_id()) != async_tree_id) {
+		tree->connect(LW_NAME(process_frame), callable_mp_static(&BehaviorTree::_process_async_instantiations));
+		async_tree_id = tree->get_instance_id();
+	}
+}
+
+void BehaviorTree::_clone_async(void *p_userdata) {
+	AsyncInstantiation *async = (AsyncInstantiation *)p_userdata;
+	async->root_copy = async->source_root->clone();
+	if (async->root_copy.is_null()) {
+		return;
+	}
+	// * Subtrees are normally cloned during initialization - doing it here keeps it off the main thread.
+	_expand_subtrees(async->root_copy.ptr());
+}
+
+void BehaviorTree::_finish_async(AsyncInstantiation *p_async) {
+	WorkerThreadPool::get_singleton()->wait_for_task_completion(p_async->task_id);
+	Node *agent = Object::cast_to<Node>(OBJECT_DB_GET_INSTANCE(p_async->agent_id));
+	Node *instance_owner = Object::cast_to<Node>(OBJECT_DB_GET_INSTANCE(p_async->instance_owner_id));
+	Node *scene_root = Object::cast_to<Node>(OBJECT_DB_GET_INSTANCE(p_async->scene_root_id));
+	// * If any of the nodes were freed in the meantime, the instantiation is dropped.
+	Ref<BTInstance> inst;
+	if (p_async->root_copy.is_null()) {
+		ERR_PRINT("BehaviorTree: Async instantiation failed - unable to clone the tasks.");
+	} else if (!agent || !instance_owner || !scene_root) {
+		WARN_PRINT("BehaviorTree: Async instantiation dropped - agent, instance owner or scene root was freed.");
+	} else {
+		inst = p_async->behavior_tree->_create_instance(p_async->root_copy, p_async->source_root->get_instance_id(), agent, p_async->blackboard, instance_owner, scene_root);
+	}
+	// Called with a null instance on failure, so that the caller can recover.
+	if (p_async->callback.is_valid()) {
+		p_async->callback.call(inst);
+	}
+	memdelete(p_async);
+}
+
+void BehaviorTree::_process_async_instantiations() {
+	uint32_t i = 0;
+	while (i < async_instantiations.size()) {
+		AsyncInstantiation *async = async_instantiations[i];
+		if (!WorkerThreadPool::get_singleton()->is_task_completed(async->task_id)) {
+			i++;
+			continue;
+		}
+		// Removed before finishing, since the callback may start another instantiation.
+		async_instantiations.remove_at(i);
+		_finish_async(async);
+	}
+
+	i = 0;
+	while (i < async_preloads.size()) {
+		AsyncPreload *preload = async_preloads[i];
+		if (!WorkerThreadPool::get_singleton()->is_task_completed(preload->task_id)) {
+			i++;
+			continue;
+		}
+		async_preloads.remove_at(i);
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(preload->task_id);
+		// * Not on the worker thread: the loader may return cached trees that are being instantiated on this thread,
+		// and warming up builds their templates and plan initializers without a lock.
+		for (int j = 0; j < preload->trees.size(); j++) {
+			const Ref<BehaviorTree> bt = preload->trees[j];
+			if (bt.is_valid()) {
+				bt->warm_up();
+			}
+		}
+		if (preload->callback.is_valid()) {
+			preload->callback.call(preload->trees);
+		}
+		memdelete(preload);
+	}
+}
+
+void BehaviorTree::_warm_up_tasks(const BTTask *p_task, HashSet<uint64_t> &r_visited) {
+	const BTNewScope *scope = Object::cast_to<BTNewScope>(p_task);
+	if (scope && scope->get_blackboard_plan().is_valid()) {
+		scope->get_blackboard_plan()->warm_up();
+	}
+	const BTSubtree *subtree = Object::cast_to<BTSubtree>(p_task);
+	if (subtree && subtree->get_subtree().is_valid()) {
+		subtree->get_subtree()->_warm_up(r_visited);
+	}
+	for (int i = 0; i < p_task->get_child_count(); i++) {
+		_warm_up_tasks(p_task->get_child(i).ptr(), r_visited);
+	}
+}
+
+void BehaviorTree::_warm_up(HashSet<uint64_t> &r_visited) const {
+	const uint64_t id = uint64_t(get_instance_id());
+	if (r_visited.has(id)) {
+		return;
+	}
+	r_visited.insert(id);
+
+	if (blackboard_plan.is_valid()) {
+		blackboard_plan->warm_up();
+	}
+	if (root_task.is_null()) {
+		return;
+	}
+	_warm_up_tasks(root_task.ptr(), r_visited);
+	_prepare_templates(get_instance_template());
+}
+
+// Prepares the data that is otherwise built on first instantiation: blackboard plan initializers of the tree,
+// its scopes and subtrees, and cached instance templates.
+void BehaviorTree::warm_up() const {
+	HashSet<uint64_t> visited;
+	_warm_up(visited);
+}
+
+void BehaviorTree::_preload_async(void *p_userdata) {
+	AsyncPreload *preload = (AsyncPreload *)p_userdata;
+	preload->trees.resize(preload->paths.size());
+	for (int i = 0; i < preload->paths.size(); i++) {
+		Ref<BehaviorTree> bt = RESOURCE_LOAD(preload->paths[i], "BehaviorTree");
+		if (bt.is_null()) {
+			ERR_PRINT(vformat("BehaviorTree: Failed to preload \"%s\".", preload->paths[i]));
+			continue;
+		}
+		preload->trees[i] = bt;
+	}
+}
+
+// Loads the trees on a worker thread, then warms them up and calls p_callback on the main thread with an array of
+// the loaded trees, in the order of p_paths (null for the ones that failed to load).
+void BehaviorTree::preload_async(const PackedStringArray &p_paths, const Callable &p_callback) {
+	AsyncPreload *preload = memnew(AsyncPreload);
+	preload->paths = p_paths;
+	preload->callback = p_callback;
+#ifdef LIMBOAI_MODULE
+	preload->task_id = WorkerThreadPool::get_singleton()->add_native_task(&BehaviorTree::_preload_async, preload, false, "BehaviorTree preloading");
+#elif LIMBOAI_GDEXTENSION
+	preload->task_id = WorkerThreadPool::get_singleton()->add_task(callable_mp_static(&BehaviorTree::_preload_async_bound).bind(uint64_t(preload)), false, "BehaviorTree preloading");
+#endif
+	async_preloads.push_back(preload);
+	_connect_async_processing();
+}
+
+void BehaviorTree::finish_async_instantiations() {
+	while (!async_instantiations.is_empty()) {
+		AsyncInstantiation *async = async_instantiations[0];
+		async_instantiations.remove_at(0);
+		_finish_async(async);
+	}
+}
+
+void BehaviorTree::free_async_operations() {
+	for (AsyncInstantiation *async : async_instantiations) {
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(async->task_id);
+		memdelete(async);
+	}
+	async_instantiations.clear();
+	for (AsyncPreload *preload : async_preloads) {
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(preload->task_id);
+		memdelete(preload);
+	}
+	async_preloads.clear();
+}
+
+// Returns the root to use, which differs from p_root_copy if the validation replaced it.
+Ref<BTTask> BehaviorTree::_initialize_root(const Ref<BTTask> &p_root_copy, Node *p_agent, const Ref<Blackboard> &p_blackboard, Node *p_scene_root) const {
+	p_root_copy->initialize(p_agent, p_blackboard, p_scene_root);
+	Ref<BTTask> root = p_root_copy;
+	if (BTValidator::is_enabled()) {
+		BTValidator::validate(root, get_path());
+	}
+	return root;
+}
+
+// Initializes a copy of the root task and wraps it in an instance. The copy can be freshly cloned or recycled.
+Ref<BTInstance> BehaviorTree::_create_instance(const Ref<BTTask> &p_root_copy, uint64_t p_template_id, Node *p_agent, const Ref<Blackboard> &p_blackboard, Node *p_instance_owner, Node *p_scene_root) const {
+	Ref<BTTask> root = _initialize_root(p_root_copy, p_agent, p_blackboard, p_scene_root);
+	Ref<BTInstance> inst = BTInstance::create(root, get_path(), p_instance_owner);
+	ERR_FAIL_COND_V(inst.is_null(), nullptr);
+	inst->source_bt_id = get_instance_id();
+	inst->source_template_id = p_template_id;
+	if (compile_instances) {
+		inst->compile();
+	}
+	BTMemoryStats::add_instance(inst.ptr());
+#ifdef DEBUG_ENABLED
+	if (profiling_enabled) {
+		inst->profile = _attach_profile(root);
+	}
+#endif
+	if (telemetry_enabled) {
+		inst->telemetry = _attach_telemetry(root);
+	}
+	return inst;
+}
+
+Dictionary BehaviorTree::analyze_cost() const {
+	return BTCostAnalyzer::analyze(this);
+}
+
+// Live instances are measured when they are created, see BTMemoryStats.
+Dictionary BehaviorTree::get_memory_usage() const {
+	Dictionary usage;
+	usage["instances"] = BTMemoryStats::get_tree_instance_count(get_instance_id());
+	usage["total"] = int64_t(BTMemoryStats::get_tree_memory_usage(get_instance_id()));
+	usage["parameters"] = root_task.is_valid() ? int64_t(BTMemoryStats::get_parameter_memory_usage(root_task.ptr())) : int64_t(0);
+	return usage;
+}
+
+void BehaviorTree::set_profiling_enabled(bool p_enable) {
+#ifdef DEBUG_ENABLED
+	profiling_enabled = p_enable;
+#else
+	ERR_FAIL_COND_MSG(p_enable, "BehaviorTree: Profiling is only available in debug builds.");
+#endif
+}
+
+// Classes and child counts in depth-first order - the stats of a profile or telemetry are attached by position.
+static uint32_t _hash_layout(const BTTask *p_task, uint32_t p_hash = HASH_MURMUR3_SEED) {
+	p_hash = hash_murmur3_one_32(p_task->get_class().hash(), p_hash);
+	p_hash = hash_murmur3_one_32(uint32_t(p_task->get_child_count()), p_hash);
+	for (int i = 0; i < p_task->get_child_count(); i++) {
+		p_hash = _hash_layout(p_task->get_child(i).ptr(), p_hash);
+	}
+	return p_hash;
+}
+
+Ref<BTProfile> BehaviorTree::get_profile() const {
+	recorder_lock.lock();
+	Ref<BTProfile> result = profile;
+	recorder_lock.unlock();
+	return result;
+}
+
+Ref<BTTelemetry> BehaviorTree::get_telemetry() const {
+	recorder_lock.lock();
+	Ref<BTTelemetry> result = telemetry;
+	recorder_lock.unlock();
+	return result;
+}
+
+#ifdef DEBUG_ENABLED
+
+void BehaviorTree::_assign_stats(BTTask *p_task, BTProfile *p_profile, int &r_index) {
+	p_task->data.profile_stats = p_profile->get_task_stats(r_index);
+	r_index += 1;
+	for (int i = 0; i < p_task->get_child_count(); i++) {
+		_assign_stats(p_task->get_child(i).ptr(), p_profile, r_index);
+	}
+}
+
+// Built on the first instantiation after the tasks changed, like the state arena.
+Ref<BTProfile> BehaviorTree::_attach_profile(const Ref<BTTask> &p_instance_root) const {
+	// Laid out from the instance rather than root_task, since comments are not cloned at runtime.
+	const uint32_t layout = _hash_layout(p_instance_root.ptr());
+	recorder_lock.lock();
+	if (profile.is_null() || profile_layout != layout) {
+		Ref<BTProfile> rebuilt = memnew(BTProfile);
+		rebuilt->build(p_instance_root);
+		profile = rebuilt;
+		profile_layout = layout;
+	}
+	Ref<BTProfile> current = profile;
+	recorder_lock.unlock();
+	int index = 0;
+	_assign_stats(p_instance_root.ptr(), current.ptr(), index);
+	return current;
+}
+
+#endif // DEBUG_ENABLED
+
+void BehaviorTree::_assign_counters(BTTask *p_task, BTTelemetry *p_telemetry, int &r_index) {
+	p_task->data.telemetry = p_telemetry->get_task_counters(r_index);
+	r_index += 1;
+	for (int i = 0; i < p_task->get_child_count(); i++) {
+		_assign_counters(p_task->get_child(i).ptr(), p_telemetry, r_index);
+	}
+}
+
+Ref<BTTelemetry> BehaviorTree::_attach_telemetry(const Ref<BTTask> &p_instance_root) const {
+	const uint32_t layout = _hash_layout(p_instance_root.ptr());
+	recorder_lock.lock();
+	if (telemetry.is_null() || telemetry_layout != layout) {
+		Ref<BTTelemetry> rebuilt = memnew(BTTelemetry);
+		rebuilt->build(p_instance_root);
+		telemetry = rebuilt;
+		telemetry_layout = layout;
+	}
+	Ref<BTTelemetry> current = telemetry;
+	recorder_lock.unlock();
+	int index = 0;
+	_assign_counters(p_instance_root.ptr(), current.ptr(), index);
+	return current;
 }
 
 void BehaviorTree::_plan_changed() {
@@ -117,13 +692,37 @@ void BehaviorTree::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_blackboard_plan"), &BehaviorTree::get_blackboard_plan);
 	ClassDB::bind_method(D_METHOD("set_root_task", "task"), &BehaviorTree::set_root_task);
 	ClassDB::bind_method(D_METHOD("get_root_task"), &BehaviorTree::get_root_task);
+	ClassDB::bind_method(D_METHOD("set_cache_template", "enable"), &BehaviorTree::set_cache_template);
+	ClassDB::bind_method(D_METHOD("get_cache_template"), &BehaviorTree::get_cache_template);
+	ClassDB::bind_method(D_METHOD("set_compile_instances", "enable"), &BehaviorTree::set_compile_instances);
+	ClassDB::bind_method(D_METHOD("get_compile_instances"), &BehaviorTree::get_compile_instances);
+	ClassDB::bind_method(D_METHOD("set_share_identical_updates", "enable"), &BehaviorTree::set_share_identical_updates);
+	ClassDB::bind_method(D_METHOD("get_share_identical_updates"), &BehaviorTree::get_share_identical_updates);
 	ClassDB::bind_method(D_METHOD("clone"), &BehaviorTree::clone);
+	ClassDB::bind_method(D_METHOD("optimize"), &BehaviorTree::optimize);
 	ClassDB::bind_method(D_METHOD("copy_other", "other"), &BehaviorTree::copy_other);
+	ClassDB::bind_method(D_METHOD("set_profiling_enabled", "enable"), &BehaviorTree::set_profiling_enabled);
+	ClassDB::bind_method(D_METHOD("is_profiling_enabled"), &BehaviorTree::is_profiling_enabled);
+	ClassDB::bind_method(D_METHOD("get_profile"), &BehaviorTree::get_profile);
+	ClassDB::bind_method(D_METHOD("set_telemetry_enabled", "enable"), &BehaviorTree::set_telemetry_enabled);
+	ClassDB::bind_method(D_METHOD("is_telemetry_enabled"), &BehaviorTree::is_telemetry_enabled);
+	ClassDB::bind_method(D_METHOD("get_telemetry"), &BehaviorTree::get_telemetry);
+	ClassDB::bind_method(D_METHOD("get_memory_usage"), &BehaviorTree::get_memory_usage);
+	ClassDB::bind_method(D_METHOD("analyze_cost"), &BehaviorTree::analyze_cost);
 	ClassDB::bind_method(D_METHOD("instantiate", "agent", "blackboard", "instance_owner", "custom_scene_root"), &BehaviorTree::instantiate, DEFVAL(Variant()));
+	ClassDB::bind_method(D_METHOD("instantiate_headless", "blackboard"), &BehaviorTree::instantiate_headless);
+	ClassDB::bind_method(D_METHOD("instantiate_async", "agent", "blackboard", "instance_owner", "callback", "custom_scene_root"), &BehaviorTree::instantiate_async, DEFVAL(Variant()));
+	ClassDB::bind_method(D_METHOD("instantiate_many", "agents", "blackboards", "instance_owner", "custom_scene_root"), &BehaviorTree::instantiate_many, DEFVAL(Variant()));
+	ClassDB::bind_static_method("BehaviorTree", D_METHOD("finish_async_instantiations"), &BehaviorTree::finish_async_instantiations);
+	ClassDB::bind_method(D_METHOD("warm_up"), &BehaviorTree::warm_up);
+	ClassDB::bind_static_method("BehaviorTree", D_METHOD("preload_async", "paths", "callback"), &BehaviorTree::preload_async);
 
 	ADD_PROPERTY(PropertyInfo(Variant::STRING, "description", PROPERTY_HINT_MULTILINE_TEXT), "set_description", "get_description");
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "blackboard_plan", PROPERTY_HINT_RESOURCE_TYPE, "BlackboardPlan", PROPERTY_USAGE_DEFAULT | PROPERTY_USAGE_EDITOR_INSTANTIATE_OBJECT), "set_blackboard_plan", "get_blackboard_plan");
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "root_task", PROPERTY_HINT_RESOURCE_TYPE, "BTTask", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL), "set_root_task", "get_root_task");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "compile_instances"), "set_compile_instances", "get_compile_instances");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "share_identical_updates"), "set_share_identical_updates", "get_share_identical_updates");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "cache_template"), "set_cache_template", "get_cache_template");
 
 	ADD_SIGNAL(MethodInfo("plan_changed"));
 }
@@ -131,7 +730,24 @@ void BehaviorTree::_bind_methods() {
 BehaviorTree::BehaviorTree() {
 }
 
+BTStateArena *BehaviorTree::_get_state_arena(uint32_t p_block_size) const {
+	state_arena_lock.lock();
+	if (state_arena == nullptr || state_arena->get_block_size() != p_block_size) {
+		if (state_arena) {
+			state_arena->unreference();
+		}
+		state_arena = BTStateArena::create(p_block_size);
+	}
+	state_arena->reference();
+	BTStateArena *arena = state_arena;
+	state_arena_lock.unlock();
+	return arena;
+}
+
 BehaviorTree::~BehaviorTree() {
+	if (state_arena) {
+		state_arena->unreference();
+	}
 	if (Engine::get_singleton()->is_editor_hint() && blackboard_plan.is_valid() &&
 			blackboard_plan->is_connected(LW_NAME(changed), callable_mp(this, &BehaviorTree::_plan_changed))) {
 		blackboard_plan->disconnect(LW_NAME(changed), callable_mp(this, &BehaviorTree::_plan_changed));
@@ -14,26 +14,120 @@
 
 #include "../blackboard/blackboard_plan.h"
 #include "bt_instance.h"
+#include "bt_profile.h"
+#include "bt_state_arena.h"
+#include "bt_telemetry.h"
 #include "tasks/bt_task.h"
 
 #ifdef LIMBOAI_MODULE
 #include "core/io/resource.h"
+#include "core/templates/hash_set.h"
+#include "core/templates/local_vector.h"
 #endif // LIMBOAI_MODULE
 
 #ifdef LIMBOAI_GDEXTENSION
 #include <godot_cpp/classes/resource.hpp>
+#include <godot_cpp/templates/hash_set.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
 using namespace godot;
 #endif // LIMBOAI_GDEXTENSION
 
 class BehaviorTree : public Resource {
 	GDCLASS(BehaviorTree, Resource);
+	friend class BTInstance;
+	friend class BTInstancePool;
 
 private:
 	String description;
 	Ref<BlackboardPlan> blackboard_plan;
 	Ref<BTTask> root_task;
+	bool compile_instances = false;
+	bool share_identical_updates = false;
+	bool cache_template = false;
+	// Runtime copy of the tasks with subtrees expanded, cloned by each instantiation (see set_cache_template()).
+	mutable Ref<BTTask> instance_template;
+
+	bool profiling_enabled = false;
+	// Rebuilt on instantiation if the layout of the instance tasks changed - instances keep the previous profile alive.
+	mutable Ref<BTProfile> profile;
+	mutable uint32_t profile_layout = 0; // Hash of the task layout the profile was built for (see _hash_layout()).
+
+	bool telemetry_enabled = false;
+	// Like the profile: rebuilt on instantiation if the layout changed, kept alive by the instances recording into it.
+	mutable Ref<BTTelemetry> telemetry;
+	mutable uint32_t telemetry_layout = 0;
+	// Guards the profile and telemetry - trees can be instantiated on several threads at once (see instantiate_many()).
+	mutable SpinLock recorder_lock;
+
+	// Task states of compiled instances. Replaced when the number of tasks changes - instances keep the previous one alive.
+	mutable BTStateArena *state_arena = nullptr;
+	mutable SpinLock state_arena_lock;
+
+	// Started with instantiate_async(): the tasks are cloned on a worker thread, and initialized on the main thread.
+	struct AsyncInstantiation {
+		Ref<BehaviorTree> behavior_tree;
+		Ref<BTTask> source_root;
+		Ref<BTTask> root_copy; // Written by the worker thread.
+		Ref<Blackboard> blackboard;
+		ObjectID agent_id;
+		ObjectID instance_owner_id;
+		ObjectID scene_root_id;
+		Callable callback;
+		int64_t task_id = -1;
+	};
+	static LocalVector<AsyncInstantiation *> async_instantiations;
+	static uint64_t async_tree_id;
+
+	static void _clone_async(void *p_userdata);
+#ifdef LIMBOAI_GDEXTENSION
+	static void _clone_async_bound(uint64_t p_userdata) { _clone_async((void *)p_userdata); }
+#endif
+	static void _finish_async(AsyncInstantiation *p_async);
+
+	// Started with preload_async(): the trees are loaded and warmed up on a worker thread.
+	struct AsyncPreload {
+		PackedStringArray paths;
+		Array trees; // Written by the worker thread.
+		Callable callback;
+		int64_t task_id = -1;
+	};
+	static LocalVector<AsyncPreload *> async_preloads;
+
+	static void _preload_async(void *p_userdata);
+#ifdef LIMBOAI_GDEXTENSION
+	static void _preload_async_bound(uint64_t p_userdata) { _preload_async((void *)p_userdata); }
+#endif
+
+	// Shared by the worker threads of instantiate_many(), each cloning some of the roots.
+	struct BulkClone {
+		Ref<BTTask> source_root;
+		LocalVector<Ref<BTTask>> root_copies;
+	};
+
+	static void _clone_many(void *p_userdata, uint32_t p_index);
+#ifdef LIMBOAI_GDEXTENSION
+	static void _clone_many_bound(uint32_t p_index, uint64_t p_userdata) { _clone_many((void *)p_userdata, p_index); }
+#endif
+
+	static void _connect_async_processing();
+	static void _process_async_instantiations();
+
+	static void _warm_up_tasks(const BTTask *p_task, HashSet<uint64_t> &r_visited);
+	void _warm_up(HashSet<uint64_t> &r_visited) const;
 
 	void _plan_changed();
+	Ref<BTTask> _initialize_root(const Ref<BTTask> &p_root_copy, Node *p_agent, const Ref<Blackboard> &p_blackboard, Node *p_scene_root) const;
+	// p_template_id is the instance template p_root_copy was cloned from (see BTInstancePool).
+	Ref<BTInstance> _create_instance(const Ref<BTTask> &p_root_copy, uint64_t p_template_id, Node *p_agent, const Ref<Blackboard> &p_blackboard, Node *p_instance_owner, Node *p_scene_root) const;
+#ifdef DEBUG_ENABLED
+	// Returns the profile that the tasks of p_instance_root record into.
+	Ref<BTProfile> _attach_profile(const Ref<BTTask> &p_instance_root) const;
+	static void _assign_stats(BTTask *p_task, BTProfile *p_profile, int &r_index);
+#endif
+	Ref<BTTelemetry> _attach_telemetry(const Ref<BTTask> &p_instance_root) const;
+	// Returns a new reference to the arena with blocks of p_block_size states.
+	BTStateArena *_get_state_arena(uint32_t p_block_size) const;
+	static void _assign_counters(BTTask *p_task, BTTelemetry *p_telemetry, int &r_index);
 
 #ifdef TOOLS_ENABLED
 	void _set_editor_behavior_tree_hint();
@@ -61,9 +155,44 @@ public:
 	void set_root_task(const Ref<BTTask> &p_value);
 	Ref<BTTask> get_root_task() const { return root_task; }
 
+	void set_cache_template(bool p_enable);
+	bool get_cache_template() const { return cache_template; }
+	// Returns the tasks that instances are cloned from - the cached template if enabled, or the root task.
+	Ref<BTTask> get_instance_template() const;
+
+	void set_compile_instances(bool p_enable);
+	bool get_compile_instances() const { return compile_instances; }
+
+	void set_share_identical_updates(bool p_enable);
+	bool get_share_identical_updates() const { return share_identical_updates; }
+
+	void set_profiling_enabled(bool p_enable);
+	bool is_profiling_enabled() const { return profiling_enabled; }
+	Ref<BTProfile> get_profile() const;
+
+	void set_telemetry_enabled(bool p_enable) { telemetry_enabled = p_enable; }
+	bool is_telemetry_enabled() const { return telemetry_enabled; }
+	Ref<BTTelemetry> get_telemetry() const;
+
+	Dictionary get_memory_usage() const;
+	Dictionary analyze_cost() const;
+
+	// Removes tasks that don't affect the outcome, such as comments and single-child sequences. Returns the number of removed tasks.
+	int optimize();
+
 	Ref<BehaviorTree> clone() const;
 	void copy_other(const Ref<BehaviorTree> &p_other);
 	Ref<BTInstance> instantiate(Node *p_agent, const Ref<Blackboard> &p_blackboard, Node *p_instance_owner, Node *p_custom_scene_root = nullptr) const;
+	// Instantiates without an agent, instance owner and scene root, for simulations that don't use the scene tree (see BTRunner).
+	Ref<BTInstance> instantiate_headless(const Ref<Blackboard> &p_blackboard) const;
+	void instantiate_async(Node *p_agent, const Ref<Blackboard> &p_blackboard, Node *p_instance_owner, const Callable &p_callback, Node *p_custom_scene_root = nullptr);
+	static void finish_async_instantiations();
+	// Drops unfinished async instantiations and preloads without calling their callbacks. Used at shutdown.
+	static void free_async_operations();
+	TypedArray<BTInstance> instantiate_many(const TypedArray<Node> &p_agents, const TypedArray<Blackboard> &p_blackboards, Node *p_instance_owner, Node *p_custom_scene_root = nullptr) const;
+
+	void warm_up() const;
+	static void preload_async(const PackedStringArray &p_paths, const Callable &p_callback);
 
 	BehaviorTree();
 	~BehaviorTree();
@@ -0,0 +1,638 @@
+/**
+ * behavior_tree_format.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "behavior_tree_format.h"
+
+#include "../util/limbo_compat.h"
+#include "../util/limbo_mapped_file.h"
+#include "../util/limbo_snapshot.h"
+#include "behavior_tree.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/io/file_access.h"
+#include "core/object/class_db.h"
+#include "core/object/script_language.h"
+#include "core/templates/hash_map.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/resource_loader.hpp>
+#include <godot_cpp/classes/script.hpp>
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/templates/hash_map.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+// File layout:
+//   u32 magic, u32 version
+//   u32 string count, strings
+//   u32 external count, (u32 type, u32 path) per external resource
+//   u32 object count, u32 class per object
+//   per object: u32 property count, (u32 name, value) per property
+// Object 0 is the BehaviorTree itself. Values are tagged, see ValueTag.
+//
+// The format is position-independent: it holds no pointers, offsets that need fixing up, or alignment
+// requirements, and decoding never writes to it. So files can be decoded straight from a read-only mapping
+// (see LimboMappedFile), which saves copying them into a buffer first. The mapping is released once decoded -
+// the tree is made of regular task objects, and nothing refers to the file afterwards.
+
+namespace {
+
+constexpr uint32_t LBT_MAGIC = 0x3154424C; // "LBT1"
+constexpr uint32_t LBT_VERSION = 1;
+constexpr int MAX_VALUE_DEPTH = 64;
+
+enum ValueTag : uint8_t {
+	TAG_VARIANT, // Value without objects, in engine encoding.
+	TAG_NULL,
+	TAG_OBJECT, // Index into the object table.
+	TAG_EXTERNAL, // Index into the external resource table.
+	TAG_ARRAY, // Array that holds resources, followed by tagged elements.
+	TAG_DICTIONARY,
+};
+
+bool _contains_objects(const Variant &p_value) {
+	switch (p_value.get_type()) {
+		case Variant::OBJECT: {
+			return true;
+		}
+		case Variant::ARRAY: {
+			const Array arr = p_value;
+			for (int i = 0; i < arr.size(); i++) {
+				if (_contains_objects(arr[i])) {
+					return true;
+				}
+			}
+			return false;
+		}
+		case Variant::DICTIONARY: {
+			const Dictionary dict = p_value;
+			const Array keys = dict.keys();
+			for (int i = 0; i < keys.size(); i++) {
+				if (_contains_objects(keys[i]) || _contains_objects(dict[keys[i]])) {
+					return true;
+				}
+			}
+			return false;
+		}
+		default: {
+			return false;
+		}
+	}
+}
+
+class LBTEncoder {
+private:
+	struct Property {
+		uint32_t name = 0;
+		Variant value;
+	};
+
+	LocalVector<StringName> strings;
+	HashMap<StringName, uint32_t> string_indices;
+	LocalVector<Ref<Resource>> externals;
+	HashMap<uint64_t, uint32_t> external_indices;
+	LocalVector<Ref<Resource>> objects;
+	HashMap<uint64_t, uint32_t> object_indices;
+	LocalVector<LocalVector<Property>> properties;
+	Error error = OK;
+
+	uint32_t _intern(const StringName &p_string) {
+		const uint32_t *idx = string_indices.getptr(p_string);
+		if (idx) {
+			return *idx;
+		}
+		string_indices.insert(p_string, strings.size());
+		strings.push_back(p_string);
+		return strings.size() - 1;
+	}
+
+	void _discover(const Variant &p_value);
+	void _add_object(const Ref<Resource> &p_resource);
+	void _write_value(LimboSnapshotWriter &p_writer, const Variant &p_value) const;
+
+public:
+	Error encode(const Ref<Resource> &p_root, PackedByteArray &r_data);
+};
+
+void LBTEncoder::_discover(const Variant &p_value) {
+	if (p_value.get_type() == Variant::ARRAY) {
+		const Array arr = p_value;
+		for (int i = 0; i < arr.size(); i++) {
+			_discover(arr[i]);
+		}
+		return;
+	}
+	if (p_value.get_type() == Variant::DICTIONARY) {
+		const Dictionary dict = p_value;
+		const Array keys = dict.keys();
+		for (int i = 0; i < keys.size(); i++) {
+			_discover(keys[i]);
+			_discover(dict[keys[i]]);
+		}
+		return;
+	}
+	if (p_value.get_type() != Variant::OBJECT) {
+		return;
+	}
+
+	Ref<Resource> res = p_value;
+	if (res.is_null()) {
+		const Object *obj = p_value;
+		if (obj) {
+			WARN_PRINT(vformat("ResourceFormatSaverBehaviorTree: Only resources can be saved, storing null instead of %s.", obj->get_class()));
+		}
+		return;
+	}
+	const uint64_t id = uint64_t(res->get_instance_id());
+	if (object_indices.has(id) || external_indices.has(id)) {
+		return;
+	}
+	if (!RESOURCE_IS_BUILT_IN(res)) {
+		external_indices.insert(id, externals.size());
+		externals.push_back(res);
+		_intern(res->get_class());
+		_intern(res->get_path());
+		return;
+	}
+	_add_object(res);
+}
+
+void LBTEncoder::_add_object(const Ref<Resource> &p_resource) {
+	if (IS_CLASS(p_resource, Script)) {
+		ERR_PRINT("ResourceFormatSaverBehaviorTree: Built-in scripts are not supported. Save the script to a file first.");
+		error = ERR_UNAVAILABLE;
+		return;
+	}
+
+	const uint32_t idx = objects.size();
+	object_indices.insert(uint64_t(p_resource->get_instance_id()), idx);
+	objects.push_back(p_resource);
+	properties.push_back(LocalVector<Property>());
+	_intern(p_resource->get_class());
+
+	LocalVector<Property> props;
+#ifdef LIMBOAI_MODULE
+	const StringName class_name = p_resource->get_class();
+	List<PropertyInfo> plist;
+	p_resource->get_property_list(&plist);
+	for (const PropertyInfo &pi : plist) {
+		if (!(pi.usage & PROPERTY_USAGE_STORAGE)) {
+			continue;
+		}
+		const StringName name = pi.name;
+#elif LIMBOAI_GDEXTENSION
+	TypedArray<Dictionary> plist = p_resource->get_property_list();
+	for (int i = 0; i < plist.size(); i++) {
+		const Dictionary pi = plist[i];
+		if (!(int(pi["usage"]) & PROPERTY_USAGE_STORAGE)) {
+			continue;
+		}
+		const StringName name = pi["name"];
+#endif // LIMBOAI_MODULE & LIMBOAI_GDEXTENSION
+		const Variant value = p_resource->get(name);
+#ifdef LIMBOAI_MODULE
+		// Loaded objects start with class defaults, so those don't need to be stored.
+		bool has_default = false;
+		const Variant default_value = ClassDB::class_get_default_property_value(class_name, name, &has_default);
+		if (has_default && default_value.get_type() == value.get_type() && default_value == value) {
+			continue;
+		}
+#endif
+		Property prop;
+		prop.name = _intern(name);
+		prop.value = value;
+		props.push_back(prop);
+		_discover(value);
+	}
+	properties[idx] = props;
+}
+
+void LBTEncoder::_write_value(LimboSnapshotWriter &p_writer, const Variant &p_value) const {
+	if (!_contains_objects(p_value)) {
+		p_writer.put_u8(TAG_VARIANT);
+		p_writer.put_variant(p_value);
+		return;
+	}
+
+	if (p_value.get_type() == Variant::ARRAY) {
+		const Array arr = p_value;
+		p_writer.put_u8(TAG_ARRAY);
+		p_writer.put_u32(arr.size());
+		for (int i = 0; i < arr.size(); i++) {
+			_write_value(p_writer, arr[i]);
+		}
+	} else if (p_value.get_type() == Variant::DICTIONARY) {
+		const Dictionary dict = p_value;
+		const Array keys = dict.keys();
+		p_writer.put_u8(TAG_DICTIONARY);
+		p_writer.put_u32(keys.size());
+		for (int i = 0; i < keys.size(); i++) {
+			_write_value(p_writer, keys[i]);
+			_write_value(p_writer, dict[keys[i]]);
+		}
+	} else {
+		Ref<Resource> res = p_value;
+		const uint32_t *idx = res.is_valid() ? object_indices.getptr(uint64_t(res->get_instance_id())) : nullptr;
+		if (idx) {
+			p_writer.put_u8(TAG_OBJECT);
+			p_writer.put_u32(*idx);
+			return;
+		}
+		idx = res.is_valid() ? external_indices.getptr(uint64_t(res->get_instance_id())) : nullptr;
+		if (idx) {
+			p_writer.put_u8(TAG_EXTERNAL);
+			p_writer.put_u32(*idx);
+			return;
+		}
+		p_writer.put_u8(TAG_NULL);
+	}
+}
+
+Error LBTEncoder::encode(const Ref<Resource> &p_root, PackedByteArray &r_data) {
+	// The root is always stored as object 0, even if it has a path of its own.
+	_add_object(p_root);
+	if (error != OK) {
+		return error;
+	}
+
+	LimboSnapshotWriter writer;
+	writer.put_u32(LBT_MAGIC);
+	writer.put_u32(LBT_VERSION);
+
+	writer.put_u32(strings.size());
+	for (const StringName &str : strings) {
+		writer.put_string_name(str);
+	}
+
+	writer.put_u32(externals.size());
+	for (const Ref<Resource> &ext : externals) {
+		writer.put_u32(string_indices[ext->get_class()]);
+		writer.put_u32(string_indices[ext->get_path()]);
+	}
+
+	writer.put_u32(objects.size());
+	for (const Ref<Resource> &obj : objects) {
+		writer.put_u32(string_indices[obj->get_class()]);
+	}
+	for (const LocalVector<Property> &props : properties) {
+		writer.put_u32(props.size());
+		for (const Property &prop : props) {
+			writer.put_u32(prop.name);
+			_write_value(writer, prop.value);
+		}
+	}
+
+	r_data = writer.to_bytes();
+	return OK;
+}
+
+class LBTDecoder {
+private:
+	LimboSnapshotReader reader;
+	uint32_t data_size = 0;
+	LocalVector<StringName> strings;
+	LocalVector<Ref<Resource>> externals;
+	LocalVector<Ref<Resource>> objects;
+
+	_FORCE_INLINE_ const StringName &_get_string(uint32_t p_index) {
+		static const StringName empty;
+		if (unlikely(p_index >= strings.size())) {
+			reader.set_failed();
+			return empty;
+		}
+		return strings[p_index];
+	}
+
+	// Guards allocations against counts that can't fit in the remaining data.
+	_FORCE_INLINE_ uint32_t _get_count() {
+		const uint32_t count = reader.get_u32();
+		if (unlikely(count > data_size - reader.get_position())) {
+			reader.set_failed();
+			return 0;
+		}
+		return count;
+	}
+
+	Variant _read_value(int p_depth);
+
+public:
+	// Reads the string table and external resource paths. Returns false if the file is malformed.
+	bool read_header(LocalVector<String> &r_paths, LocalVector<String> &r_types);
+	Ref<Resource> decode(Error *r_error);
+
+	LBTDecoder(const uint8_t *p_data, uint32_t p_size) :
+			reader(p_data, p_size), data_size(p_size) {}
+};
+
+Variant LBTDecoder::_read_value(int p_depth) {
+	if (unlikely(p_depth > MAX_VALUE_DEPTH)) {
+		reader.set_failed();
+		return Variant();
+	}
+	const uint8_t tag = reader.get_u8();
+	switch (tag) {
+		case TAG_VARIANT: {
+			Variant value = reader.get_variant();
+			if (unlikely(value.get_type() == Variant::OBJECT)) {
+				// Objects are only allowed through the resource tables.
+				reader.set_failed();
+				return Variant();
+			}
+			return value;
+		}
+		case TAG_NULL: {
+			return Variant();
+		}
+		case TAG_OBJECT: {
+			const uint32_t idx = reader.get_u32();
+			if (unlikely(idx >= objects.size())) {
+				reader.set_failed();
+				return Variant();
+			}
+			return objects[idx];
+		}
+		case TAG_EXTERNAL: {
+			const uint32_t idx = reader.get_u32();
+			if (unlikely(idx >= externals.size())) {
+				reader.set_failed();
+				return Variant();
+			}
+			return externals[idx];
+		}
+		case TAG_ARRAY: {
+			Array arr;
+			const uint32_t count = _get_count();
+			for (uint32_t i = 0; i < count && !reader.has_failed(); i++) {
+				arr.push_back(_read_value(p_depth + 1));
+			}
+			return arr;
+		}
+		case TAG_DICTIONARY: {
+			Dictionary dict;
+			const uint32_t count = _get_count();
+			for (uint32_t i = 0; i < count && !reader.has_failed(); i++) {
+				const Variant key = _read_value(p_depth + 1);
+				dict[key] = _read_value(p_depth + 1);
+			}
+			return dict;
+		}
+		default: {
+			reader.set_failed();
+			return Variant();
+		}
+	}
+}
+
+bool LBTDecoder::read_header(LocalVector<String> &r_paths, LocalVector<String> &r_types) {
+	if (reader.get_u32() != LBT_MAGIC || reader.get_u32() != LBT_VERSION) {
+		return false;
+	}
+
+	strings.resize(_get_count());
+	for (uint32_t i = 0; i < strings.size(); i++) {
+		strings[i] = reader.get_string_name();
+	}
+
+	const uint32_t num_externals = _get_count();
+	r_paths.resize(num_externals);
+	r_types.resize(num_externals);
+	for (uint32_t i = 0; i < num_externals; i++) {
+		r_types[i] = _get_string(reader.get_u32());
+		r_paths[i] = _get_string(reader.get_u32());
+	}
+	return !reader.has_failed();
+}
+
+Ref<Resource> LBTDecoder::decode(Error *r_error) {
+	LocalVector<String> paths;
+	LocalVector<String> types;
+	if (!read_header(paths, types)) {
+		*r_error = ERR_FILE_CORRUPT;
+		ERR_FAIL_V_MSG(Ref<Resource>(), "ResourceFormatLoaderBehaviorTree: Unrecognized or corrupt data.");
+	}
+
+	externals.resize(paths.size());
+	for (uint32_t i = 0; i < paths.size(); i++) {
+		externals[i] = RESOURCE_LOAD(paths[i], types[i]);
+		if (externals[i].is_null()) {
+			*r_error = ERR_FILE_MISSING_DEPENDENCIES;
+			ERR_FAIL_V_MSG(Ref<Resource>(), vformat("ResourceFormatLoaderBehaviorTree: Failed to load dependency: %s", paths[i]));
+		}
+	}
+
+	// Instantiate the whole table first: properties may refer to any object.
+	objects.resize(_get_count());
+	if (objects.is_empty()) {
+		*r_error = ERR_FILE_CORRUPT;
+		ERR_FAIL_V_MSG(Ref<Resource>(), "ResourceFormatLoaderBehaviorTree: No resources stored.");
+	}
+	for (uint32_t i = 0; i < objects.size(); i++) {
+		const StringName &class_name = _get_string(reader.get_u32());
+		if (reader.has_failed() || !ClassDB::can_instantiate(class_name) || !ClassDB::is_parent_class(class_name, "Resource")) {
+			*r_error = ERR_FILE_CORRUPT;
+			ERR_FAIL_V_MSG(Ref<Resource>(), vformat("ResourceFormatLoaderBehaviorTree: Can't instantiate resource of type \"%s\".", class_name));
+		}
+		objects[i] = ClassDB::instantiate(class_name);
+	}
+	if (!IS_CLASS(objects[0], BehaviorTree)) {
+		*r_error = ERR_FILE_CORRUPT;
+		ERR_FAIL_V_MSG(Ref<Resource>(), "ResourceFormatLoaderBehaviorTree: Stored resource is not a BehaviorTree.");
+	}
+
+	for (uint32_t i = 0; i < objects.size() && !reader.has_failed(); i++) {
+		const uint32_t num_props = _get_count();
+		for (uint32_t j = 0; j < num_props && !reader.has_failed(); j++) {
+			const StringName &name = _get_string(reader.get_u32());
+			const Variant value = _read_value(0);
+			if (!reader.has_failed()) {
+				objects[i]->set(name, value);
+			}
+		}
+	}
+	if (reader.has_failed()) {
+		*r_error = ERR_FILE_CORRUPT;
+		ERR_FAIL_V_MSG(Ref<Resource>(), "ResourceFormatLoaderBehaviorTree: Corrupt data.");
+	}
+
+	*r_error = OK;
+	return objects[0];
+}
+
+} // namespace
+
+//**** ResourceFormatLoaderBehaviorTree
+
+Ref<Resource> ResourceFormatLoaderBehaviorTree::load_from_bytes(const PackedByteArray &p_data, Error *r_error) {
+	return load_from_buffer(p_data.ptr(), p_data.size(), r_error);
+}
+
+Ref<Resource> ResourceFormatLoaderBehaviorTree::load_from_buffer(const uint8_t *p_data, uint32_t p_size, Error *r_error) {
+	Error err = OK;
+	LBTDecoder decoder(p_data, p_size);
+	Ref<Resource> res = decoder.decode(&err);
+	if (r_error) {
+		*r_error = err;
+	}
+	return res;
+}
+
+Ref<Resource> ResourceFormatLoaderBehaviorTree::load_from_file(const String &p_path, Error *r_error) {
+	LimboMappedFile file;
+	const Error err = file.open(p_path);
+	if (err != OK) {
+		if (r_error) {
+			*r_error = ERR_FILE_CANT_OPEN;
+		}
+		return Ref<Resource>();
+	}
+	return load_from_buffer(file.ptr(), file.get_size(), r_error);
+}
+
+#ifdef LIMBOAI_MODULE
+
+Ref<Resource> ResourceFormatLoaderBehaviorTree::load(const String &p_path, const String &p_original_path, Error *r_error, bool p_use_sub_threads, float *r_progress, CacheMode p_cache_mode) {
+	Error err = OK;
+	Ref<Resource> res = load_from_file(p_path, &err);
+	if (r_error) {
+		*r_error = err;
+	}
+	ERR_FAIL_COND_V_MSG(err == ERR_FILE_CANT_OPEN, Ref<Resource>(), vformat("ResourceFormatLoaderBehaviorTree: Cannot open file: %s", p_path));
+	ERR_FAIL_COND_V_MSG(res.is_null(), Ref<Resource>(), vformat("ResourceFormatLoaderBehaviorTree: Failed to load: %s", p_path));
+	return res;
+}
+
+void ResourceFormatLoaderBehaviorTree::get_recognized_extensions(List<String> *p_extensions) const {
+	p_extensions->push_back("lbt");
+}
+
+bool ResourceFormatLoaderBehaviorTree::handles_type(const String &p_type) const {
+	return ClassDB::is_parent_class("BehaviorTree", p_type);
+}
+
+String ResourceFormatLoaderBehaviorTree::get_resource_type(const String &p_path) const {
+	return p_path.get_extension().to_lower() == "lbt" ? "BehaviorTree" : "";
+}
+
+void ResourceFormatLoaderBehaviorTree::get_dependencies(const String &p_path, List<String> *p_dependencies, bool p_add_types) {
+	LimboMappedFile file;
+	file.open(p_path);
+	LBTDecoder decoder(file.ptr(), file.get_size());
+	LocalVector<String> paths;
+	LocalVector<String> types;
+	ERR_FAIL_COND_MSG(!decoder.read_header(paths, types), vformat("ResourceFormatLoaderBehaviorTree: Unrecognized or corrupt file: %s", p_path));
+	for (uint32_t i = 0; i < paths.size(); i++) {
+		p_dependencies->push_back(p_add_types ? paths[i] + "::" + types[i] : paths[i]);
+	}
+}
+
+#elif LIMBOAI_GDEXTENSION
+
+Variant ResourceFormatLoaderBehaviorTree::_load(const String &p_path, const String &p_original_path, bool p_use_sub_threads, int32_t p_cache_mode) const {
+	Error err = OK;
+	Ref<Resource> res = load_from_file(p_path, &err);
+	if (err == ERR_FILE_CANT_OPEN) {
+		ERR_PRINT(vformat("ResourceFormatLoaderBehaviorTree: Cannot open file: %s", p_path));
+		return err;
+	}
+	if (res.is_null()) {
+		ERR_PRINT(vformat("ResourceFormatLoaderBehaviorTree: Failed to load: %s", p_path));
+		return err;
+	}
+	return res;
+}
+
+PackedStringArray ResourceFormatLoaderBehaviorTree::_get_recognized_extensions() const {
+	PackedStringArray extensions;
+	extensions.push_back("lbt");
+	return extensions;
+}
+
+bool ResourceFormatLoaderBehaviorTree::_handles_type(const StringName &p_type) const {
+	return ClassDB::is_parent_class("BehaviorTree", p_type);
+}
+
+String ResourceFormatLoaderBehaviorTree::_get_resource_type(const String &p_path) const {
+	return p_path.get_extension().to_lower() == "lbt" ? "BehaviorTree" : "";
+}
+
+PackedStringArray ResourceFormatLoaderBehaviorTree::_get_dependencies(const String &p_path, bool p_add_types) const {
+	PackedStringArray dependencies;
+	LimboMappedFile file;
+	file.open(p_path);
+	LBTDecoder decoder(file.ptr(), file.get_size());
+	LocalVector<String> paths;
+	LocalVector<String> types;
+	ERR_FAIL_COND_V_MSG(!decoder.read_header(paths, types), dependencies, vformat("ResourceFormatLoaderBehaviorTree: Unrecognized or corrupt file: %s", p_path));
+	for (uint32_t i = 0; i < paths.size(); i++) {
+		dependencies.push_back(p_add_types ? paths[i] + "::" + types[i] : paths[i]);
+	}
+	return dependencies;
+}
+
+#endif // LIMBOAI_MODULE & LIMBOAI_GDEXTENSION
+
+//**** ResourceFormatSaverBehaviorTree
+
+Error ResourceFormatSaverBehaviorTree::save_to_bytes(const Ref<Resource> &p_resource, PackedByteArray &r_data) {
+	ERR_FAIL_COND_V(p_resource.is_null(), ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V_MSG(!IS_CLASS(p_resource, BehaviorTree), ERR_INVALID_PARAMETER, "ResourceFormatSaverBehaviorTree: Only BehaviorTree resources are supported.");
+	LBTEncoder encoder;
+	return encoder.encode(p_resource, r_data);
+}
+
+#ifdef LIMBOAI_MODULE
+
+Error ResourceFormatSaverBehaviorTree::save(const Ref<Resource> &p_resource, const String &p_path, uint32_t p_flags) {
+	PackedByteArray data;
+	Error err = save_to_bytes(p_resource, data);
+	ERR_FAIL_COND_V(err != OK, err);
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(err != OK, err, vformat("ResourceFormatSaverBehaviorTree: Cannot save file: %s", p_path));
+	f->store_buffer(data.ptr(), data.size());
+	return f->get_error() == OK || f->get_error() == ERR_FILE_EOF ? OK : ERR_CANT_CREATE;
+}
+
+bool ResourceFormatSaverBehaviorTree::recognize(const Ref<Resource> &p_resource) const {
+	return p_resource.is_valid() && IS_CLASS(p_resource, BehaviorTree);
+}
+
+void ResourceFormatSaverBehaviorTree::get_recognized_extensions(const Ref<Resource> &p_resource, List<String> *p_extensions) const {
+	if (recognize(p_resource)) {
+		p_extensions->push_back("lbt");
+	}
+}
+
+#elif LIMBOAI_GDEXTENSION
+
+Error ResourceFormatSaverBehaviorTree::_save(const Ref<Resource> &p_resource, const String &p_path, uint32_t p_flags) {
+	PackedByteArray data;
+	Error err = save_to_bytes(p_resource, data);
+	ERR_FAIL_COND_V(err != OK, err);
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::WRITE);
+	ERR_FAIL_COND_V_MSG(f.is_null(), FileAccess::get_open_error(), vformat("ResourceFormatSaverBehaviorTree: Cannot save file: %s", p_path));
+	f->store_buffer(data);
+	return f->get_error() == OK || f->get_error() == ERR_FILE_EOF ? OK : ERR_CANT_CREATE;
+}
+
+bool ResourceFormatSaverBehaviorTree::_recognize(const Ref<Resource> &p_resource) const {
+	return p_resource.is_valid() && IS_CLASS(p_resource, BehaviorTree);
+}
+
+PackedStringArray ResourceFormatSaverBehaviorTree::_get_recognized_extensions(const Ref<Resource> &p_resource) const {
+	PackedStringArray extensions;
+	if (_recognize(p_resource)) {
+		extensions.push_back("lbt");
+	}
+	return extensions;
+}
+
+#endif // LIMBOAI_MODULE & LIMBOAI_GDEXTENSION
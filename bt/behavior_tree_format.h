@@ -0,0 +1,79 @@
+/**
+ * behavior_tree_format.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef BEHAVIOR_TREE_FORMAT_H
+#define BEHAVIOR_TREE_FORMAT_H
+
+#ifdef LIMBOAI_MODULE
+#include "core/io/resource_loader.h"
+#include "core/io/resource_saver.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/resource_format_loader.hpp>
+#include <godot_cpp/classes/resource_format_saver.hpp>
+using namespace godot;
+#endif // LIMBOAI_GDEXTENSION
+
+// Compact binary format for BehaviorTree resources (".lbt"). A file contains an interned string table,
+// a table of external resources, and a flat table of built-in resources (tasks, parameters, plans)
+// that is instantiated in one pass before any properties are assigned. Children are restored through
+// the "children" property of parentless tasks, so they are never cloned while loading.
+class ResourceFormatLoaderBehaviorTree : public ResourceFormatLoader {
+	GDCLASS(ResourceFormatLoaderBehaviorTree, ResourceFormatLoader);
+
+protected:
+	static void _bind_methods() {}
+
+public:
+	static Ref<Resource> load_from_bytes(const PackedByteArray &p_data, Error *r_error = nullptr);
+	// Decodes p_data in place, without copying it. The data is only read.
+	static Ref<Resource> load_from_buffer(const uint8_t *p_data, uint32_t p_size, Error *r_error = nullptr);
+	// Maps the file read-only where possible, see LimboMappedFile.
+	static Ref<Resource> load_from_file(const String &p_path, Error *r_error = nullptr);
+
+#ifdef LIMBOAI_MODULE
+	virtual Ref<Resource> load(const String &p_path, const String &p_original_path = "", Error *r_error = nullptr, bool p_use_sub_threads = false, float *r_progress = nullptr, CacheMode p_cache_mode = CACHE_MODE_REUSE) override;
+	virtual void get_recognized_extensions(List<String> *p_extensions) const override;
+	virtual bool handles_type(const String &p_type) const override;
+	virtual String get_resource_type(const String &p_path) const override;
+	virtual void get_dependencies(const String &p_path, List<String> *p_dependencies, bool p_add_types = false) override;
+#elif LIMBOAI_GDEXTENSION
+	virtual Variant _load(const String &p_path, const String &p_original_path, bool p_use_sub_threads, int32_t p_cache_mode) const override;
+	virtual PackedStringArray _get_recognized_extensions() const override;
+	virtual bool _handles_type(const StringName &p_type) const override;
+	virtual String _get_resource_type(const String &p_path) const override;
+	virtual PackedStringArray _get_dependencies(const String &p_path, bool p_add_types) const override;
+#endif
+};
+
+class ResourceFormatSaverBehaviorTree : public ResourceFormatSaver {
+	GDCLASS(ResourceFormatSaverBehaviorTree, ResourceFormatSaver);
+
+protected:
+	static void _bind_methods() {}
+
+public:
+	// Fails for built-in scripts, which can't be restored without the script language.
+	static Error save_to_bytes(const Ref<Resource> &p_resource, PackedByteArray &r_data);
+
+#ifdef LIMBOAI_MODULE
+	virtual Error save(const Ref<Resource> &p_resource, const String &p_path, uint32_t p_flags = 0) override;
+	virtual bool recognize(const Ref<Resource> &p_resource) const override;
+	virtual void get_recognized_extensions(const Ref<Resource> &p_resource, List<String> *p_extensions) const override;
+#elif LIMBOAI_GDEXTENSION
+	virtual Error _save(const Ref<Resource> &p_resource, const String &p_path, uint32_t p_flags) override;
+	virtual bool _recognize(const Ref<Resource> &p_resource) const override;
+	virtual PackedStringArray _get_recognized_extensions(const Ref<Resource> &p_resource) const override;
+#endif
+};
+
+#endif // BEHAVIOR_TREE_FORMAT_H
@@ -0,0 +1,216 @@
+/**
+ * bt_cost_analyzer.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "bt_cost_analyzer.h"
+
+#include "../util/limbo_compat.h"
+#include "behavior_tree.h"
+#include "tasks/blackboard/bt_check_expression.h"
+#include "tasks/bt_comment.h"
+#include "tasks/composites/bt_dynamic_selector.h"
+#include "tasks/composites/bt_dynamic_sequence.h"
+#include "tasks/composites/bt_parallel.h"
+#include "tasks/composites/bt_planner.h"
+#include "tasks/composites/bt_utility_selector.h"
+#include "tasks/decorators/bt_for_each.h"
+#include "tasks/decorators/bt_repeat.h"
+#include "tasks/decorators/bt_repeat_until_failure.h"
+#include "tasks/decorators/bt_repeat_until_success.h"
+#include "tasks/decorators/bt_subtree.h"
+#include "tasks/scene/bt_check_agent_property.h"
+#include "tasks/scene/bt_find_path.h"
+#include "tasks/scene/bt_query_nearby.h"
+#include "tasks/scene/bt_set_agent_property.h"
+#include "tasks/utility/bt_call_method.h"
+#include "tasks/utility/bt_evaluate_expression.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/object/script_language.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/script.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+double BTCostAnalyzer::get_task_weight(const BTTask *p_task) {
+	ERR_FAIL_NULL_V(p_task, 0.0);
+	if (IS_CLASS(p_task, BTComment)) {
+		return 0.0;
+	}
+	// * Script methods are called through the scripting language on every tick.
+	if (Ref<Script>(p_task->get_script()).is_valid()) {
+		return 5.0;
+	}
+	if (IS_CLASS(p_task, BTFindPath)) {
+		return 10.0;
+	}
+	if (IS_CLASS(p_task, BTQueryNearby)) {
+		return 8.0;
+	}
+	if (IS_CLASS(p_task, BTEvaluateExpression)) {
+		return 6.0;
+	}
+	if (IS_CLASS(p_task, BTPlanner) || IS_CLASS(p_task, BTUtilitySelector)) {
+		return 5.0;
+	}
+	if (IS_CLASS(p_task, BTCallMethod)) {
+		return 4.0;
+	}
+	if (IS_CLASS(p_task, BTCheckExpression)) {
+		return 3.0;
+	}
+	if (IS_CLASS(p_task, BTCheckAgentProperty) || IS_CLASS(p_task, BTSetAgentProperty)) {
+		return 2.0;
+	}
+	return 1.0;
+}
+
+static int _get_iterations_per_tick(const BTTask *p_task) {
+	if (const BTRepeat *repeat = Object::cast_to<BTRepeat>(p_task)) {
+		return repeat->get_max_iterations_per_tick();
+	}
+	if (const BTForEach *for_each = Object::cast_to<BTForEach>(p_task)) {
+		return for_each->get_max_iterations_per_tick();
+	}
+	if (const BTRepeatUntilFailure *until_failure = Object::cast_to<BTRepeatUntilFailure>(p_task)) {
+		return until_failure->get_max_iterations_per_tick();
+	}
+	if (const BTRepeatUntilSuccess *until_success = Object::cast_to<BTRepeatUntilSuccess>(p_task)) {
+		return until_success->get_max_iterations_per_tick();
+	}
+	return 1;
+}
+
+double BTCostAnalyzer::_estimate(const BTTask *p_task, LocalVector<const BehaviorTree *> &r_subtrees) {
+	double children_cost = 0.0;
+	for (int i = 0; i < p_task->get_child_count(); i++) {
+		children_cost += _estimate(p_task->get_child(i).ptr(), r_subtrees);
+	}
+
+	// * Edited subtrees have no children - the tasks of the subtree are counted instead, unless it's recursive.
+	const BTSubtree *subtree = Object::cast_to<BTSubtree>(p_task);
+	if (subtree && p_task->get_child_count() == 0 && subtree->get_subtree().is_valid() && subtree->get_subtree()->get_root_task().is_valid()) {
+		const BehaviorTree *tree = subtree->get_subtree().ptr();
+		if (r_subtrees.find(tree) == -1) {
+			r_subtrees.push_back(tree);
+			children_cost += _estimate(tree->get_root_task().ptr(), r_subtrees);
+			r_subtrees.remove_at(r_subtrees.size() - 1);
+		}
+	}
+	return get_task_weight(p_task) + children_cost * _get_iterations_per_tick(p_task);
+}
+
+double BTCostAnalyzer::estimate_tick_cost(const BTTask *p_task) {
+	ERR_FAIL_NULL_V(p_task, 0.0);
+	LocalVector<const BehaviorTree *> subtrees;
+	return _estimate(p_task, subtrees);
+}
+
+static void _find_subtrees(const BTTask *p_task, LocalVector<const BTSubtree *> &r_found) {
+	if (const BTSubtree *subtree = Object::cast_to<BTSubtree>(p_task)) {
+		r_found.push_back(subtree);
+	}
+	for (int i = 0; i < p_task->get_child_count(); i++) {
+		_find_subtrees(p_task->get_child(i).ptr(), r_found);
+	}
+}
+
+// Returns how many levels of subtrees p_tree nests, counting itself, or -1 if it includes itself.
+// Stops counting past MAX_SUBTREE_DEPTH.
+int BTCostAnalyzer::_get_subtree_depth(const BehaviorTree *p_tree, LocalVector<const BehaviorTree *> &r_subtrees) {
+	if (p_tree == nullptr || p_tree->get_root_task().is_null()) {
+		return 0;
+	}
+	if (r_subtrees.find(p_tree) != -1) {
+		return -1;
+	}
+	if ((int)r_subtrees.size() > MAX_SUBTREE_DEPTH) {
+		return 1;
+	}
+	r_subtrees.push_back(p_tree);
+	LocalVector<const BTSubtree *> nested;
+	_find_subtrees(p_tree->get_root_task().ptr(), nested);
+	int depth = 1;
+	for (const BTSubtree *subtree : nested) {
+		const int nested_depth = _get_subtree_depth(subtree->get_subtree().ptr(), r_subtrees);
+		if (nested_depth == -1) {
+			depth = -1;
+			break;
+		}
+		depth = MAX(depth, nested_depth + 1);
+	}
+	r_subtrees.remove_at(r_subtrees.size() - 1);
+	return depth;
+}
+
+PackedStringArray BTCostAnalyzer::get_task_warnings(const BTTask *p_task) {
+	PackedStringArray warnings;
+	ERR_FAIL_NULL_V(p_task, warnings);
+
+	if (IS_CLASS(p_task, BTEvaluateExpression)) {
+		for (const BTTask *parent = p_task->get_parent().ptr(); parent != nullptr; parent = parent->get_parent().ptr()) {
+			if (IS_CLASS(parent, BTDynamicSelector) || IS_CLASS(parent, BTDynamicSequence)) {
+				warnings.push_back(vformat("BTEvaluateExpression under %s is evaluated again on every tick. Consider storing its result in a blackboard variable outside of the dynamic composite.", parent->get_class()));
+				break;
+			}
+		}
+	} else if (IS_CLASS(p_task, BTCallMethod)) {
+		for (const BTTask *parent = p_task->get_parent().ptr(); parent != nullptr; parent = parent->get_parent().ptr()) {
+			const BTParallel *parallel = Object::cast_to<BTParallel>(parent);
+			if (parallel && parallel->get_repeat()) {
+				warnings.push_back("BTCallMethod under a repeating BTParallel calls the method on every tick. Consider calling it once, before the parallel.");
+				break;
+			}
+		}
+	} else if (const BTSubtree *subtree = Object::cast_to<BTSubtree>(p_task)) {
+		LocalVector<const BehaviorTree *> subtrees;
+		const int depth = _get_subtree_depth(subtree->get_subtree().ptr(), subtrees);
+		if (depth == -1) {
+			warnings.push_back("Subtree includes itself: it's instantiated endlessly at runtime.");
+		} else if (depth > MAX_SUBTREE_DEPTH) {
+			warnings.push_back(vformat("Subtrees are nested more than %d levels deep. Each level is a new blackboard scope and adds to the cost of instantiation.", MAX_SUBTREE_DEPTH));
+		}
+	}
+
+	if (p_task->get_parent().is_null() && !IS_CLASS(p_task, BTComment)) {
+		const double cost = estimate_tick_cost(p_task);
+		if (cost > COST_WARNING_THRESHOLD) {
+			warnings.push_back(vformat("Estimated worst-case cost of a tick is %.0f, above %.0f. Consider splitting the tree, or running expensive branches less often.", cost, COST_WARNING_THRESHOLD));
+		}
+	}
+	return warnings;
+}
+
+void BTCostAnalyzer::_collect_warnings(BTTask *p_task, const String &p_path, PackedStringArray &r_warnings) {
+	const PackedStringArray warnings = get_task_warnings(p_task);
+	for (int i = 0; i < warnings.size(); i++) {
+		r_warnings.push_back(p_path + ": " + warnings[i]);
+	}
+	for (int i = 0; i < p_task->get_child_count(); i++) {
+		BTTask *child = p_task->get_child(i).ptr();
+		_collect_warnings(child, p_path + "/" + child->get_task_name(), r_warnings);
+	}
+}
+
+Dictionary BTCostAnalyzer::analyze(const BehaviorTree *p_tree) {
+	Dictionary report;
+	ERR_FAIL_NULL_V(p_tree, report);
+	PackedStringArray warnings;
+	double cost = 0.0;
+	if (p_tree->get_root_task().is_valid()) {
+		BTTask *root = p_tree->get_root_task().ptr();
+		cost = estimate_tick_cost(root);
+		_collect_warnings(root, root->get_task_name(), warnings);
+	}
+	report["estimated_cost"] = cost;
+	report["warnings"] = warnings;
+	return report;
+}
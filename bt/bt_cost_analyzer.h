@@ -0,0 +1,56 @@
+/**
+ * bt_cost_analyzer.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef BT_COST_ANALYZER_H
+#define BT_COST_ANALYZER_H
+
+#include "tasks/bt_task.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/templates/local_vector.h"
+#include "core/variant/dictionary.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+using namespace godot;
+#endif // LIMBOAI_GDEXTENSION
+
+// Static analysis of behavior trees that needs no instance: estimates the cost of a tick from relative weights
+// of the task classes, and finds patterns that are expensive at runtime. The findings are shown as configuration
+// warnings in the editor and printed on export. For measured costs, see BTProfile.
+class BTCostAnalyzer {
+public:
+	static constexpr int MAX_SUBTREE_DEPTH = 4;
+	static constexpr double COST_WARNING_THRESHOLD = 100.0;
+
+private:
+	static double _estimate(const BTTask *p_task, LocalVector<const BehaviorTree *> &r_subtrees);
+	static int _get_subtree_depth(const BehaviorTree *p_tree, LocalVector<const BehaviorTree *> &r_subtrees);
+	static void _collect_warnings(BTTask *p_task, const String &p_path, PackedStringArray &r_warnings);
+
+public:
+	// Relative cost of ticking p_task itself, excluding its children. Plain built-in tasks weigh 1.0.
+	static double get_task_weight(const BTTask *p_task);
+	// Worst-case cost of a single tick of p_task: every child that may run in the same tick is counted,
+	// including the tasks of subtrees.
+	static double estimate_tick_cost(const BTTask *p_task);
+	// Warnings about expensive patterns involving p_task. Only relies on the parents of the task, so it works
+	// on edited trees.
+	static PackedStringArray get_task_warnings(const BTTask *p_task);
+
+	// Analyzes all tasks of p_tree. Returns {"estimated_cost": float, "warnings": PackedStringArray},
+	// with each warning prefixed by the path of its task.
+	static Dictionary analyze(const BehaviorTree *p_tree);
+};
+
+#endif // BT_COST_ANALYZER_H
@@ -0,0 +1,282 @@
+/**
+ * bt_crowd.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "bt_crowd.h"
+
+#include "../util/limbo_compat.h"
+#include "../util/limbo_profiling.h"
+#include "../util/limbo_string_names.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/config/engine.h"
+#include "core/error/error_macros.h"
+#include "core/object/class_db.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/core/class_db.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+VARIANT_ENUM_CAST(BTCrowd::UpdateMode);
+
+void BTCrowd::set_behavior_tree(const Ref<BehaviorTree> &p_tree) {
+	ERR_FAIL_COND_MSG(!agents.is_empty(), "BTCrowd: Can't change the behavior tree while the crowd has agents. Call clear_agents() first.");
+	behavior_tree = p_tree;
+}
+
+void BTCrowd::set_update_mode(UpdateMode p_mode) {
+	update_mode = p_mode;
+	_update_processing();
+}
+
+void BTCrowd::set_active(bool p_active) {
+	active = p_active;
+	_update_processing();
+}
+
+void BTCrowd::set_seed(int64_t p_seed) {
+	seed = p_seed;
+	if (seed != 0) {
+		rng.seed(uint64_t(seed));
+	} else {
+		const uint64_t high = uint64_t(RANDF() * 4294967296.0);
+		rng.seed((high << 32) | uint64_t(RANDF() * 4294967296.0));
+	}
+}
+
+void BTCrowd::_update_processing() {
+	bool enabled = active && !Engine::get_singleton()->is_editor_hint();
+	set_process(update_mode == UpdateMode::IDLE && enabled);
+	set_physics_process(update_mode == UpdateMode::PHYSICS && enabled);
+}
+
+int BTCrowd::add_agent(Node *p_agent, const Ref<Blackboard> &p_blackboard) {
+	ERR_FAIL_NULL_V_MSG(p_agent, -1, "BTCrowd: Agent can't be null.");
+	ERR_FAIL_COND_V_MSG(behavior_tree.is_null(), -1, "BTCrowd: Can't add an agent - needs a valid behavior tree.");
+	ERR_FAIL_COND_V_MSG(agent_indices.has(p_agent->get_instance_id()), -1, "BTCrowd: Agent is already in the crowd.");
+	ERR_FAIL_COND_V_MSG(updating, -1, "BTCrowd: Can't add agents during an update.");
+
+	Ref<Blackboard> bb = p_blackboard;
+	if (bb.is_null()) {
+		Ref<BlackboardPlan> plan = behavior_tree->get_blackboard_plan();
+		bb = plan.is_valid() ? plan->create_blackboard(p_agent, Ref<Blackboard>(), p_agent) : Ref<Blackboard>(memnew(Blackboard));
+	}
+	// * Agents spawned at runtime are often not owned by a scene - they serve as the scene root then.
+	Node *scene_root = get_owner() ? get_owner() : p_agent;
+	Ref<BTInstance> instance = behavior_tree->instantiate(p_agent, bb, this, scene_root);
+	ERR_FAIL_COND_V_MSG(instance.is_null(), -1, "BTCrowd: Failed to instantiate behavior tree.");
+
+	const uint32_t index = agents.size();
+	agents.push_back(p_agent->get_instance_id());
+	instances.push_back(instance);
+	roots.push_back(instance->get_root_task().ptr());
+	blackboards.push_back(bb);
+	statuses.push_back(BT::FRESH);
+	agent_indices.insert(p_agent->get_instance_id(), index);
+	p_agent->connect(LW_NAME(tree_exited), callable_mp(this, &BTCrowd::_on_agent_exited).bind(p_agent->get_instance_id()));
+	return index;
+}
+
+void BTCrowd::_remove_at(uint32_t p_index) {
+	const ObjectID agent_id = agents[p_index];
+	Node *agent = Object::cast_to<Node>(OBJECT_DB_GET_INSTANCE(agent_id));
+	if (agent) {
+		const Callable on_exited = callable_mp(this, &BTCrowd::_on_agent_exited).bind(agent_id);
+		if (agent->is_connected(LW_NAME(tree_exited), on_exited)) {
+			agent->disconnect(LW_NAME(tree_exited), on_exited);
+		}
+		if (roots[p_index]->get_status() == BT::RUNNING) {
+			roots[p_index]->abort();
+		}
+	}
+	// * The tasks of a freed agent are released without aborting - exiting them could access the agent.
+	agent_indices.erase(agent_id);
+
+	const uint32_t last = agents.size() - 1;
+	if (p_index != last) {
+		agents[p_index] = agents[last];
+		instances[p_index] = instances[last];
+		roots[p_index] = roots[last];
+		blackboards[p_index] = blackboards[last];
+		statuses[p_index] = statuses[last];
+		agent_indices[agents[p_index]] = p_index;
+	}
+	agents.resize(last);
+	instances.resize(last);
+	roots.resize(last);
+	blackboards.resize(last);
+	statuses.resize(last);
+}
+
+void BTCrowd::_request_removal(ObjectID p_agent_id) {
+	if (updating) {
+		// * Tasks of the agent may still be on the stack - removed after the update.
+		pending_removals.push_back(p_agent_id);
+		return;
+	}
+	const uint32_t *index = agent_indices.getptr(p_agent_id);
+	if (index) {
+		_remove_at(*index);
+	}
+}
+
+// Agents freed outside of the scene tree don't emit a signal.
+void BTCrowd::_remove_freed_agents() {
+	for (int64_t i = int64_t(agents.size()) - 1; i >= 0; i--) {
+		if (OBJECT_DB_GET_INSTANCE(agents[i]) == nullptr) {
+			_remove_at(i);
+		}
+	}
+}
+
+// Reparenting exits the scene tree too - the check is deferred until the agent had a chance to re-enter it.
+void BTCrowd::_on_agent_exited(ObjectID p_agent_id) {
+	if (exited_agents.is_empty()) {
+		callable_mp(this, &BTCrowd::_drop_exited_agents).call_deferred();
+	}
+	exited_agents.push_back(p_agent_id);
+}
+
+void BTCrowd::_drop_exited_agents() {
+	const LocalVector<ObjectID> exited = exited_agents;
+	exited_agents.clear();
+	for (const ObjectID &id : exited) {
+		Node *agent = Object::cast_to<Node>(OBJECT_DB_GET_INSTANCE(id));
+		if (agent == nullptr || !agent->is_inside_tree()) {
+			_request_removal(id);
+		}
+	}
+}
+
+void BTCrowd::remove_agent(Node *p_agent) {
+	ERR_FAIL_NULL(p_agent);
+	ERR_FAIL_COND_MSG(!agent_indices.has(p_agent->get_instance_id()), "BTCrowd: Agent is not in the crowd.");
+	_request_removal(p_agent->get_instance_id());
+}
+
+void BTCrowd::clear_agents() {
+	ERR_FAIL_COND_MSG(updating, "BTCrowd: Can't clear agents during an update.");
+	while (!agents.is_empty()) {
+		_remove_at(agents.size() - 1);
+	}
+}
+
+bool BTCrowd::has_agent(Node *p_agent) const {
+	return p_agent != nullptr && agent_indices.has(p_agent->get_instance_id());
+}
+
+Node *BTCrowd::get_agent(int p_index) const {
+	ERR_FAIL_INDEX_V(p_index, (int)agents.size(), nullptr);
+	return Object::cast_to<Node>(OBJECT_DB_GET_INSTANCE(agents[p_index]));
+}
+
+Ref<Blackboard> BTCrowd::get_agent_blackboard(int p_index) const {
+	ERR_FAIL_INDEX_V(p_index, (int)blackboards.size(), Ref<Blackboard>());
+	return blackboards[p_index];
+}
+
+BT::Status BTCrowd::get_agent_status(int p_index) const {
+	ERR_FAIL_INDEX_V(p_index, (int)statuses.size(), BT::FRESH);
+	return statuses[p_index];
+}
+
+double BTCrowd::get_agent_elapsed_time(int p_index) const {
+	ERR_FAIL_INDEX_V(p_index, (int)roots.size(), 0.0);
+	return roots[p_index]->get_elapsed_time();
+}
+
+Ref<BTInstance> BTCrowd::get_agent_instance(int p_index) const {
+	ERR_FAIL_INDEX_V(p_index, (int)instances.size(), Ref<BTInstance>());
+	return instances[p_index];
+}
+
+void BTCrowd::update(double p_delta) {
+	LIMBO_PROFILE_ZONE("BTCrowd::update");
+	_remove_freed_agents();
+	if (roots.is_empty()) {
+		return;
+	}
+	for (const Ref<BTInstance> &instance : instances) {
+		instance->advance_clock(p_delta);
+	}
+
+	// * The crowd has a single random stream, and its ticks are never reactive (see BTTask::_begin_batch_tick()).
+	BTInstance::SleepRequest *outer_request = BTInstance::sleep_request;
+	LimboRNG *outer_rng = BTInstance::current_rng;
+	BTInstance::sleep_request = nullptr;
+	BTInstance::current_rng = &rng;
+	updating = true;
+	BTTask::TaskBatchContext batch;
+	batch.tasks = roots.ptr();
+	batch.count = roots.size();
+	batch.delta = p_delta;
+	batch.statuses = statuses.ptr();
+	BTTask::execute_batch(batch);
+	updating = false;
+	BTInstance::sleep_request = outer_request;
+	BTInstance::current_rng = outer_rng;
+
+	for (const ObjectID &id : pending_removals) {
+		_request_removal(id);
+	}
+	pending_removals.clear();
+}
+
+void BTCrowd::_notification(int p_notification) {
+	switch (p_notification) {
+		case NOTIFICATION_PROCESS: {
+			update(get_process_delta_time());
+		} break;
+		case NOTIFICATION_PHYSICS_PROCESS: {
+			update(get_physics_process_delta_time());
+		} break;
+		case NOTIFICATION_READY: {
+			_update_processing();
+		} break;
+	}
+}
+
+void BTCrowd::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_behavior_tree", "behavior_tree"), &BTCrowd::set_behavior_tree);
+	ClassDB::bind_method(D_METHOD("get_behavior_tree"), &BTCrowd::get_behavior_tree);
+	ClassDB::bind_method(D_METHOD("set_update_mode", "update_mode"), &BTCrowd::set_update_mode);
+	ClassDB::bind_method(D_METHOD("get_update_mode"), &BTCrowd::get_update_mode);
+	ClassDB::bind_method(D_METHOD("set_active", "active"), &BTCrowd::set_active);
+	ClassDB::bind_method(D_METHOD("get_active"), &BTCrowd::get_active);
+	ClassDB::bind_method(D_METHOD("set_seed", "seed"), &BTCrowd::set_seed);
+	ClassDB::bind_method(D_METHOD("get_seed"), &BTCrowd::get_seed);
+
+	ClassDB::bind_method(D_METHOD("add_agent", "agent", "blackboard"), &BTCrowd::add_agent, DEFVAL(Variant()));
+	ClassDB::bind_method(D_METHOD("remove_agent", "agent"), &BTCrowd::remove_agent);
+	ClassDB::bind_method(D_METHOD("clear_agents"), &BTCrowd::clear_agents);
+	ClassDB::bind_method(D_METHOD("has_agent", "agent"), &BTCrowd::has_agent);
+	ClassDB::bind_method(D_METHOD("get_agent_count"), &BTCrowd::get_agent_count);
+	ClassDB::bind_method(D_METHOD("get_agent", "index"), &BTCrowd::get_agent);
+	ClassDB::bind_method(D_METHOD("get_agent_blackboard", "index"), &BTCrowd::get_agent_blackboard);
+	ClassDB::bind_method(D_METHOD("get_agent_status", "index"), &BTCrowd::get_agent_status);
+	ClassDB::bind_method(D_METHOD("get_agent_elapsed_time", "index"), &BTCrowd::get_agent_elapsed_time);
+	ClassDB::bind_method(D_METHOD("get_agent_instance", "index"), &BTCrowd::get_agent_instance);
+	ClassDB::bind_method(D_METHOD("update", "delta"), &BTCrowd::update);
+
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "behavior_tree", PROPERTY_HINT_RESOURCE_TYPE, "BehaviorTree"), "set_behavior_tree", "get_behavior_tree");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "update_mode", PROPERTY_HINT_ENUM, "Idle,Physics,Manual"), "set_update_mode", "get_update_mode");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "active"), "set_active", "get_active");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "seed"), "set_seed", "get_seed");
+
+	BIND_ENUM_CONSTANT(IDLE);
+	BIND_ENUM_CONSTANT(PHYSICS);
+	BIND_ENUM_CONSTANT(MANUAL);
+}
+
+BTCrowd::BTCrowd() {
+	set_seed(0);
+}
@@ -0,0 +1,111 @@
+/**
+ * bt_crowd.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef BT_CROWD_H
+#define BT_CROWD_H
+
+#include "../blackboard/blackboard.h"
+#include "../util/limbo_rng.h"
+#include "behavior_tree.h"
+#include "bt_instance.h"
+#include "tasks/bt_task.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "scene/main/node.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/node.hpp>
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+using namespace godot;
+#endif // LIMBOAI_GDEXTENSION
+
+// Runs one behavior tree for many agents. The tree is executed node by node across all agents (see BTTask::_tick_batch()),
+// with the per-agent data kept in parallel arrays, instead of each agent having its own BTPlayer.
+class BTCrowd : public Node {
+	GDCLASS(BTCrowd, Node);
+
+public:
+	enum UpdateMode : unsigned int {
+		IDLE, // automatically call update() during NOTIFICATION_PROCESS
+		PHYSICS, // automatically call update() during NOTIFICATION_PHYSICS
+		MANUAL, // manually update the crowd: user must call update(delta)
+	};
+
+private:
+	Ref<BehaviorTree> behavior_tree;
+	UpdateMode update_mode = UpdateMode::PHYSICS;
+	bool active = true;
+	int64_t seed = 0;
+	LimboRNG rng;
+
+	// Per-agent columns, indexed by agent. Agents are swapped with the last one on removal, so the columns stay dense.
+	// * Agents are referenced by ID - they may be freed while in the crowd, and are looked up before each use.
+	LocalVector<ObjectID> agents;
+	LocalVector<Ref<BTInstance>> instances;
+	LocalVector<BTTask *> roots;
+	LocalVector<Ref<Blackboard>> blackboards;
+	LocalVector<BT::Status> statuses;
+	HashMap<ObjectID, uint32_t> agent_indices;
+	bool updating = false;
+	LocalVector<ObjectID> pending_removals; // Agents removed during an update.
+	LocalVector<ObjectID> exited_agents; // Agents that left the scene tree - dropped unless they re-enter it this frame.
+
+	void _update_processing();
+	void _remove_at(uint32_t p_index);
+	void _remove_freed_agents();
+	void _on_agent_exited(ObjectID p_agent_id);
+	void _drop_exited_agents();
+	void _request_removal(ObjectID p_agent_id);
+
+protected:
+	static void _bind_methods();
+
+	void _notification(int p_notification);
+
+#ifdef LIMBOAI_GDEXTENSION
+	String _to_string() const { return String(get_name()) + ":<" + get_class() + "#" + itos(get_instance_id()) + ">"; }
+#endif
+
+public:
+	void set_behavior_tree(const Ref<BehaviorTree> &p_tree);
+	Ref<BehaviorTree> get_behavior_tree() const { return behavior_tree; }
+
+	void set_update_mode(UpdateMode p_mode);
+	UpdateMode get_update_mode() const { return update_mode; }
+
+	void set_active(bool p_active);
+	bool get_active() const { return active; }
+
+	void set_seed(int64_t p_seed);
+	int64_t get_seed() const { return seed; }
+
+	int add_agent(Node *p_agent, const Ref<Blackboard> &p_blackboard = Ref<Blackboard>());
+	void remove_agent(Node *p_agent);
+	void clear_agents();
+	bool has_agent(Node *p_agent) const;
+
+	_FORCE_INLINE_ int get_agent_count() const { return agents.size(); }
+	Node *get_agent(int p_index) const;
+	Ref<Blackboard> get_agent_blackboard(int p_index) const;
+	BT::Status get_agent_status(int p_index) const;
+	double get_agent_elapsed_time(int p_index) const;
+	Ref<BTInstance> get_agent_instance(int p_index) const;
+
+	void update(double p_delta);
+
+	BTCrowd();
+};
+
+#endif // BT_CROWD_H
@@ -12,7 +12,20 @@
 #include "bt_instance.h"
 
 #include "../editor/debugger/limbo_debugger.h"
+#include "../util/limbo_compat.h"
+#include "../util/limbo_profiling.h"
+#include "../util/limbo_ticks.h"
 #include "behavior_tree.h"
+#include "bt_memory_stats.h"
+#include "bt_state_arena.h"
+#include "bt_stats.h"
+#include "bt_tree_monitor.h"
+#include "tasks/composites/bt_selector.h"
+#include "tasks/composites/bt_sequence.h"
+#include "tasks/decorators/bt_always_fail.h"
+#include "tasks/decorators/bt_always_succeed.h"
+#include "tasks/decorators/bt_invert.h"
+#include "tasks/decorators/bt_subtree.h"
 
 #ifdef LIMBOAI_MODULE
 #include "core/os/time.h"
@@ -24,40 +37,1220 @@
 #include <godot_cpp/classes/time.hpp>
 #endif
 
+thread_local BTInstance::SleepRequest *BTInstance::sleep_request = nullptr;
+thread_local LimboRNG *BTInstance::current_rng = nullptr;
+thread_local uint64_t BTInstance::budget_deadline_usec = 0;
+thread_local uint64_t BTInstance::current_instance_id = 0;
+thread_local const LocalVector<BTPostedEvent> *BTInstance::current_events = nullptr;
+thread_local bool BTInstance::scheduled_update_pending = false;
+thread_local bool BTInstance::current_update_scheduled = false;
+
+LimboRNG &BTInstance::get_current_rng() {
+	if (likely(current_rng != nullptr)) {
+		return *current_rng;
+	}
+	static thread_local LimboRNG thread_rng;
+	return thread_rng;
+}
+
+int64_t BTInstance::get_remaining_budget_usec() {
+	if (budget_deadline_usec == 0) {
+		return -1;
+	}
+	const uint64_t now = Time::get_singleton()->get_ticks_usec();
+	return now < budget_deadline_usec ? int64_t(budget_deadline_usec - now) : 0;
+}
+
+// True if a task of the subtree lists a child owned by another parent, as loaded source trees may (see BTTask::_set_children()).
+static bool _has_shared_children(const BTTask *p_task) {
+	for (int i = 0; i < p_task->get_child_count(); i++) {
+		const Ref<BTTask> child = p_task->get_child(i);
+		if (child->get_parent().ptr() != p_task || child->get_index() != i || _has_shared_children(child.ptr())) {
+			return true;
+		}
+	}
+	return false;
+}
+
 Ref<BTInstance> BTInstance::create(Ref<BTTask> p_root_task, String p_source_bt_path, Node *p_owner_node) {
 	ERR_FAIL_NULL_V(p_root_task, nullptr);
-	ERR_FAIL_NULL_V(p_owner_node, nullptr);
+	// * Parent walks of shared children would lead into another tree - only clones are executable.
+	ERR_FAIL_COND_V_MSG(_has_shared_children(p_root_task.ptr()), nullptr, "BTInstance: Can't create an instance from a source tree with shared child tasks - instantiate a clone of it instead.");
+	BTStats::ensure_processing();
+	LimboErrorReporter::ensure_monitors();
 	Ref<BTInstance> inst;
 	inst.instantiate();
 	inst->root_task = p_root_task;
-	inst->owner_node_id = p_owner_node->get_instance_id();
+	p_root_task->_set_clock(&inst->clock);
+	inst->owner_node_id = p_owner_node ? uint64_t(p_owner_node->get_instance_id()) : 0;
 	inst->source_bt_path = p_source_bt_path;
+	inst->set_seed(0);
 	return inst;
 }
 
 BT::Status BTInstance::update(double p_delta) {
 	ERR_FAIL_COND_V(!root_task.is_valid(), BT::FRESH);
+	_update(p_delta);
+	_emit_updated();
+	return last_status;
+}
 
+// Performs the update without emitting signals, so it can be called from a worker thread.
+BT::Status BTInstance::_update(double p_delta) {
+	LIMBO_PROFILE_ZONE("BTInstance::update");
 #ifdef DEBUG_ENABLED
-	double start = Time::get_singleton()->get_ticks_usec();
+	const bool timed = monitor_performance || BTStats::is_timing();
+#else
+	const bool timed = BTStats::is_timing();
 #endif
+	const uint64_t start = timed ? LimboTicks::now() : 0;
+	const uint64_t start_tasks = BTStats::get_thread_task_count();
+	const BT::Status prev_status = last_status;
 
-	last_status = root_task->execute(p_delta);
-	emit_signal(LW_NAME(updated), last_status);
+	sleeping = false;
+	wake_requested.clear(); // * Cleared before consuming, so that events posted from now on wake up the instance again.
+	SleepRequest request;
+	request.instance_id = get_instance_id();
+	// Restored at the end, in case this update is nested in a tick of another instance.
+	SleepRequest *outer_request = sleep_request;
+	sleep_request = reactive ? &request : nullptr;
+	LimboRNG *outer_rng = current_rng;
+	current_rng = &rng;
+	const uint64_t outer_instance_id = current_instance_id;
+	current_instance_id = get_instance_id();
+	const LocalVector<BTPostedEvent> *outer_events = current_events;
+	const bool outer_scheduled = current_update_scheduled;
+	current_update_scheduled = scheduled_update_pending;
+	scheduled_update_pending = false;
+	if (unlikely(event_queue_size > 0)) {
+		_consume_events();
+	}
+	current_events = &consumed_events;
+	const uint64_t outer_deadline = budget_deadline_usec;
+	if (tick_budget_usec > 0) {
+		// Nested in a budgeted update (or a scheduler frame), the earlier deadline applies.
+		const uint64_t deadline = Time::get_singleton()->get_ticks_usec() + tick_budget_usec;
+		budget_deadline_usec = outer_deadline == 0 ? deadline : MIN(deadline, outer_deadline);
+	}
+
+	p_delta *= time_scale;
+	clock += p_delta;
+
+	if (unlikely(!pending_aborts.is_empty())) {
+		// * Iterating over a copy, since exiting tasks may queue more aborts.
+		event_lock.lock();
+		const LocalVector<uint64_t> aborts = pending_aborts;
+		pending_aborts.clear();
+		event_lock.unlock();
+		for (const uint64_t id : aborts) {
+			BTTask *task = Object::cast_to<BTTask>(OBJECT_DB_GET_INSTANCE(id));
+			if (task && task->get_status() == BT::RUNNING) {
+				task->abort();
+			}
+		}
+	}
 
+	// In compiled mode, the root is reached through the node table - no refcounting on the hot path.
+	BTTask *root = is_compiled() ? compiled_nodes[0].task.ptr() : root_task.ptr();
+	BTTask *resume_task = resume_running ? _find_resume_task(root) : root;
+	if (resume_task != root) {
+		// Tick the deepest running task directly, skipping the pass-through tasks above it.
+		BT::Status status = resume_task->execute(p_delta);
+		if (status == BT::RUNNING) {
+			// * Elapsed time of the skipped parents follows the instance clock.
+			last_status = BT::RUNNING;
+		} else {
+			// Status changed - unwind through the regular tick path, reporting the result when the task is reached.
+			resume_task->data.resumed = true;
+			last_status = is_compiled() ? _tick_compiled(0, p_delta) : root->execute(p_delta);
+			resume_task->data.resumed = false;
+		}
+	} else {
+		last_status = is_compiled() ? _tick_compiled(0, p_delta) : root->execute(p_delta);
+	}
+
+	sleep_request = outer_request;
+	current_rng = outer_rng;
+	current_instance_id = outer_instance_id;
+	current_events = outer_events;
+	current_update_scheduled = outer_scheduled;
+	if (unlikely(!consumed_events.is_empty())) {
+		// * Events that no task consumed are dropped.
+		consumed_events.clear();
+	}
+	budget_deadline_usec = outer_deadline;
+
+	_count_update(prev_status, uint32_t(BTStats::get_thread_task_count() - start_tasks));
+
+	if (reactive) {
+		if (last_status == BT::RUNNING && request.num_requests > 0 && !request.blocked && request.wake_after > 0.0) {
+			// Every running branch is waiting - no need to tick until the earliest wake-up time.
+			sleeping = true;
+			sleep_remaining = request.wake_after;
+			Ref<Blackboard> bb = get_blackboard();
+			sleep_bb_change_count = bb.is_valid() ? bb->get_change_count() : 0;
+		}
+	}
+
+	if (timed) {
+		const uint64_t ticks = LimboTicks::now() - start;
+		const uint64_t usec = LimboTicks::to_usec(ticks);
+		if (BTStats::is_enabled()) {
+			BTStats::record_update(usec);
+		}
+		if (unlikely(BTStats::is_spike(usec))) {
+			BTTask *running = _find_running_task(root);
+			BTStats::record_spike(get_instance_id(), usec, source_bt_path, running ? uint64_t(running->get_instance_id()) : 0);
+		}
+#ifdef DEBUG_ENABLED
+		// * Written only by the thread updating this instance, and read on the main thread between updates.
+		if (monitor_performance) {
+			update_ticks_acc += ticks;
+			update_count += 1;
+			update_ticks_max = MAX(update_ticks_max, ticks);
+		}
+		overview_usec += usec;
+#endif
+	}
 #ifdef DEBUG_ENABLED
-	double end = Time::get_singleton()->get_ticks_usec();
-	update_time_acc += (end - start);
-	update_time_n += 1.0;
+	overview_updates += 1;
+	overview_status_changes += last_status != prev_status;
 #endif
 	return last_status;
 }
 
+BTTask *BTInstance::_find_running_task(BTTask *p_root) const {
+	if (p_root->data.state->status != BT::RUNNING) {
+		return nullptr;
+	}
+	BTTask *task = p_root;
+	for (int i = 0; i < task->data.children.size(); i++) {
+		BTTask *child = task->_get_child_ptr_unchecked(i);
+		if (child->data.state->status == BT::RUNNING) {
+			// Descend into the first running child.
+			task = child;
+			i = -1;
+		}
+	}
+	return task;
+}
+
+#ifdef DEBUG_ENABLED
+String BTInstance::_get_running_path() const {
+	if (root_task.is_null() || root_task->data.state->status != BT::RUNNING) {
+		return String();
+	}
+	BTTask *task = root_task.ptr();
+	String path = task->get_task_name();
+	for (int i = 0; i < task->data.children.size(); i++) {
+		BTTask *child = task->_get_child_ptr_unchecked(i);
+		if (child->data.state->status == BT::RUNNING) {
+			task = child;
+			path += "/" + task->get_task_name();
+			i = -1;
+		}
+	}
+	return path;
+}
+#endif // DEBUG_ENABLED
+
+BTTask *BTInstance::_find_resume_task(BTTask *p_root) const {
+	if (p_root->data.state->status != BT::RUNNING) {
+		return p_root;
+	}
+	BTTask *task = p_root;
+	while (task->data.resumable) {
+		BTTask *running_child = nullptr;
+		for (int i = 0; i < task->data.children.size(); i++) {
+			BTTask *child = task->_get_child_ptr_unchecked(i);
+			if (child->data.state->status == BT::RUNNING) {
+				running_child = child;
+				break;
+			}
+		}
+		if (running_child == nullptr) {
+			break;
+		}
+		task = running_child;
+	}
+	return task;
+}
+
+bool BTInstance::is_subtree_thread_safe(const Ref<BTTask> &p_task) {
+	Ref<Script> sc = GET_SCRIPT(p_task);
+	if (sc.is_valid() || !LimboTaskDB::is_task_thread_safe(p_task->get_class()) || !p_task->can_tick_on_worker_thread()) {
+		return false;
+	}
+	// * Lazy subtrees are cloned and initialized during the tick - that must stay on the main thread.
+	BTSubtree *subtree = Object::cast_to<BTSubtree>(p_task.ptr());
+	if (subtree && subtree->is_lazy()) {
+		return false;
+	}
+	for (int i = 0; i < p_task->get_child_count(); i++) {
+		if (!is_subtree_thread_safe(p_task->get_child(i))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// True if a task of the subtree writes a variable that resolves to one of p_outer scopes.
+static bool _writes_outer_var(const BTTask *p_task, const LocalVector<const Blackboard *> &p_outer) {
+	LocalVector<StringName> read_vars;
+	LocalVector<StringName> written_vars;
+	p_task->validate_runtime(read_vars, written_vars);
+	for (const StringName &var : written_vars) {
+		for (const Blackboard *bb = p_task->get_blackboard().ptr(); bb != nullptr; bb = bb->get_parent().ptr()) {
+			if (bb->has_local_var(var)) {
+				if (p_outer.find(bb) != -1) {
+					return true;
+				}
+				break;
+			}
+		}
+	}
+	for (int i = 0; i < p_task->get_child_count(); i++) {
+		if (_writes_outer_var(p_task->get_child(i).ptr(), p_outer)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// The instance's own scope must be exclusive to it (BTScheduler doesn't tick two instances of one scope at once).
+// Outer scopes are usually shared, so they must not be written, and listeners would run on the worker thread,
+// as would the property accessors of bound variables.
+bool BTInstance::is_thread_safe() const {
+	ERR_FAIL_COND_V(!root_task.is_valid(), false);
+	if (!is_subtree_thread_safe(root_task)) {
+		return false;
+	}
+	const Ref<Blackboard> bb = root_task->get_blackboard();
+	if (bb.is_null()) {
+		return true;
+	}
+	if (bb->has_var_listeners() || bb->has_bound_vars()) {
+		return false;
+	}
+	LocalVector<const Blackboard *> outer;
+	for (const Blackboard *scope = bb->get_parent().ptr(); scope != nullptr; scope = scope->get_parent().ptr()) {
+		outer.push_back(scope);
+	}
+	return outer.is_empty() || !_writes_outer_var(root_task.ptr(), outer);
+}
+
+bool BTInstance::is_subtree_pure(const Ref<BTTask> &p_task) {
+	Ref<Script> sc = GET_SCRIPT(p_task);
+	if (sc.is_valid() || !LimboTaskDB::is_task_pure(p_task->get_class())) {
+		return false;
+	}
+	BTSubtree *subtree = Object::cast_to<BTSubtree>(p_task.ptr());
+	if (subtree && subtree->is_lazy()) {
+		return false;
+	}
+	for (int i = 0; i < p_task->get_child_count(); i++) {
+		if (!is_subtree_pure(p_task->get_child(i))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool BTInstance::is_pure() const {
+	ERR_FAIL_COND_V(!root_task.is_valid(), false);
+	return is_subtree_pure(root_task);
+}
+
+// Measured now, unlike the totals in BTMemoryStats. Parameters are mostly shared with other instances of the tree, so they aren't part of the total.
+Dictionary BTInstance::get_memory_usage() const {
+	Dictionary usage;
+	ERR_FAIL_COND_V(!root_task.is_valid(), usage);
+	const uint64_t tasks = BTMemoryStats::get_task_memory_usage(root_task.ptr());
+	const uint64_t blackboard = BTMemoryStats::get_blackboard_memory_usage(root_task.ptr());
+	usage["tasks"] = int64_t(tasks);
+	usage["parameters"] = int64_t(BTMemoryStats::get_parameter_memory_usage(root_task.ptr()));
+	usage["blackboard"] = int64_t(blackboard);
+	usage["total"] = int64_t(sizeof(BTInstance) + tasks + blackboard + compiled_nodes.size() * sizeof(CompiledNode) + compiled_children.size() * (sizeof(BTTask *) + sizeof(uint32_t)));
+	return usage;
+}
+
+void BTInstance::set_update_interval(double p_interval) {
+	update_interval = MAX(p_interval, 0.0);
+	// Random phase spreads instances sharing the same interval evenly across frames.
+	// Drawn from the instance RNG, so that a seeded instance ticks on the same frames every run.
+	tick_countdown = update_interval * rng.randf();
+}
+
+void BTInstance::set_seed(int64_t p_seed) {
+	seed = p_seed;
+	if (seed != 0) {
+		rng.seed(uint64_t(seed));
+	} else {
+		const uint64_t high = uint64_t(RANDF() * 4294967296.0);
+		rng.seed((high << 32) | uint64_t(RANDF() * 4294967296.0));
+	}
+}
+
+void BTInstance::set_reactive(bool p_reactive) {
+	reactive = p_reactive;
+	if (!reactive) {
+		sleeping = false;
+	}
+}
+
+void BTInstance::wake() {
+	if (sleeping) {
+		sleeping = false;
+		if (update_interval > 0.0) {
+			// Don't wait for the next interval tick on wake-up.
+			tick_countdown = 0.0;
+		}
+	}
+}
+
+void BTInstance::set_event_queue_capacity(int p_capacity) {
+	ERR_FAIL_COND_MSG(p_capacity < 1, "BTInstance: Event queue capacity must be at least 1.");
+	event_lock.lock();
+	if (event_queue_size > 0) {
+		event_lock.unlock();
+		ERR_FAIL_MSG("BTInstance: Unable to change event queue capacity while events are queued.");
+	}
+	event_queue_capacity = p_capacity;
+	event_queue.clear();
+	event_queue_head = 0;
+	event_lock.unlock();
+}
+
+bool BTInstance::post_event_id(int p_event_id, const Variant &p_cargo) {
+	ERR_FAIL_COND_V_MSG(p_event_id < 0 || p_event_id >= LimboEventRegistry::get_count(), false, "BTInstance: Invalid event ID.");
+	event_lock.lock();
+	if (event_queue_size >= (uint32_t)event_queue_capacity) {
+		event_lock.unlock();
+		ERR_PRINT_ONCE(vformat("BTInstance: Event queue is full (capacity: %d). Event \"%s\" is dropped.", event_queue_capacity, LimboEventRegistry::get_name(p_event_id)));
+		return false;
+	}
+	if (event_queue.size() < (uint32_t)event_queue_capacity) {
+		event_queue.resize(event_queue_capacity);
+	}
+	BTPostedEvent &pe = event_queue[(event_queue_head + event_queue_size) % event_queue_capacity];
+	pe.event_id = p_event_id;
+	pe.cargo = p_cargo;
+	event_queue_size++;
+	event_lock.unlock();
+	request_wake();
+	return true;
+}
+
+bool BTInstance::post_event(const StringName &p_event, const Variant &p_cargo) {
+	ERR_FAIL_COND_V_MSG(p_event == StringName(), false, "BTInstance: Unable to post an event with an empty name.");
+	return post_event_id(LimboEventRegistry::intern(p_event), p_cargo);
+}
+
+int BTInstance::get_posted_event_count() {
+	event_lock.lock();
+	int ret = event_queue_size;
+	event_lock.unlock();
+	return ret;
+}
+
+// Moves the posted events to consumed_events for the update in progress.
+void BTInstance::_consume_events() {
+	event_lock.lock();
+	consumed_events.reserve(event_queue_size);
+	for (uint32_t i = 0; i < event_queue_size; i++) {
+		BTPostedEvent &pe = event_queue[(event_queue_head + i) % event_queue_capacity];
+		consumed_events.push_back(pe);
+		pe.cargo = Variant();
+	}
+	event_queue_head = (event_queue_head + event_queue_size) % event_queue_capacity;
+	event_queue_size = 0;
+	event_lock.unlock();
+}
+
+const LocalVector<BTPostedEvent> &BTInstance::get_current_events() {
+	static const LocalVector<BTPostedEvent> no_events;
+	return current_events ? *current_events : no_events;
+}
+
+void BTInstance::queue_abort(BTTask *p_task) {
+	ERR_FAIL_NULL(p_task);
+	const uint64_t id = p_task->get_instance_id();
+	event_lock.lock();
+	if (pending_aborts.find(id) == -1) {
+		pending_aborts.push_back(id);
+	}
+	event_lock.unlock();
+	request_wake();
+}
+
+// Called by advance() while sleeping: returns true once the wake-up time is reached, a blackboard variable changes,
+// or a wake-up is requested.
+bool BTInstance::_advance_sleeping(double p_delta) {
+	sleep_remaining -= p_delta * time_scale;
+	if (sleep_remaining > 0.0 && !wake_requested.is_set()) {
+		const Blackboard *bb = root_task.is_valid() ? root_task->data.context->blackboard.ptr() : nullptr;
+		if (bb == nullptr || bb->get_change_count() == sleep_bb_change_count) {
+			return false;
+		}
+	}
+	wake();
+	return true;
+}
+
+void BTInstance::advance_clock(double p_seconds) {
+	ERR_FAIL_COND_MSG(p_seconds < 0.0, "BTInstance: The clock can't be turned back.");
+	clock += p_seconds;
+	if (sleeping) {
+		sleep_remaining -= p_seconds;
+		if (sleep_remaining <= 0.0) {
+			wake();
+		}
+	}
+}
+
+// Detaches the task tree from this instance, leaving it invalid, so that the tree can be reused.
+Ref<BTTask> BTInstance::_release_root_task() {
+	ERR_FAIL_COND_V(!root_task.is_valid(), nullptr);
+	_clear_compiled();
+	root_task->abort();
+	root_task->_set_clock(nullptr);
+#ifdef DEBUG_ENABLED
+	if (profile.is_valid()) {
+		_detach_profile(root_task.ptr());
+		profile.unref();
+	}
+	set_trace_enabled(false);
+#endif
+	if (telemetry.is_valid()) {
+		_detach_telemetry(root_task.ptr());
+		telemetry.unref();
+	}
+	sleeping = false;
+	Ref<BTTask> root = root_task;
+	root_task.unref();
+	return root;
+}
+
+void BTInstance::compile() {
+	ERR_FAIL_COND(!root_task.is_valid());
+	_clear_compiled();
+	_compile_node(root_task.ptr());
+
+	// * Instances of the same tree share an arena, so that ticking them in scheduler order streams through memory.
+	const BehaviorTree *bt = Object::cast_to<BehaviorTree>(OBJECT_DB_GET_INSTANCE(source_bt_id));
+	state_arena = bt ? bt->_get_state_arena(compiled_nodes.size()) : nullptr;
+	if (state_arena) {
+		compiled_states = state_arena->allocate();
+	} else {
+		own_compiled_states.resize(compiled_nodes.size());
+		compiled_states = own_compiled_states.ptr();
+	}
+
+	// Child and state tables are complete - now it's safe to hand out pointers into them.
+	for (uint32_t i = 0; i < compiled_nodes.size(); i++) {
+		BTTask *task = compiled_nodes[i].task.ptr();
+		task->data.compiled_children = compiled_nodes[i].child_count > 0 ? &compiled_children[compiled_nodes[i].first_child] : nullptr;
+		compiled_states[i] = *task->data.state;
+		task->data.state = &compiled_states[i];
+	}
+}
+
+static BTInstance::NodeKind _get_node_kind(BTTask *p_task, int p_child_count) {
+	// * Only exact built-in classes - subclasses and scripts may override _tick().
+	Ref<Script> sc = GET_SCRIPT(p_task);
+	if (sc.is_valid()) {
+		return BTInstance::NODE_TASK;
+	}
+	const StringName cls = p_task->get_class();
+	if (p_child_count > 0 && cls == BTSequence::get_class_static()) {
+		return BTInstance::NODE_SEQUENCE;
+	}
+	if (p_child_count > 0 && cls == BTSelector::get_class_static()) {
+		return BTInstance::NODE_SELECTOR;
+	}
+	if (p_child_count != 1) {
+		return BTInstance::NODE_TASK;
+	}
+	if (cls == BTInvert::get_class_static()) {
+		return BTInstance::NODE_INVERT;
+	}
+	if (cls == BTAlwaysSucceed::get_class_static()) {
+		return BTInstance::NODE_ALWAYS_SUCCEED;
+	}
+	if (cls == BTAlwaysFail::get_class_static()) {
+		return BTInstance::NODE_ALWAYS_FAIL;
+	}
+	return BTInstance::NODE_TASK;
+}
+
+void BTInstance::_compile_node(BTTask *p_task) {
+	CompiledNode node;
+	node.task = p_task;
+	node.child_count = p_task->get_child_count();
+	BTSubtree *subtree = Object::cast_to<BTSubtree>(p_task);
+	if (subtree && subtree->is_lazy()) {
+		// * Children of lazy subtrees come and go, so they are left out of the child table.
+		node.child_count = 0;
+	}
+	node.kind = _get_node_kind(p_task, node.child_count);
+	if (node.kind == NODE_SEQUENCE) {
+		node.last_running_idx = &static_cast<BTSequence *>(p_task)->last_running_idx;
+	} else if (node.kind == NODE_SELECTOR) {
+		node.last_running_idx = &static_cast<BTSelector *>(p_task)->last_running_idx;
+	}
+	node.first_child = compiled_children.size();
+	compiled_nodes.push_back(node);
+
+	// Reserve a contiguous range for the children of this node, and fill in their indices as they are compiled.
+	for (int i = 0; i < node.child_count; i++) {
+		compiled_children.push_back(p_task->data.children[i].ptr());
+		compiled_child_nodes.push_back(0);
+	}
+	for (int i = 0; i < node.child_count; i++) {
+		compiled_child_nodes[node.first_child + i] = compiled_nodes.size();
+		_compile_node(p_task->data.children[i].ptr());
+	}
+}
+
+// Same as BTComposite::_tick_in_order(), over compiled records.
+template <BT::Status CONTINUE>
+BT::Status BTInstance::_tick_compiled_in_order(const uint32_t *p_children, int p_count, int &r_last_running_idx, double p_delta) {
+	BT::Status status = CONTINUE;
+	for (int i = r_last_running_idx; i < p_count; i++) {
+		status = _tick_compiled(p_children[i], p_delta);
+		if (status != CONTINUE) {
+			r_last_running_idx = i;
+			break;
+		}
+	}
+	return status;
+}
+
+BT::Status BTInstance::_tick_compiled(uint32_t p_index, double p_delta) {
+	const CompiledNode &node = compiled_nodes[p_index];
+	BTTask *task = node.task.ptr();
+	// * Tasks whose children changed at runtime drop their child table, and fall back to execute() like the rest.
+	if (node.kind == NODE_TASK || task->data.compiled_children == nullptr || !task->_begin_batch_tick(p_delta)) {
+		return task->execute(p_delta);
+	}
+
+	const NodeKind kind = node.kind;
+	const uint32_t *children = &compiled_child_nodes[node.first_child];
+	const int child_count = node.child_count;
+	int *last_running_idx = node.last_running_idx;
+
+	BT::Status status;
+	switch (kind) {
+		case NODE_SEQUENCE: {
+			status = _tick_compiled_in_order<BT::SUCCESS>(children, child_count, *last_running_idx, p_delta);
+		} break;
+		case NODE_SELECTOR: {
+			status = _tick_compiled_in_order<BT::FAILURE>(children, child_count, *last_running_idx, p_delta);
+		} break;
+		case NODE_INVERT: {
+			status = _tick_compiled(children[0], p_delta);
+			if (status == BT::SUCCESS) {
+				status = BT::FAILURE;
+			} else if (status == BT::FAILURE) {
+				status = BT::SUCCESS;
+			}
+		} break;
+		case NODE_ALWAYS_SUCCEED: {
+			status = _tick_compiled(children[0], p_delta) == BT::RUNNING ? BT::RUNNING : BT::SUCCESS;
+		} break;
+		case NODE_ALWAYS_FAIL: {
+			status = _tick_compiled(children[0], p_delta) == BT::RUNNING ? BT::RUNNING : BT::FAILURE;
+		} break;
+		default: {
+			status = task->_tick(p_delta);
+		} break;
+	}
+	task->_end_batch_tick(status);
+	return status;
+}
+
+void BTInstance::_clear_compiled() {
+	for (const CompiledNode &node : compiled_nodes) {
+		BTTask *task = node.task.ptr();
+		task->data.compiled_children = nullptr;
+		task->data.own_state = *task->data.state;
+		task->data.state = &task->data.own_state;
+	}
+	compiled_nodes.clear();
+	compiled_children.clear();
+	compiled_child_nodes.clear();
+	if (state_arena) {
+		state_arena->free(compiled_states);
+		state_arena->unreference();
+		state_arena = nullptr;
+	}
+	compiled_states = nullptr;
+	own_compiled_states.clear();
+}
+
+int BTInstance::_count_tasks(const BTTask *p_task) {
+	int count = 1;
+	for (int i = 0; i < p_task->data.children.size(); i++) {
+		count += _count_tasks(p_task->data.children[i].ptr());
+	}
+	return count;
+}
+
+void BTInstance::_save_task_state(const BTTask *p_task, const Blackboard *p_parent_scope, LimboSnapshotWriter &p_writer) {
+	p_writer.put_u8(uint8_t(p_task->data.state->status));
+	p_writer.put_double(p_task->get_elapsed_time());
+
+	// Tasks like BTNewScope and BTSubtree introduce a scope for their descendants.
+	const Blackboard *scope = p_task->data.context->blackboard.ptr();
+	const bool new_scope = scope != nullptr && scope != p_parent_scope;
+	p_writer.put_u8(new_scope);
+	if (new_scope) {
+		scope->save_vars(p_writer);
+	}
+
+	// Task state is prefixed with its size, so that a mismatch is detected on restore.
+	const uint32_t size_pos = p_writer.get_position();
+	p_writer.put_u32(0);
+	p_task->_save_state(p_writer);
+	p_writer.patch_u32(size_pos, p_writer.get_position() - size_pos - 4);
+
+	for (int i = 0; i < p_task->data.children.size(); i++) {
+		_save_task_state(p_task->data.children[i].ptr(), scope, p_writer);
+	}
+}
+
+// Unless p_apply is set, only checks that the state matches the task, leaving it as it is - like _read_population().
+void BTInstance::_load_task_state(BTTask *p_task, const Blackboard *p_parent_scope, LimboSnapshotReader &p_reader, bool p_apply) {
+	const uint8_t status = p_reader.get_u8();
+	const double elapsed = p_reader.get_double();
+	if (status > BT::SUCCESS) {
+		p_reader.set_failed();
+	}
+	if (p_apply) {
+		p_task->data.state->status = BT::Status(status);
+		p_task->_restore_elapsed_time(status == BT::RUNNING, elapsed);
+		p_task->data.state->touched = true; // Restored outside of execute() - the next abort() must visit it.
+	}
+
+	Blackboard *scope = p_task->data.context->blackboard.ptr();
+	const bool new_scope = scope != nullptr && scope != p_parent_scope;
+	if (p_reader.get_u8() != uint8_t(new_scope)) {
+		p_reader.set_failed();
+		return;
+	}
+	if (new_scope) {
+		if (p_apply) {
+			scope->load_vars(p_reader);
+		} else {
+			Blackboard::skip_vars(p_reader);
+		}
+	}
+
+	const uint32_t size = p_reader.get_u32();
+	const uint32_t start = p_reader.get_position();
+	LimboSnapshotWriter current;
+	if (!p_apply) {
+		p_task->_save_state(current);
+	}
+	p_task->_load_state(p_reader);
+	if (!p_apply) {
+		LimboSnapshotReader restore(current.to_bytes());
+		p_task->_load_state(restore);
+	}
+	if (p_reader.get_position() - start != size) {
+		ERR_PRINT(vformat("BTInstance: Snapshot state of %s doesn't match the task.", p_task->get_task_name()));
+		p_reader.set_failed();
+		return;
+	}
+
+	for (int i = 0; i < p_task->data.children.size() && !p_reader.has_failed(); i++) {
+		_load_task_state(p_task->data.children[i].ptr(), scope, p_reader, p_apply);
+	}
+}
+
+void BTInstance::_count_update(BT::Status p_prev_status, uint32_t p_tasks) {
+	last_update_tasks = p_tasks;
+	task_count_average = tick_count == 0 ? double(last_update_tasks) : task_count_average + (last_update_tasks - task_count_average) * TASK_COUNT_SMOOTHING;
+	tick_count += 1;
+	status_change_count += last_status != p_prev_status;
+	if (last_status != BT::RUNNING) {
+		last_result_clock = clock;
+	}
+}
+
+// Everything the next update of a pure instance depends on: the tree, the outer blackboard scope and its changes, and the
+// state of the tasks with their own scopes. Unlike snapshots, the random stream is left out - pure tasks don't draw from it.
+// * The change count of the outer scopes tells apart instances updated before and after a write to them.
+void BTInstance::_write_shared_state(LimboSnapshotWriter &p_writer) const {
+	const Ref<Blackboard> bb = root_task->get_blackboard();
+	const Ref<Blackboard> outer = bb.is_valid() ? bb->get_parent() : Ref<Blackboard>();
+	p_writer.put_u64(source_bt_id);
+	p_writer.put_u64(outer.is_valid() ? uint64_t(outer->get_instance_id()) : 0);
+	p_writer.put_u64(outer.is_valid() ? outer->get_change_count() : 0);
+	p_writer.put_double(time_scale);
+	p_writer.put_u8(uint8_t(last_status));
+	_save_task_state(root_task.ptr(), nullptr, p_writer);
+}
+
+// Takes the state written after updating another instance, which was in the same state as this one, instead of ticking.
+// * Tasks are not aborted: the instance was in the same state as the one it takes over from, so their states are simply
+// overwritten - _exit() and the abort counters would fire for tasks that didn't stop running.
+// * The update counts as if it executed the tasks of the shared one, so that stats don't depend on sharing.
+void BTInstance::_share_update(double p_delta, const PackedByteArray &p_state, uint32_t p_tasks) {
+	const BT::Status prev_status = last_status;
+	const bool timed = BTStats::is_enabled();
+	const uint64_t start = timed ? LimboTicks::now() : 0;
+	clock += p_delta * time_scale;
+	LimboSnapshotReader reader(p_state);
+	reader.get_double(); // Delta, written by BTScheduler.
+	reader.get_u64();
+	reader.get_u64();
+	reader.get_u64();
+	reader.get_double();
+	const uint8_t status = reader.get_u8();
+	_load_task_state(root_task.ptr(), nullptr, reader);
+	ERR_FAIL_COND_MSG(reader.has_failed() || !reader.is_at_end(), "BTInstance: Shared update doesn't match the instance.");
+	last_status = BT::Status(status);
+	_count_update(prev_status, p_tasks);
+	if (timed) {
+		BTStats::record_shared_update(LimboTicks::to_usec(LimboTicks::now() - start), p_tasks);
+	}
+}
+
+PackedByteArray BTInstance::create_snapshot() const {
+	ERR_FAIL_COND_V(!root_task.is_valid(), PackedByteArray());
+	LimboSnapshotWriter writer;
+	writer.put_u32(SNAPSHOT_MAGIC);
+	writer.put_u8(SNAPSHOT_VERSION);
+	writer.put_u8(uint8_t(last_status));
+	writer.put_u64(rng.state);
+	writer.put_u64(rng.inc);
+	writer.put_u32(_count_tasks(root_task.ptr()));
+	// The scope of the root task counts as new, so that its local variables are included.
+	_save_task_state(root_task.ptr(), nullptr, writer);
+	return writer.to_bytes();
+}
+
+// Running tasks are aborted first, and restored tasks resume without _enter() being called again. The whole snapshot
+// is checked before the instance is touched, so corrupted data leaves it as it was.
+Error BTInstance::restore_snapshot(const PackedByteArray &p_snapshot) {
+	ERR_FAIL_COND_V(!root_task.is_valid(), ERR_UNCONFIGURED);
+	LimboSnapshotReader reader(p_snapshot);
+	ERR_FAIL_COND_V_MSG(reader.get_u32() != SNAPSHOT_MAGIC, ERR_INVALID_DATA, "BTInstance: Not a behavior tree snapshot.");
+	ERR_FAIL_COND_V_MSG(reader.get_u8() != SNAPSHOT_VERSION, ERR_INVALID_DATA, "BTInstance: Unsupported snapshot version.");
+	const uint8_t status = reader.get_u8();
+	const uint64_t rng_state = reader.get_u64();
+	const uint64_t rng_inc = reader.get_u64();
+	const uint32_t num_tasks = reader.get_u32();
+	ERR_FAIL_COND_V_MSG(reader.has_failed() || status > BT::SUCCESS, ERR_INVALID_DATA, "BTInstance: Snapshot data is corrupted.");
+	ERR_FAIL_COND_V_MSG(num_tasks != uint32_t(_count_tasks(root_task.ptr())), ERR_INVALID_DATA, "BTInstance: Snapshot was taken from a different behavior tree.");
+
+	// * Readers are plain positions in the data - the copy checks the task states, the original applies them.
+	LimboSnapshotReader check = reader;
+	_load_task_state(root_task.ptr(), nullptr, check, false);
+	ERR_FAIL_COND_V_MSG(check.has_failed() || !check.is_at_end(), ERR_INVALID_DATA, "BTInstance: Snapshot data is corrupted.");
+
+	root_task->abort();
+	_load_task_state(root_task.ptr(), nullptr, reader);
+	ERR_FAIL_COND_V_MSG(reader.has_failed() || !reader.is_at_end(), ERR_INVALID_DATA, "BTInstance: Snapshot data is corrupted.");
+
+	last_status = BT::Status(status);
+	rng.state = rng_state;
+	rng.inc = rng_inc;
+	sleeping = false;
+	return OK;
+}
+
+namespace {
+
+// Column of per-instance records: each run of equal records is stored once, after the length of the run.
+struct PopulationColumnWriter {
+	LimboSnapshotWriter &out;
+	PackedByteArray last;
+	uint32_t run = 0;
+
+	PopulationColumnWriter(LimboSnapshotWriter &p_out) :
+			out(p_out) {}
+
+	void push(const LimboSnapshotWriter &p_record) {
+		const PackedByteArray record = p_record.to_bytes();
+		if (run > 0 && record == last) {
+			run += 1;
+			return;
+		}
+		flush();
+		last = record;
+		run = 1;
+	}
+
+	void flush() {
+		if (run > 0) {
+			out.put_u32(run);
+			out.put_bytes(last);
+			run = 0;
+		}
+	}
+};
+
+// Reads a column of p_count records. Runs that are empty or longer than the rest of the column fail the reader.
+struct PopulationColumnReader {
+	LimboSnapshotReader &in;
+	PackedByteArray record;
+	uint32_t remaining = 0;
+	uint32_t left = 0; // Records of the column not read yet.
+
+	PopulationColumnReader(LimboSnapshotReader &p_in, uint32_t p_count) :
+			in(p_in), left(p_count) {}
+
+	const PackedByteArray &next() {
+		if (remaining == 0) {
+			remaining = in.get_u32();
+			record = in.get_bytes();
+			if (remaining == 0 || remaining > left) {
+				in.set_failed();
+				remaining = 1;
+			}
+		}
+		remaining -= 1;
+		left -= 1;
+		return record;
+	}
+};
+
+} //namespace
+
+void BTInstance::_collect_tasks(BTTask *p_task, LocalVector<BTTask *> &r_tasks) {
+	r_tasks.push_back(p_task);
+	for (int i = 0; i < p_task->data.children.size(); i++) {
+		_collect_tasks(p_task->data.children[i].ptr(), r_tasks);
+	}
+}
+
+// Same rule as in snapshots: a task owns a scope if it's not the scope of its parent.
+static Blackboard *_get_own_scope(const BTTask *p_task) {
+	Blackboard *scope = p_task->get_blackboard().ptr();
+	const BTTask *parent = p_task->get_parent().ptr();
+	const Blackboard *parent_scope = parent ? parent->get_blackboard().ptr() : nullptr;
+	return scope != parent_scope ? scope : nullptr;
+}
+
+// Instances are stored column by column: for each task, the statuses of all instances, then their runtime states,
+// then each variable of its scope. Instances of a crowd are mostly in a few states, so equal neighbors collapse into runs.
+PackedByteArray BTInstance::save_population(const TypedArray<BTInstance> &p_instances) {
+	ERR_FAIL_COND_V_MSG(p_instances.is_empty(), PackedByteArray(), "BTInstance: No instances to save.");
+	const uint32_t count = p_instances.size();
+	LocalVector<BTInstance *> instances;
+	LocalVector<LocalVector<BTTask *>> tasks;
+	instances.resize(count);
+	tasks.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		BTInstance *inst = Object::cast_to<BTInstance>(p_instances[i]);
+		ERR_FAIL_COND_V_MSG(inst == nullptr || !inst->root_task.is_valid(), PackedByteArray(), "BTInstance: Can't save an invalid instance.");
+		ERR_FAIL_COND_V_MSG(i > 0 && inst->source_bt_id != instances[0]->source_bt_id, PackedByteArray(), "BTInstance: All instances in a population must come from the same behavior tree.");
+		instances[i] = inst;
+		_collect_tasks(inst->root_task.ptr(), tasks[i]);
+		ERR_FAIL_COND_V_MSG(tasks[i].size() != tasks[0].size(), PackedByteArray(), "BTInstance: All instances in a population must have the same tasks.");
+	}
+	const uint32_t num_tasks = tasks[0].size();
+
+	LimboSnapshotWriter writer;
+	writer.put_u32(POPULATION_MAGIC);
+	writer.put_u8(SNAPSHOT_VERSION);
+	writer.put_u32(count);
+	writer.put_u32(num_tasks);
+
+	// * Random streams differ between instances - no runs to find.
+	for (const BTInstance *inst : instances) {
+		writer.put_u64(inst->rng.state);
+		writer.put_u64(inst->rng.inc);
+	}
+	PopulationColumnWriter statuses(writer);
+	for (const BTInstance *inst : instances) {
+		LimboSnapshotWriter record;
+		record.put_u8(uint8_t(inst->last_status));
+		statuses.push(record);
+	}
+	statuses.flush();
+
+	for (uint32_t t = 0; t < num_tasks; t++) {
+		PopulationColumnWriter task_statuses(writer);
+		for (uint32_t i = 0; i < count; i++) {
+			LimboSnapshotWriter record;
+			record.put_u8(uint8_t(tasks[i][t]->data.state->status));
+			record.put_double(tasks[i][t]->get_elapsed_time());
+			task_statuses.push(record);
+		}
+		task_statuses.flush();
+
+		PopulationColumnWriter task_states(writer);
+		for (uint32_t i = 0; i < count; i++) {
+			LimboSnapshotWriter record;
+			tasks[i][t]->_save_state(record);
+			task_states.push(record);
+		}
+		task_states.flush();
+
+		const Blackboard *first_scope = _get_own_scope(tasks[0][t]);
+		writer.put_u8(first_scope != nullptr);
+		if (first_scope == nullptr) {
+			continue;
+		}
+		const TypedArray<StringName> vars = first_scope->list_vars();
+		writer.put_u32(vars.size());
+		for (int v = 0; v < vars.size(); v++) {
+			const StringName name = vars[v];
+			writer.put_string_name(name);
+			PopulationColumnWriter values(writer);
+			for (uint32_t i = 0; i < count; i++) {
+				const Blackboard *scope = _get_own_scope(tasks[i][t]);
+				ERR_FAIL_NULL_V_MSG(scope, PackedByteArray(), "BTInstance: All instances in a population must have the same blackboard scopes.");
+				LimboSnapshotWriter record;
+				record.put_variant(scope->get_var(name, Variant(), false));
+				values.push(record);
+			}
+			values.flush();
+		}
+	}
+	return writer.to_bytes();
+}
+
+// Reads the records that follow the header of a population. Unless p_apply is set, only checks that they match the
+// instances, leaving them as they are - task states are loaded to be checked, and then put back.
+Error BTInstance::_read_population(LimboSnapshotReader &p_reader, const LocalVector<BTInstance *> &p_instances, const LocalVector<LocalVector<BTTask *>> &p_tasks, bool p_apply) {
+	const uint32_t count = p_instances.size();
+	const uint32_t num_tasks = p_tasks[0].size();
+	for (BTInstance *inst : p_instances) {
+		const uint64_t rng_state = p_reader.get_u64();
+		const uint64_t rng_inc = p_reader.get_u64();
+		if (p_apply) {
+			inst->root_task->abort();
+			inst->rng.state = rng_state;
+			inst->rng.inc = rng_inc;
+			inst->sleeping = false;
+		}
+	}
+	PopulationColumnReader statuses(p_reader, count);
+	for (BTInstance *inst : p_instances) {
+		LimboSnapshotReader record(statuses.next());
+		const uint8_t status = record.get_u8();
+		ERR_FAIL_COND_V_MSG(record.has_failed() || status > BT::SUCCESS, ERR_INVALID_DATA, "BTInstance: Population data is corrupted.");
+		if (p_apply) {
+			inst->last_status = BT::Status(status);
+		}
+	}
+
+	for (uint32_t t = 0; t < num_tasks && !p_reader.has_failed(); t++) {
+		PopulationColumnReader task_statuses(p_reader, count);
+		for (uint32_t i = 0; i < count; i++) {
+			BTTask *task = p_tasks[i][t];
+			LimboSnapshotReader record(task_statuses.next());
+			const uint8_t status = record.get_u8();
+			const double elapsed = record.get_double();
+			ERR_FAIL_COND_V_MSG(record.has_failed() || status > BT::SUCCESS, ERR_INVALID_DATA, "BTInstance: Population data is corrupted.");
+			if (p_apply) {
+				task->data.state->status = BT::Status(status);
+				task->_restore_elapsed_time(status == BT::RUNNING, elapsed);
+				task->data.state->touched = true; // Restored outside of execute() - the next abort() must visit it.
+			}
+		}
+
+		PopulationColumnReader task_states(p_reader, count);
+		for (uint32_t i = 0; i < count; i++) {
+			BTTask *task = p_tasks[i][t];
+			LimboSnapshotWriter current;
+			if (!p_apply) {
+				task->_save_state(current);
+			}
+			LimboSnapshotReader record(task_states.next());
+			task->_load_state(record);
+			const bool matches = !record.has_failed() && record.is_at_end();
+			if (!p_apply) {
+				LimboSnapshotReader restore(current.to_bytes());
+				task->_load_state(restore);
+			}
+			ERR_FAIL_COND_V_MSG(!matches, ERR_INVALID_DATA, vformat("BTInstance: Population state of %s doesn't match the task.", task->get_task_name()));
+		}
+
+		if (p_reader.get_u8() == 0) {
+			continue;
+		}
+		const uint32_t num_vars = p_reader.get_u32();
+		for (uint32_t v = 0; v < num_vars && !p_reader.has_failed(); v++) {
+			const StringName name = p_reader.get_string_name();
+			PopulationColumnReader values(p_reader, count);
+			for (uint32_t i = 0; i < count; i++) {
+				LimboSnapshotReader record(values.next());
+				const Variant value = record.get_variant();
+				Blackboard *scope = _get_own_scope(p_tasks[i][t]);
+				ERR_FAIL_COND_V_MSG(record.has_failed() || scope == nullptr, ERR_INVALID_DATA, "BTInstance: Population data is corrupted.");
+				if (p_apply) {
+					scope->set_var(name, value);
+				}
+			}
+		}
+	}
+	ERR_FAIL_COND_V_MSG(p_reader.has_failed() || !p_reader.is_at_end(), ERR_INVALID_DATA, "BTInstance: Population data is corrupted.");
+	return OK;
+}
+
+// Like restore_snapshot(), for each instance in the same order as when saved. The whole population is checked
+// before any instance is touched, so corrupted data leaves all instances as they were.
+Error BTInstance::load_population(const TypedArray<BTInstance> &p_instances, const PackedByteArray &p_data) {
+	LimboSnapshotReader reader(p_data);
+	ERR_FAIL_COND_V_MSG(reader.get_u32() != POPULATION_MAGIC, ERR_INVALID_DATA, "BTInstance: Not a behavior tree population.");
+	ERR_FAIL_COND_V_MSG(reader.get_u8() != SNAPSHOT_VERSION, ERR_INVALID_DATA, "BTInstance: Unsupported population version.");
+	const uint32_t count = reader.get_u32();
+	const uint32_t num_tasks = reader.get_u32();
+	ERR_FAIL_COND_V_MSG(reader.has_failed(), ERR_INVALID_DATA, "BTInstance: Population data is corrupted.");
+	ERR_FAIL_COND_V_MSG(count != uint32_t(p_instances.size()), ERR_INVALID_PARAMETER, vformat("BTInstance: Population holds %d instances, but %d were given.", count, p_instances.size()));
+	ERR_FAIL_COND_V_MSG(count == 0, ERR_INVALID_DATA, "BTInstance: Population data is corrupted.");
+
+	LocalVector<BTInstance *> instances;
+	LocalVector<LocalVector<BTTask *>> tasks;
+	instances.resize(count);
+	tasks.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		BTInstance *inst = Object::cast_to<BTInstance>(p_instances[i]);
+		ERR_FAIL_COND_V_MSG(inst == nullptr || !inst->root_task.is_valid(), ERR_INVALID_PARAMETER, "BTInstance: Can't load into an invalid instance.");
+		instances[i] = inst;
+		_collect_tasks(inst->root_task.ptr(), tasks[i]);
+		ERR_FAIL_COND_V_MSG(tasks[i].size() != num_tasks, ERR_INVALID_DATA, "BTInstance: Population was saved from a different behavior tree.");
+	}
+
+	// * Readers are plain positions in the data - the copy checks the records, the original applies them.
+	LimboSnapshotReader check = reader;
+	const Error err = _read_population(check, instances, tasks, false);
+	if (err != OK) {
+		return err;
+	}
+	return _read_population(reader, instances, tasks, true);
+}
+
+// A task matches if it has the same type, name and number of children, and its parent matched too. Old tasks that are
+// still running but have no match are aborted, while matched ones are dropped without exiting, as their new copies continue.
+int BTInstance::_transfer_task_state(BTTask *p_old, BTTask *p_new, const Blackboard *p_old_parent_scope, const Blackboard *p_new_parent_scope) {
+	if (p_old->get_class() != p_new->get_class() || p_old->get_script() != p_new->get_script() ||
+			p_old->data.custom_name != p_new->data.custom_name || p_old->data.children.size() != p_new->data.children.size()) {
+		if (p_old->data.state->status == BT::RUNNING) {
+			p_old->abort();
+		}
+		return 0;
+	}
+
+	LimboSnapshotWriter writer;
+	p_old->_save_state(writer);
+	LimboSnapshotReader reader(writer.to_bytes());
+	p_new->_load_state(reader);
+	if (reader.has_failed() || !reader.is_at_end()) {
+		ERR_PRINT(vformat("BTInstance: Runtime state of %s couldn't be carried over.", p_new->get_task_name()));
+		if (p_old->data.state->status == BT::RUNNING) {
+			p_old->abort();
+		}
+		return 0;
+	}
+	p_new->data.state->status = p_old->data.state->status;
+	p_new->_restore_elapsed_time(p_old->data.state->timing, p_old->get_elapsed_time());
+	p_new->data.state->touched = p_old->data.state->touched;
+
+	// Scopes are recreated by initialization, e.g. by BTNewScope, and only the variables are carried over.
+	const Blackboard *old_scope = p_old->data.context->blackboard.ptr();
+	Blackboard *new_scope = p_new->data.context->blackboard.ptr();
+	if (old_scope && new_scope && old_scope != new_scope && old_scope != p_old_parent_scope && new_scope != p_new_parent_scope) {
+		LimboSnapshotWriter vars_writer;
+		old_scope->save_vars(vars_writer);
+		LimboSnapshotReader vars_reader(vars_writer.to_bytes());
+		new_scope->load_vars(vars_reader);
+	}
+
+	int count = 1;
+	for (int i = 0; i < p_old->data.children.size(); i++) {
+		count += _transfer_task_state(p_old->data.children[i].ptr(), p_new->data.children[i].ptr(), old_scope, new_scope);
+	}
+	return count;
+}
+
+int BTInstance::hot_swap(const Ref<BehaviorTree> &p_behavior_tree) {
+	ERR_FAIL_COND_V_MSG(!root_task.is_valid(), -1, "BTInstance: Can't hot-swap an invalid instance.");
+	ERR_FAIL_COND_V_MSG(p_behavior_tree.is_null() || p_behavior_tree->get_root_task().is_null(), -1, "BTInstance: Hot-swap failed - BT has no valid root task.");
+
+	Node *agent = root_task->get_agent();
+	Node *scene_root = root_task->get_scene_root();
+	Ref<Blackboard> bb = root_task->get_blackboard();
+	// * Only headless instances (see BehaviorTree::instantiate_headless()) have neither an agent nor an owner node.
+	ERR_FAIL_COND_V_MSG(agent == nullptr && owner_node_id != 0, -1, "BTInstance: Hot-swap failed - the agent was freed.");
+	ERR_FAIL_COND_V(bb.is_null(), -1);
+
+	// * Variables added to the plan are created, and existing values are kept.
+	// * Without an owner node, node paths can't be prefetched - as with instantiate_headless(), the blackboard is then left to the caller.
+	const Ref<BlackboardPlan> plan = p_behavior_tree->get_blackboard_plan();
+	Node *owner_node = get_owner_node();
+	if (plan.is_valid() && (owner_node != nullptr || !plan->is_prefetching_nodepath_vars())) {
+		plan->populate_blackboard(bb, false, owner_node, scene_root);
+	}
+	const Ref<BTTask> tmpl = p_behavior_tree->get_instance_template();
+	Ref<BTTask> new_root = p_behavior_tree->_initialize_root(tmpl->clone(), agent, bb, scene_root);
+
+	const bool was_compiled = is_compiled();
+	_clear_compiled();
+#ifdef DEBUG_ENABLED
+	const bool was_monitored = monitor_performance;
+	const bool was_tracing = tracing;
+	set_monitor_performance(false);
+	set_trace_enabled(false);
+	if (profile.is_valid()) {
+		_detach_profile(root_task.ptr());
+		profile.unref();
+	}
+#endif
+	if (telemetry.is_valid()) {
+		_detach_telemetry(root_task.ptr());
+		telemetry.unref();
+	}
+	BTMemoryStats::remove_instance(this);
+
+	new_root->_set_clock(&clock);
+	const int carried = _transfer_task_state(root_task.ptr(), new_root.ptr(), nullptr, nullptr);
+	root_task->_set_clock(nullptr);
+	root_task = new_root;
+	source_bt_path = p_behavior_tree->get_path();
+	source_bt_id = p_behavior_tree->get_instance_id();
+	source_template_id = tmpl->get_instance_id();
+	sleeping = false;
+	if (carried == 0) {
+		last_status = BT::FRESH;
+	}
+
+	if (was_compiled || p_behavior_tree->get_compile_instances()) {
+		compile();
+	}
+	BTMemoryStats::add_instance(this);
+	if (p_behavior_tree->is_telemetry_enabled()) {
+		telemetry = p_behavior_tree->_attach_telemetry(root_task);
+	}
+#ifdef DEBUG_ENABLED
+	if (p_behavior_tree->is_profiling_enabled()) {
+		profile = p_behavior_tree->_attach_profile(root_task);
+	}
+	if (was_monitored) {
+		set_monitor_performance(true);
+	}
+	if (was_tracing) {
+		set_trace_enabled(true);
+	}
+#endif
+	return carried;
+}
+
 void BTInstance::set_monitor_performance(bool p_monitor) {
 #ifdef DEBUG_ENABLED
 	monitor_performance = p_monitor;
 	if (monitor_performance) {
-		_add_custom_monitor();
+		if (BTTreeMonitor::is_enabled()) {
+			BTTreeMonitor::add_instance(this);
+			tree_monitored = true;
+		} else {
+			_add_custom_monitor();
+		}
 	} else {
 		_remove_custom_monitor();
 	}
@@ -72,6 +1265,41 @@ bool BTInstance::get_monitor_performance() const {
 #endif
 }
 
+void BTInstance::set_trace_enabled(bool p_enabled) {
+#ifdef DEBUG_ENABLED
+	if (p_enabled == tracing) {
+		return;
+	}
+	ERR_FAIL_COND_MSG(p_enabled && !root_task.is_valid(), "BTInstance: Can't trace an invalid instance.");
+	tracing = p_enabled;
+	if (tracing) {
+		// * Each tracing session starts with a fresh trace.
+		trace.instantiate();
+		trace->build(root_task);
+	}
+	if (root_task.is_valid()) {
+		uint32_t index = 0;
+		_attach_trace(root_task.ptr(), tracing ? trace.ptr() : nullptr, index);
+	}
+#endif
+}
+
+bool BTInstance::is_trace_enabled() const {
+#ifdef DEBUG_ENABLED
+	return tracing;
+#else
+	return false;
+#endif
+}
+
+Ref<BTTrace> BTInstance::get_trace() const {
+#ifdef DEBUG_ENABLED
+	return trace;
+#else
+	return nullptr;
+#endif
+}
+
 void BTInstance::register_with_debugger() {
 #ifdef DEBUG_ENABLED
 	if (LimboDebugger::get_singleton()->is_active()) {
@@ -88,13 +1316,36 @@ void BTInstance::unregister_with_debugger() {
 #endif
 }
 
+void BTInstance::_detach_telemetry(BTTask *p_task) {
+	p_task->data.telemetry = nullptr;
+	for (int i = 0; i < p_task->data.children.size(); i++) {
+		_detach_telemetry(p_task->data.children[i].ptr());
+	}
+}
+
 #ifdef DEBUG_ENABLED
 
+void BTInstance::_detach_profile(BTTask *p_task) {
+	p_task->data.profile_stats = nullptr;
+	for (int i = 0; i < p_task->data.children.size(); i++) {
+		_detach_profile(p_task->data.children[i].ptr());
+	}
+}
+
+void BTInstance::_attach_trace(BTTask *p_task, BTTrace *p_trace, uint32_t &r_index) {
+	p_task->data.trace = p_trace;
+	p_task->data.trace_index = r_index++;
+	for (int i = 0; i < p_task->data.children.size(); i++) {
+		_attach_trace(p_task->data.children[i].ptr(), p_trace, r_index);
+	}
+}
+
 double BTInstance::_get_mean_update_time_msec_and_reset() {
-	if (update_time_n) {
-		double mean_time_msec = (update_time_acc * 0.001) / update_time_n;
-		update_time_acc = 0.0;
-		update_time_n = 0.0;
+	if (update_count) {
+		double mean_time_msec = (LimboTicks::to_usec(update_ticks_acc) * 0.001) / update_count;
+		update_ticks_acc = 0;
+		update_count = 0;
+		update_ticks_max = 0;
 		return mean_time_msec;
 	}
 	return 0.0;
@@ -115,6 +1366,10 @@ void BTInstance::_add_custom_monitor() {
 }
 
 void BTInstance::_remove_custom_monitor() {
+	if (tree_monitored) {
+		BTTreeMonitor::remove_instance(this);
+		tree_monitored = false;
+	}
 	if (monitor_id != StringName() && Performance::get_singleton()->has_custom_monitor(monitor_id)) {
 		Performance::get_singleton()->remove_custom_monitor(monitor_id);
 	}
@@ -131,16 +1386,73 @@ void BTInstance::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_blackboard"), &BTInstance::get_blackboard);
 
 	ClassDB::bind_method(D_METHOD("is_instance_valid"), &BTInstance::is_instance_valid);
+	ClassDB::bind_method(D_METHOD("is_compiled"), &BTInstance::is_compiled);
+	ClassDB::bind_method(D_METHOD("is_thread_safe"), &BTInstance::is_thread_safe);
+	ClassDB::bind_method(D_METHOD("is_pure"), &BTInstance::is_pure);
+	ClassDB::bind_method(D_METHOD("get_memory_usage"), &BTInstance::get_memory_usage);
+
+	ClassDB::bind_method(D_METHOD("set_resume_running", "enable"), &BTInstance::set_resume_running);
+	ClassDB::bind_method(D_METHOD("get_resume_running"), &BTInstance::get_resume_running);
+
+	ClassDB::bind_method(D_METHOD("set_update_interval", "interval"), &BTInstance::set_update_interval);
+	ClassDB::bind_method(D_METHOD("get_update_interval"), &BTInstance::get_update_interval);
+
+	ClassDB::bind_method(D_METHOD("set_tick_budget_usec", "budget_usec"), &BTInstance::set_tick_budget_usec);
+	ClassDB::bind_method(D_METHOD("get_tick_budget_usec"), &BTInstance::get_tick_budget_usec);
+
+	ClassDB::bind_method(D_METHOD("set_priority", "priority"), &BTInstance::set_priority);
+	ClassDB::bind_method(D_METHOD("get_priority"), &BTInstance::get_priority);
+	ClassDB::bind_method(D_METHOD("set_time_scale", "scale"), &BTInstance::set_time_scale);
+	ClassDB::bind_method(D_METHOD("get_time_scale"), &BTInstance::get_time_scale);
+	ClassDB::bind_method(D_METHOD("get_clock_time"), &BTInstance::get_clock_time);
+	ClassDB::bind_method(D_METHOD("advance_clock", "seconds"), &BTInstance::advance_clock);
+
+	ClassDB::bind_method(D_METHOD("set_seed", "seed"), &BTInstance::set_seed);
+	ClassDB::bind_method(D_METHOD("get_seed"), &BTInstance::get_seed);
+
+	ClassDB::bind_method(D_METHOD("set_reactive", "enable"), &BTInstance::set_reactive);
+	ClassDB::bind_method(D_METHOD("is_reactive"), &BTInstance::is_reactive);
+	ClassDB::bind_method(D_METHOD("is_sleeping"), &BTInstance::is_sleeping);
+	ClassDB::bind_method(D_METHOD("wake"), &BTInstance::wake);
+
+	ClassDB::bind_method(D_METHOD("get_last_update_task_count"), &BTInstance::get_last_update_task_count);
+	ClassDB::bind_method(D_METHOD("get_task_count_average"), &BTInstance::get_task_count_average);
+	ClassDB::bind_method(D_METHOD("get_tick_count"), &BTInstance::get_tick_count);
+	ClassDB::bind_method(D_METHOD("get_status_change_count"), &BTInstance::get_status_change_count);
+	ClassDB::bind_method(D_METHOD("get_time_since_last_result"), &BTInstance::get_time_since_last_result);
+
+	ClassDB::bind_method(D_METHOD("set_event_queue_capacity", "capacity"), &BTInstance::set_event_queue_capacity);
+	ClassDB::bind_method(D_METHOD("get_event_queue_capacity"), &BTInstance::get_event_queue_capacity);
+	ClassDB::bind_method(D_METHOD("post_event", "event", "cargo"), &BTInstance::post_event, DEFVAL(Variant()));
+	ClassDB::bind_method(D_METHOD("post_event_id", "event_id", "cargo"), &BTInstance::post_event_id, DEFVAL(Variant()));
+	ClassDB::bind_method(D_METHOD("get_posted_event_count"), &BTInstance::get_posted_event_count);
 
 	ClassDB::bind_method(D_METHOD("set_monitor_performance", "monitor"), &BTInstance::set_monitor_performance);
 	ClassDB::bind_method(D_METHOD("get_monitor_performance"), &BTInstance::get_monitor_performance);
+	ClassDB::bind_method(D_METHOD("set_trace_enabled", "enabled"), &BTInstance::set_trace_enabled);
+	ClassDB::bind_method(D_METHOD("is_trace_enabled"), &BTInstance::is_trace_enabled);
+	ClassDB::bind_method(D_METHOD("get_trace"), &BTInstance::get_trace);
 
 	ClassDB::bind_method(D_METHOD("update", "delta"), &BTInstance::update);
+	ClassDB::bind_method(D_METHOD("create_snapshot"), &BTInstance::create_snapshot);
+	ClassDB::bind_method(D_METHOD("restore_snapshot", "snapshot"), &BTInstance::restore_snapshot);
+	ClassDB::bind_static_method("BTInstance", D_METHOD("save_population", "instances"), &BTInstance::save_population);
+	ClassDB::bind_static_method("BTInstance", D_METHOD("load_population", "instances", "data"), &BTInstance::load_population);
+	ClassDB::bind_method(D_METHOD("hot_swap", "behavior_tree"), &BTInstance::hot_swap);
 
 	ClassDB::bind_method(D_METHOD("register_with_debugger"), &BTInstance::register_with_debugger);
 	ClassDB::bind_method(D_METHOD("unregister_with_debugger"), &BTInstance::unregister_with_debugger);
 
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "monitor_performance"), "set_monitor_performance", "get_monitor_performance");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "trace_enabled"), "set_trace_enabled", "is_trace_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "resume_running"), "set_resume_running", "get_resume_running");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "reactive"), "set_reactive", "is_reactive");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "seed"), "set_seed", "get_seed");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "update_interval", PROPERTY_HINT_RANGE, "0.0,10.0,0.001,or_greater,suffix:s"), "set_update_interval", "get_update_interval");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "priority"), "set_priority", "get_priority");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "event_queue_capacity", PROPERTY_HINT_RANGE, "1,1024,1,or_greater"), "set_event_queue_capacity", "get_event_queue_capacity");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "tick_budget_usec", PROPERTY_HINT_RANGE, "0,100000,1,or_greater,suffix:us"), "set_tick_budget_usec", "get_tick_budget_usec");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "time_scale", PROPERTY_HINT_RANGE, "0.0,4.0,0.01,or_greater"), "set_time_scale", "get_time_scale");
 
 	ADD_SIGNAL(MethodInfo("updated", PropertyInfo(Variant::INT, "status")));
 	ADD_SIGNAL(MethodInfo("freed"));
@@ -148,7 +1460,14 @@ void BTInstance::_bind_methods() {
 
 BTInstance::~BTInstance() {
 	emit_signal(LW_NAME(freed));
+	BTMemoryStats::remove_instance(this);
+	_clear_compiled();
+	if (root_task.is_valid()) {
+		// * Tasks may outlive the instance.
+		root_task->_set_clock(nullptr);
+	}
 #ifdef DEBUG_ENABLED
 	_remove_custom_monitor();
+	set_trace_enabled(false);
 #endif
 }
@@ -11,24 +11,206 @@
 #ifndef BT_INSTANCE_H
 #define BT_INSTANCE_H
 
+#include "../hsm/limbo_event_registry.h"
+#include "../util/limbo_rng.h"
+#include "../util/limbo_string_names.h"
+#include "bt_profile.h"
+#include "bt_telemetry.h"
+#include "bt_trace.h"
 #include "tasks/bt_task.h"
 
+#ifdef LIMBOAI_MODULE
+#include "core/os/spin_lock.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/templates/safe_refcount.hpp>
+#include <godot_cpp/templates/spin_lock.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+class BehaviorTree;
+class BTStateArena;
+
+// Event posted to a BTInstance (see BTInstance::post_event()).
+struct BTPostedEvent {
+	int event_id = LimboEventRegistry::INVALID_EVENT;
+	Variant cargo;
+};
+
 class BTInstance : public RefCounted {
 	GDCLASS(BTInstance, RefCounted);
+	friend class BehaviorTree;
+	friend class BTCrowd;
+	friend class BTInstancePool;
+	friend class BTMemoryStats;
+	friend class BTScheduler;
+	friend class BTTask;
+	friend class BTTreeMonitor;
+	friend class LimboDebugger;
+
+public:
+	// How a compiled node is ticked. Built-in sequences, selectors and simple decorators are interpreted by the instance
+	// from their records, all other tasks (including scripted ones) are executed through their task objects.
+	enum NodeKind : uint8_t {
+		NODE_TASK,
+		NODE_SEQUENCE,
+		NODE_SELECTOR,
+		NODE_INVERT,
+		NODE_ALWAYS_SUCCEED,
+		NODE_ALWAYS_FAIL,
+	};
+
+	// Record of a task in the depth-first layout of a compiled instance. Its state is at the same index in the state array.
+	// Holds a reference, so that tasks removed from the tree at runtime outlive the layout that points to them.
+	struct CompiledNode {
+		Ref<BTTask> task;
+		NodeKind kind = NODE_TASK;
+		int child_count = 0;
+		int first_child = 0; // Offset of the first child in compiled_children and compiled_child_nodes.
+		int *last_running_idx = nullptr; // Of a sequence or selector - kept in the task, which saves it in snapshots.
+	};
 
 private:
+	// Collects wake-up requests from the tasks ticked during an update of a reactive instance.
+	struct SleepRequest {
+		double wake_after = Math_INF;
+		uint32_t num_requests = 0;
+		bool blocked = false; // Some RUNNING task needs to be ticked every frame.
+		uint64_t instance_id = 0; // Instance that is being updated, so that tasks can wake it up from signals.
+	};
+	static thread_local SleepRequest *sleep_request;
+	// RNG of the instance being updated on this thread.
+	static thread_local LimboRNG *current_rng;
+	// Time by which tasks ticked on this thread should yield (see BTTask::get_remaining_budget_usec()), 0 if unlimited.
+	// Set for the update of an instance with a tick budget, and by BTScheduler for its frame budget.
+	static thread_local uint64_t budget_deadline_usec;
+	// ID of the instance being updated on this thread, or 0 outside of an update.
+	static thread_local uint64_t current_instance_id;
+	// Events consumed by the update in progress on this thread, or nullptr outside of an update.
+	static thread_local const LocalVector<BTPostedEvent> *current_events;
+	// Set by BTScheduler right before it updates an instance, and consumed by that update - nested updates don't inherit it.
+	static thread_local bool scheduled_update_pending;
+	// True while the instance being updated on this thread was updated by BTScheduler.
+	static thread_local bool current_update_scheduled;
+
 	Ref<BTTask> root_task;
+	// Tasks to abort before the next tick, queued by observers (see queue_abort()).
+	LocalVector<uint64_t> pending_aborts;
+
+	// Bounded FIFO of posted events, consumed at the start of the next update. Guarded by event_lock, as are pending_aborts.
+	LocalVector<BTPostedEvent> event_queue;
+	uint32_t event_queue_head = 0;
+	uint32_t event_queue_size = 0;
+	int event_queue_capacity = 32;
+	SpinLock event_lock;
+	LocalVector<BTPostedEvent> consumed_events; // Events of the update in progress.
+	void _consume_events();
 	uint64_t owner_node_id = 0;
 	String source_bt_path;
+	uint64_t source_bt_id = 0;
+	uint64_t source_template_id = 0; // Instance template of the source tree that the tasks were cloned from.
+	uint64_t accounted_memory = 0; // Counted in BTMemoryStats totals, if not zero.
 	BT::Status last_status = BT::FRESH;
 
+	// Work counters, kept in all builds: cheap enough to update on every tick (see get_task_count_average()).
+	uint32_t last_update_tasks = 0;
+	uint64_t tick_count = 0;
+	uint64_t status_change_count = 0;
+	double task_count_average = 0.0;
+	double last_result_clock = 0.0; // Clock time of the last update that didn't return RUNNING.
+
+	bool resume_running = false;
+
+	int64_t seed = 0;
+	LimboRNG rng;
+
+	// Set if the tasks of this instance record into a shared BehaviorTree profile.
+	Ref<BTProfile> profile;
+	// Set if the tasks of this instance count outcomes into a shared BehaviorTree telemetry, in all builds.
+	Ref<BTTelemetry> telemetry;
+	static void _detach_telemetry(BTTask *p_task);
+
+	double update_interval = 0.0;
+	double tick_countdown = 0.0;
+	int tick_budget_usec = 0;
+	int priority = 0;
+	double pending_delta = 0.0;
+	double time_scale = 1.0;
+	double clock = 0.0; // Advanced by each update. Tasks measure their elapsed time against it (see BTTask::get_elapsed_time()).
+
+	bool reactive = false;
+	bool sleeping = false;
+	double sleep_remaining = 0.0;
+	SafeFlag wake_requested; // See request_wake(). Consumed by the next advance() or update.
+	uint64_t sleep_bb_change_count = 0;
+
+	LocalVector<CompiledNode> compiled_nodes;
+	LocalVector<BTTask *> compiled_children;
+	LocalVector<uint32_t> compiled_child_nodes; // Parallel to compiled_children: indices of the children in compiled_nodes.
+	// Parallel to compiled_nodes: a block of the state arena of the behavior tree, or own_compiled_states without one.
+	BTTask::State *compiled_states = nullptr;
+	LocalVector<BTTask::State> own_compiled_states;
+	BTStateArena *state_arena = nullptr;
+
+	void _compile_node(BTTask *p_task);
+	void _clear_compiled();
+	BT::Status _tick_compiled(uint32_t p_index, double p_delta);
+	template <BT::Status CONTINUE>
+	BT::Status _tick_compiled_in_order(const uint32_t *p_children, int p_count, int &r_last_running_idx, double p_delta);
+	BTTask *_find_resume_task(BTTask *p_root) const;
+	BTTask *_find_running_task(BTTask *p_root) const;
+	BT::Status _update(double p_delta);
+	Ref<BTTask> _release_root_task();
+
+	static constexpr uint32_t SNAPSHOT_MAGIC = 0x4954424c; // "LBTI"
+	static constexpr uint32_t POPULATION_MAGIC = 0x5054424c; // "LBTP"
+	static constexpr uint8_t SNAPSHOT_VERSION = 1;
+	static constexpr double TASK_COUNT_SMOOTHING = 0.125; // Weight of the latest update in task_count_average.
+	static int _count_tasks(const BTTask *p_task);
+	static void _collect_tasks(BTTask *p_task, LocalVector<BTTask *> &r_tasks);
+	static Error _read_population(LimboSnapshotReader &p_reader, const LocalVector<BTInstance *> &p_instances, const LocalVector<LocalVector<BTTask *>> &p_tasks, bool p_apply);
+	static void _save_task_state(const BTTask *p_task, const Blackboard *p_parent_scope, LimboSnapshotWriter &p_writer);
+	static void _load_task_state(BTTask *p_task, const Blackboard *p_parent_scope, LimboSnapshotReader &p_reader, bool p_apply = true);
+	static int _transfer_task_state(BTTask *p_old, BTTask *p_new, const Blackboard *p_old_parent_scope, const Blackboard *p_new_parent_scope);
+	bool _advance_sleeping(double p_delta);
+	void _count_update(BT::Status p_prev_status, uint32_t p_tasks);
+
+	// Updates of pure instances in the same state can be shared (see BTScheduler).
+	_FORCE_INLINE_ bool _can_share_update() const { return !reactive && event_queue_size == 0 && pending_aborts.is_empty(); }
+	void _write_shared_state(LimboSnapshotWriter &p_writer) const;
+	void _share_update(double p_delta, const PackedByteArray &p_state, uint32_t p_tasks);
+
+	// Usually no one but the debugger listens, and emitting boxes the status and looks up the signal on every update.
+	_FORCE_INLINE_ void _emit_updated() {
+		if (has_connections(LW_NAME(updated))) {
+			emit_signal(LW_NAME(updated), last_status);
+		}
+	}
+
 #ifdef DEBUG_ENABLED
 	bool monitor_performance = false;
 	StringName monitor_id;
-	double update_time_acc = 0.0;
-	double update_time_n = 0.0;
+	// * In LimboTicks, accumulated only while monitor_performance is on.
+	uint64_t update_ticks_acc = 0;
+	uint64_t update_count = 0;
+	uint64_t update_ticks_max = 0;
+	bool tree_monitored = false; // Reported by BTTreeMonitor instead of its own monitor.
+	// * Read and reset by LimboDebugger for its overview of all instances.
+	uint32_t overview_updates = 0;
+	uint32_t overview_status_changes = 0;
+	uint64_t overview_usec = 0;
+
+	Ref<BTTrace> trace; // Kept after tracing is disabled.
+	bool tracing = false;
 
 	double _get_mean_update_time_msec_and_reset();
+	// Names of the running tasks from the root down to the first running leaf, joined with "/". Empty unless running.
+	String _get_running_path() const;
+	static void _detach_profile(BTTask *p_task);
+	static void _attach_trace(BTTask *p_task, BTTrace *p_trace, uint32_t &r_index);
 	void _add_custom_monitor();
 	void _remove_custom_monitor();
 
@@ -53,9 +235,137 @@ public:
 
 	BT::Status update(double p_delta);
 
+	void set_resume_running(bool p_enable) { resume_running = p_enable; }
+	bool get_resume_running() const { return resume_running; }
+
+	void set_update_interval(double p_interval);
+	double get_update_interval() const { return update_interval; }
+
+	void set_reactive(bool p_reactive);
+	bool is_reactive() const { return reactive; }
+
+	void set_tick_budget_usec(int p_budget) { tick_budget_usec = MAX(p_budget, 0); }
+	int get_tick_budget_usec() const { return tick_budget_usec; }
+
+	// Used by BTScheduler to decide which updates can be deferred when over the frame budget.
+	void set_priority(int p_priority) { priority = p_priority; }
+	int get_priority() const { return priority; }
+
+	void set_time_scale(double p_scale) { time_scale = MAX(p_scale, 0.0); }
+	double get_time_scale() const { return time_scale; }
+
+	_FORCE_INLINE_ double get_clock_time() const { return clock; }
+	void advance_clock(double p_seconds);
+
+	// Microseconds left before the tasks being updated on the calling thread should yield, or -1 if not limited.
+	static int64_t get_remaining_budget_usec();
+
+	_FORCE_INLINE_ bool is_sleeping() const { return sleeping; }
+	void wake();
+	// Thread-safe wake(): the instance wakes up on its next advance(). Can be called from any thread, also while
+	// the instance is being updated on another one.
+	_FORCE_INLINE_ void request_wake() { wake_requested.set(); }
+
+	// Tasks executed by the last update, including the tasks of instances updated from within it.
+	_FORCE_INLINE_ uint32_t get_last_update_task_count() const { return last_update_tasks; }
+	// Exponentially weighted moving average of the tasks executed per update - an estimate of the cost of an update
+	// that doesn't need timing, e.g. for balancing instances between threads.
+	_FORCE_INLINE_ double get_task_count_average() const { return task_count_average; }
+	_FORCE_INLINE_ uint64_t get_tick_count() const { return tick_count; }
+	_FORCE_INLINE_ uint64_t get_status_change_count() const { return status_change_count; }
+	// Instance clock time since an update last returned SUCCESS or FAILURE, or since the first update.
+	_FORCE_INLINE_ double get_time_since_last_result() const { return clock - last_result_clock; }
+
+	void set_event_queue_capacity(int p_capacity);
+	int get_event_queue_capacity() const { return event_queue_capacity; }
+	// Queues an event for the next update, and wakes up the instance. Can be called from any thread.
+	// Events are consumed by tasks such as BTEventSelector, and dropped after the update.
+	bool post_event(const StringName &p_event, const Variant &p_cargo = Variant());
+	bool post_event_id(int p_event_id, const Variant &p_cargo = Variant());
+	int get_posted_event_count();
+	// Events consumed by the update in progress on the calling thread, in the order they were posted.
+	// Empty outside of an update of a BTInstance.
+	static const LocalVector<BTPostedEvent> &get_current_events();
+
+	// Aborts p_task at the start of the next update, if it's still RUNNING, and wakes up the instance.
+	// Lets tasks react to blackboard changes that happen in the middle of a tick (see BTObserver). Can be called from any thread.
+	void queue_abort(BTTask *p_task);
+
+	// Accumulates delta time and returns true when the instance is due for an update.
+	_FORCE_INLINE_ bool advance(double p_delta) {
+		pending_delta += p_delta;
+		if (unlikely(sleeping)) {
+			return _advance_sleeping(p_delta);
+		}
+		if (update_interval <= 0.0) {
+			return true;
+		}
+		tick_countdown -= p_delta;
+		return tick_countdown <= 0.0;
+	}
+
+	// Returns delta time accumulated since the last update and schedules the next one.
+	_FORCE_INLINE_ double consume_pending_delta() {
+		double delta = pending_delta;
+		pending_delta = 0.0;
+		if (update_interval > 0.0) {
+			tick_countdown += update_interval;
+			if (tick_countdown <= 0.0) {
+				// Fell behind by more than one interval - don't try to catch up.
+				tick_countdown = update_interval;
+			}
+		}
+		return delta;
+	}
+
+	// Zero seed is replaced with a random one.
+	void set_seed(int64_t p_seed);
+	int64_t get_seed() const { return seed; }
+
+	// Random stream of the instance being updated on the calling thread. Outside of an update,
+	// returns a stream local to the thread.
+	static LimboRNG &get_current_rng();
+
+	// Captures the status of each task, its runtime state, and the blackboard scopes of this instance.
+	// Outer scopes shared with other instances are not included (see Blackboard::create_snapshot()).
+	PackedByteArray create_snapshot() const;
+	Error restore_snapshot(const PackedByteArray &p_snapshot);
+
+	// Snapshots of many instances of the same behavior tree in a single buffer, laid out per task and per variable,
+	// with runs of equal values stored once. Much smaller and faster than a snapshot of each instance.
+	static PackedByteArray save_population(const TypedArray<BTInstance> &p_instances);
+	static Error load_population(const TypedArray<BTInstance> &p_instances, const PackedByteArray &p_data);
+
+	// Replaces the tasks with a fresh copy of p_behavior_tree, keeping the blackboard. Runtime state is carried over
+	// to the tasks that match the old ones. Returns the number of tasks that kept their state, or -1 on failure.
+	int hot_swap(const Ref<BehaviorTree> &p_behavior_tree);
+
+	// True if the tasks are thread-safe, and the blackboard has no listeners and no writes to its outer scopes.
+	bool is_thread_safe() const;
+	// True if p_task and all of its descendants can be ticked on a worker thread. Doesn't consider the blackboard.
+	static bool is_subtree_thread_safe(const Ref<BTTask> &p_task);
+
+	bool is_pure() const;
+	// True if p_task and all of its descendants only depend on their saved state and the blackboard.
+	static bool is_subtree_pure(const Ref<BTTask> &p_task);
+
+	Dictionary get_memory_usage() const;
+
+	void compile();
+	_FORCE_INLINE_ bool is_compiled() const { return !compiled_nodes.is_empty(); }
+	_FORCE_INLINE_ int get_compiled_node_count() const { return compiled_nodes.size(); }
+	_FORCE_INLINE_ const CompiledNode &get_compiled_node(int p_index) const { return compiled_nodes[p_index]; }
+	// Execution state of the compiled tasks, in the same depth-first order as the nodes.
+	_FORCE_INLINE_ BT::Status get_compiled_status(int p_index) const { return compiled_states[p_index].status; }
+	_FORCE_INLINE_ double get_compiled_elapsed_time(int p_index) const { return compiled_states[p_index].get_elapsed(&clock); }
+
 	void set_monitor_performance(bool p_monitor);
 	bool get_monitor_performance() const;
 
+	void set_trace_enabled(bool p_enabled);
+	bool is_trace_enabled() const;
+	Ref<BTTrace> get_trace() const;
+
 	void register_with_debugger();
 	void unregister_with_debugger();
 
@@ -0,0 +1,207 @@
+/**
+ * bt_instance_pool.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "bt_instance_pool.h"
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/core/class_db.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+void BTInstancePool::set_max_pooled_per_tree(int p_max) {
+	max_pooled_per_tree = MAX(p_max, 0);
+}
+
+Ref<Blackboard> BTInstancePool::_create_blackboard(const Ref<BehaviorTree> &p_behavior_tree, Node *p_instance_owner, Node *p_scene_root) const {
+	Ref<BlackboardPlan> plan = p_behavior_tree->get_blackboard_plan();
+	if (plan.is_valid()) {
+		return plan->create_blackboard(p_instance_owner, Ref<Blackboard>(), p_scene_root);
+	}
+	return Ref<Blackboard>(memnew(Blackboard));
+}
+
+// Returns the pooled entries of p_behavior_tree, creating the list if needed.
+// Entries cloned from an outdated template (e.g., after set_root_task()) are dropped.
+LocalVector<BTInstancePool::Entry> *BTInstancePool::_get_entries(const Ref<BehaviorTree> &p_behavior_tree) {
+	const uint64_t bt_id = p_behavior_tree->get_instance_id();
+	LocalVector<Entry> *entries = pool.getptr(bt_id);
+	if (entries == nullptr) {
+		return &pool.insert(bt_id, LocalVector<Entry>())->value;
+	}
+	const Ref<BTTask> tmpl = p_behavior_tree->get_instance_template();
+	const uint64_t template_id = tmpl.is_valid() ? (uint64_t)tmpl->get_instance_id() : 0;
+	uint32_t kept = 0;
+	for (uint32_t i = 0; i < entries->size(); i++) {
+		if ((*entries)[i].template_id == template_id) {
+			(*entries)[kept++] = (*entries)[i];
+		}
+	}
+	entries->resize(kept);
+	return entries;
+}
+
+bool BTInstancePool::_pop_entry(const Ref<BehaviorTree> &p_behavior_tree, Entry &r_entry) {
+	LocalVector<Entry> *entries = _get_entries(p_behavior_tree);
+	if (entries->is_empty()) {
+		return false;
+	}
+	r_entry = (*entries)[entries->size() - 1];
+	entries->remove_at(entries->size() - 1);
+	return true;
+}
+
+void BTInstancePool::_push_entry(uint64_t p_bt_id, const Entry &p_entry) {
+	LocalVector<Entry> *entries = pool.getptr(p_bt_id);
+	if (entries == nullptr) {
+		entries = &pool.insert(p_bt_id, LocalVector<Entry>())->value;
+	}
+	if (max_pooled_per_tree > 0 && (int)entries->size() >= max_pooled_per_tree) {
+		return;
+	}
+	entries->push_back(p_entry);
+}
+
+Ref<BTInstance> BTInstancePool::acquire(const Ref<BehaviorTree> &p_behavior_tree, Node *p_agent, Node *p_instance_owner, Node *p_custom_scene_root) {
+	ERR_FAIL_COND_V(p_behavior_tree.is_null(), nullptr);
+	ERR_FAIL_NULL_V_MSG(p_agent, nullptr, "BTInstancePool: Acquire failed - agent can't be null.");
+	ERR_FAIL_NULL_V_MSG(p_instance_owner, nullptr, "BTInstancePool: Acquire failed - instance owner can't be null.");
+	Node *scene_root = p_custom_scene_root ? p_custom_scene_root : p_instance_owner->get_owner();
+	ERR_FAIL_NULL_V_MSG(scene_root, nullptr, "BTInstancePool: Acquire failed - unable to establish scene root. This is likely due to the instance owner not being owned by a scene node and custom_scene_root being null.");
+
+	Entry entry;
+	if (!_pop_entry(p_behavior_tree, entry)) {
+		Ref<Blackboard> bb = _create_blackboard(p_behavior_tree, p_instance_owner, scene_root);
+		return p_behavior_tree->instantiate(p_agent, bb, p_instance_owner, scene_root);
+	}
+
+	Ref<Blackboard> bb = entry.blackboard;
+	if (bb.is_null()) {
+		bb = _create_blackboard(p_behavior_tree, p_instance_owner, scene_root);
+	} else {
+		// Restoring the initial state: runtime variables are dropped, plan variables are reset to their defaults.
+		bb->clear();
+		Ref<BlackboardPlan> plan = p_behavior_tree->get_blackboard_plan();
+		if (plan.is_valid()) {
+			plan->populate_blackboard(bb, true, p_instance_owner, scene_root);
+		}
+	}
+	return p_behavior_tree->_create_instance(entry.root_task, entry.template_id, p_agent, bb, p_instance_owner, scene_root);
+}
+
+void BTInstancePool::release(const Ref<BTInstance> &p_instance) {
+	ERR_FAIL_COND(p_instance.is_null());
+	ERR_FAIL_COND_MSG(!p_instance->is_instance_valid(), "BTInstancePool: Instance was already released.");
+	ERR_FAIL_COND_MSG(p_instance->source_bt_id == 0, "BTInstancePool: Instance was not created from a BehaviorTree.");
+
+	Entry entry;
+	entry.blackboard = p_instance->get_blackboard();
+	entry.template_id = p_instance->source_template_id;
+	entry.root_task = p_instance->_release_root_task();
+	_push_entry(p_instance->source_bt_id, entry);
+}
+
+Ref<BTInstance> BTInstancePool::acquire_with_blackboard(const Ref<BehaviorTree> &p_behavior_tree, Node *p_agent, const Ref<Blackboard> &p_blackboard, Node *p_instance_owner, Node *p_custom_scene_root) {
+	ERR_FAIL_COND_V(p_behavior_tree.is_null(), nullptr);
+	ERR_FAIL_NULL_V_MSG(p_agent, nullptr, "BTInstancePool: Acquire failed - agent can't be null.");
+	ERR_FAIL_NULL_V_MSG(p_instance_owner, nullptr, "BTInstancePool: Acquire failed - instance owner can't be null.");
+	ERR_FAIL_COND_V_MSG(p_blackboard.is_null(), nullptr, "BTInstancePool: Acquire failed - blackboard can't be null.");
+	Node *scene_root = p_custom_scene_root ? p_custom_scene_root : p_instance_owner->get_owner();
+	ERR_FAIL_NULL_V_MSG(scene_root, nullptr, "BTInstancePool: Acquire failed - unable to establish scene root. This is likely due to the instance owner not being owned by a scene node and custom_scene_root being null.");
+
+	Entry entry;
+	if (!_pop_entry(p_behavior_tree, entry)) {
+		return p_behavior_tree->instantiate(p_agent, p_blackboard, p_instance_owner, scene_root);
+	}
+	// A recycled blackboard of the entry (if any) is dropped, as the instance runs on the given one.
+	return p_behavior_tree->_create_instance(entry.root_task, entry.template_id, p_agent, p_blackboard, p_instance_owner, scene_root);
+}
+
+void BTInstancePool::release_tasks(const Ref<BTInstance> &p_instance) {
+	ERR_FAIL_COND(p_instance.is_null());
+	ERR_FAIL_COND_MSG(!p_instance->is_instance_valid(), "BTInstancePool: Instance was already released.");
+	ERR_FAIL_COND_MSG(p_instance->source_bt_id == 0, "BTInstancePool: Instance was not created from a BehaviorTree.");
+
+	Entry entry;
+	entry.template_id = p_instance->source_template_id;
+	entry.root_task = p_instance->_release_root_task();
+	_push_entry(p_instance->source_bt_id, entry);
+}
+
+TypedArray<BTInstance> BTInstancePool::acquire_population(const Ref<BehaviorTree> &p_behavior_tree, const TypedArray<Node> &p_agents, const PackedByteArray &p_data, Node *p_custom_scene_root) {
+	TypedArray<BTInstance> instances;
+	ERR_FAIL_COND_V(p_behavior_tree.is_null(), instances);
+	instances.resize(p_agents.size());
+	for (int i = 0; i < p_agents.size(); i++) {
+		Node *agent = Object::cast_to<Node>(p_agents[i]);
+		Ref<BTInstance> inst = acquire(p_behavior_tree, agent, agent, p_custom_scene_root);
+		if (inst.is_null()) {
+			instances.resize(i);
+			break;
+		}
+		instances[i] = inst;
+	}
+	if (instances.size() != p_agents.size() || BTInstance::load_population(instances, p_data) != OK) {
+		ERR_PRINT("BTInstancePool: Failed to restore the population - acquired instances are released.");
+		for (int i = 0; i < instances.size(); i++) {
+			release(instances[i]);
+		}
+		return TypedArray<BTInstance>();
+	}
+	return instances;
+}
+
+void BTInstancePool::prewarm(const Ref<BehaviorTree> &p_behavior_tree, int p_count) {
+	ERR_FAIL_COND(p_behavior_tree.is_null());
+	ERR_FAIL_COND_MSG(p_behavior_tree->get_root_task().is_null(), "BTInstancePool: Prewarm failed - BT has no valid root task.");
+	LocalVector<Entry> *entries = _get_entries(p_behavior_tree);
+	const Ref<BTTask> tmpl = p_behavior_tree->get_instance_template();
+	if (max_pooled_per_tree > 0) {
+		p_count = MIN(p_count, max_pooled_per_tree - (int)entries->size());
+	}
+	for (int i = 0; i < p_count; i++) {
+		Entry entry;
+		entry.root_task = tmpl->clone();
+		entry.template_id = tmpl->get_instance_id();
+		entries->push_back(entry);
+	}
+}
+
+int BTInstancePool::get_pooled_count(const Ref<BehaviorTree> &p_behavior_tree) const {
+	ERR_FAIL_COND_V(p_behavior_tree.is_null(), 0);
+	const LocalVector<Entry> *entries = pool.getptr(p_behavior_tree->get_instance_id());
+	if (entries == nullptr) {
+		return 0;
+	}
+	const Ref<BTTask> tmpl = p_behavior_tree->get_instance_template();
+	const uint64_t template_id = tmpl.is_valid() ? (uint64_t)tmpl->get_instance_id() : 0;
+	int count = 0;
+	for (const Entry &entry : *entries) {
+		count += entry.template_id == template_id;
+	}
+	return count;
+}
+
+void BTInstancePool::clear() {
+	pool.clear();
+}
+
+void BTInstancePool::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_max_pooled_per_tree", "max"), &BTInstancePool::set_max_pooled_per_tree);
+	ClassDB::bind_method(D_METHOD("get_max_pooled_per_tree"), &BTInstancePool::get_max_pooled_per_tree);
+
+	ClassDB::bind_method(D_METHOD("acquire", "behavior_tree", "agent", "instance_owner", "custom_scene_root"), &BTInstancePool::acquire, DEFVAL(Variant()));
+	ClassDB::bind_method(D_METHOD("release", "instance"), &BTInstancePool::release);
+	ClassDB::bind_method(D_METHOD("acquire_population", "behavior_tree", "agents", "data", "custom_scene_root"), &BTInstancePool::acquire_population, DEFVAL(Variant()));
+	ClassDB::bind_method(D_METHOD("prewarm", "behavior_tree", "count"), &BTInstancePool::prewarm);
+	ClassDB::bind_method(D_METHOD("get_pooled_count", "behavior_tree"), &BTInstancePool::get_pooled_count);
+	ClassDB::bind_method(D_METHOD("clear"), &BTInstancePool::clear);
+
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "max_pooled_per_tree", PROPERTY_HINT_RANGE, "0,1024,1,or_greater"), "set_max_pooled_per_tree", "get_max_pooled_per_tree");
+}
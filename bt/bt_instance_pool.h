@@ -0,0 +1,74 @@
+/**
+ * bt_instance_pool.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef BT_INSTANCE_POOL_H
+#define BT_INSTANCE_POOL_H
+
+#include "behavior_tree.h"
+#include "bt_instance.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/object/ref_counted.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+using namespace godot;
+#endif // LIMBOAI_GDEXTENSION
+
+// Recycles task trees and blackboards of released instances, avoiding BehaviorTree::instantiate() cloning costs.
+class BTInstancePool : public RefCounted {
+	GDCLASS(BTInstancePool, RefCounted);
+
+private:
+	struct Entry {
+		Ref<BTTask> root_task;
+		Ref<Blackboard> blackboard; // Null if prewarmed.
+		uint64_t template_id = 0; // Instance template that root_task was cloned from.
+	};
+
+	// Keyed by the instance ID of the BehaviorTree.
+	HashMap<uint64_t, LocalVector<Entry>> pool;
+	int max_pooled_per_tree = 0;
+
+	Ref<Blackboard> _create_blackboard(const Ref<BehaviorTree> &p_behavior_tree, Node *p_instance_owner, Node *p_scene_root) const;
+	LocalVector<Entry> *_get_entries(const Ref<BehaviorTree> &p_behavior_tree);
+	bool _pop_entry(const Ref<BehaviorTree> &p_behavior_tree, Entry &r_entry);
+	void _push_entry(uint64_t p_bt_id, const Entry &p_entry);
+
+protected:
+	static void _bind_methods();
+
+public:
+	void set_max_pooled_per_tree(int p_max);
+	int get_max_pooled_per_tree() const { return max_pooled_per_tree; }
+
+	Ref<BTInstance> acquire(const Ref<BehaviorTree> &p_behavior_tree, Node *p_agent, Node *p_instance_owner, Node *p_custom_scene_root = nullptr);
+	void release(const Ref<BTInstance> &p_instance);
+
+	// Variants for instances running on a blackboard they don't own (e.g., the shared blackboard of BTPlayer LODs):
+	// the given blackboard is used as is, and only the task tree is recycled on release.
+	Ref<BTInstance> acquire_with_blackboard(const Ref<BehaviorTree> &p_behavior_tree, Node *p_agent, const Ref<Blackboard> &p_blackboard, Node *p_instance_owner, Node *p_custom_scene_root = nullptr);
+	void release_tasks(const Ref<BTInstance> &p_instance);
+
+	// Acquires an instance for each agent, owned by the agent, and restores them from BTInstance::save_population().
+	TypedArray<BTInstance> acquire_population(const Ref<BehaviorTree> &p_behavior_tree, const TypedArray<Node> &p_agents, const PackedByteArray &p_data, Node *p_custom_scene_root = nullptr);
+
+	void prewarm(const Ref<BehaviorTree> &p_behavior_tree, int p_count);
+	int get_pooled_count(const Ref<BehaviorTree> &p_behavior_tree) const;
+	void clear();
+};
+
+#endif // BT_INSTANCE_POOL_H
@@ -0,0 +1,171 @@
+/**
+ * bt_memory_stats.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "bt_memory_stats.h"
+
+#include "../blackboard/bb_param/bb_param.h"
+#include "../util/limbo_compat.h"
+#include "../util/limbo_task_db.h"
+#include "bt_instance.h"
+
+#ifdef LIMBOAI_MODULE
+#include "main/performance.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/performance.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+SpinLock BTMemoryStats::lock;
+HashMap<uint64_t, BTMemoryStats::TreeMemory> BTMemoryStats::trees;
+uint32_t BTMemoryStats::total_instances = 0;
+uint64_t BTMemoryStats::total_bytes = 0;
+bool BTMemoryStats::monitors_added = false;
+
+uint64_t BTMemoryStats::get_task_memory_usage(const BTTask *p_root) {
+	ERR_FAIL_NULL_V(p_root, 0);
+	uint64_t usage = MAX(uint64_t(LimboTaskDB::get_task_size(p_root->get_class())), uint64_t(sizeof(BTTask)));
+	usage += p_root->data.children.size() * sizeof(Ref<BTTask>);
+	usage += p_root->get_custom_name().length() * sizeof(char32_t);
+	if (p_root->data.context != &BTTask::empty_context && (p_root->data.parent == nullptr || p_root->data.parent->data.context != p_root->data.context)) {
+		usage += sizeof(BTTask::Context); // * Counted once per scope.
+	}
+	for (int i = 0; i < p_root->data.children.size(); i++) {
+		usage += get_task_memory_usage(p_root->data.children[i].ptr());
+	}
+	return usage;
+}
+
+void BTMemoryStats::_collect_parameters(const BTTask *p_task, HashSet<BBParam *> &r_params) {
+	for (const StringName &prop_name : BTTask::_get_object_properties(p_task)) {
+		Ref<BBParam> param = p_task->get(prop_name);
+		if (param.is_valid()) {
+			r_params.insert(param.ptr());
+		}
+	}
+	for (int i = 0; i < p_task->get_child_count(); i++) {
+		_collect_parameters(p_task->get_child(i).ptr(), r_params);
+	}
+}
+
+uint64_t BTMemoryStats::get_parameter_memory_usage(const BTTask *p_root) {
+	ERR_FAIL_NULL_V(p_root, 0);
+	HashSet<BBParam *> params;
+	_collect_parameters(p_root, params);
+	uint64_t usage = 0;
+	for (BBParam *param : params) {
+		usage += sizeof(BBParam) + BBVariable::get_value_memory_usage(param->get_saved_value());
+	}
+	return usage;
+}
+
+void BTMemoryStats::_collect_blackboards(const BTTask *p_task, const Blackboard *p_parent_bb, HashSet<const Blackboard *> &r_blackboards) {
+	const Blackboard *bb = p_task->get_blackboard().ptr();
+	if (bb && bb != p_parent_bb) {
+		r_blackboards.insert(bb);
+	}
+	for (int i = 0; i < p_task->get_child_count(); i++) {
+		_collect_blackboards(p_task->get_child(i).ptr(), bb, r_blackboards);
+	}
+}
+
+uint64_t BTMemoryStats::get_blackboard_memory_usage(const BTTask *p_root) {
+	ERR_FAIL_NULL_V(p_root, 0);
+	HashSet<const Blackboard *> blackboards;
+	_collect_blackboards(p_root, nullptr, blackboards);
+	uint64_t usage = 0;
+	for (const Blackboard *bb : blackboards) {
+		usage += bb->get_memory_usage();
+	}
+	return usage;
+}
+
+void BTMemoryStats::add_instance(BTInstance *p_instance) {
+	ERR_FAIL_NULL(p_instance);
+	ERR_FAIL_COND(p_instance->accounted_memory != 0);
+	const BTTask *root = p_instance->get_root_task().ptr();
+	ERR_FAIL_NULL(root);
+	p_instance->accounted_memory = sizeof(BTInstance) + get_task_memory_usage(root) + get_blackboard_memory_usage(root) +
+			p_instance->compiled_nodes.size() * sizeof(BTInstance::CompiledNode) + p_instance->compiled_children.size() * (sizeof(BTTask *) + sizeof(uint32_t)) +
+			p_instance->compiled_nodes.size() * sizeof(BTTask::State);
+
+	lock.lock();
+	TreeMemory &tree = trees[p_instance->source_bt_id];
+	tree.instances += 1;
+	tree.bytes += p_instance->accounted_memory;
+	total_instances += 1;
+	total_bytes += p_instance->accounted_memory;
+	lock.unlock();
+
+	Performance *perf = Performance::get_singleton();
+	if (unlikely(!monitors_added && perf)) {
+		monitors_added = true;
+		if (!perf->has_custom_monitor("LimboAI/memory_kib")) {
+			PERFORMANCE_ADD_CUSTOM_MONITOR("LimboAI/memory_kib", callable_mp_static(&BTMemoryStats::_get_total_kib));
+			PERFORMANCE_ADD_CUSTOM_MONITOR("LimboAI/live_instances", callable_mp_static(&BTMemoryStats::_get_total_instances));
+		}
+	}
+}
+
+// Instances can be freed on any thread, e.g. by a worker that held the last reference.
+void BTMemoryStats::remove_instance(BTInstance *p_instance) {
+	ERR_FAIL_NULL(p_instance);
+	if (p_instance->accounted_memory == 0) {
+		return;
+	}
+	lock.lock();
+	TreeMemory *tree = trees.getptr(p_instance->source_bt_id);
+	if (tree) {
+		tree->instances -= 1;
+		tree->bytes -= p_instance->accounted_memory;
+		if (tree->instances == 0) {
+			trees.erase(p_instance->source_bt_id);
+		}
+	}
+	total_instances -= 1;
+	total_bytes -= p_instance->accounted_memory;
+	lock.unlock();
+	p_instance->accounted_memory = 0;
+}
+
+uint64_t BTMemoryStats::get_tree_memory_usage(uint64_t p_behavior_tree_id) {
+	lock.lock();
+	const TreeMemory *tree = trees.getptr(p_behavior_tree_id);
+	const uint64_t bytes = tree ? tree->bytes : 0;
+	lock.unlock();
+	return bytes;
+}
+
+uint32_t BTMemoryStats::get_tree_instance_count(uint64_t p_behavior_tree_id) {
+	lock.lock();
+	const TreeMemory *tree = trees.getptr(p_behavior_tree_id);
+	const uint32_t count = tree ? tree->instances : 0;
+	lock.unlock();
+	return count;
+}
+
+uint64_t BTMemoryStats::get_total_memory_usage() {
+	lock.lock();
+	const uint64_t bytes = total_bytes;
+	lock.unlock();
+	return bytes;
+}
+
+double BTMemoryStats::_get_total_kib() {
+	return get_total_memory_usage() / 1024.0;
+}
+
+int64_t BTMemoryStats::_get_total_instances() {
+	lock.lock();
+	const int64_t count = total_instances;
+	lock.unlock();
+	return count;
+}
@@ -0,0 +1,71 @@
+/**
+ * bt_memory_stats.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef BT_MEMORY_STATS_H
+#define BT_MEMORY_STATS_H
+
+#ifdef LIMBOAI_MODULE
+#include "core/os/spin_lock.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/hash_set.h"
+#include "core/typedefs.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/core/defs.hpp>
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/hash_set.hpp>
+#include <godot_cpp/templates/spin_lock.hpp>
+using namespace godot;
+#endif // LIMBOAI_GDEXTENSION
+
+class BBParam;
+class Blackboard;
+class BTInstance;
+class BTTask;
+
+// Estimated memory used by behavior tree instances, exposed as LimboAI/memory_* performance monitors.
+// An instance is measured once, when it is created: growth of its blackboard afterwards is not reflected in the totals.
+class BTMemoryStats {
+private:
+	struct TreeMemory {
+		uint32_t instances = 0;
+		uint64_t bytes = 0;
+	};
+
+	static SpinLock lock;
+	static HashMap<uint64_t, TreeMemory> trees; // By BehaviorTree instance ID.
+	static uint32_t total_instances;
+	static uint64_t total_bytes;
+	static bool monitors_added;
+
+	static void _collect_parameters(const BTTask *p_task, HashSet<BBParam *> &r_params);
+	static void _collect_blackboards(const BTTask *p_task, const Blackboard *p_parent_bb, HashSet<const Blackboard *> &r_blackboards);
+	static double _get_total_kib();
+	static int64_t _get_total_instances();
+
+public:
+	// Task objects, excluding BBParam resources. Those with saved values are shared by all instances of a BehaviorTree,
+	// while each instance has its own copy of those with a read cache (see BBParam::has_read_cache()).
+	static uint64_t get_task_memory_usage(const BTTask *p_root);
+	static uint64_t get_parameter_memory_usage(const BTTask *p_root);
+	// Root blackboard, and scopes created by tasks such as BTNewScope.
+	static uint64_t get_blackboard_memory_usage(const BTTask *p_root);
+
+	static void add_instance(BTInstance *p_instance);
+	static void remove_instance(BTInstance *p_instance);
+
+	static uint64_t get_tree_memory_usage(uint64_t p_behavior_tree_id);
+	static uint32_t get_tree_instance_count(uint64_t p_behavior_tree_id);
+	static uint64_t get_total_memory_usage();
+};
+
+#endif // BT_MEMORY_STATS_H
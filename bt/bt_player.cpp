@@ -12,7 +12,9 @@
 #include "bt_player.h"
 
 #include "../util/limbo_compat.h"
+#include "../util/limbo_spatial_index.h"
 #include "../util/limbo_string_names.h"
+#include "bt_scheduler.h"
 
 #ifdef LIMBOAI_MODULE
 #include "core/config/engine.h"
@@ -24,6 +26,11 @@
 #include "core/string/string_name.h"
 #include "core/variant/variant.h"
 #include "main/performance.h"
+#include "scene/2d/camera_2d.h"
+#include "scene/main/viewport.h"
+#ifndef _3D_DISABLED
+#include "scene/3d/camera_3d.h"
+#endif // ! _3D_DISABLED
 
 #define IS_DEBUGGER_ACTIVE() (EngineDebugger::is_active())
 #define GET_TICKS_USEC() (OS::get_singleton()->get_ticks_usec())
@@ -31,9 +38,12 @@
 #endif // ! LIMBOAI_MODULE
 
 #ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/camera2d.hpp>
+#include <godot_cpp/classes/camera3d.hpp>
 #include <godot_cpp/classes/engine_debugger.hpp>
 #include <godot_cpp/classes/performance.hpp>
 #include <godot_cpp/classes/time.hpp>
+#include <godot_cpp/classes/viewport.hpp>
 
 #define IS_DEBUGGER_ACTIVE() (EngineDebugger::get_singleton()->is_active())
 #define GET_TICKS_USEC() (Time::get_singleton()->get_ticks_usec())
@@ -44,6 +54,10 @@ VARIANT_ENUM_CAST(BTPlayer::UpdateMode);
 
 void BTPlayer::_load_tree() {
 	bt_instance.unref();
+	load_id += 1;
+	instantiation_pending = false;
+	current_lod = 0;
+	lod_elapsed = lod_check_interval; // Pick the LOD on the first update.
 	ERR_FAIL_COND_MSG(!behavior_tree.is_valid(), "BTPlayer: Initialization failed - needs a valid behavior tree.");
 	ERR_FAIL_COND_MSG(!behavior_tree->get_root_task().is_valid(), "BTPlayer: Initialization failed - behavior tree has no valid root task.");
 	Node *agent = GET_NODE(this, agent_node);
@@ -51,12 +65,39 @@ void BTPlayer::_load_tree() {
 	Node *scene_root = _get_scene_root();
 	ERR_FAIL_COND_MSG(scene_root == nullptr,
 			"BTPlayer: Initialization failed - unable to establish scene root. This is likely due to BTPlayer not being owned by a scene node. Check BTPlayer.set_scene_root_hint().");
-	bt_instance = behavior_tree->instantiate(agent, blackboard, this, scene_root);
+	if (async_instantiation) {
+		instantiation_pending = true;
+		behavior_tree->instantiate_async(agent, blackboard, this, callable_mp(this, &BTPlayer::_on_async_instantiated).bind(load_id), scene_root);
+		return;
+	}
+	_set_up_instance(behavior_tree->instantiate(agent, blackboard, this, scene_root));
+}
+
+void BTPlayer::_on_async_instantiated(const Ref<BTInstance> &p_instance, uint32_t p_load_id) {
+	if (p_load_id != load_id) {
+		return;
+	}
+	instantiation_pending = false;
+	_set_up_instance(p_instance);
+}
+
+void BTPlayer::_set_up_instance(const Ref<BTInstance> &p_instance) {
+	bt_instance = p_instance;
 	ERR_FAIL_COND_MSG(bt_instance.is_null(), "BTPlayer: Failed to instantiate behavior tree.");
+	bt_instance->set_seed(seed);
+	bt_instance->set_update_interval(update_interval);
+	bt_instance->set_reactive(reactive);
+	bt_instance->set_tick_budget_usec(tick_budget_usec);
+	bt_instance->set_priority(priority);
+	bt_instance->set_time_scale(time_scale);
+	if (scheduled) {
+		BTScheduler::get_singleton()->notify_tree_changed(this);
+	}
 #ifdef DEBUG_ENABLED
 	bt_instance->set_monitor_performance(monitor_performance);
 	bt_instance->register_with_debugger();
 #endif // DEBUG_ENABLED
+	emit_signal(LW_NAME(instantiated));
 }
 
 void BTPlayer::_update_blackboard_plan() {
@@ -73,7 +114,10 @@ void BTPlayer::_update_blackboard_plan() {
 void BTPlayer::set_bt_instance(const Ref<BTInstance> &p_bt_instance) {
 	ERR_FAIL_COND_MSG(p_bt_instance.is_null(), "BTPlayer: Failed to set behavior tree instance - instance is null.");
 	ERR_FAIL_COND_MSG(!p_bt_instance->is_instance_valid(), "BTPlayer: Failed to set behavior tree instance - instance is not valid.");
+	ERR_FAIL_NULL_MSG(p_bt_instance->get_agent(), "BTPlayer: Failed to set behavior tree instance - instance has no agent. Use BTRunner for headless instances.");
 
+	load_id += 1;
+	instantiation_pending = false;
 	bt_instance = p_bt_instance;
 	blackboard = p_bt_instance->get_blackboard();
 	agent_node = p_bt_instance->get_agent()->get_path();
@@ -123,37 +167,248 @@ void BTPlayer::set_blackboard_plan(const Ref<BlackboardPlan> &p_plan) {
 
 void BTPlayer::set_update_mode(UpdateMode p_mode) {
 	update_mode = p_mode;
+	fixed_accumulator = 0.0;
 	set_active(active);
 }
 
+void BTPlayer::set_fixed_timestep(double p_timestep) {
+	ERR_FAIL_COND_MSG(p_timestep <= 0.0, "BTPlayer: Fixed timestep must be positive.");
+	fixed_timestep = p_timestep;
+}
+
+void BTPlayer::set_update_interval(double p_interval) {
+	update_interval = MAX(p_interval, 0.0);
+	if (bt_instance.is_valid()) {
+		bt_instance->set_update_interval(update_interval);
+	}
+}
+
+void BTPlayer::set_reactive(bool p_reactive) {
+	reactive = p_reactive;
+	if (bt_instance.is_valid()) {
+		bt_instance->set_reactive(reactive);
+	}
+}
+
+void BTPlayer::set_tick_budget_usec(int p_budget) {
+	tick_budget_usec = MAX(p_budget, 0);
+	if (bt_instance.is_valid()) {
+		bt_instance->set_tick_budget_usec(tick_budget_usec);
+	}
+}
+
+void BTPlayer::set_priority(int p_priority) {
+	priority = p_priority;
+	if (bt_instance.is_valid()) {
+		bt_instance->set_priority(priority);
+	}
+}
+
+void BTPlayer::set_time_scale(double p_scale) {
+	time_scale = MAX(p_scale, 0.0);
+	if (bt_instance.is_valid()) {
+		bt_instance->set_time_scale(time_scale);
+	}
+}
+
+void BTPlayer::set_seed(int64_t p_seed) {
+	seed = p_seed;
+	if (bt_instance.is_valid()) {
+		bt_instance->set_seed(seed);
+	}
+}
+
 void BTPlayer::set_active(bool p_active) {
 	active = p_active;
-	bool is_not_editor = !Engine::get_singleton()->is_editor_hint();
-	set_process(update_mode == UpdateMode::IDLE && active && is_not_editor);
-	set_physics_process(update_mode == UpdateMode::PHYSICS && active && is_not_editor);
-	set_process_input(active && is_not_editor);
+	set_process_input(active && !Engine::get_singleton()->is_editor_hint());
+	_update_processing();
+}
+
+void BTPlayer::sleep() {
+	if (sleeping) {
+		return;
+	}
+	sleeping = true;
+	_update_processing();
+}
+
+void BTPlayer::wake() {
+	if (!sleeping) {
+		return;
+	}
+	sleeping = false;
+	_update_processing();
+}
+
+void BTPlayer::_update_processing() {
+	bool enabled = active && !sleeping && !Engine::get_singleton()->is_editor_hint();
+	set_process((update_mode == UpdateMode::IDLE || update_mode == UpdateMode::FIXED) && enabled);
+	set_physics_process(update_mode == UpdateMode::PHYSICS && enabled);
+	_update_scheduling();
+}
+
+void BTPlayer::_update_scheduling() {
+	bool should_schedule = update_mode == UpdateMode::SCHEDULED && active && !sleeping && is_inside_tree() && !Engine::get_singleton()->is_editor_hint();
+	if (should_schedule == scheduled || BTScheduler::get_singleton() == nullptr) {
+		return;
+	}
+	scheduled = should_schedule;
+	if (scheduled) {
+		BTScheduler::get_singleton()->register_player(this);
+	} else {
+		BTScheduler::get_singleton()->unregister_player(this);
+	}
 }
 
 void BTPlayer::update(double p_delta) {
+	if (instantiation_pending || sleeping) {
+		return;
+	}
 	if (!bt_instance.is_valid()) {
 		ERR_PRINT_ONCE(vformat("BTPlayer doesn't have a behavior tree with a valid root task to execute (owner: %s)", get_owner()));
 		return;
 	}
 
+	if (update_mode == UpdateMode::MANUAL) {
+		_advance_lod(p_delta);
+	}
 	if (active) {
-		BT::Status status = bt_instance->update(p_delta);
-		emit_signal(LW_NAME(updated), status);
-#ifndef DISABLE_DEPRECATED
-		if (status == BTTask::SUCCESS || status == BTTask::FAILURE) {
-			emit_signal(LW_NAME(behavior_tree_finished), status);
+		_emit_updated(bt_instance->update(p_delta));
+	}
+}
+
+void BTPlayer::set_lod_trees(const TypedArray<BehaviorTree> &p_trees) {
+	lod_trees = p_trees;
+	lod_elapsed = lod_check_interval;
+}
+
+void BTPlayer::set_lod_check_interval(double p_interval) {
+	lod_check_interval = MAX(p_interval, 0.0);
+}
+
+void BTPlayer::set_lod_override(int p_lod) {
+	lod_override = MAX(p_lod, -1);
+	// Applied on the next update, as the tree may be in the middle of a tick.
+	lod_elapsed = lod_check_interval;
+}
+
+void BTPlayer::_advance_lod(double p_delta) {
+	if (lod_trees.is_empty() || bt_instance.is_null() || behavior_tree.is_null()) {
+		return;
+	}
+	// Checked even while the tree sleeps, so that a dormant variant is swapped out as soon as it's needed.
+	lod_elapsed += p_delta;
+	if (lod_elapsed < lod_check_interval) {
+		return;
+	}
+	lod_elapsed = 0.0;
+	int lod = _compute_lod();
+	if (lod != current_lod) {
+		_swap_lod(lod);
+	}
+}
+
+int BTPlayer::_compute_lod() const {
+	if (lod_override >= 0) {
+		return MIN(lod_override, (int)lod_trees.size());
+	}
+	Node *reference = nullptr;
+	if (!lod_reference.is_empty()) {
+		reference = GET_NODE(this, lod_reference);
+	} else if (Viewport *viewport = get_viewport()) {
+#ifndef _3D_DISABLED
+		reference = viewport->get_camera_3d();
+#endif // ! _3D_DISABLED
+		if (reference == nullptr) {
+			reference = viewport->get_camera_2d();
 		}
+	}
+	Vector3 agent_position;
+	Vector3 reference_position;
+	if (reference == nullptr || !LimboSpatialIndex::get_node_position(bt_instance->get_agent(), agent_position) || !LimboSpatialIndex::get_node_position(reference, reference_position)) {
+		return current_lod;
+	}
+	// Distances are thresholds in ascending order: passing the i-th one selects lod_trees[i].
+	const real_t distance_sq = agent_position.distance_squared_to(reference_position);
+	const int count = MIN((int)lod_trees.size(), (int)lod_distances.size());
+	int lod = 0;
+	while (lod < count && distance_sq >= real_t(lod_distances[lod]) * real_t(lod_distances[lod])) {
+		lod++;
+	}
+	return lod;
+}
+
+void BTPlayer::_swap_lod(int p_lod) {
+	Ref<BehaviorTree> tree = p_lod == 0 ? behavior_tree : Ref<BehaviorTree>(lod_trees[p_lod - 1]);
+	ERR_FAIL_COND_MSG(tree.is_null() || tree->get_root_task().is_null(), vformat("BTPlayer: LOD %d needs a valid behavior tree with a valid root task.", p_lod));
+	if (lod_pool.is_null()) {
+		lod_pool = Ref<BTInstancePool>(memnew(BTInstancePool));
+	}
+	Node *scene_root = _get_scene_root();
+	Ref<BlackboardPlan> plan = tree->get_blackboard_plan();
+	if (plan.is_valid()) {
+		// Variables the variant adds to the shared blackboard; existing values are kept.
+		plan->populate_blackboard(blackboard, false, this, scene_root);
+	}
+	Ref<BTInstance> inst = lod_pool->acquire_with_blackboard(tree, bt_instance->get_agent(), blackboard, this, scene_root);
+	ERR_FAIL_COND_MSG(inst.is_null(), vformat("BTPlayer: Failed to swap to LOD %d.", p_lod));
+
+#ifdef DEBUG_ENABLED
+	bt_instance->set_monitor_performance(false);
+	bt_instance->unregister_with_debugger();
+#endif // DEBUG_ENABLED
+	// Aborts the running tasks of the previous variant.
+	lod_pool->release_tasks(bt_instance);
+	current_lod = p_lod;
+	_set_up_instance(inst);
+	emit_signal(LW_NAME(lod_changed), current_lod);
+}
+
+void BTPlayer::_emit_updated(BT::Status p_status) {
+	if (has_connections(LW_NAME(updated))) {
+		emit_signal(LW_NAME(updated), p_status);
+	}
+#ifndef DISABLE_DEPRECATED
+	if (p_status == BTTask::SUCCESS || p_status == BTTask::FAILURE) {
+		emit_signal(LW_NAME(behavior_tree_finished), p_status);
+	}
 #endif // DISABLE_DEPRECATED
+}
+
+void BTPlayer::_update_with_interval(double p_delta) {
+	_advance_lod(p_delta);
+	_update_instance(p_delta);
+}
+
+void BTPlayer::_update_instance(double p_delta) {
+	if (bt_instance.is_valid()) {
+		if (!bt_instance->advance(p_delta)) {
+			return;
+		}
+		p_delta = bt_instance->consume_pending_delta();
+	}
+	update(p_delta);
+}
+
+void BTPlayer::_update_fixed(double p_delta) {
+	_advance_lod(p_delta);
+	fixed_accumulator += p_delta;
+	int steps = 0;
+	while (fixed_accumulator >= fixed_timestep && steps < max_catch_up_steps) {
+		fixed_accumulator -= fixed_timestep;
+		steps++;
+		_update_instance(fixed_timestep);
+	}
+	if (fixed_accumulator >= fixed_timestep) {
+		// * Too far behind: the backlog is dropped, so that a slow frame can't cause longer and longer catch-ups.
+		fixed_accumulator = Math::fmod(fixed_accumulator, fixed_timestep);
 	}
 }
 
 void BTPlayer::restart() {
 	ERR_FAIL_COND_MSG(bt_instance.is_null(), "BTPlayer: Restart failed - no valid tree instance. Make sure the BTPlayer has a valid behavior tree with a valid root task.");
 	bt_instance->get_root_task()->abort();
+	bt_instance->wake();
 	set_active(true);
 }
 
@@ -170,12 +425,14 @@ void BTPlayer::set_monitor_performance(bool p_monitor_performance) {
 void BTPlayer::_notification(int p_notification) {
 	switch (p_notification) {
 		case NOTIFICATION_PROCESS: {
-			Variant time = get_process_delta_time();
-			update(time);
+			if (update_mode == UpdateMode::FIXED) {
+				_update_fixed(get_process_delta_time());
+			} else {
+				_update_with_interval(get_process_delta_time());
+			}
 		} break;
 		case NOTIFICATION_PHYSICS_PROCESS: {
-			Variant time = get_physics_process_delta_time();
-			update(time);
+			_update_with_interval(get_physics_process_delta_time());
 		} break;
 		case NOTIFICATION_READY: {
 			if (!Engine::get_singleton()->is_editor_hint()) {
@@ -201,8 +458,13 @@ void BTPlayer::_notification(int p_notification) {
 				bt_instance->register_with_debugger();
 			}
 #endif // DEBUG_ENABLED
+			_update_scheduling();
 		} break;
 		case NOTIFICATION_EXIT_TREE: {
+			if (scheduled) {
+				scheduled = false;
+				BTScheduler::get_singleton()->unregister_player(this);
+			}
 #ifdef DEBUG_ENABLED
 			if (bt_instance.is_valid()) {
 				bt_instance->set_monitor_performance(false);
@@ -226,6 +488,22 @@ void BTPlayer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_agent_node"), &BTPlayer::get_agent_node);
 	ClassDB::bind_method(D_METHOD("set_update_mode", "update_mode"), &BTPlayer::set_update_mode);
 	ClassDB::bind_method(D_METHOD("get_update_mode"), &BTPlayer::get_update_mode);
+	ClassDB::bind_method(D_METHOD("set_fixed_timestep", "timestep"), &BTPlayer::set_fixed_timestep);
+	ClassDB::bind_method(D_METHOD("get_fixed_timestep"), &BTPlayer::get_fixed_timestep);
+	ClassDB::bind_method(D_METHOD("set_max_catch_up_steps", "steps"), &BTPlayer::set_max_catch_up_steps);
+	ClassDB::bind_method(D_METHOD("get_max_catch_up_steps"), &BTPlayer::get_max_catch_up_steps);
+	ClassDB::bind_method(D_METHOD("set_update_interval", "interval"), &BTPlayer::set_update_interval);
+	ClassDB::bind_method(D_METHOD("get_update_interval"), &BTPlayer::get_update_interval);
+	ClassDB::bind_method(D_METHOD("set_reactive", "enable"), &BTPlayer::set_reactive);
+	ClassDB::bind_method(D_METHOD("is_reactive"), &BTPlayer::is_reactive);
+	ClassDB::bind_method(D_METHOD("set_priority", "priority"), &BTPlayer::set_priority);
+	ClassDB::bind_method(D_METHOD("get_priority"), &BTPlayer::get_priority);
+	ClassDB::bind_method(D_METHOD("set_tick_budget_usec", "budget_usec"), &BTPlayer::set_tick_budget_usec);
+	ClassDB::bind_method(D_METHOD("get_tick_budget_usec"), &BTPlayer::get_tick_budget_usec);
+	ClassDB::bind_method(D_METHOD("set_time_scale", "scale"), &BTPlayer::set_time_scale);
+	ClassDB::bind_method(D_METHOD("get_time_scale"), &BTPlayer::get_time_scale);
+	ClassDB::bind_method(D_METHOD("set_seed", "seed"), &BTPlayer::set_seed);
+	ClassDB::bind_method(D_METHOD("get_seed"), &BTPlayer::get_seed);
 	ClassDB::bind_method(D_METHOD("set_active", "active"), &BTPlayer::set_active);
 	ClassDB::bind_method(D_METHOD("get_active"), &BTPlayer::get_active);
 	ClassDB::bind_method(D_METHOD("set_blackboard", "blackboard"), &BTPlayer::set_blackboard);
@@ -237,8 +515,29 @@ void BTPlayer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_monitor_performance", "enable"), &BTPlayer::set_monitor_performance);
 	ClassDB::bind_method(D_METHOD("get_monitor_performance"), &BTPlayer::get_monitor_performance);
 
+	ClassDB::bind_method(D_METHOD("set_async_instantiation", "enable"), &BTPlayer::set_async_instantiation);
+	ClassDB::bind_method(D_METHOD("get_async_instantiation"), &BTPlayer::get_async_instantiation);
+	ClassDB::bind_method(D_METHOD("is_instantiation_pending"), &BTPlayer::is_instantiation_pending);
+
+	ClassDB::bind_method(D_METHOD("set_lod_trees", "trees"), &BTPlayer::set_lod_trees);
+	ClassDB::bind_method(D_METHOD("get_lod_trees"), &BTPlayer::get_lod_trees);
+	ClassDB::bind_method(D_METHOD("set_lod_distances", "distances"), &BTPlayer::set_lod_distances);
+	ClassDB::bind_method(D_METHOD("get_lod_distances"), &BTPlayer::get_lod_distances);
+	ClassDB::bind_method(D_METHOD("set_lod_reference", "reference"), &BTPlayer::set_lod_reference);
+	ClassDB::bind_method(D_METHOD("get_lod_reference"), &BTPlayer::get_lod_reference);
+	ClassDB::bind_method(D_METHOD("set_lod_check_interval", "interval"), &BTPlayer::set_lod_check_interval);
+	ClassDB::bind_method(D_METHOD("get_lod_check_interval"), &BTPlayer::get_lod_check_interval);
+	ClassDB::bind_method(D_METHOD("set_lod_override", "lod"), &BTPlayer::set_lod_override);
+	ClassDB::bind_method(D_METHOD("get_lod_override"), &BTPlayer::get_lod_override);
+	ClassDB::bind_method(D_METHOD("set_lod_pool", "pool"), &BTPlayer::set_lod_pool);
+	ClassDB::bind_method(D_METHOD("get_lod_pool"), &BTPlayer::get_lod_pool);
+	ClassDB::bind_method(D_METHOD("get_current_lod"), &BTPlayer::get_current_lod);
+
 	ClassDB::bind_method(D_METHOD("update", "delta"), &BTPlayer::update);
 	ClassDB::bind_method(D_METHOD("restart"), &BTPlayer::restart);
+	ClassDB::bind_method(D_METHOD("sleep"), &BTPlayer::sleep);
+	ClassDB::bind_method(D_METHOD("wake"), &BTPlayer::wake);
+	ClassDB::bind_method(D_METHOD("is_sleeping"), &BTPlayer::is_sleeping);
 
 	ClassDB::bind_method(D_METHOD("get_bt_instance"), &BTPlayer::get_bt_instance);
 	ClassDB::bind_method(D_METHOD("set_bt_instance", "bt_instance"), &BTPlayer::set_bt_instance);
@@ -247,17 +546,37 @@ void BTPlayer::_bind_methods() {
 
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "behavior_tree", PROPERTY_HINT_RESOURCE_TYPE, "BehaviorTree"), "set_behavior_tree", "get_behavior_tree");
 	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "agent_node"), "set_agent_node", "get_agent_node");
-	ADD_PROPERTY(PropertyInfo(Variant::INT, "update_mode", PROPERTY_HINT_ENUM, "Idle,Physics,Manual"), "set_update_mode", "get_update_mode");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "update_mode", PROPERTY_HINT_ENUM, "Idle,Physics,Manual,Scheduled,Fixed"), "set_update_mode", "get_update_mode");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "fixed_timestep", PROPERTY_HINT_RANGE, "0.001,1.0,0.001,or_greater,suffix:s"), "set_fixed_timestep", "get_fixed_timestep");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "max_catch_up_steps", PROPERTY_HINT_RANGE, "1,16,1,or_greater"), "set_max_catch_up_steps", "get_max_catch_up_steps");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "update_interval", PROPERTY_HINT_RANGE, "0.0,10.0,0.001,or_greater,suffix:s"), "set_update_interval", "get_update_interval");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "reactive"), "set_reactive", "is_reactive");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "priority"), "set_priority", "get_priority");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "tick_budget_usec", PROPERTY_HINT_RANGE, "0,100000,1,or_greater,suffix:us"), "set_tick_budget_usec", "get_tick_budget_usec");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "time_scale", PROPERTY_HINT_RANGE, "0.0,4.0,0.01,or_greater"), "set_time_scale", "get_time_scale");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "seed"), "set_seed", "get_seed");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "active"), "set_active", "get_active");
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "blackboard", PROPERTY_HINT_NONE, "Blackboard", 0), "set_blackboard", "get_blackboard");
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "blackboard_plan", PROPERTY_HINT_RESOURCE_TYPE, "BlackboardPlan", PROPERTY_USAGE_DEFAULT | PROPERTY_USAGE_EDITOR_INSTANTIATE_OBJECT | PROPERTY_USAGE_ALWAYS_DUPLICATE), "set_blackboard_plan", "get_blackboard_plan");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "monitor_performance"), "set_monitor_performance", "get_monitor_performance");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "async_instantiation"), "set_async_instantiation", "get_async_instantiation");
+
+	ADD_GROUP("LOD", "lod_");
+	ADD_PROPERTY(PropertyInfo(Variant::ARRAY, "lod_trees", PROPERTY_HINT_ARRAY_TYPE, RESOURCE_TYPE_HINT("BehaviorTree")), "set_lod_trees", "get_lod_trees");
+	ADD_PROPERTY(PropertyInfo(Variant::PACKED_FLOAT32_ARRAY, "lod_distances"), "set_lod_distances", "get_lod_distances");
+	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "lod_reference"), "set_lod_reference", "get_lod_reference");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "lod_check_interval", PROPERTY_HINT_RANGE, "0.0,10.0,0.01,or_greater,suffix:s"), "set_lod_check_interval", "get_lod_check_interval");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "lod_override", PROPERTY_HINT_RANGE, "-1,8,1,or_greater"), "set_lod_override", "get_lod_override");
 
 	BIND_ENUM_CONSTANT(IDLE);
 	BIND_ENUM_CONSTANT(PHYSICS);
 	BIND_ENUM_CONSTANT(MANUAL);
+	BIND_ENUM_CONSTANT(SCHEDULED);
+	BIND_ENUM_CONSTANT(FIXED);
 
 	ADD_SIGNAL(MethodInfo("updated", PropertyInfo(Variant::INT, "status")));
+	ADD_SIGNAL(MethodInfo("instantiated"));
+	ADD_SIGNAL(MethodInfo("lod_changed", PropertyInfo(Variant::INT, "lod")));
 
 #ifndef DISABLE_DEPRECATED
 	ADD_SIGNAL(MethodInfo("behavior_tree_finished", PropertyInfo(Variant::INT, "status")));
@@ -270,4 +589,7 @@ BTPlayer::BTPlayer() {
 }
 
 BTPlayer::~BTPlayer() {
+	if (scheduled && BTScheduler::get_singleton()) {
+		BTScheduler::get_singleton()->unregister_player(this);
+	}
 }
@@ -16,24 +16,30 @@
 #include "../blackboard/blackboard_plan.h"
 #include "behavior_tree.h"
 #include "bt_instance.h"
+#include "bt_instance_pool.h"
 #include "tasks/bt_task.h"
 
 #ifdef LIMBOAI_MODULE
+#include "core/variant/typed_array.h"
 #include "scene/main/node.h"
 #endif
 
 #ifdef LIMBOAI_GDEXTENSION
 #include <godot_cpp/classes/node.hpp>
+#include <godot_cpp/variant/typed_array.hpp>
 #endif
 
 class BTPlayer : public Node {
 	GDCLASS(BTPlayer, Node);
+	friend class BTScheduler;
 
 public:
 	enum UpdateMode : unsigned int {
 		IDLE, // automatically call update() during NOTIFICATION_PROCESS
 		PHYSICS, // automatically call update() during NOTIFICATION_PHYSICS
 		MANUAL, // manually update state machine, user must call update(delta)
+		SCHEDULED, // updated in batch by BTScheduler during physics frame
+		FIXED, // updated in steps of fixed_timestep during NOTIFICATION_PROCESS, catching up with elapsed time
 	};
 
 private:
@@ -42,14 +48,50 @@ private:
 	Ref<BlackboardPlan> blackboard_plan;
 	UpdateMode update_mode = UpdateMode::PHYSICS;
 	bool active = true;
+	double update_interval = 0.0;
+	double fixed_timestep = 1.0 / 30.0;
+	int max_catch_up_steps = 4;
+	double fixed_accumulator = 0.0;
+	bool reactive = false;
+	int tick_budget_usec = 0;
+	int priority = 0;
+	double time_scale = 1.0;
+	int64_t seed = 0;
 	Ref<Blackboard> blackboard;
 	Node *scene_root_hint = nullptr;
 	bool monitor_performance = false;
+	bool scheduled = false;
+	bool sleeping = false;
+	bool async_instantiation = false;
+	// Incremented on each load, so that results of superseded asynchronous instantiations are discarded.
+	uint32_t load_id = 0;
+	bool instantiation_pending = false;
 
 	Ref<BTInstance> bt_instance;
 
+	// LOD 0 is the behavior_tree, LOD i is lod_trees[i - 1]: variants share the blackboard and swap through lod_pool.
+	TypedArray<BehaviorTree> lod_trees;
+	PackedFloat32Array lod_distances;
+	NodePath lod_reference;
+	double lod_check_interval = 0.5;
+	int lod_override = -1;
+	Ref<BTInstancePool> lod_pool;
+	int current_lod = 0;
+	double lod_elapsed = 0.0;
+
 	void _load_tree();
+	void _set_up_instance(const Ref<BTInstance> &p_instance);
+	void _on_async_instantiated(const Ref<BTInstance> &p_instance, uint32_t p_load_id);
 	void _update_blackboard_plan();
+	void _update_processing();
+	void _update_scheduling();
+	void _update_with_interval(double p_delta);
+	void _update_instance(double p_delta);
+	void _update_fixed(double p_delta);
+	void _emit_updated(BT::Status p_status);
+	void _advance_lod(double p_delta);
+	int _compute_lod() const;
+	void _swap_lod(int p_lod);
 	_FORCE_INLINE_ Node *_get_scene_root() const { return scene_root_hint ? scene_root_hint : get_owner(); }
 
 protected:
@@ -74,6 +116,30 @@ public:
 	void set_update_mode(UpdateMode p_mode);
 	UpdateMode get_update_mode() const { return update_mode; }
 
+	void set_update_interval(double p_interval);
+	double get_update_interval() const { return update_interval; }
+
+	void set_fixed_timestep(double p_timestep);
+	double get_fixed_timestep() const { return fixed_timestep; }
+
+	void set_max_catch_up_steps(int p_steps) { max_catch_up_steps = MAX(p_steps, 1); }
+	int get_max_catch_up_steps() const { return max_catch_up_steps; }
+
+	void set_reactive(bool p_reactive);
+	bool is_reactive() const { return reactive; }
+
+	void set_tick_budget_usec(int p_budget);
+	int get_tick_budget_usec() const { return tick_budget_usec; }
+
+	void set_priority(int p_priority);
+	int get_priority() const { return priority; }
+
+	void set_time_scale(double p_scale);
+	double get_time_scale() const { return time_scale; }
+
+	void set_seed(int64_t p_seed);
+	int64_t get_seed() const { return seed; }
+
 	void set_active(bool p_active);
 	bool get_active() const { return active; }
 
@@ -83,9 +149,37 @@ public:
 	void set_monitor_performance(bool p_monitor_performance);
 	bool get_monitor_performance() const { return monitor_performance; }
 
+	void set_async_instantiation(bool p_enable) { async_instantiation = p_enable; }
+	bool get_async_instantiation() const { return async_instantiation; }
+	bool is_instantiation_pending() const { return instantiation_pending; }
+
+	void set_lod_trees(const TypedArray<BehaviorTree> &p_trees);
+	TypedArray<BehaviorTree> get_lod_trees() const { return lod_trees; }
+
+	void set_lod_distances(const PackedFloat32Array &p_distances) { lod_distances = p_distances; }
+	PackedFloat32Array get_lod_distances() const { return lod_distances; }
+
+	void set_lod_reference(const NodePath &p_reference) { lod_reference = p_reference; }
+	NodePath get_lod_reference() const { return lod_reference; }
+
+	void set_lod_check_interval(double p_interval);
+	double get_lod_check_interval() const { return lod_check_interval; }
+
+	void set_lod_override(int p_lod);
+	int get_lod_override() const { return lod_override; }
+
+	void set_lod_pool(const Ref<BTInstancePool> &p_pool) { lod_pool = p_pool; }
+	Ref<BTInstancePool> get_lod_pool() const { return lod_pool; }
+
+	int get_current_lod() const { return current_lod; }
+
 	void update(double p_delta);
 	void restart();
 
+	void sleep();
+	void wake();
+	bool is_sleeping() const { return sleeping; }
+
 	Ref<BTInstance> get_bt_instance() { return bt_instance; }
 	void set_bt_instance(const Ref<BTInstance> &p_bt_instance);
 
@@ -0,0 +1,79 @@
+/**
+ * bt_profile.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "bt_profile.h"
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/core/class_db.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+void BTProfile::build(const Ref<BTTask> &p_root) {
+	ERR_FAIL_COND_MSG(!stats.is_empty(), "BTProfile: Already built.");
+	ERR_FAIL_COND(p_root.is_null());
+	_add_task(p_root, 0);
+	stats.resize(tasks.size());
+}
+
+void BTProfile::_add_task(const Ref<BTTask> &p_task, int p_depth) {
+	TaskInfo info;
+	info.name = p_task->get_task_name();
+	info.depth = p_depth;
+	tasks.push_back(info);
+	for (int i = 0; i < p_task->get_child_count(); i++) {
+		_add_task(p_task->get_child(i), p_depth + 1);
+	}
+}
+
+uint64_t BTProfile::get_tick_count(int p_index) const {
+	ERR_FAIL_INDEX_V(p_index, (int)stats.size(), 0);
+	return stats[p_index].tick_count.get();
+}
+
+uint64_t BTProfile::get_inclusive_time_usec(int p_index) const {
+	ERR_FAIL_INDEX_V(p_index, (int)stats.size(), 0);
+	return stats[p_index].inclusive_usec.get();
+}
+
+uint64_t BTProfile::get_self_time_usec(int p_index) const {
+	ERR_FAIL_INDEX_V(p_index, (int)stats.size(), 0);
+	return stats[p_index].self_usec.get();
+}
+
+Array BTProfile::get_report() const {
+	Array report;
+	for (uint32_t i = 0; i < tasks.size(); i++) {
+		Dictionary entry;
+		entry["name"] = tasks[i].name;
+		entry["depth"] = tasks[i].depth;
+		entry["tick_count"] = stats[i].tick_count.get();
+		entry["inclusive_usec"] = stats[i].inclusive_usec.get();
+		entry["self_usec"] = stats[i].self_usec.get();
+		report.push_back(entry);
+	}
+	return report;
+}
+
+void BTProfile::reset() {
+	for (BTTaskStats &s : stats) {
+		s.tick_count.set(0);
+		s.inclusive_usec.set(0);
+		s.self_usec.set(0);
+	}
+}
+
+void BTProfile::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("get_task_count"), &BTProfile::get_task_count);
+	ClassDB::bind_method(D_METHOD("get_tick_count", "task_index"), &BTProfile::get_tick_count);
+	ClassDB::bind_method(D_METHOD("get_inclusive_time_usec", "task_index"), &BTProfile::get_inclusive_time_usec);
+	ClassDB::bind_method(D_METHOD("get_self_time_usec", "task_index"), &BTProfile::get_self_time_usec);
+	ClassDB::bind_method(D_METHOD("get_report"), &BTProfile::get_report);
+	ClassDB::bind_method(D_METHOD("reset"), &BTProfile::reset);
+}
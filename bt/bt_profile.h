@@ -0,0 +1,69 @@
+/**
+ * bt_profile.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef BT_PROFILE_H
+#define BT_PROFILE_H
+
+#include "tasks/bt_task.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/object/ref_counted.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/templates/safe_refcount.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+// Counters shared by the same task in all instances of a BehaviorTree. Instances can be ticked on different threads.
+struct BTTaskStats {
+	SafeNumeric<uint64_t> tick_count;
+	SafeNumeric<uint64_t> inclusive_usec;
+	SafeNumeric<uint64_t> self_usec;
+};
+
+class BTProfile : public RefCounted {
+	GDCLASS(BTProfile, RefCounted);
+
+private:
+	struct TaskInfo {
+		String name;
+		int depth = 0;
+	};
+
+	LocalVector<TaskInfo> tasks;
+	// Sized once on build(), so that instances can hold pointers to it.
+	LocalVector<BTTaskStats> stats;
+
+	void _add_task(const Ref<BTTask> &p_task, int p_depth);
+
+protected:
+	static void _bind_methods();
+
+public:
+	// Lays out the counters in the depth-first order of the tasks in p_root.
+	void build(const Ref<BTTask> &p_root);
+	_FORCE_INLINE_ int get_task_count() const { return tasks.size(); }
+	_FORCE_INLINE_ BTTaskStats *get_task_stats(int p_index) { return &stats[p_index]; }
+	_FORCE_INLINE_ const String &get_task_name(int p_index) const { return tasks[p_index].name; }
+	_FORCE_INLINE_ int get_task_depth(int p_index) const { return tasks[p_index].depth; }
+
+	uint64_t get_tick_count(int p_index) const;
+	uint64_t get_inclusive_time_usec(int p_index) const;
+	uint64_t get_self_time_usec(int p_index) const;
+	Array get_report() const;
+	void reset();
+};
+
+#endif // BT_PROFILE_H
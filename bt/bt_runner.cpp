@@ -0,0 +1,108 @@
+/**
+ * bt_runner.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "bt_runner.h"
+
+#include "../util/limbo_profiling.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/error/error_macros.h"
+#include "core/object/class_db.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/core/class_db.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+Ref<BTInstance> BTRunner::add_tree(const Ref<BehaviorTree> &p_tree, const Ref<Blackboard> &p_blackboard) {
+	ERR_FAIL_COND_V_MSG(p_tree.is_null(), nullptr, "BTRunner: Can't add a tree - behavior tree is null.");
+	Ref<Blackboard> bb = p_blackboard;
+	if (bb.is_null()) {
+		Ref<BlackboardPlan> plan = p_tree->get_blackboard_plan();
+		bb = plan.is_valid() ? plan->create_blackboard(nullptr) : Ref<Blackboard>(memnew(Blackboard));
+	}
+	Ref<BTInstance> instance = p_tree->instantiate_headless(bb);
+	ERR_FAIL_COND_V_MSG(instance.is_null(), nullptr, "BTRunner: Failed to instantiate behavior tree.");
+	add_instance(instance);
+	return instance;
+}
+
+void BTRunner::add_instance(const Ref<BTInstance> &p_instance) {
+	ERR_FAIL_COND_MSG(p_instance.is_null() || !p_instance->is_instance_valid(), "BTRunner: Can't add an instance - instance is not valid.");
+	ERR_FAIL_COND_MSG(instance_indices.has(p_instance->get_instance_id()), "BTRunner: Instance is already added.");
+	ERR_FAIL_COND_MSG(updating, "BTRunner: Can't add instances during an update.");
+	instance_indices.insert(p_instance->get_instance_id(), instances.size());
+	instances.push_back(p_instance);
+}
+
+void BTRunner::_remove_at(uint32_t p_index) {
+	const Ref<BTInstance> instance = instances[p_index];
+	if (instance->get_root_task()->get_status() == BT::RUNNING) {
+		instance->get_root_task()->abort();
+	}
+	instance_indices.erase(instance->get_instance_id());
+
+	const uint32_t last = instances.size() - 1;
+	if (p_index != last) {
+		instances[p_index] = instances[last];
+		instance_indices[instances[p_index]->get_instance_id()] = p_index;
+	}
+	instances.resize(last);
+}
+
+void BTRunner::remove_instance(const Ref<BTInstance> &p_instance) {
+	ERR_FAIL_COND(p_instance.is_null());
+	ERR_FAIL_COND_MSG(updating, "BTRunner: Can't remove instances during an update.");
+	const uint32_t *index = instance_indices.getptr(p_instance->get_instance_id());
+	ERR_FAIL_NULL_MSG(index, "BTRunner: Instance is not added.");
+	_remove_at(*index);
+}
+
+void BTRunner::clear() {
+	ERR_FAIL_COND_MSG(updating, "BTRunner: Can't clear instances during an update.");
+	while (!instances.is_empty()) {
+		_remove_at(instances.size() - 1);
+	}
+}
+
+bool BTRunner::has_instance(const Ref<BTInstance> &p_instance) const {
+	return p_instance.is_valid() && instance_indices.has(p_instance->get_instance_id());
+}
+
+Ref<BTInstance> BTRunner::get_instance(int p_index) const {
+	ERR_FAIL_INDEX_V(p_index, (int)instances.size(), Ref<BTInstance>());
+	return instances[p_index];
+}
+
+void BTRunner::update(double p_delta) {
+	LIMBO_PROFILE_ZONE("BTRunner::update");
+	updating = true;
+	for (const Ref<BTInstance> &instance : instances) {
+		instance->update(p_delta);
+	}
+	updating = false;
+}
+
+void BTRunner::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("add_tree", "behavior_tree", "blackboard"), &BTRunner::add_tree, DEFVAL(Variant()));
+	ClassDB::bind_method(D_METHOD("add_instance", "instance"), &BTRunner::add_instance);
+	ClassDB::bind_method(D_METHOD("remove_instance", "instance"), &BTRunner::remove_instance);
+	ClassDB::bind_method(D_METHOD("clear"), &BTRunner::clear);
+	ClassDB::bind_method(D_METHOD("has_instance", "instance"), &BTRunner::has_instance);
+	ClassDB::bind_method(D_METHOD("get_instance_count"), &BTRunner::get_instance_count);
+	ClassDB::bind_method(D_METHOD("get_instance", "index"), &BTRunner::get_instance);
+	ClassDB::bind_method(D_METHOD("update", "delta"), &BTRunner::update);
+}
+
+BTRunner::~BTRunner() {
+	// * Running tasks are aborted, so they can clean up.
+	clear();
+}
@@ -0,0 +1,62 @@
+/**
+ * bt_runner.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef BT_RUNNER_H
+#define BT_RUNNER_H
+
+#include "../blackboard/blackboard.h"
+#include "behavior_tree.h"
+#include "bt_instance.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/object/ref_counted.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+using namespace godot;
+#endif // LIMBOAI_GDEXTENSION
+
+// Updates behavior tree instances without nodes, e.g. headless instances of a server simulation whose agents are
+// plain data in the blackboard (see BehaviorTree::instantiate_headless()). Updated only by calling update().
+class BTRunner : public RefCounted {
+	GDCLASS(BTRunner, RefCounted);
+
+private:
+	// Instances are swapped with the last one on removal, so the list stays dense.
+	LocalVector<Ref<BTInstance>> instances;
+	HashMap<uint64_t, uint32_t> instance_indices;
+	bool updating = false;
+
+	void _remove_at(uint32_t p_index);
+
+protected:
+	static void _bind_methods();
+
+public:
+	Ref<BTInstance> add_tree(const Ref<BehaviorTree> &p_tree, const Ref<Blackboard> &p_blackboard = Ref<Blackboard>());
+	void add_instance(const Ref<BTInstance> &p_instance);
+	void remove_instance(const Ref<BTInstance> &p_instance);
+	void clear();
+	bool has_instance(const Ref<BTInstance> &p_instance) const;
+	int get_instance_count() const { return instances.size(); }
+	Ref<BTInstance> get_instance(int p_index) const;
+
+	void update(double p_delta);
+
+	~BTRunner();
+};
+
+#endif // BT_RUNNER_H
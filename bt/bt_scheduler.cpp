@@ -0,0 +1,559 @@
+/**
+ * bt_scheduler.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "bt_scheduler.h"
+
+#include "../hsm/limbo_hsm.h"
+#include "../util/limbo_compat.h"
+#include "../util/limbo_string_names.h"
+#include "bt_instance.h"
+#include "bt_player.h"
+#include "tasks/composites/bt_utility_selector.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/object/class_db.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/templates/hashfuncs.h"
+#include "core/os/os.h"
+#include "core/os/time.h"
+#include "scene/main/scene_tree.h"
+#include "scene/main/window.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/os.hpp>
+#include <godot_cpp/classes/scene_tree.hpp>
+#include <godot_cpp/classes/time.hpp>
+#include <godot_cpp/classes/window.hpp>
+#include <godot_cpp/classes/worker_thread_pool.hpp>
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/templates/hashfuncs.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+BTScheduler *BTScheduler::singleton = nullptr;
+thread_local LocalVector<BTScheduler::DeferredCall> *BTScheduler::deferred_calls = nullptr;
+
+int BTScheduler::_find_entry(BTPlayer *p_player) const {
+	const uint32_t *idx = entry_index.getptr(p_player->get_instance_id());
+	return idx ? int(*idx) : -1;
+}
+
+void BTScheduler::_reindex() {
+	for (uint32_t i = 0; i < entries.size(); i++) {
+		if (entries[i].player != nullptr) {
+			entry_index[entries[i].player->get_instance_id()] = i;
+		}
+	}
+}
+
+void BTScheduler::_update_entry(Entry &p_entry) const {
+	BTPlayer *player = p_entry.player;
+	p_entry.tree_id = player->get_behavior_tree().is_valid() ? uint64_t(player->get_behavior_tree()->get_instance_id()) : 0;
+	p_entry.thread_safe = player->bt_instance.is_valid() && player->bt_instance->is_thread_safe();
+	p_entry.pure = player->bt_instance.is_valid() && player->bt_instance->is_pure();
+}
+
+void BTScheduler::_compact() {
+	uint32_t j = 0;
+	for (uint32_t i = 0; i < entries.size(); i++) {
+		if (entries[i].player != nullptr) {
+			entries[j++] = entries[i];
+		}
+	}
+	entries.resize(j);
+	start_index = 0;
+	_reindex();
+
+	j = 0;
+	for (uint32_t i = 0; i < hsms.size(); i++) {
+		if (hsms[i] != nullptr) {
+			hsms[j++] = hsms[i];
+		}
+	}
+	hsms.resize(j);
+	hsm_start_index = 0;
+	compact_needed = false;
+}
+
+void BTScheduler::_connect_to_scene_tree() {
+	if (connected) {
+		return;
+	}
+	SceneTree *tree = SCENE_TREE();
+	ERR_FAIL_NULL_MSG(tree, "BTScheduler: SceneTree is not available.");
+	tree->connect(LW_NAME(physics_frame), callable_mp(this, &BTScheduler::_on_physics_frame));
+	connected = true;
+}
+
+void BTScheduler::_on_physics_frame() {
+	if (entries.is_empty() && hsms.is_empty()) {
+		return;
+	}
+	update(SCENE_TREE()->get_root()->get_physics_process_delta_time());
+}
+
+void BTScheduler::register_player(BTPlayer *p_player) {
+	ERR_FAIL_NULL(p_player);
+	if (_find_entry(p_player) != -1) {
+		return;
+	}
+	Entry entry;
+	entry.player = p_player;
+	_update_entry(entry);
+	entry_index.insert(p_player->get_instance_id(), entries.size());
+	entries.push_back(entry);
+	player_count += 1;
+	sort_needed = true;
+	_connect_to_scene_tree();
+}
+
+void BTScheduler::unregister_player(BTPlayer *p_player) {
+	int idx = _find_entry(p_player);
+	if (idx == -1) {
+		return;
+	}
+	// * Constant time, so that whole groups of players can be put to sleep at once: the list is compacted before the next update.
+	entries[idx].player = nullptr;
+	entry_index.erase(p_player->get_instance_id());
+	player_count -= 1;
+	compact_needed = true;
+}
+
+void BTScheduler::notify_tree_changed(BTPlayer *p_player) {
+	int idx = _find_entry(p_player);
+	if (idx != -1) {
+		_update_entry(entries[idx]);
+		sort_needed = true;
+	}
+}
+
+int BTScheduler::get_player_count() const {
+	return player_count;
+}
+
+int BTScheduler::_set_group_sleeping(const StringName &p_group, bool p_sleeping) {
+	SceneTree *tree = SCENE_TREE();
+	ERR_FAIL_NULL_V(tree, 0);
+	int count = 0;
+#ifdef LIMBOAI_MODULE
+	List<Node *> members;
+	tree->get_nodes_in_group(p_group, &members);
+	for (Node *member : members) {
+#elif LIMBOAI_GDEXTENSION
+	TypedArray<Node> members = tree->get_nodes_in_group(p_group);
+	for (int i = 0; i < members.size(); i++) {
+		Node *member = Object::cast_to<Node>(members[i]);
+#endif
+		BTPlayer *player = Object::cast_to<BTPlayer>(member);
+		if (player == nullptr || player->is_sleeping() == p_sleeping) {
+			continue;
+		}
+		if (p_sleeping) {
+			player->sleep();
+		} else {
+			player->wake();
+		}
+		count++;
+	}
+	return count;
+}
+
+void BTScheduler::register_hsm(LimboHSM *p_hsm) {
+	ERR_FAIL_NULL(p_hsm);
+	if (hsms.has(p_hsm)) {
+		return;
+	}
+	hsms.push_back(p_hsm);
+	_connect_to_scene_tree();
+}
+
+void BTScheduler::unregister_hsm(LimboHSM *p_hsm) {
+	int64_t idx = hsms.find(p_hsm);
+	if (idx == -1) {
+		return;
+	}
+	if (updating) {
+		hsms[idx] = nullptr;
+		compact_needed = true;
+	} else {
+		hsms.remove_at(idx);
+		hsm_start_index = 0;
+	}
+}
+
+void BTScheduler::_update_player(const Entry &p_entry, double p_delta) {
+	BTPlayer *player = p_entry.player;
+	BTInstance *inst = player->bt_instance.ptr();
+	// * LOD variants come from other trees - entry.tree_id no longer matches them.
+	if (!p_entry.pure || !player->behavior_tree->get_share_identical_updates() || !player->active || player->sleeping ||
+			player->instantiation_pending || inst->source_bt_id != p_entry.tree_id || !inst->_can_share_update()) {
+		BTInstance::scheduled_update_pending = true;
+		player->update(p_delta);
+		BTInstance::scheduled_update_pending = false; // * In case the player didn't update the instance.
+		return;
+	}
+
+	LimboSnapshotWriter writer;
+	writer.put_double(p_delta);
+	inst->_write_shared_state(writer);
+	const PackedByteArray state = writer.to_bytes();
+	const uint32_t hash = hash_murmur3_buffer(state.ptr(), state.size());
+	const uint32_t *idx = shared_update_index.getptr(hash);
+	if (idx) {
+		const PackedByteArray &before = shared_updates[*idx].state_before;
+		if (before.size() == state.size() && memcmp(before.ptr(), state.ptr(), state.size()) == 0) {
+			inst->_share_update(p_delta, shared_updates[*idx].state_after, shared_updates[*idx].tasks);
+			inst->_emit_updated();
+			player->_emit_updated(inst->get_last_status());
+			shared_count++;
+			return;
+		}
+	}
+
+	// The first player in this state is the representative. Its result is captured before the signals, whose handlers may change the blackboard.
+	BTInstance::scheduled_update_pending = true;
+	inst->_update(p_delta);
+	if (idx == nullptr) {
+		SharedUpdate shared;
+		shared.state_before = state;
+		LimboSnapshotWriter after;
+		after.put_double(p_delta);
+		inst->_write_shared_state(after);
+		shared.state_after = after.to_bytes();
+		shared.tasks = inst->last_update_tasks;
+		shared_update_index.insert(hash, shared_updates.size());
+		shared_updates.push_back(shared);
+	}
+	inst->_emit_updated();
+	player->_emit_updated(inst->get_last_status());
+}
+
+void BTScheduler::update(double p_delta) {
+	ERR_FAIL_COND_MSG(updating, "BTScheduler: Recursive update is not allowed.");
+
+	if (compact_needed) {
+		_compact();
+	}
+	if (sort_needed) {
+		// Grouping players by tree improves instruction cache locality.
+		entries.sort_custom<EntryComparator>();
+		sort_needed = false;
+		start_index = 0;
+		_reindex();
+	}
+
+	updating = true;
+	BTUtilitySelector::prepare_batches();
+	const uint64_t start_usec = frame_budget_usec > 0 ? Time::get_singleton()->get_ticks_usec() : 0;
+	// * Lets expensive tasks yield once the frame budget is spent (see BTTask::get_remaining_budget_usec()).
+	const uint64_t outer_deadline = BTInstance::budget_deadline_usec;
+	if (frame_budget_usec > 0) {
+		BTInstance::budget_deadline_usec = start_usec + frame_budget_usec;
+	}
+	bool over_budget = false;
+	int64_t first_deferred = -1;
+	deferred_count = 0;
+	shared_count = 0;
+
+	// * State machines go first: their BTState leaves update behavior trees too, so they share the same budget.
+	int64_t first_deferred_hsm = -1;
+	const uint32_t hsm_count = hsms.size();
+	for (uint32_t n = 0; n < hsm_count; n++) {
+		const uint32_t i = (hsm_start_index + n) % hsm_count;
+		LimboHSM *hsm = hsms[i];
+		if (hsm == nullptr || !hsm->_advance(p_delta)) {
+			continue;
+		}
+		if (over_budget && hsm->get_update_interval() > 0.0) {
+			if (first_deferred_hsm == -1) {
+				first_deferred_hsm = i;
+			}
+			deferred_count++;
+			continue;
+		}
+		hsm->update(hsm->_consume_pending_delta());
+		if (frame_budget_usec > 0 && !over_budget) {
+			over_budget = Time::get_singleton()->get_ticks_usec() - start_usec > (uint64_t)frame_budget_usec;
+		}
+	}
+	hsm_start_index = first_deferred_hsm == -1 ? 0 : uint32_t(first_deferred_hsm);
+
+	// Players registered during this update will be ticked during the next one.
+	const uint32_t count = entries.size();
+	background.clear();
+	for (uint32_t n = 0; n < count; n++) {
+		// Start from the first player deferred during the previous update, so that none of them starve.
+		const uint32_t i = (start_index + n) % count;
+		BTPlayer *player = entries[i].player;
+		if (player == nullptr) {
+			continue;
+		}
+		BTInstance *inst = player->bt_instance.ptr();
+		if (inst == nullptr) {
+			player->update(p_delta);
+			continue;
+		}
+		player->_advance_lod(p_delta);
+		inst = player->bt_instance.ptr();
+		if (!inst->advance(p_delta)) {
+			continue;
+		}
+		if (inst->get_update_interval() > 0.0 || inst->get_priority() < min_guaranteed_priority) {
+			// Rate-limited and low-priority players can tolerate a late update - they fill the budget left by the others.
+			background.push_back(i);
+			continue;
+		}
+		if (!_try_add_job(i, inst)) {
+			_update_player(entries[i], inst->consume_pending_delta());
+		}
+	}
+
+	if (frame_budget_usec > 0 && !over_budget) {
+		over_budget = Time::get_singleton()->get_ticks_usec() - start_usec > (uint64_t)frame_budget_usec;
+	}
+	for (uint32_t i : background) {
+		Entry &entry = entries[i];
+		BTInstance *inst = entry.player ? entry.player->bt_instance.ptr() : nullptr;
+		if (inst == nullptr) {
+			// Unregistered or reset by a signal handler of another player.
+			continue;
+		}
+		if (over_budget && (max_skipped_updates == 0 || entry.skipped < uint32_t(max_skipped_updates))) {
+			// Their delta keeps accumulating until the next update.
+			if (first_deferred == -1) {
+				first_deferred = i;
+			}
+			entry.skipped += 1;
+			deferred_count++;
+			continue;
+		}
+		entry.skipped = 0;
+		if (_try_add_job(i, inst)) {
+			continue;
+		}
+		_update_player(entry, inst->consume_pending_delta());
+		if (frame_budget_usec > 0 && !over_budget) {
+			over_budget = Time::get_singleton()->get_ticks_usec() - start_usec > (uint64_t)frame_budget_usec;
+		}
+	}
+	start_index = first_deferred == -1 ? 0 : uint32_t(first_deferred);
+
+	BTInstance::budget_deadline_usec = outer_deadline;
+	shared_updates.clear();
+	shared_update_index.clear();
+
+	if (!jobs.is_empty()) {
+		// * Worker threads yield by the same deadline as the main thread.
+		job_deadline_usec = frame_budget_usec > 0 ? start_usec + frame_budget_usec : 0;
+		_run_jobs();
+	}
+	job_scopes.clear();
+	// * Scores prepared for this update must not be used by trees ticked after it.
+	BTUtilitySelector::finish_batches();
+	updating = false;
+}
+
+// Queues the update of a thread-safe player for a worker thread. Returns false if it must be updated on the main thread.
+bool BTScheduler::_try_add_job(uint32_t p_entry_idx, BTInstance *p_instance) {
+	const Entry &entry = entries[p_entry_idx];
+	// * Shared updates are cheaper than ticking on another thread.
+	// * Listeners may be added after the entry was classified, and a blackboard may be shared by mistake.
+	if (!use_threads || !entry.thread_safe || (entry.pure && entry.player->behavior_tree->get_share_identical_updates()) ||
+			!_can_run_job(p_instance)) {
+		return false;
+	}
+	if (entry.player->active) {
+		Job job;
+		job.entry_idx = p_entry_idx;
+		job.instance = Ref<BTInstance>(p_instance);
+		job.delta = p_instance->consume_pending_delta();
+		// * Instances that haven't been ticked yet count as a single task until their average settles.
+		job.cost = MAX(p_instance->get_task_count_average(), 1.0);
+		jobs.push_back(job);
+	}
+	return true;
+}
+
+void BTScheduler::_process_batch(uint32_t p_batch) {
+	const Batch &batch = batches[p_batch];
+	deferred_calls = &batch_calls[batch.index];
+	const uint64_t outer_deadline = BTInstance::budget_deadline_usec;
+	BTInstance::budget_deadline_usec = job_deadline_usec;
+	for (uint32_t i = batch.begin; i < batch.end; i++) {
+		BTInstance::scheduled_update_pending = true;
+		jobs[i].instance->_update(jobs[i].delta);
+	}
+	BTInstance::budget_deadline_usec = outer_deadline;
+	deferred_calls = nullptr;
+}
+
+// Splits jobs into batches of similar cost, so that a few expensive trees don't keep one thread busy while the others idle.
+// Jobs stay in scheduler order within batches to keep trees of the same type together.
+void BTScheduler::_build_batches() {
+	double total_cost = 0.0;
+	for (const Job &job : jobs) {
+		total_cost += job.cost;
+	}
+	// * Several batches per thread: worker threads pick the next batch as soon as they finish one, which evens out estimation errors.
+	const int num_threads = MAX(OS::get_singleton()->get_processor_count(), 1);
+	const double target_cost = total_cost / double(num_threads * BATCHES_PER_THREAD);
+
+	batches.clear();
+	Batch batch;
+	for (uint32_t i = 0; i < jobs.size(); i++) {
+		batch.cost += jobs[i].cost;
+		if (batch.cost >= target_cost || i + 1 - batch.begin >= uint32_t(batch_size) || i + 1 == jobs.size()) {
+			batch.end = i + 1;
+			batches.push_back(batch);
+			batch.index += 1;
+			batch.begin = batch.end;
+			batch.cost = 0.0;
+		}
+	}
+	// * Most expensive batches are handed out first, so that the cheap ones fill the gaps at the end.
+	batches.sort_custom<BatchCostComparator>();
+}
+
+// False if the player was unregistered or its instance was replaced after the job was queued, e.g., by a signal handler of a player updated on the main thread.
+bool BTScheduler::_is_job_valid(const Job &p_job) const {
+	const BTPlayer *player = entries[p_job.entry_idx].player;
+	return player != nullptr && player->bt_instance == p_job.instance;
+}
+
+void BTScheduler::_run_jobs() {
+	uint32_t num_valid = 0;
+	for (uint32_t i = 0; i < jobs.size(); i++) {
+		if (_is_job_valid(jobs[i])) {
+			jobs[num_valid++] = jobs[i];
+		}
+	}
+	jobs.resize(num_valid);
+	if (jobs.is_empty()) {
+		return;
+	}
+
+	_build_batches();
+	const uint32_t num_batches = batches.size();
+	if (batch_calls.size() < num_batches) {
+		batch_calls.resize(num_batches);
+	}
+
+#ifdef LIMBOAI_MODULE
+	WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_native_group_task(&BTScheduler::_process_batch_native, this, num_batches, -1, true, "BTScheduler");
+#elif LIMBOAI_GDEXTENSION
+	int64_t group = WorkerThreadPool::get_singleton()->add_group_task(callable_mp(this, &BTScheduler::_process_batch), num_batches, -1, true, "BTScheduler");
+#endif
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+
+	// Apply side effects in batch order, so that the result doesn't depend on thread timing.
+	for (uint32_t b = 0; b < num_batches; b++) {
+		_apply_deferred_calls(batch_calls[b]);
+	}
+
+	for (const Job &job : jobs) {
+		if (!_is_job_valid(job)) {
+			// Unregistered or reset by a signal handler of another player, or by a deferred call.
+			continue;
+		}
+		BTPlayer *player = entries[job.entry_idx].player;
+		job.instance->_emit_updated();
+		player->_emit_updated(job.instance->get_last_status());
+	}
+	jobs.clear();
+}
+
+bool BTScheduler::_can_run_job(const BTInstance *p_instance) {
+	const Ref<Blackboard> bb = p_instance->get_blackboard();
+	if (bb.is_null()) {
+		return true;
+	}
+	// * Checked for each job: listeners and bindings can be added at any time.
+	if (bb->has_var_listeners() || bb->has_bound_vars() || job_scopes.has(bb.ptr())) {
+		return false;
+	}
+	job_scopes.insert(bb.ptr());
+	return true;
+}
+
+void BTScheduler::_apply_deferred_calls(LocalVector<DeferredCall> &p_calls) {
+	for (const DeferredCall &call : p_calls) {
+		if (call.method == StringName()) {
+			call.result_blackboard->set_var(call.result_var, call.value);
+			continue;
+		}
+		Object *obj = OBJECT_DB_GET_INSTANCE(call.object);
+		if (obj == nullptr) {
+			continue;
+		}
+		Variant result = obj->callv(call.method, call.args);
+		if (call.result_blackboard.is_valid()) {
+			call.result_blackboard->set_var(call.result_var, result);
+		}
+	}
+	p_calls.clear();
+}
+
+void BTScheduler::defer_call(Object *p_object, const StringName &p_method, const Array &p_args, const Ref<Blackboard> &p_result_blackboard, const StringName &p_result_var) {
+	ERR_FAIL_NULL(deferred_calls);
+	ERR_FAIL_NULL(p_object);
+	DeferredCall call;
+	call.object = p_object->get_instance_id();
+	call.method = p_method;
+	call.args = p_args;
+	call.result_blackboard = p_result_blackboard;
+	call.result_var = p_result_var;
+	deferred_calls->push_back(call);
+}
+
+void BTScheduler::defer_set_var(const Ref<Blackboard> &p_blackboard, const StringName &p_name, const Variant &p_value) {
+	ERR_FAIL_NULL(deferred_calls);
+	ERR_FAIL_COND(p_blackboard.is_null());
+	DeferredCall call;
+	call.result_blackboard = p_blackboard;
+	call.result_var = p_name;
+	call.value = p_value;
+	deferred_calls->push_back(call);
+}
+
+void BTScheduler::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("get_player_count"), &BTScheduler::get_player_count);
+	ClassDB::bind_method(D_METHOD("sleep_group", "group"), &BTScheduler::sleep_group);
+	ClassDB::bind_method(D_METHOD("wake_group", "group"), &BTScheduler::wake_group);
+	ClassDB::bind_method(D_METHOD("get_hsm_count"), &BTScheduler::get_hsm_count);
+	ClassDB::bind_method(D_METHOD("get_deferred_count"), &BTScheduler::get_deferred_count);
+	ClassDB::bind_method(D_METHOD("get_shared_count"), &BTScheduler::get_shared_count);
+	ClassDB::bind_method(D_METHOD("set_frame_budget_usec", "budget_usec"), &BTScheduler::set_frame_budget_usec);
+	ClassDB::bind_method(D_METHOD("get_frame_budget_usec"), &BTScheduler::get_frame_budget_usec);
+	ClassDB::bind_method(D_METHOD("set_min_guaranteed_priority", "priority"), &BTScheduler::set_min_guaranteed_priority);
+	ClassDB::bind_method(D_METHOD("get_min_guaranteed_priority"), &BTScheduler::get_min_guaranteed_priority);
+	ClassDB::bind_method(D_METHOD("set_max_skipped_updates", "count"), &BTScheduler::set_max_skipped_updates);
+	ClassDB::bind_method(D_METHOD("get_max_skipped_updates"), &BTScheduler::get_max_skipped_updates);
+	ClassDB::bind_method(D_METHOD("set_use_threads", "enable"), &BTScheduler::set_use_threads);
+	ClassDB::bind_method(D_METHOD("get_use_threads"), &BTScheduler::get_use_threads);
+	ClassDB::bind_method(D_METHOD("set_batch_size", "size"), &BTScheduler::set_batch_size);
+	ClassDB::bind_method(D_METHOD("get_batch_size"), &BTScheduler::get_batch_size);
+	ClassDB::bind_method(D_METHOD("update", "delta"), &BTScheduler::update);
+
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "frame_budget_usec", PROPERTY_HINT_RANGE, "0,100000,1,or_greater,suffix:us"), "set_frame_budget_usec", "get_frame_budget_usec");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "min_guaranteed_priority"), "set_min_guaranteed_priority", "get_min_guaranteed_priority");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "max_skipped_updates", PROPERTY_HINT_RANGE, "0,100,1,or_greater"), "set_max_skipped_updates", "get_max_skipped_updates");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_threads"), "set_use_threads", "get_use_threads");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "batch_size", PROPERTY_HINT_RANGE, "1,1024,1,or_greater"), "set_batch_size", "get_batch_size");
+}
+
+BTScheduler::BTScheduler() {
+	singleton = this;
+}
+
+BTScheduler::~BTScheduler() {
+	singleton = nullptr;
+}
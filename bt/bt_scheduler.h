@@ -0,0 +1,193 @@
+/**
+ * bt_scheduler.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef BT_SCHEDULER_H
+#define BT_SCHEDULER_H
+
+#include "../blackboard/blackboard.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/object/object.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/hash_set.h"
+#include "core/templates/local_vector.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/object.hpp>
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/hash_set.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+using namespace godot;
+#endif // LIMBOAI_GDEXTENSION
+
+class BTInstance;
+class BTPlayer;
+class LimboHSM;
+
+// Ticks all BTPlayers and root LimboHSMs in SCHEDULED update mode in one loop, instead of dispatching a notification to each of them.
+class BTScheduler : public Object {
+	GDCLASS(BTScheduler, Object);
+	friend class BTTask;
+
+public:
+	// Scene-mutating call recorded on a worker thread, applied later on the main thread.
+	struct DeferredCall {
+		ObjectID object;
+		StringName method;
+		Array args;
+		Ref<Blackboard> result_blackboard;
+		StringName result_var;
+		Variant value; // Stored in result_var instead of a call result if the method is empty.
+	};
+
+private:
+	struct Entry {
+		BTPlayer *player = nullptr;
+		uint64_t tree_id = 0;
+		bool thread_safe = false;
+		bool pure = false;
+		uint32_t skipped = 0; // Consecutive updates deferred due to the frame budget.
+	};
+
+	struct Job {
+		uint32_t entry_idx = 0;
+		Ref<BTInstance> instance; // Kept alive in case the player drops it before the jobs run.
+		double delta = 0.0;
+		double cost = 1.0; // Estimated from the work counters of the instance.
+	};
+
+	// Consecutive range of jobs ticked by a single worker thread task.
+	struct Batch {
+		uint32_t index = 0; // Position in job order - deferred calls are applied in this order.
+		uint32_t begin = 0;
+		uint32_t end = 0;
+		double cost = 0.0;
+	};
+
+	struct BatchCostComparator {
+		_FORCE_INLINE_ bool operator()(const Batch &p_a, const Batch &p_b) const { return p_a.cost > p_b.cost; }
+	};
+
+	// Result of an update that players in the same state take over instead of ticking (see BehaviorTree::share_identical_updates).
+	struct SharedUpdate {
+		PackedByteArray state_before;
+		PackedByteArray state_after;
+		uint32_t tasks = 0; // Executed by the update.
+	};
+
+	struct EntryComparator {
+		_FORCE_INLINE_ bool operator()(const Entry &p_a, const Entry &p_b) const { return p_a.tree_id < p_b.tree_id; }
+	};
+
+	static BTScheduler *singleton;
+	static thread_local LocalVector<DeferredCall> *deferred_calls;
+
+	LocalVector<Entry> entries;
+	HashMap<ObjectID, uint32_t> entry_index; // Player -> index in entries.
+	uint32_t player_count = 0; // Entries of unregistered players are cleared lazily.
+	uint32_t start_index = 0;
+	LocalVector<LimboHSM *> hsms;
+	uint32_t hsm_start_index = 0;
+	int frame_budget_usec = 0;
+	int deferred_count = 0;
+	int min_guaranteed_priority = 0;
+	int max_skipped_updates = 0;
+	LocalVector<uint32_t> background; // Entries due for an update that can be deferred, in round-robin order.
+	bool use_threads = false;
+	int batch_size = 64;
+	LocalVector<Job> jobs;
+	HashSet<const Blackboard *> job_scopes; // Blackboards of this update's jobs - each one is ticked by a single thread.
+	uint64_t job_deadline_usec = 0; // Frame budget deadline for the tasks ticked on worker threads, 0 if unlimited.
+	LocalVector<Batch> batches;
+	LocalVector<LocalVector<DeferredCall>> batch_calls;
+	LocalVector<SharedUpdate> shared_updates;
+	HashMap<uint32_t, uint32_t> shared_update_index; // Hash of state_before -> index in shared_updates.
+	int shared_count = 0;
+	bool sort_needed = false;
+	bool compact_needed = false;
+	bool updating = false;
+	bool connected = false;
+
+	int _find_entry(BTPlayer *p_player) const;
+	void _update_entry(Entry &p_entry) const;
+	void _compact();
+	void _reindex();
+	void _connect_to_scene_tree();
+	void _on_physics_frame();
+	int _set_group_sleeping(const StringName &p_group, bool p_sleeping);
+	void _update_player(const Entry &p_entry, double p_delta);
+
+	void _process_batch(uint32_t p_batch);
+	void _build_batches();
+	void _run_jobs();
+	bool _is_job_valid(const Job &p_job) const;
+	bool _can_run_job(const BTInstance *p_instance);
+	bool _try_add_job(uint32_t p_entry_idx, BTInstance *p_instance);
+	static void _apply_deferred_calls(LocalVector<DeferredCall> &p_calls);
+#ifdef LIMBOAI_MODULE
+	static void _process_batch_native(void *p_userdata, uint32_t p_batch) { static_cast<BTScheduler *>(p_userdata)->_process_batch(p_batch); }
+#endif
+
+protected:
+	static void _bind_methods();
+
+public:
+	static constexpr int BATCHES_PER_THREAD = 4;
+
+	_FORCE_INLINE_ static BTScheduler *get_singleton() { return singleton; }
+
+	void register_player(BTPlayer *p_player);
+	void unregister_player(BTPlayer *p_player);
+	void notify_tree_changed(BTPlayer *p_player);
+
+	int get_player_count() const;
+
+	// Puts to sleep or wakes up all BTPlayers in the group, e.g., the agents of a streamed out world cell.
+	// Returns the number of players affected.
+	int sleep_group(const StringName &p_group) { return _set_group_sleeping(p_group, true); }
+	int wake_group(const StringName &p_group) { return _set_group_sleeping(p_group, false); }
+
+	void register_hsm(LimboHSM *p_hsm);
+	void unregister_hsm(LimboHSM *p_hsm);
+	int get_hsm_count() const { return hsms.size(); }
+
+	void set_frame_budget_usec(int p_budget) { frame_budget_usec = MAX(p_budget, 0); }
+	int get_frame_budget_usec() const { return frame_budget_usec; }
+
+	int get_deferred_count() const { return deferred_count; }
+	int get_shared_count() const { return shared_count; }
+
+	void set_min_guaranteed_priority(int p_priority) { min_guaranteed_priority = p_priority; }
+	int get_min_guaranteed_priority() const { return min_guaranteed_priority; }
+
+	void set_max_skipped_updates(int p_count) { max_skipped_updates = MAX(p_count, 0); }
+	int get_max_skipped_updates() const { return max_skipped_updates; }
+
+	void set_use_threads(bool p_enable) { use_threads = p_enable; }
+	bool get_use_threads() const { return use_threads; }
+
+	void set_batch_size(int p_size) { batch_size = MAX(p_size, 1); }
+	int get_batch_size() const { return batch_size; }
+
+	// True while ticking a batch on a worker thread - scene-mutating tasks must use defer_call() instead.
+	static _FORCE_INLINE_ bool is_deferring_calls() { return deferred_calls != nullptr; }
+	static void defer_call(Object *p_object, const StringName &p_method, const Array &p_args, const Ref<Blackboard> &p_result_blackboard = Ref<Blackboard>(), const StringName &p_result_var = StringName());
+	// Inserting a variable changes the blackboard structure, which worker threads must not do - the write is applied on the main thread instead.
+	static void defer_set_var(const Ref<Blackboard> &p_blackboard, const StringName &p_name, const Variant &p_value);
+
+	void update(double p_delta);
+
+	BTScheduler();
+	~BTScheduler();
+};
+
+#endif // BT_SCHEDULER_H
@@ -11,8 +11,10 @@
 
 #include "bt_state.h"
 
+#include "../hsm/limbo_hsm.h"
 #include "../util/limbo_compat.h"
 #include "../util/limbo_string_names.h"
+#include "../util/limbo_timer_wheel.h"
 
 #ifdef LIMBOAI_MODULE
 #include "core/debugger/engine_debugger.h"
@@ -37,6 +39,16 @@ void BTState::set_behavior_tree(const Ref<BehaviorTree> &p_tree) {
 	_update_blackboard_plan();
 }
 
+void BTState::set_success_event(const StringName &p_success_event) {
+	success_event = p_success_event;
+	success_event_id = success_event == StringName() ? LimboEventRegistry::INVALID_EVENT : LimboEventRegistry::intern(success_event);
+}
+
+void BTState::set_failure_event(const StringName &p_failure_event) {
+	failure_event = p_failure_event;
+	failure_event_id = failure_event == StringName() ? LimboEventRegistry::INVALID_EVENT : LimboEventRegistry::intern(failure_event);
+}
+
 void BTState::set_scene_root_hint(Node *p_scene_root) {
 	ERR_FAIL_NULL_MSG(p_scene_root, "BTState: Failed to set scene root hint - scene root is null.");
 	ERR_FAIL_COND_MSG(bt_instance.is_valid(), "BTState: Scene root hint shouldn't be set after initialization. This change will not affect the current behavior tree instance.");
@@ -44,6 +56,20 @@ void BTState::set_scene_root_hint(Node *p_scene_root) {
 	scene_root_hint = p_scene_root;
 }
 
+void BTState::set_update_interval(double p_interval) {
+	update_interval = MAX(p_interval, 0.0);
+	if (bt_instance.is_valid()) {
+		bt_instance->set_update_interval(update_interval);
+	}
+}
+
+void BTState::set_reactive(bool p_reactive) {
+	reactive = p_reactive;
+	if (bt_instance.is_valid()) {
+		bt_instance->set_reactive(reactive);
+	}
+}
+
 void BTState::set_monitor_performance(bool p_monitor) {
 	monitor_performance = p_monitor;
 
@@ -54,6 +80,15 @@ void BTState::set_monitor_performance(bool p_monitor) {
 #endif
 }
 
+void BTState::set_lazy_instantiation(bool p_enable) {
+	ERR_FAIL_COND_MSG(bt_instance.is_valid(), "BTState: Lazy instantiation can't be changed after initialization.");
+	lazy_instantiation = p_enable;
+}
+
+void BTState::set_release_delay(double p_delay) {
+	release_delay = MAX(p_delay, 0.0);
+}
+
 void BTState::_update_blackboard_plan() {
 	if (get_blackboard_plan().is_null()) {
 		set_blackboard_plan(memnew(BlackboardPlan));
@@ -72,10 +107,23 @@ Node *BTState::_get_prefetch_root_for_base_plan() {
 void BTState::_setup() {
 	LimboState::_setup();
 	ERR_FAIL_COND_MSG(behavior_tree.is_null(), "BTState: BehaviorTree is not assigned.");
+	if (!lazy_instantiation) {
+		_instantiate();
+	}
+}
+
+void BTState::_instantiate() {
 	Node *scene_root = _get_scene_root();
 	ERR_FAIL_NULL_MSG(scene_root, "BTState: Initialization failed - unable to establish scene root. This is likely due to BTState not being owned by a scene node. Check BTState.set_scene_root_hint().");
-	bt_instance = behavior_tree->instantiate(get_agent(), get_blackboard(), this, scene_root);
+	if (instance_pool.is_valid()) {
+		// * The blackboard belongs to the state, so only the task tree is recycled.
+		bt_instance = instance_pool->acquire_with_blackboard(behavior_tree, get_agent(), get_blackboard(), this, scene_root);
+	} else {
+		bt_instance = behavior_tree->instantiate(get_agent(), get_blackboard(), this, scene_root);
+	}
 	ERR_FAIL_COND_MSG(bt_instance.is_null(), "BTState: Initialization failed - failed to instantiate behavior tree.");
+	bt_instance->set_update_interval(update_interval);
+	bt_instance->set_reactive(reactive);
 
 #ifdef DEBUG_ENABLED
 	bt_instance->register_with_debugger();
@@ -83,13 +131,50 @@ void BTState::_setup() {
 #endif
 }
 
+void BTState::_release_instance() {
+	if (bt_instance.is_null()) {
+		return;
+	}
+#ifdef DEBUG_ENABLED
+	bt_instance->unregister_with_debugger();
+	bt_instance->set_monitor_performance(false);
+#endif
+	if (instance_pool.is_valid()) {
+		instance_pool->release_tasks(bt_instance);
+	}
+	bt_instance.unref();
+}
+
+void BTState::_release_callback(Object *p_owner, uint32_t p_timer_id) {
+	BTState *state = Object::cast_to<BTState>(p_owner);
+	// Ignoring timers of earlier exits - the state was entered again since.
+	if (state && state->release_timer_id == p_timer_id) {
+		state->release_timer_id = 0;
+		if (!state->is_active()) {
+			state->_release_instance();
+		}
+	}
+}
+
+void BTState::_enter() {
+	release_timer_id = 0;
+	if (bt_instance.is_null() && lazy_instantiation && behavior_tree.is_valid()) {
+		_instantiate();
+	}
+	LimboState::_enter();
+}
+
 void BTState::_exit() {
 	if (bt_instance.is_valid()) {
 		bt_instance->get_root_task()->abort();
+		bt_instance->wake();
 	} else {
 		ERR_PRINT_ONCE("BTState: BehaviorTree is not assigned.");
 	}
 	LimboState::_exit();
+	if (lazy_instantiation && release_delay > 0.0 && bt_instance.is_valid()) {
+		release_timer_id = LimboTimerWheel::get(false)->schedule(release_delay, this, &BTState::_release_callback);
+	}
 }
 
 void BTState::_update(double p_delta) {
@@ -99,13 +184,19 @@ void BTState::_update(double p_delta) {
 		return;
 	}
 	ERR_FAIL_NULL(bt_instance);
-	BT::Status status = bt_instance->update(p_delta);
-	if (status == BTTask::SUCCESS) {
-		get_root()->dispatch(success_event, Variant());
-	} else if (status == BTTask::FAILURE) {
-		get_root()->dispatch(failure_event, Variant());
+	if (bt_instance->advance(p_delta)) {
+		BT::Status status = bt_instance->update(bt_instance->consume_pending_delta());
+		const int event_id = status == BTTask::SUCCESS ? success_event_id : (status == BTTask::FAILURE ? failure_event_id : LimboEventRegistry::INVALID_EVENT);
+		if (event_id != LimboEventRegistry::INVALID_EVENT) {
+			if (likely(is_active())) {
+				LimboHSM::_dispatch_from_active(this, event_id, Variant());
+			} else {
+				// * The tree triggered a transition away from this state - the event goes to the new active branch.
+				dispatch_id(event_id, Variant());
+			}
+		}
 	}
-	emit_signal(LW_NAME(updated), p_delta);
+	_emit_updated(p_delta);
 }
 
 void BTState::_notification(int p_notification) {
@@ -148,18 +239,34 @@ void BTState::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_failure_event", "event"), &BTState::set_failure_event);
 	ClassDB::bind_method(D_METHOD("get_failure_event"), &BTState::get_failure_event);
 
+	ClassDB::bind_method(D_METHOD("set_update_interval", "interval"), &BTState::set_update_interval);
+	ClassDB::bind_method(D_METHOD("get_update_interval"), &BTState::get_update_interval);
+	ClassDB::bind_method(D_METHOD("set_reactive", "enable"), &BTState::set_reactive);
+	ClassDB::bind_method(D_METHOD("is_reactive"), &BTState::is_reactive);
+
 	ClassDB::bind_method(D_METHOD("set_monitor_performance", "enable"), &BTState::set_monitor_performance);
 	ClassDB::bind_method(D_METHOD("get_monitor_performance"), &BTState::get_monitor_performance);
 
+	ClassDB::bind_method(D_METHOD("set_lazy_instantiation", "enable"), &BTState::set_lazy_instantiation);
+	ClassDB::bind_method(D_METHOD("get_lazy_instantiation"), &BTState::get_lazy_instantiation);
+	ClassDB::bind_method(D_METHOD("set_release_delay", "delay"), &BTState::set_release_delay);
+	ClassDB::bind_method(D_METHOD("get_release_delay"), &BTState::get_release_delay);
+	ClassDB::bind_method(D_METHOD("set_instance_pool", "pool"), &BTState::set_instance_pool);
+	ClassDB::bind_method(D_METHOD("get_instance_pool"), &BTState::get_instance_pool);
+
 	ClassDB::bind_method(D_METHOD("set_scene_root_hint", "scene_root"), &BTState::set_scene_root_hint);
 
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "behavior_tree", PROPERTY_HINT_RESOURCE_TYPE, "BehaviorTree"), "set_behavior_tree", "get_behavior_tree");
 	ADD_PROPERTY(PropertyInfo(Variant::STRING_NAME, "success_event"), "set_success_event", "get_success_event");
 	ADD_PROPERTY(PropertyInfo(Variant::STRING_NAME, "failure_event"), "set_failure_event", "get_failure_event");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "update_interval", PROPERTY_HINT_RANGE, "0.0,10.0,0.001,or_greater,suffix:s"), "set_update_interval", "get_update_interval");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "reactive"), "set_reactive", "is_reactive");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "monitor_performance"), "set_monitor_performance", "get_monitor_performance");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "lazy_instantiation"), "set_lazy_instantiation", "get_lazy_instantiation");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "release_delay", PROPERTY_HINT_RANGE, "0.0,600.0,0.1,or_greater,suffix:s"), "set_release_delay", "get_release_delay");
 }
 
 BTState::BTState() {
-	success_event = LW_NAME(EVENT_SUCCESS);
-	failure_event = LW_NAME(EVENT_FAILURE);
+	set_success_event(LW_NAME(EVENT_SUCCESS));
+	set_failure_event(LW_NAME(EVENT_FAILURE));
 }
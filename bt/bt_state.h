@@ -15,6 +15,7 @@
 #include "../hsm/limbo_state.h"
 
 #include "../bt/behavior_tree.h"
+#include "../bt/bt_instance_pool.h"
 #include "../bt/tasks/bt_task.h"
 
 class BTState : public LimboState {
@@ -25,10 +26,23 @@ private:
 	Ref<BTInstance> bt_instance;
 	StringName success_event;
 	StringName failure_event;
+	int success_event_id = LimboEventRegistry::INVALID_EVENT;
+	int failure_event_id = LimboEventRegistry::INVALID_EVENT;
 	Node *scene_root_hint = nullptr;
 	bool monitor_performance = false;
+	double update_interval = 0.0;
+	bool reactive = false;
+
+	// With lazy_instantiation, the tree is instantiated on the first enter, and released after being inactive for release_delay.
+	bool lazy_instantiation = false;
+	double release_delay = 0.0;
+	Ref<BTInstancePool> instance_pool;
+	uint32_t release_timer_id = 0;
 
 	_FORCE_INLINE_ Node *_get_scene_root() const { return scene_root_hint ? scene_root_hint : get_owner(); }
+	void _instantiate();
+	void _release_instance();
+	static void _release_callback(Object *p_owner, uint32_t p_timer_id);
 
 protected:
 	static void _bind_methods();
@@ -40,6 +54,7 @@ protected:
 	virtual Node *_get_prefetch_root_for_base_plan() override;
 
 	virtual void _setup() override;
+	virtual void _enter() override;
 	virtual void _exit() override;
 	virtual void _update(double p_delta) override;
 
@@ -49,15 +64,30 @@ public:
 
 	Ref<BTInstance> get_bt_instance() const { return bt_instance; }
 
-	void set_success_event(const StringName &p_success_event) { success_event = p_success_event; }
+	void set_success_event(const StringName &p_success_event);
 	StringName get_success_event() const { return success_event; }
 
-	void set_failure_event(const StringName &p_failure_event) { failure_event = p_failure_event; }
+	void set_failure_event(const StringName &p_failure_event);
 	StringName get_failure_event() const { return failure_event; }
 
+	void set_update_interval(double p_interval);
+	double get_update_interval() const { return update_interval; }
+
+	void set_reactive(bool p_reactive);
+	bool is_reactive() const { return reactive; }
+
 	void set_monitor_performance(bool p_monitor);
 	bool get_monitor_performance() const { return monitor_performance; }
 
+	void set_lazy_instantiation(bool p_enable);
+	bool get_lazy_instantiation() const { return lazy_instantiation; }
+
+	void set_release_delay(double p_delay);
+	double get_release_delay() const { return release_delay; }
+
+	void set_instance_pool(const Ref<BTInstancePool> &p_pool) { instance_pool = p_pool; }
+	Ref<BTInstancePool> get_instance_pool() const { return instance_pool; }
+
 	void set_scene_root_hint(Node *p_node);
 
 	BTState();
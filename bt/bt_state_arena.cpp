@@ -0,0 +1,95 @@
+/**
+ * bt_state_arena.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "bt_state_arena.h"
+
+BTStateArena::BTStateArena(uint32_t p_block_size) :
+		block_size(p_block_size) {
+	refcount.init();
+}
+
+BTStateArena::~BTStateArena() {
+	ERR_FAIL_COND_MSG(allocated_blocks > 0, "BTStateArena: Freed while blocks are still in use.");
+	for (Slab &slab : slabs) {
+		if (slab.states) {
+			memdelete_arr(slab.states);
+		}
+	}
+}
+
+BTStateArena *BTStateArena::create(uint32_t p_block_size) {
+	ERR_FAIL_COND_V(p_block_size == 0, nullptr);
+	return memnew(BTStateArena(p_block_size));
+}
+
+void BTStateArena::unreference() {
+	if (refcount.unref()) {
+		memdelete(this);
+	}
+}
+
+BTTask::State *BTStateArena::allocate() {
+	lock.lock();
+	uint32_t s = first_free_slab;
+	while (s < slabs.size() && slabs[s].free_mask == 0) {
+		s++;
+	}
+	if (s == slabs.size()) {
+		slabs.push_back(Slab());
+	}
+	first_free_slab = s;
+	Slab &slab = slabs[s];
+	if (slab.states == nullptr) {
+		slab.states = memnew_arr(BTTask::State, BLOCKS_PER_SLAB * block_size);
+		live_slabs += 1;
+	} else if (slab.free_mask == ~uint64_t(0)) {
+		empty_slabs -= 1;
+	}
+	uint32_t b = 0;
+	while (!(slab.free_mask & (uint64_t(1) << b))) {
+		b++;
+	}
+	slab.free_mask &= ~(uint64_t(1) << b);
+	allocated_blocks += 1;
+	BTTask::State *block = slab.states + b * block_size;
+	block_slabs.insert(block, s);
+	lock.unlock();
+
+	for (uint32_t i = 0; i < block_size; i++) {
+		block[i] = BTTask::State();
+	}
+	return block;
+}
+
+void BTStateArena::free(BTTask::State *p_block) {
+	lock.lock();
+	const uint32_t *idx = block_slabs.getptr(p_block);
+	if (idx == nullptr) {
+		lock.unlock();
+		ERR_FAIL_MSG("BTStateArena: Block doesn't belong to this arena.");
+	}
+	const uint32_t s = *idx;
+	block_slabs.erase(p_block);
+	Slab &slab = slabs[s];
+	slab.free_mask |= uint64_t(1) << (uint32_t(p_block - slab.states) / block_size);
+	allocated_blocks -= 1;
+	if (slab.free_mask == ~uint64_t(0)) {
+		if (empty_slabs < MAX_EMPTY_SLABS) {
+			empty_slabs += 1;
+		} else {
+			memdelete_arr(slab.states);
+			slab.states = nullptr;
+			live_slabs -= 1;
+		}
+	}
+	first_free_slab = MIN(first_free_slab, s);
+	lock.unlock();
+}
@@ -0,0 +1,77 @@
+/**
+ * bt_state_arena.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef BT_STATE_ARENA_H
+#define BT_STATE_ARENA_H
+
+#include "tasks/bt_task.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/os/spin_lock.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/templates/safe_refcount.hpp>
+#include <godot_cpp/templates/spin_lock.hpp>
+using namespace godot;
+#endif // LIMBOAI_GDEXTENSION
+
+// Shared storage for the task states of compiled instances of one BehaviorTree (see BTInstance::compile()).
+// Blocks of the same size are carved out of slabs and handed out from the first slab with a free block,
+// so instances created one after another tick through consecutive memory.
+// Slabs that become empty are released, except for MAX_EMPTY_SLABS kept for the next allocations.
+class BTStateArena {
+public:
+	static constexpr uint32_t BLOCKS_PER_SLAB = 64;
+	static constexpr uint32_t MAX_EMPTY_SLABS = 1;
+
+private:
+	struct Slab {
+		BTTask::State *states = nullptr; // Null once released - the entry is reused by the next new slab.
+		uint64_t free_mask = ~uint64_t(0); // Bit per block.
+	};
+
+	SafeRefCount refcount;
+	uint32_t block_size = 0;
+	uint32_t allocated_blocks = 0;
+	uint32_t live_slabs = 0;
+	uint32_t empty_slabs = 0; // Live slabs without allocated blocks.
+	uint32_t first_free_slab = 0; // No slab before this one has a free block.
+	LocalVector<Slab> slabs;
+	HashMap<const BTTask::State *, uint32_t> block_slabs; // Allocated block -> index in slabs.
+	SpinLock lock;
+
+	BTStateArena(uint32_t p_block_size);
+	~BTStateArena();
+
+public:
+	// Returns a new arena holding one reference.
+	static BTStateArena *create(uint32_t p_block_size);
+	void reference() { refcount.ref(); }
+	// Frees the arena when the last reference goes away.
+	void unreference();
+
+	uint32_t get_block_size() const { return block_size; }
+	uint32_t get_allocated_blocks() const { return allocated_blocks; }
+	uint32_t get_slab_count() const { return live_slabs; }
+	size_t get_memory_usage() const { return sizeof(BTStateArena) + slabs.size() * sizeof(Slab) + live_slabs * BLOCKS_PER_SLAB * block_size * sizeof(BTTask::State); }
+
+	// Returns a block of get_block_size() states, reset to their defaults.
+	BTTask::State *allocate();
+	void free(BTTask::State *p_block);
+};
+
+#endif // BT_STATE_ARENA_H
@@ -0,0 +1,202 @@
+/**
+ * bt_stats.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "bt_stats.h"
+
+#include "../util/limbo_compat.h"
+#include "../util/limbo_string_names.h"
+#include "../util/limbo_ticks.h"
+#include "tasks/bt_task.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/config/project_settings.h"
+#include "main/performance.h"
+#include "scene/main/scene_tree.h"
+#include "scene/main/window.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/performance.hpp>
+#include <godot_cpp/classes/project_settings.hpp>
+#include <godot_cpp/classes/scene_tree.hpp>
+#include <godot_cpp/classes/window.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+BTStats::Shard BTStats::shards[BTStats::MAX_SHARDS];
+SafeNumeric<uint32_t> BTStats::num_shards;
+thread_local BTStats::Shard *BTStats::thread_shard = nullptr;
+thread_local uint64_t BTStats::thread_tasks_executed = 0;
+thread_local uint64_t BTStats::thread_tasks_published = 0;
+bool BTStats::enabled = true;
+uint64_t BTStats::connected_tree_id = 0;
+uint64_t BTStats::total_usec = 0;
+uint64_t BTStats::total_instances = 0;
+uint64_t BTStats::total_tasks = 0;
+uint64_t BTStats::frame_usec = 0;
+uint64_t BTStats::frame_instances = 0;
+uint64_t BTStats::frame_tasks = 0;
+double BTStats::frame_delta = 0.0;
+uint64_t BTStats::total_histogram[BTStats::HISTOGRAM_BUCKETS] = {};
+uint64_t BTStats::frame_histogram[BTStats::HISTOGRAM_BUCKETS] = {};
+bool BTStats::spike_capture = false;
+SafeNumeric<uint64_t> BTStats::spike_threshold;
+SpinLock BTStats::spike_lock;
+LocalVector<BTStats::Spike> BTStats::pending_spikes;
+LocalVector<BTStats::Spike> BTStats::frame_spikes;
+
+void BTStats::initialize() {
+	enabled = GLOBAL_DEF("limbo_ai/behavior_tree/runtime_stats", true);
+	LimboTicks::initialize();
+}
+
+void BTStats::record_update(uint64_t p_usec) {
+	if (unlikely(thread_shard == nullptr)) {
+		// * With more threads than shards, some shards are shared - updates are atomic, so that's still correct.
+		thread_shard = &shards[num_shards.postincrement() % MAX_SHARDS];
+	}
+	thread_shard->update_usec.add(p_usec);
+	thread_shard->instances_updated.increment();
+	thread_shard->tasks_executed.add(thread_tasks_executed - thread_tasks_published);
+	thread_tasks_published = thread_tasks_executed;
+
+	int bucket = 0;
+	for (uint64_t usec = p_usec; usec > 1 && bucket < HISTOGRAM_BUCKETS - 1; usec >>= 1) {
+		bucket++;
+	}
+	thread_shard->histogram[bucket].increment();
+}
+
+void BTStats::record_shared_update(uint64_t p_usec, uint32_t p_tasks) {
+	record_update(p_usec);
+	thread_shard->tasks_executed.add(p_tasks);
+}
+
+void BTStats::set_spike_capture(bool p_enabled) {
+	spike_capture = p_enabled;
+	spike_lock.lock();
+	pending_spikes.clear();
+	spike_threshold.set(0);
+	spike_lock.unlock();
+	frame_spikes.clear();
+}
+
+void BTStats::record_spike(uint64_t p_instance_id, uint64_t p_usec, const String &p_tree_path, uint64_t p_running_task_id) {
+	spike_lock.lock();
+	int slot = -1;
+	if (pending_spikes.size() < MAX_SPIKES) {
+		slot = pending_spikes.size();
+		pending_spikes.push_back(Spike());
+	} else {
+		// Replace the fastest of the captured updates, if this one is slower.
+		slot = 0;
+		for (uint32_t i = 1; i < pending_spikes.size(); i++) {
+			if (pending_spikes[i].usec < pending_spikes[slot].usec) {
+				slot = i;
+			}
+		}
+		if (pending_spikes[slot].usec >= p_usec) {
+			slot = -1;
+		}
+	}
+	if (slot != -1) {
+		Spike &spike = pending_spikes[slot];
+		spike.instance_id = p_instance_id;
+		spike.usec = p_usec;
+		spike.tree_path = p_tree_path;
+		spike.running_task_id = p_running_task_id;
+		if (pending_spikes.size() == MAX_SPIKES) {
+			uint64_t threshold = pending_spikes[0].usec;
+			for (const Spike &s : pending_spikes) {
+				threshold = MIN(threshold, s.usec);
+			}
+			spike_threshold.set(threshold);
+		}
+	}
+	spike_lock.unlock();
+}
+
+String BTStats::_get_task_path(uint64_t p_task_id) {
+	BTTask *task = p_task_id ? Object::cast_to<BTTask>(OBJECT_DB_GET_INSTANCE(p_task_id)) : nullptr;
+	String path;
+	while (task != nullptr) {
+		path = path.is_empty() ? task->get_task_name() : task->get_task_name() + "/" + path;
+		task = task->get_parent().ptr();
+	}
+	return path;
+}
+
+void BTStats::merge(double p_delta) {
+	LimboTicks::calibrate();
+	uint64_t usec = 0;
+	uint64_t instances = 0;
+	uint64_t tasks = 0;
+	const uint32_t count = MIN(num_shards.get(), MAX_SHARDS);
+	for (uint32_t i = 0; i < count; i++) {
+		usec += shards[i].update_usec.get();
+		instances += shards[i].instances_updated.get();
+		tasks += shards[i].tasks_executed.get();
+	}
+	for (int b = 0; b < HISTOGRAM_BUCKETS; b++) {
+		uint64_t n = 0;
+		for (uint32_t i = 0; i < count; i++) {
+			n += shards[i].histogram[b].get();
+		}
+		frame_histogram[b] = n - total_histogram[b];
+		total_histogram[b] = n;
+	}
+	// Shards are never reset, so writers are never interrupted - the frame values are differences of the totals.
+	frame_usec = usec - total_usec;
+	frame_instances = instances - total_instances;
+	frame_tasks = tasks - total_tasks;
+	frame_delta = p_delta;
+	total_usec = usec;
+	total_instances = instances;
+	total_tasks = tasks;
+
+	if (spike_capture) {
+		spike_lock.lock();
+		SWAP(frame_spikes, pending_spikes);
+		pending_spikes.clear();
+		spike_threshold.set(0);
+		spike_lock.unlock();
+
+		frame_spikes.sort_custom<SpikeComparator>();
+		for (Spike &spike : frame_spikes) {
+			spike.task_path = _get_task_path(spike.running_task_id);
+		}
+	}
+}
+
+void BTStats::ensure_processing() {
+	if (!enabled) {
+		return;
+	}
+	SceneTree *tree = SCENE_TREE();
+	if (tree == nullptr || uint64_t(tree->get_instance_id()) == connected_tree_id) {
+		return;
+	}
+	tree->connect(LW_NAME(process_frame), callable_mp_static(&BTStats::_on_process_frame));
+	connected_tree_id = tree->get_instance_id();
+
+	Performance *perf = Performance::get_singleton();
+	if (perf && !perf->has_custom_monitor("LimboAI/update_time_ms")) {
+		PERFORMANCE_ADD_CUSTOM_MONITOR("LimboAI/update_time_ms", callable_mp_static(&BTStats::_get_update_time_msec));
+		PERFORMANCE_ADD_CUSTOM_MONITOR("LimboAI/instances_updated", callable_mp_static(&BTStats::_get_instances_updated));
+		PERFORMANCE_ADD_CUSTOM_MONITOR("LimboAI/tasks_executed", callable_mp_static(&BTStats::_get_tasks_executed));
+		PERFORMANCE_ADD_CUSTOM_MONITOR("LimboAI/tasks_per_second", callable_mp_static(&BTStats::_get_tasks_per_second));
+	}
+}
+
+void BTStats::_on_process_frame() {
+	SceneTree *tree = SCENE_TREE();
+	ERR_FAIL_NULL(tree);
+	merge(tree->get_root()->get_process_delta_time());
+}
@@ -0,0 +1,130 @@
+/**
+ * bt_stats.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef BT_STATS_H
+#define BT_STATS_H
+
+#ifdef LIMBOAI_MODULE
+#include "core/os/spin_lock.h"
+#include "core/string/ustring.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+#include "core/typedefs.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/core/defs.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/templates/safe_refcount.hpp>
+#include <godot_cpp/templates/spin_lock.hpp>
+#include <godot_cpp/variant/string.hpp>
+using namespace godot;
+#endif // LIMBOAI_GDEXTENSION
+
+// Runtime statistics of behavior tree updates, exposed as LimboAI/* performance monitors in all builds.
+// Each thread writes to its own shard, and the shards are summed on the main thread once per frame.
+class BTStats {
+public:
+	// Bucket 0 counts updates under 2 usec, bucket i counts updates in [2^i, 2^(i+1)) usec, the last one is open-ended.
+	static constexpr int HISTOGRAM_BUCKETS = 16;
+	static constexpr uint32_t MAX_SPIKES = 8;
+
+	// One of the slowest updates of a frame.
+	struct Spike {
+		uint64_t instance_id = 0;
+		uint64_t usec = 0;
+		String tree_path;
+		uint64_t running_task_id = 0; // Resolved into task_path on the main thread.
+		String task_path;
+	};
+
+	// Orders spikes from the slowest.
+	struct SpikeComparator {
+		_FORCE_INLINE_ bool operator()(const Spike &p_a, const Spike &p_b) const { return p_a.usec > p_b.usec; }
+	};
+
+private:
+	static constexpr uint32_t MAX_SHARDS = 64;
+
+	// Cache line aligned, so that threads don't contend for the same line.
+	struct alignas(64) Shard {
+		SafeNumeric<uint64_t> update_usec;
+		SafeNumeric<uint64_t> instances_updated;
+		SafeNumeric<uint64_t> tasks_executed;
+		SafeNumeric<uint64_t> histogram[HISTOGRAM_BUCKETS];
+	};
+
+	static Shard shards[MAX_SHARDS];
+	static SafeNumeric<uint32_t> num_shards;
+	static thread_local Shard *thread_shard;
+	static thread_local uint64_t thread_tasks_executed;
+	static thread_local uint64_t thread_tasks_published; // Part of thread_tasks_executed already added to the shard.
+	static bool enabled;
+	static uint64_t connected_tree_id;
+
+	// Totals as of the last merge, and the difference to the merge before it.
+	static uint64_t total_usec;
+	static uint64_t total_instances;
+	static uint64_t total_tasks;
+	static uint64_t frame_usec;
+	static uint64_t frame_instances;
+	static uint64_t frame_tasks;
+	static double frame_delta;
+	static uint64_t total_histogram[HISTOGRAM_BUCKETS];
+	static uint64_t frame_histogram[HISTOGRAM_BUCKETS];
+
+	static bool spike_capture;
+	static SafeNumeric<uint64_t> spike_threshold; // Updates slower than this are candidates for the spike buffer.
+	static SpinLock spike_lock;
+	static LocalVector<Spike> pending_spikes;
+	static LocalVector<Spike> frame_spikes;
+
+	static String _get_task_path(uint64_t p_task_id);
+
+	static void _on_process_frame();
+	static double _get_update_time_msec() { return frame_usec * 0.001; }
+	static int64_t _get_instances_updated() { return frame_instances; }
+	static int64_t _get_tasks_executed() { return frame_tasks; }
+	static double _get_tasks_per_second() { return frame_delta > 0.0 ? frame_tasks / frame_delta : 0.0; }
+
+public:
+	static void initialize();
+	_FORCE_INLINE_ static bool is_enabled() { return enabled; }
+	// True if updates need to be timed for the stats or spike capture.
+	_FORCE_INLINE_ static bool is_timing() { return enabled || spike_capture; }
+
+	// Hot path: a plain thread-local counter, published with the next record_update() on this thread.
+	_FORCE_INLINE_ static void count_task() { thread_tasks_executed++; }
+	// Tasks executed on the calling thread so far - never reset, so that nested updates can take differences.
+	_FORCE_INLINE_ static uint64_t get_thread_task_count() { return thread_tasks_executed; }
+	static void record_update(uint64_t p_usec);
+	// An update that took over the result of another one, counting the tasks executed by that one.
+	static void record_shared_update(uint64_t p_usec, uint32_t p_tasks);
+
+	// Spike capture is off unless requested, e.g. by the LimboAI debugger.
+	static void set_spike_capture(bool p_enabled);
+	_FORCE_INLINE_ static bool is_spike(uint64_t p_usec) { return spike_capture && p_usec > spike_threshold.get(); }
+	static void record_spike(uint64_t p_instance_id, uint64_t p_usec, const String &p_tree_path, uint64_t p_running_task_id);
+
+	// Connects to the SceneTree and adds the monitors. Call on the main thread.
+	static void ensure_processing();
+	// Sums up the shards. Normally called on every process frame.
+	static void merge(double p_delta);
+
+	static uint64_t get_frame_update_usec() { return frame_usec; }
+	static uint64_t get_frame_instances_updated() { return frame_instances; }
+	static uint64_t get_frame_tasks_executed() { return frame_tasks; }
+	static uint64_t get_frame_histogram_bucket(int p_bucket) { return frame_histogram[p_bucket]; }
+	// Slowest updates of the last merged frame, slowest first.
+	static const LocalVector<Spike> &get_frame_spikes() { return frame_spikes; }
+};
+
+#endif // BT_STATS_H
@@ -0,0 +1,130 @@
+/**
+ * bt_telemetry.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "bt_telemetry.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/io/file_access.h"
+#include "core/io/json.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/json.hpp>
+#include <godot_cpp/core/class_db.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+void BTTelemetry::build(const Ref<BTTask> &p_root) {
+	ERR_FAIL_COND_MSG(!counters.is_empty(), "BTTelemetry: Already built.");
+	ERR_FAIL_COND(p_root.is_null());
+	_add_task(p_root);
+	counters.resize(task_names.size());
+}
+
+void BTTelemetry::_add_task(const Ref<BTTask> &p_task) {
+	task_names.push_back(p_task->get_task_name());
+	for (int i = 0; i < p_task->get_child_count(); i++) {
+		_add_task(p_task->get_child(i));
+	}
+}
+
+String BTTelemetry::get_task_name(int p_index) const {
+	ERR_FAIL_INDEX_V(p_index, task_names.size(), String());
+	return task_names[p_index];
+}
+
+int64_t BTTelemetry::get_counter(int p_index, Counter p_counter) const {
+	ERR_FAIL_INDEX_V(p_index, (int)counters.size(), 0);
+	const BTTaskCounters &c = counters[p_index];
+	switch (p_counter) {
+		case COUNTER_ENTERED:
+			return c.entered.get();
+		case COUNTER_SUCCEEDED:
+			return c.succeeded.get();
+		case COUNTER_FAILED:
+			return c.failed.get();
+		case COUNTER_ABORTED:
+			return c.aborted.get();
+		case COUNTER_TICKS:
+			return c.ticks.get();
+		default:
+			ERR_FAIL_V_MSG(0, "BTTelemetry: Invalid counter.");
+	}
+}
+
+// All counters in one flat array: COUNTER_MAX values per task, in the order of the Counter enum.
+PackedInt64Array BTTelemetry::get_counters() const {
+	PackedInt64Array result;
+	result.resize(counters.size() * COUNTER_MAX);
+	int64_t *w = result.ptrw();
+	for (const BTTaskCounters &c : counters) {
+		*w++ = c.entered.get();
+		*w++ = c.succeeded.get();
+		*w++ = c.failed.get();
+		*w++ = c.aborted.get();
+		*w++ = c.ticks.get();
+	}
+	return result;
+}
+
+Array BTTelemetry::get_report() const {
+	Array report;
+	for (uint32_t i = 0; i < counters.size(); i++) {
+		Dictionary entry;
+		entry["name"] = task_names[i];
+		entry["entered"] = counters[i].entered.get();
+		entry["succeeded"] = counters[i].succeeded.get();
+		entry["failed"] = counters[i].failed.get();
+		entry["aborted"] = counters[i].aborted.get();
+		entry["ticks"] = counters[i].ticks.get();
+		report.push_back(entry);
+	}
+	return report;
+}
+
+String BTTelemetry::to_json() const {
+	return JSON::stringify(get_report());
+}
+
+Error BTTelemetry::save(const String &p_path) const {
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::WRITE);
+	ERR_FAIL_COND_V_MSG(f.is_null(), ERR_CANT_CREATE, "BTTelemetry: Can't open file for writing: " + p_path);
+	f->store_string(to_json());
+	return OK;
+}
+
+void BTTelemetry::reset() {
+	for (BTTaskCounters &c : counters) {
+		c.entered.set(0);
+		c.succeeded.set(0);
+		c.failed.set(0);
+		c.aborted.set(0);
+		c.ticks.set(0);
+	}
+}
+
+void BTTelemetry::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("get_task_count"), &BTTelemetry::get_task_count);
+	ClassDB::bind_method(D_METHOD("get_task_name", "task_index"), &BTTelemetry::get_task_name);
+	ClassDB::bind_method(D_METHOD("get_counter", "task_index", "counter"), &BTTelemetry::get_counter);
+	ClassDB::bind_method(D_METHOD("get_counters"), &BTTelemetry::get_counters);
+	ClassDB::bind_method(D_METHOD("get_report"), &BTTelemetry::get_report);
+	ClassDB::bind_method(D_METHOD("to_json"), &BTTelemetry::to_json);
+	ClassDB::bind_method(D_METHOD("save", "path"), &BTTelemetry::save);
+	ClassDB::bind_method(D_METHOD("reset"), &BTTelemetry::reset);
+
+	BIND_ENUM_CONSTANT(COUNTER_ENTERED);
+	BIND_ENUM_CONSTANT(COUNTER_SUCCEEDED);
+	BIND_ENUM_CONSTANT(COUNTER_FAILED);
+	BIND_ENUM_CONSTANT(COUNTER_ABORTED);
+	BIND_ENUM_CONSTANT(COUNTER_TICKS);
+	BIND_ENUM_CONSTANT(COUNTER_MAX);
+}
@@ -0,0 +1,79 @@
+/**
+ * bt_telemetry.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef BT_TELEMETRY_H
+#define BT_TELEMETRY_H
+
+#include "tasks/bt_task.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/object/ref_counted.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/templates/safe_refcount.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+// Outcome counters shared by the same task in all instances of a BehaviorTree, available in release builds.
+// Instances can be ticked on different threads.
+struct BTTaskCounters {
+	SafeNumeric<uint32_t> entered;
+	SafeNumeric<uint32_t> succeeded;
+	SafeNumeric<uint32_t> failed;
+	SafeNumeric<uint32_t> aborted;
+	SafeNumeric<uint32_t> ticks;
+};
+
+class BTTelemetry : public RefCounted {
+	GDCLASS(BTTelemetry, RefCounted);
+
+public:
+	enum Counter {
+		COUNTER_ENTERED,
+		COUNTER_SUCCEEDED,
+		COUNTER_FAILED,
+		COUNTER_ABORTED,
+		COUNTER_TICKS,
+		COUNTER_MAX,
+	};
+
+private:
+	PackedStringArray task_names;
+	// Sized once on build(), so that instances can hold pointers to it.
+	LocalVector<BTTaskCounters> counters;
+
+	void _add_task(const Ref<BTTask> &p_task);
+
+protected:
+	static void _bind_methods();
+
+public:
+	// Lays out the counters in the depth-first order of the tasks in p_root.
+	void build(const Ref<BTTask> &p_root);
+	_FORCE_INLINE_ int get_task_count() const { return counters.size(); }
+	_FORCE_INLINE_ BTTaskCounters *get_task_counters(int p_index) { return &counters[p_index]; }
+
+	String get_task_name(int p_index) const;
+	int64_t get_counter(int p_index, Counter p_counter) const;
+	PackedInt64Array get_counters() const;
+	Array get_report() const;
+	String to_json() const;
+	Error save(const String &p_path) const;
+	void reset();
+};
+
+VARIANT_ENUM_CAST(BTTelemetry::Counter);
+
+#endif // BT_TELEMETRY_H
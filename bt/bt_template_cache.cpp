@@ -0,0 +1,111 @@
+/**
+ * bt_template_cache.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "bt_template_cache.h"
+
+#include "../util/limbo_compat.h"
+#include "../util/limboai_version.h"
+#include "behavior_tree.h"
+#include "behavior_tree_format.h"
+#include "tasks/decorators/bt_subtree.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/config/project_settings.h"
+#include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+#include "core/templates/hashfuncs.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/dir_access.hpp>
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/project_settings.hpp>
+#include <godot_cpp/templates/hashfuncs.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+String BTTemplateCache::cache_dir;
+
+void BTTemplateCache::initialize() {
+	cache_dir = GLOBAL_DEF(PropertyInfo(Variant::STRING, "limbo_ai/behavior_tree/template_cache_dir"), "");
+}
+
+void BTTemplateCache::_collect_sources(const BTTask *p_task, HashSet<String> &r_paths) {
+	const BTSubtree *subtree = Object::cast_to<BTSubtree>(p_task);
+	if (subtree && subtree->get_subtree().is_valid() && subtree->get_subtree()->get_root_task().is_valid()) {
+		// * Built-in subtrees are saved in the file of the tree that contains them.
+		const String path = subtree->get_subtree()->get_path().get_slice("::", 0);
+		if (!r_paths.has(path)) {
+			r_paths.insert(path);
+			_collect_sources(subtree->get_subtree()->get_root_task().ptr(), r_paths);
+		}
+	}
+	for (int i = 0; i < p_task->get_child_count(); i++) {
+		_collect_sources(p_task->get_child(i).ptr(), r_paths);
+	}
+}
+
+String BTTemplateCache::_get_entry_path(const BehaviorTree *p_tree) {
+	const String tree_path = p_tree->get_path();
+	if (tree_path.is_empty() || tree_path.contains("::")) {
+		return String();
+	}
+	HashSet<String> paths;
+	paths.insert(tree_path);
+	_collect_sources(p_tree->get_root_task().ptr(), paths);
+
+	// * Order of the set doesn't matter: hashes of the files are combined with XOR.
+	uint32_t files_hash = 0;
+	for (const String &path : paths) {
+		if (path.is_empty()) {
+			continue;
+		}
+		files_hash ^= hash_murmur3_one_32(FileAccess::get_md5(path).hash(), path.hash());
+	}
+	const uint32_t h = hash_fmix32(hash_murmur3_one_32(files_hash, String(LIMBOAI_VERSION_HASH).hash()));
+	return cache_dir.path_join(tree_path.md5_text() + "-" + String::num_uint64(h, 16) + ".lbt");
+}
+
+Ref<BTTask> BTTemplateCache::load(const BehaviorTree *p_tree) {
+	ERR_FAIL_NULL_V(p_tree, nullptr);
+	const String entry = _get_entry_path(p_tree);
+	if (entry.is_empty() || !FileAccess::file_exists(entry)) {
+		return nullptr;
+	}
+	Ref<BehaviorTree> cached = ResourceFormatLoaderBehaviorTree::load_from_file(entry);
+	if (cached.is_null() || cached->get_root_task().is_null()) {
+		WARN_PRINT("BTTemplateCache: Ignoring unreadable cache entry: " + entry);
+		return nullptr;
+	}
+	return cached->get_root_task();
+}
+
+void BTTemplateCache::store(const BehaviorTree *p_tree, const Ref<BTTask> &p_template) {
+	ERR_FAIL_NULL(p_tree);
+	ERR_FAIL_COND(p_template.is_null());
+	const String entry = _get_entry_path(p_tree);
+	if (entry.is_empty()) {
+		return;
+	}
+	Ref<BehaviorTree> wrapper = memnew(BehaviorTree);
+	wrapper->set_root_task(p_template);
+	PackedByteArray bytes;
+	if (ResourceFormatSaverBehaviorTree::save_to_bytes(wrapper, bytes) != OK) {
+		return;
+	}
+	DirAccess::make_dir_recursive_absolute(cache_dir);
+	// * Entries may be mapped by other processes (see LimboMappedFile) - they are replaced, never rewritten in place.
+	const String tmp_path = entry + ".tmp";
+	Ref<FileAccess> f = FileAccess::open(tmp_path, FileAccess::WRITE);
+	ERR_FAIL_COND_MSG(f.is_null(), "BTTemplateCache: Can't open file for writing: " + tmp_path);
+	f->store_buffer(bytes);
+	f.unref();
+	ERR_FAIL_COND_MSG(DirAccess::rename_absolute(tmp_path, entry) != OK, "BTTemplateCache: Can't replace cache entry: " + entry);
+}
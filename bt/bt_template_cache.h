@@ -0,0 +1,49 @@
+/**
+ * bt_template_cache.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef BT_TEMPLATE_CACHE_H
+#define BT_TEMPLATE_CACHE_H
+
+#include "tasks/bt_task.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/templates/hash_set.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/templates/hash_set.hpp>
+using namespace godot;
+#endif // LIMBOAI_GDEXTENSION
+
+class BehaviorTree;
+
+// On-disk cache of instance templates (see BehaviorTree::get_instance_template()), controlled by the
+// "limbo_ai/behavior_tree/template_cache_dir" project setting. Templates are stored in the binary ".lbt" format,
+// keyed by the path of the tree and a hash of the files of the tree and its subtrees, so editing any of them
+// invalidates the entry. A cached template is loaded in one pass instead of cloning the tree and its subtrees.
+class BTTemplateCache {
+private:
+	static String cache_dir;
+
+	static void _collect_sources(const BTTask *p_task, HashSet<String> &r_paths);
+	static String _get_entry_path(const BehaviorTree *p_tree);
+
+public:
+	static void initialize();
+	static _FORCE_INLINE_ bool is_enabled() { return !cache_dir.is_empty(); }
+
+	// Returns the cached template of p_tree, or null if there is none for the current version of its files.
+	static Ref<BTTask> load(const BehaviorTree *p_tree);
+	// Stores p_template built from p_tree. Trees with built-in scripts are not cached.
+	static void store(const BehaviorTree *p_tree, const Ref<BTTask> &p_template);
+};
+
+#endif // BT_TEMPLATE_CACHE_H
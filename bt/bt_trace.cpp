@@ -0,0 +1,376 @@
+/**
+ * bt_trace.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "bt_trace.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/io/file_access.h"
+#include "core/io/json.h"
+#include "core/os/time.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/json.hpp>
+#include <godot_cpp/classes/time.hpp>
+#include <godot_cpp/core/class_db.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+#define TRACE_MAGIC 0x5454424C // "LBTT"
+#define TRACE_VERSION 2 // Version 2 adds the start time.
+
+// Little-endian encoding helpers for the trace file format.
+
+static void _put_u32(LocalVector<uint8_t> &r_buf, uint32_t p_value) {
+	for (int i = 0; i < 4; i++) {
+		r_buf.push_back((p_value >> (i * 8)) & 0xFF);
+	}
+}
+
+static void _put_string(LocalVector<uint8_t> &r_buf, const String &p_string) {
+	CharString utf8 = p_string.utf8();
+	_put_u32(r_buf, utf8.length());
+	for (int i = 0; i < utf8.length(); i++) {
+		r_buf.push_back(uint8_t(utf8.get_data()[i]));
+	}
+}
+
+struct TraceReader {
+	const uint8_t *ptr = nullptr;
+	int64_t size = 0;
+	int64_t pos = 0;
+	bool failed = false;
+
+	uint32_t get_u32() {
+		if (pos + 4 > size) {
+			failed = true;
+			return 0;
+		}
+		uint32_t value = 0;
+		for (int i = 0; i < 4; i++) {
+			value |= uint32_t(ptr[pos + i]) << (i * 8);
+		}
+		pos += 4;
+		return value;
+	}
+
+	String get_string() {
+		uint32_t len = get_u32();
+		if (failed || pos + len > size) {
+			failed = true;
+			return String();
+		}
+		String s = String::utf8((const char *)ptr + pos, len);
+		pos += len;
+		return s;
+	}
+};
+
+void BTTrace::set_capacity(int p_capacity) {
+	ERR_FAIL_COND_MSG(p_capacity < 1, "BTTrace: Capacity must be positive.");
+	capacity = p_capacity;
+	clear();
+}
+
+void BTTrace::build(const Ref<BTTask> &p_root) {
+	ERR_FAIL_COND(p_root.is_null());
+	tasks.clear();
+	_add_task(p_root);
+	ERR_FAIL_COND_MSG(tasks.size() > UINT16_MAX + 1u, "BTTrace: Too many tasks to trace.");
+	_compute_subtree_end(0);
+	clear();
+}
+
+void BTTrace::_add_task(const Ref<BTTask> &p_task) {
+	TaskInfo info;
+	info.name = p_task->get_task_name();
+	info.type_name = p_task->get_class();
+	info.num_children = p_task->get_child_count();
+	tasks.push_back(info);
+	for (int i = 0; i < p_task->get_child_count(); i++) {
+		_add_task(p_task->get_child(i));
+	}
+}
+
+int BTTrace::_compute_subtree_end(int p_index) {
+	int next = p_index + 1;
+	for (int i = 0; i < tasks[p_index].num_children && next < (int)tasks.size(); i++) {
+		next = _compute_subtree_end(next);
+	}
+	tasks[p_index].subtree_end = next;
+	return next;
+}
+
+void BTTrace::record(uint32_t p_task_index, BT::Status p_old_status, BT::Status p_new_status) {
+	// * Written by the thread updating the instance - instances aren't updated concurrently.
+	Record &r = records[write_pos];
+	r.time_msec = uint32_t((Time::get_singleton()->get_ticks_usec() - start_usec) / 1000);
+	r.task_index = p_task_index;
+	r.old_status = p_old_status;
+	r.new_status = p_new_status;
+	write_pos = (write_pos + 1) % capacity;
+	record_count = MIN(record_count + 1, capacity);
+}
+
+String BTTrace::get_task_name(int p_index) const {
+	ERR_FAIL_INDEX_V(p_index, (int)tasks.size(), String());
+	return tasks[p_index].name;
+}
+
+String BTTrace::get_task_type(int p_index) const {
+	ERR_FAIL_INDEX_V(p_index, (int)tasks.size(), String());
+	return tasks[p_index].type_name;
+}
+
+int BTTrace::get_task_child_count(int p_index) const {
+	ERR_FAIL_INDEX_V(p_index, (int)tasks.size(), 0);
+	return tasks[p_index].num_children;
+}
+
+Dictionary BTTrace::get_record(int p_index) const {
+	ERR_FAIL_INDEX_V(p_index, (int)record_count, Dictionary());
+	const Record &r = get_record_unchecked(p_index);
+	Dictionary d;
+	d["time_msec"] = r.time_msec;
+	d["task_index"] = r.task_index;
+	d["old_status"] = r.old_status;
+	d["new_status"] = r.new_status;
+	return d;
+}
+
+PackedInt32Array BTTrace::get_statuses_at(int p_record_count) const {
+	PackedInt32Array statuses;
+	statuses.resize(tasks.size());
+	statuses.fill(BT::FRESH);
+	const int count = CLAMP(p_record_count, 0, (int)record_count);
+	for (int i = 0; i < count; i++) {
+		const Record &r = get_record_unchecked(i);
+		if (r.task_index >= tasks.size()) {
+			continue;
+		}
+		if (r.old_status != BT::RUNNING) {
+			// * Entering a task resets its children, like BTTask::execute() does.
+			for (int j = r.task_index + 1; j < tasks[r.task_index].subtree_end; j++) {
+				statuses.set(j, BT::FRESH);
+			}
+		}
+		statuses.set(r.task_index, r.new_status);
+	}
+	return statuses;
+}
+
+void BTTrace::clear() {
+	records.resize(capacity);
+	write_pos = 0;
+	record_count = 0;
+	start_usec = Time::get_singleton()->get_ticks_usec();
+}
+
+PackedByteArray BTTrace::to_bytes() const {
+	LocalVector<uint8_t> buf;
+	_put_u32(buf, TRACE_MAGIC);
+	_put_u32(buf, TRACE_VERSION);
+	_put_u32(buf, uint32_t(start_usec));
+	_put_u32(buf, uint32_t(start_usec >> 32));
+	_put_u32(buf, tasks.size());
+	for (const TaskInfo &info : tasks) {
+		_put_string(buf, info.name);
+		_put_string(buf, info.type_name);
+		_put_u32(buf, info.num_children);
+	}
+	_put_u32(buf, record_count);
+	for (uint32_t i = 0; i < record_count; i++) {
+		const Record &r = get_record_unchecked(i);
+		_put_u32(buf, r.time_msec);
+		_put_u32(buf, uint32_t(r.task_index) | (uint32_t(r.old_status) << 16) | (uint32_t(r.new_status) << 24));
+	}
+
+	PackedByteArray bytes;
+	bytes.resize(buf.size());
+	memcpy(bytes.ptrw(), buf.ptr(), buf.size());
+	return bytes;
+}
+
+Error BTTrace::from_bytes(const PackedByteArray &p_bytes) {
+	TraceReader reader;
+	reader.ptr = p_bytes.ptr();
+	reader.size = p_bytes.size();
+	ERR_FAIL_COND_V_MSG(reader.get_u32() != TRACE_MAGIC, ERR_FILE_UNRECOGNIZED, "BTTrace: Not a behavior tree trace.");
+	const uint32_t version = reader.get_u32();
+	ERR_FAIL_COND_V_MSG(version < 1 || version > TRACE_VERSION, ERR_FILE_UNRECOGNIZED, "BTTrace: Unsupported trace version.");
+	uint64_t new_start_usec = 0;
+	if (version >= 2) {
+		new_start_usec = reader.get_u32();
+		new_start_usec |= uint64_t(reader.get_u32()) << 32;
+	}
+
+	LocalVector<TaskInfo> new_tasks;
+	uint32_t num_tasks = reader.get_u32();
+	ERR_FAIL_COND_V(num_tasks > UINT16_MAX + 1u, ERR_FILE_CORRUPT);
+	for (uint32_t i = 0; i < num_tasks && !reader.failed; i++) {
+		TaskInfo info;
+		info.name = reader.get_string();
+		info.type_name = reader.get_string();
+		info.num_children = reader.get_u32();
+		new_tasks.push_back(info);
+	}
+	uint32_t num_records = reader.get_u32();
+	ERR_FAIL_COND_V_MSG(reader.failed || reader.size - reader.pos != int64_t(num_records) * 8, ERR_FILE_CORRUPT, "BTTrace: Trace data is corrupt.");
+
+	tasks = new_tasks;
+	if (!tasks.is_empty()) {
+		_compute_subtree_end(0);
+	}
+	capacity = MAX(num_records, 1u);
+	clear();
+	start_usec = new_start_usec;
+	for (uint32_t i = 0; i < num_records; i++) {
+		Record &r = records[i];
+		r.time_msec = reader.get_u32();
+		uint32_t packed = reader.get_u32();
+		r.task_index = packed & 0xFFFF;
+		r.old_status = (packed >> 16) & 0xFF;
+		r.new_status = (packed >> 24) & 0xFF;
+	}
+	record_count = num_records;
+	write_pos = num_records % capacity;
+	return OK;
+}
+
+Error BTTrace::save(const String &p_path) const {
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::WRITE);
+	ERR_FAIL_COND_V_MSG(f.is_null(), ERR_CANT_CREATE, "BTTrace: Can't open file for writing: " + p_path);
+	f->store_buffer(to_bytes());
+	return OK;
+}
+
+Ref<BTTrace> BTTrace::load(const String &p_path) {
+	PackedByteArray bytes = FileAccess::get_file_as_bytes(p_path);
+	ERR_FAIL_COND_V_MSG(bytes.is_empty(), nullptr, "BTTrace: Can't read file: " + p_path);
+	Ref<BTTrace> trace;
+	trace.instantiate();
+	if (trace->from_bytes(bytes) != OK) {
+		return nullptr;
+	}
+	return trace;
+}
+
+static const char *_status_name(uint8_t p_status) {
+	switch (p_status) {
+		case BT::RUNNING:
+			return "RUNNING";
+		case BT::FAILURE:
+			return "FAILURE";
+		case BT::SUCCESS:
+			return "SUCCESS";
+		default:
+			return "FRESH";
+	}
+}
+
+static Dictionary _make_complete_event(const String &p_name, const String &p_category, int p_track, uint64_t p_ts, uint64_t p_dur, uint8_t p_status) {
+	Dictionary event;
+	event["name"] = p_name;
+	event["cat"] = p_category;
+	event["ph"] = "X";
+	event["pid"] = 1;
+	event["tid"] = p_track;
+	event["ts"] = int64_t(p_ts);
+	event["dur"] = int64_t(p_dur);
+	Dictionary args;
+	args["status"] = _status_name(p_status);
+	event["args"] = args;
+	return event;
+}
+
+String BTTrace::to_chrome_trace(const TypedArray<BTTrace> &p_traces, const PackedStringArray &p_track_names) {
+	// * Timestamps are relative to the earliest trace.
+	uint64_t base_usec = UINT64_MAX;
+	for (int i = 0; i < p_traces.size(); i++) {
+		Ref<BTTrace> trace = p_traces[i];
+		ERR_FAIL_COND_V_MSG(trace.is_null(), String(), "BTTrace: Can't convert a null trace.");
+		base_usec = MIN(base_usec, trace->start_usec);
+	}
+
+	Array events;
+	LocalVector<int64_t> entered_at;
+	for (int i = 0; i < p_traces.size(); i++) {
+		Ref<BTTrace> trace = p_traces[i];
+		const int track = i + 1;
+		Dictionary metadata;
+		metadata["name"] = "thread_name";
+		metadata["ph"] = "M";
+		metadata["pid"] = 1;
+		metadata["tid"] = track;
+		Dictionary metadata_args;
+		metadata_args["name"] = i < p_track_names.size() ? p_track_names[i] : vformat("Instance %d", i);
+		metadata["args"] = metadata_args;
+		events.push_back(metadata);
+
+		// Tasks that stay RUNNING become complete events, others finish in a single tick and have no duration.
+		entered_at.resize(trace->tasks.size());
+		for (int64_t &t : entered_at) {
+			t = -1;
+		}
+		const uint64_t offset_usec = trace->start_usec - base_usec;
+		uint64_t last_ts = 0;
+		for (int r = 0; r < trace->get_record_count(); r++) {
+			const Record &rec = trace->get_record_unchecked(r);
+			if (rec.task_index >= trace->tasks.size()) {
+				continue;
+			}
+			const TaskInfo &info = trace->tasks[rec.task_index];
+			const uint64_t ts = offset_usec + uint64_t(rec.time_msec) * 1000;
+			last_ts = ts;
+			if (rec.new_status == BT::RUNNING && rec.old_status != BT::RUNNING) {
+				entered_at[rec.task_index] = ts;
+			} else if (rec.old_status == BT::RUNNING) {
+				// * Entered before the oldest record in the buffer if unknown.
+				const uint64_t start = entered_at[rec.task_index] >= 0 ? uint64_t(entered_at[rec.task_index]) : offset_usec;
+				events.push_back(_make_complete_event(info.name, info.type_name, track, start, ts - start, rec.new_status));
+				entered_at[rec.task_index] = -1;
+			} else if (rec.new_status != BT::FRESH) {
+				events.push_back(_make_complete_event(info.name, info.type_name, track, ts, 0, rec.new_status));
+			}
+		}
+		for (uint32_t t = 0; t < entered_at.size(); t++) {
+			if (entered_at[t] >= 0) {
+				events.push_back(_make_complete_event(trace->tasks[t].name, trace->tasks[t].type_name, track, entered_at[t], last_ts - entered_at[t], BT::RUNNING));
+			}
+		}
+	}
+
+	Dictionary document;
+	document["traceEvents"] = events;
+	document["displayTimeUnit"] = "ms";
+	return JSON::stringify(document);
+}
+
+void BTTrace::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_capacity", "capacity"), &BTTrace::set_capacity);
+	ClassDB::bind_method(D_METHOD("get_capacity"), &BTTrace::get_capacity);
+	ClassDB::bind_method(D_METHOD("get_task_count"), &BTTrace::get_task_count);
+	ClassDB::bind_method(D_METHOD("get_task_name", "task_index"), &BTTrace::get_task_name);
+	ClassDB::bind_method(D_METHOD("get_task_type", "task_index"), &BTTrace::get_task_type);
+	ClassDB::bind_method(D_METHOD("get_task_child_count", "task_index"), &BTTrace::get_task_child_count);
+	ClassDB::bind_method(D_METHOD("get_record_count"), &BTTrace::get_record_count);
+	ClassDB::bind_method(D_METHOD("get_record", "index"), &BTTrace::get_record);
+	ClassDB::bind_method(D_METHOD("get_statuses_at", "record_count"), &BTTrace::get_statuses_at);
+	ClassDB::bind_method(D_METHOD("clear"), &BTTrace::clear);
+	ClassDB::bind_method(D_METHOD("to_bytes"), &BTTrace::to_bytes);
+	ClassDB::bind_method(D_METHOD("from_bytes", "bytes"), &BTTrace::from_bytes);
+	ClassDB::bind_method(D_METHOD("save", "path"), &BTTrace::save);
+	ClassDB::bind_static_method("BTTrace", D_METHOD("load", "path"), &BTTrace::load);
+	ClassDB::bind_static_method("BTTrace", D_METHOD("to_chrome_trace", "traces", "track_names"), &BTTrace::to_chrome_trace, DEFVAL(PackedStringArray()));
+	ClassDB::bind_method(D_METHOD("get_start_usec"), &BTTrace::get_start_usec);
+
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "capacity", PROPERTY_HINT_RANGE, "1,65536,1,or_greater"), "set_capacity", "get_capacity");
+}
@@ -0,0 +1,97 @@
+/**
+ * bt_trace.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef BT_TRACE_H
+#define BT_TRACE_H
+
+#include "tasks/bt_task.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/object/ref_counted.h"
+#include "core/templates/local_vector.h"
+#include "core/variant/typed_array.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/variant/typed_array.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+// Ring buffer of task status transitions of a BTInstance. Recording is only available in debug builds.
+class BTTrace : public RefCounted {
+	GDCLASS(BTTrace, RefCounted);
+
+public:
+	// 8 bytes per transition.
+	struct Record {
+		uint32_t time_msec = 0; // Since the trace was built.
+		uint16_t task_index = 0;
+		uint8_t old_status = 0;
+		uint8_t new_status = 0;
+	};
+
+private:
+	struct TaskInfo {
+		String name;
+		String type_name;
+		int num_children = 0;
+		int subtree_end = 0; // Index one past the last descendant.
+	};
+
+	LocalVector<TaskInfo> tasks;
+	LocalVector<Record> records;
+	uint32_t capacity = 4096;
+	uint32_t write_pos = 0;
+	uint32_t record_count = 0;
+	uint64_t start_usec = 0;
+
+	void _add_task(const Ref<BTTask> &p_task);
+	int _compute_subtree_end(int p_index);
+
+protected:
+	static void _bind_methods();
+
+public:
+	void set_capacity(int p_capacity);
+	int get_capacity() const { return capacity; }
+
+	// Lays out the tasks of p_root in depth-first order and clears the records.
+	void build(const Ref<BTTask> &p_root);
+	void record(uint32_t p_task_index, BT::Status p_old_status, BT::Status p_new_status);
+
+	int get_task_count() const { return tasks.size(); }
+	String get_task_name(int p_index) const;
+	String get_task_type(int p_index) const;
+	int get_task_child_count(int p_index) const;
+	// Engine ticks when the trace was started. Traces recorded in the same process share the clock.
+	int64_t get_start_usec() const { return start_usec; }
+
+	// Records are indexed from the oldest one that is still in the buffer.
+	int get_record_count() const { return record_count; }
+	const Record &get_record_unchecked(int p_index) const { return records[(write_pos + capacity - record_count + p_index) % capacity]; }
+	Dictionary get_record(int p_index) const;
+	// Returns the status of each task after p_record_count records are replayed.
+	PackedInt32Array get_statuses_at(int p_record_count) const;
+
+	void clear();
+
+	PackedByteArray to_bytes() const;
+	Error from_bytes(const PackedByteArray &p_bytes);
+	Error save(const String &p_path) const;
+	static Ref<BTTrace> load(const String &p_path);
+
+	// Converts traces into the Chrome trace event format, with one track per trace. Meant to be run offline,
+	// on traces loaded from files, since it builds the whole JSON document in memory.
+	static String to_chrome_trace(const TypedArray<BTTrace> &p_traces, const PackedStringArray &p_track_names = PackedStringArray());
+};
+
+#endif // BT_TRACE_H
@@ -0,0 +1,137 @@
+/**
+ * bt_tree_monitor.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "bt_tree_monitor.h"
+
+#include "../util/limbo_compat.h"
+#include "../util/limbo_string_names.h"
+#include "../util/limbo_ticks.h"
+#include "bt_instance.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/config/project_settings.h"
+#include "main/performance.h"
+#include "scene/main/scene_tree.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/performance.hpp>
+#include <godot_cpp/classes/project_settings.hpp>
+#include <godot_cpp/classes/scene_tree.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+bool BTTreeMonitor::enabled = false;
+HashMap<String, BTTreeMonitor::TreeStats> BTTreeMonitor::trees;
+LocalVector<double> BTTreeMonitor::samples;
+uint64_t BTTreeMonitor::connected_tree_id = 0;
+
+static const char *metric_names[BTTreeMonitor::METRIC_MAX] = { "instances", "total_ms", "mean_ms", "p95_ms", "max_ms" };
+
+void BTTreeMonitor::initialize() {
+	enabled = int(GLOBAL_DEF(PropertyInfo(Variant::INT, "limbo_ai/behavior_tree/performance_monitors", PROPERTY_HINT_ENUM, "Per Instance,Per Tree"), 0)) == 1;
+}
+
+String BTTreeMonitor::_get_monitor_id(const String &p_tree_path, Metric p_metric) {
+	String label = p_tree_path.is_empty() ? String("unsaved") : p_tree_path.trim_prefix("res://").replace("/", "_");
+	return vformat("LimboAI/%s|%s", metric_names[p_metric], label);
+}
+
+void BTTreeMonitor::add_instance(BTInstance *p_instance) {
+	ERR_FAIL_NULL(p_instance);
+	const String &path = p_instance->get_source_bt_path();
+	TreeStats *stats = trees.getptr(path);
+	if (stats == nullptr) {
+		stats = &trees.insert(path, TreeStats())->value;
+		for (int m = 0; m < METRIC_MAX; m++) {
+			String id = _get_monitor_id(path, Metric(m));
+			if (!Performance::get_singleton()->has_custom_monitor(id)) {
+				PERFORMANCE_ADD_CUSTOM_MONITOR(id, callable_mp_static(&BTTreeMonitor::_get_metric).bind(path, m));
+			}
+		}
+	}
+	if (stats->instances.find(p_instance) == -1) {
+		stats->instances.push_back(p_instance);
+	}
+
+	SceneTree *tree = SCENE_TREE();
+	if (tree && uint64_t(tree->get_instance_id()) != connected_tree_id) {
+		tree->connect(LW_NAME(process_frame), callable_mp_static(&BTTreeMonitor::_on_process_frame));
+		connected_tree_id = tree->get_instance_id();
+	}
+}
+
+void BTTreeMonitor::remove_instance(BTInstance *p_instance) {
+	const String &path = p_instance->get_source_bt_path();
+	TreeStats *stats = trees.getptr(path);
+	if (stats == nullptr) {
+		return;
+	}
+	stats->instances.erase(p_instance);
+	if (stats->instances.is_empty()) {
+		for (int m = 0; m < METRIC_MAX; m++) {
+			String id = _get_monitor_id(path, Metric(m));
+			if (Performance::get_singleton()->has_custom_monitor(id)) {
+				Performance::get_singleton()->remove_custom_monitor(id);
+			}
+		}
+		trees.erase(path);
+	}
+}
+
+void BTTreeMonitor::update() {
+	for (KeyValue<String, TreeStats> &kv : trees) {
+		TreeStats &stats = kv.value;
+		samples.clear();
+		double total_usec = 0.0;
+		double total_n = 0.0;
+		double max_usec = 0.0;
+		for (BTInstance *inst : stats.instances) {
+#ifdef DEBUG_ENABLED
+			if (inst->update_count > 0) {
+				const double usec = LimboTicks::to_usec(inst->update_ticks_acc);
+				samples.push_back(usec / inst->update_count);
+				total_usec += usec;
+				total_n += inst->update_count;
+				max_usec = MAX(max_usec, double(LimboTicks::to_usec(inst->update_ticks_max)));
+			}
+			inst->update_ticks_acc = 0;
+			inst->update_count = 0;
+			inst->update_ticks_max = 0;
+#endif
+		}
+		stats.metrics[METRIC_INSTANCES] = stats.instances.size();
+		stats.metrics[METRIC_TOTAL_MS] = total_usec * 0.001;
+		stats.metrics[METRIC_MEAN_MS] = total_n > 0.0 ? total_usec * 0.001 / total_n : 0.0;
+		stats.metrics[METRIC_MAX_MS] = max_usec * 0.001;
+		if (samples.is_empty()) {
+			stats.metrics[METRIC_P95_MS] = 0.0;
+		} else {
+			// * Percentile of the mean update times of the instances.
+			samples.sort();
+			uint32_t idx = MIN(uint32_t(Math::ceil(samples.size() * 0.95)), samples.size()) - 1;
+			stats.metrics[METRIC_P95_MS] = samples[idx] * 0.001;
+		}
+	}
+}
+
+double BTTreeMonitor::get_metric(const String &p_tree_path, Metric p_metric) {
+	ERR_FAIL_INDEX_V(p_metric, METRIC_MAX, 0.0);
+	const TreeStats *stats = trees.getptr(p_tree_path);
+	return stats ? stats->metrics[p_metric] : 0.0;
+}
+
+double BTTreeMonitor::_get_metric(const String &p_tree_path, int p_metric) {
+	return get_metric(p_tree_path, Metric(p_metric));
+}
+
+void BTTreeMonitor::_on_process_frame() {
+	update();
+}
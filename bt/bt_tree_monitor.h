@@ -0,0 +1,71 @@
+/**
+ * bt_tree_monitor.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef BT_TREE_MONITOR_H
+#define BT_TREE_MONITOR_H
+
+#ifdef LIMBOAI_MODULE
+#include "core/string/ustring.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/variant/string.hpp>
+using namespace godot;
+#endif // LIMBOAI_GDEXTENSION
+
+class BTInstance;
+
+// Performance monitors aggregated over all monitored instances of the same BehaviorTree resource.
+// Used instead of per-instance monitors if limbo_ai/behavior_tree/performance_monitors is set to "Per Tree".
+class BTTreeMonitor {
+public:
+	enum Metric {
+		METRIC_INSTANCES,
+		METRIC_TOTAL_MS,
+		METRIC_MEAN_MS,
+		METRIC_P95_MS,
+		METRIC_MAX_MS,
+		METRIC_MAX,
+	};
+
+private:
+	struct TreeStats {
+		LocalVector<BTInstance *> instances;
+		// Values of the last frame.
+		double metrics[METRIC_MAX] = {};
+	};
+
+	static bool enabled;
+	static HashMap<String, TreeStats> trees;
+	static LocalVector<double> samples;
+	static uint64_t connected_tree_id;
+
+	static String _get_monitor_id(const String &p_tree_path, Metric p_metric);
+	static double _get_metric(const String &p_tree_path, int p_metric);
+	static void _on_process_frame();
+
+public:
+	static void initialize();
+	_FORCE_INLINE_ static bool is_enabled() { return enabled; }
+
+	static void add_instance(BTInstance *p_instance);
+	static void remove_instance(BTInstance *p_instance);
+
+	// Collects the update times of the last frame and resets them. Normally called on every process frame.
+	static void update();
+	static double get_metric(const String &p_tree_path, Metric p_metric);
+};
+
+#endif // BT_TREE_MONITOR_H
@@ -0,0 +1,116 @@
+/**
+ * bt_validator.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "bt_validator.h"
+
+#include "../util/limbo_compat.h"
+#include "tasks/utility/bt_fail.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/config/project_settings.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/project_settings.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+bool BTValidator::enabled = false;
+HashSet<String> BTValidator::reported;
+
+void BTValidator::initialize() {
+	const int mode = GLOBAL_DEF(PropertyInfo(Variant::INT, "limbo_ai/behavior_tree/runtime_validation", PROPERTY_HINT_ENUM, "Disabled,Debug Builds Only,Always"), MODE_DEBUG_ONLY);
+#ifdef DEBUG_ENABLED
+	enabled = mode != MODE_DISABLED;
+#else
+	enabled = mode == MODE_ALWAYS;
+#endif
+}
+
+void BTValidator::_collect_written_vars(const BTTask *p_task, HashSet<StringName> &r_written) {
+	LocalVector<StringName> read_vars;
+	LocalVector<StringName> written_vars;
+	p_task->validate_runtime(read_vars, written_vars);
+	for (const StringName &var : written_vars) {
+		r_written.insert(var);
+	}
+	for (int i = 0; i < p_task->get_child_count(); i++) {
+		_collect_written_vars(p_task->get_child(i).ptr(), r_written);
+	}
+}
+
+String BTValidator::_find_error(const BTTask *p_task, const HashSet<StringName> &p_written) {
+	LocalVector<StringName> read_vars;
+	LocalVector<StringName> written_vars;
+	String error = p_task->validate_runtime(read_vars, written_vars);
+	if (!error.is_empty()) {
+		return error;
+	}
+
+	// * Variables can also be created at runtime by tasks in this tree, so only the rest must exist up front.
+	const Ref<Blackboard> bb = p_task->get_blackboard();
+	for (const StringName &var : read_vars) {
+		if (!p_written.has(var) && (bb.is_null() || !bb->has_var(var))) {
+			return vformat("Blackboard variable \"%s\" doesn't exist.", var);
+		}
+	}
+	return String();
+}
+
+Ref<BTTask> BTValidator::_make_stub(const Ref<BTTask> &p_task, const String &p_error, const String &p_tree_path) {
+	const String task_name = p_task->get_task_name();
+	const String key = p_tree_path + "|" + task_name + "|" + p_error;
+	if (!reported.has(key)) {
+		reported.insert(key);
+		ERR_PRINT(vformat("BehaviorTree: Task \"%s\" in \"%s\" is replaced by BTFail: %s", task_name, p_tree_path, p_error));
+	}
+
+	Ref<BTFail> stub = memnew(BTFail);
+	stub->set_custom_name(task_name + " [invalid]");
+	stub->initialize(p_task->get_agent(), p_task->get_blackboard(), p_task->get_scene_root());
+	return stub;
+}
+
+void BTValidator::_validate_children(BTTask *p_task, const HashSet<StringName> &p_written, const String &p_tree_path, int &r_replaced) {
+	for (int i = 0; i < p_task->data.children.size(); i++) {
+		BTTask *child = p_task->data.children[i].ptr();
+		const String error = _find_error(child, p_written);
+		if (error.is_empty()) {
+			_validate_children(child, p_written, p_tree_path, r_replaced);
+			continue;
+		}
+
+		Ref<BTTask> stub = _make_stub(p_task->data.children[i], error, p_tree_path);
+		stub->data.parent = p_task;
+		stub->data.index = i;
+		child->data.parent = nullptr;
+		child->data.index = -1;
+		p_task->data.children.write[i] = stub;
+		p_task->data.compiled_children = nullptr;
+		r_replaced++;
+	}
+}
+
+int BTValidator::validate(Ref<BTTask> &r_root, const String &p_tree_path) {
+	ERR_FAIL_COND_V(r_root.is_null(), 0);
+
+	HashSet<StringName> written;
+	_collect_written_vars(r_root.ptr(), written);
+
+	const String error = _find_error(r_root.ptr(), written);
+	if (!error.is_empty()) {
+		r_root = _make_stub(r_root, error, p_tree_path);
+		return 1;
+	}
+
+	int replaced = 0;
+	_validate_children(r_root.ptr(), written, p_tree_path, replaced);
+	return replaced;
+}
@@ -0,0 +1,55 @@
+/**
+ * bt_validator.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef BT_VALIDATOR_H
+#define BT_VALIDATOR_H
+
+#include "tasks/bt_task.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/templates/hash_set.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/templates/hash_set.hpp>
+using namespace godot;
+#endif // LIMBOAI_GDEXTENSION
+
+// One-time check of a new instance, controlled by the "limbo_ai/behavior_tree/runtime_validation" project setting.
+// Tasks that would fail on every tick - because of their configuration, or because they read a blackboard variable
+// that neither the blackboard nor any task in the tree provides - are reported once and replaced by BTFail.
+class BTValidator {
+public:
+	enum Mode {
+		MODE_DISABLED,
+		MODE_DEBUG_ONLY,
+		MODE_ALWAYS,
+	};
+
+private:
+	static bool enabled;
+	static HashSet<String> reported;
+
+	static void _collect_written_vars(const BTTask *p_task, HashSet<StringName> &r_written);
+	static String _find_error(const BTTask *p_task, const HashSet<StringName> &p_written);
+	static Ref<BTTask> _make_stub(const Ref<BTTask> &p_task, const String &p_error, const String &p_tree_path);
+	static void _validate_children(BTTask *p_task, const HashSet<StringName> &p_written, const String &p_tree_path, int &r_replaced);
+
+public:
+	static void initialize();
+	static _FORCE_INLINE_ bool is_enabled() { return enabled; }
+
+	// Validates an initialized tree; r_root is replaced if the root task itself is invalid.
+	// Returns the number of replaced tasks.
+	static int validate(Ref<BTTask> &r_root, const String &p_tree_path);
+};
+
+#endif // BT_VALIDATOR_H
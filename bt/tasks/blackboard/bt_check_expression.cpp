@@ -0,0 +1,53 @@
+/**
+ * bt_check_expression.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "bt_check_expression.h"
+
+void BTCheckExpression::set_expression_string(const String &p_expression_string) {
+	expression_string = p_expression_string;
+	if (expression_string.is_empty()) {
+		expression.clear();
+	} else {
+		expression.parse(expression_string);
+	}
+	_task_changed();
+}
+
+PackedStringArray BTCheckExpression::get_configuration_warnings() {
+	PackedStringArray warnings = BTCondition::get_configuration_warnings();
+	if (expression_string.is_empty()) {
+		warnings.append("Expression string is not set.");
+	} else if (!expression.is_valid()) {
+		warnings.append("Failed to parse expression: " + expression.get_error_text());
+	}
+	return warnings;
+}
+
+String BTCheckExpression::_generate_name() {
+	if (expression_string.is_empty()) {
+		return "CheckExpression ???";
+	}
+	return "Check if: " + expression_string;
+}
+
+BT::Status BTCheckExpression::_tick(double p_delta) {
+	LIMBO_ERR_FAIL_COND_V_MSG(!expression.is_valid(), FAILURE, "BTCheckExpression: Failed to parse expression: " + expression.get_error_text());
+	bool result = false;
+	LIMBO_ERR_FAIL_COND_V_MSG(!expression.evaluate_bool(get_blackboard(), get_agent(), result), FAILURE, "BTCheckExpression: Failed to evaluate expression: " + expression.get_error_text());
+	return result ? SUCCESS : FAILURE;
+}
+
+void BTCheckExpression::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_expression_string", "expression_string"), &BTCheckExpression::set_expression_string);
+	ClassDB::bind_method(D_METHOD("get_expression_string"), &BTCheckExpression::get_expression_string);
+
+	ADD_PROPERTY(PropertyInfo(Variant::STRING, "expression_string"), "set_expression_string", "get_expression_string");
+}
@@ -0,0 +1,40 @@
+/**
+ * bt_check_expression.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef BT_CHECK_EXPRESSION_H
+#define BT_CHECK_EXPRESSION_H
+
+#include "../bt_condition.h"
+
+#include "../../../util/limbo_expression.h"
+
+class BTCheckExpression : public BTCondition {
+	GDCLASS(BTCheckExpression, BTCondition);
+	TASK_CATEGORY(Blackboard);
+
+private:
+	String expression_string;
+	LimboExpression expression;
+
+protected:
+	static void _bind_methods();
+
+	virtual String _generate_name() override;
+	virtual Status _tick(double p_delta) override;
+
+public:
+	virtual PackedStringArray get_configuration_warnings() override;
+
+	void set_expression_string(const String &p_expression_string);
+	String get_expression_string() const { return expression_string; }
+};
+
+#endif // BT_CHECK_EXPRESSION_H
@@ -15,7 +15,11 @@
 
 void BTCheckTrigger::set_variable(const StringName &p_variable) {
 	variable = p_variable;
-	emit_changed();
+	variable_handle = BBVarHandle();
+	variable_handle.name = p_variable;
+	trigger_scope = nullptr;
+	trigger_mask = 0;
+	_task_changed();
 }
 
 PackedStringArray BTCheckTrigger::get_configuration_warnings() {
@@ -26,6 +30,22 @@ PackedStringArray BTCheckTrigger::get_configuration_warnings() {
 	return warnings;
 }
 
+String BTCheckTrigger::validate_runtime(LocalVector<StringName> &r_read_vars, LocalVector<StringName> &r_written_vars) const {
+	const String error = BTCondition::validate_runtime(r_read_vars, r_written_vars);
+	if (!error.is_empty()) {
+		return error;
+	}
+	if (variable == StringName()) {
+		return "`variable` is not set.";
+	}
+	// * Triggers declared in the blackboard aren't variables.
+	const Ref<Blackboard> bb = get_blackboard();
+	if (bb.is_null() || !bb->has_trigger(variable)) {
+		r_read_vars.push_back(variable);
+	}
+	return String();
+}
+
 String BTCheckTrigger::_generate_name() {
 	if (variable == StringName()) {
 		return "CheckTrigger ???";
@@ -33,11 +53,19 @@ String BTCheckTrigger::_generate_name() {
 	return "CheckTrigger " + LimboUtility::get_singleton()->decorate_var(variable);
 }
 
+void BTCheckTrigger::_setup() {
+	variable_handle = get_blackboard()->get_var_handle(variable);
+	trigger_mask = get_blackboard()->find_trigger(variable, trigger_scope);
+}
+
 BT::Status BTCheckTrigger::_tick(double p_delta) {
-	ERR_FAIL_COND_V_MSG(variable == StringName(), FAILURE, "BBCheckVar: `variable` is not set.");
-	Variant trigger_value = get_blackboard()->get_var(variable, false);
+	LIMBO_ERR_FAIL_COND_V_MSG(variable == StringName(), FAILURE, "BBCheckVar: `variable` is not set.");
+	if (trigger_mask != 0) {
+		return trigger_scope->consume_trigger_mask(trigger_mask) ? SUCCESS : FAILURE;
+	}
+	Variant trigger_value = get_blackboard()->get_var_by_handle(variable_handle, false);
 	if (trigger_value == Variant(true)) {
-		get_blackboard()->set_var(variable, false);
+		_set_var_by_handle(variable_handle, false);
 		return SUCCESS;
 	}
 	return FAILURE;
@@ -17,21 +17,29 @@
 class BTCheckTrigger : public BTCondition {
 	GDCLASS(BTCheckTrigger, BTCondition);
 	TASK_CATEGORY(Blackboard);
+	TASK_THREAD_SAFE();
 
 private:
 	StringName variable;
+	BBVarHandle variable_handle;
+	// Set in _setup() if the trigger is declared in the blackboard - the scope is held by the task's blackboard.
+	Blackboard *trigger_scope = nullptr;
+	uint64_t trigger_mask = 0;
 
 protected:
 	static void _bind_methods();
 
 	virtual String _generate_name() override;
+	virtual void _setup() override;
 	virtual Status _tick(double p_delta) override;
+	virtual void _tick_batch(const TaskBatchContext &p_batch) override { _tick_batch_leaves(p_batch); }
 
 public:
 	void set_variable(const StringName &p_variable);
 	StringName get_variable() const { return variable; }
 
 	virtual PackedStringArray get_configuration_warnings() override;
+	virtual String validate_runtime(LocalVector<StringName> &r_read_vars, LocalVector<StringName> &r_written_vars) const override;
 };
 
 #endif // BT_CHECK_TRIGGER
@@ -13,17 +13,23 @@
 
 void BTCheckVar::set_variable(const StringName &p_variable) {
 	variable = p_variable;
-	emit_changed();
+	variable_handle = BBVarHandle();
+	variable_handle.name = p_variable;
+	last_variable_version = -1;
+	_task_changed();
 }
 
 void BTCheckVar::set_check_type(LimboUtility::CheckType p_check_type) {
 	check_type = p_check_type;
-	emit_changed();
+	last_variable_version = -1;
+	_task_changed();
 }
 
 void BTCheckVar::set_value(const Ref<BBVariant> &p_value) {
 	value = p_value;
-	emit_changed();
+	check_func = nullptr;
+	last_variable_version = -1;
+	_task_changed();
 	if (Engine::get_singleton()->is_editor_hint() && value.is_valid() &&
 			!value->is_connected(LW_NAME(changed), callable_mp((Resource *)this, &Resource::emit_changed))) {
 		value->connect(LW_NAME(changed), callable_mp((Resource *)this, &Resource::emit_changed));
@@ -41,6 +47,21 @@ PackedStringArray BTCheckVar::get_configuration_warnings() {
 	return warnings;
 }
 
+String BTCheckVar::validate_runtime(LocalVector<StringName> &r_read_vars, LocalVector<StringName> &r_written_vars) const {
+	const String error = BTCondition::validate_runtime(r_read_vars, r_written_vars);
+	if (!error.is_empty()) {
+		return error;
+	}
+	if (variable == StringName()) {
+		return "`variable` is not set.";
+	}
+	if (value.is_null()) {
+		return "`value` is not set.";
+	}
+	r_read_vars.push_back(variable);
+	return String();
+}
+
 String BTCheckVar::_generate_name() {
 	if (variable == StringName()) {
 		return "CheckVar ???";
@@ -51,16 +72,59 @@ String BTCheckVar::_generate_name() {
 			value.is_valid() ? Variant(value) : Variant("???"));
 }
 
-BT::Status BTCheckVar::_tick(double p_delta) {
-	ERR_FAIL_COND_V_MSG(variable == StringName(), FAILURE, "BTCheckVar: `variable` is not set.");
-	ERR_FAIL_COND_V_MSG(!value.is_valid(), FAILURE, "BTCheckVar: `value` is not set.");
+void BTCheckVar::_setup() {
+	variable_handle = get_blackboard()->get_var_handle(variable);
+	if (value.is_valid() && value->get_value_source() == BBParam::BLACKBOARD_VAR) {
+		value_handle = get_blackboard()->get_var_handle(value->get_variable());
+	}
+	check_func = LimboUtility::get_check_func(value.is_valid() ? value->get_type() : Variant::NIL);
+}
 
-	ERR_FAIL_COND_V_MSG(!get_blackboard()->has_var(variable), FAILURE, vformat("BTCheckVar: Blackboard variable doesn't exist: \"%s\". Returning FAILURE.", variable));
+static _FORCE_INLINE_ bool _is_shared_container(const Variant &p_value) {
+	return p_value.get_type() == Variant::ARRAY || p_value.get_type() == Variant::DICTIONARY;
+}
 
-	Variant left_value = get_blackboard()->get_var(variable, Variant());
+void BTCheckVar::_update_input_versions(int64_t &r_variable_version, int64_t &r_value_version) {
+	r_variable_version = get_blackboard()->get_var_version(variable_handle);
+	r_value_version = value_handle.name == StringName() ? 0 : get_blackboard()->get_var_version(value_handle);
+}
+
+bool BTCheckVar::_can_skip_reevaluation() {
+	if (last_variable_version < 0 || last_value_version < 0) {
+		return false;
+	}
+	int64_t variable_version;
+	int64_t value_version;
+	_update_input_versions(variable_version, value_version);
+	// Handles re-resolve on structural changes - compare the epoch too, variable may now refer to a different slot.
+	return variable_version == last_variable_version && value_version == last_value_version && last_epoch == variable_handle.epoch && (value_handle.name == StringName() || last_epoch == value_handle.epoch);
+}
+
+BT::Status BTCheckVar::_tick(double p_delta) {
+	LIMBO_ERR_FAIL_COND_V_MSG(variable == StringName(), FAILURE, "BTCheckVar: `variable` is not set.");
+	LIMBO_ERR_FAIL_COND_V_MSG(!value.is_valid(), FAILURE, "BTCheckVar: `value` is not set.");
+
+	Variant left_value;
+	LIMBO_ERR_FAIL_COND_V_MSG(!get_blackboard()->try_get_var_by_handle(variable_handle, left_value), FAILURE, vformat("BTCheckVar: Blackboard variable doesn't exist: \"%s\". Returning FAILURE.", variable));
 	Variant right_value = value->get_value(get_scene_root(), get_blackboard());
 
-	return LimboUtility::get_singleton()->perform_check(check_type, left_value, right_value) ? SUCCESS : FAILURE;
+	const StringName value_var = value->get_value_source() == BBParam::BLACKBOARD_VAR ? value->get_variable() : StringName();
+	if (unlikely(value_handle.name != value_var)) {
+		// Value parameter was reconfigured after setup.
+		value_handle = BBVarHandle();
+		value_handle.name = value_var;
+	}
+	_update_input_versions(last_variable_version, last_value_version);
+	last_epoch = variable_handle.epoch;
+	if (_is_shared_container(left_value) || _is_shared_container(right_value)) {
+		// May be modified in place, without bumping the variable version.
+		last_variable_version = -1;
+	}
+
+	if (unlikely(check_func == nullptr)) {
+		check_func = LimboUtility::get_check_func(value->get_type());
+	}
+	return check_func(check_type, left_value, right_value) ? SUCCESS : FAILURE;
 }
 
 void BTCheckVar::_bind_methods() {
@@ -20,20 +20,36 @@
 class BTCheckVar : public BTCondition {
 	GDCLASS(BTCheckVar, BTCondition);
 	TASK_CATEGORY(Blackboard);
+	TASK_THREAD_SAFE();
+	TASK_PURE();
 
 private:
 	StringName variable;
+	BBVarHandle variable_handle;
 	LimboUtility::CheckType check_type = LimboUtility::CheckType::CHECK_EQUAL;
 	Ref<BBVariant> value;
+	LimboUtility::CheckFunc check_func = nullptr; // Selected for the value type on setup.
+
+	// Input versions at the last tick, used to detect that the result can't have changed.
+	BBVarHandle value_handle;
+	int64_t last_variable_version = -1;
+	int64_t last_value_version = -1;
+	uint64_t last_epoch = 0;
+
+	void _update_input_versions(int64_t &r_variable_version, int64_t &r_value_version);
 
 protected:
 	static void _bind_methods();
 
 	virtual String _generate_name() override;
+	virtual void _setup() override;
 	virtual Status _tick(double p_delta) override;
+	virtual void _tick_batch(const TaskBatchContext &p_batch) override { _tick_batch_leaves(p_batch); }
+	virtual bool _can_skip_reevaluation() override;
 
 public:
 	virtual PackedStringArray get_configuration_warnings() override;
+	virtual String validate_runtime(LocalVector<StringName> &r_read_vars, LocalVector<StringName> &r_written_vars) const override;
 
 	void set_variable(const StringName &p_variable);
 	StringName get_variable() const { return variable; }
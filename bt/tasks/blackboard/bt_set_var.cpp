@@ -21,33 +21,46 @@ String BTSetVar::_generate_name() {
 			value.is_valid() ? Variant(value) : Variant("???"));
 }
 
+void BTSetVar::_setup() {
+	variable_handle = get_blackboard()->get_var_handle(variable);
+}
+
 BT::Status BTSetVar::_tick(double p_delta) {
-	ERR_FAIL_COND_V_MSG(variable == StringName(), FAILURE, "BTSetVar: `variable` is not set.");
-	ERR_FAIL_COND_V_MSG(!value.is_valid(), FAILURE, "BTSetVar: `value` is not set.");
+	LIMBO_ERR_FAIL_COND_V_MSG(variable == StringName(), FAILURE, "BTSetVar: `variable` is not set.");
+	LIMBO_ERR_FAIL_COND_V_MSG(!value.is_valid(), FAILURE, "BTSetVar: `value` is not set.");
 	Variant result;
 	Variant error_result = LW_NAME(error_value);
 	Variant right_value = value->get_value(get_scene_root(), get_blackboard(), error_result);
-	ERR_FAIL_COND_V_MSG(right_value == error_result, FAILURE, "BTSetVar: Failed to get parameter value. Returning FAILURE.");
+	LIMBO_ERR_FAIL_COND_V_MSG(right_value == error_result, FAILURE, "BTSetVar: Failed to get parameter value. Returning FAILURE.");
 	if (operation == LimboUtility::OPERATION_NONE) {
 		result = right_value;
 	} else if (operation != LimboUtility::OPERATION_NONE) {
-		Variant left_value = get_blackboard()->get_var(variable, error_result);
-		ERR_FAIL_COND_V_MSG(left_value == error_result, FAILURE, vformat("BTSetVar: Failed to get \"%s\" blackboard variable. Returning FAILURE.", variable));
+		// * Packed arrays are modified in place, without copying them through a Variant.
+		BBVariable *var = get_blackboard()->get_variable_for_write(variable_handle);
+		Variant *stored = var ? var->get_value_ptrw() : nullptr;
+		if (stored && stored->get_type() >= Variant::PACKED_BYTE_ARRAY && LimboUtility::perform_element_wise_operation(operation, *stored, right_value)) {
+			var->notify_value_changed();
+			return SUCCESS;
+		}
+		Variant left_value = get_blackboard()->get_var_by_handle(variable_handle, error_result);
+		LIMBO_ERR_FAIL_COND_V_MSG(left_value == error_result, FAILURE, vformat("BTSetVar: Failed to get \"%s\" blackboard variable. Returning FAILURE.", variable));
 		result = LimboUtility::get_singleton()->perform_operation(operation, left_value, right_value);
-		ERR_FAIL_COND_V_MSG(result == Variant(), FAILURE, "BTSetVar: Operation not valid. Returning FAILURE.");
+		LIMBO_ERR_FAIL_COND_V_MSG(result == Variant(), FAILURE, "BTSetVar: Operation not valid. Returning FAILURE.");
 	}
-	get_blackboard()->set_var(variable, result);
+	_set_var_by_handle(variable_handle, result);
 	return SUCCESS;
 };
 
 void BTSetVar::set_variable(const StringName &p_variable) {
 	variable = p_variable;
-	emit_changed();
+	variable_handle = BBVarHandle();
+	variable_handle.name = p_variable;
+	_task_changed();
 }
 
 void BTSetVar::set_value(const Ref<BBVariant> &p_value) {
 	value = p_value;
-	emit_changed();
+	_task_changed();
 	if (Engine::get_singleton()->is_editor_hint() && value.is_valid() &&
 			!value->is_connected(LW_NAME(changed), callable_mp((Resource *)this, &Resource::emit_changed))) {
 		value->connect(LW_NAME(changed), callable_mp((Resource *)this, &Resource::emit_changed));
@@ -56,7 +69,7 @@ void BTSetVar::set_value(const Ref<BBVariant> &p_value) {
 
 void BTSetVar::set_operation(LimboUtility::Operation p_operation) {
 	operation = p_operation;
-	emit_changed();
+	_task_changed();
 }
 
 PackedStringArray BTSetVar::get_configuration_warnings() {
@@ -70,6 +83,21 @@ PackedStringArray BTSetVar::get_configuration_warnings() {
 	return warnings;
 }
 
+String BTSetVar::validate_runtime(LocalVector<StringName> &r_read_vars, LocalVector<StringName> &r_written_vars) const {
+	const String error = BTAction::validate_runtime(r_read_vars, r_written_vars);
+	if (!error.is_empty()) {
+		return error;
+	}
+	if (variable == StringName()) {
+		return "`variable` is not set.";
+	}
+	if (value.is_null()) {
+		return "`value` is not set.";
+	}
+	r_written_vars.push_back(variable);
+	return String();
+}
+
 void BTSetVar::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_variable", "variable"), &BTSetVar::set_variable);
 	ClassDB::bind_method(D_METHOD("get_variable"), &BTSetVar::get_variable);
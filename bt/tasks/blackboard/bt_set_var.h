@@ -20,9 +20,12 @@
 class BTSetVar : public BTAction {
 	GDCLASS(BTSetVar, BTAction);
 	TASK_CATEGORY(Blackboard);
+	TASK_THREAD_SAFE();
+	TASK_PURE();
 
 private:
 	StringName variable;
+	BBVarHandle variable_handle;
 	Ref<BBVariant> value;
 	LimboUtility::Operation operation = LimboUtility::OPERATION_NONE;
 
@@ -30,10 +33,13 @@ protected:
 	static void _bind_methods();
 
 	virtual String _generate_name() override;
+	virtual void _setup() override;
 	virtual Status _tick(double p_delta) override;
+	virtual void _tick_batch(const TaskBatchContext &p_batch) override { _tick_batch_leaves(p_batch); }
 
 public:
 	virtual PackedStringArray get_configuration_warnings() override;
+	virtual String validate_runtime(LocalVector<StringName> &r_read_vars, LocalVector<StringName> &r_written_vars) const override;
 
 	void set_variable(const StringName &p_variable);
 	StringName get_variable() const { return variable; }
@@ -0,0 +1,83 @@
+/**
+ * bt_async_action.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "bt_async_action.h"
+
+#include "../../util/limbo_string_names.h"
+
+BT::Status BTAsyncAction::_to_status(const Variant &p_result) {
+	switch (p_result.get_type()) {
+		case Variant::NIL: {
+			return SUCCESS;
+		}
+		case Variant::BOOL: {
+			return bool(p_result) ? SUCCESS : FAILURE;
+		}
+		case Variant::INT: {
+			const int status = p_result;
+			ERR_FAIL_COND_V_MSG(status != SUCCESS && status != FAILURE, FAILURE, "BTAsyncAction: _run() must return SUCCESS or FAILURE.");
+			return Status(status);
+		}
+		default: {
+			ERR_FAIL_V_MSG(FAILURE, vformat("BTAsyncAction: Unexpected result of _run(): %s.", p_result));
+		}
+	}
+}
+
+void BTAsyncAction::_on_run_completed(const Variant &p_result, uint32_t p_run_id) {
+	if (p_run_id != run_id) {
+		return; // Task was aborted or restarted while the coroutine was suspended.
+	}
+	coroutine = Variant();
+	completed = true;
+	result = _to_status(p_result);
+	_wake_instance(instance_id);
+}
+
+BT::Status BTAsyncAction::_tick(double p_delta) {
+	// Started here rather than in _enter(), so that scripts may still override _enter() and _exit().
+	if (get_status() != RUNNING) {
+		run_id += 1;
+		completed = false;
+		coroutine = Variant();
+		instance_id = 0;
+
+		Variant ret;
+		LIMBO_ERR_FAIL_COND_V_MSG(!GDVIRTUAL_CALL(_run, ret), FAILURE, "BTAsyncAction: _run() is not implemented.");
+		Object *state = ret.get_type() == Variant::OBJECT ? ret.operator Object *() : nullptr;
+		if (state == nullptr || !state->has_signal(LW_NAME(completed))) {
+			return _to_status(ret); // Returned without awaiting anything.
+		}
+		coroutine = ret;
+		instance_id = _get_reactive_instance_id();
+		state->connect(LW_NAME(completed), callable_mp(this, &BTAsyncAction::_on_run_completed).bind(run_id));
+	}
+
+	if (!completed) {
+		// Nothing to do until the coroutine completes: it wakes up the instance.
+		request_wake_after(Math_INF);
+		return RUNNING;
+	}
+	return result;
+}
+
+void BTAsyncAction::_exit() {
+	// Completion of a coroutine that is still suspended is ignored.
+	run_id += 1;
+	coroutine = Variant();
+	instance_id = 0;
+}
+
+void BTAsyncAction::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("is_suspended"), &BTAsyncAction::is_suspended);
+
+	GDVIRTUAL_BIND(_run);
+}
@@ -0,0 +1,45 @@
+/**
+ * bt_async_action.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef BT_ASYNC_ACTION_H
+#define BT_ASYNC_ACTION_H
+
+#include "bt_action.h"
+
+// Base for script actions written as coroutines: _run() is called once when the task starts, and may await
+// signals and timers. The task stays RUNNING without calling into the script until the coroutine returns,
+// and a reactive BTInstance sleeps in the meantime.
+class BTAsyncAction : public BTAction {
+	GDCLASS(BTAsyncAction, BTAction);
+
+private:
+	uint32_t run_id = 0; // Incremented on each start, so that coroutines of aborted runs are ignored when they complete.
+	bool completed = false;
+	Status result = FAILURE;
+	Variant coroutine; // Keeps the function state alive while it is suspended.
+	uint64_t instance_id = 0; // Reactive BTInstance to wake when the coroutine completes.
+
+	void _on_run_completed(const Variant &p_result, uint32_t p_run_id);
+	static Status _to_status(const Variant &p_result);
+
+protected:
+	static void _bind_methods();
+
+	virtual void _exit() override;
+	virtual Status _tick(double p_delta) override;
+
+	GDVIRTUAL0R(Variant, _run);
+
+public:
+	_FORCE_INLINE_ bool is_suspended() const { return coroutine.get_type() != Variant::NIL; }
+};
+
+#endif // BT_ASYNC_ACTION_H
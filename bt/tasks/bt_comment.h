@@ -17,6 +17,8 @@
 class BTComment : public BTTask {
 	GDCLASS(BTComment, BTTask);
 	TASK_CATEGORY(Utility);
+	TASK_THREAD_SAFE();
+	TASK_PURE();
 
 protected:
 	static void _bind_methods() {}
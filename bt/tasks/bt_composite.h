@@ -20,6 +20,162 @@ class BTComposite : public BTTask {
 protected:
 	static void _bind_methods() {}
 
+	struct InOrder {
+		_FORCE_INLINE_ int operator()(int p_idx) const { return p_idx; }
+	};
+
+	// Ticks children from r_last_running_idx onward, until one returns a status other than CONTINUE.
+	// Sequences continue on SUCCESS, selectors on FAILURE. p_order maps positions to child indices.
+	template <Status CONTINUE, typename Order = InOrder>
+	_FORCE_INLINE_ Status _tick_in_order(double p_delta, int &r_last_running_idx, Order p_order = Order()) {
+		Status status = CONTINUE;
+		const int count = get_child_count();
+		for (int i = r_last_running_idx; i < count; i++) {
+			status = _get_child_ptr_unchecked(p_order(i))->execute(p_delta);
+			if (status != CONTINUE) {
+				r_last_running_idx = i;
+				break;
+			}
+		}
+		return status;
+	}
+
+	// Batched _tick_in_order() over clones of this composite, one per agent (see BTTask::_tick_batch()). Each child is
+	// executed for all agents that reached it at once, so that the agents advance through the children together.
+	template <Status CONTINUE, typename T>
+	void _tick_batch_in_order(const TaskBatchContext &p_batch, int T::*p_last_running_idx) {
+		LocalVector<uint32_t> ticking; // Agents ticked in the batch, the others go through execute().
+		ticking.reserve(p_batch.count);
+		for (uint32_t i = 0; i < p_batch.count; i++) {
+			T *task = static_cast<T *>(p_batch.tasks[i]);
+			if (task->_begin_batch_tick(p_batch.delta)) {
+				ticking.push_back(i);
+				p_batch.statuses[i] = CONTINUE;
+			} else {
+				p_batch.statuses[i] = task->execute(p_batch.delta);
+			}
+		}
+
+		LocalVector<BTTask *> children;
+		LocalVector<uint32_t> owners;
+		LocalVector<Status> child_statuses;
+		children.reserve(ticking.size());
+		owners.reserve(ticking.size());
+		child_statuses.reserve(ticking.size());
+		const int count = get_child_count();
+		for (int c = 0; c < count; c++) {
+			children.clear();
+			owners.clear();
+			child_statuses.clear();
+			for (const uint32_t i : ticking) {
+				T *task = static_cast<T *>(p_batch.tasks[i]);
+				if (p_batch.statuses[i] == CONTINUE && task->*p_last_running_idx <= c) {
+					BTTask *child = task->_get_child_ptr_unchecked(c);
+					children.push_back(child);
+					child_statuses.push_back(child->get_status());
+					owners.push_back(i);
+				}
+			}
+			if (children.is_empty()) {
+				continue;
+			}
+			TaskBatchContext child_batch;
+			child_batch.tasks = children.ptr();
+			child_batch.count = children.size();
+			child_batch.delta = p_batch.delta;
+			child_batch.statuses = child_statuses.ptr();
+			BTTask::execute_batch(child_batch);
+			for (uint32_t k = 0; k < owners.size(); k++) {
+				if (child_statuses[k] != CONTINUE) {
+					p_batch.statuses[owners[k]] = child_statuses[k];
+					static_cast<T *>(p_batch.tasks[owners[k]])->*p_last_running_idx = c;
+				}
+			}
+		}
+
+		for (const uint32_t i : ticking) {
+			static_cast<T *>(p_batch.tasks[i])->_end_batch_tick(p_batch.statuses[i]);
+		}
+	}
+
+	// Throttles reevaluation in dynamic composites. With the defaults, preceding children are reevaluated on every tick.
+	struct Reevaluation {
+		double interval = 0.0;
+		bool on_change = false; // Also reevaluate when a blackboard variable changes.
+		double elapsed = 0.0;
+		uint64_t change_count = 0;
+
+		_FORCE_INLINE_ bool is_throttled() const { return interval > 0.0 || on_change; }
+	};
+
+	void _reset_reevaluation(Reevaluation &r_reevaluation) const {
+		r_reevaluation.elapsed = 0.0;
+		if (r_reevaluation.on_change && get_blackboard().is_valid()) {
+			r_reevaluation.change_count = get_blackboard()->get_change_count();
+		}
+	}
+
+	// Returns true if preceding children should be reevaluated on this tick.
+	bool _is_reevaluation_due(double p_delta, Reevaluation &r_reevaluation) const {
+		if (!r_reevaluation.is_throttled()) {
+			return true;
+		}
+		r_reevaluation.elapsed += p_delta;
+		bool due = r_reevaluation.interval > 0.0 && r_reevaluation.elapsed >= r_reevaluation.interval;
+		if (r_reevaluation.on_change && get_blackboard().is_valid()) {
+			due = due || get_blackboard()->get_change_count() != r_reevaluation.change_count;
+		}
+		if (due) {
+			_reset_reevaluation(r_reevaluation);
+		}
+		return due;
+	}
+
+	// Like _tick_in_order(), but preceding children are reevaluated on every tick,
+	// and the previous runner is aborted if an earlier child takes over.
+	// With a throttled p_reevaluation, preceding children are skipped until a reevaluation is due, and the reactive
+	// instance may sleep until then (blackboard changes wake it up).
+	template <Status CONTINUE>
+	Status _tick_dynamic(double p_delta, int &r_last_running_idx, Reevaluation *p_reevaluation = nullptr) {
+		Status status = SUCCESS;
+		bool guards_ticked = false;
+		const int count = get_child_count();
+		const bool throttled = p_reevaluation && p_reevaluation->is_throttled();
+		int i = 0;
+		if (throttled && !_is_reevaluation_due(p_delta, *p_reevaluation) && r_last_running_idx < count &&
+				_get_child_ptr_unchecked(r_last_running_idx)->get_status() == RUNNING) {
+			i = r_last_running_idx;
+		}
+		for (; i < count; i++) {
+			BTTask *child = _get_child_ptr_unchecked(i);
+			if (i < r_last_running_idx && child->get_status() == CONTINUE && child->can_skip_reevaluation()) {
+				// Guard inputs haven't changed since the last tick - result would be the same.
+				status = CONTINUE;
+				continue;
+			}
+			status = child->execute(p_delta);
+			if (status != CONTINUE) {
+				break;
+			}
+			guards_ticked = true;
+		}
+		if (status == RUNNING && throttled) {
+			if (p_reevaluation->interval > 0.0) {
+				request_wake_after(p_reevaluation->interval - p_reevaluation->elapsed);
+			}
+		} else if (status == RUNNING && guards_ticked) {
+			// Preceding tasks are reevaluated every tick - a reactive instance can't sleep.
+			_prevent_sleep();
+		}
+		// If the last node ticked is earlier in the tree than the previous runner,
+		// cancel previous runner.
+		if (r_last_running_idx > i && _get_child_ptr_unchecked(r_last_running_idx)->get_status() == RUNNING) {
+			_get_child_ptr_unchecked(r_last_running_idx)->abort();
+		}
+		r_last_running_idx = i;
+		return status;
+	}
+
 public:
 	virtual PackedStringArray get_configuration_warnings() override;
 };
@@ -20,6 +20,6 @@ PackedStringArray BTDecorator::get_configuration_warnings() {
 }
 
 BT::Status BTDecorator::_tick(double p_delta) {
-	ERR_FAIL_COND_V_MSG(get_child_count() == 0, FAILURE, "BT decorator doesn't have a child.");
-	return get_child(0)->execute(p_delta);
+	LIMBO_ERR_FAIL_COND_V_MSG(get_child_count() == 0, FAILURE, "BT decorator doesn't have a child.");
+	return _get_child_ptr_unchecked(0)->execute(p_delta);
 }
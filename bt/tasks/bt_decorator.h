@@ -18,6 +18,9 @@ class BTDecorator : public BTTask {
 	GDCLASS(BTDecorator, BTTask)
 
 protected:
+	// Upper limit of `max_iterations_per_tick` in looping decorators, so that a runaway loop can't stall the frame.
+	static constexpr int ITERATIONS_PER_TICK_LIMIT = 1024;
+
 	static void _bind_methods() {}
 
 	virtual Status _tick(double p_delta) override;
@@ -11,10 +11,19 @@
 
 #include "bt_task.h"
 
+#include "../../blackboard/bb_param/bb_param.h"
 #include "../../blackboard/blackboard.h"
+#include "../../util/limbo_profiling.h"
 #include "../../util/limbo_string_names.h"
 #include "../../util/limbo_utility.h"
 #include "../behavior_tree.h"
+#include "../bt_cost_analyzer.h"
+#include "../bt_instance.h"
+#include "../bt_profile.h"
+#include "../bt_scheduler.h"
+#include "../bt_stats.h"
+#include "../bt_telemetry.h"
+#include "../bt_trace.h"
 #include "bt_comment.h"
 
 #ifdef LIMBOAI_MODULE
@@ -24,6 +33,8 @@
 #include "core/object/object.h"
 #include "core/object/ref_counted.h"
 #include "core/object/script_language.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/os/time.h"
 #include "core/string/ustring.h"
 #include "core/templates/hash_map.h"
 #include "core/variant/variant.h"
@@ -39,6 +50,8 @@
 #include "godot_cpp/variant/variant.hpp"
 #include <godot_cpp/classes/ref.hpp>
 #include <godot_cpp/classes/script.hpp>
+#include <godot_cpp/classes/time.hpp>
+#include <godot_cpp/classes/worker_thread_pool.hpp>
 #endif // LIMBOAI_GDEXTENSION
 
 void BT::_bind_methods() {
@@ -80,9 +93,23 @@ void BTTask::_set_children(Array p_children) {
 	const int num_children = p_children.size();
 	int num_null = 0;
 
+	// Release the previous children, so that the ones not listed again can be adopted elsewhere without cloning.
+	for (const Ref<BTTask> &child : data.children) {
+		if (child.is_valid() && child->data.parent == this) {
+			child->data.parent = nullptr;
+			child->data.index = -1;
+		}
+	}
+
+	data.compiled_children = nullptr;
 	data.children.clear();
 	data.children.resize(num_children);
 
+	// At runtime, source tasks are only read and cloned by instantiation, which produces properly parented copies.
+	// So a task owned by another parent, e.g. a task resource referenced by several trees, is shared rather than copied.
+	// Copies are only made in the editor, where each parent must own its children, and while cloning.
+	const bool share_owned = !thread_cloning && !Engine::get_singleton()->is_editor_hint();
+
 	for (int i = 0; i < num_children; i++) {
 		Ref<BTTask> task = p_children[i];
 		if (task.is_null()) {
@@ -90,7 +117,12 @@ void BTTask::_set_children(Array p_children) {
 			num_null += 1;
 			continue;
 		}
+		int idx = i - num_null;
 		if (task->data.parent != nullptr && task->data.parent != this) {
+			if (share_owned) {
+				data.children.set(idx, task);
+				continue;
+			}
 			task = task->clone();
 			if (task.is_null()) {
 				// * BTComment::clone() returns nullptr at runtime - we omit those.
@@ -98,7 +130,6 @@ void BTTask::_set_children(Array p_children) {
 				continue;
 			}
 		}
-		int idx = i - num_null;
 		task->data.parent = this;
 		task->data.index = idx;
 		data.children.set(idx, task);
@@ -109,6 +140,7 @@ void BTTask::_set_children(Array p_children) {
 	}
 }
 
+#ifdef TOOLS_ENABLED
 void BTTask::set_display_collapsed(bool p_display_collapsed) {
 	data.display_collapsed = p_display_collapsed;
 }
@@ -116,6 +148,11 @@ void BTTask::set_display_collapsed(bool p_display_collapsed) {
 bool BTTask::is_displayed_collapsed() const {
 	return data.display_collapsed;
 }
+#endif // TOOLS_ENABLED
+
+void BTTask::_invalidate_generated_name() {
+	data.generated_name_valid = false;
+}
 
 String BTTask::get_task_name() {
 	if (!data.custom_name.is_empty()) {
@@ -123,7 +160,11 @@ String BTTask::get_task_name() {
 	}
 
 	Ref<Script> task_script = get_script();
+	if (data.generated_name_valid && task_script.is_null()) {
+		return data.generated_name;
+	}
 
+	String name;
 	if (task_script.is_valid()) {
 		// ! CURSED: Currently, has_method() doesn't return true for ClassDB-registered native virtual methods. This may break in the future.
 		bool has_generate_method = has_method(LW_NAME(_generate_name));
@@ -139,11 +180,29 @@ String BTTask::get_task_name() {
 				GDVIRTUAL_CALL(_generate_name, call_result);
 			}
 			ERR_FAIL_COND_V_MSG(call_result.is_empty() || call_result == "<null>", _generate_name(), vformat("BTTask: _generate_name() failed to return a proper name string (%s)", task_script->get_path()));
-			return call_result;
+			name = call_result;
 		}
 	}
+	if (name.is_empty()) {
+		name = _generate_name();
+	}
+	if (task_script.is_valid()) {
+		// * Not cached: exported script variables don't emit "changed", and _generate_name() can be edited in place.
+		data.generated_name_valid = false;
+		return name;
+	}
 
-	return _generate_name();
+	// * Names depend on properties, which are assumed to emit "changed" when set. Connected lazily, since most
+	// runtime instances are never asked for a name. Runtime clones invalidate the name in _task_changed() instead.
+	if (!data.runtime_clone) {
+		Callable invalidate = callable_mp(this, &BTTask::_invalidate_generated_name);
+		if (!is_connected(LW_NAME(changed), invalidate)) {
+			connect(LW_NAME(changed), invalidate);
+		}
+	}
+	data.generated_name = name;
+	data.generated_name_valid = true;
+	return name;
 }
 
 Ref<BTTask> BTTask::get_root() const {
@@ -157,17 +216,34 @@ Ref<BTTask> BTTask::get_root() const {
 void BTTask::set_custom_name(const String &p_name) {
 	if (data.custom_name != p_name) {
 		data.custom_name = p_name;
-		emit_changed();
+		_task_changed();
 	}
 };
 
+// Agent and scene root are null in headless instances (see BehaviorTree::instantiate_headless()).
 void BTTask::initialize(Node *p_agent, const Ref<Blackboard> &p_blackboard, Node *p_scene_root) {
-	ERR_FAIL_NULL(p_agent);
 	ERR_FAIL_NULL(p_blackboard);
-	ERR_FAIL_NULL(p_scene_root);
-	data.agent = p_agent;
-	data.blackboard = p_blackboard;
-	data.scene_root = p_scene_root;
+	Context *shared = data.parent ? data.parent->data.context : nullptr;
+	if (shared && shared->agent == p_agent && shared->blackboard == p_blackboard && shared->scene_root == p_scene_root) {
+		if (shared != data.context) {
+			shared->refcount.ref();
+			_release_context();
+			data.context = shared;
+		}
+	} else {
+		Context *context = memnew(Context);
+		context->refcount.init();
+		context->agent = p_agent;
+		context->blackboard = p_blackboard;
+		context->scene_root = p_scene_root;
+		_release_context();
+		data.context = context;
+	}
+	Ref<Script> sc = GET_SCRIPT(this);
+	data.resumable = sc.is_null() && _can_resume_running_child();
+	data.virtual_enter = GDVIRTUAL_IS_OVERRIDDEN(_enter);
+	data.virtual_tick = GDVIRTUAL_IS_OVERRIDDEN(_tick);
+	data.virtual_exit = GDVIRTUAL_IS_OVERRIDDEN(_exit);
 	for (int i = 0; i < data.children.size(); i++) {
 		get_child(i)->initialize(p_agent, p_blackboard, p_scene_root);
 	}
@@ -177,108 +253,561 @@ void BTTask::initialize(Node *p_agent, const Ref<Blackboard> &p_blackboard, Node
 	}
 }
 
-Ref<BTTask> BTTask::clone() const {
-	Ref<BTTask> inst = duplicate(false);
+void BTTask::_release_context() {
+	if (data.context != &empty_context && data.context->refcount.unref()) {
+		memdelete(data.context);
+	}
+	data.context = &empty_context;
+}
 
-	// * Children are duplicated via children property. See _set_children().
+void BTTask::set_agent(Node *p_agent) {
+	if (data.context->agent == p_agent) {
+		return;
+	}
+	// * The context may be shared with other tasks - the new agent applies to this task only.
+	Context *context = memnew(Context);
+	context->refcount.init();
+	context->agent = p_agent;
+	context->blackboard = data.context->blackboard;
+	context->scene_root = data.context->scene_root;
+	_release_context();
+	data.context = context;
+}
 
+BTTask::Context BTTask::empty_context;
+HashMap<StringName, LocalVector<StringName>> BTTask::object_properties_by_class;
+HashMap<ObjectID, LocalVector<StringName>> BTTask::object_properties_by_script;
+SpinLock BTTask::object_properties_lock;
+thread_local bool BTTask::thread_cloning = false;
+
+const LocalVector<StringName> &BTTask::_get_object_properties(const BTTask *p_task) {
+	Ref<Script> sc = GET_SCRIPT(p_task);
+	const StringName class_name = p_task->get_class();
+	object_properties_lock.lock();
+	LocalVector<StringName> *cached = sc.is_valid() ? object_properties_by_script.getptr(sc->get_instance_id()) : object_properties_by_class.getptr(class_name);
+	object_properties_lock.unlock();
+	if (cached) {
+		return *cached;
+	}
+
+	// * Collected outside of the lock - another thread may insert the same list meanwhile, the first one is kept.
+
+	LocalVector<StringName> names;
 #ifdef LIMBOAI_MODULE
-	// Make BBParam properties unique.
 	List<PropertyInfo> props;
-	inst->get_property_list(&props);
-	HashMap<Ref<Resource>, Ref<Resource>> duplicates;
-	for (List<PropertyInfo>::Element *E = props.front(); E; E = E->next()) {
-		if (!(E->get().usage & PROPERTY_USAGE_STORAGE)) {
-			continue;
+	p_task->get_property_list(&props);
+	for (const PropertyInfo &pi : props) {
+		if ((pi.usage & PROPERTY_USAGE_STORAGE) && (pi.type == Variant::OBJECT || pi.type == Variant::ARRAY)) {
+			names.push_back(pi.name);
+		}
+	}
+#elif LIMBOAI_GDEXTENSION
+	TypedArray<Dictionary> props = p_task->get_property_list();
+	for (int i = 0; i < props.size(); i++) {
+		Dictionary prop = props[i];
+		const int type = prop["type"];
+		if ((int(prop["usage"]) & PROPERTY_USAGE_STORAGE) && ((type == Variant::OBJECT && int(prop["hint"]) == PROPERTY_HINT_RESOURCE_TYPE) || type == Variant::ARRAY)) {
+			names.push_back(prop["name"]);
 		}
+	}
+#endif // LIMBOAI_MODULE & LIMBOAI_GDEXTENSION
 
-		Variant v = inst->get(E->get().name);
+	object_properties_lock.lock();
+	if (sc.is_valid()) {
+		cached = object_properties_by_script.getptr(sc->get_instance_id());
+		if (cached == nullptr) {
+			cached = &object_properties_by_script.insert(sc->get_instance_id(), names)->value;
+		}
+	} else {
+		cached = object_properties_by_class.getptr(class_name);
+		if (cached == nullptr) {
+			cached = &object_properties_by_class.insert(class_name, names)->value;
+		}
+	}
+	object_properties_lock.unlock();
+	return *cached;
+}
+
+void BTTask::clear_property_cache() {
+	object_properties_lock.lock();
+	object_properties_by_class.clear();
+	object_properties_by_script.clear();
+	object_properties_lock.unlock();
+}
+
+static Ref<Resource> _get_param_copy(const Ref<BBParam> &p_param, HashMap<Ref<Resource>, Ref<Resource>> &r_duplicates) {
+	Ref<Resource> *dup = r_duplicates.getptr(p_param);
+	if (dup == nullptr) {
+		dup = &r_duplicates.insert(p_param, p_param->duplicate())->value;
+	}
+	return *dup;
+}
 
-		if (v.is_ref_counted()) {
-			Ref<RefCounted> ref = v;
-			if (ref.is_valid()) {
-				Ref<Resource> res = ref;
-				if (res.is_valid() && res->is_class("BBParam")) {
-					if (!duplicates.has(res)) {
-						duplicates[res] = res->duplicate();
+Ref<BTTask> BTTask::clone() const {
+	// * Children are cloned by _set_children() of the duplicate - they must not be shared with the source.
+	const bool was_cloning = thread_cloning;
+	thread_cloning = true;
+	Ref<BTTask> inst = duplicate(false);
+	thread_cloning = was_cloning;
+
+	// * Children are duplicated via children property. See _set_children().
+
+	if (!Engine::get_singleton()->is_editor_hint()) {
+		// * At runtime, constant BBParams are shared with the source task instead of being copied for each clone. Other
+		// exported members are still copied by duplicate(), and every clone is a full task object.
+		// BBParams without a read cache are never modified on the tick path and are shared by all clones. Those with one
+		// (see BBParam::has_read_cache()) are copied per clone, also inside arrays, so that agents don't evict each
+		// other's cache, or race for it on worker threads.
+		inst->data.runtime_clone = true;
+		HashMap<Ref<Resource>, Ref<Resource>> param_duplicates;
+		for (const StringName &prop_name : _get_object_properties(inst.ptr())) {
+			const Variant value = inst->get(prop_name);
+			if (value.get_type() == Variant::ARRAY) {
+				// * The array itself is shared with the source task - it's copied before the first change.
+				Array arr = value;
+				bool copied = false;
+				for (int i = 0; i < arr.size(); i++) {
+					Ref<BBParam> param = arr[i];
+					if (param.is_null() || !param->has_read_cache()) {
+						continue;
+					}
+					if (!copied) {
+						arr = arr.duplicate(false);
+						copied = true;
 					}
-					res = duplicates[res];
-					inst->set(E->get().name, res);
+					arr[i] = _get_param_copy(param, param_duplicates);
+				}
+				if (copied) {
+					inst->set(prop_name, arr);
 				}
+				continue;
+			}
+			Ref<BBParam> param = value;
+			if (param.is_valid() && param->has_read_cache()) {
+				inst->set(prop_name, _get_param_copy(param, param_duplicates));
 			}
 		}
+		return inst;
 	}
-#elif LIMBOAI_GDEXTENSION
+
 	// Make BBParam properties unique.
-	TypedArray<Dictionary> props = inst->get_property_list();
 	HashMap<Ref<Resource>, Ref<Resource>> duplicates;
-	for (int i = 0; i < props.size(); i++) {
-		Dictionary prop = props[i];
-		if (!(int(prop["usage"]) & PROPERTY_USAGE_STORAGE)) {
+	for (const StringName &prop_name : _get_object_properties(inst.ptr())) {
+		const Variant value = inst->get(prop_name);
+		if (value.get_type() != Variant::OBJECT) {
 			continue;
 		}
-
-		StringName prop_name = prop["name"];
-		Variant v = inst->get(prop_name);
-
-		if (v.get_type() == Variant::OBJECT && int(prop["hint"]) == PROPERTY_HINT_RESOURCE_TYPE) {
-			Ref<RefCounted> ref = v;
-			if (ref.is_valid()) {
-				Ref<Resource> res = ref;
-				if (res.is_valid() && res->is_class("BBParam")) {
-					if (!duplicates.has(res)) {
-						duplicates[res] = res->duplicate();
-					}
-					res = duplicates[res];
-					inst->set(prop_name, res);
-				}
+		Ref<Resource> res = value;
+		if (res.is_valid() && res->is_class("BBParam")) {
+			if (!duplicates.has(res)) {
+				duplicates[res] = res->duplicate();
 			}
+			inst->set(prop_name, duplicates[res]);
 		}
 	}
-#endif // LIMBOAI_MODULE & LIMBOAI_GDEXTENSION
 
 	return inst;
 }
 
-BT::Status BTTask::execute(double p_delta) {
-	if (data.status != RUNNING) {
+void BTTask::_enter_tick(double p_delta) {
+	if (data.state->status != RUNNING) {
 		// Reset children status.
-		if (data.status != FRESH) {
+		if (data.state->status != FRESH) {
 			for (int i = 0; i < get_child_count(); i++) {
 				data.children.get(i)->abort();
 			}
 		}
-		if (!GDVIRTUAL_CALL(_enter)) {
+		data.state->timing = true;
+		data.state->time = data.clock ? *data.clock : 0.0;
+		if (!data.virtual_enter || !_script_enter()) {
 			_enter();
 		}
+	} else if (data.clock == nullptr) {
+		data.state->time += p_delta;
+	}
+	data.state->touched = true;
+}
+
+void BTTask::_exit_tick() {
+	if (data.state->status != RUNNING) {
+		if (!data.virtual_exit || !_script_exit()) {
+			_exit();
+		}
+		data.state->timing = false;
+	}
+}
+
+BT::Status BTTask::execute(double p_delta) {
+#ifdef DEBUG_ENABLED
+	if (unlikely(data.profile_stats != nullptr)) {
+		return _execute_profiled(p_delta);
+	}
+	if (unlikely(data.trace != nullptr)) {
+		return _execute_traced(p_delta);
+	}
+#endif
+	if (unlikely(data.telemetry != nullptr)) {
+		return _execute_counted(p_delta);
+	}
+	if (unlikely(data.resumed)) {
+		// Already ticked this frame by a resuming BTInstance - report the result to the parent.
+		data.resumed = false;
+		return data.state->status;
+	}
+
+	// * Counted here, where the profiled, traced and counted executions end up too, so that all modes report the same.
+	BTStats::count_task();
+	_enter_tick(p_delta);
+
+	BTInstance::SleepRequest *sleep_request = BTInstance::sleep_request;
+	const uint32_t num_requests = sleep_request ? sleep_request->num_requests : 0;
+
+	if (!data.virtual_tick || !_script_tick(p_delta, data.state->status)) {
+		data.state->status = _tick(p_delta);
+	}
+
+	if (unlikely(sleep_request != nullptr) && data.state->status == RUNNING && sleep_request->num_requests == num_requests) {
+		// Neither this task nor its descendants asked to be woken up later - it must be ticked every frame.
+		sleep_request->blocked = true;
+	}
+
+	_exit_tick();
+	return data.state->status;
+}
+
+void BTTask::execute_batch(const TaskBatchContext &p_batch) {
+	if (p_batch.count > 0) {
+		p_batch.tasks[0]->_tick_batch(p_batch);
+	}
+}
+
+void BTTask::_tick_batch(const TaskBatchContext &p_batch) {
+	for (uint32_t i = 0; i < p_batch.count; i++) {
+		p_batch.statuses[i] = p_batch.tasks[i]->execute(p_batch.delta);
+	}
+}
+
+void BTTask::_tick_batch_leaves(const TaskBatchContext &p_batch) {
+	for (uint32_t i = 0; i < p_batch.count; i++) {
+		BTTask *task = p_batch.tasks[i];
+		if (unlikely(!task->_begin_batch_tick(p_batch.delta))) {
+			p_batch.statuses[i] = task->execute(p_batch.delta);
+			continue;
+		}
+		const Status status = task->_tick(p_batch.delta);
+		task->_end_batch_tick(status);
+		p_batch.statuses[i] = status;
+	}
+}
+
+bool BTTask::_begin_batch_tick(double p_delta) {
+#ifdef DEBUG_ENABLED
+	if (data.profile_stats != nullptr || data.trace != nullptr) {
+		return false;
+	}
+#endif
+	// * Sleep requests are per instance, so reactive ticks go through execute().
+	if (data.resumed || data.virtual_tick || data.telemetry != nullptr || BTInstance::sleep_request != nullptr) {
+		return false;
+	}
+	BTStats::count_task();
+	_enter_tick(p_delta);
+	return true;
+}
+
+void BTTask::_end_batch_tick(Status p_status) {
+	data.state->status = p_status;
+	_exit_tick();
+}
+
+#ifdef DEBUG_ENABLED
+
+thread_local uint64_t *BTTask::profile_children_usec = nullptr;
+
+BT::Status BTTask::_execute_traced(double p_delta) {
+	BTTrace *trace = data.trace;
+	const Status old_status = data.state->status;
+	data.trace = nullptr;
+	Status status = execute(p_delta);
+	data.trace = trace;
+	if (status != old_status) {
+		trace->record(data.trace_index, old_status, status);
+	}
+	return status;
+}
+
+BT::Status BTTask::_execute_profiled(double p_delta) {
+	// * Trees with profiling enabled also get a profiler zone per task.
+	LIMBO_PROFILE_ZONE_DYNAMIC(get_task_name());
+	BTTaskStats *stats = data.profile_stats;
+	uint64_t children_usec = 0;
+	uint64_t *parent_children_usec = profile_children_usec;
+	profile_children_usec = &children_usec;
+
+	// Cleared for the duration of the call, so that execute() takes the regular path.
+	data.profile_stats = nullptr;
+	uint64_t start = Time::get_singleton()->get_ticks_usec();
+	Status status = execute(p_delta);
+	uint64_t inclusive_usec = Time::get_singleton()->get_ticks_usec() - start;
+	data.profile_stats = stats;
+
+	profile_children_usec = parent_children_usec;
+	if (parent_children_usec) {
+		*parent_children_usec += inclusive_usec;
+	}
+	stats->tick_count.increment();
+	stats->inclusive_usec.add(inclusive_usec);
+	stats->self_usec.add(inclusive_usec - MIN(children_usec, inclusive_usec));
+	return status;
+}
+
+#endif // DEBUG_ENABLED
+
+BT::Status BTTask::_execute_counted(double p_delta) {
+	BTTaskCounters *counters = data.telemetry;
+	// * Resumed tasks were counted when the resuming BTInstance ticked them.
+	const bool counted = !data.resumed;
+	const bool entering = data.state->status != RUNNING;
+
+	// Cleared for the duration of the call, so that execute() takes the regular path.
+	data.telemetry = nullptr;
+	const Status status = execute(p_delta);
+	data.telemetry = counters;
+
+	if (counted) {
+		counters->ticks.increment();
+		if (entering) {
+			counters->entered.increment();
+		}
+		if (status == SUCCESS) {
+			counters->succeeded.increment();
+		} else if (status == FAILURE) {
+			counters->failed.increment();
+		}
+	}
+	return status;
+}
+
+// In a reactive BTInstance, tells that this task doesn't need a tick for p_seconds if it keeps RUNNING.
+// Has no effect outside of a tick or if the instance is not reactive.
+void BTTask::request_wake_after(double p_seconds) {
+	BTInstance::SleepRequest *sleep_request = BTInstance::sleep_request;
+	if (sleep_request) {
+		sleep_request->num_requests += 1;
+		sleep_request->wake_after = MIN(sleep_request->wake_after, MAX(p_seconds, 0.0));
+	}
+}
+
+int64_t BTTask::get_remaining_budget_usec() const {
+	return BTInstance::get_remaining_budget_usec();
+}
+
+void BTTask::_prevent_sleep() {
+	if (BTInstance::sleep_request) {
+		BTInstance::sleep_request->blocked = true;
+	}
+}
+
+uint64_t BTTask::_get_reactive_instance_id() {
+	return BTInstance::sleep_request ? BTInstance::sleep_request->instance_id : 0;
+}
+
+uint64_t BTTask::_get_updating_instance_id() {
+	return BTInstance::current_instance_id;
+}
+
+bool BTTask::_is_scheduled_update() {
+	return BTInstance::current_update_scheduled;
+}
+
+void BTTask::_wake_instance(uint64_t p_instance_id) {
+	BTInstance *instance = Object::cast_to<BTInstance>(OBJECT_DB_GET_INSTANCE(p_instance_id));
+	if (instance) {
+		instance->request_wake();
+	}
+}
+
+LimboRNG &BTTask::_get_rng() {
+	return BTInstance::get_current_rng();
+}
+
+struct BTTask::ConcurrentBranches {
+	BTTask *parent = nullptr;
+	const int *indices = nullptr;
+	double delta = 0.0;
+	BT::Status *statuses = nullptr;
+	BTInstance::SleepRequest *outer_request = nullptr;
+	uint64_t budget_deadline_usec = 0;
+	LocalVector<BTInstance::SleepRequest> requests;
+	LocalVector<LimboRNG> rngs;
+	LocalVector<LocalVector<BTScheduler::DeferredCall>> calls;
+};
+
+void BTTask::_execute_branch(uint32_t p_index, ConcurrentBranches *p_branches) {
+	// The waiting thread may pick up branches too - its own context is restored afterwards.
+	BTInstance::SleepRequest *prev_request = BTInstance::sleep_request;
+	LimboRNG *prev_rng = BTInstance::current_rng;
+	LocalVector<BTScheduler::DeferredCall> *prev_calls = BTScheduler::deferred_calls;
+	const uint64_t prev_deadline = BTInstance::budget_deadline_usec;
+	const bool prev_frozen = Blackboard::outer_vars_frozen;
+
+	BTInstance::sleep_request = p_branches->outer_request ? &p_branches->requests[p_index] : nullptr;
+	BTInstance::current_rng = &p_branches->rngs[p_index];
+	BTScheduler::deferred_calls = &p_branches->calls[p_index];
+	BTInstance::budget_deadline_usec = p_branches->budget_deadline_usec;
+	// * Branches read outer variables of the shared scope by name, e.g., in format strings - the lookup cache must not change.
+	Blackboard::outer_vars_frozen = true;
+	BTTask *child = p_branches->parent->_get_child_ptr_unchecked(p_branches->indices[p_index]);
+	p_branches->statuses[p_index] = child->execute(p_branches->delta);
+
+	BTInstance::sleep_request = prev_request;
+	BTInstance::current_rng = prev_rng;
+	BTScheduler::deferred_calls = prev_calls;
+	BTInstance::budget_deadline_usec = prev_deadline;
+	Blackboard::outer_vars_frozen = prev_frozen;
+}
+
+void BTTask::_insert_var(const BBVarHandle &p_handle, const Variant &p_value) {
+	if (BTScheduler::is_deferring_calls()) {
+		BTScheduler::defer_set_var(data.context->blackboard, p_handle.name, p_value);
 	} else {
-		data.elapsed += p_delta;
+		data.context->blackboard->set_var(p_handle.name, p_value);
+	}
+}
+
+bool BTTask::_execute_concurrently(const int *p_indices, uint32_t p_count, double p_delta, Status *r_statuses) {
+	// * Instances ticked by BTScheduler on worker threads already keep the pool busy.
+	if (p_count < 2 || BTScheduler::is_deferring_calls() || unlikely(data.trace != nullptr)) {
+		return false;
 	}
 
-	if (!GDVIRTUAL_CALL(_tick, p_delta, data.status)) {
-		data.status = _tick(p_delta);
+	ConcurrentBranches branches;
+	branches.parent = this;
+	branches.indices = p_indices;
+	branches.delta = p_delta;
+	branches.statuses = r_statuses;
+	branches.outer_request = BTInstance::sleep_request;
+	branches.budget_deadline_usec = BTInstance::budget_deadline_usec;
+	branches.requests.resize(p_count);
+	branches.rngs.resize(p_count);
+	branches.calls.resize(p_count);
+	LimboRNG &rng = BTInstance::get_current_rng();
+	for (uint32_t i = 0; i < p_count; i++) {
+		if (branches.outer_request) {
+			branches.requests[i].instance_id = branches.outer_request->instance_id;
+		}
+		// Separate statements: seeds must not depend on the evaluation order of operands.
+		const uint64_t high = rng.next();
+		const uint64_t low = rng.next();
+		branches.rngs[i].seed((high << 32) | low);
 	}
 
-	if (data.status != RUNNING) {
-		if (!GDVIRTUAL_CALL(_exit)) {
-			_exit();
+#ifdef LIMBOAI_MODULE
+	WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_native_group_task(&BTTask::_execute_branch_native, &branches, p_count, -1, true, "BTParallel");
+#elif LIMBOAI_GDEXTENSION
+	int64_t group = WorkerThreadPool::get_singleton()->add_group_task(callable_mp_static(&BTTask::_execute_branch_bound).bind(uint64_t(&branches)), p_count, -1, true, "BTParallel");
+#endif
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+
+	for (uint32_t i = 0; i < p_count; i++) {
+		if (branches.outer_request) {
+			const BTInstance::SleepRequest &request = branches.requests[i];
+			branches.outer_request->num_requests += request.num_requests;
+			branches.outer_request->wake_after = MIN(branches.outer_request->wake_after, request.wake_after);
+			branches.outer_request->blocked = branches.outer_request->blocked || request.blocked;
 		}
-		data.elapsed = 0.0;
+		BTScheduler::_apply_deferred_calls(branches.calls[i]);
+	}
+	return true;
+}
+
+#ifdef LIMBOAI_MODULE
+
+bool BTTask::_script_enter() {
+	return GDVIRTUAL_CALL(_enter);
+}
+
+bool BTTask::_script_exit() {
+	return GDVIRTUAL_CALL(_exit);
+}
+
+bool BTTask::_script_tick(double p_delta, Status &r_status) {
+	return GDVIRTUAL_CALL(_tick, p_delta, r_status);
+}
+
+#elif LIMBOAI_GDEXTENSION
+
+// In godot-cpp, GDVIRTUAL_CALL asks the script whether it has the method before each call, which is a second trip across
+// the extension boundary. Overrides are already known from initialize(), so the script method is called directly.
+// If the script was replaced since then, the call fails, and the native method is used instead.
+bool BTTask::_call_script_method(const StringName &p_method, const Variant **p_args, int p_argcount, Variant &r_ret) {
+	GDExtensionCallError ce;
+	::godot::internal::gdextension_interface_object_call_script_method(_owner, p_method._native_ptr(), (const GDExtensionConstVariantPtr *)p_args, p_argcount, r_ret._native_ptr(), &ce);
+	return ce.error == GDEXTENSION_CALL_OK;
+}
+
+bool BTTask::_script_enter() {
+	Variant ret;
+	return _call_script_method(LW_NAME(_enter), nullptr, 0, ret);
+}
+
+bool BTTask::_script_exit() {
+	Variant ret;
+	return _call_script_method(LW_NAME(_exit), nullptr, 0, ret);
+}
+
+bool BTTask::_script_tick(double p_delta, Status &r_status) {
+	const Variant delta = p_delta;
+	const Variant *args[1] = { &delta };
+	Variant ret;
+	if (!_call_script_method(LW_NAME(_tick), args, 1, ret)) {
+		return false;
 	}
-	return data.status;
+	r_status = Status(int(ret));
+	return true;
 }
 
+#endif
+
 void BTTask::abort() {
+	if (!data.state->touched) {
+		return;
+	}
+	data.state->touched = false;
 	for (int i = 0; i < data.children.size(); i++) {
-		get_child(i)->abort();
+		_get_child_ptr_unchecked(i)->abort();
 	}
-	if (data.status == RUNNING) {
-		if (!GDVIRTUAL_CALL(_exit)) {
+	if (data.state->status == RUNNING) {
+		if (!data.virtual_exit || !_script_exit()) {
 			_exit();
 		}
+#ifdef DEBUG_ENABLED
+		if (unlikely(data.trace != nullptr)) {
+			data.trace->record(data.trace_index, RUNNING, FRESH);
+		}
+#endif
+		if (unlikely(data.telemetry != nullptr)) {
+			data.telemetry->aborted.increment();
+		}
 	}
-	data.status = FRESH;
-	data.elapsed = 0.0;
+	data.state->status = FRESH;
+	data.resumed = false;
+	data.state->timing = false;
+}
+
+void BTTask::_set_clock(const double *p_clock) {
+	// Running tasks keep their elapsed time across the change.
+	const double elapsed = get_elapsed_time();
+	data.clock = p_clock;
+	_restore_elapsed_time(data.state->timing, elapsed);
+	for (int i = 0; i < data.children.size(); i++) {
+		data.children[i]->_set_clock(p_clock);
+	}
+}
+
+void BTTask::_restore_elapsed_time(bool p_timing, double p_elapsed) {
+	data.state->timing = p_timing;
+	data.state->time = (p_timing && data.clock) ? *data.clock - p_elapsed : p_elapsed;
 }
 
 int BTTask::get_child_count_excluding_comments() const {
@@ -293,47 +822,65 @@ int BTTask::get_child_count_excluding_comments() const {
 
 void BTTask::add_child(Ref<BTTask> p_child) {
 	ERR_FAIL_COND_MSG(p_child->get_parent().is_valid(), "p_child already has a parent!");
+	data.compiled_children = nullptr;
+	if (p_child->data.clock != data.clock) {
+		p_child->_set_clock(data.clock);
+	}
 	p_child->data.parent = this;
 	p_child->data.index = data.children.size();
 	data.children.push_back(p_child);
-	emit_changed();
+	_task_changed();
 }
 
 void BTTask::add_child_at_index(Ref<BTTask> p_child, int p_idx) {
 	ERR_FAIL_COND_MSG(p_child->get_parent().is_valid(), "p_child already has a parent!");
+	data.compiled_children = nullptr;
 	if (p_idx < 0 || p_idx > data.children.size()) {
 		p_idx = data.children.size();
 	}
+	if (p_child->data.clock != data.clock) {
+		p_child->_set_clock(data.clock);
+	}
 	p_child->data.parent = this;
 	p_child->data.index = p_idx;
 	data.children.insert(p_idx, p_child);
-	for (int i = p_idx + 1; i < data.children.size(); i++) {
-		get_child(i)->data.index = i;
+	_update_child_indices(p_idx + 1);
+	_task_changed();
+}
+
+void BTTask::_update_child_indices(int p_from) {
+	for (int i = p_from; i < data.children.size(); i++) {
+		// * Shared children keep the index in the task that owns them.
+		if (data.children[i]->data.parent == this) {
+			data.children[i]->data.index = i;
+		}
 	}
-	emit_changed();
 }
 
 void BTTask::remove_child(Ref<BTTask> p_child) {
 	int idx = data.children.find(p_child);
 	ERR_FAIL_COND_MSG(idx == -1, "p_child not found!");
+	data.compiled_children = nullptr;
 	data.children.remove_at(idx);
-	p_child->data.parent = nullptr;
-	p_child->data.index = -1;
-	for (int i = idx; i < data.children.size(); i++) {
-		get_child(i)->data.index = i;
+	if (p_child->data.parent == this) {
+		p_child->data.parent = nullptr;
+		p_child->data.index = -1;
 	}
-	emit_changed();
+	_update_child_indices(idx);
+	_task_changed();
 }
 
 void BTTask::remove_child_at_index(int p_idx) {
 	ERR_FAIL_INDEX(p_idx, get_child_count());
-	data.children[p_idx]->data.parent = nullptr;
-	data.children[p_idx]->data.index = -1;
-	data.children.remove_at(p_idx);
-	for (int i = p_idx; i < data.children.size(); i++) {
-		get_child(i)->data.index = i;
+	data.compiled_children = nullptr;
+	BTTask *child = data.children[p_idx].ptr();
+	if (child->data.parent == this) {
+		child->data.parent = nullptr;
+		child->data.index = -1;
 	}
-	emit_changed();
+	data.children.remove_at(p_idx);
+	_update_child_indices(p_idx);
+	_task_changed();
 }
 
 bool BTTask::is_descendant_of(const Ref<BTTask> &p_task) const {
@@ -356,6 +903,19 @@ Ref<BTTask> BTTask::next_sibling() const {
 	return Ref<BTTask>();
 }
 
+String BTTask::validate_runtime(LocalVector<StringName> &r_read_vars, LocalVector<StringName> &r_written_vars) const {
+	for (const StringName &prop_name : _get_object_properties(this)) {
+		Ref<BBParam> param = get(prop_name);
+		if (param.is_valid() && param->get_value_source() == BBParam::BLACKBOARD_VAR) {
+			if (param->get_variable() == StringName()) {
+				return vformat("`%s` is bound to a blackboard variable, but the variable name is not set.", prop_name);
+			}
+			r_read_vars.push_back(param->get_variable());
+		}
+	}
+	return String();
+}
+
 PackedStringArray BTTask::_get_configuration_warnings() {
 	return PackedStringArray();
 }
@@ -370,6 +930,7 @@ PackedStringArray BTTask::get_configuration_warnings() {
 	}
 	ret.append_array(warnings);
 	ret.append_array(_get_configuration_warnings());
+	ret.append_array(BTCostAnalyzer::get_task_warnings(this));
 
 	return ret;
 }
@@ -429,6 +990,8 @@ void BTTask::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("print_tree", "initial_tabs"), &BTTask::print_tree, Variant(0));
 	ClassDB::bind_method(D_METHOD("get_task_name"), &BTTask::get_task_name);
 	ClassDB::bind_method(D_METHOD("abort"), &BTTask::abort);
+	ClassDB::bind_method(D_METHOD("request_wake_after", "seconds"), &BTTask::request_wake_after);
+	ClassDB::bind_method(D_METHOD("get_remaining_budget_usec"), &BTTask::get_remaining_budget_usec);
 	ClassDB::bind_method(D_METHOD("editor_get_behavior_tree"), &BTTask::editor_get_behavior_tree);
 
 	// Properties, setters and getters.
@@ -441,6 +1004,7 @@ void BTTask::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_parent"), &BTTask::get_parent);
 	ClassDB::bind_method(D_METHOD("get_status"), &BTTask::get_status);
 	ClassDB::bind_method(D_METHOD("get_elapsed_time"), &BTTask::get_elapsed_time);
+	ClassDB::bind_method(D_METHOD("get_instance_time"), &BTTask::get_instance_time);
 	ClassDB::bind_method(D_METHOD("get_custom_name"), &BTTask::get_custom_name);
 	ClassDB::bind_method(D_METHOD("set_custom_name", "name"), &BTTask::set_custom_name);
 
@@ -464,9 +1028,11 @@ BTTask::BTTask() {
 }
 
 BTTask::~BTTask() {
+	_release_context();
 	for (int i = 0; i < get_child_count(); i++) {
 		ERR_FAIL_COND(!get_child(i).is_valid());
-		get_child(i)->data.parent = nullptr;
-		get_child(i).unref();
+		if (get_child(i)->data.parent == this) {
+			get_child(i)->data.parent = nullptr;
+		}
 	}
 }
@@ -14,6 +14,9 @@
 
 #include "../../blackboard/blackboard.h"
 #include "../../util/limbo_compat.h"
+#include "../../util/limbo_error_reporter.h"
+#include "../../util/limbo_rng.h"
+#include "../../util/limbo_snapshot.h"
 #include "../../util/limbo_string_names.h"
 #include "../../util/limbo_task_db.h"
 
@@ -25,7 +28,11 @@
 #include "core/object/object.h"
 #include "core/object/ref_counted.h"
 #include "core/os/memory.h"
+#include "core/os/spin_lock.h"
 #include "core/string/ustring.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
 #include "core/templates/vector.h"
 #include "core/typedefs.h"
 #include "core/variant/array.h"
@@ -39,11 +46,18 @@
 #include <godot_cpp/classes/resource.hpp>
 #include <godot_cpp/core/gdvirtual.gen.inc>
 #include <godot_cpp/core/object.hpp>
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/templates/safe_refcount.hpp>
+#include <godot_cpp/templates/spin_lock.hpp>
 #include <godot_cpp/templates/vector.hpp>
 using namespace godot;
 #endif // LIMBOAI_GDEXTENSION
 
 class BehaviorTree;
+struct BTTaskStats;
+struct BTTaskCounters;
+class BTTrace;
 
 /**
  * Base class for BTTask.
@@ -67,31 +81,135 @@ protected:
 
 VARIANT_ENUM_CAST(BT::Status)
 
+// Source trees loaded at runtime are read-only: a task resource referenced by several trees is listed as a child of
+// each parent, but its parent and index refer to the first one only (see _set_children()). Only clone() produces
+// executable trees, in which every task is owned by the parent that lists it - BTInstance refuses anything else.
 class BTTask : public BT {
 	GDCLASS(BTTask, BT);
 
 private:
 	friend class BehaviorTree;
+	friend class BTInstance;
+	friend class BTMemoryStats;
+	friend class BTValidator;
 
-	// Avoid namespace pollution in the derived classes.
-	struct Data {
-		int index = -1;
-		String custom_name;
+public:
+	// Clones of the same task owned by different agents, executed at once (see _tick_batch()).
+	struct TaskBatchContext {
+		BTTask *const *tasks = nullptr; // One clone per agent, starting with the task that executes the batch.
+		uint32_t count = 0;
+		double delta = 0.0;
+		Status *statuses = nullptr; // In: status of each clone before the tick. Out: status after the tick.
+	};
+
+private:
+	// Execution state of a task. Compiled instances keep it for all of their tasks in one depth-first array,
+	// so that sweeps over the whole tree (snapshots, debugger updates) are linear in memory.
+	struct State {
+		Status status = FRESH;
+		// Set by execute(), cleared by abort(). Children are only executed by their parents, so an unset flag means
+		// the whole subtree is FRESH, and resetting it on re-entry touches only the tasks that ran since the last reset.
+		bool touched = false;
+		bool timing = false; // Set from entering the task until it exits.
+		// With an instance clock: the clock reading when the task was entered. Without one: the time accumulated since then.
+		double time = 0.0;
+
+		_FORCE_INLINE_ double get_elapsed(const double *p_clock) const { return !timing ? 0.0 : (p_clock ? *p_clock - time : time); }
+	};
+
+	// Agent, scene root and blackboard, shared by the tasks of one blackboard scope in an instance instead of being
+	// stored in each task. A child initialized with the same ones as its parent shares the parent's context.
+	struct Context {
+		SafeRefCount refcount;
 		Node *agent = nullptr;
 		Node *scene_root = nullptr;
 		Ref<Blackboard> blackboard;
+	};
+	static Context empty_context; // Of tasks that aren't initialized - never freed.
+
+	// Avoid namespace pollution in the derived classes.
+	struct Data {
+		String custom_name;
+		Context *context = &empty_context;
 		BTTask *parent = nullptr;
 		Vector<Ref<BTTask>> children;
-		Status status = FRESH;
-		double elapsed = 0.0;
-		bool display_collapsed = false;
+		// Points into the contiguous child table of a compiled BTInstance (see BTInstance::compile()).
+		BTTask *const *compiled_children = nullptr;
+		State own_state;
+		// Points to own_state, or into the state array of a compiled BTInstance (see BTInstance::compile()).
+		State *state = &own_state;
+		// Clock of the BTInstance owning the task, so that running tasks don't need to accumulate elapsed time on each tick.
+		const double *clock = nullptr;
+		int index = -1;
+		// Set when the task was already ticked this frame by a resuming BTInstance (see BTInstance::set_resume_running()).
+		bool resumed = false;
+		// Cached at initialization: true if BTInstance can skip this task and resume its running child directly.
+		bool resumable = false;
+		// Cached at initialization: false if a script doesn't override the method, so that the hot path can skip GDVIRTUAL_CALL.
+		bool virtual_enter = true;
+		bool virtual_tick = true;
+		bool virtual_exit = true;
+		// Set on copies made by clone() at runtime, which are never observed as resources (see _task_changed()).
+		bool runtime_clone = false;
+		// Cached by get_task_name() for tasks without a script, until the task emits "changed".
+		bool generated_name_valid = false;
+		String generated_name;
 #ifdef TOOLS_ENABLED
+		// Editor-only state, left out of export templates.
+		bool display_collapsed = false;
 		ObjectID behavior_tree_id;
+#endif
+		// Not null if the BehaviorTree this task was instantiated from collects telemetry, in all builds
+		// (see BehaviorTree::set_telemetry_enabled()).
+		BTTaskCounters *telemetry = nullptr;
+#ifdef DEBUG_ENABLED
+		// Not null if the BehaviorTree this task was instantiated from is profiled (see BehaviorTree::set_profiling_enabled()).
+		BTTaskStats *profile_stats = nullptr;
+		// Not null if status transitions are recorded (see BTInstance::set_trace_enabled()).
+		BTTrace *trace = nullptr;
+		uint32_t trace_index = 0;
 #endif
 	} data;
 
+#ifdef DEBUG_ENABLED
+	// Time spent in the profiled children of the task being executed on this thread.
+	static thread_local uint64_t *profile_children_usec;
+	Status _execute_profiled(double p_delta);
+	Status _execute_traced(double p_delta);
+#endif
+	Status _execute_counted(double p_delta);
+
+	// Storage properties that may hold a BBParam, or an array of them, cached per class and per script. Filled on first use, also from
+	// worker threads cloning trees (see BehaviorTree::instantiate_many()), so access goes through the lock.
+	// Entries are never moved by inserts, so returned lists stay valid until clear_property_cache().
+	static HashMap<StringName, LocalVector<StringName>> object_properties_by_class;
+	static HashMap<ObjectID, LocalVector<StringName>> object_properties_by_script;
+	static SpinLock object_properties_lock;
+	static const LocalVector<StringName> &_get_object_properties(const BTTask *p_task);
+
+	// True while clone() duplicates a task on this thread (see _set_children()).
+	static thread_local bool thread_cloning;
+
+	// Per-branch context of _execute_concurrently(), defined in bt_task.cpp.
+	struct ConcurrentBranches;
+	static void _execute_branch(uint32_t p_index, ConcurrentBranches *p_branches);
+#ifdef LIMBOAI_MODULE
+	static void _execute_branch_native(void *p_userdata, uint32_t p_index) { _execute_branch(p_index, static_cast<ConcurrentBranches *>(p_userdata)); }
+#elif LIMBOAI_GDEXTENSION
+	static void _execute_branch_bound(uint32_t p_index, uint64_t p_branches) { _execute_branch(p_index, reinterpret_cast<ConcurrentBranches *>(p_branches)); }
+#endif
+
+	void _release_context();
+
+	_FORCE_INLINE_ void _enter_tick(double p_delta);
+	_FORCE_INLINE_ void _exit_tick();
+
 	Array _get_children() const;
 	void _set_children(Array children);
+	void _update_child_indices(int p_from);
+	void _set_clock(const double *p_clock);
+	void _restore_elapsed_time(bool p_timing, double p_elapsed);
+	void _invalidate_generated_name();
 
 	PackedStringArray _get_configuration_warnings(); // ! Scripts only.
 
@@ -104,6 +222,83 @@ protected:
 	virtual void _exit() {}
 	virtual Status _tick(double p_delta) { return FAILURE; }
 
+	// Executes clones of this task owned by different agents at once (see BTCrowd), starting with this task.
+	// Replaces execute() on each of them - the default executes them one by one, so custom tasks keep working.
+	// Overrides wrap their work in _begin_batch_tick() and _end_batch_tick(), and pass children on with execute_batch().
+	virtual void _tick_batch(const TaskBatchContext &p_batch);
+	// _tick_batch() for leaves: calls _tick() on each clone without the rest of execute() around it.
+	void _tick_batch_leaves(const TaskBatchContext &p_batch);
+	// What execute() does before and after _tick(). Returns false if the task must go through execute() instead,
+	// e.g. when it's extended by a script, profiled, or resumed.
+	bool _begin_batch_tick(double p_delta);
+	void _end_batch_tick(Status p_status);
+
+	// Return true if ticking this task while its only running child stays RUNNING has no effect other than ticking that child.
+	// Such tasks can be skipped by BTInstance in resume mode.
+	virtual bool _can_resume_running_child() const { return false; }
+	// Dynamic composites can skip re-evaluating a task that returns true - its inputs haven't changed since the last tick.
+	virtual bool _can_skip_reevaluation() { return false; }
+
+	// Runtime state other than the status and elapsed time, such as the index of the running child, captured
+	// in BTInstance snapshots. _load_state() must read exactly what _save_state() writes.
+	virtual void _save_state(LimboSnapshotWriter &p_writer) const {}
+	virtual void _load_state(LimboSnapshotReader &p_reader) {}
+
+	// Returns a raw pointer to the child task, avoiding reference counting in the tick path.
+	_FORCE_INLINE_ BTTask *_get_child_ptr(int p_idx) const {
+		ERR_FAIL_INDEX_V(p_idx, data.children.size(), nullptr);
+		return data.compiled_children ? data.compiled_children[p_idx] : data.children[p_idx].ptr();
+	}
+	// Bounds are only asserted in dev builds - for indices that are valid by construction, such as a loop over
+	// [0, get_child_count()), a stored running index, or child 0 after checking that there is a child.
+	_FORCE_INLINE_ BTTask *_get_child_ptr_unchecked(int p_idx) const {
+		DEV_ASSERT(p_idx >= 0 && p_idx < data.children.size());
+		return data.compiled_children ? data.compiled_children[p_idx] : data.children.ptr()[p_idx].ptr();
+	}
+	// True if the task was already ticked this frame by a resuming BTInstance, and is about to report its result.
+	// Tasks that resume their running child must not redo the decisions that started it (see _can_resume_running_child()).
+	static _FORCE_INLINE_ bool _is_resumed(const BTTask *p_task) { return p_task->data.resumed; }
+
+	// Called by the setters of tasks instead of emit_changed(). Runtime clones only drop their cached name, skipping
+	// the "changed" signal, which nothing listens to outside of the editor.
+	_FORCE_INLINE_ void _task_changed() {
+		if (data.runtime_clone) {
+			data.generated_name_valid = false;
+		} else {
+			emit_changed();
+		}
+	}
+
+	// Keeps a reactive BTInstance awake, even if other running tasks requested to wake up later.
+	static void _prevent_sleep();
+	// ID of the reactive BTInstance being updated, or 0 outside of a tick or if the instance is not reactive.
+	// Store it while RUNNING to wake up the instance with _wake_instance() when an awaited event happens.
+	static uint64_t _get_reactive_instance_id();
+	// ID of the BTInstance being updated on this thread, reactive or not, or 0 outside of an update.
+	static uint64_t _get_updating_instance_id();
+	// True if the BTInstance being updated on this thread was updated by BTScheduler.
+	static bool _is_scheduled_update();
+	// Requests a wake-up of the instance (see BTInstance::request_wake()). Safe to call from any thread.
+	static void _wake_instance(uint64_t p_instance_id);
+
+	// Executes the children with the given indices concurrently on the WorkerThreadPool, storing their statuses in r_statuses.
+	// Each branch gets its own wake-up request, random stream and buffer of deferred scene calls (see BTScheduler::defer_call()),
+	// merged in the given order after all branches finish. The children must be thread-safe subtrees that don't write
+	// blackboard variables used by other branches. Returns false without executing anything if that's not possible on this thread.
+	bool _execute_concurrently(const int *p_indices, uint32_t p_count, double p_delta, Status *r_statuses);
+
+	// Writes a blackboard variable from _tick(). On worker threads, a variable missing from the task's scope is inserted
+	// on the main thread after the batch (see BTScheduler::defer_set_var()), so it's not readable until the next update.
+	_FORCE_INLINE_ void _set_var_by_handle(BBVarHandle &p_handle, const Variant &p_value) {
+		if (unlikely(!data.context->blackboard->try_set_var_by_handle(p_handle, p_value))) {
+			_insert_var(p_handle, p_value);
+		}
+	}
+	void _insert_var(const BBVarHandle &p_handle, const Variant &p_value);
+
+	// Random stream of the BTInstance being updated. Use instead of the global RNG, so that seeded instances are reproducible.
+	static LimboRNG &_get_rng();
+
 	GDVIRTUAL0RC(String, _generate_name);
 	GDVIRTUAL0(_setup);
 	GDVIRTUAL0(_enter);
@@ -111,6 +306,14 @@ protected:
 	GDVIRTUAL1R(Status, _tick, double);
 	GDVIRTUAL0RC(PackedStringArray, _get_configuration_warnings);
 
+	// Script overrides of the methods on the execution path. Only called if data.virtual_* is set for the method.
+	bool _script_enter();
+	bool _script_exit();
+	bool _script_tick(double p_delta, Status &r_status);
+#ifdef LIMBOAI_GDEXTENSION
+	bool _call_script_method(const StringName &p_method, const Variant **p_args, int p_argcount, Variant &r_ret);
+#endif
+
 #ifdef LIMBOAI_GDEXTENSION
 	String _to_string() const { return "<" + get_class() + "#" + itos(get_instance_id()) + ">"; }
 #endif
@@ -122,13 +325,22 @@ public:
 	virtual bool editor_can_reload_from_file() override { return false; }
 #endif // LIMBOAI_MODULE
 
-	_FORCE_INLINE_ Node *get_agent() const { return data.agent; }
-	void set_agent(Node *p_agent) { data.agent = p_agent; }
+	_FORCE_INLINE_ bool is_runtime_clone() const { return data.runtime_clone; }
 
-	_FORCE_INLINE_ Node *get_scene_root() const { return data.scene_root; }
+	// Overridden with TASK_THREAD_SAFE() in tasks that can be ticked on a worker thread.
+	static _FORCE_INLINE_ bool is_task_thread_safe() { return false; }
+	// Overridden with TASK_PURE() in tasks whose results can be shared between identical instances (see BTInstance::is_pure()).
+	static _FORCE_INLINE_ bool is_task_pure() { return false; }
 
+	_FORCE_INLINE_ Node *get_agent() const { return data.context->agent; }
+	void set_agent(Node *p_agent);
+
+	_FORCE_INLINE_ Node *get_scene_root() const { return data.context->scene_root; }
+
+#ifdef TOOLS_ENABLED
 	void set_display_collapsed(bool p_display_collapsed);
 	bool is_displayed_collapsed() const;
+#endif
 
 	String get_custom_name() const { return data.custom_name; }
 	void set_custom_name(const String &p_name);
@@ -137,17 +349,33 @@ public:
 	Ref<BTTask> get_root() const;
 
 	virtual Ref<BTTask> clone() const;
+	static void clear_property_cache();
 	virtual void initialize(Node *p_agent, const Ref<Blackboard> &p_blackboard, Node *p_scene_root);
 	virtual PackedStringArray get_configuration_warnings(); // ! Native version.
+	// Runtime validation, see BTValidator. Appends the blackboard variables the task reads and writes, and returns
+	// an error if the task fails on every tick with its configuration. The default lists variable-bound BBParams.
+	virtual String validate_runtime(LocalVector<StringName> &r_read_vars, LocalVector<StringName> &r_written_vars) const;
+	// Checked for initialized tasks of TASK_THREAD_SAFE() classes: false if the configuration still needs the main thread,
+	// e.g., a node path that has to be resolved in the scene tree.
+	virtual bool can_tick_on_worker_thread() const { return true; }
 
 	Status execute(double p_delta);
+	// Executes clones of the same task, one per agent, node by node rather than agent by agent (see _tick_batch()).
+	static void execute_batch(const TaskBatchContext &p_batch);
 	void abort();
+	void request_wake_after(double p_seconds);
+	// Expensive tasks can check it in _tick() and return RUNNING to continue in the next update. See BTInstance::get_remaining_budget_usec().
+	int64_t get_remaining_budget_usec() const;
 
 	_FORCE_INLINE_ Ref<BTTask> get_parent() const { return Ref<BTTask>(data.parent); }
 	_FORCE_INLINE_ bool is_root() const { return data.parent == nullptr; }
-	_FORCE_INLINE_ Ref<Blackboard> get_blackboard() const { return data.blackboard; }
-	_FORCE_INLINE_ Status get_status() const { return data.status; }
-	_FORCE_INLINE_ double get_elapsed_time() const { return data.elapsed; };
+	_FORCE_INLINE_ Ref<Blackboard> get_blackboard() const { return data.context->blackboard; }
+	_FORCE_INLINE_ Status get_status() const { return data.state->status; }
+	_FORCE_INLINE_ double get_elapsed_time() const { return data.state->get_elapsed(data.clock); };
+	// Time on the clock of the owning BTInstance, or 0 if the task isn't part of an instance.
+	_FORCE_INLINE_ double get_instance_time() const { return data.clock ? *data.clock : 0.0; }
+	_FORCE_INLINE_ bool has_instance_clock() const { return data.clock != nullptr; }
+	_FORCE_INLINE_ bool can_skip_reevaluation() { return _can_skip_reevaluation(); }
 
 	_FORCE_INLINE_ Ref<BTTask> get_child(int p_idx) const {
 		ERR_FAIL_INDEX_V(p_idx, data.children.size(), nullptr);
@@ -179,4 +407,9 @@ public:
 	~BTTask();
 };
 
+// Clones of a task share its name, so that runtime errors of all agents running the same tree are reported together.
+_FORCE_INLINE_ uint64_t limbo_error_key(BTTask *p_task) {
+	return p_task->get_task_name().hash();
+}
+
 #endif // BT_TASK_H
@@ -0,0 +1,55 @@
+/**
+ * bt_consideration.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "bt_consideration.h"
+
+void BTConsideration::set_variable(const StringName &p_variable) {
+	variable = p_variable;
+	emit_changed();
+}
+
+void BTConsideration::set_input_min(double p_input_min) {
+	input_min = p_input_min;
+	emit_changed();
+}
+
+void BTConsideration::set_input_max(double p_input_max) {
+	input_max = p_input_max;
+	emit_changed();
+}
+
+void BTConsideration::set_curve(const Ref<Curve> &p_curve) {
+	curve = p_curve;
+	emit_changed();
+}
+
+double BTConsideration::evaluate(double p_input) const {
+	const double range = input_max - input_min;
+	const double t = range == 0.0 ? (p_input >= input_max ? 1.0 : 0.0) : CLAMP((p_input - input_min) / range, 0.0, 1.0);
+	return curve.is_valid() ? double(curve->sample_baked(t)) : t;
+}
+
+void BTConsideration::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_variable", "variable"), &BTConsideration::set_variable);
+	ClassDB::bind_method(D_METHOD("get_variable"), &BTConsideration::get_variable);
+	ClassDB::bind_method(D_METHOD("set_input_min", "value"), &BTConsideration::set_input_min);
+	ClassDB::bind_method(D_METHOD("get_input_min"), &BTConsideration::get_input_min);
+	ClassDB::bind_method(D_METHOD("set_input_max", "value"), &BTConsideration::set_input_max);
+	ClassDB::bind_method(D_METHOD("get_input_max"), &BTConsideration::get_input_max);
+	ClassDB::bind_method(D_METHOD("set_curve", "curve"), &BTConsideration::set_curve);
+	ClassDB::bind_method(D_METHOD("get_curve"), &BTConsideration::get_curve);
+	ClassDB::bind_method(D_METHOD("evaluate", "input"), &BTConsideration::evaluate);
+
+	ADD_PROPERTY(PropertyInfo(Variant::STRING_NAME, "variable"), "set_variable", "get_variable");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "input_min"), "set_input_min", "get_input_min");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "input_max"), "set_input_max", "get_input_max");
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "curve", PROPERTY_HINT_RESOURCE_TYPE, "Curve"), "set_curve", "get_curve");
+}
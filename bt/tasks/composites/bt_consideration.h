@@ -0,0 +1,57 @@
+/**
+ * bt_consideration.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef BT_CONSIDERATION_H
+#define BT_CONSIDERATION_H
+
+#ifdef LIMBOAI_MODULE
+#include "core/io/resource.h"
+#include "scene/resources/curve.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/curve.hpp>
+#include <godot_cpp/classes/resource.hpp>
+using namespace godot;
+#endif // LIMBOAI_GDEXTENSION
+
+// Scoring input of a BTUtilitySelector child: maps a blackboard float from [input_min, input_max] to a score through a curve.
+class BTConsideration : public Resource {
+	GDCLASS(BTConsideration, Resource);
+
+private:
+	StringName variable;
+	double input_min = 0.0;
+	double input_max = 1.0;
+	Ref<Curve> curve;
+
+protected:
+	static void _bind_methods();
+
+public:
+	void set_variable(const StringName &p_variable);
+	StringName get_variable() const { return variable; }
+
+	void set_input_min(double p_input_min);
+	double get_input_min() const { return input_min; }
+
+	void set_input_max(double p_input_max);
+	double get_input_max() const { return input_max; }
+
+	// Score of the normalized input. If not set, the score equals the normalized input.
+	void set_curve(const Ref<Curve> &p_curve);
+	Ref<Curve> get_curve() const { return curve; }
+
+	// Score for an input value, without the sampling used by BTUtilitySelector.
+	double evaluate(double p_input) const;
+};
+
+#endif // BT_CONSIDERATION_H
@@ -17,15 +17,27 @@
 class BTDynamicSelector : public BTComposite {
 	GDCLASS(BTDynamicSelector, BTComposite);
 	TASK_CATEGORY(Composites);
+	TASK_THREAD_SAFE();
+	TASK_PURE();
 
 private:
 	int last_running_idx = 0;
+	Reevaluation reevaluation;
 
 protected:
-	static void _bind_methods() {}
+	static void _bind_methods();
 
 	virtual void _enter() override;
 	virtual Status _tick(double p_delta) override;
+	virtual void _save_state(LimboSnapshotWriter &p_writer) const override;
+	virtual void _load_state(LimboSnapshotReader &p_reader) override;
+
+public:
+	void set_reevaluation_interval(double p_interval);
+	double get_reevaluation_interval() const { return reevaluation.interval; }
+
+	void set_reevaluate_on_change(bool p_enable);
+	bool get_reevaluate_on_change() const { return reevaluation.on_change; }
 };
 
 #endif // BT_DYNAMIC_SELECTOR_H
@@ -11,24 +11,49 @@
 
 #include "bt_dynamic_sequence.h"
 
+//**** Setters / Getters
+
+void BTDynamicSequence::set_reevaluation_interval(double p_interval) {
+	reevaluation.interval = MAX(p_interval, 0.0);
+	_task_changed();
+}
+
+void BTDynamicSequence::set_reevaluate_on_change(bool p_enable) {
+	reevaluation.on_change = p_enable;
+	_task_changed();
+}
+
+//**** Task Implementation
+
 void BTDynamicSequence::_enter() {
 	last_running_idx = 0;
+	_reset_reevaluation(reevaluation);
 }
 
 BT::Status BTDynamicSequence::_tick(double p_delta) {
-	Status status = SUCCESS;
-	int i;
-	for (i = 0; i < get_child_count(); i++) {
-		status = get_child(i)->execute(p_delta);
-		if (status != SUCCESS) {
-			break;
-		}
-	}
-	// If the last node ticked is earlier in the tree than the previous runner,
-	// cancel previous runner.
-	if (last_running_idx > i && get_child(last_running_idx)->get_status() == RUNNING) {
-		get_child(last_running_idx)->abort();
-	}
-	last_running_idx = i;
-	return status;
+	return _tick_dynamic<SUCCESS>(p_delta, last_running_idx, &reevaluation);
+}
+
+void BTDynamicSequence::_save_state(LimboSnapshotWriter &p_writer) const {
+	p_writer.put_u32(last_running_idx);
+	p_writer.put_double(reevaluation.elapsed);
+}
+
+void BTDynamicSequence::_load_state(LimboSnapshotReader &p_reader) {
+	last_running_idx = p_reader.get_u32();
+	const double elapsed = p_reader.get_double();
+	_reset_reevaluation(reevaluation);
+	reevaluation.elapsed = elapsed;
+}
+
+//**** Godot
+
+void BTDynamicSequence::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_reevaluation_interval", "interval"), &BTDynamicSequence::set_reevaluation_interval);
+	ClassDB::bind_method(D_METHOD("get_reevaluation_interval"), &BTDynamicSequence::get_reevaluation_interval);
+	ClassDB::bind_method(D_METHOD("set_reevaluate_on_change", "enable"), &BTDynamicSequence::set_reevaluate_on_change);
+	ClassDB::bind_method(D_METHOD("get_reevaluate_on_change"), &BTDynamicSequence::get_reevaluate_on_change);
+
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "reevaluation_interval", PROPERTY_HINT_RANGE, "0.0,60.0,0.01,or_greater,suffix:s"), "set_reevaluation_interval", "get_reevaluation_interval");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "reevaluate_on_change"), "set_reevaluate_on_change", "get_reevaluate_on_change");
 }
@@ -0,0 +1,130 @@
+/**
+ * bt_event_selector.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "bt_event_selector.h"
+
+#include "../../../hsm/limbo_event_registry.h"
+#include "../../../util/limbo_utility.h"
+#include "../../bt_instance.h"
+
+//**** Setters / Getters
+
+void BTEventSelector::set_events(const TypedArray<StringName> &p_events) {
+	events = p_events;
+	_task_changed();
+}
+
+void BTEventSelector::set_cargo_var(const StringName &p_var) {
+	cargo_var = p_var;
+	_task_changed();
+}
+
+//**** Task Implementation
+
+PackedStringArray BTEventSelector::get_configuration_warnings() {
+	PackedStringArray warnings = BTComposite::get_configuration_warnings();
+	if (events.size() != get_child_count()) {
+		warnings.append(vformat("Expected an event for each child task (%d), got %d. Children without an event are never selected.", get_child_count(), events.size()));
+	}
+	int num_defaults = 0;
+	for (int i = 0; i < events.size(); i++) {
+		num_defaults += StringName(events[i]) == StringName();
+	}
+	if (num_defaults > 1) {
+		warnings.append("Only the first child with an empty event is the default branch.");
+	}
+	return warnings;
+}
+
+String BTEventSelector::_generate_name() {
+	PackedStringArray names;
+	for (int i = 0; i < events.size(); i++) {
+		const StringName event = events[i];
+		names.push_back(event == StringName() ? String("default") : String(event));
+	}
+	String name = names.is_empty() ? "EventSelector" : "EventSelector " + String(", ").join(names);
+	if (cargo_var != StringName()) {
+		name += "  " + LimboUtility::get_singleton()->decorate_output_var(cargo_var);
+	}
+	return name;
+}
+
+void BTEventSelector::_setup() {
+	event_ids.resize(get_child_count());
+	default_idx = -1;
+	for (int i = 0; i < get_child_count(); i++) {
+		const StringName event = i < events.size() ? StringName(events[i]) : StringName();
+		event_ids[i] = LimboEventRegistry::INVALID_EVENT;
+		if (event != StringName()) {
+			event_ids[i] = LimboEventRegistry::intern(event);
+		} else if (i < events.size() && default_idx == -1) {
+			default_idx = i;
+		}
+	}
+}
+
+void BTEventSelector::_enter() {
+	active_idx = -1;
+}
+
+// Returns the branch of the first child keyed to an event posted since the last update, or -1.
+int BTEventSelector::_select_branch() {
+	const LocalVector<BTPostedEvent> &posted = BTInstance::get_current_events();
+	int selected = -1;
+	const Variant *cargo = nullptr;
+	for (const BTPostedEvent &pe : posted) {
+		for (int i = 0; i < (selected == -1 ? (int)event_ids.size() : selected); i++) {
+			if (event_ids[i] == pe.event_id) {
+				selected = i;
+				cargo = &pe.cargo;
+				break;
+			}
+		}
+	}
+	if (cargo && cargo_var != StringName()) {
+		get_blackboard()->set_var(cargo_var, *cargo);
+	}
+	return selected;
+}
+
+BT::Status BTEventSelector::_tick(double p_delta) {
+	const int selected = BTInstance::get_current_events().is_empty() ? -1 : _select_branch();
+	if (selected != -1 && selected != active_idx) {
+		// * Interrupts the running branch - a repeated event of the active branch doesn't restart it.
+		if (active_idx != -1 && _get_child_ptr_unchecked(active_idx)->get_status() == RUNNING) {
+			_get_child_ptr_unchecked(active_idx)->abort();
+		}
+		active_idx = selected;
+	}
+	if (active_idx == -1) {
+		active_idx = default_idx;
+		if (active_idx == -1) {
+			return FAILURE;
+		}
+	}
+	const Status status = _get_child_ptr_unchecked(active_idx)->execute(p_delta);
+	if (status != RUNNING) {
+		active_idx = -1;
+	}
+	return status;
+}
+
+//**** Godot
+
+void BTEventSelector::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_events", "events"), &BTEventSelector::set_events);
+	ClassDB::bind_method(D_METHOD("get_events"), &BTEventSelector::get_events);
+	ClassDB::bind_method(D_METHOD("set_cargo_var", "variable"), &BTEventSelector::set_cargo_var);
+	ClassDB::bind_method(D_METHOD("get_cargo_var"), &BTEventSelector::get_cargo_var);
+
+	ADD_PROPERTY(PropertyInfo(Variant::ARRAY, "events", PROPERTY_HINT_ARRAY_TYPE, "StringName"), "set_events", "get_events");
+	ADD_PROPERTY(PropertyInfo(Variant::STRING_NAME, "cargo_var"), "set_cargo_var", "get_cargo_var");
+}
@@ -0,0 +1,59 @@
+/**
+ * bt_event_selector.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef BT_EVENT_SELECTOR_H
+#define BT_EVENT_SELECTOR_H
+
+#include "../bt_composite.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/templates/local_vector.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/templates/local_vector.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+class BTEventSelector : public BTComposite {
+	GDCLASS(BTEventSelector, BTComposite);
+	TASK_CATEGORY(Composites);
+
+private:
+	TypedArray<StringName> events; // One per child. Empty for the default branch.
+	StringName cargo_var;
+
+	LocalVector<int> event_ids; // Interned in _setup(), indexed by child.
+	int default_idx = -1;
+	int active_idx = -1;
+
+	int _select_branch();
+
+protected:
+	static void _bind_methods();
+
+	virtual String _generate_name() override;
+	virtual void _setup() override;
+	virtual void _enter() override;
+	virtual Status _tick(double p_delta) override;
+	virtual void _save_state(LimboSnapshotWriter &p_writer) const override { p_writer.put_u32(active_idx + 1); }
+	virtual void _load_state(LimboSnapshotReader &p_reader) override { active_idx = int(p_reader.get_u32()) - 1; }
+
+public:
+	void set_events(const TypedArray<StringName> &p_events);
+	TypedArray<StringName> get_events() const { return events; }
+
+	void set_cargo_var(const StringName &p_var);
+	StringName get_cargo_var() const { return cargo_var; }
+
+	virtual PackedStringArray get_configuration_warnings() override;
+};
+
+#endif // BT_EVENT_SELECTOR_H
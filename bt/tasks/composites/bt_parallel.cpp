@@ -11,24 +11,136 @@
 
 #include "bt_parallel.h"
 
-void BTParallel::_enter() {
+#include "../../bt_instance.h"
+
+static void _collect_vars(const BTTask *p_task, LocalVector<StringName> &r_read, LocalVector<StringName> &r_written) {
+	p_task->validate_runtime(r_read, r_written);
+	for (int i = 0; i < p_task->get_child_count(); i++) {
+		_collect_vars(p_task->get_child(i).ptr(), r_read, r_written);
+	}
+}
+
+// Branches can run concurrently if they are thread-safe, and each blackboard variable written by a branch
+// already exists in the scope of that branch and isn't used by any other branch. Variables of outer scopes
+// are not written concurrently: missing from the branch scope, they would be inserted into it by every writer.
+// Listeners are checked on every tick (see _has_listeners()), since they may be added at any time.
+bool BTParallel::_can_run_concurrently() const {
+	const int count = get_child_count();
+	if (count < 2) {
+		return false;
+	}
+	LocalVector<LocalVector<StringName>> read_vars;
+	LocalVector<LocalVector<StringName>> written_vars;
+	read_vars.resize(count);
+	written_vars.resize(count);
+	for (int i = 0; i < count; i++) {
+		if (!BTInstance::is_subtree_thread_safe(get_child(i))) {
+			return false;
+		}
+		_collect_vars(get_child(i).ptr(), read_vars[i], written_vars[i]);
+	}
+	for (int i = 0; i < count; i++) {
+		const Ref<Blackboard> &bb = get_child(i)->get_blackboard();
+		for (const StringName &var : written_vars[i]) {
+			if (bb.is_null() || !bb->has_local_var(var)) {
+				WARN_PRINT(vformat("BTParallel: Branch %d writes blackboard variable \"%s\" that is not in the scope of the parallel - executing branches sequentially.", i, var));
+				return false;
+			}
+			for (int j = 0; j < count; j++) {
+				if (j != i && (read_vars[j].find(var) != -1 || written_vars[j].find(var) != -1)) {
+					WARN_PRINT(vformat("BTParallel: Branches %d and %d share blackboard variable \"%s\" - executing branches sequentially.", i, j, var));
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+// Listeners are called by the thread that writes the variable, so they rule out concurrent branches.
+bool BTParallel::_has_listeners() const {
 	for (int i = 0; i < get_child_count(); i++) {
-		get_child(i)->abort();
+		const Ref<Blackboard> &bb = _get_child_ptr_unchecked(i)->get_blackboard();
+		if (bb.is_valid() && bb->has_var_listeners()) {
+			return true;
+		}
 	}
+	return false;
 }
 
-BT::Status BTParallel::_tick(double p_delta) {
-	int num_succeeded = 0;
-	int num_failed = 0;
-	BT::Status return_status = RUNNING;
+void BTParallel::_setup() {
+	concurrent_ready = concurrent && _can_run_concurrently();
+	if (concurrent_ready) {
+		all_children.resize(get_child_count());
+		branch_statuses.resize(get_child_count());
+		for (uint32_t i = 0; i < all_children.size(); i++) {
+			all_children[i] = i;
+		}
+	}
+}
+
+void BTParallel::_enter() {
 	for (int i = 0; i < get_child_count(); i++) {
-		Status status = BT::FRESH;
-		Ref<BTTask> child = get_child(i);
-		if (!repeat && (child->get_status() == FAILURE || child->get_status() == SUCCESS)) {
-			status = child->get_status();
+		_get_child_ptr_unchecked(i)->abort();
+	}
+	active_dirty = true;
+}
+
+void BTParallel::_rebuild_active() {
+	active_children.clear();
+	num_succeeded = 0;
+	num_failed = 0;
+	const int count = get_child_count();
+	for (int i = 0; i < count; i++) {
+		const Status status = _get_child_ptr_unchecked(i)->get_status();
+		if (status == SUCCESS) {
+			num_succeeded += 1;
+		} else if (status == FAILURE) {
+			num_failed += 1;
 		} else {
-			status = child->execute(p_delta);
+			active_children.push_back(i);
 		}
+	}
+	active_dirty = false;
+}
+
+BT::Status BTParallel::_tick_repeating(double p_delta) {
+	int succeeded = 0;
+	int failed = 0;
+	BT::Status return_status = RUNNING;
+	const int count = get_child_count();
+	const bool concurrently = concurrent_ready && !_has_listeners() && _execute_concurrently(all_children.ptr(), count, p_delta, branch_statuses.ptr());
+	for (int i = 0; i < count; i++) {
+		const Status status = concurrently ? branch_statuses[i] : _get_child_ptr_unchecked(i)->execute(p_delta);
+		if (status == FAILURE) {
+			failed += 1;
+			if (failed >= num_failures_required && return_status == RUNNING) {
+				return_status = FAILURE;
+			}
+		} else if (status == SUCCESS) {
+			succeeded += 1;
+			if (succeeded >= num_successes_required && return_status == RUNNING) {
+				return_status = SUCCESS;
+			}
+		}
+	}
+	return return_status;
+}
+
+BT::Status BTParallel::_tick(double p_delta) {
+	if (repeat) {
+		return _tick_repeating(p_delta);
+	}
+	if (active_dirty) {
+		_rebuild_active();
+	}
+
+	BT::Status return_status = RUNNING;
+	const bool concurrently = concurrent_ready && !_has_listeners() && _execute_concurrently(active_children.ptr(), active_children.size(), p_delta, branch_statuses.ptr());
+	uint32_t kept = 0;
+	for (uint32_t n = 0; n < active_children.size(); n++) {
+		const int idx = active_children[n];
+		const Status status = concurrently ? branch_statuses[n] : _get_child_ptr_unchecked(idx)->execute(p_delta);
 		if (status == FAILURE) {
 			num_failed += 1;
 			if (num_failed >= num_failures_required && return_status == RUNNING) {
@@ -39,14 +151,31 @@ BT::Status BTParallel::_tick(double p_delta) {
 			if (num_succeeded >= num_successes_required && return_status == RUNNING) {
 				return_status = SUCCESS;
 			}
+		} else {
+			active_children[kept++] = idx;
 		}
 	}
-	if (!repeat && (num_failed + num_succeeded) == get_child_count() && return_status == RUNNING) {
-		return_status = FAILURE;
+	active_children.resize(kept);
+
+	if (kept == 0 && return_status == RUNNING) {
+		return_status = FAILURE; // All children finished without reaching the required number.
 	}
 	return return_status;
 }
 
+PackedStringArray BTParallel::get_configuration_warnings() {
+	PackedStringArray warnings = BTComposite::get_configuration_warnings();
+	if (concurrent) {
+		for (int i = 0; i < get_child_count(); i++) {
+			if (!BTInstance::is_subtree_thread_safe(get_child(i))) {
+				warnings.append("Concurrent execution requires thread-safe child tasks - children will be executed sequentially.");
+				break;
+			}
+		}
+	}
+	return warnings;
+}
+
 void BTParallel::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_num_successes_required"), &BTParallel::get_num_successes_required);
 	ClassDB::bind_method(D_METHOD("set_num_successes_required", "value"), &BTParallel::set_num_successes_required);
@@ -54,8 +183,12 @@ void BTParallel::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_num_failures_required", "value"), &BTParallel::set_num_failures_required);
 	ClassDB::bind_method(D_METHOD("get_repeat"), &BTParallel::get_repeat);
 	ClassDB::bind_method(D_METHOD("set_repeat", "enable"), &BTParallel::set_repeat);
+	ClassDB::bind_method(D_METHOD("get_concurrent"), &BTParallel::get_concurrent);
+	ClassDB::bind_method(D_METHOD("set_concurrent", "enable"), &BTParallel::set_concurrent);
+	ClassDB::bind_method(D_METHOD("is_running_concurrently"), &BTParallel::is_running_concurrently);
 
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "num_successes_required"), "set_num_successes_required", "get_num_successes_required");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "num_failures_required"), "set_num_failures_required", "get_num_failures_required");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "repeat"), "set_repeat", "get_repeat");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "concurrent"), "set_concurrent", "get_concurrent");
 }
@@ -14,37 +14,75 @@
 
 #include "../bt_composite.h"
 
+#ifdef LIMBOAI_MODULE
+#include "core/templates/local_vector.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/templates/local_vector.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
 class BTParallel : public BTComposite {
 	GDCLASS(BTParallel, BTComposite);
 	TASK_CATEGORY(Composites);
+	TASK_THREAD_SAFE();
 
 private:
 	int num_successes_required = 1;
 	int num_failures_required = 1;
 	bool repeat = false;
 
+	// Without repeat, finished children are not ticked again: only the indices of the running ones are kept,
+	// in child order, and finished ones are accounted for in the counters.
+	LocalVector<int> active_children;
+	int num_succeeded = 0;
+	int num_failed = 0;
+	bool active_dirty = true; // Rebuilt from the child statuses on the next tick.
+
+	bool concurrent = false;
+	bool concurrent_ready = false; // Children were found independent in _setup().
+	LocalVector<int> all_children; // Indices of all children, for concurrent repeating ticks.
+	LocalVector<Status> branch_statuses;
+
+	void _rebuild_active();
+	bool _can_run_concurrently() const;
+	bool _has_listeners() const;
+	Status _tick_repeating(double p_delta);
+
 protected:
 	static void _bind_methods();
 
+	virtual void _setup() override;
 	virtual void _enter() override;
 	virtual Status _tick(double p_delta) override;
+	virtual void _load_state(LimboSnapshotReader &p_reader) override { active_dirty = true; }
 
 public:
 	int get_num_successes_required() const { return num_successes_required; }
 	void set_num_successes_required(int p_value) {
 		num_successes_required = p_value;
-		emit_changed();
+		_task_changed();
 	}
 	int get_num_failures_required() const { return num_failures_required; }
 	void set_num_failures_required(int p_value) {
 		num_failures_required = p_value;
-		emit_changed();
+		_task_changed();
 	}
 	bool get_repeat() const { return repeat; }
 	void set_repeat(bool p_value) {
 		repeat = p_value;
-		emit_changed();
+		active_dirty = true;
+		_task_changed();
+	}
+	bool get_concurrent() const { return concurrent; }
+	void set_concurrent(bool p_value) {
+		concurrent = p_value;
+		_task_changed();
 	}
+	// True if children are executed on the WorkerThreadPool. Set up when the task is initialized.
+	bool is_running_concurrently() const { return concurrent_ready; }
+
+	virtual PackedStringArray get_configuration_warnings() override;
 };
 
 #endif // BT_PARALLEL_H
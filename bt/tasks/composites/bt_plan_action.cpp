@@ -0,0 +1,41 @@
+/**
+ * bt_plan_action.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "bt_plan_action.h"
+
+void BTPlanAction::set_preconditions(const Dictionary &p_preconditions) {
+	preconditions = p_preconditions;
+	emit_changed();
+}
+
+void BTPlanAction::set_effects(const Dictionary &p_effects) {
+	effects = p_effects;
+	emit_changed();
+}
+
+void BTPlanAction::set_cost(double p_cost) {
+	ERR_FAIL_COND_MSG(p_cost < 0.0, "BTPlanAction: Cost can't be negative.");
+	cost = p_cost;
+	emit_changed();
+}
+
+void BTPlanAction::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_preconditions", "preconditions"), &BTPlanAction::set_preconditions);
+	ClassDB::bind_method(D_METHOD("get_preconditions"), &BTPlanAction::get_preconditions);
+	ClassDB::bind_method(D_METHOD("set_effects", "effects"), &BTPlanAction::set_effects);
+	ClassDB::bind_method(D_METHOD("get_effects"), &BTPlanAction::get_effects);
+	ClassDB::bind_method(D_METHOD("set_cost", "cost"), &BTPlanAction::set_cost);
+	ClassDB::bind_method(D_METHOD("get_cost"), &BTPlanAction::get_cost);
+
+	ADD_PROPERTY(PropertyInfo(Variant::DICTIONARY, "preconditions"), "set_preconditions", "get_preconditions");
+	ADD_PROPERTY(PropertyInfo(Variant::DICTIONARY, "effects"), "set_effects", "get_effects");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "cost", PROPERTY_HINT_RANGE, "0.0,100.0,0.01,or_greater"), "set_cost", "get_cost");
+}
@@ -0,0 +1,50 @@
+/**
+ * bt_plan_action.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef BT_PLAN_ACTION_H
+#define BT_PLAN_ACTION_H
+
+#ifdef LIMBOAI_MODULE
+#include "core/io/resource.h"
+#include "core/variant/dictionary.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/resource.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+using namespace godot;
+#endif // LIMBOAI_GDEXTENSION
+
+// Planning description of a BTPlanner child: the world state it requires, the world state it produces, and its cost.
+// World state is a set of blackboard variables, given as variable name -> value.
+class BTPlanAction : public Resource {
+	GDCLASS(BTPlanAction, Resource);
+
+private:
+	Dictionary preconditions;
+	Dictionary effects;
+	double cost = 1.0;
+
+protected:
+	static void _bind_methods();
+
+public:
+	void set_preconditions(const Dictionary &p_preconditions);
+	Dictionary get_preconditions() const { return preconditions; }
+
+	void set_effects(const Dictionary &p_effects);
+	Dictionary get_effects() const { return effects; }
+
+	void set_cost(double p_cost);
+	double get_cost() const { return cost; }
+};
+
+#endif // BT_PLAN_ACTION_H
@@ -0,0 +1,463 @@
+/**
+ * bt_planner.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "bt_planner.h"
+
+#include "../../../util/limbo_compat.h"
+#include "../../../util/limbo_profiling.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/templates/hashfuncs.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/templates/hashfuncs.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+SpinLock BTPlanner::cache_lock;
+
+//**** Planning
+
+uint32_t BTPlanner::_hash_state(const LocalVector<Variant> &p_state) {
+	uint32_t h = HASH_MURMUR3_SEED;
+	for (const Variant &value : p_state) {
+		h = hash_murmur3_one_32(value.hash(), h);
+	}
+	return hash_fmix32(h);
+}
+
+bool BTPlanner::_equals(const LocalVector<Variant> &p_a, const LocalVector<Variant> &p_b) {
+	if (p_a.size() != p_b.size()) {
+		return false;
+	}
+	for (uint32_t i = 0; i < p_a.size(); i++) {
+		if (p_a[i] != p_b[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool BTPlanner::_satisfies(const LocalVector<Variant> &p_state, const LocalVector<Fact> &p_facts) {
+	for (const Fact &fact : p_facts) {
+		if (p_state[fact.var] != fact.value) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool BTPlanner::find_plan(const Layout &p_layout, const LocalVector<Variant> &p_state, int p_max_expansions, LocalVector<int> &r_plan) {
+	LIMBO_PROFILE_ZONE("BTPlanner::find_plan");
+	r_plan.clear();
+	struct Node {
+		int parent = -1;
+		int action = -1;
+		double cost = 0.0;
+	};
+
+	// * States of the nodes are stored back to back, one variable per slot.
+	const uint32_t width = p_state.size();
+	LocalVector<Node> nodes;
+	LocalVector<Variant> states;
+	LocalVector<uint32_t> open;
+	HashMap<uint32_t, uint32_t> visited; // State hash -> cheapest node reaching it.
+
+	nodes.push_back(Node());
+	for (const Variant &value : p_state) {
+		states.push_back(value);
+	}
+	open.push_back(0);
+	visited.insert(_hash_state(p_state), 0);
+
+	LocalVector<Variant> current;
+	LocalVector<Variant> next;
+	int expansions = 0;
+	while (!open.is_empty() && expansions < p_max_expansions) {
+		// Plans are short, so a linear scan for the cheapest open node beats maintaining a heap.
+		uint32_t best = 0;
+		for (uint32_t i = 1; i < open.size(); i++) {
+			if (nodes[open[i]].cost < nodes[open[best]].cost) {
+				best = i;
+			}
+		}
+		const uint32_t node_idx = open[best];
+		open[best] = open[open.size() - 1];
+		open.resize(open.size() - 1);
+
+		current.resize(width);
+		for (uint32_t v = 0; v < width; v++) {
+			current[v] = states[node_idx * width + v];
+		}
+		if (_satisfies(current, p_layout.goal)) {
+			for (int n = node_idx; nodes[n].parent != -1; n = nodes[n].parent) {
+				r_plan.push_back(p_layout.actions[nodes[n].action].child_index);
+			}
+			r_plan.invert();
+			return true;
+		}
+		expansions++;
+
+		for (uint32_t a = 0; a < p_layout.actions.size(); a++) {
+			const Action &action = p_layout.actions[a];
+			if (!_satisfies(current, action.preconditions)) {
+				continue;
+			}
+			next = current;
+			for (const Fact &effect : action.effects) {
+				next[effect.var] = effect.value;
+			}
+			const double cost = nodes[node_idx].cost + action.cost;
+			const uint32_t h = _hash_state(next);
+			HashMap<uint32_t, uint32_t>::Iterator E = visited.find(h);
+			if (E && nodes[E->value].cost <= cost) {
+				bool same = true;
+				for (uint32_t v = 0; v < width && same; v++) {
+					same = states[E->value * width + v] == next[v];
+				}
+				if (same) {
+					continue; // Reached already, at most as expensively.
+				}
+			}
+			Node node;
+			node.parent = node_idx;
+			node.action = a;
+			node.cost = cost;
+			nodes.push_back(node);
+			for (const Variant &value : next) {
+				states.push_back(value);
+			}
+			open.push_back(nodes.size() - 1);
+			visited[h] = nodes.size() - 1;
+		}
+	}
+	return false;
+}
+
+//**** Cache
+
+BTPlanner::PlanCache *BTPlanner::_get_cache() const {
+	cache_lock.lock();
+	if (cache == nullptr) {
+		cache = memnew(PlanCache);
+		cache->refcount.init();
+	}
+	cache->refcount.ref();
+	cache_lock.unlock();
+	return cache;
+}
+
+void BTPlanner::_release_cache() {
+	if (cache && cache->refcount.unref()) {
+		memdelete(cache);
+	}
+	cache = nullptr;
+}
+
+Ref<BTTask> BTPlanner::clone() const {
+	Ref<BTPlanner> inst = BTComposite::clone();
+	if (inst.is_valid() && inst->is_runtime_clone()) {
+		inst->cache = _get_cache();
+	}
+	return inst;
+}
+
+int BTPlanner::get_cached_plan_count() const {
+	if (cache == nullptr) {
+		return 0;
+	}
+	cache->lock.lock();
+	const int count = cache->entries.size();
+	cache->lock.unlock();
+	return count;
+}
+
+//**** Setters / Getters
+
+Ref<BTPlanAction> BTPlanner::get_plan_action(int p_index) const {
+	ERR_FAIL_INDEX_V(p_index, get_child_count(), Ref<BTPlanAction>());
+	return _get_plan_action(p_index);
+}
+
+void BTPlanner::set_plan_action(int p_index, const Ref<BTPlanAction> &p_action) {
+	ERR_FAIL_INDEX(p_index, get_child_count());
+	ERR_FAIL_COND(IS_CLASS(get_child(p_index), BTComment));
+	get_child(p_index)->set_meta(LW_NAME(_plan_action_), p_action);
+	get_child(p_index)->emit_signal(LW_NAME(changed));
+	layout.child_count = -1; // Recompiled on the next run.
+}
+
+void BTPlanner::set_goal(const Dictionary &p_goal) {
+	goal = p_goal;
+	layout.child_count = -1;
+	_task_changed();
+}
+
+void BTPlanner::set_max_expansions(int p_max_expansions) {
+	max_expansions = MAX(p_max_expansions, 1);
+	_task_changed();
+}
+
+PackedInt32Array BTPlanner::get_plan() const {
+	PackedInt32Array arr;
+	for (int idx : plan) {
+		arr.push_back(idx);
+	}
+	return arr;
+}
+
+//**** Task Implementation
+
+PackedStringArray BTPlanner::get_configuration_warnings() {
+	PackedStringArray warnings = BTComposite::get_configuration_warnings();
+	if (goal.is_empty()) {
+		warnings.append("Goal is not set.");
+	}
+	for (int i = 0; i < get_child_count(); i++) {
+		if (!IS_CLASS(get_child(i), BTComment) && _get_plan_action(i).is_null()) {
+			warnings.append(vformat("Child %d has no plan action and is never planned.", i));
+		}
+	}
+	return warnings;
+}
+
+String BTPlanner::validate_runtime(LocalVector<StringName> &r_read_vars, LocalVector<StringName> &r_written_vars) const {
+	const String error = BTComposite::validate_runtime(r_read_vars, r_written_vars);
+	if (!error.is_empty()) {
+		return error;
+	}
+	if (goal.is_empty()) {
+		return "`goal` is not set.";
+	}
+	const Array goal_vars = goal.keys();
+	for (int i = 0; i < goal_vars.size(); i++) {
+		r_read_vars.push_back(goal_vars[i]);
+	}
+	for (int i = 0; i < get_child_count(); i++) {
+		const Ref<BTPlanAction> action = _get_plan_action(i);
+		if (action.is_null()) {
+			continue;
+		}
+		const Array vars = action->get_preconditions().keys();
+		for (int j = 0; j < vars.size(); j++) {
+			r_read_vars.push_back(vars[j]);
+		}
+	}
+	return String();
+}
+
+void BTPlanner::_compile() {
+	layout = Layout();
+	layout.child_count = get_child_count();
+	HashMap<StringName, uint32_t> indices;
+	auto compile_facts = [&](const Dictionary &p_facts, LocalVector<Fact> &r_facts) {
+		const Array keys = p_facts.keys();
+		for (int i = 0; i < keys.size(); i++) {
+			const StringName var = keys[i];
+			HashMap<StringName, uint32_t>::Iterator E = indices.find(var);
+			if (!E) {
+				E = indices.insert(var, layout.variables.size());
+				layout.variables.push_back(var);
+			}
+			Fact fact;
+			fact.var = E->value;
+			fact.value = p_facts[keys[i]];
+			r_facts.push_back(fact);
+		}
+	};
+
+	compile_facts(goal, layout.goal);
+	for (int i = 0; i < get_child_count(); i++) {
+		const Ref<BTPlanAction> plan_action = _get_plan_action(i);
+		if (plan_action.is_null()) {
+			continue;
+		}
+		Action action;
+		action.child_index = i;
+		action.cost = plan_action->get_cost();
+		compile_facts(plan_action->get_preconditions(), action.preconditions);
+		compile_facts(plan_action->get_effects(), action.effects);
+		layout.actions.push_back(action);
+	}
+
+	handles.resize(layout.variables.size());
+	for (uint32_t i = 0; i < layout.variables.size(); i++) {
+		handles[i] = get_blackboard().is_valid() ? get_blackboard()->get_var_handle(layout.variables[i]) : BBVarHandle();
+	}
+	state.resize(layout.variables.size());
+	versions.resize(layout.variables.size());
+}
+
+void BTPlanner::_read_state() {
+	const Ref<Blackboard> &bb = get_blackboard();
+	for (uint32_t i = 0; i < handles.size(); i++) {
+		state[i] = bb->get_var_by_handle(handles[i], Variant(), false);
+		versions[i] = bb->get_var_version(handles[i]);
+	}
+}
+
+bool BTPlanner::_has_world_changed() {
+	// Untracked variables (missing or bound to a property) are compared by value.
+	const Ref<Blackboard> &bb = get_blackboard();
+	for (uint32_t i = 0; i < handles.size(); i++) {
+		const int64_t version = bb->get_var_version(handles[i]);
+		if (version != versions[i] || (version == -1 && bb->get_var_by_handle(handles[i], Variant(), false) != state[i])) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool BTPlanner::_is_plan_valid() const {
+	// Simulates the rest of the plan. The running step has already started, so its preconditions are skipped.
+	LocalVector<Variant> simulated = state;
+	for (uint32_t i = plan_pos; i < plan.size(); i++) {
+		const Action *action = nullptr;
+		for (const Action &a : layout.actions) {
+			if (a.child_index == uint32_t(plan[i])) {
+				action = &a;
+				break;
+			}
+		}
+		ERR_FAIL_NULL_V(action, false);
+		const bool started = i == plan_pos && _get_child_ptr_unchecked(plan[i])->get_status() == RUNNING;
+		if (!started && !_satisfies(simulated, action->preconditions)) {
+			return false;
+		}
+		for (const Fact &effect : action->effects) {
+			simulated[effect.var] = effect.value;
+		}
+	}
+	return _satisfies(simulated, layout.goal);
+}
+
+void BTPlanner::_find_plan() {
+	plan.clear();
+	plan_pos = 0;
+	const uint32_t h = _hash_state(state);
+	PlanCache *shared = cache;
+	if (shared) {
+		shared->lock.lock();
+		HashMap<uint32_t, PlanCache::Entry>::Iterator E = shared->entries.find(h);
+		const bool hit = E && _equals(E->value.state, state);
+		if (hit) {
+			plan = E->value.plan;
+		}
+		shared->lock.unlock();
+		if (hit) {
+			last_plan_cached = true;
+			return;
+		}
+	}
+
+	last_plan_cached = false;
+	find_plan(layout, state, max_expansions, plan);
+	if (shared) {
+		shared->lock.lock();
+		if (shared->entries.size() >= CACHE_CAPACITY) {
+			shared->entries.clear(); // * World states seen recently are cached again on their next use.
+		}
+		PlanCache::Entry entry;
+		entry.state = state;
+		entry.plan = plan; // * Empty if there is no plan - the search isn't repeated for this state either.
+		shared->entries[h] = entry;
+		shared->lock.unlock();
+	}
+}
+
+BT::Status BTPlanner::_replan() {
+	_read_state();
+	const int running_idx = plan_pos < plan.size() && _get_child_ptr_unchecked(plan[plan_pos])->get_status() == RUNNING ? plan[plan_pos] : -1;
+	if (_satisfies(state, layout.goal)) {
+		if (running_idx != -1) {
+			_get_child_ptr_unchecked(running_idx)->abort();
+		}
+		plan.clear();
+		plan_pos = 0;
+		return SUCCESS;
+	}
+	if (plan_pos < plan.size() && _is_plan_valid()) {
+		return RUNNING; // The change doesn't affect the rest of the plan.
+	}
+
+	_find_plan();
+	if (running_idx != -1 && (plan.is_empty() || plan[0] != running_idx)) {
+		_get_child_ptr_unchecked(running_idx)->abort();
+	}
+	return plan.is_empty() ? FAILURE : RUNNING;
+}
+
+void BTPlanner::_setup() {
+	_compile();
+}
+
+void BTPlanner::_enter() {
+	if (layout.child_count != get_child_count()) {
+		_compile();
+	}
+	plan.clear();
+	plan_pos = 0;
+}
+
+void BTPlanner::_exit() {
+	plan.clear();
+	plan_pos = 0;
+}
+
+BT::Status BTPlanner::_tick(double p_delta) {
+	ERR_FAIL_COND_V_MSG(get_blackboard().is_null(), FAILURE, "BTPlanner: Task is not initialized.");
+	if (plan.is_empty() || _has_world_changed()) {
+		const Status status = _replan();
+		if (status != RUNNING) {
+			return status;
+		}
+	}
+	while (true) {
+		const Status status = _get_child_ptr_unchecked(plan[plan_pos])->execute(p_delta);
+		if (status != SUCCESS) {
+			return status;
+		}
+		plan_pos += 1;
+		if (plan_pos == plan.size()) {
+			// The plan is complete - it failed if the actions didn't produce the goal state.
+			_read_state();
+			return _satisfies(state, layout.goal) ? SUCCESS : FAILURE;
+		}
+		if (_has_world_changed()) {
+			const Status replanned = _replan();
+			if (replanned != RUNNING) {
+				return replanned;
+			}
+		}
+	}
+}
+
+BTPlanner::~BTPlanner() {
+	_release_cache();
+}
+
+//**** Godot
+
+void BTPlanner::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("get_plan_action", "child_idx"), &BTPlanner::get_plan_action);
+	ClassDB::bind_method(D_METHOD("set_plan_action", "child_idx", "action"), &BTPlanner::set_plan_action);
+	ClassDB::bind_method(D_METHOD("set_goal", "goal"), &BTPlanner::set_goal);
+	ClassDB::bind_method(D_METHOD("get_goal"), &BTPlanner::get_goal);
+	ClassDB::bind_method(D_METHOD("set_max_expansions", "max_expansions"), &BTPlanner::set_max_expansions);
+	ClassDB::bind_method(D_METHOD("get_max_expansions"), &BTPlanner::get_max_expansions);
+	ClassDB::bind_method(D_METHOD("get_plan"), &BTPlanner::get_plan);
+	ClassDB::bind_method(D_METHOD("get_plan_position"), &BTPlanner::get_plan_position);
+	ClassDB::bind_method(D_METHOD("is_plan_cached"), &BTPlanner::is_plan_cached);
+	ClassDB::bind_method(D_METHOD("get_cached_plan_count"), &BTPlanner::get_cached_plan_count);
+
+	ADD_PROPERTY(PropertyInfo(Variant::DICTIONARY, "goal"), "set_goal", "get_goal");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "max_expansions", PROPERTY_HINT_RANGE, "1,4096,1,or_greater"), "set_max_expansions", "get_max_expansions");
+}
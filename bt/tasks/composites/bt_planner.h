@@ -0,0 +1,144 @@
+/**
+ * bt_planner.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef BT_PLANNER_H
+#define BT_PLANNER_H
+
+#include "../bt_composite.h"
+#include "bt_plan_action.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/os/spin_lock.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/templates/safe_refcount.hpp>
+#include <godot_cpp/templates/spin_lock.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+// Goal-oriented composite: searches for the cheapest sequence of children that turns the current world state
+// into the goal state, and executes it. The world state consists of the blackboard variables named in the goal
+// and in the plan actions of the children.
+class BTPlanner : public BTComposite {
+	GDCLASS(BTPlanner, BTComposite);
+	TASK_CATEGORY(Composites);
+	TASK_THREAD_SAFE();
+
+public:
+	static constexpr int CACHE_CAPACITY = 256;
+
+	struct Fact {
+		uint32_t var = 0; // Index into Layout::variables.
+		Variant value;
+	};
+
+	struct Action {
+		uint32_t child_index = 0;
+		double cost = 1.0;
+		LocalVector<Fact> preconditions;
+		LocalVector<Fact> effects;
+	};
+
+	// Goal and actions with their facts referring to the world state by index, compiled on setup.
+	struct Layout {
+		LocalVector<StringName> variables;
+		LocalVector<Fact> goal;
+		LocalVector<Action> actions;
+		int child_count = -1;
+	};
+
+	// Best-first search over world states. Stores the child indices of the cheapest plan found within
+	// p_max_expansions expanded states in r_plan and returns true, or returns false if there is none.
+	static bool find_plan(const Layout &p_layout, const LocalVector<Variant> &p_state, int p_max_expansions, LocalVector<int> &r_plan);
+
+private:
+	// Plans shared by runtime clones of the same planner, keyed by the hash of the world state they start from.
+	struct PlanCache {
+		struct Entry {
+			LocalVector<Variant> state;
+			LocalVector<int> plan;
+		};
+
+		SafeRefCount refcount;
+		SpinLock lock;
+		HashMap<uint32_t, Entry> entries;
+	};
+
+	static SpinLock cache_lock;
+
+	Dictionary goal;
+	int max_expansions = 256;
+
+	mutable PlanCache *cache = nullptr; // Created lazily in the source task, when it is first cloned.
+
+	Layout layout;
+	LocalVector<BBVarHandle> handles;
+	LocalVector<Variant> state; // World state when the plan was last checked.
+	LocalVector<int64_t> versions; // Variable versions matching the state, see Blackboard::get_var_version().
+	LocalVector<int> plan;
+	uint32_t plan_pos = 0;
+	bool last_plan_cached = false;
+
+	_FORCE_INLINE_ Ref<BTPlanAction> _get_plan_action(int p_index) const {
+		return get_child(p_index)->get_meta(LW_NAME(_plan_action_), Ref<BTPlanAction>());
+	}
+	static uint32_t _hash_state(const LocalVector<Variant> &p_state);
+	static bool _equals(const LocalVector<Variant> &p_a, const LocalVector<Variant> &p_b);
+	static bool _satisfies(const LocalVector<Variant> &p_state, const LocalVector<Fact> &p_facts);
+
+	void _compile();
+	PlanCache *_get_cache() const;
+	void _release_cache();
+	void _read_state();
+	bool _has_world_changed();
+	bool _is_plan_valid() const;
+	void _find_plan();
+	Status _replan();
+
+protected:
+	static void _bind_methods();
+
+	virtual void _setup() override;
+	virtual void _enter() override;
+	virtual void _exit() override;
+	virtual Status _tick(double p_delta) override;
+
+public:
+	// Plan actions are stored in the metadata of the children.
+	Ref<BTPlanAction> get_plan_action(int p_index) const;
+	void set_plan_action(int p_index, const Ref<BTPlanAction> &p_action);
+
+	void set_goal(const Dictionary &p_goal);
+	Dictionary get_goal() const { return goal; }
+
+	void set_max_expansions(int p_max_expansions);
+	int get_max_expansions() const { return max_expansions; }
+
+	// Child indices of the current plan, and the position of the running step in it.
+	PackedInt32Array get_plan() const;
+	int get_plan_position() const { return plan_pos; }
+	// True if the current plan came from the cache shared by clones of this planner.
+	bool is_plan_cached() const { return last_plan_cached; }
+	int get_cached_plan_count() const;
+
+	virtual Ref<BTTask> clone() const override;
+	virtual PackedStringArray get_configuration_warnings() override;
+	virtual String validate_runtime(LocalVector<StringName> &r_read_vars, LocalVector<StringName> &r_written_vars) const override;
+
+	~BTPlanner();
+};
+
+#endif // BT_PLANNER_H
@@ -55,30 +55,117 @@ bool BTProbabilitySelector::has_probability(int p_index) const {
 
 void BTProbabilitySelector::set_abort_on_failure(bool p_abort_on_failure) {
 	abort_on_failure = p_abort_on_failure;
-	emit_changed();
+	_task_changed();
 }
 
 bool BTProbabilitySelector::get_abort_on_failure() const {
 	return abort_on_failure;
 }
 
+void BTProbabilitySelector::_set_weight(int p_index, double p_weight) {
+	get_child(p_index)->set_meta(LW_NAME(_weight_), Variant(p_weight));
+	get_child(p_index)->emit_signal(LW_NAME(changed));
+	if (weights.size() == (uint32_t)get_child_count()) {
+		const double weight = MAX(p_weight, 0.0);
+		if (weight_tree.size() == weights.size() + 1 && !_is_failed(p_index)) {
+			// Changed during a run.
+			_tree_add(p_index, weight - weights[p_index]);
+		}
+		weights[p_index] = weight;
+	}
+}
+
+void BTProbabilitySelector::_cache_weights() {
+	weights.resize(get_child_count());
+	for (int i = 0; i < get_child_count(); i++) {
+		weights[i] = IS_CLASS(get_child(i), BTComment) ? 0.0 : MAX(_get_weight(i), 0.0);
+	}
+}
+
+void BTProbabilitySelector::_tree_add(int p_index, double p_delta) {
+	for (uint32_t i = p_index + 1; i < weight_tree.size(); i += i & (~i + 1)) {
+		weight_tree[i] += p_delta;
+	}
+}
+
+double BTProbabilitySelector::_tree_total() const {
+	double total = 0.0;
+	for (uint32_t i = weight_tree.size() - 1; i > 0; i -= i & (~i + 1)) {
+		total += weight_tree[i];
+	}
+	return total;
+}
+
+// Returns the index of the first child at which the cumulative weight reaches p_roll and is positive.
+int BTProbabilitySelector::_tree_find(double p_roll) const {
+	const uint32_t count = weight_tree.size() - 1;
+	uint32_t step = 1;
+	while ((step << 1) <= count) {
+		step <<= 1;
+	}
+	uint32_t pos = 0;
+	double sum = 0.0;
+	for (; step > 0; step >>= 1) {
+		const uint32_t next = pos + step;
+		if (next <= count) {
+			const double next_sum = sum + weight_tree[next];
+			if (next_sum < p_roll || next_sum <= 0.0) {
+				pos = next;
+				sum = next_sum;
+			}
+		}
+	}
+	return pos; // Zero-based index of the child following the prefix.
+}
+
+void BTProbabilitySelector::_setup() {
+	_cache_weights();
+}
+
 void BTProbabilitySelector::_enter() {
+	if (weights.size() != (uint32_t)get_child_count()) {
+		_cache_weights();
+	}
+	const int count = weights.size();
+
+	failed_mask.resize((count + 63) / 64);
+	for (uint64_t &bits : failed_mask) {
+		bits = 0;
+	}
+	_build_tree();
 	_select_task();
 }
 
+// Linear-time construction from the weights of children that haven't failed: each node passes its sum to the parent.
+void BTProbabilitySelector::_build_tree() {
+	const uint32_t count = weights.size();
+	weight_tree.resize(count + 1);
+	weight_tree[0] = 0.0;
+	for (uint32_t i = 0; i < count; i++) {
+		weight_tree[i + 1] = _is_failed(i) ? 0.0 : weights[i];
+	}
+	for (uint32_t i = 1; i <= count; i++) {
+		const uint32_t parent = i + (i & (~i + 1));
+		if (parent <= count) {
+			weight_tree[parent] += weight_tree[i];
+		}
+	}
+}
+
 void BTProbabilitySelector::_exit() {
-	failed_tasks.clear();
-	selected_task.unref();
+	weight_tree.clear();
+	selected_idx = -1;
 }
 
 BT::Status BTProbabilitySelector::_tick(double p_delta) {
-	while (selected_task.is_valid()) {
-		Status status = selected_task->execute(p_delta);
+	while (selected_idx >= 0) {
+		Status status = _get_child_ptr_unchecked(selected_idx)->execute(p_delta);
 		if (status == FAILURE) {
 			if (abort_on_failure) {
 				return FAILURE;
 			}
-			failed_tasks.insert(selected_task);
+			failed_mask[selected_idx >> 6] |= uint64_t(1) << (selected_idx & 63);
+			_tree_add(selected_idx, -weights[selected_idx]);
 			_select_task();
 		} else { // RUNNING or SUCCESS
 			return status;
@@ -89,30 +176,62 @@ BT::Status BTProbabilitySelector::_tick(double p_delta) {
 }
 
 void BTProbabilitySelector::_select_task() {
-	selected_task.unref();
-
-	double remaining_tasks_weight = _get_total_weight();
-	for (const Ref<BTTask> &task : failed_tasks) {
-		remaining_tasks_weight -= _get_weight(task);
+	selected_idx = -1;
+	const int count = weights.size();
+	if (count == 0) {
+		return;
 	}
 
-	double roll = RAND_RANGE(0.0, remaining_tasks_weight);
-	for (int i = 0; i < get_child_count(); i++) {
-		Ref<BTTask> task = get_child(i);
-		if (failed_tasks.has(task)) {
-			continue;
-		}
-		double weight = _get_weight(i);
-		if (weight == 0) {
-			continue;
+	const double remaining_tasks_weight = _tree_total();
+	if (remaining_tasks_weight <= 0.0) {
+		return;
+	}
+	int idx = MIN(_tree_find(_get_rng().randf_range(0.0, remaining_tasks_weight)), count - 1);
+	if (unlikely(!_is_selectable(idx))) {
+		// Rounding errors accumulated by removals can shift the boundaries slightly - pick the nearest remaining child.
+		int found = -1;
+		for (int i = idx + 1; i < count && found < 0; i++) {
+			found = _is_selectable(i) ? i : -1;
 		}
-		if (roll > weight) {
-			roll -= weight;
-			continue;
+		for (int i = idx - 1; i >= 0 && found < 0; i--) {
+			found = _is_selectable(i) ? i : -1;
 		}
+		idx = found;
+	}
+	selected_idx = idx;
+}
+
+void BTProbabilitySelector::_save_state(LimboSnapshotWriter &p_writer) const {
+	p_writer.put_i64(selected_idx);
+	p_writer.put_u32(failed_mask.size());
+	for (uint64_t bits : failed_mask) {
+		p_writer.put_u64(bits);
+	}
+}
 
-		selected_task = task;
-		break;
+void BTProbabilitySelector::_load_state(LimboSnapshotReader &p_reader) {
+	selected_idx = int(p_reader.get_i64());
+	const uint32_t words = p_reader.get_u32();
+	if (selected_idx >= get_child_count() || (words != 0 && words != uint32_t(get_child_count() + 63) / 64)) {
+		p_reader.set_failed();
+		return;
+	}
+	failed_mask.resize(words);
+	for (uint32_t i = 0; i < words; i++) {
+		failed_mask[i] = p_reader.get_u64();
+	}
+	weight_tree.clear();
+	if (get_status() == RUNNING) {
+		if (weights.size() != (uint32_t)get_child_count()) {
+			_cache_weights();
+		}
+		if (failed_mask.is_empty()) {
+			failed_mask.resize((weights.size() + 63) / 64);
+			for (uint64_t &bits : failed_mask) {
+				bits = 0;
+			}
+		}
+		_build_tree();
 	}
 }
 
@@ -18,11 +18,12 @@
 
 #ifdef LIMBOAI_MODULE
 #include "core/core_string_names.h"
+#include "core/templates/local_vector.h"
 #include "core/typedefs.h"
 #endif // LIMBOAI_MODULE
 
 #ifdef LIMBOAI_GDEXTENSION
-#include <godot_cpp/templates/hash_set.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
 #endif // LIMBOAI_GDEXTENSION
 
 class BTProbabilitySelector : public BTComposite {
@@ -30,18 +31,25 @@ class BTProbabilitySelector : public BTComposite {
 	TASK_CATEGORY(Composites);
 
 private:
-	HashSet<Ref<BTTask>> failed_tasks;
-	Ref<BTTask> selected_task;
+	// Child weights cached from metadata, zero for comments. Rebuilt if the number of children changes.
+	LocalVector<double> weights;
+	// Fenwick tree of weights of children that haven't failed during the current run (1-based).
+	LocalVector<double> weight_tree;
+	LocalVector<uint64_t> failed_mask;
+	int selected_idx = -1;
 	bool abort_on_failure = false;
 
+	void _cache_weights();
+	void _build_tree();
+	void _tree_add(int p_index, double p_delta);
+	double _tree_total() const;
+	int _tree_find(double p_roll) const;
+	_FORCE_INLINE_ bool _is_failed(int p_index) const { return failed_mask[p_index >> 6] & (uint64_t(1) << (p_index & 63)); }
+	_FORCE_INLINE_ bool _is_selectable(int p_index) const { return !_is_failed(p_index) && weights[p_index] > 0.0; }
 	void _select_task();
 #define SNAME(m_arg) ([]() -> const StringName & { static StringName sname = _scs_create(m_arg, true); return sname; })()
 	_FORCE_INLINE_ double _get_weight(int p_index) const { return get_child(p_index)->get_meta(LW_NAME(_weight_), 1.0); }
-	_FORCE_INLINE_ double _get_weight(Ref<BTTask> p_task) const { return p_task->get_meta(LW_NAME(_weight_), 1.0); }
-	_FORCE_INLINE_ void _set_weight(int p_index, double p_weight) {
-		get_child(p_index)->set_meta(LW_NAME(_weight_), Variant(p_weight));
-		get_child(p_index)->emit_signal(LW_NAME(changed));
-	}
+	void _set_weight(int p_index, double p_weight);
 	_FORCE_INLINE_ double _get_total_weight() const {
 		double total = 0.0;
 		for (int i = 0; i < get_child_count(); i++) {
@@ -55,9 +63,13 @@ private:
 protected:
 	static void _bind_methods();
 
+	virtual void _setup() override;
 	virtual void _enter() override;
 	virtual void _exit() override;
 	virtual Status _tick(double p_delta) override;
+	virtual void _save_state(LimboSnapshotWriter &p_writer) const override;
+	virtual void _load_state(LimboSnapshotReader &p_reader) override;
+	virtual bool _can_resume_running_child() const override { return true; }
 
 public:
 	double get_weight(int p_index) const;
@@ -11,25 +11,78 @@
 
 #include "bt_random_selector.h"
 
+void BTRandomSelector::set_seed(int64_t p_seed) {
+	seed = p_seed;
+	rng_seeded = false;
+	_task_changed();
+}
+
+void BTRandomSelector::_seed_rng() {
+	if (seed != 0) {
+		rng.seed(uint64_t(seed));
+	}
+	rng_seeded = true;
+}
+
+void BTRandomSelector::_reset_indices() {
+	indices.resize(get_child_count());
+	for (int i = 0; i < get_child_count(); i++) {
+		indices[i] = i;
+	}
+}
+
+void BTRandomSelector::_setup() {
+	_seed_rng();
+	_reset_indices();
+}
+
 void BTRandomSelector::_enter() {
 	last_running_idx = 0;
-	if (indicies.size() != get_child_count()) {
-		indicies.resize(get_child_count());
-		for (int i = 0; i < get_child_count(); i++) {
-			indicies[i] = i;
-		}
+	if (unlikely(!rng_seeded)) {
+		_seed_rng();
+	}
+	if (unlikely(indices.size() != (uint32_t)get_child_count())) {
+		_reset_indices();
 	}
-	indicies.shuffle();
+	// Zero seed: draw from the stream of the BTInstance.
+	(seed != 0 ? rng : _get_rng()).shuffle(indices);
 }
 
 BT::Status BTRandomSelector::_tick(double p_delta) {
-	Status status = FAILURE;
-	for (int i = last_running_idx; i < get_child_count(); i++) {
-		status = get_child(indicies[i])->execute(p_delta);
-		if (status != FAILURE) {
-			last_running_idx = i;
-			break;
-		}
+	return _tick_in_order<FAILURE>(p_delta, last_running_idx, [this](int p_idx) { return int(indices[p_idx]); });
+}
+
+void BTRandomSelector::_save_state(LimboSnapshotWriter &p_writer) const {
+	p_writer.put_u32(last_running_idx);
+	p_writer.put_u32(indices.size());
+	for (uint32_t idx : indices) {
+		p_writer.put_u32(idx);
+	}
+	p_writer.put_u64(rng.state);
+	p_writer.put_u64(rng.inc);
+}
+
+void BTRandomSelector::_load_state(LimboSnapshotReader &p_reader) {
+	last_running_idx = p_reader.get_u32();
+	const uint32_t count = p_reader.get_u32();
+	if (count != (uint32_t)get_child_count()) {
+		p_reader.set_failed();
+		return;
 	}
-	return status;
+	indices.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		indices[i] = MIN(p_reader.get_u32(), count - 1);
+	}
+	rng.state = p_reader.get_u64();
+	rng.inc = p_reader.get_u64();
+	rng_seeded = true;
+}
+
+//**** Godot
+
+void BTRandomSelector::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_seed", "seed"), &BTRandomSelector::set_seed);
+	ClassDB::bind_method(D_METHOD("get_seed"), &BTRandomSelector::get_seed);
+
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "seed"), "set_seed", "get_seed");
 }
@@ -14,19 +14,36 @@
 
 #include "../bt_composite.h"
 
+#include "../../../util/limbo_rng.h"
+
 class BTRandomSequence : public BTComposite {
 	GDCLASS(BTRandomSequence, BTComposite);
 	TASK_CATEGORY(Composites);
 
 private:
 	int last_running_idx = 0;
-	Array indicies;
+	int64_t seed = 0;
+	LimboRNG rng; // Own stream, used instead of the BTInstance stream if seed is set.
+	bool rng_seeded = false;
+	// Execution order, sized once and shuffled in place on each entry.
+	LocalVector<uint32_t> indices;
+
+	void _seed_rng();
+	void _reset_indices();
 
 protected:
-	static void _bind_methods() {}
+	static void _bind_methods();
 
+	virtual void _setup() override;
 	virtual void _enter() override;
 	virtual Status _tick(double p_delta) override;
+	virtual void _save_state(LimboSnapshotWriter &p_writer) const override;
+	virtual void _load_state(LimboSnapshotReader &p_reader) override;
+	virtual bool _can_resume_running_child() const override { return true; }
+
+public:
+	void set_seed(int64_t p_seed);
+	int64_t get_seed() const { return seed; }
 };
 
 #endif // BT_RANDOM_SEQUENCE_H
@@ -16,13 +16,9 @@ void BTSelector::_enter() {
 }
 
 BT::Status BTSelector::_tick(double p_delta) {
-	Status status = FAILURE;
-	for (int i = last_running_idx; i < get_child_count(); i++) {
-		status = get_child(i)->execute(p_delta);
-		if (status != FAILURE) {
-			last_running_idx = i;
-			break;
-		}
-	}
-	return status;
+	return _tick_in_order<FAILURE>(p_delta, last_running_idx);
+}
+
+void BTSelector::_tick_batch(const TaskBatchContext &p_batch) {
+	_tick_batch_in_order<FAILURE>(p_batch, &BTSelector::last_running_idx);
 }
@@ -16,13 +16,9 @@ void BTSequence::_enter() {
 }
 
 BT::Status BTSequence::_tick(double p_delta) {
-	Status status = SUCCESS;
-	for (int i = last_running_idx; i < get_child_count(); i++) {
-		status = get_child(i)->execute(p_delta);
-		if (status != SUCCESS) {
-			last_running_idx = i;
-			break;
-		}
-	}
-	return status;
+	return _tick_in_order<SUCCESS>(p_delta, last_running_idx);
+}
+
+void BTSequence::_tick_batch(const TaskBatchContext &p_batch) {
+	_tick_batch_in_order<SUCCESS>(p_batch, &BTSequence::last_running_idx);
 }
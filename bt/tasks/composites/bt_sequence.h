@@ -17,6 +17,10 @@
 class BTSequence : public BTComposite {
 	GDCLASS(BTSequence, BTComposite);
 	TASK_CATEGORY(Composites);
+	TASK_THREAD_SAFE();
+	TASK_PURE();
+
+	friend class BTInstance;
 
 private:
 	int last_running_idx = 0;
@@ -26,6 +30,10 @@ protected:
 
 	virtual void _enter() override;
 	virtual Status _tick(double p_delta) override;
+	virtual void _tick_batch(const TaskBatchContext &p_batch) override;
+	virtual void _save_state(LimboSnapshotWriter &p_writer) const override { p_writer.put_u32(last_running_idx); }
+	virtual void _load_state(LimboSnapshotReader &p_reader) override { last_running_idx = p_reader.get_u32(); }
+	virtual bool _can_resume_running_child() const override { return true; }
 };
 
 #endif // BT_SEQUENCE_H
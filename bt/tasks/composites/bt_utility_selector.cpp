@@ -0,0 +1,345 @@
+/**
+ * bt_utility_selector.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "bt_utility_selector.h"
+
+#include "../../../util/limbo_compat.h"
+
+SpinLock BTUtilitySelector::batches_lock;
+LocalVector<BTUtilitySelector::Batch *> BTUtilitySelector::batches;
+uint64_t BTUtilitySelector::batch_generation = 1; // Never matches a consumed stamp.
+
+//**** Scoring
+
+void BTUtilitySelector::score_considerations(const Layout &p_layout, const float *p_inputs, float *r_outputs, uint32_t p_instances) {
+	const float *input_min = p_layout.input_min.ptr();
+	const float *input_scale = p_layout.input_scale.ptr();
+	const float *samples = p_layout.curve_samples.ptr();
+	const uint32_t num_considerations = p_layout.size();
+	// Inputs of several instances can be scored in one call, laid out one instance after another.
+	for (uint32_t k = 0; k < p_instances; k++) {
+		const float *in = p_inputs + k * num_considerations;
+		float *out = r_outputs + k * num_considerations;
+		for (uint32_t c = 0; c < num_considerations; c++) {
+			const float t = CLAMP((in[c] - input_min[c]) * input_scale[c], 0.0f, 1.0f);
+			const float f = t * float(CURVE_SAMPLES - 1);
+			const int idx = MIN(int(f), CURVE_SAMPLES - 2);
+			const float *curve = samples + c * CURVE_SAMPLES;
+			out[c] = curve[idx] + (curve[idx + 1] - curve[idx]) * (f - float(idx));
+		}
+	}
+}
+
+void BTUtilitySelector::combine_scores(const Layout &p_layout, const float *p_outputs, float *r_scores) {
+	for (uint32_t c = 0; c < p_layout.child_count; c++) {
+		r_scores[c] = 0.0f;
+	}
+	for (uint32_t i = 0; i < p_layout.size(); i++) {
+		r_scores[p_layout.child_index[i]] = 1.0f;
+	}
+	for (uint32_t i = 0; i < p_layout.size(); i++) {
+		r_scores[p_layout.child_index[i]] *= p_outputs[i];
+	}
+}
+
+//**** Batches
+
+BTUtilitySelector::Batch *BTUtilitySelector::_get_batch() const {
+	batches_lock.lock();
+	if (batch == nullptr) {
+		batch = memnew(Batch);
+		batch->refcount.init();
+		batches.push_back(batch);
+	}
+	batches_lock.unlock();
+	return batch;
+}
+
+void BTUtilitySelector::_join_batch(Batch *p_batch) {
+	batches_lock.lock();
+	p_batch->refcount.ref();
+	p_batch->members.push_back(this);
+	batch = p_batch;
+	batches_lock.unlock();
+}
+
+void BTUtilitySelector::_leave_batch() {
+	if (batch == nullptr) {
+		return;
+	}
+	batches_lock.lock();
+	batch->members.erase(this);
+	if (batch->refcount.unref()) {
+		batches.erase(batch);
+		memdelete(batch);
+	}
+	batch = nullptr;
+	batches_lock.unlock();
+}
+
+void BTUtilitySelector::prepare_batches() {
+	batches_lock.lock();
+	batch_generation += 1;
+	for (Batch *b : batches) {
+		b->due.clear();
+		for (BTUtilitySelector *member : b->members) {
+			if (member->due_next_tick && member->get_status() == RUNNING && member->get_blackboard().is_valid() &&
+					(b->due.is_empty() || member->layout.size() == b->due[0]->layout.size())) {
+				b->due.push_back(member);
+			}
+		}
+		if (b->due.size() < 2) {
+			continue; // Scored on tick - nothing to share.
+		}
+
+		// One row of inputs per member, scored in a single pass with the layout they share.
+		const uint32_t row_size = b->due[0]->layout.size();
+		b->inputs.resize(b->due.size() * row_size);
+		b->outputs.resize(b->due.size() * row_size);
+		for (uint32_t r = 0; r < b->due.size(); r++) {
+			b->due[r]->_gather_inputs(b->inputs.ptr() + r * row_size);
+		}
+		score_considerations(b->due[0]->layout, b->inputs.ptr(), b->outputs.ptr(), b->due.size());
+		for (uint32_t r = 0; r < b->due.size(); r++) {
+			BTUtilitySelector *member = b->due[r];
+			combine_scores(member->layout, b->outputs.ptr() + r * row_size, member->scores.ptr());
+			member->prepared_generation = batch_generation;
+		}
+	}
+	batches_lock.unlock();
+}
+
+void BTUtilitySelector::finish_batches() {
+	batches_lock.lock();
+	batch_generation += 1;
+	batches_lock.unlock();
+}
+
+Ref<BTTask> BTUtilitySelector::clone() const {
+	Ref<BTUtilitySelector> inst = BTComposite::clone();
+	if (inst.is_valid() && inst->is_runtime_clone()) {
+		inst->_join_batch(_get_batch());
+	}
+	return inst;
+}
+
+//**** Setters / Getters
+
+TypedArray<BTConsideration> BTUtilitySelector::get_considerations(int p_index) const {
+	ERR_FAIL_INDEX_V(p_index, get_child_count(), TypedArray<BTConsideration>());
+	return _get_considerations(p_index);
+}
+
+void BTUtilitySelector::set_considerations(int p_index, const TypedArray<BTConsideration> &p_considerations) {
+	ERR_FAIL_INDEX(p_index, get_child_count());
+	ERR_FAIL_COND(IS_CLASS(get_child(p_index), BTComment));
+	get_child(p_index)->set_meta(LW_NAME(_considerations_), p_considerations);
+	get_child(p_index)->emit_signal(LW_NAME(changed));
+	layout.child_count = 0; // Recompiled on the next run.
+}
+
+void BTUtilitySelector::set_reevaluation_interval(double p_interval) {
+	reevaluation_interval = p_interval;
+	_task_changed();
+}
+
+double BTUtilitySelector::get_score(int p_index) const {
+	ERR_FAIL_INDEX_V(p_index, get_child_count(), 0.0);
+	return p_index < int(scores.size()) ? scores[p_index] : 0.0;
+}
+
+//**** Task Implementation
+
+PackedStringArray BTUtilitySelector::get_configuration_warnings() {
+	PackedStringArray warnings = BTComposite::get_configuration_warnings();
+	for (int i = 0; i < get_child_count(); i++) {
+		if (!IS_CLASS(get_child(i), BTComment) && _get_considerations(i).is_empty()) {
+			warnings.append(vformat("Child %d has no considerations and is never selected.", i));
+		}
+	}
+	return warnings;
+}
+
+String BTUtilitySelector::validate_runtime(LocalVector<StringName> &r_read_vars, LocalVector<StringName> &r_written_vars) const {
+	const String error = BTComposite::validate_runtime(r_read_vars, r_written_vars);
+	if (!error.is_empty()) {
+		return error;
+	}
+	bool any = false;
+	for (int i = 0; i < get_child_count(); i++) {
+		const TypedArray<BTConsideration> considerations = _get_considerations(i);
+		for (int j = 0; j < considerations.size(); j++) {
+			const Ref<BTConsideration> consideration = considerations[j];
+			if (consideration.is_null() || consideration->get_variable() == StringName()) {
+				return vformat("Consideration %d of child %d has no variable.", j, i);
+			}
+			r_read_vars.push_back(consideration->get_variable());
+			any = true;
+		}
+	}
+	if (!any) {
+		return "No child has considerations.";
+	}
+	return String();
+}
+
+void BTUtilitySelector::_compile() {
+	layout = Layout();
+	layout.child_count = get_child_count();
+	for (int i = 0; i < get_child_count(); i++) {
+		const TypedArray<BTConsideration> considerations = _get_considerations(i);
+		for (int j = 0; j < considerations.size(); j++) {
+			const Ref<BTConsideration> consideration = considerations[j];
+			if (consideration.is_null()) {
+				continue; // Reported by validate_runtime().
+			}
+			const double range = consideration->get_input_max() - consideration->get_input_min();
+			layout.input_min.push_back(consideration->get_input_min());
+			layout.input_scale.push_back(range == 0.0 ? 0.0 : 1.0 / range);
+			layout.child_index.push_back(i);
+			layout.variables.push_back(consideration->get_variable());
+			const Ref<Curve> curve = consideration->get_curve();
+			for (int s = 0; s < CURVE_SAMPLES; s++) {
+				const float t = float(s) / float(CURVE_SAMPLES - 1);
+				layout.curve_samples.push_back(curve.is_valid() ? float(curve->sample_baked(t)) : t);
+			}
+		}
+	}
+
+	input_handles.resize(layout.size());
+	for (uint32_t i = 0; i < layout.size(); i++) {
+		input_handles[i] = get_blackboard().is_valid() ? get_blackboard()->get_var_handle(layout.variables[i]) : BBVarHandle();
+	}
+	inputs.resize(layout.size());
+	outputs.resize(layout.size());
+	scores.resize(layout.child_count);
+	tried.resize(layout.child_count);
+}
+
+void BTUtilitySelector::_gather_inputs(float *r_inputs) {
+	const Ref<Blackboard> &bb = get_blackboard();
+	for (uint32_t i = 0; i < input_handles.size(); i++) {
+		r_inputs[i] = float(bb->get_var_by_handle(input_handles[i], 0.0, false));
+	}
+}
+
+void BTUtilitySelector::_evaluate() {
+	since_evaluation = 0.0;
+	if (prepared_generation == batch_generation) {
+		prepared_generation = 0; // Already scored together with other clones this frame.
+		return;
+	}
+	ERR_FAIL_COND_MSG(get_blackboard().is_null(), "BTUtilitySelector: Task is not initialized.");
+	_gather_inputs(inputs.ptr());
+	score_considerations(layout, inputs.ptr(), outputs.ptr(), 1);
+	combine_scores(layout, outputs.ptr(), scores.ptr());
+}
+
+int BTUtilitySelector::_find_best() const {
+	int best = -1;
+	float best_score = 0.0f;
+	for (uint32_t i = 0; i < scores.size(); i++) {
+		if (scores[i] > best_score && !tried[i]) {
+			best = i;
+			best_score = scores[i];
+		}
+	}
+	return best;
+}
+
+void BTUtilitySelector::_setup() {
+	_compile();
+}
+
+void BTUtilitySelector::_enter() {
+	if (layout.child_count != uint32_t(get_child_count())) {
+		_compile();
+	}
+	for (uint32_t i = 0; i < tried.size(); i++) {
+		tried[i] = false;
+	}
+	selected_idx = -1;
+	since_evaluation = 0.0;
+}
+
+void BTUtilitySelector::_exit() {
+	selected_idx = -1;
+}
+
+BT::Status BTUtilitySelector::_tick(double p_delta) {
+	since_evaluation += p_delta;
+	if (selected_idx == -1 || since_evaluation >= reevaluation_interval) {
+		_evaluate();
+		const int best = _find_best();
+		if (selected_idx == -1) {
+			selected_idx = best;
+		} else if (best != -1 && best != selected_idx && scores[best] > scores[selected_idx]) {
+			// A better option appeared while the selected child was running.
+			_get_child_ptr_unchecked(selected_idx)->abort();
+			selected_idx = best;
+		}
+	}
+
+	// * Trees updated in other modes may be ticked at any time, so scores prepared by the scheduler could be stale for them.
+	due_next_tick = _is_scheduled_update() && since_evaluation + p_delta >= reevaluation_interval;
+
+	while (selected_idx != -1) {
+		const Status status = _get_child_ptr_unchecked(selected_idx)->execute(p_delta);
+		if (status != FAILURE) {
+			return status;
+		}
+		tried[selected_idx] = true;
+		selected_idx = _find_best(); // Next best option, by the scores of the last evaluation.
+	}
+	return FAILURE;
+}
+
+void BTUtilitySelector::_save_state(LimboSnapshotWriter &p_writer) const {
+	p_writer.put_i64(selected_idx);
+	p_writer.put_u32(tried.size());
+	for (uint32_t i = 0; i < tried.size(); i++) {
+		p_writer.put_u8(tried[i]);
+	}
+}
+
+void BTUtilitySelector::_load_state(LimboSnapshotReader &p_reader) {
+	selected_idx = int(p_reader.get_i64());
+	const uint32_t count = p_reader.get_u32();
+	if (selected_idx >= get_child_count() || (count != 0 && count != uint32_t(get_child_count()))) {
+		p_reader.set_failed();
+		return;
+	}
+	if (layout.child_count != uint32_t(get_child_count())) {
+		_compile();
+	}
+	for (uint32_t i = 0; i < count; i++) {
+		tried[i] = p_reader.get_u8() != 0;
+	}
+	// Scores aren't saved: evaluated again on the next tick.
+	since_evaluation = reevaluation_interval;
+}
+
+BTUtilitySelector::~BTUtilitySelector() {
+	_leave_batch();
+}
+
+//**** Godot
+
+void BTUtilitySelector::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("get_considerations", "child_idx"), &BTUtilitySelector::get_considerations);
+	ClassDB::bind_method(D_METHOD("set_considerations", "child_idx", "considerations"), &BTUtilitySelector::set_considerations);
+	ClassDB::bind_method(D_METHOD("set_reevaluation_interval", "interval"), &BTUtilitySelector::set_reevaluation_interval);
+	ClassDB::bind_method(D_METHOD("get_reevaluation_interval"), &BTUtilitySelector::get_reevaluation_interval);
+	ClassDB::bind_method(D_METHOD("get_score", "child_idx"), &BTUtilitySelector::get_score);
+	ClassDB::bind_method(D_METHOD("get_selected_index"), &BTUtilitySelector::get_selected_index);
+
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "reevaluation_interval", PROPERTY_HINT_RANGE, "0.0,60.0,0.01,or_greater,suffix:s"), "set_reevaluation_interval", "get_reevaluation_interval");
+}
@@ -0,0 +1,135 @@
+/**
+ * bt_utility_selector.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef BT_UTILITY_SELECTOR_H
+#define BT_UTILITY_SELECTOR_H
+
+#include "../bt_composite.h"
+#include "bt_consideration.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/os/spin_lock.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/templates/safe_refcount.hpp>
+#include <godot_cpp/templates/spin_lock.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+class BTUtilitySelector : public BTComposite {
+	GDCLASS(BTUtilitySelector, BTComposite);
+	TASK_CATEGORY(Composites);
+	TASK_THREAD_SAFE();
+
+public:
+	static constexpr int CURVE_SAMPLES = 32;
+
+	// Considerations of all children flattened into parallel arrays, compiled on setup.
+	// Inputs are gathered from the blackboard, then scored in one branchless pass over the arrays.
+	struct Layout {
+		LocalVector<float> input_min;
+		LocalVector<float> input_scale; // 1 / (max - min), or 0 if the range is empty.
+		LocalVector<float> curve_samples; // CURVE_SAMPLES per consideration; a linear ramp if there is no curve.
+		LocalVector<uint32_t> child_index;
+		LocalVector<StringName> variables;
+		uint32_t child_count = 0;
+
+		_FORCE_INLINE_ uint32_t size() const { return child_index.size(); }
+	};
+
+	// Samples the curve of each consideration at its normalized input. Inputs and outputs hold p_instances
+	// consecutive runs of p_layout.size() values, so that instances sharing a layout can be scored together.
+	static void score_considerations(const Layout &p_layout, const float *p_inputs, float *r_outputs, uint32_t p_instances);
+	// Multiplies consideration outputs into child scores. Children without considerations score 0.
+	static void combine_scores(const Layout &p_layout, const float *p_outputs, float *r_scores);
+
+private:
+	// Runtime clones of the same selector, e.g. in all agents running a BehaviorTree.
+	// The scheduler scores the ones that are due for reevaluation together, see prepare_batches().
+	struct Batch {
+		SafeRefCount refcount;
+		LocalVector<BTUtilitySelector *> members;
+		LocalVector<BTUtilitySelector *> due;
+		LocalVector<float> inputs;
+		LocalVector<float> outputs;
+	};
+
+	static SpinLock batches_lock;
+	static LocalVector<Batch *> batches;
+	static uint64_t batch_generation;
+
+	double reevaluation_interval = 0.5;
+
+	mutable Batch *batch = nullptr; // Created lazily in the source task, when it is first cloned.
+	uint64_t prepared_generation = 0; // Scores were computed by prepare_batches() of this generation.
+	bool due_next_tick = false; // Last ticked by BTScheduler and will reevaluate on the next tick.
+
+	Layout layout;
+	LocalVector<BBVarHandle> input_handles;
+	LocalVector<float> inputs;
+	LocalVector<float> outputs;
+	LocalVector<float> scores;
+	LocalVector<bool> tried; // Children that failed during the current run.
+	int selected_idx = -1;
+	double since_evaluation = 0.0;
+
+	_FORCE_INLINE_ TypedArray<BTConsideration> _get_considerations(int p_index) const {
+		return get_child(p_index)->get_meta(LW_NAME(_considerations_), TypedArray<BTConsideration>());
+	}
+	void _compile();
+	void _gather_inputs(float *r_inputs);
+	void _evaluate();
+	Batch *_get_batch() const;
+	void _join_batch(Batch *p_batch);
+	void _leave_batch();
+	int _find_best() const;
+
+protected:
+	static void _bind_methods();
+
+	virtual void _setup() override;
+	virtual void _enter() override;
+	virtual void _exit() override;
+	virtual Status _tick(double p_delta) override;
+	virtual void _save_state(LimboSnapshotWriter &p_writer) const override;
+	virtual void _load_state(LimboSnapshotReader &p_reader) override;
+
+public:
+	// Considerations are stored in the metadata of the children.
+	TypedArray<BTConsideration> get_considerations(int p_index) const;
+	void set_considerations(int p_index, const TypedArray<BTConsideration> &p_considerations);
+
+	void set_reevaluation_interval(double p_interval);
+	double get_reevaluation_interval() const { return reevaluation_interval; }
+
+	// Score of the child from the last evaluation, or 0 if it wasn't evaluated.
+	double get_score(int p_index) const;
+	int get_selected_index() const { return selected_idx; }
+	_FORCE_INLINE_ const Layout &get_layout() const { return layout; }
+
+	// Called by BTScheduler before updating its players: scores the running clones of each selector that will
+	// reevaluate on their next tick in one kernel call per selector. Only clones last ticked by the scheduler take part -
+	// trees updated in other modes evaluate on tick. Main thread only, while no trees are ticked.
+	static void prepare_batches();
+	// Called by BTScheduler after updating its players: scores prepared for clones that weren't ticked are discarded.
+	static void finish_batches();
+
+	virtual Ref<BTTask> clone() const override;
+	virtual PackedStringArray get_configuration_warnings() override;
+	virtual String validate_runtime(LocalVector<StringName> &r_read_vars, LocalVector<StringName> &r_written_vars) const override;
+
+	~BTUtilitySelector();
+};
+
+#endif // BT_UTILITY_SELECTOR_H
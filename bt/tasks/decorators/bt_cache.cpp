@@ -0,0 +1,144 @@
+/**
+ * bt_cache.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "bt_cache.h"
+
+#include "../../../util/limbo_timer_wheel.h"
+#include "../../../util/limbo_utility.h"
+
+//**** Setters / Getters
+
+void BTCache::set_duration(double p_value) {
+	duration = p_value;
+	_task_changed();
+}
+
+void BTCache::set_max_ticks(int p_value) {
+	max_ticks = MAX(0, p_value);
+	_task_changed();
+}
+
+void BTCache::set_use_instance_clock(bool p_value) {
+	use_instance_clock = p_value;
+	_task_changed();
+}
+
+void BTCache::set_input_vars(const TypedArray<StringName> &p_vars) {
+	input_vars = p_vars;
+	_task_changed();
+}
+
+//**** Task Implementation
+
+PackedStringArray BTCache::get_configuration_warnings() {
+	PackedStringArray warnings = BTDecorator::get_configuration_warnings();
+	if (duration <= 0.0 && max_ticks == 0 && input_vars.is_empty()) {
+		warnings.append("The result is cached until the tree is set up again. Set duration, max_ticks or input_vars to expire it.");
+	}
+	return warnings;
+}
+
+String BTCache::_generate_name() {
+	PackedStringArray limits;
+	if (duration > 0.0) {
+		limits.push_back(vformat("%s sec", Math::snapped(duration, 0.001)));
+	}
+	if (max_ticks > 0) {
+		limits.push_back(vformat("%d ticks", max_ticks));
+	}
+	String name = limits.is_empty() ? "Cache" : "Cache " + String(", ").join(limits);
+	if (!input_vars.is_empty()) {
+		PackedStringArray vars;
+		for (int i = 0; i < input_vars.size(); i++) {
+			vars.push_back(LimboUtility::get_singleton()->decorate_var(input_vars[i]));
+		}
+		name += " by " + String(", ").join(vars);
+	}
+	return name;
+}
+
+void BTCache::_setup() {
+	cached_status = FRESH;
+	num_hits = 0;
+	input_handles.resize(input_vars.size());
+	input_versions.resize(input_vars.size());
+	for (int i = 0; i < input_vars.size(); i++) {
+		input_handles[i] = get_blackboard()->get_var_handle(input_vars[i]);
+	}
+}
+
+double BTCache::_get_time() const {
+	return _uses_instance_clock() ? get_instance_time() : LimboTimerWheel::get(false)->get_time();
+}
+
+bool BTCache::_is_cache_valid() {
+	if (cached_status == FRESH) {
+		return false;
+	}
+	if (duration > 0.0 && _get_time() >= cached_until) {
+		return false;
+	}
+	if (max_ticks > 0 && num_hits >= max_ticks) {
+		return false;
+	}
+	// * Versions change on every write, so comparing them doesn't read the values.
+	const Ref<Blackboard> &bb = get_blackboard();
+	for (uint32_t i = 0; i < input_handles.size(); i++) {
+		const int64_t version = bb->get_var_version(input_handles[i]);
+		if (version != input_versions[i] || version == -1) {
+			return false;
+		}
+	}
+	return true;
+}
+
+BT::Status BTCache::_tick(double p_delta) {
+	LIMBO_ERR_FAIL_COND_V_MSG(get_child_count() == 0, FAILURE, "BT decorator has no child.");
+	if (_is_cache_valid()) {
+		num_hits += 1;
+		return cached_status;
+	}
+
+	Status status = _get_child_ptr_unchecked(0)->execute(p_delta);
+	if (status == RUNNING) {
+		// * Only final results are cached.
+		cached_status = FRESH;
+		return status;
+	}
+	cached_status = status;
+	cached_until = _get_time() + duration;
+	num_hits = 0;
+	const Ref<Blackboard> &bb = get_blackboard();
+	for (uint32_t i = 0; i < input_handles.size(); i++) {
+		input_versions[i] = bb->get_var_version(input_handles[i]);
+	}
+	return status;
+}
+
+//**** Godot
+
+void BTCache::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_duration", "duration"), &BTCache::set_duration);
+	ClassDB::bind_method(D_METHOD("get_duration"), &BTCache::get_duration);
+	ClassDB::bind_method(D_METHOD("set_max_ticks", "ticks"), &BTCache::set_max_ticks);
+	ClassDB::bind_method(D_METHOD("get_max_ticks"), &BTCache::get_max_ticks);
+	ClassDB::bind_method(D_METHOD("set_use_instance_clock", "enable"), &BTCache::set_use_instance_clock);
+	ClassDB::bind_method(D_METHOD("get_use_instance_clock"), &BTCache::get_use_instance_clock);
+	ClassDB::bind_method(D_METHOD("set_input_vars", "variables"), &BTCache::set_input_vars);
+	ClassDB::bind_method(D_METHOD("get_input_vars"), &BTCache::get_input_vars);
+	ClassDB::bind_method(D_METHOD("invalidate"), &BTCache::invalidate);
+	ClassDB::bind_method(D_METHOD("has_cached_result"), &BTCache::has_cached_result);
+
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "duration"), "set_duration", "get_duration");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "max_ticks", PROPERTY_HINT_RANGE, "0,1000,1,or_greater"), "set_max_ticks", "get_max_ticks");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_instance_clock"), "set_use_instance_clock", "get_use_instance_clock");
+	ADD_PROPERTY(PropertyInfo(Variant::ARRAY, "input_vars", PROPERTY_HINT_ARRAY_TYPE, "StringName"), "set_input_vars", "get_input_vars");
+}
@@ -0,0 +1,73 @@
+/**
+ * bt_cache.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef BT_CACHE_H
+#define BT_CACHE_H
+
+#include "../bt_decorator.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/templates/local_vector.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/templates/local_vector.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+class BTCache : public BTDecorator {
+	GDCLASS(BTCache, BTDecorator);
+	TASK_CATEGORY(Decorators);
+
+private:
+	double duration = 1.0;
+	int max_ticks = 0;
+	bool use_instance_clock = false;
+	TypedArray<StringName> input_vars;
+
+	// Resolved in _setup(), with the versions of the inputs when the result was cached.
+	LocalVector<BBVarHandle> input_handles;
+	LocalVector<int64_t> input_versions;
+
+	Status cached_status = FRESH; // FRESH while nothing is cached.
+	double cached_until = 0.0;
+	int num_hits = 0;
+
+	_FORCE_INLINE_ bool _uses_instance_clock() const { return use_instance_clock && has_instance_clock(); }
+	double _get_time() const;
+	bool _is_cache_valid();
+
+protected:
+	static void _bind_methods();
+
+	virtual String _generate_name() override;
+	virtual void _setup() override;
+	virtual Status _tick(double p_delta) override;
+
+public:
+	void set_duration(double p_value);
+	double get_duration() const { return duration; }
+
+	void set_max_ticks(int p_value);
+	int get_max_ticks() const { return max_ticks; }
+
+	void set_use_instance_clock(bool p_value);
+	bool get_use_instance_clock() const { return use_instance_clock; }
+
+	void set_input_vars(const TypedArray<StringName> &p_vars);
+	TypedArray<StringName> get_input_vars() const { return input_vars; }
+
+	void invalidate() { cached_status = FRESH; }
+	bool has_cached_result() const { return cached_status != FRESH; }
+
+	virtual PackedStringArray get_configuration_warnings() override;
+};
+
+#endif // BT_CACHE_H
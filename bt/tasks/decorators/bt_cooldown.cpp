@@ -11,39 +11,40 @@
 
 #include "bt_cooldown.h"
 
-#ifdef LIMBOAI_MODULE
-#include "scene/main/scene_tree.h"
-#endif
-
-#ifdef LIMBOAI_GDEXTENSION
-#include <godot_cpp/classes/scene_tree.hpp>
-#endif
+#include "../../../util/limbo_timer_wheel.h"
 
 //**** Setters / Getters
 
 void BTCooldown::set_duration(double p_value) {
 	duration = p_value;
-	emit_changed();
+	_task_changed();
 }
 
 void BTCooldown::set_process_pause(bool p_value) {
 	process_pause = p_value;
-	emit_changed();
+	_task_changed();
+}
+
+void BTCooldown::set_use_instance_clock(bool p_value) {
+	use_instance_clock = p_value;
+	_task_changed();
 }
 
 void BTCooldown::set_start_cooled(bool p_value) {
 	start_cooled = p_value;
-	emit_changed();
+	_task_changed();
 }
 
 void BTCooldown::set_trigger_on_failure(bool p_value) {
 	trigger_on_failure = p_value;
-	emit_changed();
+	_task_changed();
 }
 
 void BTCooldown::set_cooldown_state_var(const StringName &p_value) {
 	cooldown_state_var = p_value;
-	emit_changed();
+	cooldown_state_handle = BBVarHandle();
+	cooldown_state_handle.name = p_value;
+	_task_changed();
 }
 
 //**** Task Implementation
@@ -53,21 +54,43 @@ String BTCooldown::_generate_name() {
 }
 
 void BTCooldown::_setup() {
-	if (cooldown_state_var == StringName()) {
-		cooldown_state_var = vformat("cooldown_%d", get_instance_id());
+	cooldown_end = 0.0;
+	timer_id = 0;
+	chill_pending = false;
+	state_reset_pending = false;
+	if (cooldown_state_var != StringName()) {
+		get_blackboard()->set_var(cooldown_state_var, start_cooled && use_instance_clock);
+		cooldown_state_handle = get_blackboard()->get_var_handle(cooldown_state_var);
 	}
-	get_blackboard()->set_var(cooldown_state_var, false);
 	if (start_cooled) {
-		_chill();
+		if (use_instance_clock) {
+			chill_pending = true;
+		} else {
+			_chill();
+		}
 	}
 }
 
 BT::Status BTCooldown::_tick(double p_delta) {
-	ERR_FAIL_COND_V_MSG(get_child_count() == 0, FAILURE, "BT decorator has no child.");
-	if (get_blackboard()->get_var(cooldown_state_var, true)) {
+	LIMBO_ERR_FAIL_COND_V_MSG(get_child_count() == 0, FAILURE, "BT decorator has no child.");
+	if (unlikely(chill_pending)) {
+		chill_pending = false;
+		_chill();
+	}
+	if (state_reset_pending && get_instance_time() >= cooldown_end) {
+		state_reset_pending = false;
+		get_blackboard()->set_var_by_handle(cooldown_state_handle, false);
+	}
+	if (cooldown_state_var == StringName()) {
+		const double now = _uses_instance_clock() ? get_instance_time() : LimboTimerWheel::get(process_pause)->get_time();
+		if (now < cooldown_end) {
+			return FAILURE;
+		}
+	} else if (get_blackboard()->get_var_by_handle(cooldown_state_handle, true)) {
+		// The state variable can be shared with other tasks, or reset from outside.
 		return FAILURE;
 	}
-	Status status = get_child(0)->execute(p_delta);
+	Status status = _get_child_ptr_unchecked(0)->execute(p_delta);
 	if (status == SUCCESS || (trigger_on_failure && status == FAILURE)) {
 		_chill();
 	}
@@ -75,19 +98,37 @@ BT::Status BTCooldown::_tick(double p_delta) {
 }
 
 void BTCooldown::_chill() {
-	get_blackboard()->set_var(cooldown_state_var, true);
-	if (timer.is_valid()) {
-		timer->set_time_left(duration);
-	} else {
-		timer = SCENE_TREE()->create_timer(duration, process_pause);
-		ERR_FAIL_NULL(timer);
-		timer->connect(LW_NAME(timeout), callable_mp(this, &BTCooldown::_on_timeout), CONNECT_ONE_SHOT);
+	if (_uses_instance_clock()) {
+		// * Follows the agent's own time: scaled, paused and fast-forwarded with its BTInstance.
+		cooldown_end = get_instance_time() + duration;
+		if (cooldown_state_var != StringName()) {
+			get_blackboard()->set_var_by_handle(cooldown_state_handle, true);
+			state_reset_pending = true;
+		}
+		return;
+	}
+	LimboTimerWheel *wheel = LimboTimerWheel::get(process_pause);
+	cooldown_end = wheel->get_time() + duration;
+	if (cooldown_state_var != StringName()) {
+		// Only a named state variable needs a timer: it has to be reset when the cooldown ends.
+		get_blackboard()->set_var_by_handle(cooldown_state_handle, true);
+		timer_id = wheel->schedule(duration, this, &BTCooldown::_timeout_callback);
 	}
 }
 
 void BTCooldown::_on_timeout() {
-	get_blackboard()->set_var(cooldown_state_var, false);
-	timer.unref();
+	timer_id = 0;
+	if (cooldown_state_var != StringName() && get_blackboard().is_valid()) {
+		get_blackboard()->set_var_by_handle(cooldown_state_handle, false);
+	}
+}
+
+void BTCooldown::_timeout_callback(Object *p_owner, uint32_t p_timer_id) {
+	BTCooldown *cooldown = Object::cast_to<BTCooldown>(p_owner);
+	// Ignoring timers replaced by a later _chill().
+	if (cooldown && cooldown->timer_id == p_timer_id) {
+		cooldown->_on_timeout();
+	}
 }
 
 //**** Godot
@@ -97,6 +138,8 @@ void BTCooldown::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_duration"), &BTCooldown::get_duration);
 	ClassDB::bind_method(D_METHOD("set_process_pause", "enable"), &BTCooldown::set_process_pause);
 	ClassDB::bind_method(D_METHOD("get_process_pause"), &BTCooldown::get_process_pause);
+	ClassDB::bind_method(D_METHOD("set_use_instance_clock", "enable"), &BTCooldown::set_use_instance_clock);
+	ClassDB::bind_method(D_METHOD("get_use_instance_clock"), &BTCooldown::get_use_instance_clock);
 	ClassDB::bind_method(D_METHOD("set_start_cooled", "enable"), &BTCooldown::set_start_cooled);
 	ClassDB::bind_method(D_METHOD("get_start_cooled"), &BTCooldown::get_start_cooled);
 	ClassDB::bind_method(D_METHOD("set_trigger_on_failure", "enable"), &BTCooldown::set_trigger_on_failure);
@@ -107,6 +150,7 @@ void BTCooldown::_bind_methods() {
 
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "duration"), "set_duration", "get_duration");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "process_pause"), "set_process_pause", "get_process_pause");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_instance_clock"), "set_use_instance_clock", "get_use_instance_clock");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "start_cooled"), "set_start_cooled", "get_start_cooled");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "trigger_on_failure"), "set_trigger_on_failure", "get_trigger_on_failure");
 	ADD_PROPERTY(PropertyInfo(Variant::STRING_NAME, "cooldown_state_var"), "set_cooldown_state_var", "get_cooldown_state_var");
@@ -14,14 +14,6 @@
 
 #include "../bt_decorator.h"
 
-#ifdef LIMBOAI_MODULE
-#include "scene/main/scene_tree.h"
-#endif
-
-#ifdef LIMBOAI_GDEXTENSION
-#include <godot_cpp/classes/scene_tree_timer.hpp>
-#endif
-
 class BTCooldown : public BTDecorator {
 	GDCLASS(BTCooldown, BTDecorator);
 	TASK_CATEGORY(Decorators);
@@ -29,14 +21,26 @@ class BTCooldown : public BTDecorator {
 private:
 	double duration = 10.0;
 	bool process_pause = false;
+	bool use_instance_clock = false;
 	bool start_cooled = false;
 	bool trigger_on_failure = false;
 	StringName cooldown_state_var = "";
-
-	Ref<SceneTreeTimer> timer = nullptr;
-
+	// Resolved in _setup(): the optional state variable is accessed without hashing its name on every tick.
+	BBVarHandle cooldown_state_handle;
+
+	// Time on the LimboTimerWheel clock (or the instance clock) when the cooldown ends.
+	double cooldown_end = 0.0;
+	// Not zero while waiting to reset cooldown_state_var.
+	uint32_t timer_id = 0;
+	// With use_instance_clock: the instance clock isn't attached during _setup(), so start_cooled is applied on the first tick.
+	bool chill_pending = false;
+	// With use_instance_clock: cooldown_state_var is reset by the next tick after the cooldown ends.
+	bool state_reset_pending = false;
+
+	_FORCE_INLINE_ bool _uses_instance_clock() const { return use_instance_clock && has_instance_clock(); }
 	void _chill();
 	void _on_timeout();
+	static void _timeout_callback(Object *p_owner, uint32_t p_timer_id);
 
 protected:
 	static void _bind_methods();
@@ -52,6 +56,9 @@ public:
 	void set_process_pause(bool p_value);
 	bool get_process_pause() const { return process_pause; }
 
+	void set_use_instance_clock(bool p_value);
+	bool get_use_instance_clock() const { return use_instance_clock; }
+
 	void set_start_cooled(bool p_value);
 	bool get_start_cooled() const { return start_cooled; }
 
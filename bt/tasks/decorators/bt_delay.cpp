@@ -13,7 +13,7 @@
 
 void BTDelay::set_seconds(double p_value) {
 	seconds = p_value;
-	emit_changed();
+	_task_changed();
 }
 
 String BTDelay::_generate_name() {
@@ -21,11 +21,12 @@ String BTDelay::_generate_name() {
 }
 
 BT::Status BTDelay::_tick(double p_delta) {
-	ERR_FAIL_COND_V_MSG(get_child_count() == 0, FAILURE, "BT decorator has no child.");
+	LIMBO_ERR_FAIL_COND_V_MSG(get_child_count() == 0, FAILURE, "BT decorator has no child.");
 	if (get_elapsed_time() <= seconds) {
+		request_wake_after(seconds - get_elapsed_time());
 		return RUNNING;
 	}
-	return get_child(0)->execute(p_delta);
+	return _get_child_ptr_unchecked(0)->execute(p_delta);
 }
 
 void BTDelay::_bind_methods() {
@@ -17,6 +17,8 @@
 class BTDelay : public BTDecorator {
 	GDCLASS(BTDelay, BTDecorator);
 	TASK_CATEGORY(Decorators);
+	TASK_THREAD_SAFE();
+	TASK_PURE();
 
 private:
 	double seconds = 1.0;
@@ -26,6 +28,7 @@ protected:
 
 	virtual String _generate_name() override;
 	virtual Status _tick(double p_delta) override;
+	virtual bool _can_resume_running_child() const override { return true; }
 
 public:
 	void set_seconds(double p_value);
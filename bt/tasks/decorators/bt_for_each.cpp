@@ -22,52 +22,159 @@
 
 void BTForEach::set_array_var(const StringName &p_value) {
 	array_var = p_value;
-	emit_changed();
+	array_handle = BBVarHandle();
+	array_handle.name = array_var;
+	_task_changed();
 }
 
 void BTForEach::set_save_var(const StringName &p_value) {
 	save_var = p_value;
-	emit_changed();
+	save_handle = BBVarHandle();
+	save_handle.name = save_var;
+	_task_changed();
+}
+
+void BTForEach::set_iteration_mode(IterationMode p_mode) {
+	iteration_mode = p_mode;
+	_task_changed();
+}
+
+void BTForEach::set_max_iterations_per_tick(int p_value) {
+	max_iterations_per_tick = CLAMP(p_value, 1, ITERATIONS_PER_TICK_LIMIT);
+	_task_changed();
 }
 
 //**** Task Implementation
 
+String BTForEach::validate_runtime(LocalVector<StringName> &r_read_vars, LocalVector<StringName> &r_written_vars) const {
+	const String error = BTDecorator::validate_runtime(r_read_vars, r_written_vars);
+	if (!error.is_empty()) {
+		return error;
+	}
+	if (get_child_count() == 0) {
+		return "Decorator has no child.";
+	}
+	if (array_var == StringName()) {
+		return "Array variable is not set.";
+	}
+	if (save_var == StringName()) {
+		return "Save variable is not set.";
+	}
+	r_read_vars.push_back(array_var);
+	r_written_vars.push_back(save_var);
+	return String();
+}
+
+bool BTForEach::can_tick_on_worker_thread() const {
+	// * On worker threads, inserting the save variable is deferred to the main thread, so the child would be executed
+	// before the element is stored. The variable must already exist in the scope of the task.
+	const Ref<Blackboard> &bb = get_blackboard();
+	return bb.is_valid() && bb->has_local_var(save_var);
+}
+
 String BTForEach::_generate_name() {
 	return vformat("ForEach %s in %s",
 			LimboUtility::get_singleton()->decorate_var(save_var),
 			LimboUtility::get_singleton()->decorate_var(array_var));
 }
 
+// Returns -1 if the value is not an array.
+static int64_t _get_array_size(const Variant &p_array) {
+#define ARRAY_SIZE_CASE(m_type, m_class) \
+	case Variant::m_type: {              \
+		const m_class arr = p_array;     \
+		return arr.size();               \
+	}
+	switch (p_array.get_type()) {
+		ARRAY_SIZE_CASE(ARRAY, Array);
+		ARRAY_SIZE_CASE(PACKED_BYTE_ARRAY, PackedByteArray);
+		ARRAY_SIZE_CASE(PACKED_INT32_ARRAY, PackedInt32Array);
+		ARRAY_SIZE_CASE(PACKED_INT64_ARRAY, PackedInt64Array);
+		ARRAY_SIZE_CASE(PACKED_FLOAT32_ARRAY, PackedFloat32Array);
+		ARRAY_SIZE_CASE(PACKED_FLOAT64_ARRAY, PackedFloat64Array);
+		ARRAY_SIZE_CASE(PACKED_STRING_ARRAY, PackedStringArray);
+		ARRAY_SIZE_CASE(PACKED_VECTOR2_ARRAY, PackedVector2Array);
+		ARRAY_SIZE_CASE(PACKED_VECTOR3_ARRAY, PackedVector3Array);
+		ARRAY_SIZE_CASE(PACKED_VECTOR4_ARRAY, PackedVector4Array);
+		ARRAY_SIZE_CASE(PACKED_COLOR_ARRAY, PackedColorArray);
+		default: {
+			return -1;
+		}
+	}
+#undef ARRAY_SIZE_CASE
+}
+
+bool BTForEach::_fetch_array() {
+	// Packed arrays are copy-on-write: holding the value (rather than converting it) is cheap and keeps a snapshot intact.
+	array = get_blackboard()->get_var_by_handle(array_handle, Variant());
+	LIMBO_ERR_FAIL_COND_V_MSG(_get_array_size(array) < 0, false, vformat("BTForEach: Variable \"%s\" doesn't hold an array (type: %s).", array_var, Variant::get_type_name(array.get_type())));
+	return true;
+}
+
+void BTForEach::_setup() {
+	array_handle = get_blackboard()->get_var_handle(array_var);
+	save_handle = get_blackboard()->get_var_handle(save_var);
+}
+
 void BTForEach::_enter() {
 	current_idx = 0;
+	if (iteration_mode == ITERATE_SNAPSHOT && array_var != StringName()) {
+		_fetch_array();
+	}
+}
+
+void BTForEach::_exit() {
+	array = Variant();
 }
 
 BT::Status BTForEach::_tick(double p_delta) {
-	ERR_FAIL_COND_V_MSG(get_child_count() == 0, FAILURE, "BTForEach: Decorator has no child.");
-	ERR_FAIL_COND_V_MSG(save_var == StringName(), FAILURE, "BTForEach: Save variable is not set.");
-	ERR_FAIL_COND_V_MSG(array_var == StringName(), FAILURE, "BTForEach: Array variable is not set.");
-
-	Array arr = get_blackboard()->get_var(array_var, Variant());
-	if (current_idx >= arr.size()) {
-		if (current_idx != 0) {
-			WARN_PRINT("BTForEach: Array size changed during iteration.");
+	LIMBO_ERR_FAIL_COND_V_MSG(get_child_count() == 0, FAILURE, "BTForEach: Decorator has no child.");
+	LIMBO_ERR_FAIL_COND_V_MSG(save_var == StringName(), FAILURE, "BTForEach: Save variable is not set.");
+	LIMBO_ERR_FAIL_COND_V_MSG(array_var == StringName(), FAILURE, "BTForEach: Array variable is not set.");
+
+	BTTask *child = _get_child_ptr_unchecked(0);
+	for (int i = 0; i < max_iterations_per_tick; i++) {
+		if (iteration_mode == ITERATE_LIVE && !_fetch_array()) {
+			return FAILURE;
+		}
+		// Arrays are shared by reference, so even a snapshot may have been resized.
+		const int64_t size = _get_array_size(array);
+		if (size < 0) {
+			return FAILURE;
+		}
+		if (current_idx >= size) {
+			if (current_idx != 0) {
+				WARN_PRINT("BTForEach: Array size changed during iteration.");
+			}
+			return SUCCESS;
+		}
+		bool valid;
+		bool oob;
+		_set_var_by_handle(save_handle, array.get_indexed(current_idx, valid, oob));
+
+		Status status = child->execute(p_delta);
+		if (status == RUNNING) {
+			break;
+		} else if (status == FAILURE) {
+			return FAILURE;
+		} else if (current_idx == (size - 1)) {
+			return SUCCESS;
+		} else {
+			current_idx += 1;
 		}
-		return SUCCESS;
-	}
-	Variant elem = arr[current_idx];
-	get_blackboard()->set_var(save_var, elem);
-
-	Status status = get_child(0)->execute(p_delta);
-	if (status == RUNNING) {
-		return RUNNING;
-	} else if (status == FAILURE) {
-		return FAILURE;
-	} else if (current_idx == (arr.size() - 1)) {
-		return SUCCESS;
-	} else {
-		current_idx += 1;
-		return RUNNING;
 	}
+	return RUNNING;
+}
+
+void BTForEach::_save_state(LimboSnapshotWriter &p_writer) const {
+	p_writer.put_u32(current_idx);
+	// Only a snapshot is held between ticks - in live mode, the array is fetched on each tick.
+	p_writer.put_variant(iteration_mode == ITERATE_SNAPSHOT ? array : Variant());
+}
+
+void BTForEach::_load_state(LimboSnapshotReader &p_reader) {
+	current_idx = p_reader.get_u32();
+	array = p_reader.get_variant();
 }
 
 //**** Godot
@@ -77,7 +184,16 @@ void BTForEach::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_array_var"), &BTForEach::get_array_var);
 	ClassDB::bind_method(D_METHOD("set_save_var", "variable"), &BTForEach::set_save_var);
 	ClassDB::bind_method(D_METHOD("get_save_var"), &BTForEach::get_save_var);
+	ClassDB::bind_method(D_METHOD("set_iteration_mode", "mode"), &BTForEach::set_iteration_mode);
+	ClassDB::bind_method(D_METHOD("get_iteration_mode"), &BTForEach::get_iteration_mode);
+	ClassDB::bind_method(D_METHOD("set_max_iterations_per_tick", "value"), &BTForEach::set_max_iterations_per_tick);
+	ClassDB::bind_method(D_METHOD("get_max_iterations_per_tick"), &BTForEach::get_max_iterations_per_tick);
 
 	ADD_PROPERTY(PropertyInfo(Variant::STRING_NAME, "array_var"), "set_array_var", "get_array_var");
 	ADD_PROPERTY(PropertyInfo(Variant::STRING_NAME, "save_var"), "set_save_var", "get_save_var");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "iteration_mode", PROPERTY_HINT_ENUM, "Live,Snapshot"), "set_iteration_mode", "get_iteration_mode");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "max_iterations_per_tick", PROPERTY_HINT_RANGE, "1,1024"), "set_max_iterations_per_tick", "get_max_iterations_per_tick");
+
+	BIND_ENUM_CONSTANT(ITERATE_LIVE);
+	BIND_ENUM_CONSTANT(ITERATE_SNAPSHOT);
 }
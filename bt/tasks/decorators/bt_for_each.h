@@ -17,19 +17,42 @@
 class BTForEach : public BTDecorator {
 	GDCLASS(BTForEach, BTDecorator);
 	TASK_CATEGORY(Decorators);
+	TASK_THREAD_SAFE();
+	TASK_PURE();
+
+public:
+	enum IterationMode {
+		ITERATE_LIVE,
+		ITERATE_SNAPSHOT,
+	};
 
 private:
 	StringName array_var;
 	StringName save_var;
+	IterationMode iteration_mode = ITERATE_LIVE;
+	int max_iterations_per_tick = 1;
 
+	BBVarHandle array_handle;
+	BBVarHandle save_handle;
+
+	// Array or packed array, held as-is to avoid converting packed arrays to Array.
+	Variant array;
+	int64_t array_size = 0;
 	int current_idx;
 
+	bool _fetch_array();
+
 protected:
 	static void _bind_methods();
 
 	virtual String _generate_name() override;
+	virtual void _setup() override;
 	virtual void _enter() override;
+	virtual void _exit() override;
 	virtual Status _tick(double p_delta) override;
+	virtual void _save_state(LimboSnapshotWriter &p_writer) const override;
+	virtual void _load_state(LimboSnapshotReader &p_reader) override;
+	virtual bool _can_resume_running_child() const override { return true; }
 
 public:
 	void set_array_var(const StringName &p_value);
@@ -37,6 +60,17 @@ public:
 
 	void set_save_var(const StringName &p_value);
 	StringName get_save_var() const { return save_var; }
+
+	virtual String validate_runtime(LocalVector<StringName> &r_read_vars, LocalVector<StringName> &r_written_vars) const override;
+	virtual bool can_tick_on_worker_thread() const override;
+
+	void set_iteration_mode(IterationMode p_mode);
+	IterationMode get_iteration_mode() const { return iteration_mode; }
+
+	void set_max_iterations_per_tick(int p_value);
+	int get_max_iterations_per_tick() const { return max_iterations_per_tick; }
 };
 
+VARIANT_ENUM_CAST(BTForEach::IterationMode);
+
 #endif // BT_FOR_EACH_H
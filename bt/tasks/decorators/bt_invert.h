@@ -17,11 +17,14 @@
 class BTInvert : public BTDecorator {
 	GDCLASS(BTInvert, BTDecorator);
 	TASK_CATEGORY(Decorators);
+	TASK_THREAD_SAFE();
+	TASK_PURE();
 
 protected:
 	static void _bind_methods() {}
 
 	virtual Status _tick(double p_delta) override;
+	virtual bool _can_resume_running_child() const override { return true; }
 };
 
 #endif // BT_INVERT_H
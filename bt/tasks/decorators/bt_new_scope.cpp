@@ -27,7 +27,7 @@ void BTNewScope::set_blackboard_plan(const Ref<BlackboardPlan> &p_plan) {
 	}
 #endif // TOOLS_ENABLED
 
-	emit_changed();
+	_task_changed();
 }
 
 #ifdef TOOLS_ENABLED
@@ -54,8 +54,8 @@ void BTNewScope::initialize(Node *p_agent, const Ref<Blackboard> &p_blackboard,
 }
 
 BT::Status BTNewScope::_tick(double p_delta) {
-	ERR_FAIL_COND_V_MSG(get_child_count() == 0, FAILURE, "BT decorator has no child.");
-	return get_child(0)->execute(p_delta);
+	LIMBO_ERR_FAIL_COND_V_MSG(get_child_count() == 0, FAILURE, "BT decorator has no child.");
+	return _get_child_ptr_unchecked(0)->execute(p_delta);
 }
 
 void BTNewScope::_bind_methods() {
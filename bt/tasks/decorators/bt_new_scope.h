@@ -19,6 +19,9 @@
 class BTNewScope : public BTDecorator {
 	GDCLASS(BTNewScope, BTDecorator);
 	TASK_CATEGORY(Decorators);
+	TASK_THREAD_SAFE();
+	TASK_PURE();
+	friend class BehaviorTree;
 
 private:
 	Ref<BlackboardPlan> blackboard_plan;
@@ -36,6 +39,7 @@ protected:
 	Ref<BlackboardPlan> get_blackboard_plan() const { return blackboard_plan; }
 
 	virtual Status _tick(double p_delta) override;
+	virtual bool _can_resume_running_child() const override { return true; }
 
 public:
 	virtual void initialize(Node *p_agent, const Ref<Blackboard> &p_blackboard, Node *p_scene_root) override;
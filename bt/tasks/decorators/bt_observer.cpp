@@ -0,0 +1,180 @@
+/**
+ * bt_observer.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "bt_observer.h"
+
+#include "../../../util/limbo_utility.h"
+#include "../../bt_instance.h"
+#include "../bt_composite.h"
+#include "../bt_condition.h"
+
+//**** Setters / Getters
+
+void BTObserver::set_observed_vars(const TypedArray<StringName> &p_vars) {
+	observed_vars = p_vars;
+	_task_changed();
+}
+
+void BTObserver::set_abort_mode(AbortMode p_mode) {
+	abort_mode = p_mode;
+	_task_changed();
+}
+
+//**** Task Implementation
+
+PackedStringArray BTObserver::get_configuration_warnings() {
+	PackedStringArray warnings = BTDecorator::get_configuration_warnings();
+	if (abort_mode != ABORT_SELF && get_parent().is_valid() && !Object::cast_to<BTComposite>(get_parent().ptr())) {
+		warnings.append("Lower priority aborts need a composite parent: the branches after this one are aborted.");
+	}
+	return warnings;
+}
+
+String BTObserver::_generate_name() {
+	static const char *mode_names[] = { "self", "lower priority", "both" };
+	String name = vformat("Observe (abort %s)", mode_names[abort_mode]);
+	if (!observed_vars.is_empty()) {
+		PackedStringArray vars;
+		for (int i = 0; i < observed_vars.size(); i++) {
+			vars.push_back(LimboUtility::get_singleton()->decorate_var(observed_vars[i]));
+		}
+		name += " " + String(", ").join(vars);
+	}
+	return name;
+}
+
+static void _collect_condition_vars(const BTTask *p_task, LocalVector<StringName> &r_vars) {
+	if (Object::cast_to<BTCondition>(p_task)) {
+		LocalVector<StringName> written;
+		p_task->validate_runtime(r_vars, written);
+	}
+	for (int i = 0; i < p_task->get_child_count(); i++) {
+		_collect_condition_vars(p_task->get_child(i).ptr(), r_vars);
+	}
+}
+
+void BTObserver::_subscribe() {
+	LocalVector<StringName> names;
+	if (observed_vars.is_empty()) {
+		// * By default, the variables read by the conditions in the branch.
+		_collect_condition_vars(this, names);
+	} else {
+		for (int i = 0; i < observed_vars.size(); i++) {
+			names.push_back(observed_vars[i]);
+		}
+	}
+
+	observed_blackboard = get_blackboard();
+	for (const StringName &name : names) {
+		bool duplicate = false;
+		for (const Observed &obs : observed) {
+			duplicate = duplicate || obs.name == name;
+		}
+		// * Variables that don't exist can't be observed.
+		if (duplicate || name == StringName() || !observed_blackboard->has_var(name)) {
+			continue;
+		}
+		Observed obs;
+		obs.name = name;
+		obs.value = observed_blackboard->get_var(name, Variant(), false);
+		obs.listener = callable_mp(this, &BTObserver::_on_var_changed).bind((int)observed.size());
+		observed_blackboard->add_var_listener(name, obs.listener);
+		observed.push_back(obs);
+	}
+}
+
+void BTObserver::_unsubscribe() {
+	for (const Observed &obs : observed) {
+		if (observed_blackboard->has_var(obs.name)) {
+			observed_blackboard->remove_var_listener(obs.name, obs.listener);
+		}
+	}
+	observed.clear();
+	observed_blackboard.unref();
+}
+
+void BTObserver::_setup() {
+	_unsubscribe();
+	instance_id = 0;
+	if (get_blackboard().is_valid()) {
+		_subscribe();
+	}
+}
+
+bool BTObserver::_is_lower_priority_running() const {
+	const BTTask *parent = get_parent().ptr();
+	if (parent == nullptr || parent->get_status() != RUNNING || !Object::cast_to<BTComposite>(parent)) {
+		return false;
+	}
+	for (int i = get_index() + 1; i < parent->get_child_count(); i++) {
+		if (parent->get_child(i)->get_status() == RUNNING) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void BTObserver::_on_var_changed(const Variant &p_value, int p_index) {
+	Observed &obs = observed[p_index];
+	if (obs.value == p_value) {
+		// * Written, but not changed.
+		return;
+	}
+	obs.value = p_value;
+
+	BTTask *target = nullptr;
+	if (get_status() == RUNNING) {
+		// * The branch is restarted, and its conditions are evaluated again.
+		target = abort_mode != ABORT_LOWER_PRIORITY ? this : nullptr;
+	} else if (abort_mode != ABORT_SELF && _is_lower_priority_running()) {
+		// * The parent composite is restarted, so that this branch gets another chance.
+		target = get_parent().ptr();
+	}
+	BTInstance *instance = target ? Object::cast_to<BTInstance>(OBJECT_DB_GET_INSTANCE(instance_id)) : nullptr;
+	if (instance) {
+		// * Variables may change in the middle of a tick - the abort is deferred to the next update.
+		instance->queue_abort(target);
+	}
+}
+
+void BTObserver::_enter() {
+	instance_id = _get_updating_instance_id();
+	for (Observed &obs : observed) {
+		obs.value = observed_blackboard->get_var(obs.name, Variant(), false);
+	}
+}
+
+BT::Status BTObserver::_tick(double p_delta) {
+	LIMBO_ERR_FAIL_COND_V_MSG(get_child_count() == 0, FAILURE, "BT decorator has no child.");
+	return _get_child_ptr_unchecked(0)->execute(p_delta);
+}
+
+BTObserver::~BTObserver() {
+	if (observed_blackboard.is_valid()) {
+		_unsubscribe();
+	}
+}
+
+//**** Godot
+
+void BTObserver::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_observed_vars", "variables"), &BTObserver::set_observed_vars);
+	ClassDB::bind_method(D_METHOD("get_observed_vars"), &BTObserver::get_observed_vars);
+	ClassDB::bind_method(D_METHOD("set_abort_mode", "mode"), &BTObserver::set_abort_mode);
+	ClassDB::bind_method(D_METHOD("get_abort_mode"), &BTObserver::get_abort_mode);
+
+	ADD_PROPERTY(PropertyInfo(Variant::ARRAY, "observed_vars", PROPERTY_HINT_ARRAY_TYPE, "StringName"), "set_observed_vars", "get_observed_vars");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "abort_mode", PROPERTY_HINT_ENUM, "Self,Lower Priority,Both"), "set_abort_mode", "get_abort_mode");
+
+	BIND_ENUM_CONSTANT(ABORT_SELF);
+	BIND_ENUM_CONSTANT(ABORT_LOWER_PRIORITY);
+	BIND_ENUM_CONSTANT(ABORT_BOTH);
+}
@@ -0,0 +1,78 @@
+/**
+ * bt_observer.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef BT_OBSERVER_H
+#define BT_OBSERVER_H
+
+#include "../bt_decorator.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/templates/local_vector.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/templates/local_vector.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+class BTObserver : public BTDecorator {
+	GDCLASS(BTObserver, BTDecorator);
+	TASK_CATEGORY(Decorators);
+
+public:
+	enum AbortMode {
+		ABORT_SELF,
+		ABORT_LOWER_PRIORITY,
+		ABORT_BOTH,
+	};
+
+private:
+	TypedArray<StringName> observed_vars;
+	AbortMode abort_mode = AbortMode::ABORT_BOTH;
+
+	// Subscribed in _setup(), with the last known value of each variable.
+	struct Observed {
+		StringName name;
+		Variant value;
+		Callable listener;
+	};
+	LocalVector<Observed> observed;
+	Ref<Blackboard> observed_blackboard;
+	uint64_t instance_id = 0; // BTInstance that last entered this task, which performs the aborts.
+
+	void _subscribe();
+	void _unsubscribe();
+	void _on_var_changed(const Variant &p_value, int p_index);
+	bool _is_lower_priority_running() const;
+
+protected:
+	static void _bind_methods();
+
+	virtual String _generate_name() override;
+	virtual void _setup() override;
+	virtual void _enter() override;
+	virtual Status _tick(double p_delta) override;
+	virtual bool _can_resume_running_child() const override { return true; }
+
+public:
+	void set_observed_vars(const TypedArray<StringName> &p_vars);
+	TypedArray<StringName> get_observed_vars() const { return observed_vars; }
+
+	void set_abort_mode(AbortMode p_mode);
+	AbortMode get_abort_mode() const { return abort_mode; }
+
+	virtual PackedStringArray get_configuration_warnings() override;
+
+	~BTObserver();
+};
+
+VARIANT_ENUM_CAST(BTObserver::AbortMode);
+
+#endif // BT_OBSERVER_H
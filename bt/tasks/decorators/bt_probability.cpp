@@ -15,7 +15,7 @@
 
 void BTProbability::set_run_chance(float p_value) {
 	run_chance = p_value;
-	emit_changed();
+	_task_changed();
 }
 
 String BTProbability::_generate_name() {
@@ -23,9 +23,11 @@ String BTProbability::_generate_name() {
 }
 
 BT::Status BTProbability::_tick(double p_delta) {
-	ERR_FAIL_COND_V_MSG(get_child_count() == 0, FAILURE, "BT decorator has no child.");
-	if (get_child(0)->get_status() == RUNNING || RANDF() <= run_chance) {
-		return get_child(0)->execute(p_delta);
+	LIMBO_ERR_FAIL_COND_V_MSG(get_child_count() == 0, FAILURE, "BT decorator has no child.");
+	BTTask *child = _get_child_ptr_unchecked(0);
+	// * A running child is continued without rolling again, even when it has just completed in resume mode.
+	if (child->get_status() == RUNNING || _is_resumed(child) || _get_rng().randf() <= run_chance) {
+		return child->execute(p_delta);
 	}
 	return FAILURE;
 }
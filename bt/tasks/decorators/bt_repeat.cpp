@@ -23,34 +23,45 @@ void BTRepeat::_enter() {
 }
 
 BT::Status BTRepeat::_tick(double p_delta) {
-	ERR_FAIL_COND_V_MSG(get_child_count() == 0, FAILURE, "BT decorator has no child.");
-	Status status = get_child(0)->execute(p_delta);
-	if (status == RUNNING || forever) {
-		return RUNNING;
-	} else if (status == FAILURE && abort_on_failure) {
-		return FAILURE;
-	} else if (cur_iteration >= times) {
-		return SUCCESS;
-	} else {
-		cur_iteration += 1;
-		return RUNNING;
+	LIMBO_ERR_FAIL_COND_V_MSG(get_child_count() == 0, FAILURE, "BT decorator has no child.");
+	BTTask *child = _get_child_ptr_unchecked(0);
+	// * Children that complete instantly are restarted within the same tick, up to max_iterations_per_tick times.
+	for (int i = 0; i < max_iterations_per_tick; i++) {
+		Status status = child->execute(p_delta);
+		if (status == RUNNING) {
+			break;
+		} else if (forever) {
+			continue;
+		} else if (status == FAILURE && abort_on_failure) {
+			return FAILURE;
+		} else if (cur_iteration >= times) {
+			return SUCCESS;
+		} else {
+			cur_iteration += 1;
+		}
 	}
+	return RUNNING;
 }
 
 void BTRepeat::set_forever(bool p_forever) {
 	forever = p_forever;
 	notify_property_list_changed();
-	emit_changed();
+	_task_changed();
 }
 
 void BTRepeat::set_times(int p_value) {
 	times = p_value;
-	emit_changed();
+	_task_changed();
 }
 
 void BTRepeat::set_abort_on_failure(bool p_value) {
 	abort_on_failure = p_value;
-	emit_changed();
+	_task_changed();
+}
+
+void BTRepeat::set_max_iterations_per_tick(int p_value) {
+	max_iterations_per_tick = CLAMP(p_value, 1, ITERATIONS_PER_TICK_LIMIT);
+	_task_changed();
 }
 
 void BTRepeat::_get_property_list(List<PropertyInfo> *p_list) const {
@@ -67,10 +78,13 @@ void BTRepeat::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_times"), &BTRepeat::get_times);
 	ClassDB::bind_method(D_METHOD("set_abort_on_failure", "enable"), &BTRepeat::set_abort_on_failure);
 	ClassDB::bind_method(D_METHOD("get_abort_on_failure"), &BTRepeat::get_abort_on_failure);
+	ClassDB::bind_method(D_METHOD("set_max_iterations_per_tick", "value"), &BTRepeat::set_max_iterations_per_tick);
+	ClassDB::bind_method(D_METHOD("get_max_iterations_per_tick"), &BTRepeat::get_max_iterations_per_tick);
 
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "forever"), "set_forever", "get_forever");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "times", PROPERTY_HINT_RANGE, "1,65535", PROPERTY_USAGE_NONE), "set_times", "get_times");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "abort_on_failure", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NONE), "set_abort_on_failure", "get_abort_on_failure");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "max_iterations_per_tick", PROPERTY_HINT_RANGE, "1,1024"), "set_max_iterations_per_tick", "get_max_iterations_per_tick");
 }
 
 BTRepeat::BTRepeat() {
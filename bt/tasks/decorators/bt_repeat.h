@@ -17,11 +17,14 @@
 class BTRepeat : public BTDecorator {
 	GDCLASS(BTRepeat, BTDecorator);
 	TASK_CATEGORY(Decorators);
+	TASK_THREAD_SAFE();
+	TASK_PURE();
 
 private:
 	bool forever = false;
 	int times = 1;
 	bool abort_on_failure = false;
+	int max_iterations_per_tick = 1;
 	int cur_iteration = 0;
 
 protected:
@@ -32,6 +35,9 @@ protected:
 	virtual String _generate_name() override;
 	virtual void _enter() override;
 	virtual Status _tick(double p_delta) override;
+	virtual void _save_state(LimboSnapshotWriter &p_writer) const override { p_writer.put_u32(cur_iteration); }
+	virtual void _load_state(LimboSnapshotReader &p_reader) override { cur_iteration = p_reader.get_u32(); }
+	virtual bool _can_resume_running_child() const override { return true; }
 
 public:
 	void set_forever(bool p_forever);
@@ -43,6 +49,9 @@ public:
 	void set_abort_on_failure(bool p_value);
 	bool get_abort_on_failure() const { return abort_on_failure; }
 
+	void set_max_iterations_per_tick(int p_value);
+	int get_max_iterations_per_tick() const { return max_iterations_per_tick; }
+
 	BTRepeat();
 };
 
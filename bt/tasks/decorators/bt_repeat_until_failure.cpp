@@ -12,9 +12,27 @@
 #include "bt_repeat_until_failure.h"
 
 BT::Status BTRepeatUntilFailure::_tick(double p_delta) {
-	ERR_FAIL_COND_V_MSG(get_child_count() == 0, FAILURE, "BT decorator has no child.");
-	if (get_child(0)->execute(p_delta) == FAILURE) {
-		return SUCCESS;
+	LIMBO_ERR_FAIL_COND_V_MSG(get_child_count() == 0, FAILURE, "BT decorator has no child.");
+	BTTask *child = _get_child_ptr_unchecked(0);
+	for (int i = 0; i < max_iterations_per_tick; i++) {
+		const Status status = child->execute(p_delta);
+		if (status == FAILURE) {
+			return SUCCESS;
+		} else if (status == RUNNING) {
+			break;
+		}
 	}
 	return RUNNING;
 }
+
+void BTRepeatUntilFailure::set_max_iterations_per_tick(int p_value) {
+	max_iterations_per_tick = CLAMP(p_value, 1, ITERATIONS_PER_TICK_LIMIT);
+	_task_changed();
+}
+
+void BTRepeatUntilFailure::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_max_iterations_per_tick", "value"), &BTRepeatUntilFailure::set_max_iterations_per_tick);
+	ClassDB::bind_method(D_METHOD("get_max_iterations_per_tick"), &BTRepeatUntilFailure::get_max_iterations_per_tick);
+
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "max_iterations_per_tick", PROPERTY_HINT_RANGE, "1,1024"), "set_max_iterations_per_tick", "get_max_iterations_per_tick");
+}
@@ -17,11 +17,21 @@
 class BTRepeatUntilFailure : public BTDecorator {
 	GDCLASS(BTRepeatUntilFailure, BTDecorator);
 	TASK_CATEGORY(Decorators);
+	TASK_THREAD_SAFE();
+	TASK_PURE();
+
+private:
+	int max_iterations_per_tick = 1;
 
 protected:
-	static void _bind_methods() {}
+	static void _bind_methods();
 
 	virtual Status _tick(double p_delta) override;
+	virtual bool _can_resume_running_child() const override { return true; }
+
+public:
+	void set_max_iterations_per_tick(int p_value);
+	int get_max_iterations_per_tick() const { return max_iterations_per_tick; }
 };
 
 #endif // BT_REPEAT_UNTIL_FAILURE_H
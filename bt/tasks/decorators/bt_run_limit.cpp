@@ -13,12 +13,12 @@
 
 void BTRunLimit::set_run_limit(int p_value) {
 	run_limit = p_value;
-	emit_changed();
+	_task_changed();
 }
 
 void BTRunLimit::set_count_policy(CountPolicy p_policy) {
 	count_policy = p_policy;
-	emit_changed();
+	_task_changed();
 }
 
 String BTRunLimit::_generate_name() {
@@ -26,11 +26,11 @@ String BTRunLimit::_generate_name() {
 }
 
 BT::Status BTRunLimit::_tick(double p_delta) {
-	ERR_FAIL_COND_V_MSG(get_child_count() == 0, FAILURE, "BT decorator has no child.");
+	LIMBO_ERR_FAIL_COND_V_MSG(get_child_count() == 0, FAILURE, "BT decorator has no child.");
 	if (num_runs >= run_limit) {
 		return FAILURE;
 	}
-	Status child_status = get_child(0)->execute(p_delta);
+	Status child_status = _get_child_ptr_unchecked(0)->execute(p_delta);
 	if ((count_policy == COUNT_SUCCESSFUL && child_status == SUCCESS) ||
 			(count_policy == COUNT_FAILED && child_status == FAILURE) ||
 			(count_policy == COUNT_ALL && child_status != RUNNING)) {
@@ -17,6 +17,8 @@
 class BTRunLimit : public BTDecorator {
 	GDCLASS(BTRunLimit, BTDecorator);
 	TASK_CATEGORY(Decorators);
+	TASK_THREAD_SAFE();
+	TASK_PURE();
 
 public:
 	enum CountPolicy {
@@ -35,6 +37,9 @@ protected:
 
 	virtual String _generate_name() override;
 	virtual Status _tick(double p_delta) override;
+	virtual void _save_state(LimboSnapshotWriter &p_writer) const override { p_writer.put_u32(num_runs); }
+	virtual void _load_state(LimboSnapshotReader &p_reader) override { num_runs = p_reader.get_u32(); }
+	virtual bool _can_resume_running_child() const override { return true; }
 
 public:
 	void set_run_limit(int p_value);
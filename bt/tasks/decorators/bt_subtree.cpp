@@ -11,6 +11,8 @@
 
 #include "bt_subtree.h"
 
+#include "../../../util/limbo_timer_wheel.h"
+
 void BTSubtree::set_subtree(const Ref<BehaviorTree> &p_subtree) {
 	if (Engine::get_singleton()->is_editor_hint()) {
 		if (subtree.is_valid() && subtree->is_connected(LW_NAME(changed), callable_mp(this, &BTSubtree::_update_blackboard_plan))) {
@@ -22,7 +24,7 @@ void BTSubtree::set_subtree(const Ref<BehaviorTree> &p_subtree) {
 	}
 	subtree = p_subtree;
 	_update_blackboard_plan();
-	emit_changed();
+	_task_changed();
 }
 
 void BTSubtree::_update_blackboard_plan() {
@@ -45,18 +47,67 @@ String BTSubtree::_generate_name() {
 }
 
 void BTSubtree::initialize(Node *p_agent, const Ref<Blackboard> &p_blackboard, Node *p_scene_root) {
-	ERR_FAIL_COND_MSG(!subtree.is_valid(), "Subtree is not assigned.");
-	ERR_FAIL_COND_MSG(!subtree->get_root_task().is_valid(), "Subtree root task is not valid.");
-	ERR_FAIL_COND_MSG(get_child_count() != 0, "Subtree task shouldn't have children during initialization.");
-
-	add_child(subtree->get_root_task()->clone());
+	LIMBO_ERR_FAIL_COND_MSG(!subtree.is_valid(), "Subtree is not assigned.");
+	LIMBO_ERR_FAIL_COND_MSG(!subtree->get_root_task().is_valid(), "Subtree root task is not valid.");
+	if (!lazy) {
+		instantiate_subtree();
+	}
 
 	BTNewScope::initialize(p_agent, p_blackboard, p_scene_root);
 }
 
+void BTSubtree::instantiate_subtree() {
+	if (subtree_instantiated || subtree.is_null() || subtree->get_root_task().is_null()) {
+		return;
+	}
+	if (get_child_count() == 0) {
+		add_child(subtree->get_instance_template()->clone());
+	}
+	// * Otherwise, this task was cloned from an expanded template and already carries the subtree.
+	subtree_instantiated = true;
+}
+
+void BTSubtree::release_subtree() {
+	release_timer_id = 0;
+	if (!subtree_instantiated) {
+		return;
+	}
+	LIMBO_ERR_FAIL_COND_MSG(get_status() == RUNNING, "BTSubtree: Can't release a running subtree.");
+	if (get_child_count() > 0) {
+		Ref<BTTask> child = get_child(0);
+		child->abort();
+		remove_child(child);
+	}
+	subtree_instantiated = false;
+}
+
+void BTSubtree::_release_timeout(Object *p_owner, uint32_t p_timer_id) {
+	BTSubtree *task = Object::cast_to<BTSubtree>(p_owner);
+	// * Ignore timers of previous runs and subtrees that were entered again.
+	if (task && task->release_timer_id == p_timer_id && task->get_status() != RUNNING) {
+		task->release_subtree();
+	}
+}
+
+void BTSubtree::_enter() {
+	release_timer_id = 0;
+}
+
+void BTSubtree::_exit() {
+	if (lazy && release_delay > 0.0 && subtree_instantiated) {
+		release_timer_id = LimboTimerWheel::get(false)->schedule(release_delay, this, &BTSubtree::_release_timeout);
+	}
+}
+
 BT::Status BTSubtree::_tick(double p_delta) {
-	ERR_FAIL_COND_V_MSG(get_child_count() == 0, FAILURE, "BT decorator doesn't have a child.");
-	return get_child(0)->execute(p_delta);
+	if (get_child_count() == 0 && lazy) {
+		// First tick of a lazy subtree - the clone inherits the scope blackboard created in initialize().
+		instantiate_subtree();
+		ERR_FAIL_COND_V(get_child_count() == 0, FAILURE);
+		get_child(0)->initialize(get_agent(), get_blackboard(), get_scene_root());
+	}
+	LIMBO_ERR_FAIL_COND_V_MSG(get_child_count() == 0, FAILURE, "BT decorator doesn't have a child.");
+	return _get_child_ptr_unchecked(0)->execute(p_delta);
 }
 
 PackedStringArray BTSubtree::get_configuration_warnings() {
@@ -70,8 +121,15 @@ PackedStringArray BTSubtree::get_configuration_warnings() {
 void BTSubtree::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_subtree", "behavior_tree"), &BTSubtree::set_subtree);
 	ClassDB::bind_method(D_METHOD("get_subtree"), &BTSubtree::get_subtree);
+	ClassDB::bind_method(D_METHOD("set_lazy", "enable"), &BTSubtree::set_lazy);
+	ClassDB::bind_method(D_METHOD("is_lazy"), &BTSubtree::is_lazy);
+	ClassDB::bind_method(D_METHOD("set_release_delay", "delay"), &BTSubtree::set_release_delay);
+	ClassDB::bind_method(D_METHOD("get_release_delay"), &BTSubtree::get_release_delay);
+	ClassDB::bind_method(D_METHOD("release_subtree"), &BTSubtree::release_subtree);
 
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "subtree", PROPERTY_HINT_RESOURCE_TYPE, "BehaviorTree"), "set_subtree", "get_subtree");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "lazy"), "set_lazy", "is_lazy");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "release_delay", PROPERTY_HINT_RANGE, "0.0,600.0,0.1,or_greater,suffix:s"), "set_release_delay", "get_release_delay");
 }
 
 BTSubtree::~BTSubtree() {
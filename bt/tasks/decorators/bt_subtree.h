@@ -19,9 +19,18 @@
 class BTSubtree : public BTNewScope {
 	GDCLASS(BTSubtree, BTNewScope);
 	TASK_CATEGORY(Decorators);
+	TASK_THREAD_SAFE();
+	TASK_PURE();
 
 private:
 	Ref<BehaviorTree> subtree;
+	// True once the subtree was cloned under this task - repeated initialization reuses it (see BTInstancePool).
+	bool subtree_instantiated = false;
+	bool lazy = false;
+	double release_delay = 0.0;
+	uint32_t release_timer_id = 0;
+
+	static void _release_timeout(Object *p_owner, uint32_t p_timer_id);
 
 protected:
 	static void _bind_methods();
@@ -29,12 +38,26 @@ protected:
 	virtual void _update_blackboard_plan() override;
 
 	virtual String _generate_name() override;
+	virtual void _enter() override;
+	virtual void _exit() override;
 	virtual Status _tick(double p_delta) override;
+	virtual bool _can_resume_running_child() const override { return true; }
 
 public:
 	void set_subtree(const Ref<BehaviorTree> &p_value);
 	Ref<BehaviorTree> get_subtree() const { return subtree; }
 
+	void set_lazy(bool p_lazy) { lazy = p_lazy; }
+	bool is_lazy() const { return lazy; }
+
+	void set_release_delay(double p_delay) { release_delay = MAX(p_delay, 0.0); }
+	double get_release_delay() const { return release_delay; }
+
+	// Clones the subtree under this task, unless already done. Touches no nodes, so it can run on a worker thread.
+	void instantiate_subtree();
+	// Frees the subtree clone. It will be cloned and initialized again on the next tick.
+	void release_subtree();
+
 	virtual void initialize(Node *p_agent, const Ref<Blackboard> &p_blackboard, Node *p_scene_root) override;
 	virtual PackedStringArray get_configuration_warnings() override;
 
@@ -13,7 +13,7 @@
 
 void BTTimeLimit::set_time_limit(double p_value) {
 	time_limit = p_value;
-	emit_changed();
+	_task_changed();
 }
 
 String BTTimeLimit::_generate_name() {
@@ -21,11 +21,14 @@ String BTTimeLimit::_generate_name() {
 }
 
 BT::Status BTTimeLimit::_tick(double p_delta) {
-	ERR_FAIL_COND_V_MSG(get_child_count() == 0, FAILURE, "BT decorator has no child.");
-	Status status = get_child(0)->execute(p_delta);
-	if (status == RUNNING && get_elapsed_time() >= time_limit) {
-		get_child(0)->abort();
-		return FAILURE;
+	LIMBO_ERR_FAIL_COND_V_MSG(get_child_count() == 0, FAILURE, "BT decorator has no child.");
+	Status status = _get_child_ptr_unchecked(0)->execute(p_delta);
+	if (status == RUNNING) {
+		if (get_elapsed_time() >= time_limit) {
+			_get_child_ptr_unchecked(0)->abort();
+			return FAILURE;
+		}
+		request_wake_after(time_limit - get_elapsed_time());
 	}
 	return status;
 }
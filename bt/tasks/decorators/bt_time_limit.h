@@ -17,6 +17,8 @@
 class BTTimeLimit : public BTDecorator {
 	GDCLASS(BTTimeLimit, BTDecorator);
 	TASK_CATEGORY(Decorators);
+	TASK_THREAD_SAFE();
+	TASK_PURE();
 
 private:
 	double time_limit = 5.0;
@@ -0,0 +1,63 @@
+/**
+ * bt_animation_player_resolver.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "bt_animation_player_resolver.h"
+
+#include "../../../util/limbo_compat.h"
+
+void BTAnimationPlayerResolver::reset() {
+	player = nullptr;
+	player_id = 0;
+	var_handle = BBVarHandle();
+	var_version = -1;
+	checked_animation = StringName();
+	checked_player_id = 0;
+	animation_found = false;
+}
+
+AnimationPlayer *BTAnimationPlayerResolver::resolve(const Ref<BBNode> &p_param, Node *p_scene_root, const Ref<Blackboard> &p_blackboard) {
+	ERR_FAIL_COND_V(p_param.is_null(), nullptr);
+	const bool from_blackboard = p_param->get_value_source() == BBParam::BLACKBOARD_VAR;
+
+	if (likely(player_id != 0) && OBJECT_DB_GET_INSTANCE(player_id) == player) {
+		if (!from_blackboard) {
+			return player;
+		}
+		// Bound variables have no version (-1), so they are resolved every time.
+		const int64_t version = p_blackboard.is_valid() ? p_blackboard->get_var_version(var_handle) : -1;
+		if (version != -1 && version == var_version) {
+			return player;
+		}
+	}
+
+	if (from_blackboard && p_blackboard.is_valid()) {
+		if (var_handle.name != p_param->get_variable()) {
+			var_handle = BBVarHandle();
+			var_handle.name = p_param->get_variable();
+		}
+		// Read before resolving, so that a change in between is detected on the next call.
+		var_version = p_blackboard->get_var_version(var_handle);
+	}
+	player = Object::cast_to<AnimationPlayer>(p_param->get_value(p_scene_root, p_blackboard));
+	player_id = player ? uint64_t(player->get_instance_id()) : 0;
+	return player;
+}
+
+bool BTAnimationPlayerResolver::has_animation(const StringName &p_animation_name) {
+	ERR_FAIL_NULL_V(player, false);
+	// Only a successful lookup is reused: a missing animation may be added to the player later.
+	if (!animation_found || checked_player_id != player_id || checked_animation != p_animation_name) {
+		checked_player_id = player_id;
+		checked_animation = p_animation_name;
+		animation_found = player->has_animation(p_animation_name);
+	}
+	return animation_found;
+}
@@ -0,0 +1,53 @@
+/**
+ * bt_animation_player_resolver.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef BT_ANIMATION_PLAYER_RESOLVER_H
+#define BT_ANIMATION_PLAYER_RESOLVER_H
+
+#include "../../../blackboard/bb_param/bb_node.h"
+#include "../../../blackboard/blackboard.h"
+
+#ifdef LIMBOAI_MODULE
+#include "scene/animation/animation_player.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/animation_player.hpp>
+using namespace godot;
+#endif // LIMBOAI_GDEXTENSION
+
+// Resolves the AnimationPlayer of a scene task from its BBNode parameter, and remembers it.
+// Later calls only verify that the node still exists and, for a blackboard-sourced parameter,
+// that the variable hasn't changed - the node path is walked again only if either check fails.
+class BTAnimationPlayerResolver {
+private:
+	AnimationPlayer *player = nullptr;
+	uint64_t player_id = 0;
+	BBVarHandle var_handle;
+	int64_t var_version = -1;
+
+	// Result of the last animation lookup, valid while the same player is resolved.
+	StringName checked_animation;
+	uint64_t checked_player_id = 0;
+	bool animation_found = false;
+
+public:
+	void reset();
+
+	// Returns nullptr if the parameter doesn't point to an AnimationPlayer.
+	AnimationPlayer *resolve(const Ref<BBNode> &p_param, Node *p_scene_root, const Ref<Blackboard> &p_blackboard);
+	_FORCE_INLINE_ AnimationPlayer *get_player() const { return player; }
+
+	// Checks if the last resolved player has the animation. Must be called after resolve().
+	bool has_animation(const StringName &p_animation_name);
+};
+
+#endif // BT_ANIMATION_PLAYER_RESOLVER_H
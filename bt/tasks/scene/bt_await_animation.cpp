@@ -15,7 +15,7 @@
 
 void BTAwaitAnimation::set_animation_player(Ref<BBNode> p_animation_player) {
 	animation_player_param = p_animation_player;
-	emit_changed();
+	_task_changed();
 	if (Engine::get_singleton()->is_editor_hint() && animation_player_param.is_valid() &&
 			!animation_player_param->is_connected(LW_NAME(changed), callable_mp((Resource *)this, &Resource::emit_changed))) {
 		animation_player_param->connect(LW_NAME(changed), callable_mp((Resource *)this, &Resource::emit_changed));
@@ -24,12 +24,17 @@ void BTAwaitAnimation::set_animation_player(Ref<BBNode> p_animation_player) {
 
 void BTAwaitAnimation::set_animation_name(const StringName &p_animation_name) {
 	animation_name = p_animation_name;
-	emit_changed();
+	_task_changed();
 }
 
 void BTAwaitAnimation::set_max_time(double p_max_time) {
 	max_time = p_max_time;
-	emit_changed();
+	_task_changed();
+}
+
+void BTAwaitAnimation::set_use_signals(bool p_use_signals) {
+	use_signals = p_use_signals;
+	_task_changed();
 }
 
 //**** Task Implementation
@@ -57,25 +62,82 @@ PackedStringArray BTAwaitAnimation::get_configuration_warnings() {
 String BTAwaitAnimation::_generate_name() {
 	return "AwaitAnimation" +
 			(animation_name != StringName() ? vformat(" \"%s\"", animation_name) : " ???") +
-			vformat("  max_time: %ss", Math::snapped(max_time, 0.001));
+			vformat("  max_time: %ss", Math::snapped(max_time, 0.001)) +
+			(use_signals ? "  (signals)" : "");
 }
 
 void BTAwaitAnimation::_setup() {
 	setup_failed = true;
-	ERR_FAIL_COND_MSG(animation_player_param.is_null(), "BTAwaitAnimation: AnimationPlayer parameter is not set.");
-	animation_player = Object::cast_to<AnimationPlayer>(animation_player_param->get_value(get_scene_root(), get_blackboard()));
-	ERR_FAIL_COND_MSG(animation_player == nullptr, "BTAwaitAnimation: Failed to get AnimationPlayer.");
-	ERR_FAIL_COND_MSG(animation_name == StringName(), "BTAwaitAnimation: Animation Name is not set.");
-	ERR_FAIL_COND_MSG(!animation_player->has_animation(animation_name), vformat("BTAwaitAnimation: Animation not found: %s", animation_name));
+	LIMBO_ERR_FAIL_COND_MSG(animation_player_param.is_null(), "BTAwaitAnimation: AnimationPlayer parameter is not set.");
+	player_resolver.reset();
+	AnimationPlayer *animation_player = player_resolver.resolve(animation_player_param, get_scene_root(), get_blackboard());
+	LIMBO_ERR_FAIL_COND_MSG(animation_player == nullptr, "BTAwaitAnimation: Failed to get AnimationPlayer.");
+	LIMBO_ERR_FAIL_COND_MSG(animation_name == StringName(), "BTAwaitAnimation: Animation Name is not set.");
+	LIMBO_ERR_FAIL_COND_MSG(!player_resolver.has_animation(animation_name), vformat("BTAwaitAnimation: Animation not found: %s", animation_name));
 	setup_failed = false;
 }
 
+void BTAwaitAnimation::_enter() {
+	// Signals only help if there is a reactive instance to wake up - otherwise the task is ticked every frame anyway.
+	AnimationPlayer *animation_player = use_signals && !setup_failed ? player_resolver.resolve(animation_player_param, get_scene_root(), get_blackboard()) : nullptr;
+	instance_id = animation_player ? _get_reactive_instance_id() : 0;
+	if (instance_id != 0) {
+		connected_player_id = animation_player->get_instance_id();
+		animation_player->connect(LW_NAME(animation_finished), callable_mp(this, &BTAwaitAnimation::_on_animation_finished));
+		animation_player->connect(LW_NAME(animation_changed), callable_mp(this, &BTAwaitAnimation::_on_animation_changed));
+	}
+}
+
+void BTAwaitAnimation::_exit() {
+	_disconnect_signals();
+}
+
+void BTAwaitAnimation::_disconnect_signals() {
+	if (instance_id == 0) {
+		return;
+	}
+	instance_id = 0;
+	AnimationPlayer *animation_player = Object::cast_to<AnimationPlayer>(OBJECT_DB_GET_INSTANCE(connected_player_id));
+	if (animation_player == nullptr) {
+		return; // Freed along with its connections.
+	}
+	if (animation_player->is_connected(LW_NAME(animation_finished), callable_mp(this, &BTAwaitAnimation::_on_animation_finished))) {
+		animation_player->disconnect(LW_NAME(animation_finished), callable_mp(this, &BTAwaitAnimation::_on_animation_finished));
+	}
+	if (animation_player->is_connected(LW_NAME(animation_changed), callable_mp(this, &BTAwaitAnimation::_on_animation_changed))) {
+		animation_player->disconnect(LW_NAME(animation_changed), callable_mp(this, &BTAwaitAnimation::_on_animation_changed));
+	}
+}
+
+void BTAwaitAnimation::_on_animation_finished(const StringName &p_animation_name) {
+	_wake_instance(instance_id);
+}
+
+void BTAwaitAnimation::_on_animation_changed(const StringName &p_old_name, const StringName &p_new_name) {
+	_wake_instance(instance_id);
+}
+
 BT::Status BTAwaitAnimation::_tick(double p_delta) {
-	ERR_FAIL_COND_V_MSG(setup_failed == true, FAILURE, "BTAwaitAnimation: _setup() failed - returning FAILURE.");
+	LIMBO_ERR_FAIL_COND_V_MSG(setup_failed == true, FAILURE, "BTAwaitAnimation: _setup() failed - returning FAILURE.");
+	AnimationPlayer *animation_player = player_resolver.resolve(animation_player_param, get_scene_root(), get_blackboard());
+	LIMBO_ERR_FAIL_NULL_V_MSG(animation_player, FAILURE, "BTAwaitAnimation: Failed to get AnimationPlayer.");
 
-	// ! Doing this check instead of using signal due to a bug in Godot: https://github.com/godotengine/godot/issues/76127
+	// ! Doing this check instead of relying on signals due to a bug in Godot: https://github.com/godotengine/godot/issues/76127
+	// ! With use_signals, the signals only wake up the instance, and the state is still polled here.
 	if (animation_player->is_playing() && animation_player->get_assigned_animation() == animation_name) {
 		if (get_elapsed_time() < max_time) {
+			if (instance_id != 0) {
+				// Sleep until the expected end of the animation, in case the signal is never emitted.
+				double remaining = max_time - get_elapsed_time();
+				const double playing_speed = Math::abs(animation_player->get_playing_speed());
+				if (playing_speed > 0.0) {
+					const double position = animation_player->get_current_animation_position();
+					const double length = animation_player->get_current_animation_length();
+					const double to_end = animation_player->get_playing_speed() > 0.0 ? length - position : position;
+					remaining = MIN(remaining, to_end / playing_speed);
+				}
+				request_wake_after(remaining);
+			}
 			return RUNNING;
 		} else if (max_time > 0.0) {
 			WARN_PRINT(vformat("BTAwaitAnimation: Waiting time for the \"%s\" animation exceeded the allocated %s sec.", animation_name, max_time));
@@ -93,8 +155,11 @@ void BTAwaitAnimation::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_animation_name"), &BTAwaitAnimation::get_animation_name);
 	ClassDB::bind_method(D_METHOD("set_max_time", "time_sec"), &BTAwaitAnimation::set_max_time);
 	ClassDB::bind_method(D_METHOD("get_max_time"), &BTAwaitAnimation::get_max_time);
+	ClassDB::bind_method(D_METHOD("set_use_signals", "enabled"), &BTAwaitAnimation::set_use_signals);
+	ClassDB::bind_method(D_METHOD("get_use_signals"), &BTAwaitAnimation::get_use_signals);
 
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "animation_player", PROPERTY_HINT_RESOURCE_TYPE, "BBNode"), "set_animation_player", "get_animation_player");
 	ADD_PROPERTY(PropertyInfo(Variant::STRING_NAME, "animation_name"), "set_animation_name", "get_animation_name");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "max_time", PROPERTY_HINT_RANGE, "0.0,100.0"), "set_max_time", "get_max_time");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_signals"), "set_use_signals", "get_use_signals");
 }
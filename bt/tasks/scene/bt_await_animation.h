@@ -15,6 +15,7 @@
 #include "../bt_action.h"
 
 #include "../../../blackboard/bb_param/bb_node.h"
+#include "bt_animation_player_resolver.h"
 
 #ifdef LIMBOAI_MODULE
 #include "scene/animation/animation_player.h"
@@ -32,15 +33,24 @@ private:
 	Ref<BBNode> animation_player_param;
 	StringName animation_name;
 	double max_time = 1.0;
+	bool use_signals = false;
 
-	AnimationPlayer *animation_player = nullptr;
+	BTAnimationPlayerResolver player_resolver;
 	bool setup_failed = false;
+	uint64_t instance_id = 0; // Reactive BTInstance to wake when the animation stops.
+	uint64_t connected_player_id = 0;
+
+	void _on_animation_finished(const StringName &p_animation_name);
+	void _on_animation_changed(const StringName &p_old_name, const StringName &p_new_name);
+	void _disconnect_signals();
 
 protected:
 	static void _bind_methods();
 
 	virtual String _generate_name() override;
 	virtual void _setup() override;
+	virtual void _enter() override;
+	virtual void _exit() override;
 	virtual Status _tick(double p_delta) override;
 
 public:
@@ -53,6 +63,9 @@ public:
 	void set_max_time(double p_max_time);
 	double get_max_time() const { return max_time; }
 
+	void set_use_signals(bool p_use_signals);
+	bool get_use_signals() const { return use_signals; }
+
 	virtual PackedStringArray get_configuration_warnings() override;
 };
 
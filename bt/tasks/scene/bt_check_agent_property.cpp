@@ -13,17 +13,19 @@
 
 void BTCheckAgentProperty::set_property(StringName p_prop) {
 	property = p_prop;
-	emit_changed();
+	property_accessor.set_path(property);
+	_task_changed();
 }
 
 void BTCheckAgentProperty::set_check_type(LimboUtility::CheckType p_check_type) {
 	check_type = p_check_type;
-	emit_changed();
+	_task_changed();
 }
 
 void BTCheckAgentProperty::set_value(Ref<BBVariant> p_value) {
 	value = p_value;
-	emit_changed();
+	check_func = nullptr;
+	_task_changed();
 	if (Engine::get_singleton()->is_editor_hint() && value.is_valid() &&
 			!value->is_connected(LW_NAME(changed), callable_mp((Resource *)this, &Resource::emit_changed))) {
 		value->connect(LW_NAME(changed), callable_mp((Resource *)this, &Resource::emit_changed));
@@ -41,6 +43,20 @@ PackedStringArray BTCheckAgentProperty::get_configuration_warnings() {
 	return warnings;
 }
 
+String BTCheckAgentProperty::validate_runtime(LocalVector<StringName> &r_read_vars, LocalVector<StringName> &r_written_vars) const {
+	const String error = BTCondition::validate_runtime(r_read_vars, r_written_vars);
+	if (!error.is_empty()) {
+		return error;
+	}
+	if (property == StringName()) {
+		return "`property` is not set.";
+	}
+	if (value.is_null()) {
+		return "`value` is not set.";
+	}
+	return String();
+}
+
 String BTCheckAgentProperty::_generate_name() {
 	if (property == StringName()) {
 		return "CheckAgentProperty ???";
@@ -51,21 +67,24 @@ String BTCheckAgentProperty::_generate_name() {
 			value.is_valid() ? Variant(value) : Variant("???"));
 }
 
+void BTCheckAgentProperty::_setup() {
+	check_func = LimboUtility::get_check_func(value.is_valid() ? value->get_type() : Variant::NIL);
+	LIMBO_ERR_FAIL_COND_MSG(get_agent() == nullptr, "BTCheckAgentProperty: Needs an agent node - headless instances don't have one.");
+}
+
 BT::Status BTCheckAgentProperty::_tick(double p_delta) {
-	ERR_FAIL_COND_V_MSG(property == StringName(), FAILURE, "BTCheckAgentProperty: `property` is not set.");
-	ERR_FAIL_COND_V_MSG(!value.is_valid(), FAILURE, "BTCheckAgentProperty: `value` is not set.");
+	LIMBO_ERR_FAIL_COND_V_MSG(property == StringName(), FAILURE, "BTCheckAgentProperty: `property` is not set.");
+	LIMBO_ERR_FAIL_COND_V_MSG(!value.is_valid(), FAILURE, "BTCheckAgentProperty: `value` is not set.");
 
-#ifdef LIMBOAI_MODULE
-	bool r_valid;
-	Variant left_value = get_agent()->get(property, &r_valid);
-	ERR_FAIL_COND_V_MSG(r_valid == false, FAILURE, vformat("BTCheckAgentProperty: Agent has no property named \"%s\"", property));
-#elif LIMBOAI_GDEXTENSION
-	Variant left_value = get_agent()->get(property);
-#endif
+	Variant left_value;
+	LIMBO_ERR_FAIL_COND_V_MSG(!property_accessor.get(get_agent(), left_value), FAILURE, vformat("BTCheckAgentProperty: Agent has no property named \"%s\"", property));
 
 	Variant right_value = value->get_value(get_scene_root(), get_blackboard());
 
-	return LimboUtility::get_singleton()->perform_check(check_type, left_value, right_value) ? SUCCESS : FAILURE;
+	if (unlikely(check_func == nullptr)) {
+		check_func = LimboUtility::get_check_func(value->get_type());
+	}
+	return check_func(check_type, left_value, right_value) ? SUCCESS : FAILURE;
 }
 
 void BTCheckAgentProperty::_bind_methods() {
@@ -15,6 +15,7 @@
 #include "../bt_condition.h"
 
 #include "../../../blackboard/bb_param/bb_variant.h"
+#include "../../../util/limbo_property_accessor.h"
 #include "../../../util/limbo_utility.h"
 
 class BTCheckAgentProperty : public BTCondition {
@@ -23,13 +24,16 @@ class BTCheckAgentProperty : public BTCondition {
 
 private:
 	StringName property;
+	LimboPropertyAccessor property_accessor;
 	LimboUtility::CheckType check_type = LimboUtility::CheckType::CHECK_EQUAL;
 	Ref<BBVariant> value;
+	LimboUtility::CheckFunc check_func = nullptr; // Selected for the value type on setup.
 
 protected:
 	static void _bind_methods();
 
 	virtual String _generate_name() override;
+	virtual void _setup() override;
 	virtual Status _tick(double p_delta) override;
 
 public:
@@ -43,6 +47,7 @@ public:
 	Ref<BBVariant> get_value() const { return value; }
 
 	virtual PackedStringArray get_configuration_warnings() override;
+	virtual String validate_runtime(LocalVector<StringName> &r_read_vars, LocalVector<StringName> &r_written_vars) const override;
 };
 
 #endif // BT_CHECK_AGENT_PROPERTY_H
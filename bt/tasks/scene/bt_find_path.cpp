@@ -0,0 +1,193 @@
+/**
+ * bt_find_path.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "bt_find_path.h"
+
+#include "../../../util/limbo_path_queries.h"
+#include "../../../util/limbo_utility.h"
+
+#ifdef LIMBOAI_MODULE
+#include "scene/2d/node_2d.h"
+#include "scene/3d/node_3d.h"
+#include "scene/resources/3d/world_3d.h"
+#include "scene/resources/world_2d.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/node2d.hpp>
+#include <godot_cpp/classes/node3d.hpp>
+#include <godot_cpp/classes/world2d.hpp>
+#include <godot_cpp/classes/world3d.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+//**** Setters / Getters
+
+void BTFindPath::set_target_var(const StringName &p_target_var) {
+	target_var = p_target_var;
+	target_handle = BBVarHandle();
+	_task_changed();
+}
+
+void BTFindPath::set_path_var(const StringName &p_path_var) {
+	path_var = p_path_var;
+	path_handle = BBVarHandle();
+	_task_changed();
+}
+
+void BTFindPath::set_navigation_layers(uint32_t p_navigation_layers) {
+	navigation_layers = p_navigation_layers;
+	_task_changed();
+}
+
+//**** Task Implementation
+
+PackedStringArray BTFindPath::get_configuration_warnings() {
+	PackedStringArray warnings = BTAction::get_configuration_warnings();
+	if (target_var == StringName()) {
+		warnings.append("Target variable is not set.");
+	}
+	if (path_var == StringName()) {
+		warnings.append("Path variable is not set.");
+	}
+	if (navigation_layers == 0) {
+		warnings.append("No navigation layers are enabled.");
+	}
+	return warnings;
+}
+
+String BTFindPath::validate_runtime(LocalVector<StringName> &r_read_vars, LocalVector<StringName> &r_written_vars) const {
+	const String error = BTAction::validate_runtime(r_read_vars, r_written_vars);
+	if (!error.is_empty()) {
+		return error;
+	}
+	if (target_var == StringName()) {
+		return "`target_var` is not set.";
+	}
+	if (path_var == StringName()) {
+		return "`path_var` is not set.";
+	}
+	r_read_vars.push_back(target_var);
+	r_written_vars.push_back(path_var);
+	return String();
+}
+
+String BTFindPath::_generate_name() {
+	if (target_var == StringName() || path_var == StringName()) {
+		return "FindPath ???";
+	}
+	return vformat("FindPath to %s  %s", LimboUtility::get_singleton()->decorate_var(target_var),
+			LimboUtility::get_singleton()->decorate_output_var(path_var));
+}
+
+void BTFindPath::_setup() {
+	target_handle = get_blackboard()->get_var_handle(target_var);
+	path_handle = get_blackboard()->get_var_handle(path_var);
+	LIMBO_ERR_FAIL_COND_MSG(get_agent() == nullptr, "BTFindPath: Needs an agent node - headless instances don't have one.");
+}
+
+bool BTFindPath::_get_query(RID &r_map, Vector3 &r_from, Vector3 &r_to, bool &r_2d) {
+	const Variant target = get_blackboard()->get_var_by_handle(target_handle);
+#ifdef LIMBOAI_MODULE
+	const Object *target_obj = target.get_validated_object();
+#elif LIMBOAI_GDEXTENSION
+	const Object *target_obj = target.get_type() == Variant::OBJECT ? (Object *)target : nullptr;
+#endif
+	if (const Node3D *agent_3d = Object::cast_to<Node3D>(get_agent())) {
+		LIMBO_ERR_FAIL_COND_V_MSG(!agent_3d->is_inside_tree(), false, "BTFindPath: Agent must be inside the scene tree.");
+		r_2d = false;
+		r_map = agent_3d->get_world_3d()->get_navigation_map();
+		r_from = agent_3d->get_global_position();
+		if (target.get_type() == Variant::VECTOR3) {
+			r_to = target;
+			return true;
+		}
+		const Node3D *target_node = Object::cast_to<Node3D>(target_obj);
+		LIMBO_ERR_FAIL_NULL_V_MSG(target_node, false, vformat("BTFindPath: Target must be a Vector3 or a Node3D, got: %s.", target));
+		r_to = target_node->get_global_position();
+		return true;
+	}
+	if (const Node2D *agent_2d = Object::cast_to<Node2D>(get_agent())) {
+		LIMBO_ERR_FAIL_COND_V_MSG(!agent_2d->is_inside_tree(), false, "BTFindPath: Agent must be inside the scene tree.");
+		r_2d = true;
+		r_map = agent_2d->get_world_2d()->get_navigation_map();
+		const Vector2 from = agent_2d->get_global_position();
+		r_from = Vector3(from.x, from.y, 0.0);
+		Vector2 to;
+		if (target.get_type() == Variant::VECTOR2) {
+			to = target;
+		} else {
+			const Node2D *target_node = Object::cast_to<Node2D>(target_obj);
+			LIMBO_ERR_FAIL_NULL_V_MSG(target_node, false, vformat("BTFindPath: Target must be a Vector2 or a Node2D, got: %s.", target));
+			to = target_node->get_global_position();
+		}
+		r_to = Vector3(to.x, to.y, 0.0);
+		return true;
+	}
+	LIMBO_ERR_FAIL_V_MSG(false, "BTFindPath: Agent must be a Node2D or a Node3D.");
+}
+
+void BTFindPath::_exit() {
+	if (ticket != 0) {
+		LimboPathQueries::cancel(ticket);
+		ticket = 0;
+	}
+}
+
+BT::Status BTFindPath::_tick(double p_delta) {
+	LIMBO_ERR_FAIL_COND_V_MSG(target_var == StringName(), FAILURE, "BTFindPath: Target variable is not set.");
+	LIMBO_ERR_FAIL_COND_V_MSG(path_var == StringName(), FAILURE, "BTFindPath: Path variable is not set.");
+
+	if (ticket == 0) {
+		RID map;
+		Vector3 from;
+		Vector3 to;
+		bool is_2d = false;
+		if (!_get_query(map, from, to, is_2d)) {
+			return FAILURE;
+		}
+		// Queries of all agents are computed together on the WorkerThreadPool at the start of the next frame.
+		ticket = LimboPathQueries::submit(map, from, to, navigation_layers, is_2d, _get_reactive_instance_id());
+	}
+
+	Variant path;
+	switch (LimboPathQueries::poll(ticket, path)) {
+		case LimboPathQueries::QUERY_PENDING: {
+			// The reactive instance is woken up when the path arrives - this is a fallback.
+			request_wake_after(1.0);
+			return RUNNING;
+		}
+		case LimboPathQueries::QUERY_READY: {
+			ticket = 0;
+			get_blackboard()->set_var_by_handle(path_handle, path);
+			const bool found = path.get_type() == Variant::PACKED_VECTOR3_ARRAY ? !PackedVector3Array(path).is_empty() : !PackedVector2Array(path).is_empty();
+			return found ? SUCCESS : FAILURE;
+		}
+		case LimboPathQueries::QUERY_INVALID: {
+			ticket = 0;
+		} break;
+	}
+	return FAILURE;
+}
+
+//**** Godot
+
+void BTFindPath::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_target_var", "variable"), &BTFindPath::set_target_var);
+	ClassDB::bind_method(D_METHOD("get_target_var"), &BTFindPath::get_target_var);
+	ClassDB::bind_method(D_METHOD("set_path_var", "variable"), &BTFindPath::set_path_var);
+	ClassDB::bind_method(D_METHOD("get_path_var"), &BTFindPath::get_path_var);
+	ClassDB::bind_method(D_METHOD("set_navigation_layers", "layers"), &BTFindPath::set_navigation_layers);
+	ClassDB::bind_method(D_METHOD("get_navigation_layers"), &BTFindPath::get_navigation_layers);
+
+	ADD_PROPERTY(PropertyInfo(Variant::STRING_NAME, "target_var"), "set_target_var", "get_target_var");
+	ADD_PROPERTY(PropertyInfo(Variant::STRING_NAME, "path_var"), "set_path_var", "get_path_var");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "navigation_layers", PROPERTY_HINT_LAYERS_3D_NAVIGATION), "set_navigation_layers", "get_navigation_layers");
+}
@@ -0,0 +1,54 @@
+/**
+ * bt_find_path.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef BT_FIND_PATH_H
+#define BT_FIND_PATH_H
+
+#include "../bt_action.h"
+
+class BTFindPath : public BTAction {
+	GDCLASS(BTFindPath, BTAction);
+	TASK_CATEGORY(Scene);
+
+private:
+	StringName target_var;
+	StringName path_var;
+	uint32_t navigation_layers = 1;
+
+	BBVarHandle target_handle;
+	BBVarHandle path_handle;
+	uint64_t ticket = 0; // Pending query in LimboPathQueries.
+
+	bool _get_query(RID &r_map, Vector3 &r_from, Vector3 &r_to, bool &r_2d);
+
+protected:
+	static void _bind_methods();
+
+	virtual String _generate_name() override;
+	virtual void _setup() override;
+	virtual void _exit() override;
+	virtual Status _tick(double p_delta) override;
+
+public:
+	void set_target_var(const StringName &p_target_var);
+	StringName get_target_var() const { return target_var; }
+
+	void set_path_var(const StringName &p_path_var);
+	StringName get_path_var() const { return path_var; }
+
+	void set_navigation_layers(uint32_t p_navigation_layers);
+	uint32_t get_navigation_layers() const { return navigation_layers; }
+
+	virtual PackedStringArray get_configuration_warnings() override;
+	virtual String validate_runtime(LocalVector<StringName> &r_read_vars, LocalVector<StringName> &r_written_vars) const override;
+};
+
+#endif // BT_FIND_PATH_H
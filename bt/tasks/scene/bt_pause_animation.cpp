@@ -15,7 +15,7 @@
 
 void BTPauseAnimation::set_animation_player(Ref<BBNode> p_animation_player) {
 	animation_player_param = p_animation_player;
-	emit_changed();
+	_task_changed();
 	if (Engine::get_singleton()->is_editor_hint() && animation_player_param.is_valid() &&
 			!animation_player_param->is_connected(LW_NAME(changed), callable_mp((Resource *)this, &Resource::emit_changed))) {
 		animation_player_param->connect(LW_NAME(changed), callable_mp((Resource *)this, &Resource::emit_changed));
@@ -44,14 +44,17 @@ String BTPauseAnimation::_generate_name() {
 
 void BTPauseAnimation::_setup() {
 	setup_failed = true;
-	ERR_FAIL_COND_MSG(animation_player_param.is_null(), "BTPauseAnimation: AnimationPlayer parameter is not set.");
-	animation_player = Object::cast_to<AnimationPlayer>(animation_player_param->get_value(get_scene_root(), get_blackboard()));
-	ERR_FAIL_COND_MSG(animation_player == nullptr, "BTPauseAnimation: Failed to get AnimationPlayer.");
+	LIMBO_ERR_FAIL_COND_MSG(animation_player_param.is_null(), "BTPauseAnimation: AnimationPlayer parameter is not set.");
+	player_resolver.reset();
+	AnimationPlayer *animation_player = player_resolver.resolve(animation_player_param, get_scene_root(), get_blackboard());
+	LIMBO_ERR_FAIL_COND_MSG(animation_player == nullptr, "BTPauseAnimation: Failed to get AnimationPlayer.");
 	setup_failed = false;
 }
 
 BT::Status BTPauseAnimation::_tick(double p_delta) {
-	ERR_FAIL_COND_V_MSG(setup_failed == true, FAILURE, "BTPauseAnimation: _setup() failed - returning FAILURE.");
+	LIMBO_ERR_FAIL_COND_V_MSG(setup_failed == true, FAILURE, "BTPauseAnimation: _setup() failed - returning FAILURE.");
+	AnimationPlayer *animation_player = player_resolver.resolve(animation_player_param, get_scene_root(), get_blackboard());
+	LIMBO_ERR_FAIL_NULL_V_MSG(animation_player, FAILURE, "BTPauseAnimation: Failed to get AnimationPlayer.");
 	animation_player->pause();
 	return SUCCESS;
 }
@@ -15,6 +15,7 @@
 #include "../bt_action.h"
 
 #include "../../../blackboard/bb_param/bb_node.h"
+#include "bt_animation_player_resolver.h"
 
 #ifdef LIMBOAI_MODULE
 #include "scene/animation/animation_player.h"
@@ -31,7 +32,7 @@ class BTPauseAnimation : public BTAction {
 private:
 	Ref<BBNode> animation_player_param;
 
-	AnimationPlayer *animation_player = nullptr;
+	BTAnimationPlayerResolver player_resolver;
 	bool setup_failed = false;
 
 protected:
@@ -15,7 +15,7 @@
 
 void BTPlayAnimation::set_animation_player(Ref<BBNode> p_animation_player) {
 	animation_player_param = p_animation_player;
-	emit_changed();
+	_task_changed();
 	if (Engine::get_singleton()->is_editor_hint() && animation_player_param.is_valid() &&
 			!animation_player_param->is_connected(LW_NAME(changed), callable_mp((Resource *)this, &Resource::emit_changed))) {
 		animation_player_param->connect(LW_NAME(changed), callable_mp((Resource *)this, &Resource::emit_changed));
@@ -24,27 +24,32 @@ void BTPlayAnimation::set_animation_player(Ref<BBNode> p_animation_player) {
 
 void BTPlayAnimation::set_animation_name(StringName p_animation_name) {
 	animation_name = p_animation_name;
-	emit_changed();
+	_task_changed();
 }
 
 void BTPlayAnimation::set_await_completion(double p_await_completion) {
 	await_completion = p_await_completion;
-	emit_changed();
+	_task_changed();
 }
 
 void BTPlayAnimation::set_blend(double p_blend) {
 	blend = p_blend;
-	emit_changed();
+	_task_changed();
 }
 
 void BTPlayAnimation::set_speed(double p_speed) {
 	speed = p_speed;
-	emit_changed();
+	_task_changed();
 }
 
 void BTPlayAnimation::set_from_end(bool p_from_end) {
 	from_end = p_from_end;
-	emit_changed();
+	_task_changed();
+}
+
+void BTPlayAnimation::set_use_signals(bool p_use_signals) {
+	use_signals = p_use_signals;
+	_task_changed();
 }
 
 //**** Task Implementation
@@ -72,15 +77,17 @@ String BTPlayAnimation::_generate_name() {
 			(blend >= 0.0 ? vformat("  blend: %ss", Math::snapped(blend, 0.001)) : "") +
 			(speed != 1.0 ? vformat("  speed: %s", Math::snapped(speed, 0.001)) : "") +
 			(from_end != false ? vformat("  from_end: %s", from_end) : "") +
-			(await_completion > 0.0 ? vformat("  await_completion: %ss", Math::snapped(await_completion, 0.001)) : "");
+			(await_completion > 0.0 ? vformat("  await_completion: %ss", Math::snapped(await_completion, 0.001)) : "") +
+			(use_signals && await_completion > 0.0 ? "  (signals)" : "");
 }
 
 void BTPlayAnimation::_setup() {
 	setup_failed = true;
-	ERR_FAIL_COND_MSG(animation_player_param.is_null(), "BTPlayAnimation: AnimationPlayer parameter is not set.");
-	animation_player = Object::cast_to<AnimationPlayer>(animation_player_param->get_value(get_scene_root(), get_blackboard()));
-	ERR_FAIL_COND_MSG(animation_player == nullptr, "BTPlayAnimation: Failed to get AnimationPlayer.");
-	ERR_FAIL_COND_MSG(animation_name != StringName() && !animation_player->has_animation(animation_name), vformat("BTPlayAnimation: Animation not found: %s", animation_name));
+	LIMBO_ERR_FAIL_COND_MSG(animation_player_param.is_null(), "BTPlayAnimation: AnimationPlayer parameter is not set.");
+	player_resolver.reset();
+	AnimationPlayer *animation_player = player_resolver.resolve(animation_player_param, get_scene_root(), get_blackboard());
+	LIMBO_ERR_FAIL_COND_MSG(animation_player == nullptr, "BTPlayAnimation: Failed to get AnimationPlayer.");
+	LIMBO_ERR_FAIL_COND_MSG(animation_name != StringName() && !player_resolver.has_animation(animation_name), vformat("BTPlayAnimation: Animation not found: %s", animation_name));
 	if (animation_name == StringName() && await_completion > 0.0) {
 		WARN_PRINT("BTPlayAnimation: Animation Name is required in order to wait for the animation to finish.");
 	}
@@ -88,17 +95,73 @@ void BTPlayAnimation::_setup() {
 }
 
 void BTPlayAnimation::_enter() {
-	if (!setup_failed) {
-		animation_player->play(animation_name, blend, speed, from_end);
+	if (setup_failed) {
+		return;
+	}
+	AnimationPlayer *animation_player = player_resolver.resolve(animation_player_param, get_scene_root(), get_blackboard());
+	if (animation_player == nullptr || (animation_name != StringName() && !player_resolver.has_animation(animation_name))) {
+		return; // Reported in _tick().
+	}
+	animation_player->play(animation_name, blend, speed, from_end);
+	// Connected after play(), so that switching to this animation doesn't trigger a wake-up.
+	instance_id = use_signals && await_completion > 0.0 ? _get_reactive_instance_id() : 0;
+	if (instance_id != 0) {
+		connected_player_id = animation_player->get_instance_id();
+		animation_player->connect(LW_NAME(animation_finished), callable_mp(this, &BTPlayAnimation::_on_animation_finished));
+		animation_player->connect(LW_NAME(animation_changed), callable_mp(this, &BTPlayAnimation::_on_animation_changed));
+	}
+}
+
+void BTPlayAnimation::_exit() {
+	_disconnect_signals();
+}
+
+void BTPlayAnimation::_disconnect_signals() {
+	if (instance_id == 0) {
+		return;
+	}
+	instance_id = 0;
+	AnimationPlayer *animation_player = Object::cast_to<AnimationPlayer>(OBJECT_DB_GET_INSTANCE(connected_player_id));
+	if (animation_player == nullptr) {
+		return; // Freed along with its connections.
+	}
+	if (animation_player->is_connected(LW_NAME(animation_finished), callable_mp(this, &BTPlayAnimation::_on_animation_finished))) {
+		animation_player->disconnect(LW_NAME(animation_finished), callable_mp(this, &BTPlayAnimation::_on_animation_finished));
+	}
+	if (animation_player->is_connected(LW_NAME(animation_changed), callable_mp(this, &BTPlayAnimation::_on_animation_changed))) {
+		animation_player->disconnect(LW_NAME(animation_changed), callable_mp(this, &BTPlayAnimation::_on_animation_changed));
 	}
 }
 
+void BTPlayAnimation::_on_animation_finished(const StringName &p_animation_name) {
+	_wake_instance(instance_id);
+}
+
+void BTPlayAnimation::_on_animation_changed(const StringName &p_old_name, const StringName &p_new_name) {
+	_wake_instance(instance_id);
+}
+
 BT::Status BTPlayAnimation::_tick(double p_delta) {
-	ERR_FAIL_COND_V_MSG(setup_failed == true, FAILURE, "BTPlayAnimation: _setup() failed - returning FAILURE.");
+	LIMBO_ERR_FAIL_COND_V_MSG(setup_failed == true, FAILURE, "BTPlayAnimation: _setup() failed - returning FAILURE.");
+	AnimationPlayer *animation_player = player_resolver.resolve(animation_player_param, get_scene_root(), get_blackboard());
+	LIMBO_ERR_FAIL_NULL_V_MSG(animation_player, FAILURE, "BTPlayAnimation: Failed to get AnimationPlayer.");
+	LIMBO_ERR_FAIL_COND_V_MSG(animation_name != StringName() && !player_resolver.has_animation(animation_name), FAILURE, vformat("BTPlayAnimation: Animation not found: %s", animation_name));
 
-	// ! Doing this check instead of using signal due to a bug in Godot: https://github.com/godotengine/godot/issues/76127
+	// ! Doing this check instead of relying on signals due to a bug in Godot: https://github.com/godotengine/godot/issues/76127
+	// ! Signals are only used to wake up a sleeping instance early.
 	if (animation_player->is_playing() && animation_player->get_assigned_animation() == animation_name) {
 		if (get_elapsed_time() < await_completion) {
+			if (instance_id != 0) {
+				// Polled again at the expected end of the animation, even if no signal arrives.
+				double remaining = await_completion - get_elapsed_time();
+				const double playing_speed = animation_player->get_playing_speed();
+				if (playing_speed != 0.0) {
+					const double position = animation_player->get_current_animation_position();
+					const double to_end = playing_speed > 0.0 ? animation_player->get_current_animation_length() - position : position;
+					remaining = MIN(remaining, to_end / Math::abs(playing_speed));
+				}
+				request_wake_after(remaining);
+			}
 			return RUNNING;
 		} else if (await_completion > 0.0) {
 			WARN_PRINT(vformat("BTPlayAnimation: Waiting time for the \"%s\" animation exceeded the allocated %s sec.", animation_name, await_completion));
@@ -122,6 +185,8 @@ void BTPlayAnimation::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_speed"), &BTPlayAnimation::get_speed);
 	ClassDB::bind_method(D_METHOD("set_from_end", "from_end"), &BTPlayAnimation::set_from_end);
 	ClassDB::bind_method(D_METHOD("get_from_end"), &BTPlayAnimation::get_from_end);
+	ClassDB::bind_method(D_METHOD("set_use_signals", "enabled"), &BTPlayAnimation::set_use_signals);
+	ClassDB::bind_method(D_METHOD("get_use_signals"), &BTPlayAnimation::get_use_signals);
 
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "await_completion", PROPERTY_HINT_RANGE, "0.0,100.0"), "set_await_completion", "get_await_completion");
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "animation_player", PROPERTY_HINT_RESOURCE_TYPE, "BBNode"), "set_animation_player", "get_animation_player");
@@ -129,4 +194,5 @@ void BTPlayAnimation::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "blend"), "set_blend", "get_blend");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "speed"), "set_speed", "get_speed");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "from_end"), "set_from_end", "get_from_end");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_signals"), "set_use_signals", "get_use_signals");
 }
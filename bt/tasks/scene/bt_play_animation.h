@@ -15,6 +15,7 @@
 #include "../bt_action.h"
 
 #include "../../../blackboard/bb_param/bb_node.h"
+#include "bt_animation_player_resolver.h"
 
 #ifdef LIMBOAI_MODULE
 #include "scene/animation/animation_player.h"
@@ -35,9 +36,16 @@ private:
 	double blend = -1.0;
 	double speed = 1.0;
 	bool from_end = false;
+	bool use_signals = false;
 
-	AnimationPlayer *animation_player = nullptr;
+	BTAnimationPlayerResolver player_resolver;
 	bool setup_failed = false;
+	uint64_t instance_id = 0; // Reactive BTInstance to wake when the animation stops.
+	uint64_t connected_player_id = 0;
+
+	void _on_animation_finished(const StringName &p_animation_name);
+	void _on_animation_changed(const StringName &p_old_name, const StringName &p_new_name);
+	void _disconnect_signals();
 
 protected:
 	static void _bind_methods();
@@ -45,6 +53,7 @@ protected:
 	virtual String _generate_name() override;
 	virtual void _setup() override;
 	virtual void _enter() override;
+	virtual void _exit() override;
 	virtual Status _tick(double p_delta) override;
 
 public:
@@ -66,6 +75,9 @@ public:
 	void set_from_end(bool p_from_end);
 	bool get_from_end() const { return from_end; }
 
+	void set_use_signals(bool p_use_signals);
+	bool get_use_signals() const { return use_signals; }
+
 	virtual PackedStringArray get_configuration_warnings() override;
 };
 
@@ -0,0 +1,113 @@
+/**
+ * bt_query_nearby.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "bt_query_nearby.h"
+
+#include "../../../util/limbo_spatial_index.h"
+#include "../../../util/limbo_utility.h"
+
+//**** Setters / Getters
+
+void BTQueryNearby::set_group(const StringName &p_group) {
+	group = p_group;
+	_task_changed();
+}
+
+void BTQueryNearby::set_radius(double p_radius) {
+	radius = p_radius;
+	_task_changed();
+}
+
+void BTQueryNearby::set_output_var(const StringName &p_output_var) {
+	output_var = p_output_var;
+	output_handle = BBVarHandle();
+	_task_changed();
+}
+
+//**** Task Implementation
+
+PackedStringArray BTQueryNearby::get_configuration_warnings() {
+	PackedStringArray warnings = BTAction::get_configuration_warnings();
+	if (group == StringName()) {
+		warnings.append("Group is not set.");
+	}
+	if (radius <= 0.0) {
+		warnings.append("Radius should be greater than 0.0.");
+	}
+	if (output_var == StringName()) {
+		warnings.append("Output variable is not set.");
+	}
+	return warnings;
+}
+
+String BTQueryNearby::validate_runtime(LocalVector<StringName> &r_read_vars, LocalVector<StringName> &r_written_vars) const {
+	const String error = BTAction::validate_runtime(r_read_vars, r_written_vars);
+	if (!error.is_empty()) {
+		return error;
+	}
+	if (group == StringName()) {
+		return "`group` is not set.";
+	}
+	if (radius <= 0.0) {
+		return "`radius` must be greater than 0.0.";
+	}
+	if (output_var == StringName()) {
+		return "`output_var` is not set.";
+	}
+	r_written_vars.push_back(output_var);
+	return String();
+}
+
+String BTQueryNearby::_generate_name() {
+	if (group == StringName() || output_var == StringName()) {
+		return "QueryNearby ???";
+	}
+	return vformat("QueryNearby \"%s\"  radius: %s  %s", group, Math::snapped(radius, 0.001),
+			LimboUtility::get_singleton()->decorate_output_var(output_var));
+}
+
+void BTQueryNearby::_setup() {
+	output_handle = get_blackboard()->get_var_handle(output_var);
+	LIMBO_ERR_FAIL_COND_MSG(get_agent() == nullptr, "BTQueryNearby: Needs an agent node - headless instances don't have one.");
+}
+
+BT::Status BTQueryNearby::_tick(double p_delta) {
+	LIMBO_ERR_FAIL_COND_V_MSG(group == StringName(), FAILURE, "BTQueryNearby: Group is not set.");
+	LIMBO_ERR_FAIL_COND_V_MSG(radius <= 0.0, FAILURE, "BTQueryNearby: Radius must be greater than 0.0.");
+	LIMBO_ERR_FAIL_COND_V_MSG(output_var == StringName(), FAILURE, "BTQueryNearby: Output variable is not set.");
+
+	Vector3 position;
+	LIMBO_ERR_FAIL_COND_V_MSG(!LimboSpatialIndex::get_node_position(get_agent(), position), FAILURE, "BTQueryNearby: Agent must be a Node2D or a Node3D.");
+
+	// The index is shared by every task querying the group in this frame.
+	const LimboSpatialIndex *index = LimboSpatialIndex::get(group, radius);
+	Node *nearest = index ? index->find_nearest(position, radius, get_agent()) : nullptr;
+	if (nearest == nullptr) {
+		return FAILURE;
+	}
+	get_blackboard()->set_var_by_handle(output_handle, nearest);
+	return SUCCESS;
+}
+
+//**** Godot
+
+void BTQueryNearby::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_group", "group"), &BTQueryNearby::set_group);
+	ClassDB::bind_method(D_METHOD("get_group"), &BTQueryNearby::get_group);
+	ClassDB::bind_method(D_METHOD("set_radius", "radius"), &BTQueryNearby::set_radius);
+	ClassDB::bind_method(D_METHOD("get_radius"), &BTQueryNearby::get_radius);
+	ClassDB::bind_method(D_METHOD("set_output_var", "variable"), &BTQueryNearby::set_output_var);
+	ClassDB::bind_method(D_METHOD("get_output_var"), &BTQueryNearby::get_output_var);
+
+	ADD_PROPERTY(PropertyInfo(Variant::STRING_NAME, "group"), "set_group", "get_group");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "radius", PROPERTY_HINT_RANGE, "0.001,10000,0.001,or_greater"), "set_radius", "get_radius");
+	ADD_PROPERTY(PropertyInfo(Variant::STRING_NAME, "output_var"), "set_output_var", "get_output_var");
+}
@@ -0,0 +1,49 @@
+/**
+ * bt_query_nearby.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef BT_QUERY_NEARBY_H
+#define BT_QUERY_NEARBY_H
+
+#include "../bt_action.h"
+
+class BTQueryNearby : public BTAction {
+	GDCLASS(BTQueryNearby, BTAction);
+	TASK_CATEGORY(Scene);
+
+private:
+	StringName group;
+	double radius = 100.0;
+	StringName output_var;
+
+	BBVarHandle output_handle;
+
+protected:
+	static void _bind_methods();
+
+	virtual String _generate_name() override;
+	virtual void _setup() override;
+	virtual Status _tick(double p_delta) override;
+
+public:
+	void set_group(const StringName &p_group);
+	StringName get_group() const { return group; }
+
+	void set_radius(double p_radius);
+	double get_radius() const { return radius; }
+
+	void set_output_var(const StringName &p_output_var);
+	StringName get_output_var() const { return output_var; }
+
+	virtual PackedStringArray get_configuration_warnings() override;
+	virtual String validate_runtime(LocalVector<StringName> &r_read_vars, LocalVector<StringName> &r_written_vars) const override;
+};
+
+#endif // BT_QUERY_NEARBY_H
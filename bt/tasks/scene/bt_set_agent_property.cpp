@@ -11,14 +11,18 @@
 
 #include "bt_set_agent_property.h"
 
+#include "../../bt_scheduler.h"
+
 void BTSetAgentProperty::set_property(StringName p_prop) {
 	property = p_prop;
-	emit_changed();
+	property_accessor.set_path(property);
+	_task_changed();
 }
 
 void BTSetAgentProperty::set_value(Ref<BBVariant> p_value) {
 	value = p_value;
-	emit_changed();
+	operation_func = nullptr;
+	_task_changed();
 	if (Engine::get_singleton()->is_editor_hint() && value.is_valid() &&
 			!value->is_connected(LW_NAME(changed), callable_mp((Resource *)this, &Resource::emit_changed))) {
 		value->connect(LW_NAME(changed), callable_mp((Resource *)this, &Resource::emit_changed));
@@ -27,7 +31,7 @@ void BTSetAgentProperty::set_value(Ref<BBVariant> p_value) {
 
 void BTSetAgentProperty::set_operation(LimboUtility::Operation p_operation) {
 	operation = p_operation;
-	emit_changed();
+	_task_changed();
 }
 
 PackedStringArray BTSetAgentProperty::get_configuration_warnings() {
@@ -41,6 +45,25 @@ PackedStringArray BTSetAgentProperty::get_configuration_warnings() {
 	return warnings;
 }
 
+String BTSetAgentProperty::validate_runtime(LocalVector<StringName> &r_read_vars, LocalVector<StringName> &r_written_vars) const {
+	const String error = BTAction::validate_runtime(r_read_vars, r_written_vars);
+	if (!error.is_empty()) {
+		return error;
+	}
+	if (property == StringName()) {
+		return "`property` is not set.";
+	}
+	if (value.is_null()) {
+		return "`value` is not set.";
+	}
+	return String();
+}
+
+bool BTSetAgentProperty::can_tick_on_worker_thread() const {
+	// * Operations read the property of the agent, which must happen on the main thread, right before it is set.
+	return operation == LimboUtility::OPERATION_NONE;
+}
+
 String BTSetAgentProperty::_generate_name() {
 	if (property == StringName()) {
 		return "SetAgentProperty ???";
@@ -52,34 +75,48 @@ String BTSetAgentProperty::_generate_name() {
 			value.is_valid() ? Variant(value) : Variant("???"));
 }
 
+void BTSetAgentProperty::_setup() {
+	operation_func = LimboUtility::get_operation_func(value.is_valid() ? value->get_type() : Variant::NIL);
+	LIMBO_ERR_FAIL_COND_MSG(get_agent() == nullptr, "BTSetAgentProperty: Needs an agent node - headless instances don't have one.");
+}
+
 BT::Status BTSetAgentProperty::_tick(double p_delta) {
-	ERR_FAIL_COND_V_MSG(property == StringName(), FAILURE, "BTSetAgentProperty: `property` is not set.");
-	ERR_FAIL_COND_V_MSG(!value.is_valid(), FAILURE, "BTSetAgentProperty: `value` is not set.");
+	LIMBO_ERR_FAIL_COND_V_MSG(property == StringName(), FAILURE, "BTSetAgentProperty: `property` is not set.");
+	LIMBO_ERR_FAIL_COND_V_MSG(!value.is_valid(), FAILURE, "BTSetAgentProperty: `value` is not set.");
 
 	Variant result;
-	StringName error_value = LW_NAME(error_value);
+	const StringName &error_value = LW_NAME(error_value);
 	Variant right_value = value->get_value(get_scene_root(), get_blackboard(), error_value);
-	ERR_FAIL_COND_V_MSG(right_value == Variant(error_value), FAILURE, "BTSetAgentProperty: Couldn't get value of value-parameter.");
-	bool r_valid;
+	// Type is compared first, so that no StringName comparison happens for other value types.
+	LIMBO_ERR_FAIL_COND_V_MSG(right_value.get_type() == Variant::STRING_NAME && right_value == Variant(error_value), FAILURE, "BTSetAgentProperty: Couldn't get value of value-parameter.");
 	if (operation == LimboUtility::OPERATION_NONE) {
 		result = right_value;
 	} else {
-#ifdef LIMBOAI_MODULE
-		Variant left_value = get_agent()->get(property, &r_valid);
-		ERR_FAIL_COND_V_MSG(!r_valid, FAILURE, vformat("BTSetAgentProperty: Failed to get agent's \"%s\" property. Returning FAILURE.", property));
-#elif LIMBOAI_GDEXTENSION
-		Variant left_value = get_agent()->get(property);
-#endif
-		result = LimboUtility::get_singleton()->perform_operation(operation, left_value, right_value);
-		ERR_FAIL_COND_V_MSG(result == Variant(), FAILURE, "BTSetAgentProperty: Operation not valid. Returning FAILURE.");
+		Variant left_value;
+		LIMBO_ERR_FAIL_COND_V_MSG(!property_accessor.get(get_agent(), left_value), FAILURE, vformat("BTSetAgentProperty: Failed to get agent's \"%s\" property. Returning FAILURE.", property));
+		if (unlikely(operation_func == nullptr)) {
+			operation_func = LimboUtility::get_operation_func(value->get_type());
+		}
+		result = operation_func(operation, left_value, right_value);
+		LIMBO_ERR_FAIL_COND_V_MSG(result == Variant(), FAILURE, "BTSetAgentProperty: Operation not valid. Returning FAILURE.");
+	}
+
+	if (BTScheduler::is_deferring_calls()) {
+		// Ticking on a worker thread - the property is set on the main thread after the batch completes.
+		Array args;
+		if (property_accessor.is_indexed()) {
+			args.push_back(NodePath(String(property)));
+			args.push_back(result);
+			BTScheduler::defer_call(get_agent(), LW_NAME(set_indexed), args);
+		} else {
+			args.push_back(property);
+			args.push_back(result);
+			BTScheduler::defer_call(get_agent(), LW_NAME(set), args);
+		}
+		return SUCCESS;
 	}
 
-#ifdef LIMBOAI_MODULE
-	get_agent()->set(property, result, &r_valid);
-	ERR_FAIL_COND_V_MSG(!r_valid, FAILURE, vformat("BTSetAgentProperty: Couldn't set property \"%s\" with value \"%s\"", property, result));
-#elif LIMBOAI_GDEXTENSION
-	get_agent()->set(property, result);
-#endif
+	LIMBO_ERR_FAIL_COND_V_MSG(!property_accessor.set(get_agent(), result), FAILURE, vformat("BTSetAgentProperty: Couldn't set property \"%s\" with value \"%s\"", property, result));
 	return SUCCESS;
 }
 
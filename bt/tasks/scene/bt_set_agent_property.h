@@ -15,25 +15,32 @@
 #include "../bt_action.h"
 
 #include "../../../blackboard/bb_param/bb_variant.h"
+#include "../../../util/limbo_property_accessor.h"
 #include "../../../util/limbo_utility.h"
 
 class BTSetAgentProperty : public BTAction {
 	GDCLASS(BTSetAgentProperty, BTAction);
 	TASK_CATEGORY(Scene);
+	TASK_THREAD_SAFE();
 
 private:
 	StringName property;
+	LimboPropertyAccessor property_accessor;
 	Ref<BBVariant> value;
 	LimboUtility::Operation operation = LimboUtility::OPERATION_NONE;
+	LimboUtility::OperationFunc operation_func = nullptr; // Selected for the value type on setup.
 
 protected:
 	static void _bind_methods();
 
 	virtual String _generate_name() override;
+	virtual void _setup() override;
 	virtual Status _tick(double p_delta) override;
 
 public:
 	virtual PackedStringArray get_configuration_warnings() override;
+	virtual String validate_runtime(LocalVector<StringName> &r_read_vars, LocalVector<StringName> &r_written_vars) const override;
+	virtual bool can_tick_on_worker_thread() const override;
 
 	void set_property(StringName p_prop);
 	StringName get_property() const { return property; }
@@ -15,7 +15,7 @@
 
 void BTStopAnimation::set_animation_player(Ref<BBNode> p_animation_player) {
 	animation_player_param = p_animation_player;
-	emit_changed();
+	_task_changed();
 	if (Engine::get_singleton()->is_editor_hint() && animation_player_param.is_valid() &&
 			!animation_player_param->is_connected(LW_NAME(changed), callable_mp((Resource *)this, &Resource::emit_changed))) {
 		animation_player_param->connect(LW_NAME(changed), callable_mp((Resource *)this, &Resource::emit_changed));
@@ -24,12 +24,12 @@ void BTStopAnimation::set_animation_player(Ref<BBNode> p_animation_player) {
 
 void BTStopAnimation::set_animation_name(StringName p_animation_name) {
 	animation_name = p_animation_name;
-	emit_changed();
+	_task_changed();
 }
 
 void BTStopAnimation::set_keep_state(bool p_keep_state) {
 	keep_state = p_keep_state;
-	emit_changed();
+	_task_changed();
 }
 
 //**** Task Implementation
@@ -56,17 +56,20 @@ String BTStopAnimation::_generate_name() {
 
 void BTStopAnimation::_setup() {
 	setup_failed = true;
-	ERR_FAIL_COND_MSG(animation_player_param.is_null(), "BTStopAnimation: AnimationPlayer parameter is not set.");
-	animation_player = Object::cast_to<AnimationPlayer>(animation_player_param->get_value(get_scene_root(), get_blackboard()));
-	ERR_FAIL_COND_MSG(animation_player == nullptr, "BTStopAnimation: Failed to get AnimationPlayer.");
+	LIMBO_ERR_FAIL_COND_MSG(animation_player_param.is_null(), "BTStopAnimation: AnimationPlayer parameter is not set.");
+	player_resolver.reset();
+	AnimationPlayer *animation_player = player_resolver.resolve(animation_player_param, get_scene_root(), get_blackboard());
+	LIMBO_ERR_FAIL_COND_MSG(animation_player == nullptr, "BTStopAnimation: Failed to get AnimationPlayer.");
 	if (animation_name != StringName()) {
-		ERR_FAIL_COND_MSG(!animation_player->has_animation(animation_name), vformat("BTStopAnimation: Animation not found: %s", animation_name));
+		LIMBO_ERR_FAIL_COND_MSG(!player_resolver.has_animation(animation_name), vformat("BTStopAnimation: Animation not found: %s", animation_name));
 	}
 	setup_failed = false;
 }
 
 BT::Status BTStopAnimation::_tick(double p_delta) {
-	ERR_FAIL_COND_V_MSG(setup_failed == true, FAILURE, "BTStopAnimation: _setup() failed - returning FAILURE.");
+	LIMBO_ERR_FAIL_COND_V_MSG(setup_failed == true, FAILURE, "BTStopAnimation: _setup() failed - returning FAILURE.");
+	AnimationPlayer *animation_player = player_resolver.resolve(animation_player_param, get_scene_root(), get_blackboard());
+	LIMBO_ERR_FAIL_NULL_V_MSG(animation_player, FAILURE, "BTStopAnimation: Failed to get AnimationPlayer.");
 	if (animation_player->is_playing() && (animation_name == StringName() || animation_name == animation_player->get_assigned_animation())) {
 		animation_player->stop(keep_state);
 	}
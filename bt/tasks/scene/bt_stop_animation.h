@@ -15,6 +15,7 @@
 #include "../bt_action.h"
 
 #include "../../../blackboard/bb_param/bb_node.h"
+#include "bt_animation_player_resolver.h"
 
 #ifdef LIMBOAI_MODULE
 #include "scene/animation/animation_player.h"
@@ -33,7 +34,7 @@ private:
 	StringName animation_name;
 	bool keep_state = false;
 
-	AnimationPlayer *animation_player = nullptr;
+	BTAnimationPlayerResolver player_resolver;
 	bool setup_failed = false;
 
 protected:
@@ -13,6 +13,13 @@
 
 #include "../../../util/limbo_compat.h"
 #include "../../../util/limbo_utility.h"
+#include "../../bt_scheduler.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/object/class_db.h"
+#include "core/object/method_bind.h"
+#include "core/object/script_language.h"
+#endif // LIMBOAI_MODULE
 
 #ifdef LIMBOAI_GDEXTENSION
 #include "godot_cpp/classes/global_constants.hpp"
@@ -22,12 +29,15 @@
 
 void BTCallMethod::set_method(const StringName &p_method_name) {
 	method = p_method_name;
-	emit_changed();
+#ifdef LIMBOAI_MODULE
+	cached_object_id = 0;
+#endif
+	_task_changed();
 }
 
 void BTCallMethod::set_node_param(const Ref<BBNode> &p_object) {
 	node_param = p_object;
-	emit_changed();
+	_task_changed();
 	if (Engine::get_singleton()->is_editor_hint() && node_param.is_valid() &&
 			!node_param->is_connected(LW_NAME(changed), callable_mp((Resource *)this, &Resource::emit_changed))) {
 		node_param->connect(LW_NAME(changed), callable_mp((Resource *)this, &Resource::emit_changed));
@@ -36,21 +46,57 @@ void BTCallMethod::set_node_param(const Ref<BBNode> &p_object) {
 
 void BTCallMethod::set_include_delta(bool p_include_delta) {
 	include_delta = p_include_delta;
-	emit_changed();
+	_cache_args();
+	_task_changed();
 }
 
 void BTCallMethod::set_args(TypedArray<BBVariant> p_args) {
 	args = p_args;
-	emit_changed();
+	_cache_args();
+	_task_changed();
 }
 
 void BTCallMethod::set_result_var(const StringName &p_result_var) {
 	result_var = p_result_var;
-	emit_changed();
+	_task_changed();
 }
 
 //**** Task Implementation
 
+void BTCallMethod::_cache_args() {
+	arg_params.clear();
+	for (int i = 0; i < args.size(); i++) {
+		Ref<BBVariant> param = args[i];
+		arg_params.push_back(param.ptr());
+	}
+
+#ifdef LIMBOAI_MODULE
+	const int argument_count = arg_params.size() + int(include_delta);
+	arg_values.clear();
+	arg_values.resize(argument_count);
+	arg_ptrs.resize(argument_count);
+	for (int i = 0; i < argument_count; i++) {
+		arg_ptrs[i] = &arg_values[i];
+	}
+#elif LIMBOAI_GDEXTENSION
+	call_args = Array();
+	call_args.resize(arg_params.size() + int(include_delta));
+#endif
+}
+
+#ifdef LIMBOAI_MODULE
+void BTCallMethod::_resolve_method(Object *p_object) {
+	cached_object_id = p_object->get_instance_id();
+	cached_script_instance = p_object->get_script_instance();
+	cached_method_bind = nullptr;
+	if (cached_script_instance && cached_script_instance->has_method(method)) {
+		// * Script methods are called through Object::callp().
+		return;
+	}
+	cached_method_bind = ClassDB::get_method(p_object->get_class_name(), method);
+}
+#endif // LIMBOAI_MODULE
+
 PackedStringArray BTCallMethod::get_configuration_warnings() {
 	PackedStringArray warnings = BTAction::get_configuration_warnings();
 	if (method == StringName()) {
@@ -66,6 +112,42 @@ PackedStringArray BTCallMethod::get_configuration_warnings() {
 	return warnings;
 }
 
+String BTCallMethod::validate_runtime(LocalVector<StringName> &r_read_vars, LocalVector<StringName> &r_written_vars) const {
+	const String error = BTAction::validate_runtime(r_read_vars, r_written_vars);
+	if (!error.is_empty()) {
+		return error;
+	}
+	if (method == StringName()) {
+		return "Method Name is not set.";
+	}
+	if (node_param.is_null()) {
+		return "Node parameter is not set.";
+	}
+	for (int i = 0; i < args.size(); i++) {
+		Ref<BBVariant> arg = args[i];
+		if (arg.is_valid() && arg->get_value_source() == BBParam::BLACKBOARD_VAR) {
+			r_read_vars.push_back(arg->get_variable());
+		}
+	}
+	if (result_var != StringName()) {
+		r_written_vars.push_back(result_var);
+	}
+	return String();
+}
+
+bool BTCallMethod::can_tick_on_worker_thread() const {
+	// * Deferred calls complete after the tick, so a result can't be stored in the same tick as on the main thread.
+	if (result_var != StringName()) {
+		return false;
+	}
+	return node_param.is_valid() && !node_param->resolves_node_path(get_blackboard());
+}
+
+void BTCallMethod::_setup() {
+	// * Args may have been modified in place since they were assigned.
+	_cache_args();
+}
+
 String BTCallMethod::_generate_name() {
 	String args_str = include_delta ? "delta" : "";
 	if (args.size() > 0) {
@@ -82,43 +164,61 @@ String BTCallMethod::_generate_name() {
 }
 
 BT::Status BTCallMethod::_tick(double p_delta) {
-	ERR_FAIL_COND_V_MSG(method == StringName(), FAILURE, "BTCallMethod: Method Name is not set.");
-	ERR_FAIL_COND_V_MSG(node_param.is_null(), FAILURE, "BTCallMethod: Node parameter is not set.");
+	LIMBO_ERR_FAIL_COND_V_MSG(method == StringName(), FAILURE, "BTCallMethod: Method Name is not set.");
+	LIMBO_ERR_FAIL_COND_V_MSG(node_param.is_null(), FAILURE, "BTCallMethod: Node parameter is not set.");
 	Object *obj = node_param->get_value(get_scene_root(), get_blackboard());
-	ERR_FAIL_COND_V_MSG(obj == nullptr, FAILURE, "BTCallMethod: Failed to get object: " + node_param->to_string());
+	LIMBO_ERR_FAIL_COND_V_MSG(obj == nullptr, FAILURE, "BTCallMethod: Failed to get object: " + node_param->to_string());
 
 	Variant result;
-	Array call_args;
-
-#ifdef LIMBOAI_MODULE
-	const Variant delta = include_delta ? Variant(p_delta) : Variant();
-	const Variant **argptrs = nullptr;
 
-	int argument_count = include_delta ? args.size() + 1 : args.size();
-	if (argument_count > 0) {
-		argptrs = (const Variant **)alloca(sizeof(Variant *) * argument_count);
+	if (BTScheduler::is_deferring_calls()) {
+		// Ticking on a worker thread - the method is called on the main thread after the batch completes.
+		Array deferred_args;
 		if (include_delta) {
-			argptrs[0] = &delta;
+			deferred_args.push_back(Variant(p_delta));
 		}
-		for (int i = 0; i < args.size(); i++) {
-			Ref<BBVariant> param = args[i];
-			call_args.push_back(param->get_value(get_scene_root(), get_blackboard()));
-			argptrs[i + int(include_delta)] = &call_args[i];
+		for (BBVariant *param : arg_params) {
+			deferred_args.push_back(param->get_value(get_scene_root(), get_blackboard()));
 		}
+		BTScheduler::defer_call(obj, method, deferred_args, result_var != StringName() ? get_blackboard() : Ref<Blackboard>(), result_var);
+		return SUCCESS;
 	}
 
+#ifdef LIMBOAI_MODULE
+	if (include_delta) {
+		arg_values[0] = p_delta;
+	}
+	for (uint32_t i = 0; i < arg_params.size(); i++) {
+		arg_values[i + int(include_delta)] = arg_params[i]->get_value(get_scene_root(), get_blackboard());
+	}
+
+	if (obj->get_instance_id() != cached_object_id || obj->get_script_instance() != cached_script_instance) {
+		_resolve_method(obj);
+	}
+
+	const int argument_count = arg_values.size();
+	const Variant **argptrs = argument_count > 0 ? arg_ptrs.ptr() : nullptr;
 	Callable::CallError ce;
-	result = obj->callp(method, argptrs, argument_count, ce);
+	if (cached_method_bind) {
+		result = cached_method_bind->call(obj, argptrs, argument_count, ce);
+	} else {
+		result = obj->callp(method, argptrs, argument_count, ce);
+	}
 	if (ce.error != Callable::CallError::CALL_OK) {
-		ERR_FAIL_V_MSG(FAILURE, "BTCallMethod: Error calling method: " + Variant::get_call_error_text(obj, method, argptrs, argument_count, ce) + ".");
+		LIMBO_ERR_FAIL_V_MSG(FAILURE, "BTCallMethod: Error calling method: " + Variant::get_call_error_text(obj, method, argptrs, argument_count, ce) + ".");
+	}
+	for (Variant &value : arg_values) {
+		if (value.get_type() == Variant::OBJECT) {
+			// * Don't keep objects referenced until the next tick.
+			value = Variant();
+		}
 	}
 #elif LIMBOAI_GDEXTENSION
 	if (include_delta) {
-		call_args.push_back(Variant(p_delta));
+		call_args[0] = p_delta;
 	}
-	for (int i = 0; i < args.size(); i++) {
-		Ref<BBVariant> param = args[i];
-		call_args.push_back(param->get_value(get_scene_root(), get_blackboard()));
+	for (uint32_t i = 0; i < arg_params.size(); i++) {
+		call_args[i + int(include_delta)] = arg_params[i]->get_value(get_scene_root(), get_blackboard());
 	}
 
 	// TODO: Unsure how to detect call error, so we return SUCCESS for now...
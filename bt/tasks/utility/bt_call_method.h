@@ -17,9 +17,21 @@
 #include "../../../blackboard/bb_param/bb_node.h"
 #include "../../../blackboard/bb_param/bb_variant.h"
 
+#ifdef LIMBOAI_MODULE
+#include "core/templates/local_vector.h"
+
+class MethodBind;
+class ScriptInstance;
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/templates/local_vector.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
 class BTCallMethod : public BTAction {
 	GDCLASS(BTCallMethod, BTAction);
 	TASK_CATEGORY(Utility);
+	TASK_THREAD_SAFE();
 
 private:
 	StringName method;
@@ -28,10 +40,29 @@ private:
 	bool include_delta = false;
 	StringName result_var;
 
+	// Argument params and buffers reused between ticks.
+	LocalVector<BBVariant *> arg_params;
+#ifdef LIMBOAI_MODULE
+	LocalVector<Variant> arg_values; // Delta first, if included.
+	LocalVector<const Variant *> arg_ptrs;
+
+	// Method resolved for the last target object; null if the call has to go through Object::callp().
+	uint64_t cached_object_id = 0;
+	ScriptInstance *cached_script_instance = nullptr;
+	MethodBind *cached_method_bind = nullptr;
+
+	void _resolve_method(Object *p_object);
+#elif LIMBOAI_GDEXTENSION
+	Array call_args;
+#endif
+
+	void _cache_args();
+
 protected:
 	static void _bind_methods();
 
 	virtual String _generate_name() override;
+	virtual void _setup() override;
 	virtual Status _tick(double p_delta) override;
 
 public:
@@ -51,6 +82,8 @@ public:
 	StringName get_result_var() const { return result_var; }
 
 	virtual PackedStringArray get_configuration_warnings() override;
+	virtual String validate_runtime(LocalVector<StringName> &r_read_vars, LocalVector<StringName> &r_written_vars) const override;
+	virtual bool can_tick_on_worker_thread() const override;
 
 	BTCallMethod();
 };
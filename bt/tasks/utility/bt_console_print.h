@@ -17,6 +17,7 @@
 class BTConsolePrint : public BTAction {
 	GDCLASS(BTConsolePrint, BTAction);
 	TASK_CATEGORY(Utility);
+	TASK_THREAD_SAFE();
 
 private:
 	String text;
@@ -31,13 +32,13 @@ protected:
 public:
 	void set_text(String p_value) {
 		text = p_value;
-		emit_changed();
+		_task_changed();
 	}
 	String get_text() const { return text; }
 
 	void set_bb_format_parameters(const PackedStringArray &p_value) {
 		bb_format_parameters = p_value;
-		emit_changed();
+		_task_changed();
 	}
 	PackedStringArray get_bb_format_parameters() const { return bb_format_parameters; }
 
@@ -23,12 +23,13 @@
 
 void BTEvaluateExpression::set_expression_string(const String &p_expression_string) {
 	expression_string = p_expression_string;
-	emit_changed();
+	has_cached_result = false;
+	_task_changed();
 }
 
 void BTEvaluateExpression::set_node_param(Ref<BBNode> p_object) {
 	node_param = p_object;
-	emit_changed();
+	_task_changed();
 	if (Engine::get_singleton()->is_editor_hint() && node_param.is_valid() &&
 			!node_param->is_connected(LW_NAME(changed), callable_mp((Resource *)this, &Resource::emit_changed))) {
 		node_param->connect(LW_NAME(changed), callable_mp((Resource *)this, &Resource::emit_changed));
@@ -40,12 +41,12 @@ void BTEvaluateExpression::set_input_include_delta(bool p_input_include_delta) {
 		processed_input_values.resize(input_values.size() + int(p_input_include_delta));
 	}
 	input_include_delta = p_input_include_delta;
-	emit_changed();
+	_task_changed();
 }
 
 void BTEvaluateExpression::set_input_names(const PackedStringArray &p_input_names) {
 	input_names = p_input_names;
-	emit_changed();
+	_task_changed();
 }
 
 void BTEvaluateExpression::set_input_values(const TypedArray<BBVariant> &p_input_values) {
@@ -53,12 +54,21 @@ void BTEvaluateExpression::set_input_values(const TypedArray<BBVariant> &p_input
 		processed_input_values.resize(p_input_values.size() + int(input_include_delta));
 	}
 	input_values = p_input_values;
-	emit_changed();
+	if (get_blackboard().is_valid()) {
+		_build_input_slots();
+	}
+	_task_changed();
 }
 
 void BTEvaluateExpression::set_result_var(const StringName &p_result_var) {
 	result_var = p_result_var;
-	emit_changed();
+	_task_changed();
+}
+
+void BTEvaluateExpression::set_evaluate_on_input_change(bool p_enable) {
+	evaluate_on_input_change = p_enable;
+	has_cached_result = false;
+	_task_changed();
 }
 
 //**** Task Implementation
@@ -78,9 +88,94 @@ PackedStringArray BTEvaluateExpression::get_configuration_warnings() {
 	return warnings;
 }
 
+String BTEvaluateExpression::validate_runtime(LocalVector<StringName> &r_read_vars, LocalVector<StringName> &r_written_vars) const {
+	const String error = BTAction::validate_runtime(r_read_vars, r_written_vars);
+	if (!error.is_empty()) {
+		return error;
+	}
+	if (expression_string.is_empty()) {
+		return "Expression String is not set.";
+	}
+	if (node_param.is_null()) {
+		return "Node parameter is not set.";
+	}
+	if (is_parsed != OK) {
+		return "Failed to parse expression: " + expression->get_error_text();
+	}
+	for (int i = 0; i < input_values.size(); i++) {
+		Ref<BBVariant> input = input_values[i];
+		if (input.is_valid() && input->get_value_source() == BBParam::BLACKBOARD_VAR) {
+			r_read_vars.push_back(input->get_variable());
+		}
+	}
+	if (result_var != StringName()) {
+		r_written_vars.push_back(result_var);
+	}
+	return String();
+}
+
+void BTEvaluateExpression::_build_input_slots() {
+	input_slots.clear();
+	input_slots.resize(input_values.size());
+	for (int i = 0; i < input_values.size(); ++i) {
+		Ref<BBVariant> bb_variant = input_values[i];
+		input_slots[i].param = bb_variant.ptr();
+		if (bb_variant.is_valid() && bb_variant->get_value_source() == BBParam::BLACKBOARD_VAR) {
+			input_slots[i].handle = get_blackboard()->get_var_handle(bb_variant->get_variable());
+		}
+	}
+	has_cached_result = false;
+}
+
+void BTEvaluateExpression::_read_inputs() {
+	const Ref<Blackboard> &bb = get_blackboard();
+	for (uint32_t i = 0; i < input_slots.size(); ++i) {
+		InputSlot &slot = input_slots[i];
+		const StringName input_var = slot.param->get_value_source() == BBParam::BLACKBOARD_VAR ? slot.param->get_variable() : StringName();
+		if (unlikely(slot.handle.name != input_var)) {
+			// Input parameter was reconfigured after setup.
+			slot.handle = BBVarHandle();
+			slot.handle.name = input_var;
+		}
+		Variant &value = processed_input_values[i + int(input_include_delta)];
+		if (slot.handle.name == StringName()) {
+			value = slot.param->get_value(get_scene_root(), bb);
+		} else if (unlikely(!bb->try_get_var_by_handle(slot.handle, value))) {
+			LIMBO_ERR_PRINT(vformat("BBParam: Blackboard variable \"%s\" doesn't exist.", slot.handle.name));
+			value = Variant();
+		}
+		slot.last_version = slot.handle.name == StringName() ? 0 : bb->get_var_version(slot.handle);
+		slot.last_epoch = slot.handle.epoch;
+		if (value.get_type() == Variant::ARRAY || value.get_type() == Variant::DICTIONARY || value.get_type() == Variant::OBJECT) {
+			// May change without bumping the variable version.
+			slot.last_version = -1;
+		}
+	}
+}
+
+bool BTEvaluateExpression::_inputs_unchanged(Object *p_object) {
+	if (!has_cached_result || input_include_delta || p_object->get_instance_id() != last_object_id) {
+		return false;
+	}
+	const Ref<Blackboard> &bb = get_blackboard();
+	for (InputSlot &slot : input_slots) {
+		if (slot.last_version < 0) {
+			return false;
+		}
+		if (slot.handle.name == StringName()) {
+			continue;
+		}
+		if (bb->get_var_version(slot.handle) != slot.last_version || slot.handle.epoch != slot.last_epoch) {
+			return false;
+		}
+	}
+	return true;
+}
+
 void BTEvaluateExpression::_setup() {
+	_build_input_slots();
 	parse();
-	ERR_FAIL_COND_MSG(is_parsed != Error::OK, "BTEvaluateExpression: Failed to parse expression: " + expression->get_error_text());
+	LIMBO_ERR_FAIL_COND_MSG(is_parsed != Error::OK, "BTEvaluateExpression: Failed to parse expression: " + expression->get_error_text());
 }
 
 Error BTEvaluateExpression::parse() {
@@ -106,22 +201,26 @@ String BTEvaluateExpression::_generate_name() {
 }
 
 BT::Status BTEvaluateExpression::_tick(double p_delta) {
-	ERR_FAIL_COND_V_MSG(expression_string.is_empty(), FAILURE, "BTEvaluateExpression: Expression String is not set.");
-	ERR_FAIL_COND_V_MSG(node_param.is_null(), FAILURE, "BTEvaluateExpression: Node parameter is not set.");
+	LIMBO_ERR_FAIL_COND_V_MSG(expression_string.is_empty(), FAILURE, "BTEvaluateExpression: Expression String is not set.");
+	LIMBO_ERR_FAIL_COND_V_MSG(node_param.is_null(), FAILURE, "BTEvaluateExpression: Node parameter is not set.");
 	Object *obj = node_param->get_value(get_scene_root(), get_blackboard());
-	ERR_FAIL_COND_V_MSG(obj == nullptr, FAILURE, "BTEvaluateExpression: Failed to get object: " + node_param->to_string());
-	ERR_FAIL_COND_V_MSG(is_parsed != Error::OK, FAILURE, "BTEvaluateExpression: Failed to parse expression: " + expression->get_error_text());
+	LIMBO_ERR_FAIL_COND_V_MSG(obj == nullptr, FAILURE, "BTEvaluateExpression: Failed to get object: " + node_param->to_string());
+	LIMBO_ERR_FAIL_COND_V_MSG(is_parsed != Error::OK, FAILURE, "BTEvaluateExpression: Failed to parse expression: " + expression->get_error_text());
+
+	if (evaluate_on_input_change && _inputs_unchanged(obj)) {
+		// * Skipped: the result stored on the last evaluation is still valid.
+		return SUCCESS;
+	}
 
 	if (input_include_delta) {
 		processed_input_values[0] = p_delta;
 	}
-	for (int i = 0; i < input_values.size(); ++i) {
-		const Ref<BBVariant> &bb_variant = input_values[i];
-		processed_input_values[i + int(input_include_delta)] = bb_variant->get_value(get_scene_root(), get_blackboard());
-	}
+	_read_inputs();
 
 	Variant result = expression->execute(processed_input_values, obj, false);
-	ERR_FAIL_COND_V_MSG(expression->has_execute_failed(), FAILURE, "BTEvaluateExpression: Failed to execute: " + expression->get_error_text());
+	LIMBO_ERR_FAIL_COND_V_MSG(expression->has_execute_failed(), FAILURE, "BTEvaluateExpression: Failed to execute: " + expression->get_error_text());
+	last_object_id = obj->get_instance_id();
+	has_cached_result = true;
 
 	if (result_var != StringName()) {
 		get_blackboard()->set_var(result_var, result);
@@ -146,10 +245,13 @@ void BTEvaluateExpression::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_input_delta_included"), &BTEvaluateExpression::is_input_delta_included);
 	ClassDB::bind_method(D_METHOD("set_result_var", "variable"), &BTEvaluateExpression::set_result_var);
 	ClassDB::bind_method(D_METHOD("get_result_var"), &BTEvaluateExpression::get_result_var);
+	ClassDB::bind_method(D_METHOD("set_evaluate_on_input_change", "enable"), &BTEvaluateExpression::set_evaluate_on_input_change);
+	ClassDB::bind_method(D_METHOD("is_evaluated_on_input_change"), &BTEvaluateExpression::is_evaluated_on_input_change);
 
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "node", PROPERTY_HINT_RESOURCE_TYPE, "BBNode"), "set_node_param", "get_node_param");
 	ADD_PROPERTY(PropertyInfo(Variant::STRING, "expression_string"), "set_expression_string", "get_expression_string");
 	ADD_PROPERTY(PropertyInfo(Variant::STRING_NAME, "result_var"), "set_result_var", "get_result_var");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "evaluate_on_input_change"), "set_evaluate_on_input_change", "is_evaluated_on_input_change");
 	ADD_GROUP("Inputs", "input_");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "input_include_delta"), "set_input_include_delta", "is_input_delta_included");
 	ADD_PROPERTY(PropertyInfo(Variant::PACKED_STRING_ARRAY, "input_names", PROPERTY_HINT_ARRAY_TYPE, "String"), "set_input_names", "get_input_names");
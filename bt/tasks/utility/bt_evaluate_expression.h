@@ -26,6 +26,14 @@
 #include "../../../blackboard/bb_param/bb_node.h"
 #include "../../../blackboard/bb_param/bb_variant.h"
 
+#ifdef LIMBOAI_MODULE
+#include "core/templates/local_vector.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/templates/local_vector.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
 class BTEvaluateExpression : public BTAction {
 	GDCLASS(BTEvaluateExpression, BTAction);
 	TASK_CATEGORY(Utility);
@@ -40,6 +48,22 @@ private:
 	bool input_include_delta = false;
 	Array processed_input_values;
 	StringName result_var;
+	bool evaluate_on_input_change = false;
+
+	// Inputs resolved on setup: blackboard variables are read through handles.
+	struct InputSlot {
+		BBVariant *param = nullptr;
+		BBVarHandle handle; // Empty name if the input is a saved value.
+		int64_t last_version = -1;
+		uint64_t last_epoch = 0;
+	};
+	LocalVector<InputSlot> input_slots;
+	uint64_t last_object_id = 0;
+	bool has_cached_result = false;
+
+	void _build_input_slots();
+	void _read_inputs();
+	bool _inputs_unchanged(Object *p_object);
 
 protected:
 	static void _bind_methods();
@@ -69,7 +93,11 @@ public:
 	void set_result_var(const StringName &p_result_var);
 	StringName get_result_var() const { return result_var; }
 
+	void set_evaluate_on_input_change(bool p_enable);
+	bool is_evaluated_on_input_change() const { return evaluate_on_input_change; }
+
 	virtual PackedStringArray get_configuration_warnings() override;
+	virtual String validate_runtime(LocalVector<StringName> &r_read_vars, LocalVector<StringName> &r_written_vars) const override;
 
 	BTEvaluateExpression();
 };
@@ -17,6 +17,8 @@
 class BTFail : public BTAction {
 	GDCLASS(BTFail, BTAction);
 	TASK_CATEGORY(Utility);
+	TASK_THREAD_SAFE();
+	TASK_PURE();
 
 protected:
 	static void _bind_methods() {}
@@ -20,11 +20,12 @@ String BTRandomWait::_generate_name() {
 }
 
 void BTRandomWait::_enter() {
-	duration = RAND_RANGE(min_duration, max_duration);
+	duration = _get_rng().randf_range(min_duration, max_duration);
 }
 
 BT::Status BTRandomWait::_tick(double p_delta) {
 	if (get_elapsed_time() < duration) {
+		request_wake_after(duration - get_elapsed_time());
 		return RUNNING;
 	} else {
 		return SUCCESS;
@@ -36,7 +37,7 @@ void BTRandomWait::set_min_duration(double p_max_duration) {
 	if (max_duration < min_duration) {
 		set_max_duration(min_duration);
 	}
-	emit_changed();
+	_task_changed();
 }
 
 void BTRandomWait::set_max_duration(double p_max_duration) {
@@ -44,7 +45,7 @@ void BTRandomWait::set_max_duration(double p_max_duration) {
 	if (min_duration > max_duration) {
 		set_min_duration(max_duration);
 	}
-	emit_changed();
+	_task_changed();
 }
 
 void BTRandomWait::_bind_methods() {
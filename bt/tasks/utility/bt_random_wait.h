@@ -30,6 +30,8 @@ protected:
 	virtual String _generate_name() override;
 	virtual void _enter() override;
 	virtual Status _tick(double p_delta) override;
+	virtual void _save_state(LimboSnapshotWriter &p_writer) const override { p_writer.put_double(duration); }
+	virtual void _load_state(LimboSnapshotReader &p_reader) override { duration = p_reader.get_double(); }
 
 public:
 	void set_min_duration(double p_max_duration);
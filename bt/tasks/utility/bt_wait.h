@@ -17,6 +17,8 @@
 class BTWait : public BTAction {
 	GDCLASS(BTWait, BTAction);
 	TASK_CATEGORY(Utility);
+	TASK_THREAD_SAFE();
+	TASK_PURE();
 
 private:
 	double duration = 1.0;
@@ -26,11 +28,12 @@ protected:
 
 	virtual String _generate_name() override;
 	virtual Status _tick(double p_delta) override;
+	virtual void _tick_batch(const TaskBatchContext &p_batch) override { _tick_batch_leaves(p_batch); }
 
 public:
 	void set_duration(double p_value) {
 		duration = p_value;
-		emit_changed();
+		_task_changed();
 	}
 	double get_duration() const { return duration; }
 };
@@ -17,6 +17,8 @@
 class BTWaitTicks : public BTAction {
 	GDCLASS(BTWaitTicks, BTAction);
 	TASK_CATEGORY(Utility);
+	TASK_THREAD_SAFE();
+	TASK_PURE();
 
 private:
 	int num_ticks = 1;
@@ -29,11 +31,13 @@ protected:
 	virtual String _generate_name() override;
 	virtual void _enter() override;
 	virtual Status _tick(double p_delta) override;
+	virtual void _save_state(LimboSnapshotWriter &p_writer) const override { p_writer.put_u32(num_passed); }
+	virtual void _load_state(LimboSnapshotReader &p_reader) override { num_passed = p_reader.get_u32(); }
 
 public:
 	void set_num_ticks(int p_value) {
 		num_ticks = p_value;
-		emit_changed();
+		_task_changed();
 	}
 	int get_num_ticks() const { return num_ticks; }
 };
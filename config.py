@@ -5,6 +5,14 @@ def can_build(env, platform):
     return True
 
 
+def get_opts(platform):
+    from SCons.Variables import BoolVariable
+
+    return [
+        BoolVariable("limboai_tracy", "Emit Tracy profiler zones from LimboAI (requires Tracy headers)", False),
+    ]
+
+
 def configure(env):
     pass
 
@@ -48,6 +56,7 @@ def get_doc_classes():
         "BBTransform",
         "BBTransform2D",
         "BBTransform3D",
+        "BBVarRef",
         "BBVariant",
         "BBVector2",
         "BBVector2Array",
@@ -66,8 +75,11 @@ def get_doc_classes():
         "BTAction",
         "BTAlwaysFail",
         "BTAlwaysSucceed",
+        "BTAsyncAction",
         "BTAwaitAnimation",
+        "BTCache",
         "BTCallMethod",
+        "BTCheckExpression",
         "BTEvaluateExpression",
         "BTCheckAgentProperty",
         "BTCheckTrigger",
@@ -75,23 +87,33 @@ def get_doc_classes():
         "BTComment",
         "BTComposite",
         "BTCondition",
+        "BTConsideration",
         "BTConsolePrint",
         "BTCooldown",
+        "BTCrowd",
         "BTDecorator",
         "BTDelay",
         "BTDynamicSelector",
         "BTDynamicSequence",
+        "BTEventSelector",
         "BTFail",
+        "BTFindPath",
         "BTForEach",
         "BTInstance",
+        "BTInstancePool",
         "BTInvert",
         "BTNewScope",
+        "BTObserver",
         "BTParallel",
         "BTPauseAnimation",
+        "BTPlanAction",
+        "BTPlanner",
         "BTPlayAnimation",
         "BTPlayer",
         "BTProbability",
         "BTProbabilitySelector",
+        "BTQueryNearby",
+        "BTProfile",
         "BTRandomSelector",
         "BTRandomSequence",
         "BTRandomWait",
@@ -99,6 +121,8 @@ def get_doc_classes():
         "BTRepeatUntilFailure",
         "BTRepeatUntilSuccess",
         "BTRunLimit",
+        "BTRunner",
+        "BTScheduler",
         "BTSelector",
         "BTSequence",
         "BTSetAgentProperty",
@@ -107,10 +131,18 @@ def get_doc_classes():
         "BTStopAnimation",
         "BTSubtree",
         "BTTask",
+        "BTTelemetry",
         "BTTimeLimit",
+        "BTTrace",
+        "BTUtilitySelector",
         "BTWait",
         "BTWaitTicks",
+        "LimboEventChannel",
         "LimboHSM",
+        "LimboHSMInstance",
+        "LimboHSMResource",
         "LimboState",
+        "LimboStateResource",
         "LimboUtility",
+        "SharedBlackboard",
     ]
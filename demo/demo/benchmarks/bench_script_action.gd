@@ -0,0 +1,23 @@
+#*
+#* bench_script_action.gd
+#* =============================================================================
+#* Copyright 2021-2024 Serhii Snitsaruk
+#*
+#* Use of this source code is governed by an MIT-style
+#* license that can be found in the LICENSE file or at
+#* https://opensource.org/licenses/MIT.
+#* =============================================================================
+#*
+extends BTAction
+## Minimal script task for measuring the cost of calling into scripts from behavior trees.
+
+var ticks: int = 0
+
+
+func _enter() -> void:
+	pass
+
+
+func _tick(_delta: float) -> Status:
+	ticks += 1
+	return SUCCESS
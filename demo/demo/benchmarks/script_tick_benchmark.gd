@@ -0,0 +1,71 @@
+#*
+#* script_tick_benchmark.gd
+#* =============================================================================
+#* Copyright 2021-2024 Serhii Snitsaruk
+#*
+#* Use of this source code is governed by an MIT-style
+#* license that can be found in the LICENSE file or at
+#* https://opensource.org/licenses/MIT.
+#* =============================================================================
+#*
+extends SceneTree
+## Measures the cost of ticking script-defined tasks, compared to built-in ones.
+## Run it with both the module and the GDExtension builds to compare them:
+##   godot --headless --path demo --script res://demo/benchmarks/script_tick_benchmark.gd
+## Each benchmark prints a JSON line in the same format as the C++ benchmarks in tests/test_benchmarks.h.
+
+const ScriptAction := preload("res://demo/benchmarks/bench_script_action.gd")
+
+const NUM_TASKS := 64
+const ITERATIONS := 20000
+
+
+func _initialize() -> void:
+	var build := "gdextension" if _is_extension() else "module"
+	_run("tick_script_actions_%d_%s" % [NUM_TASKS, build], _make_script_action)
+	_run("tick_builtin_actions_%d_%s" % [NUM_TASKS, build], _make_builtin_action)
+	quit()
+
+
+func _is_extension() -> bool:
+	for ext in GDExtensionManager.get_loaded_extensions():
+		if ext.contains("limboai"):
+			return true
+	return false
+
+
+func _make_script_action() -> BTTask:
+	return ScriptAction.new()
+
+
+# Succeeds right away, like ScriptAction.
+func _make_builtin_action() -> BTTask:
+	var task := BTWaitTicks.new()
+	task.num_ticks = 0
+	return task
+
+
+func _run(p_name: String, p_make_task: Callable) -> void:
+	var seq := BTSequence.new()
+	for i in NUM_TASKS:
+		seq.add_child(p_make_task.call())
+	var bt := BehaviorTree.new()
+	bt.root_task = seq
+
+	var agent := Node.new()
+	root.add_child(agent)
+	var instance: BTInstance = bt.instantiate(agent, Blackboard.new(), agent, agent)
+
+	var start := Time.get_ticks_usec()
+	for i in ITERATIONS:
+		instance.update(0.01666)
+	var usec: int = maxi(Time.get_ticks_usec() - start, 1)
+
+	var ticks := ITERATIONS * NUM_TASKS
+	print(JSON.stringify({
+		"benchmark": p_name,
+		"iterations": ticks,
+		"usec": usec,
+		"ops_per_sec": float(ticks) * 1000000.0 / float(usec),
+	}))
+	agent.free()
@@ -0,0 +1,170 @@
+#*
+#* stress_test.gd
+#* =============================================================================
+#* Copyright 2021-2024 Serhii Snitsaruk
+#*
+#* Use of this source code is governed by an MIT-style
+#* license that can be found in the LICENSE file or at
+#* https://opensource.org/licenses/MIT.
+#* =============================================================================
+#*
+extends SceneTree
+## Spawns increasing numbers of demo agents and measures how the AI cost scales.
+## Run it headless, optionally passing agent counts and the number of measured frames:
+##   godot --headless --path demo --script res://demo/benchmarks/stress_test.gd -- --agents=1000,10000,50000 --frames=300
+## Agents are the demo NPCs (behavior trees), with every tenth one being a player (LimboHSM).
+## Prints a single JSON object with one entry per agent count; pass --output=PATH to also write it to a file.
+
+const AGENT_SCENES: Array[String] = [
+	"res://demo/agents/01_agent_melee_simple.tscn",
+	"res://demo/agents/02_agent_charger.tscn",
+	"res://demo/agents/03_agent_imp.tscn",
+	"res://demo/agents/04_agent_skirmisher.tscn",
+	"res://demo/agents/05_agent_ranged.tscn",
+	"res://demo/agents/06_agent_melee_combo.tscn",
+	"res://demo/agents/07_agent_melee_nuanced.tscn",
+	"res://demo/agents/08_agent_demon.tscn",
+	"res://demo/agents/09_agent_summoner.tscn",
+]
+const PLAYER_SCENE := "res://demo/agents/player/player.tscn"
+
+const MAX_AGENTS := 50000
+const HSM_EVERY := 10
+const WARMUP_FRAMES := 30
+const ARENA_SIZE := 8000.0
+
+var agent_counts: Array[int] = [100, 1000, 5000]
+var measured_frames: int = 300
+var output_path: String = ""
+
+var _scenes: Array[PackedScene] = []
+var _player_scene: PackedScene
+var _results: Array[Dictionary] = []
+
+# State of the current run.
+var _run_index: int = -1
+var _arena: Node2D
+var _frame: int = 0
+var _ai_samples: PackedFloat64Array
+var _process_samples: PackedFloat64Array
+var _current: Dictionary
+
+
+func _initialize() -> void:
+	_parse_args()
+	for path in AGENT_SCENES:
+		_scenes.append(load(path))
+	_player_scene = load(PLAYER_SCENE)
+	_next_run()
+
+
+func _process(_delta: float) -> bool:
+	if _arena == null:
+		return true
+	_frame += 1
+	if _frame > WARMUP_FRAMES:
+		_ai_samples.append(Performance.get_custom_monitor(&"LimboAI/update_time_ms"))
+		_process_samples.append(Performance.get_monitor(Performance.TIME_PROCESS) * 1000.0)
+	if _frame >= WARMUP_FRAMES + measured_frames:
+		_finish_run()
+		return not _next_run()
+	return false
+
+
+func _parse_args() -> void:
+	for arg in OS.get_cmdline_user_args():
+		if arg.begins_with("--agents="):
+			agent_counts.clear()
+			for s in arg.trim_prefix("--agents=").split(",", false):
+				agent_counts.append(clampi(s.to_int(), 1, MAX_AGENTS))
+		elif arg.begins_with("--frames="):
+			measured_frames = maxi(arg.trim_prefix("--frames=").to_int(), 1)
+		elif arg.begins_with("--output="):
+			output_path = arg.trim_prefix("--output=")
+
+
+## Spawns the agents for the next count. Returns false when all counts are done.
+func _next_run() -> bool:
+	_run_index += 1
+	if _run_index >= agent_counts.size():
+		_report()
+		return false
+
+	var count: int = agent_counts[_run_index]
+	var rng := RandomNumberGenerator.new()
+	rng.seed = 12345
+	_arena = Node2D.new()
+	root.add_child(_arena)
+
+	var memory_before := OS.get_static_memory_usage()
+	var start := Time.get_ticks_usec()
+	for i in count:
+		var scene: PackedScene = _player_scene if i % HSM_EVERY == 0 else _scenes[i % _scenes.size()]
+		var agent: Node2D = scene.instantiate()
+		agent.position = Vector2(rng.randf() * ARENA_SIZE, rng.randf() * ARENA_SIZE)
+		# * Adding to the tree instantiates behavior trees and state machines.
+		_arena.add_child(agent)
+	var spawn_usec: int = maxi(Time.get_ticks_usec() - start, 1)
+	var memory_after := OS.get_static_memory_usage()
+
+	_frame = 0
+	_ai_samples = PackedFloat64Array()
+	_process_samples = PackedFloat64Array()
+	_current = {
+		"agents": count,
+		"hsm_agents": ceili(count / float(HSM_EVERY)),
+		"spawn_usec": spawn_usec,
+		"spawn_usec_per_agent": spawn_usec / float(count),
+		"memory_bytes_per_agent": (memory_after - memory_before) / float(count),
+	}
+	return true
+
+
+func _finish_run() -> void:
+	_current["frames"] = _ai_samples.size()
+	_current["ai_ms"] = _summarize(_ai_samples)
+	_current["process_ms"] = _summarize(_process_samples)
+	_current["ai_usec_per_agent"] = _current["ai_ms"]["mean"] * 1000.0 / float(_current["agents"])
+	_results.append(_current)
+	_arena.free()
+	_arena = null
+
+
+func _summarize(p_samples: PackedFloat64Array) -> Dictionary:
+	var sorted := p_samples.duplicate()
+	sorted.sort()
+	var total := 0.0
+	for v in sorted:
+		total += v
+	var n := sorted.size()
+	return {
+		"mean": total / n if n > 0 else 0.0,
+		"p50": sorted[n / 2] if n > 0 else 0.0,
+		"p95": sorted[mini(ceili(n * 0.95), n) - 1] if n > 0 else 0.0,
+		"max": sorted[n - 1] if n > 0 else 0.0,
+	}
+
+
+func _report() -> void:
+	var report := {
+		"benchmark": "stress_test",
+		"build": "gdextension" if _is_extension() else "module",
+		"debug": OS.is_debug_build(),
+		"warmup_frames": WARMUP_FRAMES,
+		"runs": _results,
+	}
+	var json := JSON.stringify(report, "  ")
+	print(json)
+	if not output_path.is_empty():
+		var file := FileAccess.open(output_path, FileAccess.WRITE)
+		if file:
+			file.store_string(json)
+		else:
+			push_error("Can't write to " + output_path)
+
+
+func _is_extension() -> bool:
+	for ext in GDExtensionManager.get_loaded_extensions():
+		if ext.contains("limboai"):
+			return true
+	return false
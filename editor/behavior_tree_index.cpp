@@ -0,0 +1,282 @@
+/**
+ * behavior_tree_index.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifdef TOOLS_ENABLED
+
+#include "behavior_tree_index.h"
+
+#include "../blackboard/bb_param/bb_param.h"
+#include "../bt/behavior_tree.h"
+#include "../bt/tasks/decorators/bt_subtree.h"
+#include "../util/limbo_compat.h"
+#include "../util/limbo_profiling.h"
+#include "../util/limbo_string_names.h"
+#include "../util/limbo_ticks.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/io/config_file.h"
+#include "core/io/file_access.h"
+#include "editor/editor_file_system.h"
+#include "editor/editor_paths.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/config_file.hpp>
+#include <godot_cpp/classes/editor_file_system.hpp>
+#include <godot_cpp/classes/editor_file_system_directory.hpp>
+#include <godot_cpp/classes/editor_interface.hpp>
+#include <godot_cpp/classes/editor_paths.hpp>
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/resource_loader.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+String BehaviorTreeIndex::_get_index_path() const {
+	return GET_PROJECT_SETTINGS_DIR().path_join("limbo_ai_bt_index.cfg");
+}
+
+void BehaviorTreeIndex::_load() {
+	loaded = true;
+	Ref<ConfigFile> cf;
+	cf.instantiate();
+	if (cf->load(_get_index_path()) != OK || int(cf->get_value("LimboAI", "version", 0)) != INDEX_VERSION) {
+		return;
+	}
+	const PackedStringArray sections = cf->get_sections();
+	for (int i = 0; i < sections.size(); i++) {
+		const String &path = sections[i];
+		if (path == "LimboAI") {
+			continue;
+		}
+		Entry entry;
+		entry.modified_time = uint64_t(int64_t(cf->get_value(path, "modified_time", 0)));
+		entry.tasks = cf->get_value(path, "tasks", PackedStringArray());
+		entry.subtrees = cf->get_value(path, "subtrees", PackedStringArray());
+		entry.variables = cf->get_value(path, "variables", PackedStringArray());
+		entries.insert(path, entry);
+	}
+}
+
+void BehaviorTreeIndex::_save() {
+	Ref<ConfigFile> cf;
+	cf.instantiate();
+	cf->set_value("LimboAI", "version", INDEX_VERSION);
+	for (const KeyValue<String, Entry> &kv : entries) {
+		cf->set_value(kv.key, "modified_time", int64_t(kv.value.modified_time));
+		cf->set_value(kv.key, "tasks", kv.value.tasks);
+		cf->set_value(kv.key, "subtrees", kv.value.subtrees);
+		cf->set_value(kv.key, "variables", kv.value.variables);
+	}
+	Error err = cf->save(_get_index_path());
+	ERR_FAIL_COND_MSG(err != OK, "BehaviorTreeIndex: Failed to save index: " + _get_index_path());
+	dirty = false;
+}
+
+void BehaviorTreeIndex::_request_scan() {
+	scan_requested = true;
+	set_process(true);
+}
+
+void BehaviorTreeIndex::_scan_dir(EditorFileSystemDirectory *p_dir, HashSet<String> &r_found) {
+	for (int i = 0; i < p_dir->get_file_count(); i++) {
+		if (String(p_dir->get_file_type(i)) != "BehaviorTree") {
+			continue;
+		}
+		const String path = p_dir->get_file_path(i);
+		r_found.insert(path);
+		const Entry *entry = entries.getptr(path);
+		if (entry == nullptr || entry->modified_time != FileAccess::get_modified_time(path)) {
+			pending.push_back(path);
+		}
+	}
+	for (int i = 0; i < p_dir->get_subdir_count(); i++) {
+		_scan_dir(p_dir->get_subdir(i), r_found);
+	}
+}
+
+// Finds trees that changed since they were indexed. Only compares modification times - nothing is loaded.
+void BehaviorTreeIndex::_scan() {
+	scan_requested = false;
+	if (!loaded) {
+		_load();
+	}
+	EditorFileSystemDirectory *root = EDITOR_FILE_SYSTEM()->get_filesystem();
+	if (root == nullptr) {
+		return;
+	}
+	pending.clear();
+	HashSet<String> found;
+	_scan_dir(root, found);
+
+	LocalVector<String> removed;
+	for (const KeyValue<String, Entry> &kv : entries) {
+		if (!found.has(kv.key)) {
+			removed.push_back(kv.key);
+		}
+	}
+	for (const String &path : removed) {
+		entries.erase(path);
+		dirty = true;
+	}
+}
+
+void BehaviorTreeIndex::_collect(const Ref<BTTask> &p_task, HashSet<String> &r_tasks, HashSet<String> &r_subtrees, HashSet<String> &r_variables) const {
+	Ref<Script> sc = GET_SCRIPT(p_task);
+	r_tasks.insert(sc.is_valid() && !sc->get_path().is_empty() ? sc->get_path() : String(p_task->get_class()));
+
+	const BTSubtree *subtree = Object::cast_to<BTSubtree>(p_task.ptr());
+	if (subtree && subtree->get_subtree().is_valid() && !subtree->get_subtree()->get_path().is_empty()) {
+		r_subtrees.insert(subtree->get_subtree()->get_path());
+	}
+
+	// * Variables are referenced by name properties (see EditorInspectorPluginVariableName) and by parameters.
+	LocalVector<StringName> names;
+#ifdef LIMBOAI_MODULE
+	List<PropertyInfo> props;
+	p_task->get_property_list(&props);
+	for (const PropertyInfo &pi : props) {
+		if (pi.usage & PROPERTY_USAGE_STORAGE) {
+			names.push_back(pi.name);
+		}
+	}
+#elif LIMBOAI_GDEXTENSION
+	TypedArray<Dictionary> props = p_task->get_property_list();
+	for (int i = 0; i < props.size(); i++) {
+		Dictionary prop = props[i];
+		if (int(prop["usage"]) & PROPERTY_USAGE_STORAGE) {
+			names.push_back(prop["name"]);
+		}
+	}
+#endif // LIMBOAI_MODULE & LIMBOAI_GDEXTENSION
+
+	for (const StringName &name : names) {
+		const Variant value = p_task->get(name);
+		if (value.get_type() == Variant::STRING_NAME || value.get_type() == Variant::STRING) {
+			const String prop_name = name;
+			if ((prop_name.ends_with("_var") || prop_name.ends_with("variable")) && !String(value).is_empty()) {
+				r_variables.insert(value);
+			}
+		} else if (value.get_type() == Variant::OBJECT) {
+			const BBParam *param = Object::cast_to<BBParam>(value.operator Object *());
+			if (param && param->get_value_source() == BBParam::BLACKBOARD_VAR && param->get_variable() != StringName()) {
+				r_variables.insert(param->get_variable());
+			}
+		}
+	}
+
+	for (int i = 0; i < p_task->get_child_count(); i++) {
+		_collect(p_task->get_child(i), r_tasks, r_subtrees, r_variables);
+	}
+}
+
+static PackedStringArray _to_sorted_array(const HashSet<String> &p_set) {
+	PackedStringArray arr;
+	for (const String &s : p_set) {
+		arr.push_back(s);
+	}
+	arr.sort();
+	return arr;
+}
+
+void BehaviorTreeIndex::_index_file(const String &p_path) {
+	Entry entry;
+	entry.modified_time = FileAccess::get_modified_time(p_path);
+	// * Trees that are open in the editor are indexed as saved on disk, not as edited.
+	Ref<BehaviorTree> bt = RESOURCE_LOAD_NO_CACHE(p_path, "BehaviorTree");
+	if (bt.is_valid()) {
+		HashSet<String> tasks;
+		HashSet<String> subtrees;
+		HashSet<String> variables;
+		if (bt->get_blackboard_plan().is_valid()) {
+			TypedArray<StringName> plan_vars = bt->get_blackboard_plan()->list_vars();
+			for (int i = 0; i < plan_vars.size(); i++) {
+				variables.insert(plan_vars[i]);
+			}
+		}
+		if (bt->get_root_task().is_valid()) {
+			_collect(bt->get_root_task(), tasks, subtrees, variables);
+		}
+		entry.tasks = _to_sorted_array(tasks);
+		entry.subtrees = _to_sorted_array(subtrees);
+		entry.variables = _to_sorted_array(variables);
+	}
+	entries.insert(p_path, entry);
+	dirty = true;
+}
+
+void BehaviorTreeIndex::_process_pending() {
+	LIMBO_PROFILE_ZONE("BehaviorTreeIndex::_process_pending");
+	if (scan_requested) {
+		_scan();
+	}
+	const uint64_t start = LimboTicks::now();
+	while (!pending.is_empty() && LimboTicks::to_usec(LimboTicks::now() - start) < MAX_USEC_PER_FRAME) {
+		const String path = pending[pending.size() - 1];
+		pending.remove_at(pending.size() - 1);
+		_index_file(path);
+	}
+	if (pending.is_empty()) {
+		set_process(false);
+		if (dirty) {
+			_save();
+		}
+		emit_signal(LW_NAME(index_updated));
+	}
+}
+
+PackedStringArray BehaviorTreeIndex::_find(const String &p_value, PackedStringArray Entry::*p_field) const {
+	PackedStringArray found;
+	for (const KeyValue<String, Entry> &kv : entries) {
+		if ((kv.value.*p_field).has(p_value)) {
+			found.push_back(kv.key);
+		}
+	}
+	found.sort();
+	return found;
+}
+
+PackedStringArray BehaviorTreeIndex::find_task_usages(const String &p_task) const {
+	return _find(p_task, &Entry::tasks);
+}
+
+PackedStringArray BehaviorTreeIndex::find_subtree_usages(const String &p_path) const {
+	return _find(p_path, &Entry::subtrees);
+}
+
+PackedStringArray BehaviorTreeIndex::find_variable_usages(const StringName &p_var) const {
+	return _find(p_var, &Entry::variables);
+}
+
+void BehaviorTreeIndex::_notification(int p_what) {
+	switch (p_what) {
+		case NOTIFICATION_READY: {
+			EDITOR_FILE_SYSTEM()->connect(LW_NAME(filesystem_changed), callable_mp(this, &BehaviorTreeIndex::_request_scan));
+			_request_scan();
+		} break;
+		case NOTIFICATION_PROCESS: {
+			_process_pending();
+		} break;
+		case NOTIFICATION_EXIT_TREE: {
+			if (dirty) {
+				_save();
+			}
+		} break;
+	}
+}
+
+void BehaviorTreeIndex::_bind_methods() {
+	ADD_SIGNAL(MethodInfo("index_updated"));
+}
+
+BehaviorTreeIndex::BehaviorTreeIndex() {
+	set_process(false);
+}
+
+#endif // TOOLS_ENABLED
@@ -0,0 +1,93 @@
+/**
+ * behavior_tree_index.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifdef TOOLS_ENABLED
+
+#ifndef BEHAVIOR_TREE_INDEX_H
+#define BEHAVIOR_TREE_INDEX_H
+
+#include "../bt/tasks/bt_task.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/templates/hash_map.h"
+#include "core/templates/hash_set.h"
+#include "scene/main/node.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/node.hpp>
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/hash_set.hpp>
+using namespace godot;
+#endif // LIMBOAI_GDEXTENSION
+
+class EditorFileSystemDirectory;
+
+// Index of what each behavior tree file in the project references: tasks (by class name, or script path for
+// scripted tasks), subtrees (by path), and blackboard variables. Lets editor tools find usages without loading
+// every tree. Kept in the project settings dir and updated incrementally: only trees whose files changed since
+// they were indexed are loaded again, a few per frame, so the editor never blocks on a full rebuild.
+class BehaviorTreeIndex : public Node {
+	GDCLASS(BehaviorTreeIndex, Node);
+
+private:
+	static constexpr int INDEX_VERSION = 1;
+	static constexpr uint64_t MAX_USEC_PER_FRAME = 4000;
+
+	struct Entry {
+		uint64_t modified_time = 0;
+		PackedStringArray tasks;
+		PackedStringArray subtrees;
+		PackedStringArray variables;
+	};
+
+	HashMap<String, Entry> entries;
+	LocalVector<String> pending;
+	bool scan_requested = false;
+	bool dirty = false;
+	bool loaded = false;
+
+	String _get_index_path() const;
+	void _load();
+	void _save();
+
+	void _request_scan();
+	void _scan_dir(EditorFileSystemDirectory *p_dir, HashSet<String> &r_found);
+	void _scan();
+	void _index_file(const String &p_path);
+	void _collect(const Ref<BTTask> &p_task, HashSet<String> &r_tasks, HashSet<String> &r_subtrees, HashSet<String> &r_variables) const;
+	void _process_pending();
+
+	PackedStringArray _find(const String &p_value, PackedStringArray Entry::*p_field) const;
+
+protected:
+	static void _bind_methods();
+
+	void _notification(int p_what);
+
+public:
+	// Returns paths of the indexed trees that reference the task (class name or script path).
+	PackedStringArray find_task_usages(const String &p_task) const;
+	// Returns paths of the indexed trees that include the tree at p_path as a subtree.
+	PackedStringArray find_subtree_usages(const String &p_path) const;
+	// Returns paths of the indexed trees that define or reference the blackboard variable.
+	PackedStringArray find_variable_usages(const StringName &p_var) const;
+
+	// False while changed trees are still being indexed. Results may be stale until then.
+	bool is_up_to_date() const { return !scan_requested && pending.is_empty(); }
+	int get_indexed_count() const { return entries.size(); }
+
+	BehaviorTreeIndex();
+};
+
+#endif // BEHAVIOR_TREE_INDEX_H
+
+#endif // TOOLS_ENABLED
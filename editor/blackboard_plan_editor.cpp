@@ -41,8 +41,21 @@ using namespace godot;
 
 BlackboardPlanEditor *BlackboardPlanEditor::singleton = nullptr;
 
-LineEdit *BlackboardPlanEditor::_get_name_edit(int p_row_index) const {
-	return Object::cast_to<LineEdit>(rows_vbox->get_child(p_row_index)->get_child(0)->get_child(1));
+int BlackboardPlanEditor::_get_var_index(int p_display_index) const {
+	if (drag_index < 0 || drag_start < 0) {
+		return p_display_index;
+	}
+	// * While dragging, the dragged variable is shown at drag_index, and the ones in between shift by one.
+	if (p_display_index == drag_index) {
+		return drag_start;
+	}
+	if (drag_start < drag_index && p_display_index >= drag_start && p_display_index < drag_index) {
+		return p_display_index + 1;
+	}
+	if (drag_start > drag_index && p_display_index > drag_index && p_display_index <= drag_start) {
+		return p_display_index - 1;
+	}
+	return p_display_index;
 }
 
 void BlackboardPlanEditor::_add_var() {
@@ -64,25 +77,25 @@ void BlackboardPlanEditor::_add_var() {
 	_refresh();
 }
 
-void BlackboardPlanEditor::_trash_var(int p_index) {
+void BlackboardPlanEditor::_trash_var(int p_row) {
 	ERR_FAIL_NULL(plan);
-	StringName var_name = plan->get_var_by_index(p_index).first;
+	StringName var_name = plan->get_var_by_index(rows[p_row].var_index).first;
 	plan->remove_var(var_name);
 	_refresh();
 }
 
-void BlackboardPlanEditor::_rename_var(const StringName &p_new_name, int p_index) {
+void BlackboardPlanEditor::_rename_var(const StringName &p_new_name, int p_row) {
 	ERR_FAIL_NULL(plan);
 
-	LineEdit *name_edit = _get_name_edit(p_index);
-	ERR_FAIL_NULL(name_edit);
+	LineEdit *name_edit = rows[p_row].name_edit;
+	const int index = rows[p_row].var_index;
 
 	bool is_valid_var_name = plan->is_valid_var_name(p_new_name);
 	if (is_valid_var_name) {
-		plan->rename_var(plan->get_var_by_index(p_index).first, p_new_name);
+		plan->rename_var(plan->get_var_by_index(index).first, p_new_name);
 	}
 
-	if (is_valid_var_name || plan->get_var_by_index(p_index).first == p_new_name) {
+	if (is_valid_var_name || plan->get_var_by_index(index).first == p_new_name) {
 		if (name_edit->has_theme_color_override(LW_NAME(font_color))) {
 			name_edit->remove_theme_color_override(LW_NAME(font_color));
 			name_edit->queue_redraw();
@@ -121,9 +134,9 @@ void BlackboardPlanEditor::_change_var_hint(PropertyHint p_new_hint, int p_index
 	_refresh();
 }
 
-void BlackboardPlanEditor::_change_var_hint_string(const String &p_new_hint_string, int p_index) {
+void BlackboardPlanEditor::_change_var_hint_string(const String &p_new_hint_string, int p_row) {
 	ERR_FAIL_NULL(plan);
-	plan->get_var_by_index(p_index).second.set_hint_string(p_new_hint_string);
+	plan->get_var_by_index(rows[p_row].var_index).second.set_hint_string(p_new_hint_string);
 	plan->notify_property_list_changed();
 }
 
@@ -147,9 +160,10 @@ void BlackboardPlanEditor::reset_defaults() {
 	default_hint_string = "";
 }
 
-void BlackboardPlanEditor::_show_button_popup(Button *p_button, PopupMenu *p_popup, int p_index) {
+void BlackboardPlanEditor::_show_button_popup(Button *p_button, PopupMenu *p_popup, int p_row) {
 	ERR_FAIL_NULL(p_button);
 	ERR_FAIL_NULL(p_popup);
+	const int index = rows[p_row].var_index;
 
 	Transform2D xform = p_button->get_screen_transform();
 	Rect2 rect(xform.get_origin(), xform.get_scale() * p_button->get_size());
@@ -161,14 +175,14 @@ void BlackboardPlanEditor::_show_button_popup(Button *p_button, PopupMenu *p_pop
 	if (p_popup == hint_menu) {
 		hint_menu->clear();
 		hint_menu->reset_size();
-		Variant::Type t = plan->get_var_by_index(p_index).second.get_type();
+		Variant::Type t = plan->get_var_by_index(index).second.get_type();
 		PackedInt32Array hints = LimboUtility::get_singleton()->get_property_hints_allowed_for_type(t);
 		for (int i = 0; i < hints.size(); i++) {
 			hint_menu->add_item(LimboUtility::get_singleton()->get_property_hint_text(PropertyHint(hints[i])), hints[i]);
 		}
 	}
 
-	last_index = p_index;
+	last_index = index;
 	p_popup->popup();
 }
 
@@ -182,9 +196,9 @@ void BlackboardPlanEditor::_hint_chosen(int id) {
 
 void BlackboardPlanEditor::_add_var_pressed() {
 	_add_var();
-	LineEdit *name_edit = _get_name_edit(rows_vbox->get_child_count() - 1);
-	name_edit->grab_focus();
-	name_edit->select_all();
+	// * The row of the new variable may not exist until the list is scrolled to the end - it's focused once bound.
+	pending_focus_index = plan->get_var_count() - 1;
+	_update_rows();
 
 	// Note: Scroll to the end, delay is necessary here.
 	scroll_container->call_deferred(LW_NAME(call_deferred), LW_NAME(set_v_scroll), 888888888);
@@ -195,8 +209,13 @@ void BlackboardPlanEditor::_prefetching_toggled(bool p_toggle_on) {
 	plan->set_prefetch_nodepath_vars(p_toggle_on);
 }
 
-void BlackboardPlanEditor::_drag_button_down(Control *p_row) {
-	drag_index = p_row->get_index();
+void BlackboardPlanEditor::_shared_containers_toggled(bool p_toggle_on) {
+	ERR_FAIL_COND(plan.is_null());
+	plan->set_share_container_defaults(p_toggle_on);
+}
+
+void BlackboardPlanEditor::_drag_button_down(int p_row) {
+	drag_index = rows[p_row].display_index;
 	drag_start = drag_index;
 	drag_mouse_y_delta = 0.0;
 	Input::get_singleton()->set_mouse_mode(Input::MOUSE_MODE_CAPTURED);
@@ -231,16 +250,16 @@ void BlackboardPlanEditor::_drag_button_gui_input(const Ref<InputEvent> &p_event
 	if (ABS(drag_mouse_y_delta) > required_distance) {
 		int drag_dir = drag_mouse_y_delta > 0.0f ? 1 : -1;
 		drag_mouse_y_delta -= required_distance * drag_dir;
-
-		Control *row = Object::cast_to<Control>(rows_vbox->get_child(drag_index));
-		Control *other_row = Object::cast_to<Control>(rows_vbox->get_child(drag_index + drag_dir));
-		ERR_FAIL_NULL(row);
-		ERR_FAIL_NULL(other_row);
-		rows_vbox->move_child(row, drag_index + drag_dir);
-		ADD_STYLEBOX_OVERRIDE(row, LW_NAME(panel), row->get_index() % 2 ? theme_cache.odd_style : theme_cache.even_style);
-		ADD_STYLEBOX_OVERRIDE(other_row, LW_NAME(panel), other_row->get_index() % 2 ? theme_cache.odd_style : theme_cache.even_style);
-
 		drag_index += drag_dir;
+
+		// * Keeps the dragged variable in view.
+		const int drag_y = drag_index * row_height;
+		if (drag_y < scroll_container->get_v_scroll()) {
+			scroll_container->set_v_scroll(drag_y);
+		} else if (drag_y + row_height > scroll_container->get_v_scroll() + scroll_container->get_size().y) {
+			scroll_container->set_v_scroll(drag_y + row_height - scroll_container->get_size().y);
+		}
+		_update_rows();
 	}
 }
 
@@ -251,86 +270,157 @@ void BlackboardPlanEditor::_visibility_changed() {
 	}
 }
 
-void BlackboardPlanEditor::_refresh() {
-	for (int i = 0; i < rows_vbox->get_child_count(); i++) {
-		Control *child = Object::cast_to<Control>(rows_vbox->get_child(i));
-		ERR_FAIL_NULL(child);
-		child->hide();
-		child->queue_free();
+void BlackboardPlanEditor::_create_row() {
+	const int row_index = rows.size();
+	Row row;
+
+	row.panel = memnew(PanelContainer);
+	rows_area->add_child(row.panel);
+
+	HBoxContainer *props_hbox = memnew(HBoxContainer);
+	row.panel->add_child(props_hbox);
+	props_hbox->set_h_size_flags(Control::SIZE_EXPAND_FILL);
+
+	Button *drag_button = memnew(Button);
+	props_hbox->add_child(drag_button);
+	drag_button->set_custom_minimum_size(Size2(28.0, 28.0) * EDSCALE);
+	BUTTON_SET_ICON(drag_button, theme_cache.grab_icon);
+	drag_button->connect(LW_NAME(gui_input), callable_mp(this, &BlackboardPlanEditor::_drag_button_gui_input));
+	drag_button->connect(LW_NAME(button_down), callable_mp(this, &BlackboardPlanEditor::_drag_button_down).bind(row_index));
+	drag_button->connect(LW_NAME(button_up), callable_mp(this, &BlackboardPlanEditor::_drag_button_up));
+
+	row.name_edit = memnew(LineEdit);
+	props_hbox->add_child(row.name_edit);
+	row.name_edit->set_placeholder(TTR("Variable name"));
+	row.name_edit->set_flat(true);
+	row.name_edit->set_custom_minimum_size(Size2(300.0, 0.0) * EDSCALE);
+	row.name_edit->connect(LW_NAME(text_changed), callable_mp(this, &BlackboardPlanEditor::_rename_var).bind(row_index));
+	row.name_edit->connect(LW_NAME(text_submitted), callable_mp(this, &BlackboardPlanEditor::_refresh).unbind(1));
+
+	row.type_choice = memnew(Button);
+	props_hbox->add_child(row.type_choice);
+	row.type_choice->set_custom_minimum_size(Size2(170, 0.0) * EDSCALE);
+	row.type_choice->set_text_overrun_behavior(TextServer::OVERRUN_TRIM_ELLIPSIS);
+	row.type_choice->set_flat(true);
+	row.type_choice->set_text_alignment(HORIZONTAL_ALIGNMENT_LEFT);
+	row.type_choice->connect(LW_NAME(pressed), callable_mp(this, &BlackboardPlanEditor::_show_button_popup).bind(row.type_choice, type_menu, row_index));
+
+	row.hint_choice = memnew(Button);
+	props_hbox->add_child(row.hint_choice);
+	row.hint_choice->set_custom_minimum_size(Size2(150.0, 0.0) * EDSCALE);
+	row.hint_choice->set_text_overrun_behavior(TextServer::OVERRUN_TRIM_ELLIPSIS);
+	row.hint_choice->set_flat(true);
+	row.hint_choice->set_text_alignment(HORIZONTAL_ALIGNMENT_LEFT);
+	row.hint_choice->connect(LW_NAME(pressed), callable_mp(this, &BlackboardPlanEditor::_show_button_popup).bind(row.hint_choice, hint_menu, row_index));
+
+	row.hint_string_edit = memnew(LineEdit);
+	props_hbox->add_child(row.hint_string_edit);
+	row.hint_string_edit->set_custom_minimum_size(Size2(300.0, 0.0) * EDSCALE);
+	row.hint_string_edit->set_placeholder(TTR("Hint string"));
+	row.hint_string_edit->set_h_size_flags(Control::SIZE_EXPAND_FILL);
+	row.hint_string_edit->set_flat(true);
+	row.hint_string_edit->connect(LW_NAME(text_changed), callable_mp(this, &BlackboardPlanEditor::_change_var_hint_string).bind(row_index));
+	row.hint_string_edit->connect(LW_NAME(text_submitted), callable_mp(this, &BlackboardPlanEditor::_refresh).unbind(1));
+
+	Button *trash_button = memnew(Button);
+	props_hbox->add_child(trash_button);
+	trash_button->set_custom_minimum_size(Size2(24.0, 0.0) * EDSCALE);
+	BUTTON_SET_ICON(trash_button, theme_cache.trash_icon);
+	trash_button->connect(LW_NAME(pressed), callable_mp(this, &BlackboardPlanEditor::_trash_var).bind(row_index));
+
+	rows.push_back(row);
+	if (row_height <= 0.0) {
+		row_height = MAX(row.panel->get_combined_minimum_size().y, 28.0 * EDSCALE);
 	}
+}
 
-	nodepath_prefetching->set_pressed(plan->is_prefetching_nodepath_vars());
+void BlackboardPlanEditor::_update_row(Row &p_row, int p_display_index, int p_var_index) {
+	const Pair<StringName, BBVariable> &entry = plan->get_var_by_index(p_var_index);
+	const BBVariable &var = entry.second;
+	p_row.display_index = p_display_index;
+	p_row.panel->set_position(Vector2(0.0, p_display_index * row_height));
+	p_row.panel->set_size(Vector2(rows_area->get_size().x, row_height));
+	ADD_STYLEBOX_OVERRIDE(p_row.panel, LW_NAME(panel), p_display_index % 2 ? theme_cache.odd_style : theme_cache.even_style);
+	p_row.panel->show();
+
+	// * Only rows bound to another variable, or edited outside of them, need new texts - the rest keep their state,
+	// such as the caret of a focused field.
+	const bool rebound = p_row.var_index != p_var_index;
+	p_row.var_index = p_var_index;
+	if (rebound || !p_row.name_edit->has_focus()) {
+		if (p_row.name_edit->get_text() != String(entry.first)) {
+			p_row.name_edit->set_text(entry.first);
+		}
+		if (p_row.name_edit->has_theme_color_override(LW_NAME(font_color))) {
+			p_row.name_edit->remove_theme_color_override(LW_NAME(font_color));
+		}
+	}
+	const String type_name = Variant::get_type_name(var.get_type());
+	if (p_row.type_choice->get_text() != type_name) {
+		p_row.type_choice->set_text(type_name);
+		p_row.type_choice->set_tooltip_text(type_name);
+		BUTTON_SET_ICON(p_row.type_choice, get_theme_icon(type_name, LW_NAME(EditorIcons)));
+	}
+	const String hint_text = LimboUtility::get_singleton()->get_property_hint_text(var.get_hint());
+	if (p_row.hint_choice->get_text() != hint_text) {
+		p_row.hint_choice->set_text(hint_text);
+		p_row.hint_choice->set_tooltip_text(hint_text);
+	}
+	if ((rebound || !p_row.hint_string_edit->has_focus()) && p_row.hint_string_edit->get_text() != var.get_hint_string()) {
+		p_row.hint_string_edit->set_text(var.get_hint_string());
+	}
+}
+
+// Binds the pooled rows to the variables in view. Rows are only created when the view grows,
+// so the cost of an update depends on the height of the view, not on the size of the plan.
+void BlackboardPlanEditor::_update_rows() {
+	if (plan.is_null()) {
+		return;
+	}
+	if (rows.is_empty()) {
+		_create_row();
+	}
+	const int count = plan->get_var_count();
+	rows_area->set_custom_minimum_size(Size2(0.0, count * row_height));
+
+	const int first = MAX(0, int(scroll_container->get_v_scroll() / row_height));
+	const int visible = int(Math::ceil(scroll_container->get_size().y / row_height)) + 1;
+	while ((int)rows.size() < MIN(visible, count)) {
+		_create_row();
+	}
 
-	TypedArray<StringName> names = plan->list_vars();
-	for (int i = 0; i < names.size(); i++) {
-		const String &var_name = names[i];
-		BBVariable var = plan->get_var(var_name);
-
-		PanelContainer *row_panel = memnew(PanelContainer);
-		rows_vbox->add_child(row_panel);
-		ADD_STYLEBOX_OVERRIDE(row_panel, LW_NAME(panel), i % 2 ? theme_cache.odd_style : theme_cache.even_style);
-		row_panel->set_h_size_flags(Control::SIZE_EXPAND_FILL);
-
-		HBoxContainer *props_hbox = memnew(HBoxContainer);
-		row_panel->add_child(props_hbox);
-		props_hbox->set_h_size_flags(Control::SIZE_EXPAND_FILL);
-
-		Button *drag_button = memnew(Button);
-		props_hbox->add_child(drag_button);
-		drag_button->set_custom_minimum_size(Size2(28.0, 28.0) * EDSCALE);
-		BUTTON_SET_ICON(drag_button, theme_cache.grab_icon);
-		drag_button->connect(LW_NAME(gui_input), callable_mp(this, &BlackboardPlanEditor::_drag_button_gui_input));
-		drag_button->connect(LW_NAME(button_down), callable_mp(this, &BlackboardPlanEditor::_drag_button_down).bind(row_panel));
-		drag_button->connect(LW_NAME(button_up), callable_mp(this, &BlackboardPlanEditor::_drag_button_up));
-
-		LineEdit *name_edit = memnew(LineEdit);
-		props_hbox->add_child(name_edit);
-		name_edit->set_text(var_name);
-		name_edit->set_placeholder(TTR("Variable name"));
-		name_edit->set_flat(true);
-		name_edit->set_custom_minimum_size(Size2(300.0, 0.0) * EDSCALE);
-		name_edit->connect(LW_NAME(text_changed), callable_mp(this, &BlackboardPlanEditor::_rename_var).bind(i));
-		name_edit->connect(LW_NAME(text_submitted), callable_mp(this, &BlackboardPlanEditor::_refresh).unbind(1));
-
-		Button *type_choice = memnew(Button);
-		props_hbox->add_child(type_choice);
-		type_choice->set_custom_minimum_size(Size2(170, 0.0) * EDSCALE);
-		type_choice->set_text(Variant::get_type_name(var.get_type()));
-		type_choice->set_tooltip_text(Variant::get_type_name(var.get_type()));
-		BUTTON_SET_ICON(type_choice, get_theme_icon(Variant::get_type_name(var.get_type()), LW_NAME(EditorIcons)));
-		type_choice->set_text_overrun_behavior(TextServer::OVERRUN_TRIM_ELLIPSIS);
-		type_choice->set_flat(true);
-		type_choice->set_text_alignment(HORIZONTAL_ALIGNMENT_LEFT);
-		type_choice->connect(LW_NAME(pressed), callable_mp(this, &BlackboardPlanEditor::_show_button_popup).bind(type_choice, type_menu, i));
-
-		Button *hint_choice = memnew(Button);
-		props_hbox->add_child(hint_choice);
-		hint_choice->set_custom_minimum_size(Size2(150.0, 0.0) * EDSCALE);
-		hint_choice->set_text(LimboUtility::get_singleton()->get_property_hint_text(var.get_hint()));
-		hint_choice->set_tooltip_text(LimboUtility::get_singleton()->get_property_hint_text(var.get_hint()));
-		hint_choice->set_text_overrun_behavior(TextServer::OVERRUN_TRIM_ELLIPSIS);
-		hint_choice->set_flat(true);
-		hint_choice->set_text_alignment(HORIZONTAL_ALIGNMENT_LEFT);
-		hint_choice->connect(LW_NAME(pressed), callable_mp(this, &BlackboardPlanEditor::_show_button_popup).bind(hint_choice, hint_menu, i));
-
-		LineEdit *hint_string_edit = memnew(LineEdit);
-		props_hbox->add_child(hint_string_edit);
-		hint_string_edit->set_custom_minimum_size(Size2(300.0, 0.0) * EDSCALE);
-		hint_string_edit->set_text(var.get_hint_string());
-		hint_string_edit->set_placeholder(TTR("Hint string"));
-		hint_string_edit->set_h_size_flags(Control::SIZE_EXPAND_FILL);
-		hint_string_edit->set_flat(true);
-		hint_string_edit->connect(LW_NAME(text_changed), callable_mp(this, &BlackboardPlanEditor::_change_var_hint_string).bind(i));
-		hint_string_edit->connect(LW_NAME(text_submitted), callable_mp(this, &BlackboardPlanEditor::_refresh).unbind(1));
-
-		Button *trash_button = memnew(Button);
-		props_hbox->add_child(trash_button);
-		trash_button->set_custom_minimum_size(Size2(24.0, 0.0) * EDSCALE);
-		BUTTON_SET_ICON(trash_button, theme_cache.trash_icon);
-		trash_button->connect(LW_NAME(pressed), callable_mp(this, &BlackboardPlanEditor::_trash_var).bind(i));
+	for (uint32_t i = 0; i < rows.size(); i++) {
+		Row &row = rows[i];
+		const int display_index = first + i;
+		if (display_index >= count) {
+			row.panel->hide();
+			row.var_index = -1;
+			row.display_index = -1;
+			continue;
+		}
+		_update_row(row, display_index, _get_var_index(display_index));
+		if (row.var_index == pending_focus_index) {
+			pending_focus_index = -1;
+			row.name_edit->grab_focus();
+			row.name_edit->select_all();
+		}
 	}
 }
 
+void BlackboardPlanEditor::_clear_rows() {
+	for (const Row &row : rows) {
+		row.panel->queue_free();
+	}
+	rows.clear();
+	row_height = 0.0;
+}
+
+void BlackboardPlanEditor::_refresh() {
+	nodepath_prefetching->set_pressed(plan->is_prefetching_nodepath_vars());
+	shared_containers->set_pressed(plan->is_sharing_container_defaults());
+	_update_rows();
+}
+
 void BlackboardPlanEditor::_notification(int p_what) {
 	switch (p_what) {
 		case NOTIFICATION_THEME_CHANGED: {
@@ -356,6 +446,10 @@ void BlackboardPlanEditor::_notification(int p_what) {
 			theme_cache.header_style->set_bg_color(bg_color.darkened(-0.2));
 
 			ADD_STYLEBOX_OVERRIDE(header_row, LW_NAME(panel), theme_cache.header_style);
+
+			// * Rows are recreated with the new icons and height.
+			_clear_rows();
+			_update_rows();
 		} break;
 		case NOTIFICATION_ENTER_TREE: {
 			add_var_tool->connect(LW_NAME(pressed), callable_mp(this, &BlackboardPlanEditor::_add_var_pressed));
@@ -363,6 +457,10 @@ void BlackboardPlanEditor::_notification(int p_what) {
 			type_menu->connect(LW_NAME(id_pressed), callable_mp(this, &BlackboardPlanEditor::_type_chosen));
 			hint_menu->connect(LW_NAME(id_pressed), callable_mp(this, &BlackboardPlanEditor::_hint_chosen));
 			nodepath_prefetching->connect(LW_NAME(toggled), callable_mp(this, &BlackboardPlanEditor::_prefetching_toggled));
+			shared_containers->connect(LW_NAME(toggled), callable_mp(this, &BlackboardPlanEditor::_shared_containers_toggled));
+			scroll_container->get_v_scroll_bar()->connect(LW_NAME(value_changed), callable_mp(this, &BlackboardPlanEditor::_update_rows).unbind(1));
+			scroll_container->connect(LW_NAME(resized), callable_mp(this, &BlackboardPlanEditor::_update_rows));
+			rows_area->connect(LW_NAME(resized), callable_mp(this, &BlackboardPlanEditor::_update_rows));
 
 			for (int i = 0; i < PropertyHint::PROPERTY_HINT_MAX; i++) {
 				hint_menu->add_item(LimboUtility::get_singleton()->get_property_hint_text(PropertyHint(i)), i);
@@ -402,6 +500,12 @@ BlackboardPlanEditor::BlackboardPlanEditor() {
 	nodepath_prefetching->set_h_size_flags(Control::SIZE_EXPAND | Control::SIZE_SHRINK_END);
 	nodepath_prefetching->set_focus_mode(Control::FOCUS_NONE);
 
+	shared_containers = memnew(CheckBox);
+	toolbar->add_child(shared_containers);
+	shared_containers->set_text(TTR("Shared Containers"));
+	shared_containers->set_tooltip_text(TTR("If checked, Array and Dictionary defaults will be read-only and shared by all blackboards, instead of being copied for each one.\nAssigning a new value to such a variable is allowed, but modifying the container in place is not."));
+	shared_containers->set_focus_mode(Control::FOCUS_NONE);
+
 	{
 		// * Header
 		header_row = memnew(PanelContainer);
@@ -453,10 +557,11 @@ BlackboardPlanEditor::BlackboardPlanEditor() {
 	scroll_container->set_horizontal_scroll_mode(ScrollContainer::SCROLL_MODE_DISABLED);
 	scroll_container->set_custom_minimum_size(Size2(0.0, 600.0) * EDSCALE);
 
-	rows_vbox = memnew(VBoxContainer);
-	scroll_container->add_child(rows_vbox);
-	rows_vbox->set_h_size_flags(Control::SIZE_EXPAND_FILL);
-	rows_vbox->add_theme_constant_override(LW_NAME(separation), 0);
+	// * Rows are placed by hand: only the visible ones exist, see _update_rows().
+	rows_area = memnew(Control);
+	scroll_container->add_child(rows_area);
+	rows_area->set_h_size_flags(Control::SIZE_EXPAND_FILL);
+	rows_area->set_clip_contents(true);
 
 	type_menu = memnew(PopupMenu);
 	add_child(type_menu);
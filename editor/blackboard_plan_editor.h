@@ -17,6 +17,7 @@
 #include "../blackboard/blackboard_plan.h"
 
 #ifdef LIMBOAI_MODULE
+#include "core/templates/local_vector.h"
 #include "editor/editor_inspector.h"
 #include "scene/gui/check_box.h"
 #include "scene/gui/dialogs.h"
@@ -32,6 +33,7 @@
 #include <godot_cpp/classes/scroll_container.hpp>
 #include <godot_cpp/classes/style_box_flat.hpp>
 #include <godot_cpp/classes/v_box_container.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
 using namespace godot;
 #endif // LIMBOAI_GDEXTENSION
 
@@ -64,30 +66,50 @@ private:
 	String default_hint_string;
 	Variant default_value;
 
-	VBoxContainer *rows_vbox;
+	// Only the variables in view have rows: the rows are pooled, and rebound to other variables while scrolling.
+	struct Row {
+		PanelContainer *panel = nullptr;
+		LineEdit *name_edit = nullptr;
+		Button *type_choice = nullptr;
+		Button *hint_choice = nullptr;
+		LineEdit *hint_string_edit = nullptr;
+		int display_index = -1;
+		int var_index = -1;
+	};
+	LocalVector<Row> rows;
+	float row_height = 0.0;
+	int pending_focus_index = -1;
+
+	Control *rows_area;
 	Button *add_var_tool;
 	CheckBox *nodepath_prefetching;
+	CheckBox *shared_containers;
 	PanelContainer *header_row;
 	ScrollContainer *scroll_container;
 	PopupMenu *type_menu;
 	PopupMenu *hint_menu;
 
-	LineEdit *_get_name_edit(int p_row_index) const;
+	int _get_var_index(int p_display_index) const;
+	void _create_row();
+	void _update_row(Row &p_row, int p_display_index, int p_var_index);
+	void _update_rows();
+	void _clear_rows();
 
 	void _add_var();
-	void _trash_var(int p_index);
-	void _rename_var(const StringName &p_new_name, int p_index);
+	void _trash_var(int p_row);
+	void _rename_var(const StringName &p_new_name, int p_row);
 	void _change_var_type(Variant::Type p_new_type, int p_index);
 	void _change_var_hint(PropertyHint p_new_hint, int p_index);
-	void _change_var_hint_string(const String &p_new_hint_string, int p_index);
+	void _change_var_hint_string(const String &p_new_hint_string, int p_row);
 
-	void _show_button_popup(Button *p_button, PopupMenu *p_popup, int p_index);
+	void _show_button_popup(Button *p_button, PopupMenu *p_popup, int p_row);
 	void _type_chosen(int id);
 	void _hint_chosen(int id);
 	void _add_var_pressed();
 	void _prefetching_toggled(bool p_toggle_on);
+	void _shared_containers_toggled(bool p_toggle_on);
 
-	void _drag_button_down(Control *p_row);
+	void _drag_button_down(int p_row);
 	void _drag_button_up();
 	void _drag_button_gui_input(const Ref<InputEvent> &p_event);
 
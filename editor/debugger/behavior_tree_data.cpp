@@ -12,16 +12,27 @@
 #include "behavior_tree_data.h"
 
 #ifdef LIMBOAI_MODULE
+#include "core/templates/hashfuncs.h"
 #include "core/templates/list.h"
 #endif
 
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/templates/hashfuncs.hpp>
+#endif
+
 //**** BehaviorTreeData
 
-Array BehaviorTreeData::serialize(const Ref<BTInstance> &p_instance) {
+static String _get_script_path(const BTTask *p_task) {
+	Ref<Resource> s = p_task->get_script();
+	return s.is_valid() ? s->get_path() : String();
+}
+
+Array BehaviorTreeData::serialize(const Ref<BTInstance> &p_instance, uint32_t p_structure_hash) {
 	Array arr;
 	arr.push_back(uint64_t(p_instance->get_instance_id()));
 	arr.push_back(p_instance->get_owner_node() ? p_instance->get_owner_node()->get_path() : NodePath());
 	arr.push_back(p_instance->get_source_bt_path());
+	arr.push_back(p_structure_hash);
 
 	// Flatten tree into list depth first
 	List<Ref<BTTask>> stack;
@@ -55,17 +66,19 @@ Array BehaviorTreeData::serialize(const Ref<BTInstance> &p_instance) {
 }
 
 Ref<BehaviorTreeData> BehaviorTreeData::deserialize(const Array &p_array) {
-	ERR_FAIL_COND_V(p_array.size() < 3, nullptr);
+	ERR_FAIL_COND_V(p_array.size() < 4, nullptr);
 	ERR_FAIL_COND_V(p_array[0].get_type() != Variant::INT, nullptr);
 	ERR_FAIL_COND_V(p_array[1].get_type() != Variant::NODE_PATH, nullptr);
 	ERR_FAIL_COND_V(p_array[2].get_type() != Variant::STRING, nullptr);
+	ERR_FAIL_COND_V(p_array[3].get_type() != Variant::INT, nullptr);
 
 	Ref<BehaviorTreeData> data = memnew(BehaviorTreeData);
 	data->bt_instance_id = uint64_t(p_array[0]);
 	data->node_owner_path = p_array[1];
 	data->source_bt_path = p_array[2];
+	data->structure_hash = uint32_t(int64_t(p_array[3]));
 
-	int idx = 3;
+	int idx = 4;
 	while (p_array.size() > idx + 1) {
 		ERR_FAIL_COND_V(p_array.size() < idx + 7, nullptr);
 		ERR_FAIL_COND_V(p_array[idx].get_type() != Variant::INT, nullptr);
@@ -83,6 +96,134 @@ Ref<BehaviorTreeData> BehaviorTreeData::deserialize(const Array &p_array) {
 	return data;
 }
 
+uint32_t BehaviorTreeData::hash_structure(const LocalVector<BTTask *> &p_tasks) {
+	uint32_t h = hash_murmur3_one_32(p_tasks.size());
+	for (const BTTask *task : p_tasks) {
+		h = hash_murmur3_one_32(task->get_task_name().hash(), h);
+		h = hash_murmur3_one_32(task->get_custom_name().is_empty() ? 0 : 1, h);
+		h = hash_murmur3_one_32(task->get_child_count(), h);
+		h = hash_murmur3_one_32(String(task->get_class()).hash(), h);
+		h = hash_murmur3_one_32(_get_script_path(task).hash(), h);
+	}
+	return hash_fmix32(h);
+}
+
+Array BehaviorTreeData::serialize_cached(const Ref<BTInstance> &p_instance, const LocalVector<BTTask *> &p_tasks, uint32_t p_structure_hash) {
+	PackedInt64Array ids;
+	ids.resize(p_tasks.size());
+	PackedByteArray states;
+	for (uint32_t i = 0; i < p_tasks.size(); i++) {
+		ids.set(i, int64_t(p_tasks[i]->get_instance_id()));
+		append_delta(states, i, p_tasks[i]->get_status(), p_tasks[i]->get_elapsed_time());
+	}
+	Array arr;
+	arr.push_back(uint64_t(p_instance->get_instance_id()));
+	arr.push_back(p_instance->get_owner_node() ? p_instance->get_owner_node()->get_path() : NodePath());
+	arr.push_back(p_instance->get_source_bt_path());
+	arr.push_back(p_structure_hash);
+	arr.push_back(ids);
+	arr.push_back(states);
+	return arr;
+}
+
+bool BehaviorTreeData::get_cached_key(const Array &p_array, String &r_source_bt_path, uint32_t &r_structure_hash) {
+	ERR_FAIL_COND_V(p_array.size() != 6, false);
+	ERR_FAIL_COND_V(p_array[2].get_type() != Variant::STRING, false);
+	ERR_FAIL_COND_V(p_array[3].get_type() != Variant::INT, false);
+	r_source_bt_path = p_array[2];
+	r_structure_hash = uint32_t(int64_t(p_array[3]));
+	return true;
+}
+
+Ref<BehaviorTreeData> BehaviorTreeData::deserialize_cached(const Array &p_array, const Ref<BehaviorTreeData> &p_structure) {
+	ERR_FAIL_COND_V(p_structure.is_null(), nullptr);
+	ERR_FAIL_COND_V(p_array.size() != 6, nullptr);
+	ERR_FAIL_COND_V(p_array[0].get_type() != Variant::INT, nullptr);
+	ERR_FAIL_COND_V(p_array[1].get_type() != Variant::NODE_PATH, nullptr);
+	ERR_FAIL_COND_V(p_array[4].get_type() != Variant::PACKED_INT64_ARRAY, nullptr);
+	ERR_FAIL_COND_V(p_array[5].get_type() != Variant::PACKED_BYTE_ARRAY, nullptr);
+	const PackedInt64Array ids = p_array[4];
+	ERR_FAIL_COND_V_MSG(ids.size() != p_structure->tasks.size(), nullptr, "BehaviorTreeData: Cached structure doesn't match.");
+
+	Ref<BehaviorTreeData> data = memnew(BehaviorTreeData);
+	data->bt_instance_id = uint64_t(p_array[0]);
+	data->node_owner_path = p_array[1];
+	data->source_bt_path = p_structure->source_bt_path;
+	data->structure_hash = p_structure->structure_hash;
+	int i = 0;
+	for (const TaskData &td : p_structure->tasks) {
+		TaskData copy = td;
+		copy.id = uint64_t(ids[i++]);
+		data->tasks.push_back(copy);
+	}
+	ERR_FAIL_COND_V(!data->apply_delta(p_array[5]), nullptr);
+	return data;
+}
+
+void BehaviorTreeData::flatten_tasks(const Ref<BTInstance> &p_instance, LocalVector<BTTask *> &r_tasks) {
+	r_tasks.clear();
+	LocalVector<BTTask *> stack;
+	stack.push_back(p_instance->get_root_task().ptr());
+	while (!stack.is_empty()) {
+		BTTask *task = stack[stack.size() - 1];
+		stack.remove_at(stack.size() - 1);
+		r_tasks.push_back(task);
+		for (int i = task->get_child_count() - 1; i >= 0; i--) {
+			stack.push_back(task->get_child(i).ptr());
+		}
+	}
+}
+
+void BehaviorTreeData::append_delta(PackedByteArray &r_delta, uint32_t p_task_index, int p_status, double p_elapsed_time) {
+	union {
+		float f;
+		uint32_t u;
+	} elapsed;
+	elapsed.f = p_elapsed_time;
+
+	int64_t ofs = r_delta.size();
+	r_delta.resize(ofs + DELTA_RECORD_SIZE);
+	uint8_t *w = r_delta.ptrw() + ofs;
+	for (int i = 0; i < 4; i++) {
+		w[i] = (p_task_index >> (i * 8)) & 0xFF;
+	}
+	w[4] = uint8_t(p_status);
+	for (int i = 0; i < 4; i++) {
+		w[5 + i] = (elapsed.u >> (i * 8)) & 0xFF;
+	}
+}
+
+bool BehaviorTreeData::apply_delta(const PackedByteArray &p_delta) {
+	ERR_FAIL_COND_V(p_delta.size() % DELTA_RECORD_SIZE != 0, false);
+	const uint8_t *r = p_delta.ptr();
+	// Records are sorted by task index, so a single pass over the list is enough.
+	List<TaskData>::Element *E = tasks.front();
+	uint32_t idx = 0;
+	for (int64_t ofs = 0; ofs < p_delta.size(); ofs += DELTA_RECORD_SIZE) {
+		uint32_t task_index = 0;
+		uint32_t elapsed_bits = 0;
+		for (int i = 0; i < 4; i++) {
+			task_index |= uint32_t(r[ofs + i]) << (i * 8);
+			elapsed_bits |= uint32_t(r[ofs + 5 + i]) << (i * 8);
+		}
+		union {
+			float f;
+			uint32_t u;
+		} elapsed;
+		elapsed.u = elapsed_bits;
+
+		ERR_FAIL_COND_V(task_index < idx, false);
+		while (E && idx < task_index) {
+			E = E->next();
+			idx++;
+		}
+		ERR_FAIL_NULL_V_MSG(E, false, "BehaviorTreeData: Delta doesn't match the tree structure.");
+		E->get().status = r[ofs + 4];
+		E->get().elapsed_time = elapsed.f;
+	}
+	return true;
+}
+
 Ref<BehaviorTreeData> BehaviorTreeData::create_from_bt_instance(const Ref<BTInstance> &p_bt_instance) {
 	Ref<BehaviorTreeData> data = memnew(BehaviorTreeData);
 
@@ -121,6 +262,24 @@ Ref<BehaviorTreeData> BehaviorTreeData::create_from_bt_instance(const Ref<BTInst
 	return data;
 }
 
+Ref<BehaviorTreeData> BehaviorTreeData::create_from_trace(const Ref<BTTrace> &p_trace, int p_record_count) {
+	ERR_FAIL_COND_V(p_trace.is_null(), nullptr);
+	Ref<BehaviorTreeData> data = memnew(BehaviorTreeData);
+	PackedInt32Array statuses = p_trace->get_statuses_at(p_record_count);
+	for (int i = 0; i < p_trace->get_task_count(); i++) {
+		data->tasks.push_back(TaskData(
+				i + 1,
+				p_trace->get_task_name(i),
+				false,
+				p_trace->get_task_child_count(i),
+				statuses[i],
+				0.0,
+				p_trace->get_task_type(i),
+				String()));
+	}
+	return data;
+}
+
 void BehaviorTreeData::_bind_methods() {
 	ClassDB::bind_static_method("BehaviorTreeData", D_METHOD("create_from_bt_instance", "bt_instance"), &BehaviorTreeData::create_from_bt_instance);
 }
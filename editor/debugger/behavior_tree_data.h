@@ -13,6 +13,7 @@
 #define BEHAVIOR_TREE_DATA_H
 
 #include "../../bt/bt_instance.h"
+#include "../../bt/bt_trace.h"
 #include "../../bt/tasks/bt_task.h"
 
 class BehaviorTreeData : public RefCounted {
@@ -50,11 +51,36 @@ public:
 	uint64_t bt_instance_id = 0;
 	NodePath node_owner_path;
 	String source_bt_path;
+	// Hash of everything but the ids and task states, see hash_structure().
+	uint32_t structure_hash = 0;
+
+	// Size of a delta record: task index (u32), status (u8) and elapsed time (f32), little-endian.
+	static constexpr int DELTA_RECORD_SIZE = 9;
 
 public:
-	static Array serialize(const Ref<BTInstance> &p_instance);
+	static Array serialize(const Ref<BTInstance> &p_instance, uint32_t p_structure_hash);
 	static Ref<BehaviorTreeData> deserialize(const Array &p_array);
+
+	// Hashes the names, classes, scripts and layout of p_tasks, which instances of the same tree have in common.
+	static uint32_t hash_structure(const LocalVector<BTTask *> &p_tasks);
+	// Serializes an instance whose structure the editor has already received with another instance:
+	// task ids and states are sent instead of the whole structure.
+	static Array serialize_cached(const Ref<BTInstance> &p_instance, const LocalVector<BTTask *> &p_tasks, uint32_t p_structure_hash);
+	// Returns the source path and structure hash in the data produced by serialize_cached().
+	static bool get_cached_key(const Array &p_array, String &r_source_bt_path, uint32_t &r_structure_hash);
+	// Copies p_structure with the ids and states from the data produced by serialize_cached().
+	static Ref<BehaviorTreeData> deserialize_cached(const Array &p_array, const Ref<BehaviorTreeData> &p_structure);
+	// Key of the structure in the editor cache.
+	_FORCE_INLINE_ static String get_structure_key(const String &p_source_bt_path, uint32_t p_structure_hash) { return p_source_bt_path + "#" + itos(p_structure_hash); }
+
+	// Collects the tasks of the instance in the same depth-first order as serialize().
+	static void flatten_tasks(const Ref<BTInstance> &p_instance, LocalVector<BTTask *> &r_tasks);
+	static void append_delta(PackedByteArray &r_delta, uint32_t p_task_index, int p_status, double p_elapsed_time);
+	// Applies the records made with append_delta() to the tasks of serialized structure.
+	bool apply_delta(const PackedByteArray &p_delta);
 	static Ref<BehaviorTreeData> create_from_bt_instance(const Ref<BTInstance> &p_bt_instance);
+	// Reconstructs the task states after p_record_count records of the trace. Task ids are task indices plus one.
+	static Ref<BehaviorTreeData> create_from_trace(const Ref<BTTrace> &p_trace, int p_record_count);
 
 	BehaviorTreeData();
 };
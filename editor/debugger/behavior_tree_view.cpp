@@ -38,10 +38,6 @@ inline static uint64_t item_get_task_id(TreeItem *p_item) {
 	return p_item->get_metadata(0);
 }
 
-inline static BTTask::Status item_get_task_status(TreeItem *p_item) {
-	return VariantCaster<BTTask::Status>::cast(p_item->get_metadata(1));
-}
-
 inline static String item_get_task_type(TreeItem *p_item) {
 	return ((String)p_item->get_metadata(2)).get_slicec('|', 0);
 }
@@ -66,17 +62,22 @@ void BehaviorTreeView::_draw_failure_status(Object *p_obj, Rect2 p_rect) {
 }
 
 void BehaviorTreeView::_item_collapsed(Object *p_obj) {
+	if (updating_tree) {
+		return;
+	}
 	TreeItem *item = Object::cast_to<TreeItem>(p_obj);
 	if (!item) {
 		return;
 	}
 	uint64_t id = item_get_task_id(item);
 	bool collapsed = item->is_collapsed();
-	if (!collapsed_ids.has(id) && collapsed) {
-		collapsed_ids.push_back(item_get_task_id(item));
-	} else if (collapsed_ids.has(id) && !collapsed) {
+	if (collapsed) {
+		collapsed_ids.insert(id);
+	} else {
 		collapsed_ids.erase(id);
 	}
+	// * Deferred: the tree is still handling the input event that collapsed the item.
+	callable_mp(this, &BehaviorTreeView::_sync_collapsed_item).call_deferred(id);
 }
 
 void BehaviorTreeView::_item_selected() {
@@ -104,128 +105,211 @@ void BehaviorTreeView::update_tree(const Ref<BehaviorTreeData> &p_data) {
 	_notification(NOTIFICATION_PROCESS);
 }
 
-void BehaviorTreeView::_update_tree(const Ref<BehaviorTreeData> &p_data) {
-	// Remember selected.
-	uint64_t selected_id = 0;
-	if (tree->get_selected()) {
-		selected_id = item_get_task_id(tree->get_selected());
+void BehaviorTreeView::_item_set_status(TreeItem *p_item, int p_status) {
+	p_item->set_metadata(1, p_status);
+	if (p_status == BTTask::SUCCESS) {
+		p_item->set_custom_draw_callback(0, callable_mp(this, &BehaviorTreeView::_draw_success_status));
+		p_item->set_icon(1, theme_cache.icon_success);
+	} else if (p_status == BTTask::FAILURE) {
+		p_item->set_custom_draw_callback(0, callable_mp(this, &BehaviorTreeView::_draw_failure_status));
+		p_item->set_icon(1, theme_cache.icon_failure);
+	} else if (p_status == BTTask::RUNNING) {
+		p_item->set_custom_draw_callback(0, callable_mp(this, &BehaviorTreeView::_draw_running_status));
+		p_item->set_icon(1, theme_cache.icon_running);
+	} else {
+		p_item->set_custom_draw_callback(0, callable_mp(this, &BehaviorTreeView::_draw_fresh));
+		p_item->set_icon(1, nullptr);
 	}
+}
 
-	if (last_root_id != 0 && p_data->tasks.size() > 0 && last_root_id == (uint64_t)p_data->tasks.front()->get().id) {
-		// * Update tree.
-		// ! Update routine is built on assumption that the behavior tree does NOT mutate. With little work it could detect mutations.
+void BehaviorTreeView::_add_placeholder(TreeItem *p_parent) {
+	TreeItem *placeholder = tree->create_item(p_parent);
+	placeholder->set_metadata(0, (uint64_t)0);
+	for (int c = 0; c < tree->get_columns(); c++) {
+		placeholder->set_selectable(c, false);
+	}
+}
 
-		TreeItem *item = tree->get_root();
-		int idx = 0;
-		while (item) {
-			ERR_FAIL_COND(idx >= p_data->tasks.size());
+// Returns the index past the subtree of the task at p_index, or -1 if the data is malformed.
+int BehaviorTreeView::_index_subtree(int p_index) {
+	int next = p_index + 1;
+	for (int i = 0; i < view_tasks[p_index].num_children; i++) {
+		if (next >= (int)view_tasks.size()) {
+			return -1;
+		}
+		next = _index_subtree(next);
+		if (next < 0) {
+			return -1;
+		}
+	}
+	view_tasks[p_index].subtree_end = next;
+	return next;
+}
 
-			const BTTask::Status current_status = (BTTask::Status)p_data->tasks.get(idx).status;
-			const BTTask::Status last_status = item_get_task_status(item);
-			const bool status_changed = last_status != p_data->tasks.get(idx).status;
+TreeItem *BehaviorTreeView::_materialize(int p_index, TreeItem *p_parent, uint64_t p_selected_id) {
+	ViewTask &vt = view_tasks[p_index];
+	TreeItem *item = tree->create_item(p_parent);
+	vt.item = item;
 
-			if (status_changed) {
-				item->set_metadata(1, current_status);
-				if (current_status == BTTask::SUCCESS) {
-					item->set_custom_draw_callback(0, callable_mp(this, &BehaviorTreeView::_draw_success_status));
-					item->set_icon(1, theme_cache.icon_success);
-				} else if (current_status == BTTask::FAILURE) {
-					item->set_custom_draw_callback(0, callable_mp(this, &BehaviorTreeView::_draw_failure_status));
-					item->set_icon(1, theme_cache.icon_failure);
-				} else if (current_status == BTTask::RUNNING) {
-					item->set_custom_draw_callback(0, callable_mp(this, &BehaviorTreeView::_draw_running_status));
-					item->set_icon(1, theme_cache.icon_running);
-				} else {
-					item->set_custom_draw_callback(0, callable_mp(this, &BehaviorTreeView::_draw_fresh));
-					item->set_icon(1, nullptr);
-				}
-			}
+	// Do this first because it resets properties of the cell...
+	item->set_cell_mode(0, TreeItem::CELL_MODE_CUSTOM);
+	item->set_cell_mode(1, TreeItem::CELL_MODE_ICON);
 
-			if (status_changed || current_status == BTTask::RUNNING) {
-				_item_set_elapsed_time(item, p_data->tasks.get(idx).elapsed_time);
-			}
+	item->set_metadata(0, vt.id);
+	item->set_metadata(2, vt.type_name + String("|") + vt.script_path);
 
-			if (item->get_first_child()) {
-				item = item->get_first_child();
-			} else if (item->get_next()) {
-				item = item->get_next();
-			} else {
-				while (item) {
-					item = item->get_parent();
-					if (item && item->get_next()) {
-						item = item->get_next();
-						break;
-					}
-				}
-			}
+	item->set_text(0, vt.name);
+	if (vt.is_custom_name) {
+		item->set_custom_font(0, theme_cache.font_custom_name);
+	}
 
-			idx += 1;
+	item->set_text_alignment(2, HORIZONTAL_ALIGNMENT_RIGHT);
+	_item_set_elapsed_time(item, vt.elapsed_time);
+
+	String cors = (vt.script_path.is_empty()) ? vt.type_name : vt.script_path;
+	item->set_icon(0, LimboUtility::get_singleton()->get_task_icon(cors));
+	item->set_icon_max_width(0, 16 * _get_editor_scale()); // Force user icon size.
+
+	_item_set_status(item, vt.status);
+
+	if (vt.id == p_selected_id) {
+		tree->set_selected(item, 0);
+	}
+
+	if (vt.num_children > 0) {
+		if (collapsed_ids.has(vt.id)) {
+			item->set_collapsed(true);
+			// * Collapsed branches are not materialized. An empty item keeps the fold arrow visible.
+			_add_placeholder(item);
+		} else {
+			_materialize_children(p_index, p_selected_id);
 		}
-		ERR_FAIL_COND(idx != p_data->tasks.size());
-	} else {
-		// * Create new tree.
+	}
+	return item;
+}
 
-		last_root_id = p_data->tasks.size() > 0 ? p_data->tasks.front()->get().id : 0;
+void BehaviorTreeView::_materialize_children(int p_index, uint64_t p_selected_id) {
+	TreeItem *item = view_tasks[p_index].item;
+	int child_idx = p_index + 1;
+	while (child_idx < view_tasks[p_index].subtree_end) {
+		_materialize(child_idx, item, p_selected_id);
+		child_idx = view_tasks[child_idx].subtree_end;
+	}
+}
 
-		tree->clear();
-		TreeItem *parent = nullptr;
-		List<Pair<TreeItem *, int>> parents;
-		for (const BehaviorTreeData::TaskData &task_data : p_data->tasks) {
-			// Figure out parent.
-			parent = nullptr;
-			if (parents.size()) {
-				Pair<TreeItem *, int> &p = parents.front()->get();
-				parent = p.first;
-				if (!(--p.second)) {
-					// No children left, remove it.
-					parents.pop_front();
-				}
-			}
+void BehaviorTreeView::_dematerialize_children(int p_index) {
+	TreeItem *item = view_tasks[p_index].item;
+	for (int i = p_index + 1; i < view_tasks[p_index].subtree_end; i++) {
+		view_tasks[i].item = nullptr;
+	}
+	while (item->get_first_child()) {
+		memdelete(item->get_first_child());
+	}
+}
 
-			TreeItem *item = tree->create_item(parent);
-			// Do this first because it resets properties of the cell...
-			item->set_cell_mode(0, TreeItem::CELL_MODE_CUSTOM);
-			item->set_cell_mode(1, TreeItem::CELL_MODE_ICON);
+void BehaviorTreeView::_sync_collapsed_item(uint64_t p_task_id) {
+	const int *idx = task_index_map.getptr(p_task_id);
+	if (idx == nullptr || view_tasks[*idx].item == nullptr || view_tasks[*idx].num_children == 0) {
+		return;
+	}
+	const int index = *idx;
+	TreeItem *item = view_tasks[index].item;
+	TreeItem *first_child = item->get_first_child();
+	const bool materialized = first_child && item_get_task_id(first_child) != 0;
 
-			item->set_metadata(0, task_data.id);
-			item->set_metadata(1, task_data.status);
-			item->set_metadata(2, task_data.type_name + String("|") + task_data.script_path);
+	uint64_t selected_id = 0;
+	if (tree->get_selected()) {
+		selected_id = item_get_task_id(tree->get_selected());
+	}
 
-			item->set_text(0, task_data.name);
-			if (task_data.is_custom_name) {
-				item->set_custom_font(0, theme_cache.font_custom_name);
-			}
+	updating_tree = true;
+	if (item->is_collapsed() && materialized) {
+		_dematerialize_children(index);
+		_add_placeholder(item);
+	} else if (!item->is_collapsed() && !materialized) {
+		_dematerialize_children(index); // Removes the placeholder.
+		_materialize_children(index, selected_id);
+	}
+	updating_tree = false;
+}
 
-			item->set_text_alignment(2, HORIZONTAL_ALIGNMENT_RIGHT);
-			_item_set_elapsed_time(item, task_data.elapsed_time);
-
-			String cors = (task_data.script_path.is_empty()) ? task_data.type_name : task_data.script_path;
-			item->set_icon(0, LimboUtility::get_singleton()->get_task_icon(cors));
-			item->set_icon_max_width(0, 16 * _get_editor_scale()); // Force user icon size.
-
-			if (task_data.status == BTTask::SUCCESS) {
-				item->set_custom_draw_callback(0, callable_mp(this, &BehaviorTreeView::_draw_success_status));
-				item->set_icon(1, theme_cache.icon_success);
-			} else if (task_data.status == BTTask::FAILURE) {
-				item->set_custom_draw_callback(0, callable_mp(this, &BehaviorTreeView::_draw_failure_status));
-				item->set_icon(1, theme_cache.icon_failure);
-			} else if (task_data.status == BTTask::RUNNING) {
-				item->set_custom_draw_callback(0, callable_mp(this, &BehaviorTreeView::_draw_running_status));
-				item->set_icon(1, theme_cache.icon_running);
-			}
+void BehaviorTreeView::_rebuild_tree(const Ref<BehaviorTreeData> &p_data) {
+	// Remember selected.
+	uint64_t selected_id = 0;
+	if (tree->get_selected()) {
+		selected_id = item_get_task_id(tree->get_selected());
+	}
 
-			if (task_data.id == selected_id) {
-				tree->set_selected(item, 0);
-			}
+	tree->clear();
+	task_index_map.clear();
+	view_tasks.resize(p_data->tasks.size());
+	int idx = 0;
+	for (const BehaviorTreeData::TaskData &task_data : p_data->tasks) {
+		ViewTask &vt = view_tasks[idx];
+		vt.id = task_data.id;
+		vt.name = task_data.name;
+		vt.is_custom_name = task_data.is_custom_name;
+		vt.num_children = task_data.num_children;
+		vt.status = task_data.status;
+		vt.elapsed_time = task_data.elapsed_time;
+		vt.type_name = task_data.type_name;
+		vt.script_path = task_data.script_path;
+		vt.item = nullptr;
+		task_index_map.insert(vt.id, idx);
+		idx += 1;
+	}
+
+	if (view_tasks.is_empty()) {
+		return;
+	}
+	if (_index_subtree(0) != (int)view_tasks.size()) {
+		view_tasks.clear();
+		task_index_map.clear();
+		ERR_FAIL_MSG("BehaviorTreeView: Malformed tree data.");
+	}
 
-			if (collapsed_ids.has(task_data.id)) {
-				item->set_collapsed(true);
+	updating_tree = true;
+	_materialize(0, nullptr, selected_id);
+	updating_tree = false;
+}
+
+void BehaviorTreeView::_update_tree(const Ref<BehaviorTreeData> &p_data) {
+	// * Same task ids in the same order: only statuses and timings could have changed.
+	// Lazy subtrees or a different instance change the structure, and the tree is then rebuilt.
+	bool same_structure = p_data->tasks.size() == (int)view_tasks.size();
+	if (same_structure) {
+		int idx = 0;
+		for (const BehaviorTreeData::TaskData &task_data : p_data->tasks) {
+			if (task_data.id != view_tasks[idx].id) {
+				same_structure = false;
+				break;
 			}
+			idx += 1;
+		}
+	}
+	if (!same_structure) {
+		_rebuild_tree(p_data);
+		return;
+	}
 
-			// Add in front of parents stack if children are expected.
-			if (task_data.num_children) {
-				parents.push_front(Pair<TreeItem *, int>(item, task_data.num_children));
+	int idx = 0;
+	for (const BehaviorTreeData::TaskData &task_data : p_data->tasks) {
+		ViewTask &vt = view_tasks[idx];
+		idx += 1;
+
+		const bool status_changed = vt.status != task_data.status;
+		if (!status_changed && (task_data.status != BTTask::RUNNING || vt.elapsed_time == task_data.elapsed_time)) {
+			continue;
+		}
+		vt.status = task_data.status;
+		vt.elapsed_time = task_data.elapsed_time;
+
+		// * Tasks inside collapsed branches have no items; their state is applied when materialized.
+		if (vt.item) {
+			if (status_changed) {
+				_item_set_status(vt.item, vt.status);
 			}
+			_item_set_elapsed_time(vt.item, vt.elapsed_time);
 		}
 	}
 }
@@ -233,7 +317,8 @@ void BehaviorTreeView::_update_tree(const Ref<BehaviorTreeData> &p_data) {
 void BehaviorTreeView::clear() {
 	tree->clear();
 	collapsed_ids.clear();
-	last_root_id = 0;
+	view_tasks.clear();
+	task_index_map.clear();
 }
 
 void BehaviorTreeView::_do_update_theme_item_cache() {
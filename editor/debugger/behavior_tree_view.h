@@ -17,6 +17,9 @@
 #include "behavior_tree_data.h"
 
 #ifdef LIMBOAI_MODULE
+#include "core/templates/hash_map.h"
+#include "core/templates/hash_set.h"
+#include "core/templates/local_vector.h"
 #include "scene/gui/control.h"
 #include "scene/gui/tree.h"
 #include "scene/resources/style_box_flat.h"
@@ -28,6 +31,9 @@
 #include <godot_cpp/classes/font.hpp>
 #include <godot_cpp/classes/style_box_flat.hpp>
 #include <godot_cpp/classes/tree.hpp>
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/hash_set.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
 #endif // LIMBOAI_GDEXTENSION
 
 class BehaviorTreeView : public Control {
@@ -48,8 +54,25 @@ private:
 		Ref<Font> font_custom_name;
 	} theme_cache;
 
-	Vector<uint64_t> collapsed_ids;
-	uint64_t last_root_id = 0;
+	// Mirrors the displayed BehaviorTreeData in depth-first order.
+	struct ViewTask {
+		uint64_t id = 0;
+		String name;
+		bool is_custom_name = false;
+		int num_children = 0;
+		int status = 0;
+		double elapsed_time = 0.0;
+		String type_name;
+		String script_path;
+		int subtree_end = 0; // Index past the last descendant.
+		TreeItem *item = nullptr; // Null if the task is inside a collapsed branch.
+	};
+
+	LocalVector<ViewTask> view_tasks;
+	HashMap<uint64_t, int> task_index_map;
+	bool updating_tree = false;
+
+	HashSet<uint64_t> collapsed_ids;
 
 	int last_update_msec = 0;
 	int update_interval_msec = 0;
@@ -64,6 +87,14 @@ private:
 	void _item_selected();
 	double _get_editor_scale() const;
 
+	void _item_set_status(TreeItem *p_item, int p_status);
+	void _add_placeholder(TreeItem *p_parent);
+	int _index_subtree(int p_index);
+	TreeItem *_materialize(int p_index, TreeItem *p_parent, uint64_t p_selected_id);
+	void _materialize_children(int p_index, uint64_t p_selected_id);
+	void _dematerialize_children(int p_index);
+	void _sync_collapsed_item(uint64_t p_task_id);
+	void _rebuild_tree(const Ref<BehaviorTreeData> &p_data);
 	void _update_tree(const Ref<BehaviorTreeData> &p_data);
 
 protected:
@@ -17,8 +17,10 @@
 #include "behavior_tree_data.h"
 
 #ifdef LIMBOAI_MODULE
+#include "core/config/project_settings.h"
 #include "core/debugger/engine_debugger.h"
 #include "core/io/resource.h"
+#include "core/os/time.h"
 #include "core/string/node_path.h"
 #include "scene/main/scene_tree.h"
 #include "scene/main/window.h"
@@ -26,13 +28,22 @@
 
 #ifdef LIMBOAI_GDEXTENSION
 #include <godot_cpp/classes/engine_debugger.hpp>
+#include <godot_cpp/classes/project_settings.hpp>
 #include <godot_cpp/classes/scene_tree.hpp>
+#include <godot_cpp/classes/time.hpp>
 #include <godot_cpp/classes/window.hpp>
 #endif // LIMBOAI_GDEXTENSION
 
+// Top offenders are reported to the editor at most this often.
+#define PERFORMANCE_REPORT_INTERVAL_USEC 250000
+// Interval of the overview of all instances, grouped by tree.
+#define OVERVIEW_INTERVAL_USEC 1000000
+
 //**** LimboDebugger
 
 LimboDebugger *LimboDebugger::singleton = nullptr;
+double LimboDebugger::max_update_rate = 20.0;
+double LimboDebugger::sample_rate = 20.0;
 
 LimboDebugger::LimboDebugger() {
 	singleton = this;
@@ -48,6 +59,8 @@ LimboDebugger::~LimboDebugger() {
 }
 
 void LimboDebugger::initialize() {
+	max_update_rate = GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "limbo_ai/debugger/max_update_rate", PROPERTY_HINT_RANGE, "0,240,1,or_greater,suffix:Hz"), 20.0);
+	sample_rate = GLOBAL_DEF(PropertyInfo(Variant::FLOAT, "limbo_ai/debugger/sample_rate", PROPERTY_HINT_RANGE, "1,240,1,or_greater,suffix:Hz"), 20.0);
 	if (IS_DEBUGGER_ACTIVE()) {
 		memnew(LimboDebugger);
 	}
@@ -68,12 +81,22 @@ Error LimboDebugger::parse_message(void *p_user, const String &p_msg, const Arra
 	if (p_msg == "track_bt_player") {
 		singleton->_track_tree(p_args[0]);
 	} else if (p_msg == "untrack_bt_player") {
-		singleton->_untrack_tree();
+		// * Without arguments, untracks all instances.
+		if (p_args.is_empty()) {
+			singleton->_untrack_all_trees();
+		} else {
+			singleton->_untrack_tree(p_args[0]);
+		}
 	} else if (p_msg == "start_session") {
-		singleton->session_active = true;
+		singleton->_set_session_active(true);
 		singleton->_send_active_bt_players();
 	} else if (p_msg == "stop_session") {
-		singleton->session_active = false;
+		singleton->_set_session_active(false);
+	} else if (p_msg == "sample_running_paths") {
+		singleton->_set_sampling(p_args[0]);
+	} else if (p_msg == "request_structure") {
+		// * The editor doesn't have the structure of a cached update.
+		singleton->_resend_structure(p_args[0]);
 	} else {
 		r_captured = false;
 	}
@@ -108,7 +131,7 @@ void LimboDebugger::register_bt_instance(uint64_t p_instance_id) {
 
 	active_bt_instances.insert(p_instance_id);
 	if (session_active) {
-		_send_active_bt_players();
+		added_bt_instances.push_back(p_instance_id);
 	}
 }
 
@@ -117,13 +140,17 @@ void LimboDebugger::unregister_bt_instance(uint64_t p_instance_id) {
 		return;
 	}
 
-	if (tracked_instance_id == p_instance_id) {
-		_untrack_tree();
-	}
+	_untrack_tree(p_instance_id);
 	active_bt_instances.erase(p_instance_id);
 
 	if (session_active) {
-		_send_active_bt_players();
+		int64_t idx = added_bt_instances.find(p_instance_id);
+		if (idx != -1) {
+			// * The editor hasn't been notified yet.
+			added_bt_instances.remove_at_unordered(idx);
+		} else {
+			removed_bt_instances.push_back(p_instance_id);
+		}
 	}
 }
 
@@ -134,51 +161,482 @@ bool LimboDebugger::is_active() const {
 void LimboDebugger::_track_tree(uint64_t p_instance_id) {
 	ERR_FAIL_COND(p_instance_id == 0);
 	ERR_FAIL_COND(!active_bt_instances.has(p_instance_id));
-
-	_untrack_tree();
-
-	tracked_instance_id = p_instance_id;
+	if (tracked_trees.has(p_instance_id)) {
+		return;
+	}
 
 	BTInstance *inst = Object::cast_to<BTInstance>(OBJECT_DB_GET_INSTANCE(p_instance_id));
 	ERR_FAIL_NULL(inst);
+	tracked_trees.insert(p_instance_id, TrackedTree());
 	inst->connect(LW_NAME(updated), callable_mp(this, &LimboDebugger::_on_bt_instance_updated).bind(p_instance_id));
 }
 
-void LimboDebugger::_untrack_tree() {
-	if (tracked_instance_id == 0) {
+void LimboDebugger::_untrack_tree(uint64_t p_instance_id) {
+	if (!tracked_trees.has(p_instance_id)) {
 		return;
 	}
 
-	BTInstance *inst = Object::cast_to<BTInstance>(OBJECT_DB_GET_INSTANCE(tracked_instance_id));
+	BTInstance *inst = Object::cast_to<BTInstance>(OBJECT_DB_GET_INSTANCE(p_instance_id));
 	if (inst) {
 		inst->disconnect(LW_NAME(updated), callable_mp(this, &LimboDebugger::_on_bt_instance_updated));
 	}
-	tracked_instance_id = 0;
+	tracked_trees.erase(p_instance_id);
+}
+
+void LimboDebugger::_untrack_all_trees() {
+	LocalVector<uint64_t> ids;
+	for (const KeyValue<uint64_t, TrackedTree> &kv : tracked_trees) {
+		ids.push_back(kv.key);
+	}
+	for (uint64_t id : ids) {
+		_untrack_tree(id);
+	}
 }
 
 void LimboDebugger::_send_active_bt_players() {
+	added_bt_instances.clear();
+	removed_bt_instances.clear();
+
 	Array arr;
 	for (uint64_t instance_id : active_bt_instances) {
-		arr.append(instance_id);
 		BTInstance *inst = Object::cast_to<BTInstance>(OBJECT_DB_GET_INSTANCE(instance_id));
 		if (inst == nullptr) {
 			ERR_PRINT("LimboDebugger::_send_active_bt_players: Registered BTInstance not found (no longer exists?).");
 			continue;
 		}
 		Node *owner_node = inst->get_owner_node();
+		arr.append(instance_id);
 		arr.append(owner_node ? owner_node->get_path() : NodePath());
 	}
 	EngineDebugger::get_singleton()->send_message("limboai:active_bt_players", arr);
 }
 
+void LimboDebugger::_send_bt_player_changes() {
+	// * Owner paths are resolved now, as the instances are usually registered before their owners enter the tree.
+	Array added;
+	for (uint64_t instance_id : added_bt_instances) {
+		BTInstance *inst = Object::cast_to<BTInstance>(OBJECT_DB_GET_INSTANCE(instance_id));
+		ERR_CONTINUE(inst == nullptr);
+		Node *owner_node = inst->get_owner_node();
+		added.append(instance_id);
+		added.append(owner_node ? owner_node->get_path() : NodePath());
+	}
+	Array removed;
+	for (uint64_t instance_id : removed_bt_instances) {
+		removed.append(instance_id);
+	}
+	added_bt_instances.clear();
+	removed_bt_instances.clear();
+
+	Array arr;
+	arr.push_back(added);
+	arr.push_back(removed);
+	EngineDebugger::get_singleton()->send_message("limboai:active_bt_players_changed", arr);
+}
+
+void LimboDebugger::_set_session_active(bool p_active) {
+	if (session_active == p_active) {
+		return;
+	}
+	session_active = p_active;
+	sent_structures.clear();
+	_set_sampling(false);
+	if (!p_active) {
+		_untrack_all_trees();
+		added_bt_instances.clear();
+		removed_bt_instances.clear();
+	}
+	BTStats::set_spike_capture(p_active);
+	report_spikes.clear();
+	for (int b = 0; b < BTStats::HISTOGRAM_BUCKETS; b++) {
+		report_histogram[b] = 0;
+	}
+
+	SceneTree *tree = SCENE_TREE();
+	ERR_FAIL_NULL(tree);
+	if (p_active) {
+		tree->connect(LW_NAME(process_frame), callable_mp(this, &LimboDebugger::_on_process_frame));
+	} else if (tree->is_connected(LW_NAME(process_frame), callable_mp(this, &LimboDebugger::_on_process_frame))) {
+		tree->disconnect(LW_NAME(process_frame), callable_mp(this, &LimboDebugger::_on_process_frame));
+	}
+}
+
+void LimboDebugger::_on_process_frame() {
+	if (!added_bt_instances.is_empty() || !removed_bt_instances.is_empty()) {
+		_send_bt_player_changes();
+	}
+	for (KeyValue<uint64_t, TrackedTree> &kv : tracked_trees) {
+		if (kv.value.has_pending) {
+			_flush_pending_updates(kv.key, kv.value);
+		}
+		_send_blackboard_changes(kv.key, kv.value);
+	}
+
+	// * Reads the frame last merged by BTStats.
+	for (int b = 0; b < BTStats::HISTOGRAM_BUCKETS; b++) {
+		report_histogram[b] += BTStats::get_frame_histogram_bucket(b);
+	}
+	for (const BTStats::Spike &spike : BTStats::get_frame_spikes()) {
+		if (report_spikes.size() < BTStats::MAX_SPIKES) {
+			report_spikes.push_back(spike);
+			continue;
+		}
+		uint32_t fastest = 0;
+		for (uint32_t i = 1; i < report_spikes.size(); i++) {
+			if (report_spikes[i].usec < report_spikes[fastest].usec) {
+				fastest = i;
+			}
+		}
+		if (report_spikes[fastest].usec < spike.usec) {
+			report_spikes[fastest] = spike;
+		}
+	}
+
+	uint64_t now = Time::get_singleton()->get_ticks_usec();
+	if (sampling && now - last_sample_usec >= uint64_t(1000000.0 / MAX(sample_rate, 1.0))) {
+		last_sample_usec = now;
+		_sample_running_paths();
+	}
+	if (now - last_report_usec >= PERFORMANCE_REPORT_INTERVAL_USEC) {
+		last_report_usec = now;
+		_send_performance_report();
+	}
+	if (now - last_overview_usec >= OVERVIEW_INTERVAL_USEC) {
+		const double interval_sec = last_overview_usec > 0 ? double(now - last_overview_usec) * 0.000001 : 1.0;
+		last_overview_usec = now;
+		_send_overview(interval_sec);
+		_send_task_costs();
+		if (sampling) {
+			_send_running_samples();
+		}
+	}
+}
+
+void LimboDebugger::_set_sampling(bool p_enabled) {
+	sampling = p_enabled;
+	num_samples = 0;
+	last_sample_usec = 0;
+	running_samples.clear();
+}
+
+// Reads the running path of every active instance. Frames are sampled at a fixed rate, so the cost doesn't depend on
+// how many times the trees are updated, and a path found in many samples is where agents spend their time.
+void LimboDebugger::_sample_running_paths() {
+	num_samples += 1;
+	for (uint64_t instance_id : active_bt_instances) {
+		BTInstance *inst = Object::cast_to<BTInstance>(OBJECT_DB_GET_INSTANCE(instance_id));
+		if (inst == nullptr || !inst->is_instance_valid()) {
+			continue;
+		}
+		const String path = inst->_get_running_path();
+		if (path.is_empty()) {
+			continue;
+		}
+		HashMap<String, uint32_t> *paths = running_samples.getptr(inst->source_bt_path);
+		if (paths == nullptr) {
+			paths = &running_samples.insert(inst->source_bt_path, HashMap<String, uint32_t>())->value;
+		}
+		uint32_t *count = paths->getptr(path);
+		if (count) {
+			*count += 1;
+		} else {
+			paths->insert(path, 1);
+		}
+	}
+}
+
+void LimboDebugger::_send_running_samples() {
+	// * Sent as: number of samples, then for each tree: path, running paths, sample counts. The editor accumulates them.
+	Array arr;
+	arr.push_back(num_samples);
+	for (const KeyValue<String, HashMap<String, uint32_t>> &kv : running_samples) {
+		PackedStringArray paths;
+		PackedInt32Array counts;
+		for (const KeyValue<String, uint32_t> &path : kv.value) {
+			paths.push_back(path.key);
+			counts.push_back(path.value);
+		}
+		arr.push_back(kv.key);
+		arr.push_back(paths);
+		arr.push_back(counts);
+	}
+	num_samples = 0;
+	running_samples.clear();
+	EngineDebugger::get_singleton()->send_message("limboai:running_samples", arr);
+}
+
+void LimboDebugger::_send_performance_report() {
+	PackedInt64Array histogram;
+	histogram.resize(BTStats::HISTOGRAM_BUCKETS);
+	for (int b = 0; b < BTStats::HISTOGRAM_BUCKETS; b++) {
+		histogram.set(b, report_histogram[b]);
+		report_histogram[b] = 0;
+	}
+
+	report_spikes.sort_custom<BTStats::SpikeComparator>();
+	Array spikes;
+	for (const BTStats::Spike &spike : report_spikes) {
+		spikes.push_back(spike.instance_id);
+		spikes.push_back(spike.usec);
+		spikes.push_back(spike.tree_path);
+		spikes.push_back(spike.task_path);
+	}
+	report_spikes.clear();
+
+	Array arr;
+	arr.push_back(histogram);
+	arr.push_back(spikes);
+	EngineDebugger::get_singleton()->send_message("limboai:performance_report", arr);
+}
+
+// Aggregates the counters of all instances by tree: instance count, mean update time, root status changes per second,
+// and how many instances are in which running leaf. The counters are reset, so each overview covers one interval.
+void LimboDebugger::_send_overview(double p_interval_sec) {
+	struct TreeOverview {
+		int instances = 0;
+		uint64_t updates = 0;
+		uint64_t usec = 0;
+		uint64_t status_changes = 0;
+		HashMap<String, int> running_leaves;
+	};
+	HashMap<String, TreeOverview> trees;
+	for (uint64_t instance_id : active_bt_instances) {
+		BTInstance *inst = Object::cast_to<BTInstance>(OBJECT_DB_GET_INSTANCE(instance_id));
+		if (inst == nullptr || !inst->is_instance_valid()) {
+			continue;
+		}
+		TreeOverview *overview = trees.getptr(inst->source_bt_path);
+		if (overview == nullptr) {
+			overview = &trees.insert(inst->source_bt_path, TreeOverview())->value;
+		}
+		overview->instances += 1;
+		overview->updates += inst->overview_updates;
+		overview->usec += inst->overview_usec;
+		overview->status_changes += inst->overview_status_changes;
+		inst->overview_updates = 0;
+		inst->overview_usec = 0;
+		inst->overview_status_changes = 0;
+
+		BTTask *leaf = inst->_find_running_task(inst->root_task.ptr());
+		if (leaf) {
+			const String leaf_name = leaf->get_task_name();
+			int *count = overview->running_leaves.getptr(leaf_name);
+			if (count) {
+				*count += 1;
+			} else {
+				overview->running_leaves.insert(leaf_name, 1);
+			}
+		}
+	}
+
+	// * Each tree is sent as: path, instances, mean update usec, status changes per second, running leaves (name/count pairs).
+	Array arr;
+	for (const KeyValue<String, TreeOverview> &kv : trees) {
+		const TreeOverview &overview = kv.value;
+		Array leaves;
+		for (const KeyValue<String, int> &leaf : overview.running_leaves) {
+			leaves.push_back(leaf.key);
+			leaves.push_back(leaf.value);
+		}
+		arr.push_back(kv.key);
+		arr.push_back(overview.instances);
+		arr.push_back(overview.updates > 0 ? double(overview.usec) / double(overview.updates) : 0.0);
+		arr.push_back(double(overview.status_changes) / p_interval_sec);
+		arr.push_back(leaves);
+	}
+	EngineDebugger::get_singleton()->send_message("limboai:overview", arr);
+}
+
+// Sends the profiles of the profiled trees, which all instances of a tree record into, so the editor can show
+// the cost of each task while the tree is edited. The counters are not reset - they add up since profiling started.
+void LimboDebugger::_send_task_costs() {
+	// * Each tree is sent as: path, task names, task depths, tick counts, self times in usec - in depth-first order.
+	HashSet<String> sent;
+	Array arr;
+	for (uint64_t instance_id : active_bt_instances) {
+		BTInstance *inst = Object::cast_to<BTInstance>(OBJECT_DB_GET_INSTANCE(instance_id));
+		if (inst == nullptr || inst->profile.is_null() || inst->source_bt_path.is_empty() || sent.has(inst->source_bt_path)) {
+			continue;
+		}
+		sent.insert(inst->source_bt_path);
+		const BTProfile *profile = inst->profile.ptr();
+		const int count = profile->get_task_count();
+		PackedStringArray names;
+		PackedInt32Array depths;
+		PackedInt64Array ticks;
+		PackedInt64Array self_usec;
+		names.resize(count);
+		depths.resize(count);
+		ticks.resize(count);
+		self_usec.resize(count);
+		for (int i = 0; i < count; i++) {
+			names.set(i, profile->get_task_name(i));
+			depths.set(i, profile->get_task_depth(i));
+			ticks.set(i, profile->get_tick_count(i));
+			self_usec.set(i, profile->get_self_time_usec(i));
+		}
+		arr.push_back(inst->source_bt_path);
+		arr.push_back(names);
+		arr.push_back(depths);
+		arr.push_back(ticks);
+		arr.push_back(self_usec);
+	}
+	if (!arr.is_empty()) {
+		EngineDebugger::get_singleton()->send_message("limboai:task_costs", arr);
+	}
+}
+
+void LimboDebugger::_resend_structure(uint64_t p_instance_id) {
+	TrackedTree *tracked = tracked_trees.getptr(p_instance_id);
+	if (tracked == nullptr) {
+		return;
+	}
+	BTInstance *inst = Object::cast_to<BTInstance>(OBJECT_DB_GET_INSTANCE(p_instance_id));
+	ERR_FAIL_NULL(inst);
+	if (!tracked->tasks.is_empty()) {
+		sent_structures.erase(BehaviorTreeData::get_structure_key(inst->get_source_bt_path(), BehaviorTreeData::hash_structure(tracked->tasks)));
+	}
+	// * Full update is sent on the next call, as the structure no longer matches.
+	tracked->tasks.clear();
+	_on_bt_instance_updated(BT::FRESH, p_instance_id);
+}
+
 void LimboDebugger::_on_bt_instance_updated(int _status, uint64_t p_instance_id) {
-	if (p_instance_id != tracked_instance_id) {
+	TrackedTree *tracked = tracked_trees.getptr(p_instance_id);
+	if (tracked == nullptr) {
+		return;
+	}
+	BTInstance *inst = Object::cast_to<BTInstance>(OBJECT_DB_GET_INSTANCE(p_instance_id));
+	ERR_FAIL_NULL(inst);
+
+	BehaviorTreeData::flatten_tasks(inst, flattened_tasks);
+	bool same_structure = flattened_tasks.size() == tracked->tasks.size();
+	for (uint32_t i = 0; same_structure && i < flattened_tasks.size(); i++) {
+		same_structure = flattened_tasks[i] == tracked->tasks[i];
+	}
+
+	if (!same_structure) {
+		// * Names, classes and scripts are sent only when tracking starts or the tree changes, e.g. a lazy subtree is instantiated.
+		SWAP(tracked->tasks, flattened_tasks);
+		const uint32_t num_tasks = tracked->tasks.size();
+		tracked->sent_status.resize(num_tasks);
+		tracked->sent_elapsed.resize(num_tasks);
+		tracked->pending_status.resize(num_tasks);
+		tracked->pending_elapsed.resize(num_tasks);
+		tracked->pending_dirty.resize(num_tasks);
+		for (uint32_t i = 0; i < num_tasks; i++) {
+			tracked->sent_status[i] = tracked->tasks[i]->get_status();
+			tracked->sent_elapsed[i] = tracked->tasks[i]->get_elapsed_time();
+			tracked->pending_dirty[i] = false;
+		}
+		tracked->has_pending = false;
+		const uint32_t structure_hash = BehaviorTreeData::hash_structure(tracked->tasks);
+		const String key = BehaviorTreeData::get_structure_key(inst->get_source_bt_path(), structure_hash);
+		if (sent_structures.has(key)) {
+			// * The editor has this structure from another instance of the same tree.
+			Array arr = BehaviorTreeData::serialize_cached(inst, tracked->tasks, structure_hash);
+			EngineDebugger::get_singleton()->send_message("limboai:bt_update_cached", arr);
+		} else {
+			sent_structures.insert(key);
+			Array arr = BehaviorTreeData::serialize(inst, structure_hash);
+			EngineDebugger::get_singleton()->send_message("limboai:bt_update", arr);
+		}
+		return;
+	}
+
+	for (uint32_t i = 0; i < tracked->tasks.size(); i++) {
+		const int status = tracked->tasks[i]->get_status();
+		const double elapsed = tracked->tasks[i]->get_elapsed_time();
+		if (tracked->pending_dirty[i]) {
+			// * Coalesce: a task that finished since the last send is reported as finished, even if it's running again.
+			const bool finished = tracked->pending_status[i] == BT::SUCCESS || tracked->pending_status[i] == BT::FAILURE;
+			if (!finished || status == BT::SUCCESS || status == BT::FAILURE) {
+				tracked->pending_status[i] = status;
+			}
+			tracked->pending_elapsed[i] = elapsed;
+		} else if (status != tracked->sent_status[i] || elapsed != tracked->sent_elapsed[i]) {
+			tracked->pending_status[i] = status;
+			tracked->pending_elapsed[i] = elapsed;
+			tracked->pending_dirty[i] = true;
+			tracked->has_pending = true;
+		}
+	}
+	if (tracked->has_pending) {
+		_flush_pending_updates(p_instance_id, *tracked);
+	}
+}
+
+void LimboDebugger::_flush_pending_updates(uint64_t p_instance_id, TrackedTree &p_tracked) {
+	const uint64_t now = Time::get_singleton()->get_ticks_usec();
+	if (max_update_rate > 0.0 && double(now - p_tracked.last_send_usec) < 1000000.0 / max_update_rate) {
+		return;
+	}
+	p_tracked.last_send_usec = now;
+	p_tracked.has_pending = false;
+
+	PackedByteArray delta;
+	for (uint32_t i = 0; i < p_tracked.pending_dirty.size(); i++) {
+		if (p_tracked.pending_dirty[i]) {
+			p_tracked.pending_dirty[i] = false;
+			p_tracked.sent_status[i] = p_tracked.pending_status[i];
+			p_tracked.sent_elapsed[i] = p_tracked.pending_elapsed[i];
+			BehaviorTreeData::append_delta(delta, i, p_tracked.pending_status[i], p_tracked.pending_elapsed[i]);
+		}
+	}
+	if (!delta.is_empty()) {
+		Array arr;
+		arr.push_back(p_instance_id);
+		arr.push_back(delta);
+		EngineDebugger::get_singleton()->send_message("limboai:bt_delta", arr);
+	}
+}
+
+// Sends the variables that changed in the instance's blackboard scopes since the last send, rate limited like task updates.
+void LimboDebugger::_send_blackboard_changes(uint64_t p_instance_id, TrackedTree &p_tracked) {
+	const uint64_t now = Time::get_singleton()->get_ticks_usec();
+	if (max_update_rate > 0.0 && double(now - p_tracked.last_blackboard_send_usec) < 1000000.0 / max_update_rate) {
 		return;
 	}
+	p_tracked.last_blackboard_send_usec = now;
+
 	BTInstance *inst = Object::cast_to<BTInstance>(OBJECT_DB_GET_INSTANCE(p_instance_id));
 	ERR_FAIL_NULL(inst);
-	Array arr = BehaviorTreeData::serialize(inst);
-	EngineDebugger::get_singleton()->send_message("limboai:bt_update", arr);
+
+	// * Each changed scope is sent as: index, reset flag, changed name/value pairs, erased names.
+	Array changes;
+	uint32_t num_scopes = 0;
+	for (Ref<Blackboard> bb = inst->get_blackboard(); bb.is_valid(); bb = bb->get_parent()) {
+		if (num_scopes == p_tracked.scopes.size()) {
+			p_tracked.scopes.push_back(TrackedTree::WatchedScope());
+		}
+		TrackedTree::WatchedScope &scope = p_tracked.scopes[num_scopes];
+		const bool reset = scope.blackboard_id != uint64_t(bb->get_instance_id());
+		if (reset) {
+			scope.blackboard_id = bb->get_instance_id();
+			scope.names.clear();
+			scope.versions.clear();
+		}
+		Array changed;
+		Array erased;
+		bb->diff_vars(scope.names, scope.versions, changed, erased);
+		if (reset || !changed.is_empty() || !erased.is_empty()) {
+			changes.push_back(num_scopes);
+			changes.push_back(reset);
+			changes.push_back(changed);
+			changes.push_back(erased);
+		}
+		num_scopes += 1;
+	}
+	const bool scopes_removed = num_scopes < p_tracked.scopes.size();
+	p_tracked.scopes.resize(num_scopes);
+
+	if (!changes.is_empty() || scopes_removed) {
+		Array arr;
+		arr.push_back(p_instance_id);
+		arr.push_back(num_scopes);
+		arr.push_back(changes);
+		EngineDebugger::get_singleton()->send_message("limboai:bb_delta", arr);
+	}
 }
 
 #endif // ! DEBUG_ENABLED
@@ -13,17 +13,21 @@
 #define LIMBO_DEBUGGER_H
 
 #include "../../bt/bt_instance.h"
+#include "../../bt/bt_stats.h"
 #include "../../bt/tasks/bt_task.h"
 
 #ifdef LIMBOAI_MODULE
 #include "core/object/class_db.h"
 #include "core/object/object.h"
 #include "core/string/node_path.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/hash_set.h"
 #endif // LIMBOAI_MODULE
 
 #ifdef LIMBOAI_GDEXTENSION
 #include <godot_cpp/classes/object.hpp>
 #include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/templates/hash_map.hpp>
 #include <godot_cpp/templates/hash_set.hpp>
 #include <godot_cpp/variant/node_path.hpp>
 #endif // LIMBOAI_GDEXTENSION
@@ -33,6 +37,8 @@ class LimboDebugger : public Object {
 
 private:
 	static LimboDebugger *singleton;
+	static double max_update_rate;
+	static double sample_rate;
 
 	LimboDebugger();
 
@@ -48,13 +54,68 @@ protected:
 
 #ifdef DEBUG_ENABLED
 private:
+	// State of a tracked tree: structure as last sent to the editor, task states sent since, and changes pending.
+	// Pending changes are rate limited, see limbo_ai/debugger/max_update_rate.
+	struct TrackedTree {
+		LocalVector<BTTask *> tasks;
+		LocalVector<int> sent_status;
+		LocalVector<double> sent_elapsed;
+		LocalVector<int> pending_status;
+		LocalVector<double> pending_elapsed;
+		LocalVector<uint8_t> pending_dirty;
+		bool has_pending = false;
+		uint64_t last_send_usec = 0;
+
+		// Blackboard scopes of the instance, innermost first, with the variables as last sent to the editor.
+		struct WatchedScope {
+			uint64_t blackboard_id = 0;
+			LocalVector<StringName> names;
+			LocalVector<int64_t> versions;
+		};
+		LocalVector<WatchedScope> scopes;
+		uint64_t last_blackboard_send_usec = 0;
+	};
+
 	HashSet<uint64_t> active_bt_instances;
-	uint64_t tracked_instance_id = 0;
+	HashMap<uint64_t, TrackedTree> tracked_trees;
+	LocalVector<BTTask *> flattened_tasks;
+	// Keys of tree structures the editor has received in this session, see BehaviorTreeData::get_structure_key().
+	// Other instances of the same tree are sent as task ids and states only.
+	HashSet<String> sent_structures;
+	// Changes to the list of active instances, sent to the editor once per frame.
+	LocalVector<uint64_t> added_bt_instances;
+	LocalVector<uint64_t> removed_bt_instances;
 	bool session_active = false;
 
+	// Accumulated between performance reports.
+	uint64_t report_histogram[BTStats::HISTOGRAM_BUCKETS] = {};
+	LocalVector<BTStats::Spike> report_spikes;
+	uint64_t last_report_usec = 0;
+	uint64_t last_overview_usec = 0;
+
+	// Sampling profile: how many samples found instances of each tree in each running path.
+	// Sampled at limbo_ai/debugger/sample_rate while the editor asks for it, independent of how often trees are updated.
+	bool sampling = false;
+	uint32_t num_samples = 0;
+	uint64_t last_sample_usec = 0;
+	HashMap<String, HashMap<String, uint32_t>> running_samples;
+
 	void _track_tree(uint64_t p_instance_id);
-	void _untrack_tree();
+	void _untrack_tree(uint64_t p_instance_id);
+	void _untrack_all_trees();
 	void _send_active_bt_players();
+	void _send_bt_player_changes();
+	void _set_session_active(bool p_active);
+	void _resend_structure(uint64_t p_instance_id);
+	void _on_process_frame();
+	void _send_performance_report();
+	void _send_overview(double p_interval_sec);
+	void _send_task_costs();
+	void _set_sampling(bool p_enabled);
+	void _sample_running_paths();
+	void _send_running_samples();
+	void _flush_pending_updates(uint64_t p_instance_id, TrackedTree &p_tracked);
+	void _send_blackboard_changes(uint64_t p_instance_id, TrackedTree &p_tracked);
 
 	void _on_bt_instance_updated(int status, uint64_t p_instance_id);
 
@@ -43,6 +43,7 @@
 #include "scene/gui/split_container.h"
 #include "scene/gui/tab_container.h"
 #include "scene/gui/texture_rect.h"
+#include "scene/gui/tree.h"
 #endif // LIMBOAI_MODULE
 
 #ifdef LIMBOAI_GDEXTENSION
@@ -58,8 +59,17 @@
 //**** LimboDebuggerTab
 
 void LimboDebuggerTab::_reset_controls() {
+	tracked_data.unref();
+	structure_cache.clear();
 	bt_instance_list->clear();
+	offender_list->clear();
+	histogram_label->set_text("");
+	overview_view->clear();
+	samples_view->clear();
+	sample_counts.clear();
+	total_samples = 0;
 	bt_view->clear();
+	_clear_blackboard_view();
 	alert_box->hide();
 	info_message->set_text(TTR("Run project to start debugging."));
 	info_message->show();
@@ -67,13 +77,27 @@ void LimboDebuggerTab::_reset_controls() {
 	resource_header->set_text(TTR("Inactive"));
 }
 
+void LimboDebuggerTab::_clear_blackboard_view() {
+	bb_view->clear();
+	bb_scopes.clear();
+}
+
 void LimboDebuggerTab::start_session() {
+	structure_cache.clear();
 	bt_instance_list->clear();
+	offender_list->clear();
+	histogram_label->set_text("");
 	bt_view->clear();
+	_clear_blackboard_view();
 	alert_box->hide();
 	info_message->set_text(TTR("Pick a player from the list to display behavior tree."));
 	info_message->show();
 	session->send_message("limboai:start_session", Array());
+	if (samples_button->is_pressed()) {
+		Array msg_data;
+		msg_data.push_back(true);
+		session->send_message("limboai:sample_running_paths", msg_data);
+	}
 }
 
 void LimboDebuggerTab::stop_session() {
@@ -91,6 +115,27 @@ void LimboDebuggerTab::update_active_bt_instances(const Array &p_data) {
 	_update_bt_instance_list(active_bt_instances, filter_players->get_text());
 }
 
+void LimboDebuggerTab::change_active_bt_instances(const Array &p_added, const Array &p_removed) {
+	if (!p_removed.is_empty()) {
+		HashSet<uint64_t> removed;
+		for (int i = 0; i < p_removed.size(); i++) {
+			removed.insert(uint64_t(p_removed[i]));
+		}
+		Vector<BTInstanceInfo> remaining;
+		for (const BTInstanceInfo &info : active_bt_instances) {
+			if (!removed.has(info.instance_id)) {
+				remaining.push_back(info);
+			}
+		}
+		active_bt_instances = remaining;
+	}
+	for (int i = 0; i + 1 < p_added.size(); i += 2) {
+		BTInstanceInfo info{ p_added[i], p_added[i + 1] };
+		active_bt_instances.push_back(info);
+	}
+	_update_bt_instance_list(active_bt_instances, filter_players->get_text());
+}
+
 uint64_t LimboDebuggerTab::get_selected_bt_instance_id() {
 	if (!bt_instance_list->is_anything_selected()) {
 		return 0;
@@ -99,12 +144,241 @@ uint64_t LimboDebuggerTab::get_selected_bt_instance_id() {
 }
 
 void LimboDebuggerTab::update_behavior_tree(const Ref<BehaviorTreeData> &p_data) {
+	tracked_data = p_data;
+	structure_cache[BehaviorTreeData::get_structure_key(p_data->source_bt_path, p_data->structure_hash)] = p_data;
 	resource_header->set_text(p_data->source_bt_path);
 	resource_header->set_disabled(false);
 	bt_view->update_tree(p_data);
 	info_message->hide();
 }
 
+void LimboDebuggerTab::update_behavior_tree_cached(const Array &p_data) {
+	String source_bt_path;
+	uint32_t structure_hash = 0;
+	ERR_FAIL_COND(!BehaviorTreeData::get_cached_key(p_data, source_bt_path, structure_hash));
+	const uint64_t instance_id = p_data[0];
+	if (instance_id != get_selected_bt_instance_id()) {
+		return;
+	}
+	Ref<BehaviorTreeData> data;
+	const Ref<BehaviorTreeData> *structure = structure_cache.getptr(BehaviorTreeData::get_structure_key(source_bt_path, structure_hash));
+	if (structure) {
+		data = BehaviorTreeData::deserialize_cached(p_data, *structure);
+	}
+	if (data.is_null()) {
+		// * Not in the cache - ask for the full structure.
+		Array msg_data;
+		msg_data.push_back(instance_id);
+		session->send_message("limboai:request_structure", msg_data);
+		return;
+	}
+	update_behavior_tree(data);
+}
+
+void LimboDebuggerTab::apply_behavior_tree_delta(uint64_t p_instance_id, const PackedByteArray &p_delta) {
+	if (tracked_data.is_null() || tracked_data->bt_instance_id != p_instance_id) {
+		// * Structure not received yet.
+		return;
+	}
+	if (tracked_data->apply_delta(p_delta)) {
+		bt_view->update_tree(tracked_data);
+	}
+}
+
+void LimboDebuggerTab::apply_blackboard_delta(uint64_t p_instance_id, int p_num_scopes, const Array &p_changes) {
+	if (p_instance_id != get_selected_bt_instance_id()) {
+		return;
+	}
+	TreeItem *root = bb_view->get_root();
+	if (root == nullptr) {
+		root = bb_view->create_item();
+	}
+	while ((int)bb_scopes.size() > p_num_scopes) {
+		memdelete(bb_scopes[bb_scopes.size() - 1].item);
+		bb_scopes.resize(bb_scopes.size() - 1);
+	}
+	while ((int)bb_scopes.size() < p_num_scopes) {
+		BlackboardScopeItems scope;
+		scope.item = bb_view->create_item(root);
+		scope.item->set_text(0, bb_scopes.is_empty() ? TTR("Blackboard") : vformat(TTR("Parent Scope %d"), bb_scopes.size()));
+		scope.item->set_selectable(0, false);
+		scope.item->set_selectable(1, false);
+		bb_scopes.push_back(scope);
+	}
+
+	for (int i = 0; i + 3 < p_changes.size(); i += 4) {
+		const int idx = p_changes[i];
+		ERR_CONTINUE(idx < 0 || idx >= (int)bb_scopes.size());
+		BlackboardScopeItems &scope = bb_scopes[idx];
+		if (bool(p_changes[i + 1])) {
+			// * A different blackboard took this place in the scope chain.
+			scope.item->clear_children();
+			scope.vars.clear();
+		}
+		const Array changed = p_changes[i + 2];
+		for (int j = 0; j + 1 < changed.size(); j += 2) {
+			const StringName name = changed[j];
+			TreeItem **existing = scope.vars.getptr(name);
+			TreeItem *item = existing ? *existing : nullptr;
+			if (item == nullptr) {
+				item = bb_view->create_item(scope.item);
+				item->set_text(0, name);
+				scope.vars.insert(name, item);
+			}
+			item->set_text(1, String(changed[j + 1]));
+		}
+		const Array erased = p_changes[i + 3];
+		for (int j = 0; j < erased.size(); j++) {
+			TreeItem **existing = scope.vars.getptr(erased[j]);
+			if (existing) {
+				memdelete(*existing);
+				scope.vars.erase(erased[j]);
+			}
+		}
+	}
+}
+
+void LimboDebuggerTab::update_performance_report(const Array &p_data) {
+	ERR_FAIL_COND(p_data.size() != 2);
+	PackedInt64Array histogram = p_data[0];
+	Array spikes = p_data[1];
+
+	// Histogram buckets are powers of two in usec - show the non-empty ones.
+	String histogram_text;
+	for (int b = 0; b < histogram.size(); b++) {
+		if (histogram[b] == 0) {
+			continue;
+		}
+		const String bound = b == 0 ? String("<2us") : vformat(">=%s", b < 10 ? itos(1 << b) + "us" : String::num(double(1 << b) * 0.001, 1) + "ms");
+		histogram_text += vformat("%s%s: %d", histogram_text.is_empty() ? "" : "  ", bound, histogram[b]);
+	}
+	histogram_label->set_text(histogram_text);
+
+	offender_list->clear();
+	for (int i = 0; i + 3 < spikes.size(); i += 4) {
+		const uint64_t instance_id = spikes[i];
+		const double msec = double(uint64_t(spikes[i + 1])) * 0.001;
+		const String tree_path = spikes[i + 2];
+		const String task_path = spikes[i + 3];
+
+		String owner_path;
+		for (const BTInstanceInfo &info : active_bt_instances) {
+			if (info.instance_id == instance_id) {
+				owner_path = info.owner_node_path;
+				break;
+			}
+		}
+		int idx = offender_list->add_item(vformat("%.2f ms  %s", msec, owner_path.is_empty() ? tree_path : owner_path));
+		offender_list->set_item_metadata(idx, instance_id);
+		offender_list->set_item_tooltip(idx, vformat(TTR("Update time: %.2f ms\nBehavior tree: %s\nRunning task: %s\n\nDouble-click to track this instance."), msec, tree_path, task_path));
+		offender_list->set_item_text_direction(idx, TEXT_DIRECTION_RTL);
+	}
+}
+
+void LimboDebuggerTab::update_overview(const Array &p_data) {
+	struct LeafCount {
+		String name;
+		int count = 0;
+		bool operator<(const LeafCount &p_other) const { return count > p_other.count; }
+	};
+
+	overview_view->clear();
+	TreeItem *root = overview_view->create_item();
+	for (int i = 0; i + 4 < p_data.size(); i += 5) {
+		const String tree_path = p_data[i];
+		TreeItem *tree_item = overview_view->create_item(root);
+		tree_item->set_text(0, tree_path.is_empty() ? TTR("(Unsaved tree)") : tree_path);
+		tree_item->set_tooltip_text(0, tree_path);
+		tree_item->set_text(1, itos(p_data[i + 1]));
+		tree_item->set_text(2, String::num(double(p_data[i + 2]) * 0.001, 3));
+		tree_item->set_text(3, String::num(double(p_data[i + 3]), 1));
+
+		// * Most common running leaves first - many instances stuck in the same task stand out.
+		const Array leaves = p_data[i + 4];
+		LocalVector<LeafCount> counts;
+		for (int j = 0; j + 1 < leaves.size(); j += 2) {
+			counts.push_back(LeafCount{ leaves[j], leaves[j + 1] });
+		}
+		counts.sort();
+		for (const LeafCount &leaf : counts) {
+			TreeItem *leaf_item = overview_view->create_item(tree_item);
+			leaf_item->set_text(0, leaf.name);
+			leaf_item->set_text(1, itos(leaf.count));
+			leaf_item->set_tooltip_text(0, vformat(TTR("%d instances are running this task."), leaf.count));
+		}
+	}
+}
+
+void LimboDebuggerTab::update_running_samples(const Array &p_data) {
+	struct PathCount {
+		String path;
+		int64_t count = 0;
+		bool operator<(const PathCount &p_other) const { return count > p_other.count; }
+	};
+
+	ERR_FAIL_COND(p_data.is_empty());
+	total_samples += int64_t(p_data[0]);
+	for (int i = 1; i + 2 < p_data.size(); i += 3) {
+		const PackedStringArray paths = p_data[i + 1];
+		const PackedInt32Array counts = p_data[i + 2];
+		ERR_FAIL_COND(paths.size() != counts.size());
+		HashMap<String, int64_t> &tree_counts = sample_counts[p_data[i]];
+		for (int j = 0; j < paths.size(); j++) {
+			tree_counts[paths[j]] += counts[j];
+		}
+	}
+
+	samples_view->clear();
+	TreeItem *root = samples_view->create_item();
+	for (const KeyValue<String, HashMap<String, int64_t>> &kv : sample_counts) {
+		LocalVector<PathCount> counts;
+		int64_t tree_total = 0;
+		for (const KeyValue<String, int64_t> &path : kv.value) {
+			counts.push_back(PathCount{ path.key, path.value });
+			tree_total += path.value;
+		}
+		counts.sort();
+
+		TreeItem *tree_item = samples_view->create_item(root);
+		tree_item->set_text(0, kv.key.is_empty() ? TTR("(Unsaved tree)") : kv.key);
+		tree_item->set_tooltip_text(0, kv.key);
+		tree_item->set_text(1, itos(tree_total));
+		// * Most sampled paths first - that's where instances of the tree spend their time.
+		for (const PathCount &path : counts) {
+			TreeItem *path_item = samples_view->create_item(tree_item);
+			path_item->set_text(0, path.path);
+			path_item->set_tooltip_text(0, path.path);
+			path_item->set_text(1, itos(path.count));
+			path_item->set_text(2, String::num(100.0 * double(path.count) / double(tree_total), 1));
+		}
+	}
+	samples_button->set_tooltip_text(vformat(TTR("Sample the running tasks of all active instances, and show where they spend their time.\nSamples taken: %d"), total_samples));
+}
+
+void LimboDebuggerTab::_overview_toggled(bool p_pressed) {
+	if (p_pressed) {
+		samples_button->set_pressed(false);
+	}
+	overview_view->set_visible(p_pressed);
+	view_split->set_visible(!overview_view->is_visible() && !samples_view->is_visible());
+}
+
+void LimboDebuggerTab::_samples_toggled(bool p_pressed) {
+	if (p_pressed) {
+		overview_button->set_pressed(false);
+		sample_counts.clear();
+		total_samples = 0;
+		samples_view->clear();
+	}
+	samples_view->set_visible(p_pressed);
+	view_split->set_visible(!overview_view->is_visible() && !samples_view->is_visible());
+	if (session.is_valid() && session->is_active()) {
+		Array msg_data;
+		msg_data.push_back(p_pressed);
+		session->send_message("limboai:sample_running_paths", msg_data);
+	}
+}
+
 void LimboDebuggerTab::_show_alert(const String &p_message) {
 	alert_message->set_text(p_message);
 	alert_box->set_visible(!p_message.is_empty());
@@ -142,6 +416,7 @@ void LimboDebuggerTab::_update_bt_instance_list(const Vector<BTInstanceInfo> &p_
 		if (selection_filtered_out) {
 			session->send_message("limboai:untrack_bt_player", Array());
 			bt_view->clear();
+			_clear_blackboard_view();
 			_show_alert("");
 		} else {
 			_show_alert(TTR("Behavior tree instance is no longer present."));
@@ -150,17 +425,37 @@ void LimboDebuggerTab::_update_bt_instance_list(const Vector<BTInstanceInfo> &p_
 }
 
 void LimboDebuggerTab::_bt_instance_selected(int p_idx) {
+	tracked_data.unref();
+	if (trace.is_valid()) {
+		trace.unref();
+		trace_box->hide();
+	}
 	alert_box->hide();
 	bt_view->clear();
+	_clear_blackboard_view();
 	info_message->set_text(TTR("Waiting for behavior tree update."));
 	info_message->show();
 	resource_header->set_text(TTR("Waiting for data"));
 	resource_header->set_disabled(true);
+	// * The runtime can track several instances, but this view shows one at a time.
+	session->send_message("limboai:untrack_bt_player", Array());
 	Array msg_data;
 	msg_data.push_back(bt_instance_list->get_item_metadata(p_idx));
 	session->send_message("limboai:track_bt_player", msg_data);
 }
 
+void LimboDebuggerTab::_offender_activated(int p_idx) {
+	uint64_t instance_id = offender_list->get_item_metadata(p_idx);
+	for (int i = 0; i < bt_instance_list->get_item_count(); i++) {
+		if (uint64_t(bt_instance_list->get_item_metadata(i)) == instance_id) {
+			bt_instance_list->select(i);
+			bt_instance_list->ensure_current_is_visible();
+			_bt_instance_selected(i);
+			return;
+		}
+	}
+}
+
 void LimboDebuggerTab::_filter_changed(String p_text) {
 	_update_bt_instance_list(active_bt_instances, p_text);
 }
@@ -180,6 +475,51 @@ void LimboDebuggerTab::_resource_header_pressed() {
 	EditorInterface::get_singleton()->edit_resource(bt);
 }
 
+void LimboDebuggerTab::_open_trace_pressed() {
+	trace_dialog->popup_centered_clamped(Size2i(700, 500), 0.8f);
+}
+
+void LimboDebuggerTab::_trace_selected(const String &p_path) {
+	Ref<BTTrace> loaded = BTTrace::load(p_path);
+	ERR_FAIL_COND_MSG(loaded.is_null() || loaded->get_task_count() == 0, "LimboDebugger: Failed to load trace: " + p_path);
+
+	if (bt_instance_list->is_anything_selected()) {
+		bt_instance_list->deselect_all();
+		session->send_message("limboai:untrack_bt_player", Array());
+	}
+	trace = loaded;
+	tracked_data.unref();
+	alert_box->hide();
+	bt_view->clear();
+	_clear_blackboard_view();
+	info_message->hide();
+	resource_header->set_text(p_path.get_file());
+	resource_header->set_disabled(true);
+
+	trace_slider->set_max(trace->get_record_count());
+	trace_slider->set_value_no_signal(trace->get_record_count());
+	trace_box->show();
+	_trace_scrubbed(trace->get_record_count());
+}
+
+void LimboDebuggerTab::_trace_scrubbed(double p_value) {
+	ERR_FAIL_COND(trace.is_null());
+	const int count = int(p_value);
+	const double msec = count > 0 ? double(trace->get_record_unchecked(count - 1).time_msec) : 0.0;
+	trace_time->set_text(vformat(TTR("%d / %d  (%.3f s)"), count, trace->get_record_count(), msec * 0.001));
+	bt_view->update_tree(BehaviorTreeData::create_from_trace(trace, count));
+}
+
+void LimboDebuggerTab::_close_trace() {
+	trace.unref();
+	trace_box->hide();
+	bt_view->clear();
+	_clear_blackboard_view();
+	resource_header->set_text(TTR("Inactive"));
+	info_message->set_text(TTR("Pick a player from the list to display behavior tree."));
+	info_message->show();
+}
+
 void LimboDebuggerTab::_bind_methods() {
 }
 
@@ -189,7 +529,13 @@ void LimboDebuggerTab::_notification(int p_what) {
 			resource_header->connect(LW_NAME(pressed), callable_mp(this, &LimboDebuggerTab::_resource_header_pressed));
 			filter_players->connect(LW_NAME(text_changed), callable_mp(this, &LimboDebuggerTab::_filter_changed));
 			bt_instance_list->connect(LW_NAME(item_selected), callable_mp(this, &LimboDebuggerTab::_bt_instance_selected));
+			offender_list->connect(LW_NAME(item_activated), callable_mp(this, &LimboDebuggerTab::_offender_activated));
 			update_interval->connect("value_changed", callable_mp(bt_view, &BehaviorTreeView::set_update_interval_msec));
+			open_trace->connect(LW_NAME(pressed), callable_mp(this, &LimboDebuggerTab::_open_trace_pressed));
+			overview_button->connect(LW_NAME(toggled), callable_mp(this, &LimboDebuggerTab::_overview_toggled));
+			samples_button->connect(LW_NAME(toggled), callable_mp(this, &LimboDebuggerTab::_samples_toggled));
+			trace_dialog->connect("file_selected", callable_mp(this, &LimboDebuggerTab::_trace_selected));
+			trace_slider->connect("value_changed", callable_mp(this, &LimboDebuggerTab::_trace_scrubbed));
 
 			Ref<ConfigFile> cf;
 			cf.instantiate();
@@ -262,6 +608,37 @@ LimboDebuggerTab::LimboDebuggerTab() {
 	VSeparator *sep = memnew(VSeparator);
 	toolbar->add_child(sep);
 
+	overview_button = memnew(Button);
+	toolbar->add_child(overview_button);
+	overview_button->set_flat(true);
+	overview_button->set_toggle_mode(true);
+	overview_button->set_text(TTR("Overview"));
+	overview_button->set_tooltip_text(TTR("Show all active instances grouped by behavior tree: instance counts, mean update time, status changes per second, and running tasks."));
+	overview_button->set_focus_mode(FOCUS_NONE);
+
+	samples_button = memnew(Button);
+	toolbar->add_child(samples_button);
+	samples_button->set_flat(true);
+	samples_button->set_toggle_mode(true);
+	samples_button->set_text(TTR("Samples"));
+	samples_button->set_tooltip_text(TTR("Sample the running tasks of all active instances, and show where they spend their time."));
+	samples_button->set_focus_mode(FOCUS_NONE);
+
+	open_trace = memnew(Button);
+	toolbar->add_child(open_trace);
+	open_trace->set_flat(true);
+	open_trace->set_text(TTR("Open Trace"));
+	open_trace->set_tooltip_text(TTR("Load a trace saved with BTTrace.save() and scrub through it."));
+	open_trace->set_focus_mode(FOCUS_NONE);
+
+	trace_dialog = memnew(FileDialog);
+	add_child(trace_dialog);
+	trace_dialog->set_file_mode(FileDialog::FILE_MODE_OPEN_FILE);
+	trace_dialog->set_access(FileDialog::ACCESS_FILESYSTEM);
+	trace_dialog->set_title(TTR("Open Behavior Tree Trace"));
+	trace_dialog->add_filter("*.bttrace");
+	trace_dialog->hide();
+
 	hsc = memnew(HSplitContainer);
 	hsc->set_h_size_flags(Control::SIZE_EXPAND_FILL);
 	hsc->set_v_size_flags(Control::SIZE_EXPAND_FILL);
@@ -280,13 +657,89 @@ LimboDebuggerTab::LimboDebuggerTab() {
 	bt_instance_list->set_v_size_flags(SIZE_EXPAND_FILL);
 	list_box->add_child(bt_instance_list);
 
+	Label *offenders_header = memnew(Label);
+	offenders_header->set_text(TTR("Top Offenders"));
+	offenders_header->set_tooltip_text(TTR("Slowest behavior tree updates since the last report."));
+	offenders_header->set_mouse_filter(MOUSE_FILTER_PASS);
+	list_box->add_child(offenders_header);
+
+	offender_list = memnew(ItemList);
+	offender_list->set_custom_minimum_size(Size2(240.0 * EDSCALE, 120.0 * EDSCALE));
+	offender_list->set_h_size_flags(SIZE_FILL);
+	list_box->add_child(offender_list);
+
+	histogram_label = memnew(Label);
+	histogram_label->set_autowrap_mode(TextServer::AUTOWRAP_WORD_SMART);
+	histogram_label->set_custom_minimum_size(Size2(240.0 * EDSCALE, 0.0));
+	histogram_label->set_tooltip_text(TTR("Number of behavior tree updates by duration since the last report."));
+	histogram_label->set_mouse_filter(MOUSE_FILTER_PASS);
+	list_box->add_child(histogram_label);
+
 	view_box = memnew(VBoxContainer);
 	hsc->add_child(view_box);
 
+	view_split = memnew(VSplitContainer);
+	view_split->set_v_size_flags(Control::SIZE_EXPAND_FILL);
+	view_box->add_child(view_split);
+
 	bt_view = memnew(BehaviorTreeView);
 	bt_view->set_h_size_flags(Control::SIZE_EXPAND_FILL);
 	bt_view->set_v_size_flags(Control::SIZE_EXPAND_FILL);
-	view_box->add_child(bt_view);
+	view_split->add_child(bt_view);
+
+	bb_view = memnew(Tree);
+	bb_view->set_columns(2);
+	bb_view->set_column_titles_visible(true);
+	bb_view->set_column_title(0, TTR("Variable"));
+	bb_view->set_column_title(1, TTR("Value"));
+	bb_view->set_column_expand_ratio(1, 2);
+	bb_view->set_hide_root(true);
+	bb_view->set_custom_minimum_size(Size2(0.0, 120.0 * EDSCALE));
+	view_split->add_child(bb_view);
+
+	overview_view = memnew(Tree);
+	overview_view->set_columns(4);
+	overview_view->set_column_titles_visible(true);
+	overview_view->set_column_title(0, TTR("Behavior Tree"));
+	overview_view->set_column_title(1, TTR("Instances"));
+	overview_view->set_column_title(2, TTR("Mean ms"));
+	overview_view->set_column_title(3, TTR("Changes/s"));
+	overview_view->set_column_expand_ratio(0, 4);
+	overview_view->set_hide_root(true);
+	overview_view->set_v_size_flags(Control::SIZE_EXPAND_FILL);
+	overview_view->hide();
+	view_box->add_child(overview_view);
+
+	samples_view = memnew(Tree);
+	samples_view->set_columns(3);
+	samples_view->set_column_titles_visible(true);
+	samples_view->set_column_title(0, TTR("Running Path"));
+	samples_view->set_column_title(1, TTR("Samples"));
+	samples_view->set_column_title(2, TTR("%"));
+	samples_view->set_column_expand_ratio(0, 4);
+	samples_view->set_hide_root(true);
+	samples_view->set_v_size_flags(Control::SIZE_EXPAND_FILL);
+	samples_view->hide();
+	view_box->add_child(samples_view);
+
+	trace_box = memnew(HBoxContainer);
+	trace_box->hide();
+	view_box->add_child(trace_box);
+
+	trace_slider = memnew(HSlider);
+	trace_box->add_child(trace_slider);
+	trace_slider->set_h_size_flags(SIZE_EXPAND_FILL);
+	trace_slider->set_v_size_flags(SIZE_SHRINK_CENTER);
+	trace_slider->set_step(1.0);
+
+	trace_time = memnew(Label);
+	trace_box->add_child(trace_time);
+
+	Button *close_trace = memnew(Button);
+	trace_box->add_child(close_trace);
+	close_trace->set_flat(true);
+	close_trace->set_text(TTR("Close"));
+	close_trace->connect(LW_NAME(pressed), callable_mp(this, &LimboDebuggerTab::_close_trace));
 
 	alert_box = memnew(HBoxContainer);
 	alert_box->hide();
@@ -317,6 +770,26 @@ LimboDebuggerPlugin *LimboDebuggerPlugin::singleton = nullptr;
 void LimboDebuggerPlugin::_window_visibility_changed(bool p_visible) {
 }
 
+void LimboDebuggerPlugin::_update_task_costs(const Array &p_data) {
+	ERR_FAIL_COND(p_data.size() % 5 != 0);
+	for (int i = 0; i < p_data.size(); i += 5) {
+		task_costs[p_data[i]] = p_data.slice(i + 1, i + 5);
+	}
+	emit_signal(LW_NAME(task_costs_changed));
+}
+
+void LimboDebuggerPlugin::_clear_task_costs() {
+	if (!task_costs.is_empty()) {
+		task_costs.clear();
+		emit_signal(LW_NAME(task_costs_changed));
+	}
+}
+
+Array LimboDebuggerPlugin::get_task_costs(const String &p_tree_path) const {
+	const Array *costs = task_costs.getptr(p_tree_path);
+	return costs ? *costs : Array();
+}
+
 #ifdef LIMBOAI_MODULE
 void LimboDebuggerPlugin::setup_session(int p_session_id) {
 #elif LIMBOAI_GDEXTENSION
@@ -340,6 +813,7 @@ void LimboDebuggerPlugin::_setup_session(int32_t p_session_id) {
 
 	session->connect(LW_NAME(started), callable_mp(tab, &LimboDebuggerTab::start_session));
 	session->connect(LW_NAME(stopped), callable_mp(tab, &LimboDebuggerTab::stop_session));
+	session->connect(LW_NAME(stopped), callable_mp(this, &LimboDebuggerPlugin::_clear_task_costs));
 	session->add_session_tab(session_window);
 
 	session_windows[p_session_id] = session_window;
@@ -356,11 +830,30 @@ bool LimboDebuggerPlugin::_capture(const String &p_message, const Array &p_data,
 	bool captured = true;
 	if (p_message == "limboai:active_bt_players") {
 		tab->update_active_bt_instances(p_data);
+	} else if (p_message == "limboai:active_bt_players_changed") {
+		ERR_FAIL_COND_V(p_data.size() != 2, true);
+		tab->change_active_bt_instances(p_data[0], p_data[1]);
+	} else if (p_message == "limboai:bt_delta") {
+		ERR_FAIL_COND_V(p_data.size() != 2, true);
+		tab->apply_behavior_tree_delta(p_data[0], p_data[1]);
+	} else if (p_message == "limboai:bb_delta") {
+		ERR_FAIL_COND_V(p_data.size() != 3, true);
+		tab->apply_blackboard_delta(p_data[0], p_data[1], p_data[2]);
+	} else if (p_message == "limboai:overview") {
+		tab->update_overview(p_data);
+	} else if (p_message == "limboai:running_samples") {
+		tab->update_running_samples(p_data);
+	} else if (p_message == "limboai:performance_report") {
+		tab->update_performance_report(p_data);
+	} else if (p_message == "limboai:task_costs") {
+		_update_task_costs(p_data);
 	} else if (p_message == "limboai:bt_update") {
 		Ref<BehaviorTreeData> data = BehaviorTreeData::deserialize(p_data);
-		if (data->bt_instance_id == tab->get_selected_bt_instance_id()) {
+		if (data.is_valid() && data->bt_instance_id == tab->get_selected_bt_instance_id()) {
 			tab->update_behavior_tree(data);
 		}
+	} else if (p_message == "limboai:bt_update_cached") {
+		tab->update_behavior_tree_cached(p_data);
 	} else {
 		captured = false;
 	}
@@ -389,6 +882,7 @@ int LimboDebuggerPlugin::get_first_session_tab_index() const {
 }
 
 void LimboDebuggerPlugin::_bind_methods() {
+	ADD_SIGNAL(MethodInfo("task_costs_changed"));
 }
 
 LimboDebuggerPlugin::LimboDebuggerPlugin() {
@@ -26,10 +26,13 @@
 #include "editor/plugins/editor_debugger_plugin.h"
 #include "editor/window_wrapper.h"
 #include "scene/gui/box_container.h"
+#include "scene/gui/file_dialog.h"
 #include "scene/gui/item_list.h"
+#include "scene/gui/slider.h"
 #include "scene/gui/panel_container.h"
 #include "scene/gui/split_container.h"
 #include "scene/gui/texture_rect.h"
+#include "scene/gui/tree.h"
 #endif // LIMBOAI_MODULE
 
 #ifdef LIMBOAI_GDEXTENSION
@@ -37,14 +40,19 @@
 #include <godot_cpp/classes/editor_debugger_plugin.hpp>
 #include <godot_cpp/classes/editor_debugger_session.hpp>
 #include <godot_cpp/classes/editor_spin_slider.hpp>
+#include <godot_cpp/classes/file_dialog.hpp>
 #include <godot_cpp/classes/h_box_container.hpp>
+#include <godot_cpp/classes/h_slider.hpp>
 #include <godot_cpp/classes/h_split_container.hpp>
 #include <godot_cpp/classes/item_list.hpp>
 #include <godot_cpp/classes/label.hpp>
 #include <godot_cpp/classes/line_edit.hpp>
 #include <godot_cpp/classes/panel_container.hpp>
 #include <godot_cpp/classes/texture_rect.hpp>
+#include <godot_cpp/classes/tree.hpp>
+#include <godot_cpp/classes/tree_item.hpp>
 #include <godot_cpp/classes/v_box_container.hpp>
+#include <godot_cpp/classes/v_split_container.hpp>
 #endif // LIMBOAI_GDEXTENSION
 
 class LimboDebuggerTab : public PanelContainer {
@@ -56,14 +64,34 @@ private:
 		String owner_node_path;
 	};
 
+	struct BlackboardScopeItems {
+		TreeItem *item = nullptr;
+		HashMap<StringName, TreeItem *> vars;
+	};
+
 	Vector<BTInstanceInfo> active_bt_instances;
+	Ref<BehaviorTreeData> tracked_data; // Deltas are applied to it.
+	// Structures received in this session, by BehaviorTreeData::get_structure_key(). Instances of the same tree share them.
+	HashMap<String, Ref<BehaviorTreeData>> structure_cache;
 	Ref<EditorDebuggerSession> session;
 	VBoxContainer *root_vb = nullptr;
 	HBoxContainer *toolbar = nullptr;
 	HSplitContainer *hsc = nullptr;
 	Label *info_message = nullptr;
 	ItemList *bt_instance_list = nullptr;
+	ItemList *offender_list = nullptr;
+	Label *histogram_label = nullptr;
 	BehaviorTreeView *bt_view = nullptr;
+	Tree *bb_view = nullptr;
+	LocalVector<BlackboardScopeItems> bb_scopes;
+	VSplitContainer *view_split = nullptr;
+	Tree *overview_view = nullptr;
+	Button *overview_button = nullptr;
+	Tree *samples_view = nullptr;
+	Button *samples_button = nullptr;
+	// Sampling profile accumulated since sampling was turned on: samples by tree path and running path.
+	HashMap<String, HashMap<String, int64_t>> sample_counts;
+	int64_t total_samples = 0;
 	VBoxContainer *view_box = nullptr;
 	HBoxContainer *alert_box = nullptr;
 	TextureRect *alert_icon = nullptr;
@@ -72,15 +100,29 @@ private:
 	Button *resource_header = nullptr;
 	Button *make_floating = nullptr;
 	EditorSpinSlider *update_interval = nullptr;
+	Button *open_trace = nullptr;
+	FileDialog *trace_dialog = nullptr;
+	HBoxContainer *trace_box = nullptr;
+	HSlider *trace_slider = nullptr;
+	Label *trace_time = nullptr;
+	Ref<BTTrace> trace;
 	CompatWindowWrapper *window_wrapper = nullptr;
 
 	void _reset_controls();
+	void _clear_blackboard_view();
 	void _show_alert(const String &p_message);
 	void _update_bt_instance_list(const Vector<BTInstanceInfo> &p_instances, const String &p_filter);
 	void _bt_instance_selected(int p_idx);
+	void _offender_activated(int p_idx);
 	void _filter_changed(String p_text);
 	void _window_visibility_changed(bool p_visible);
 	void _resource_header_pressed();
+	void _open_trace_pressed();
+	void _trace_selected(const String &p_path);
+	void _trace_scrubbed(double p_value);
+	void _close_trace();
+	void _overview_toggled(bool p_pressed);
+	void _samples_toggled(bool p_pressed);
 
 protected:
 	static void _bind_methods();
@@ -90,9 +132,16 @@ public:
 	void start_session();
 	void stop_session();
 	void update_active_bt_instances(const Array &p_data);
+	void change_active_bt_instances(const Array &p_added, const Array &p_removed);
 	BehaviorTreeView *get_behavior_tree_view() const { return bt_view; }
 	uint64_t get_selected_bt_instance_id();
 	void update_behavior_tree(const Ref<BehaviorTreeData> &p_data);
+	void update_behavior_tree_cached(const Array &p_data);
+	void apply_behavior_tree_delta(uint64_t p_instance_id, const PackedByteArray &p_delta);
+	void apply_blackboard_delta(uint64_t p_instance_id, int p_num_scopes, const Array &p_changes);
+	void update_performance_report(const Array &p_data);
+	void update_overview(const Array &p_data);
+	void update_running_samples(const Array &p_data);
 
 	void setup(Ref<EditorDebuggerSession> p_session, CompatWindowWrapper *p_wrapper);
 	LimboDebuggerTab();
@@ -105,8 +154,12 @@ private:
 	static LimboDebuggerPlugin *singleton;
 
 	HashMap<int, CompatWindowWrapper *> session_windows;
+	// Latest task costs reported by the running game, by tree path: task names, depths, tick counts and self times.
+	HashMap<String, Array> task_costs;
 
 	void _window_visibility_changed(bool p_visible);
+	void _update_task_costs(const Array &p_data);
+	void _clear_task_costs();
 
 protected:
 	static void _bind_methods();
@@ -124,6 +177,8 @@ public:
 	bool _capture(const String &p_message, const Array &p_data, int32_t p_session_id) override;
 #endif
 
+	Array get_task_costs(const String &p_tree_path) const;
+
 	CompatWindowWrapper *get_first_session_window() const;
 	int get_first_session_tab_index() const;
 
@@ -31,18 +31,94 @@
 #include <godot_cpp/classes/h_box_container.hpp>
 #endif // LIMBOAI_GDEXTENSION
 
-int EditorPropertyVariableName::last_caret_column = 0;
+//***** VariableNameIndex
+
+HashMap<ObjectID, VariableNameIndex::Entry> VariableNameIndex::entries;
+
+void VariableNameIndex::_invalidate(ObjectID p_plan_id) {
+	entries.erase(p_plan_id);
+}
+
+const VariableNameIndex::Entry &VariableNameIndex::_get_entry(const Ref<BlackboardPlan> &p_plan) {
+	const ObjectID id = p_plan->get_instance_id();
+	const Entry *existing = entries.getptr(id);
+	if (existing) {
+		return *existing;
+	}
+
+	// * Freed plans don't notify - their entries are dropped whenever a new one is built.
+	LocalVector<ObjectID> stale;
+	for (const KeyValue<ObjectID, Entry> &kv : entries) {
+		if (ObjectDB::get_instance(kv.key) == nullptr) {
+			stale.push_back(kv.key);
+		}
+	}
+	for (const ObjectID &stale_id : stale) {
+		entries.erase(stale_id);
+	}
+
+	Entry entry;
+	entry.sorted.resize(p_plan->get_var_count());
+	for (int i = 0; i < p_plan->get_var_count(); i++) {
+		entry.sorted[i].name = p_plan->get_var_by_index(i).first;
+		entry.sorted[i].index = i;
+	}
+	entry.sorted.sort();
+
+	// * Type and hint changes only notify the property list, and are irrelevant here.
+	const Callable invalidate = callable_mp_static(&VariableNameIndex::_invalidate).bind(id);
+	if (!p_plan->is_connected(LW_NAME(changed), invalidate)) {
+		p_plan->connect(LW_NAME(changed), invalidate);
+	}
+	return entries.insert(id, entry)->value;
+}
+
+PackedInt32Array VariableNameIndex::find_prefix(const Ref<BlackboardPlan> &p_plan, const String &p_prefix) {
+	PackedInt32Array found;
+	ERR_FAIL_COND_V(p_plan.is_null(), found);
+	const LocalVector<SortedName> &sorted = _get_entry(p_plan).sorted;
+
+	// * Binary search for the first name not less than the prefix - matches follow it.
+	uint32_t lo = 0;
+	uint32_t hi = sorted.size();
+	while (lo < hi) {
+		const uint32_t mid = (lo + hi) / 2;
+		if (sorted[mid].name < p_prefix) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	for (uint32_t i = lo; i < sorted.size() && sorted[i].name.begins_with(p_prefix); i++) {
+		found.push_back(sorted[i].index);
+	}
+	return found;
+}
 
 //***** EditorPropertyVariableName
 
+int EditorPropertyVariableName::last_caret_column = 0;
+
 void EditorPropertyVariableName::_show_variables_popup() {
 	ERR_FAIL_NULL(plan);
 
 	variables_popup->clear();
 	variables_popup->reset_size();
-	TypedArray<StringName> var_names = plan->list_vars();
-	for (int i = 0; i < var_names.size(); i++) {
-		variables_popup->add_item(var_names[i], i);
+	// * Suggests the variables that begin with what's typed, unless it's a complete name. Otherwise, lists all of them.
+	const String typed = name_edit->get_text();
+	PackedInt32Array suggested;
+	if (!typed.is_empty() && !plan->has_var(typed)) {
+		suggested = VariableNameIndex::find_prefix(plan, typed);
+	}
+	if (suggested.is_empty()) {
+		const int count = plan->get_var_count();
+		for (int i = 0; i < count; i++) {
+			variables_popup->add_item(plan->get_var_by_index(i).first, i);
+		}
+	} else {
+		for (int i = 0; i < suggested.size(); i++) {
+			variables_popup->add_item(plan->get_var_by_index(suggested[i]).first, suggested[i]);
+		}
 	}
 
 	Transform2D xform = name_edit->get_screen_transform();
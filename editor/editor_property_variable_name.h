@@ -17,6 +17,8 @@
 #include "../blackboard/blackboard_plan.h"
 
 #ifdef LIMBOAI_MODULE
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
 #include "editor/editor_inspector.h"
 #endif // LIMBOAI_MODULE
 
@@ -25,9 +27,35 @@
 #include <godot_cpp/classes/editor_inspector_plugin.hpp>
 #include <godot_cpp/classes/editor_property.hpp>
 #include <godot_cpp/classes/line_edit.hpp>
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
 using namespace godot;
 #endif // LIMBOAI_GDEXTENSION
 
+// Variable names of each plan, indexed for prefix search, shared by all variable name properties.
+// An index is built on first use and discarded when its plan changes.
+class VariableNameIndex {
+private:
+	struct SortedName {
+		String name;
+		uint32_t index = 0; // Index of the variable in the plan.
+
+		bool operator<(const SortedName &p_other) const { return name < p_other.name; }
+	};
+	struct Entry {
+		LocalVector<SortedName> sorted;
+	};
+	static HashMap<ObjectID, Entry> entries;
+
+	static void _invalidate(ObjectID p_plan_id);
+	static const Entry &_get_entry(const Ref<BlackboardPlan> &p_plan);
+
+public:
+	// Indices of the plan variables whose names begin with p_prefix, in alphabetical order of the names.
+	static PackedInt32Array find_prefix(const Ref<BlackboardPlan> &p_plan, const String &p_prefix);
+	static void clear() { entries.clear(); }
+};
+
 class EditorPropertyVariableName : public EditorProperty {
 	GDCLASS(EditorPropertyVariableName, EditorProperty);
 
@@ -107,6 +135,7 @@ public:
 	void set_editor_plan_provider(const Callable &p_getter) { editor_plan_provider = p_getter; }
 
 	EditorInspectorPluginVariableName() = default;
+	~EditorInspectorPluginVariableName() { VariableNameIndex::clear(); }
 };
 
 #endif // TOOLS_ENABLED
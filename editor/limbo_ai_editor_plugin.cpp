@@ -19,6 +19,7 @@
 #include "../bt/tasks/composites/bt_selector.h"
 #include "../bt/tasks/decorators/bt_subtree.h"
 #include "../util/limbo_compat.h"
+#include "../util/limbo_task_db.h"
 #include "../util/limbo_utility.h"
 #include "../util/limboai_version.h"
 #include "action_banner.h"
@@ -100,6 +101,51 @@ void LimboAIEditor::_commit_action_with_update(EditorUndoRedoManager *p_undo_red
 	_mark_as_dirty(true);
 }
 
+void LimboAIEditor::_flush_task_tree_update() {
+	if (task_tree_update_queued) {
+		task_tree_update_queued = false;
+		task_tree->update_tree();
+	}
+}
+
+// Keeps only the tasks that aren't descendants of other tasks in the list, preserving the order.
+Vector<Ref<BTTask>> LimboAIEditor::_exclude_descendants(const Vector<Ref<BTTask>> &p_tasks) {
+	HashSet<uint64_t> ids;
+	for (const Ref<BTTask> &task : p_tasks) {
+		ids.insert(uint64_t(task->get_instance_id()));
+	}
+
+	Vector<Ref<BTTask>> result;
+	for (const Ref<BTTask> &task : p_tasks) {
+		bool is_descendant = false;
+		for (Ref<BTTask> ancestor = task->get_parent(); ancestor.is_valid(); ancestor = ancestor->get_parent()) {
+			if (ids.has(uint64_t(ancestor->get_instance_id()))) {
+				is_descendant = true;
+				break;
+			}
+		}
+		if (!is_descendant) {
+			result.push_back(task);
+		}
+	}
+	return result;
+}
+
+// Adds removal of the tasks to the action. Tasks must be in tree order and unrelated (see _exclude_descendants()).
+void LimboAIEditor::_add_remove_tasks_to_action(EditorUndoRedoManager *p_undo_redo, const Vector<Ref<BTTask>> &p_tasks) {
+	for (const Ref<BTTask> &task : p_tasks) {
+		if (task->is_root()) {
+			ERR_FAIL_COND(task_tree->get_bt()->get_root_task() != task);
+			p_undo_redo->add_do_method(task_tree->get_bt().ptr(), LW_NAME(set_root_task), Variant());
+			p_undo_redo->add_undo_method(task_tree->get_bt().ptr(), LW_NAME(set_root_task), task);
+		} else {
+			p_undo_redo->add_do_method(task->get_parent().ptr(), LW_NAME(remove_child), task);
+			// * In tree order, siblings are restored at lower indices first.
+			p_undo_redo->add_undo_method(task->get_parent().ptr(), LW_NAME(add_child_at_index), task, task->get_index());
+		}
+	}
+}
+
 void LimboAIEditor::_add_task(const Ref<BTTask> &p_task, bool p_as_sibling) {
 	if (task_tree->get_bt().is_null()) {
 		return;
@@ -233,7 +279,11 @@ void LimboAIEditor::_update_task_tree(const Ref<BehaviorTree> &p_bt, const Ref<B
 	ERR_FAIL_COND(p_bt.is_null());
 	if (task_tree->get_bt() == p_bt) {
 		if (p_specific_task.is_null()) {
-			task_tree->update_tree();
+			// * Coalesce refreshes: bulk edits and several actions in one frame rebuild the tree once.
+			if (!task_tree_update_queued) {
+				task_tree_update_queued = true;
+				callable_mp(this, &LimboAIEditor::_flush_task_tree_update).call_deferred();
+			}
 		} else {
 			task_tree->update_task(p_specific_task);
 		}
@@ -253,6 +303,16 @@ void LimboAIEditor::_disable_editing() {
 void LimboAIEditor::edit_bt(const Ref<BehaviorTree> &p_behavior_tree, bool p_force_refresh) {
 	ERR_FAIL_COND_MSG(p_behavior_tree.is_null(), "p_behavior_tree is null");
 
+	const String path = p_behavior_tree->get_path();
+	if (pending_reloads.has(path)) {
+		pending_reloads.erase(path);
+		Ref<BehaviorTree> reloaded = RESOURCE_LOAD_NO_CACHE(path, "BehaviorTree");
+		if (reloaded.is_valid()) {
+			p_behavior_tree->copy_other(reloaded);
+		}
+		p_force_refresh = true;
+	}
+
 	if (!p_force_refresh && task_tree->get_bt() == p_behavior_tree) {
 		return;
 	}
@@ -263,16 +323,28 @@ void LimboAIEditor::edit_bt(const Ref<BehaviorTree> &p_behavior_tree, bool p_for
 #endif // LIMBOAI_MODULE
 
 	task_tree->load_bt(p_behavior_tree);
+	update_task_costs();
 
 	if (task_tree->get_bt().is_valid() && !task_tree->get_bt()->is_connected(LW_NAME(changed), callable_mp(this, &LimboAIEditor::_mark_as_dirty))) {
 		task_tree->get_bt()->connect(LW_NAME(changed), callable_mp(this, &LimboAIEditor::_mark_as_dirty).bind(true));
 	}
 
 	int idx = history.find(p_behavior_tree);
+	if (idx == -1 && !path.is_empty()) {
+		// * Tab may be restored from the layout, but not loaded yet.
+		for (int i = 0; i < history.size(); i++) {
+			if (history[i].is_null() && history_paths[i] == path) {
+				history.write[i] = p_behavior_tree;
+				idx = i;
+				break;
+			}
+		}
+	}
 	if (idx != -1) {
 		idx_history = idx;
 	} else {
 		history.push_back(p_behavior_tree);
+		history_paths.push_back(path);
 		idx_history = history.size() - 1;
 	}
 
@@ -283,6 +355,14 @@ void LimboAIEditor::edit_bt(const Ref<BehaviorTree> &p_behavior_tree, bool p_for
 	_update_tabs();
 }
 
+// Shows the task costs reported by the debugged game for the edited tree, if it's profiled there.
+void LimboAIEditor::update_task_costs() {
+	if (LimboDebuggerPlugin::get_singleton() == nullptr || task_tree->get_bt().is_null()) {
+		return;
+	}
+	task_tree->set_task_costs(LimboDebuggerPlugin::get_singleton()->get_task_costs(task_tree->get_bt()->get_path()));
+}
+
 Ref<BlackboardPlan> LimboAIEditor::get_edited_blackboard_plan() {
 	if (task_tree->get_bt().is_null()) {
 		return nullptr;
@@ -296,20 +376,27 @@ Ref<BlackboardPlan> LimboAIEditor::get_edited_blackboard_plan() {
 void LimboAIEditor::set_window_layout(const Ref<ConfigFile> &p_configuration) {
 	Array open_bts;
 	open_bts = p_configuration->get_value("LimboAI", "bteditor_open_bts", open_bts);
+	// * Only the last tree is loaded now, other tabs are loaded when activated.
+	String last_path;
 	for (int i = 0; i < open_bts.size(); i++) {
 		String path = open_bts[i];
-		if (FILE_EXISTS(path)) {
-			_load_bt(path);
+		if (FILE_EXISTS(path) && !history_paths.has(path)) {
+			history.push_back(Ref<BehaviorTree>());
+			history_paths.push_back(path);
+			last_path = path;
 		}
 	}
+	if (!last_path.is_empty()) {
+		_load_bt(last_path);
+	}
 
 	hsc->set_split_offset(p_configuration->get_value("LimboAI", "bteditor_hsplit", hsc->get_split_offset()));
 }
 
 void LimboAIEditor::get_window_layout(const Ref<ConfigFile> &p_configuration) {
 	Array open_bts;
-	for (const Ref<BehaviorTree> &bt : history) {
-		open_bts.push_back(bt->get_path());
+	for (int i = 0; i < history.size(); i++) {
+		open_bts.push_back(_get_history_path(i));
 	}
 	p_configuration->set_value("LimboAI", "bteditor_open_bts", open_bts);
 
@@ -400,6 +487,7 @@ void LimboAIEditor::_extract_subtree(const String &p_path) {
 		undo_redo->add_undo_method(selected->get_parent().ptr(), LW_NAME(add_child_at_index), selected, idx);
 	}
 	_commit_action_with_update(undo_redo);
+	_flush_task_tree_update();
 	EDIT_RESOURCE(task_tree->get_selected());
 }
 
@@ -647,18 +735,18 @@ void LimboAIEditor::_action_selected(int p_id) {
 		case ACTION_REMOVE: {
 			Ref<BTTask> sel = task_tree->get_selected();
 			if (sel.is_valid()) {
+				Vector<Ref<BTTask>> tasks;
 				if (p_id == ACTION_CUT) {
 					clipboard_task = sel->clone();
-				}
-				EditorUndoRedoManager *undo_redo = _new_undo_redo_action(TTR("Remove BT Task"));
-				if (sel->is_root()) {
-					undo_redo->add_do_method(task_tree->get_bt().ptr(), LW_NAME(set_root_task), Variant());
-					undo_redo->add_undo_method(task_tree->get_bt().ptr(), LW_NAME(set_root_task), task_tree->get_bt()->get_root_task());
+					tasks.push_back(sel);
 				} else {
-					undo_redo->add_do_method(sel->get_parent().ptr(), LW_NAME(remove_child), sel);
-					undo_redo->add_undo_method(sel->get_parent().ptr(), LW_NAME(add_child_at_index), sel, sel->get_index());
+					// * All selected tasks are removed in one action.
+					tasks = _exclude_descendants(task_tree->get_selected_tasks());
 				}
+				EditorUndoRedoManager *undo_redo = _new_undo_redo_action(tasks.size() > 1 ? TTR("Remove BT Tasks") : TTR("Remove BT Task"));
+				_add_remove_tasks_to_action(undo_redo, tasks);
 				_commit_action_with_update(undo_redo);
+				_flush_task_tree_update();
 				EDIT_RESOURCE(task_tree->get_selected());
 			}
 		} break;
@@ -861,13 +949,13 @@ void LimboAIEditor::_on_save_pressed() {
 void LimboAIEditor::_on_history_back() {
 	ERR_FAIL_COND(history.size() == 0);
 	idx_history = MAX(idx_history - 1, 0);
-	EDIT_RESOURCE(history[idx_history]);
+	_tab_clicked(idx_history);
 }
 
 void LimboAIEditor::_on_history_forward() {
 	ERR_FAIL_COND(history.size() == 0);
 	idx_history = MIN(idx_history + 1, history.size() - 1);
-	EDIT_RESOURCE(history[idx_history]);
+	_tab_clicked(idx_history);
 }
 
 void LimboAIEditor::_on_tasks_dragged(const TypedArray<BTTask> &p_tasks, Ref<BTTask> p_to_task, int p_to_pos) {
@@ -877,21 +965,11 @@ void LimboAIEditor::_on_tasks_dragged(const TypedArray<BTTask> &p_tasks, Ref<BTT
 	}
 
 	// Remove descendants of selected.
-	Vector<Ref<BTTask>> tasks_list;
+	Vector<Ref<BTTask>> dragged;
 	for (int i = 0; i < p_tasks.size(); i++) {
-		Ref<BTTask> task = p_tasks[i];
-		bool remove = false;
-		for (int s_idx = 0; s_idx < p_tasks.size(); s_idx++) {
-			Ref<BTTask> selected = p_tasks[s_idx];
-			if (task->is_descendant_of(selected)) {
-				remove = true;
-				break;
-			}
-		}
-		if (!remove) {
-			tasks_list.push_back(task);
-		}
+		dragged.push_back(p_tasks[i]);
 	}
+	Vector<Ref<BTTask>> tasks_list = _exclude_descendants(dragged);
 
 	EditorUndoRedoManager *undo_redo = _new_undo_redo_action(TTR("Drag BT Task"));
 
@@ -960,6 +1038,16 @@ void LimboAIEditor::_on_resources_reload(const PackedStringArray &p_resources) {
 }
 
 void LimboAIEditor::_on_filesystem_changed() {
+	// * Scripts may have been modified, changing the properties of the tasks.
+	BTTask::clear_property_cache();
+	LimboUtility::get_singleton()->clear_task_icon_cache();
+
+	// * Tasks may have been added or removed: the palette is rebuilt only if the user task lists changed.
+	LimboTaskDB::invalidate_user_tasks();
+	if (task_palette->is_visible_in_tree()) {
+		task_palette->refresh();
+	}
+
 	if (history.size() == 0) {
 		return;
 	}
@@ -978,14 +1066,23 @@ void LimboAIEditor::_on_new_script_pressed() {
 void LimboAIEditor::_task_type_selected(const String &p_class_or_path) {
 	change_type_popup->hide();
 
-	Ref<BTTask> selected_task = task_tree->get_selected();
-	ERR_FAIL_COND(selected_task.is_null());
-	Ref<BTTask> new_task = _create_task_by_class_or_path(p_class_or_path);
-	ERR_FAIL_COND_MSG(new_task.is_null(), "LimboAI: Unable to construct task.");
+	Vector<Ref<BTTask>> selected_tasks = task_tree->get_selected_tasks();
+	ERR_FAIL_COND(selected_tasks.is_empty());
+	Vector<Ref<BTTask>> new_tasks;
+	for (int i = 0; i < selected_tasks.size(); i++) {
+		Ref<BTTask> new_task = _create_task_by_class_or_path(p_class_or_path);
+		ERR_FAIL_COND_MSG(new_task.is_null(), "LimboAI: Unable to construct task.");
+		new_tasks.push_back(new_task);
+	}
 
+	// * Replacements run parents first, and are undone in reverse order, so nested selections work too.
 	EditorUndoRedoManager *undo_redo = _new_undo_redo_action(TTR("Change BT task type"));
-	undo_redo->add_do_method(this, LW_NAME(_replace_task), selected_task, new_task);
-	undo_redo->add_undo_method(this, LW_NAME(_replace_task), new_task, selected_task);
+	for (int i = 0; i < selected_tasks.size(); i++) {
+		undo_redo->add_do_method(this, LW_NAME(_replace_task), selected_tasks[i], new_tasks[i]);
+	}
+	for (int i = selected_tasks.size() - 1; i >= 0; i--) {
+		undo_redo->add_undo_method(this, LW_NAME(_replace_task), new_tasks[i], selected_tasks[i]);
+	}
 	_commit_action_with_update(undo_redo);
 }
 
@@ -1031,12 +1128,35 @@ void LimboAIEditor::_replace_task(const Ref<BTTask> &p_task, const Ref<BTTask> &
 	}
 }
 
+String LimboAIEditor::_get_history_path(int p_idx) const {
+	ERR_FAIL_INDEX_V(p_idx, history.size(), String());
+	return history[p_idx].is_valid() ? history[p_idx]->get_path() : history_paths[p_idx];
+}
+
+Ref<BehaviorTree> LimboAIEditor::_get_history_bt(int p_idx) {
+	ERR_FAIL_INDEX_V(p_idx, history.size(), nullptr);
+	if (history[p_idx].is_null()) {
+		Ref<BehaviorTree> bt = RESOURCE_LOAD(history_paths[p_idx], "BehaviorTree");
+		ERR_FAIL_COND_V_MSG(bt.is_null(), nullptr, "LimboAIEditor: Failed to load behavior tree: " + history_paths[p_idx]);
+		if (bt->get_blackboard_plan().is_null()) {
+			bt->set_blackboard_plan(memnew(BlackboardPlan));
+		}
+		history.write[p_idx] = bt;
+	}
+	return history[p_idx];
+}
+
 void LimboAIEditor::_tab_clicked(int p_tab) {
 	if (updating_tabs) {
 		return;
 	}
 	ERR_FAIL_INDEX(p_tab, history.size());
-	EDIT_RESOURCE(history[p_tab]);
+	Ref<BehaviorTree> bt = _get_history_bt(p_tab);
+	if (bt.is_valid()) {
+		EDIT_RESOURCE(bt);
+	} else {
+		_tab_closed(p_tab);
+	}
 }
 
 void LimboAIEditor::_tab_closed(int p_tab) {
@@ -1046,11 +1166,13 @@ void LimboAIEditor::_tab_closed(int p_tab) {
 		history_bt->disconnect(LW_NAME(changed), callable_mp(this, &LimboAIEditor::_mark_as_dirty));
 	}
 	history.remove_at(p_tab);
+	history_paths.remove_at(p_tab);
 	idx_history = MIN(idx_history, history.size() - 1);
-	if (idx_history < 0) {
+	Ref<BehaviorTree> next_bt = idx_history >= 0 ? _get_history_bt(idx_history) : Ref<BehaviorTree>();
+	if (next_bt.is_null()) {
 		_disable_editing();
 	} else {
-		EDIT_RESOURCE(history[idx_history]);
+		EDIT_RESOURCE(next_bt);
 	}
 	_update_tabs();
 }
@@ -1065,10 +1187,11 @@ void LimboAIEditor::_update_tabs() {
 
 	for (int i = 0; i < history.size(); i++) {
 		String tab_name;
-		if (history[i]->get_path().contains("::")) {
-			tab_name = history[i]->get_path().get_file();
+		const String path = _get_history_path(i);
+		if (path.contains("::")) {
+			tab_name = path.get_file();
 		} else {
-			tab_name = history[i]->get_path().get_file().get_basename();
+			tab_name = path.get_file().get_basename();
 		}
 		short_names.append(tab_name);
 		if (usage_counts.has(tab_name)) {
@@ -1084,7 +1207,7 @@ void LimboAIEditor::_update_tabs() {
 			tab_name = "[new]";
 		} else if (usage_counts[tab_name] > 1) {
 			// Use the full name if the short name is not unique.
-			tab_name = history[i]->get_path().trim_prefix("res://");
+			tab_name = _get_history_path(i).trim_prefix("res://");
 		}
 		tab_bar->add_tab(tab_name, LimboUtility::get_singleton()->get_task_icon("BehaviorTree"));
 		if (i == idx_history) {
@@ -1106,8 +1229,11 @@ void LimboAIEditor::_move_active_tab(int p_to_index) {
 		return;
 	}
 	Ref<BehaviorTree> bt = history[idx_history];
+	String path = history_paths[idx_history];
 	history.remove_at(idx_history);
+	history_paths.remove_at(idx_history);
 	history.insert(p_to_index, bt);
+	history_paths.insert(p_to_index, path);
 	idx_history = p_to_index;
 	_update_tabs();
 }
@@ -1131,6 +1257,7 @@ void LimboAIEditor::_tab_input(const Ref<InputEvent> &p_input) {
 void LimboAIEditor::_show_tab_context_menu() {
 	tab_menu->clear();
 	tab_menu->add_shortcut(LW_GET_SHORTCUT("limbo_ai/jump_to_owner"), TabMenu::TAB_JUMP_TO_OWNER);
+	tab_menu->add_item(TTR("Find Usages as Subtree"), TabMenu::TAB_FIND_SUBTREE_USAGES);
 	tab_menu->add_item(TTR("Show in FileSystem"), TabMenu::TAB_SHOW_IN_FILESYSTEM);
 	tab_menu->add_separator();
 	tab_menu->add_shortcut(LW_GET_SHORTCUT("limbo_ai/close_tab"), TabMenu::TAB_CLOSE);
@@ -1151,38 +1278,50 @@ void LimboAIEditor::_tab_menu_option_selected(int p_id) {
 
 	switch (p_id) {
 		case TAB_SHOW_IN_FILESYSTEM: {
-			Ref<BehaviorTree> bt = history[idx_history];
-			String path = bt->get_path();
+			String path = _get_history_path(idx_history);
 			if (!path.is_empty()) {
 				FS_DOCK_SELECT_FILE(path.get_slice("::", 0));
 			}
 		} break;
 		case TAB_JUMP_TO_OWNER: {
-			Ref<BehaviorTree> bt = history[idx_history];
-			ERR_FAIL_NULL(bt);
-			String bt_path = bt->get_path();
+			String bt_path = _get_history_path(idx_history);
 			if (!bt_path.is_empty()) {
 				owner_picker->pick_and_open_owner_of_resource(bt_path);
 			}
 		} break;
+		case TAB_FIND_SUBTREE_USAGES: {
+			String bt_path = _get_history_path(idx_history);
+			if (!bt_path.is_empty()) {
+				String title = TTR("Pick tree");
+				if (!bt_index->is_up_to_date()) {
+					title += " " + TTR("(index is still updating)");
+				}
+				owner_picker->pick_and_open_resource(bt_index->find_subtree_usages(bt_path), title, TTR("No behavior tree uses this tree as a subtree."));
+			}
+		} break;
 		case TAB_CLOSE: {
 			_tab_closed(idx_history);
 		} break;
 		case TAB_CLOSE_OTHER: {
 			Ref<BehaviorTree> bt = history[idx_history];
+			String path = history_paths[idx_history];
 			history.clear();
+			history_paths.clear();
 			history.append(bt);
+			history_paths.append(path);
 			idx_history = 0;
 			_update_tabs();
 		} break;
 		case TAB_CLOSE_RIGHT: {
 			for (int i = history.size() - 1; i > idx_history; i--) {
 				history.remove_at(i);
+				history_paths.remove_at(i);
 			}
 			_update_tabs();
 		} break;
 		case TAB_CLOSE_ALL: {
 			history.clear();
+			history_paths.clear();
 			idx_history = -1;
 			_disable_editing();
 			_update_tabs();
@@ -1191,21 +1330,25 @@ void LimboAIEditor::_tab_menu_option_selected(int p_id) {
 }
 
 void LimboAIEditor::_tab_plan_edited(int p_tab) {
-	ERR_FAIL_INDEX(p_tab, history.size());
-	if (history[p_tab]->get_blackboard_plan().is_valid()) {
-		EDIT_RESOURCE(history[p_tab]->get_blackboard_plan());
+	Ref<BehaviorTree> bt = _get_history_bt(p_tab);
+	if (bt.is_valid() && bt->get_blackboard_plan().is_valid()) {
+		EDIT_RESOURCE(bt->get_blackboard_plan());
 	}
 }
 
 void LimboAIEditor::_reload_modified() {
 	for (const String &res_path : disk_changed_files) {
 		Ref<BehaviorTree> res = RESOURCE_LOAD(res_path, "BehaviorTree");
-		if (res.is_valid()) {
+		if (res.is_null()) {
+			continue;
+		}
+		if (idx_history >= 0 && history.get(idx_history) == res) {
 			Ref<BehaviorTree> reloaded = RESOURCE_LOAD_NO_CACHE(res_path, "BehaviorTree");
 			res->copy_other(reloaded);
-			if (idx_history >= 0 && history.get(idx_history) == res) {
-				edit_bt(res, true);
-			}
+			edit_bt(res, true);
+		} else {
+			// * Inactive tabs are reloaded by edit_bt() when they are shown.
+			pending_reloads.insert(res_path);
 		}
 	}
 	disk_changed_files.clear();
@@ -1245,7 +1388,13 @@ void LimboAIEditor::_rename_task_confirmed() {
 void LimboAIEditor::apply_changes() {
 	for (int i = 0; i < history.size(); i++) {
 		Ref<BehaviorTree> bt = history.get(i);
+		if (bt.is_null()) {
+			continue; // Not loaded yet.
+		}
 		String path = bt->get_path();
+		if (pending_reloads.has(path)) {
+			continue; // The file on disk is newer.
+		}
 		if (RESOURCE_EXISTS(path, "BehaviorTree")) {
 			RESOURCE_SAVE(bt, path, 0);
 		}
@@ -1392,7 +1541,7 @@ void LimboAIEditor::_notification(int p_what) {
 		case NOTIFICATION_EXIT_TREE: {
 			task_tree->unload();
 			for (int i = 0; i < history.size(); i++) {
-				if (history[i]->is_connected(LW_NAME(changed), callable_mp(this, &LimboAIEditor::_mark_as_dirty))) {
+				if (history[i].is_valid() && history[i]->is_connected(LW_NAME(changed), callable_mp(this, &LimboAIEditor::_mark_as_dirty))) {
 					history[i]->disconnect(LW_NAME(changed), callable_mp(this, &LimboAIEditor::_mark_as_dirty));
 				}
 			}
@@ -1635,6 +1784,9 @@ LimboAIEditor::LimboAIEditor() {
 	owner_picker = memnew(OwnerPicker);
 	add_child(owner_picker);
 
+	bt_index = memnew(BehaviorTreeIndex);
+	add_child(bt_index);
+
 	hsc = memnew(HSplitContainer);
 	hsc->set_h_size_flags(SIZE_EXPAND_FILL);
 	hsc->set_v_size_flags(SIZE_EXPAND_FILL);
@@ -1803,6 +1955,8 @@ LimboAIEditor::LimboAIEditor() {
 	GLOBAL_DEF(PropertyInfo(Variant::STRING, "limbo_ai/behavior_tree/user_task_dir_1", PROPERTY_HINT_DIR), "res://ai/tasks");
 	GLOBAL_DEF(PropertyInfo(Variant::STRING, "limbo_ai/behavior_tree/user_task_dir_2", PROPERTY_HINT_DIR), "");
 	GLOBAL_DEF(PropertyInfo(Variant::STRING, "limbo_ai/behavior_tree/user_task_dir_3", PROPERTY_HINT_DIR), "");
+	GLOBAL_DEF(PropertyInfo(Variant::BOOL, "limbo_ai/behavior_tree/optimize_on_export"), false);
+	GLOBAL_DEF(PropertyInfo(Variant::BOOL, "limbo_ai/behavior_tree/lint_on_export"), true);
 
 	String bt_default_dir = GLOBAL_GET("limbo_ai/behavior_tree/behavior_tree_default_dir");
 	save_dialog->set_current_dir(bt_default_dir);
@@ -1816,6 +1970,44 @@ LimboAIEditor::~LimboAIEditor() {
 
 //**** LimboAIEditor ^
 
+//**** LimboAIExportPlugin
+
+#ifdef LIMBOAI_MODULE
+bool LimboAIExportPlugin::_begin_customize_resources(const Ref<EditorExportPlatform> &p_platform, const Vector<String> &p_features) {
+#elif LIMBOAI_GDEXTENSION
+bool LimboAIExportPlugin::_begin_customize_resources(const Ref<EditorExportPlatform> &p_platform, const PackedStringArray &p_features) {
+#endif
+	optimize = GLOBAL_GET("limbo_ai/behavior_tree/optimize_on_export");
+	lint = GLOBAL_GET("limbo_ai/behavior_tree/lint_on_export");
+	return optimize || lint;
+}
+
+Ref<Resource> LimboAIExportPlugin::_customize_resource(const Ref<Resource> &p_resource, const String &p_path) {
+	Ref<BehaviorTree> bt = p_resource;
+	if (bt.is_null() || bt->get_root_task().is_null()) {
+		return Ref<Resource>();
+	}
+	if (lint) {
+		// * Printed, so that performance hazards show up in headless exports too.
+		const Dictionary report = bt->analyze_cost();
+		const PackedStringArray warnings = report["warnings"];
+		for (int i = 0; i < warnings.size(); i++) {
+			WARN_PRINT(vformat("LimboAI: %s: %s", p_path, warnings[i]));
+		}
+	}
+	if (!optimize) {
+		return Ref<Resource>();
+	}
+	// Optimize a copy: the exported project must not modify the edited resource.
+	Ref<BehaviorTree> copy = bt->clone();
+	if (copy->optimize() == 0) {
+		return Ref<Resource>();
+	}
+	return copy;
+}
+
+//**** LimboAIExportPlugin ^
+
 //**** LimboAIEditorPlugin
 
 #ifdef LIMBOAI_MODULE
@@ -1832,7 +2024,9 @@ void LimboAIEditorPlugin::_bind_methods() {
 void LimboAIEditorPlugin::_notification(int p_notification) {
 	switch (p_notification) {
 		case NOTIFICATION_READY: {
-			add_debugger_plugin(memnew(LimboDebuggerPlugin));
+			LimboDebuggerPlugin *debugger_plugin = memnew(LimboDebuggerPlugin);
+			add_debugger_plugin(debugger_plugin);
+			debugger_plugin->connect(LW_NAME(task_costs_changed), callable_mp(limbo_ai_editor, &LimboAIEditor::update_task_costs));
 			add_inspector_plugin(memnew(EditorInspectorPluginBBPlan));
 			EditorInspectorPluginVariableName *var_plugin = memnew(EditorInspectorPluginVariableName);
 			var_plugin->set_editor_plan_provider(Callable(limbo_ai_editor, "get_edited_blackboard_plan"));
@@ -1845,6 +2039,9 @@ void LimboAIEditorPlugin::_notification(int p_notification) {
 #endif // LIMBOAI_MODULE
 		} break;
 		case NOTIFICATION_ENTER_TREE: {
+			export_plugin.instantiate();
+			add_export_plugin(export_plugin);
+
 			// Add BehaviorTree to the list of resources that should open in a new inspector.
 			PackedStringArray open_in_new_inspector = EDITOR_GET("interface/inspector/resources_to_open_in_new_inspector");
 			if (!open_in_new_inspector.has("BehaviorTree")) {
@@ -1852,6 +2049,10 @@ void LimboAIEditorPlugin::_notification(int p_notification) {
 				EDITOR_SETTINGS()->set_setting("interface/inspector/resources_to_open_in_new_inspector", open_in_new_inspector);
 			}
 		} break;
+		case NOTIFICATION_EXIT_TREE: {
+			remove_export_plugin(export_plugin);
+			export_plugin.unref();
+		} break;
 	}
 }
 
@@ -16,6 +16,7 @@
 
 #include "../bt/behavior_tree.h"
 #include "../bt/tasks/bt_task.h"
+#include "behavior_tree_index.h"
 #include "editor_property_variable_name.h"
 #include "owner_picker.h"
 #include "task_palette.h"
@@ -27,6 +28,7 @@
 #include "core/templates/hash_set.h"
 #include "editor/editor_node.h"
 #include "editor/editor_undo_redo_manager.h"
+#include "editor/export/editor_export_plugin.h"
 #include "editor/gui/editor_spin_slider.h"
 #include "editor/plugins/editor_plugin.h"
 #include "scene/gui/box_container.h"
@@ -48,6 +50,8 @@
 #ifdef LIMBOAI_GDEXTENSION
 #include "godot_cpp/classes/accept_dialog.hpp"
 #include <godot_cpp/classes/control.hpp>
+#include <godot_cpp/classes/editor_export_platform.hpp>
+#include <godot_cpp/classes/editor_export_plugin.hpp>
 #include <godot_cpp/classes/editor_plugin.hpp>
 #include <godot_cpp/classes/editor_spin_slider.hpp>
 #include <godot_cpp/classes/editor_undo_redo_manager.hpp>
@@ -105,6 +109,7 @@ private:
 	enum TabMenu {
 		TAB_SHOW_IN_FILESYSTEM,
 		TAB_JUMP_TO_OWNER,
+		TAB_FIND_SUBTREE_USAGES,
 		TAB_CLOSE,
 		TAB_CLOSE_OTHER,
 		TAB_CLOSE_RIGHT,
@@ -139,9 +144,12 @@ private:
 	EditorPlugin *plugin;
 	EditorLayout editor_layout;
 	Vector<Ref<BehaviorTree>> history;
+	// Resource paths of tabs, parallel to history. Entries restored from the layout stay null in history until activated.
+	Vector<String> history_paths;
 	int idx_history;
 	bool updating_tabs = false;
 	bool request_update_tabs = false;
+	bool task_tree_update_queued = false;
 	HashSet<Ref<BehaviorTree>> dirty;
 	Ref<BTTask> clipboard_task;
 
@@ -152,6 +160,7 @@ private:
 	TabBar *tab_bar;
 	PopupMenu *tab_menu;
 	OwnerPicker *owner_picker;
+	BehaviorTreeIndex *bt_index;
 	HSplitContainer *hsc;
 	TaskTree *task_tree;
 	VBoxContainer *banners;
@@ -184,6 +193,8 @@ private:
 	ConfirmationDialog *disk_changed;
 	Tree *disk_changed_list;
 	HashSet<String> disk_changed_files;
+	// Trees modified on disk that are reloaded the next time they are shown.
+	HashSet<String> pending_reloads;
 
 	AcceptDialog *info_dialog;
 
@@ -204,6 +215,9 @@ private:
 	void _save_bt(String p_path);
 	void _load_bt(String p_path);
 	void _update_task_tree(const Ref<BehaviorTree> &p_bt, const Ref<BTTask> &p_specific_task = nullptr);
+	void _flush_task_tree_update();
+	static Vector<Ref<BTTask>> _exclude_descendants(const Vector<Ref<BTTask>> &p_tasks);
+	void _add_remove_tasks_to_action(EditorUndoRedoManager *p_undo_redo, const Vector<Ref<BTTask>> &p_tasks);
 	void _disable_editing();
 	void _mark_as_dirty(bool p_dirty);
 	void _create_user_task_dir();
@@ -214,6 +228,8 @@ private:
 
 	void _tab_clicked(int p_tab);
 	void _tab_closed(int p_tab);
+	String _get_history_path(int p_idx) const;
+	Ref<BehaviorTree> _get_history_bt(int p_idx);
 	void _update_tabs();
 	void _move_active_tab(int p_to_index);
 	void _tab_input(const Ref<InputEvent> &p_input);
@@ -264,6 +280,7 @@ public:
 	void set_plugin(EditorPlugin *p_plugin) { plugin = p_plugin; };
 	void edit_bt(const Ref<BehaviorTree> &p_behavior_tree, bool p_force_refresh = false);
 	Ref<BlackboardPlan> get_edited_blackboard_plan();
+	void update_task_costs();
 	void set_window_layout(const Ref<ConfigFile> &p_configuration);
 	void get_window_layout(const Ref<ConfigFile> &p_configuration);
 
@@ -277,11 +294,35 @@ public:
 	~LimboAIEditor();
 };
 
+// Exports optimized copies of behavior trees if "limbo_ai/behavior_tree/optimize_on_export" is enabled.
+class LimboAIExportPlugin : public EditorExportPlugin {
+	GDCLASS(LimboAIExportPlugin, EditorExportPlugin);
+
+private:
+	bool optimize = false;
+	bool lint = false;
+
+protected:
+	static void _bind_methods() {}
+
+public:
+#ifdef LIMBOAI_MODULE
+	virtual String get_name() const override { return "LimboAI"; }
+	virtual bool _begin_customize_resources(const Ref<EditorExportPlatform> &p_platform, const Vector<String> &p_features) override;
+#elif LIMBOAI_GDEXTENSION
+	virtual String _get_name() const override { return "LimboAI"; }
+	virtual bool _begin_customize_resources(const Ref<EditorExportPlatform> &p_platform, const PackedStringArray &p_features) override;
+#endif // LIMBOAI_MODULE & LIMBOAI_GDEXTENSION
+	virtual Ref<Resource> _customize_resource(const Ref<Resource> &p_resource, const String &p_path) override;
+	virtual uint64_t _get_customization_configuration_hash() const override { return (optimize ? 1 : 0) | (lint ? 2 : 0); }
+};
+
 class LimboAIEditorPlugin : public EditorPlugin {
 	GDCLASS(LimboAIEditorPlugin, EditorPlugin);
 
 private:
 	LimboAIEditor *limbo_ai_editor;
+	Ref<LimboAIExportPlugin> export_plugin;
 
 protected:
 	static void _bind_methods();
@@ -77,12 +77,13 @@ void OwnerPicker::pick_and_open_owner_of_resource(const String &p_path) {
 	if (p_path.is_empty()) {
 		return;
 	}
+	pick_and_open_resource(_find_owners(p_path), TTR("Pick owner"), TTR("Couldn't find owner. Looks like it's not used by any other resource."));
+}
 
+void OwnerPicker::pick_and_open_resource(const Vector<String> &p_paths, const String &p_title, const String &p_not_found_text) {
 	owners_item_list->clear();
-
-	Vector<String> owners = _find_owners(p_path);
-	for (int i = 0; i < owners.size(); i++) {
-		owners_item_list->add_item(owners[i]);
+	for (int i = 0; i < p_paths.size(); i++) {
+		owners_item_list->add_item(p_paths[i]);
 	}
 
 	if (owners_item_list->get_item_count() > 0) {
@@ -96,12 +97,12 @@ void OwnerPicker::pick_and_open_owner_of_resource(const String &p_path) {
 	} else if (owners_item_list->get_item_count() == 0) {
 		owners_item_list->hide();
 		set_title(TTR("Alert!"));
-		set_text(TTR("Couldn't find owner. Looks like it's not used by any other resource."));
+		set_text(p_not_found_text);
 		reset_size();
 		popup_centered();
 	} else {
 		owners_item_list->show();
-		set_title(TTR("Pick owner"));
+		set_title(p_title);
 		set_text("");
 		reset_size();
 		popup_centered_ratio(0.3);
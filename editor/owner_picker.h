@@ -40,6 +40,8 @@ protected:
 
 public:
 	void pick_and_open_owner_of_resource(const String &p_path);
+	// Opens the only resource in p_paths, or lets the user pick one of them.
+	void pick_and_open_resource(const Vector<String> &p_paths, const String &p_title, const String &p_not_found_text);
 
 	OwnerPicker();
 };
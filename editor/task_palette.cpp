@@ -164,36 +164,67 @@ void TaskPaletteSection::_on_header_pressed() {
 	set_collapsed(!is_collapsed());
 }
 
-void TaskPaletteSection::set_filter(String p_filter_text) {
-	int num_hidden = 0;
-	if (p_filter_text.is_empty()) {
-		for (int i = 0; i < tasks_container->get_child_count(); i++) {
-			Object::cast_to<Button>(tasks_container->get_child(i))->show();
+bool TaskPaletteSection::_fuzzy_match(const String &p_key, const String &p_filter) {
+	// * Every character of the filter must appear in the key, in the same order.
+	const char32_t *key = p_key.ptr();
+	const char32_t *filter = p_filter.ptr();
+	const int key_len = p_key.length();
+	const int filter_len = p_filter.length();
+	int f = 0;
+	for (int k = 0; k < key_len && f < filter_len; k++) {
+		if (key[k] == filter[f]) {
+			f++;
 		}
-		set_visible(tasks_container->get_child_count() > 0);
-	} else {
-		for (int i = 0; i < tasks_container->get_child_count(); i++) {
-			Button *btn = Object::cast_to<Button>(tasks_container->get_child(i));
-			btn->set_visible(btn->get_text().findn(p_filter_text) != -1);
-			num_hidden += !btn->is_visible();
+	}
+	return f == filter_len;
+}
+
+void TaskPaletteSection::set_filter(String p_filter_text) {
+	const String filter = p_filter_text.to_lower();
+	const bool show_all = filter.is_empty() || category_key.find(filter) != -1;
+	int num_visible = 0;
+	for (TaskItem &item : tasks) {
+		item.visible = show_all || _fuzzy_match(item.search_key, filter);
+		num_visible += item.visible;
+		if (item.button) {
+			item.button->set_visible(item.visible);
 		}
-		set_visible(num_hidden < tasks_container->get_child_count());
 	}
+	set_visible(num_visible > 0);
 }
 
-void TaskPaletteSection::add_task_button(const String &p_name, const Ref<Texture> &icon, const String &p_meta) {
+void TaskPaletteSection::_create_button(TaskItem &p_item) {
 	TaskButton *btn = memnew(TaskButton);
-	btn->set_text(p_name);
-	BUTTON_SET_ICON(btn, icon);
+	btn->set_text(p_item.name);
+	BUTTON_SET_ICON(btn, LimboUtility::get_singleton()->get_task_icon(p_item.meta));
 	btn->set_tooltip_text("dummy_text"); // Force tooltip to be shown.
-	btn->set_task_meta(p_meta);
+	btn->set_task_meta(p_item.meta);
 	btn->add_theme_constant_override(LW_NAME(icon_max_width), 16 * EDSCALE); // Force user icons to  be of the proper size.
-	btn->connect(LW_NAME(pressed), callable_mp(this, &TaskPaletteSection::_on_task_button_pressed).bind(p_meta));
-	btn->connect(LW_NAME(gui_input), callable_mp(this, &TaskPaletteSection::_on_task_button_gui_input).bind(p_meta));
+	btn->connect(LW_NAME(pressed), callable_mp(this, &TaskPaletteSection::_on_task_button_pressed).bind(p_item.meta));
+	btn->connect(LW_NAME(gui_input), callable_mp(this, &TaskPaletteSection::_on_task_button_gui_input).bind(p_item.meta));
+	btn->set_visible(p_item.visible);
 	tasks_container->add_child(btn);
+	p_item.button = btn;
+}
+
+void TaskPaletteSection::add_task_button(const String &p_name, const String &p_meta) {
+	TaskItem item;
+	item.name = p_name;
+	item.search_key = p_name.to_lower();
+	item.meta = p_meta;
+	tasks.push_back(item);
+	if (buttons_created) {
+		_create_button(tasks[tasks.size() - 1]);
+	}
 }
 
 void TaskPaletteSection::set_collapsed(bool p_collapsed) {
+	if (!p_collapsed && !buttons_created) {
+		buttons_created = true;
+		for (TaskItem &item : tasks) {
+			_create_button(item);
+		}
+	}
 	tasks_container->set_visible(!p_collapsed);
 	BUTTON_SET_ICON(section_header, (p_collapsed ? theme_cache.arrow_right_icon : theme_cache.arrow_down_icon));
 }
@@ -419,7 +450,15 @@ void TaskPalette::_category_item_toggled(bool p_pressed, const String &p_categor
 	_filter_data_changed();
 }
 
+void TaskPalette::_on_refresh_pressed() {
+	// * Directories may have changed outside of the editor's file system.
+	LimboTaskDB::invalidate_user_tasks();
+	rebuild_requested = true;
+	refresh();
+}
+
 void TaskPalette::_filter_data_changed() {
+	rebuild_requested = true;
 	callable_mp(this, &TaskPalette::refresh).call_deferred();
 	_update_filter_button();
 }
@@ -435,6 +474,15 @@ void TaskPalette::_update_filter_button() {
 }
 
 void TaskPalette::refresh() {
+	LimboTaskDB::scan_user_tasks();
+	if (!rebuild_requested && tasks_version == LimboTaskDB::get_tasks_version()) {
+		// * Nothing changed: keep sections and buttons, only reapply the text filter.
+		_apply_filter(filter_edit->get_text());
+		return;
+	}
+	rebuild_requested = false;
+	tasks_version = LimboTaskDB::get_tasks_version();
+
 	HashSet<String> collapsed_sections;
 	if (sections->get_child_count() == 0) {
 		// Restore collapsed state from config.
@@ -463,7 +511,6 @@ void TaskPalette::refresh() {
 		}
 	}
 
-	LimboTaskDB::scan_user_tasks();
 	List<String> categories = LimboTaskDB::get_categories();
 	categories.sort();
 
@@ -480,8 +527,6 @@ void TaskPalette::refresh() {
 		TaskPaletteSection *sec = memnew(TaskPaletteSection());
 		sec->set_category_name(cat);
 		for (const String &task_meta : tasks) {
-			Ref<Texture2D> icon = LimboUtility::get_singleton()->get_task_icon(task_meta);
-
 			String tname;
 
 			if (task_meta.begins_with("res:")) {
@@ -496,7 +541,7 @@ void TaskPalette::refresh() {
 				tname = task_meta.trim_prefix("BT");
 			}
 
-			sec->add_task_button(tname, icon, task_meta);
+			sec->add_task_button(tname, task_meta);
 		}
 		sec->set_filter("");
 		sec->connect(LW_NAME(task_button_pressed), callable_mp(this, &TaskPalette::_on_task_button_pressed));
@@ -531,7 +576,7 @@ void TaskPalette::_notification(int p_what) {
 			// **** Signals
 			tool_filters->connect(LW_NAME(pressed), callable_mp(this, &TaskPalette::_show_filter_popup));
 			filter_edit->connect(LW_NAME(text_changed), callable_mp(this, &TaskPalette::_apply_filter));
-			tool_refresh->connect(LW_NAME(pressed), callable_mp(this, &TaskPalette::refresh));
+			tool_refresh->connect(LW_NAME(pressed), callable_mp(this, &TaskPalette::_on_refresh_pressed));
 			menu->connect(LW_NAME(id_pressed), callable_mp(this, &TaskPalette::_menu_action_selected));
 			type_all->connect(LW_NAME(pressed), callable_mp(this, &TaskPalette::_type_filter_changed));
 			type_core->connect(LW_NAME(pressed), callable_mp(this, &TaskPalette::_type_filter_changed));
@@ -610,6 +655,7 @@ void TaskPalette::_notification(int p_what) {
 
 			category_choice->queue_redraw();
 
+			rebuild_requested = true;
 			if (is_visible_in_tree()) {
 				refresh();
 			}
@@ -15,6 +15,7 @@
 #define TASK_PALETTE_H
 
 #ifdef LIMBOAI_MODULE
+#include "core/templates/local_vector.h"
 #include "scene/gui/box_container.h"
 #include "scene/gui/button.h"
 #include "scene/gui/check_box.h"
@@ -35,6 +36,7 @@
 #include <godot_cpp/classes/texture2d.hpp>
 #include <godot_cpp/classes/v_box_container.hpp>
 #include <godot_cpp/templates/hash_set.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
 using namespace godot;
 #endif // LIMBOAI_GDEXTENSION
 
@@ -75,9 +77,24 @@ private:
 		Ref<Texture2D> arrow_right_icon;
 	} theme_cache;
 
+	struct TaskItem {
+		String name;
+		String search_key; // Lowercase name.
+		String meta;
+		TaskButton *button = nullptr;
+		bool visible = true;
+	};
+
+	// Buttons are created only once the section is first expanded.
+	LocalVector<TaskItem> tasks;
+	bool buttons_created = false;
+	String category_key;
+
 	FlowContainer *tasks_container;
 	Button *section_header;
 
+	static bool _fuzzy_match(const String &p_key, const String &p_filter);
+	void _create_button(TaskItem &p_item);
 	void _on_task_button_pressed(const String &p_task);
 	void _on_task_button_gui_input(const Ref<InputEvent> &p_event, const String &p_task);
 	void _on_header_pressed();
@@ -91,13 +108,16 @@ protected:
 
 public:
 	void set_filter(String p_filter);
-	void add_task_button(const String &p_name, const Ref<Texture> &icon, const String &p_meta);
+	void add_task_button(const String &p_name, const String &p_meta);
 
 	void set_collapsed(bool p_collapsed);
 	bool is_collapsed() const;
 
 	String get_category_name() const { return section_header->get_text(); }
-	void set_category_name(const String &p_cat) { section_header->set_text(p_cat); }
+	void set_category_name(const String &p_cat) {
+		section_header->set_text(p_cat);
+		category_key = p_cat.to_lower();
+	}
 
 	TaskPaletteSection();
 	~TaskPaletteSection();
@@ -160,10 +180,14 @@ private:
 
 	String context_task;
 	bool dialog_mode = false;
+	// LimboTaskDB version the sections were built from; sections are rebuilt only when it changes.
+	uint32_t tasks_version = 0;
+	bool rebuild_requested = true;
 
 	void _menu_action_selected(int p_id);
 	void _on_task_button_pressed(const String &p_task);
 	void _on_task_button_rmb(const String &p_task);
+	void _on_refresh_pressed();
 	void _apply_filter(const String &p_text);
 	void _update_filter_popup();
 	void _show_filter_popup();
@@ -42,6 +42,7 @@ TreeItem *TaskTree::_create_tree(const Ref<BTTask> &p_task, TreeItem *p_parent,
 	ERR_FAIL_COND_V(p_task.is_null(), nullptr);
 	TreeItem *item = tree->create_item(p_parent, p_idx);
 	item->set_metadata(0, p_task);
+	item_map[p_task->get_instance_id()] = item;
 	for (int i = 0; i < p_task->get_child_count(); i++) {
 		_create_tree(p_task->get_child(i), item);
 	}
@@ -59,7 +60,12 @@ void TaskTree::_update_item(TreeItem *p_item) {
 		if (sel.is_valid() && sel->has_probability(p_item->get_index())) {
 			p_item->set_custom_draw_callback(0, callable_mp(this, &TaskTree::_draw_probability));
 			p_item->set_cell_mode(0, TreeItem::CELL_MODE_CUSTOM);
+		} else if (p_item->get_cell_mode(0) == TreeItem::CELL_MODE_CUSTOM) {
+			// * Reused item moved out of a probability selector.
+			p_item->set_cell_mode(0, TreeItem::CELL_MODE_STRING);
 		}
+	} else if (p_item->get_cell_mode(0) == TreeItem::CELL_MODE_CUSTOM) {
+		p_item->set_cell_mode(0, TreeItem::CELL_MODE_STRING);
 	}
 
 	Ref<BTTask> task = p_item->get_metadata(0);
@@ -105,19 +111,156 @@ void TaskTree::_update_item(TreeItem *p_item) {
 	if (!warning_text.is_empty()) {
 		p_item->add_button(0, theme_cache.task_warning_icon, 0, false, warning_text);
 	}
+
+	_update_item_cost(p_item, task);
+}
+
+void TaskTree::_update_item_cost(TreeItem *p_item, const Ref<BTTask> &p_task) {
+	const TaskCost *cost = task_costs.getptr(p_task->get_instance_id());
+	if (cost == nullptr || max_self_usec == 0) {
+		p_item->clear_custom_bg_color(0);
+		p_item->set_tooltip_text(0, String());
+		return;
+	}
+	const double heat = double(cost->self_usec) / double(max_self_usec);
+	p_item->set_custom_bg_color(0, theme_cache.heat_color * Color(1, 1, 1, 0.6 * heat));
+	p_item->set_tooltip_text(0, vformat(TTR("Self time: %.2f ms\nTicks: %d"), double(cost->self_usec) * 0.001, int64_t(cost->ticks)));
+}
+
+// Matches the tasks of the edited tree with the depth-first report of an instance. Instances don't have comments,
+// but carry the tasks of their subtrees, so these are skipped. Stops at the first task that doesn't match,
+// which happens when the tree was edited since the game started.
+bool TaskTree::_map_task_costs(const Ref<BTTask> &p_task, int p_depth, const CostReport &p_report, int &r_index) {
+	if (IS_CLASS(p_task, BTComment)) {
+		return true;
+	}
+	if (r_index >= p_report.names.size() || p_report.depths[r_index] != p_depth || p_report.names[r_index] != p_task->get_task_name()) {
+		return false;
+	}
+	TaskCost cost;
+	cost.ticks = p_report.ticks[r_index];
+	cost.self_usec = p_report.self_usec[r_index];
+	task_costs.insert(p_task->get_instance_id(), cost);
+	max_self_usec = MAX(max_self_usec, cost.self_usec);
+	r_index += 1;
+
+	for (int i = 0; i < p_task->get_child_count(); i++) {
+		if (!_map_task_costs(p_task->get_child(i), p_depth + 1, p_report, r_index)) {
+			return false;
+		}
+	}
+	while (r_index < p_report.depths.size() && p_report.depths[r_index] > p_depth) {
+		r_index += 1;
+	}
+	return true;
+}
+
+void TaskTree::set_task_costs(const Array &p_costs) {
+	task_costs.clear();
+	max_self_usec = 0;
+	if (p_costs.size() == 4 && bt.is_valid() && bt->get_root_task().is_valid()) {
+		CostReport report;
+		report.names = p_costs[0];
+		report.depths = p_costs[1];
+		report.ticks = p_costs[2];
+		report.self_usec = p_costs[3];
+		ERR_FAIL_COND(report.depths.size() != report.names.size() || report.ticks.size() != report.names.size() || report.self_usec.size() != report.names.size());
+		int index = 0;
+		_map_task_costs(bt->get_root_task(), 0, report, index);
+	}
+	for (const KeyValue<RECT_CACHE_KEY, TreeItem *> &kv : item_map) {
+		_update_item_cost(kv.value, kv.value->get_metadata(0));
+	}
+}
+
+void TaskTree::_rebuild_tree() {
+	tree->clear();
+	item_map.clear();
+	if (bt.is_valid() && bt->get_root_task().is_valid()) {
+		updating_tree = true;
+		_create_tree(bt->get_root_task(), nullptr);
+		updating_tree = false;
+	}
+}
+
+void TaskTree::_unmap_item(TreeItem *p_item) {
+	Ref<BTTask> task = p_item->get_metadata(0);
+	if (task.is_valid()) {
+		HashMap<RECT_CACHE_KEY, TreeItem *>::Iterator E = item_map.find(task->get_instance_id());
+		if (E && E->value == p_item) {
+			item_map.remove(E);
+		}
+	}
+	probability_rect_cache.erase(p_item->get_instance_id());
+	for (TreeItem *child = p_item->get_first_child(); child; child = child->get_next()) {
+		_unmap_item(child);
+	}
+}
+
+void TaskTree::_free_item(TreeItem *p_item) {
+	_unmap_item(p_item);
+	memdelete(p_item);
+}
+
+// Makes the child items of p_item match the children of p_task, reusing existing items.
+// Only the items that were created, moved or had their siblings changed are refreshed.
+void TaskTree::_sync_children(TreeItem *p_item, const Ref<BTTask> &p_task) {
+	bool children_changed = false;
+	for (int i = 0; i < p_task->get_child_count(); i++) {
+		const Ref<BTTask> child_task = p_task->get_child(i);
+		TreeItem *child_item = p_item->get_child_count() > i ? p_item->get_child(i) : nullptr;
+		if (child_item == nullptr || Ref<BTTask>(child_item->get_metadata(0)) != child_task) {
+			children_changed = true;
+			TreeItem **existing = item_map.getptr(child_task->get_instance_id());
+			if (existing && (*existing)->get_parent() != nullptr) {
+				// * Moved task - relocate its item and keep the subtree.
+				// Items above p_item are already in sync, so the moved item can't be one of them.
+				TreeItem *moved = *existing;
+				moved->get_parent()->remove_child(moved);
+				p_item->add_child(moved);
+				TreeItem *item_at_idx = p_item->get_child(i);
+				if (item_at_idx != moved) {
+					moved->move_before(item_at_idx);
+				}
+				child_item = moved;
+			} else {
+				child_item = _create_tree(child_task, p_item, i);
+				continue; // * Fresh subtree is already up to date.
+			}
+		}
+		_sync_children(child_item, child_task);
+	}
+
+	// Items left past the last child belong to removed tasks.
+	while (p_item->get_child_count() > p_task->get_child_count()) {
+		children_changed = true;
+		_free_item(p_item->get_child(p_item->get_child_count() - 1));
+	}
+
+	if (children_changed) {
+		// * Probability cells and configuration warnings depend on the siblings and the parent.
+		_update_item(p_item);
+		for (TreeItem *child = p_item->get_first_child(); child; child = child->get_next()) {
+			_update_item(child);
+		}
+	}
 }
 
 void TaskTree::_update_tree() {
 	Vector<Ref<BTTask>> selection = get_selected_tasks();
 
-	tree->clear();
-	if (bt.is_null()) {
+	if (bt.is_null() || bt->get_root_task().is_null()) {
+		tree->clear();
+		item_map.clear();
 		return;
 	}
 
-	if (bt->get_root_task().is_valid()) {
+	TreeItem *root_item = tree->get_root();
+	if (root_item == nullptr || Ref<BTTask>(root_item->get_metadata(0)) != bt->get_root_task()) {
+		_rebuild_tree();
+	} else {
 		updating_tree = true;
-		_create_tree(bt->get_root_task(), nullptr);
+		_sync_children(root_item, bt->get_root_task());
 		updating_tree = false;
 	}
 
@@ -130,19 +273,8 @@ TreeItem *TaskTree::_find_item(const Ref<BTTask> &p_task) const {
 	if (p_task.is_null()) {
 		return nullptr;
 	}
-	TreeItem *item = tree->get_root();
-	List<TreeItem *> stack;
-	while (item && item->get_metadata(0) != p_task) {
-		if (item->get_child_count() > 0) {
-			stack.push_back(item->get_first_child());
-		}
-		item = item->get_next();
-		if (item == nullptr && !stack.is_empty()) {
-			item = stack.front()->get();
-			stack.pop_front();
-		}
-	}
-	return item;
+	TreeItem *const *item = item_map.getptr(p_task->get_instance_id());
+	return item ? *item : nullptr;
 }
 
 void TaskTree::_on_item_mouse_selected(const Vector2 &p_pos, MouseButton p_button_index) {
@@ -201,13 +333,9 @@ void TaskTree::load_bt(const Ref<BehaviorTree> &p_behavior_tree) {
 	}
 
 	bt = p_behavior_tree;
-	tree->clear();
 	probability_rect_cache.clear();
-	if (bt->get_root_task().is_valid()) {
-		updating_tree = true;
-		_create_tree(bt->get_root_task(), nullptr);
-		updating_tree = false;
-	}
+	task_costs.clear();
+	_rebuild_tree();
 }
 
 void TaskTree::unload() {
@@ -218,6 +346,8 @@ void TaskTree::unload() {
 
 	bt.unref();
 	tree->clear();
+	item_map.clear();
+	task_costs.clear();
 }
 
 void TaskTree::update_task(const Ref<BTTask> &p_task) {
@@ -516,6 +646,7 @@ void TaskTree::_do_update_theme_item_cache() {
 
 	theme_cache.comment_color = get_theme_color(LW_NAME(disabled_font_color), LW_NAME(Editor));
 	theme_cache.probability_font_color = get_theme_color(LW_NAME(font_color), LW_NAME(Editor));
+	theme_cache.heat_color = get_theme_color(LW_NAME(error_color), LW_NAME(Editor));
 
 	theme_cache.probability_bg.instantiate();
 	theme_cache.probability_bg->set_bg_color(get_theme_color(LW_NAME(accent_color), LW_NAME(Editor)) * Color(1, 1, 1, 0.25));
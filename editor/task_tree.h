@@ -42,6 +42,22 @@ private:
 	bool editable;
 	bool updating_tree;
 	HashMap<RECT_CACHE_KEY, Rect2> probability_rect_cache;
+	// Maps task instance IDs to their items, so that updates don't need to search the tree.
+	HashMap<RECT_CACHE_KEY, TreeItem *> item_map;
+
+	// Task costs reported by the running game, shown as a heatmap over the items. See set_task_costs().
+	struct TaskCost {
+		uint64_t ticks = 0;
+		uint64_t self_usec = 0;
+	};
+	struct CostReport {
+		PackedStringArray names;
+		PackedInt32Array depths;
+		PackedInt64Array ticks;
+		PackedInt64Array self_usec;
+	};
+	HashMap<RECT_CACHE_KEY, TaskCost> task_costs;
+	uint64_t max_self_usec = 0;
 
 	struct ThemeCache {
 		Ref<Font> comment_font;
@@ -57,13 +73,20 @@ private:
 
 		Color comment_color;
 		Color probability_font_color;
+		Color heat_color;
 
 		Ref<StyleBoxFlat> probability_bg;
 	} theme_cache;
 
 	TreeItem *_create_tree(const Ref<BTTask> &p_task, TreeItem *p_parent, int p_idx = -1);
 	void _update_item(TreeItem *p_item);
+	void _update_item_cost(TreeItem *p_item, const Ref<BTTask> &p_task);
+	bool _map_task_costs(const Ref<BTTask> &p_task, int p_depth, const CostReport &p_report, int &r_index);
 	void _update_tree();
+	void _rebuild_tree();
+	void _sync_children(TreeItem *p_item, const Ref<BTTask> &p_task);
+	void _free_item(TreeItem *p_item);
+	void _unmap_item(TreeItem *p_item);
 	TreeItem *_find_item(const Ref<BTTask> &p_task) const;
 
 	void _on_item_selected();
@@ -91,6 +114,7 @@ public:
 	Ref<BehaviorTree> get_bt() const { return bt; }
 	void update_tree() { _update_tree(); }
 	void update_task(const Ref<BTTask> &p_task);
+	void set_task_costs(const Array &p_costs);
 	void add_selection(const Ref<BTTask> &p_task);
 	void remove_selection(const Ref<BTTask> &p_task);
 	Ref<BTTask> get_selected() const;
@@ -0,0 +1,89 @@
+/**
+ * limbo_event_channel.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "limbo_event_channel.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/error/error_macros.h"
+#include "core/object/class_db.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/core/class_db.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+void LimboEventChannel::set_capacity(int p_capacity) {
+	ERR_FAIL_COND_MSG(p_capacity < 1, "LimboEventChannel: Capacity must be at least 1.");
+	lock.lock();
+	capacity = p_capacity;
+	messages.clear();
+	first_sequence = sequence;
+	lock.unlock();
+}
+
+uint64_t LimboEventChannel::_get_oldest_sequence() const {
+	lock.lock();
+	const uint64_t ret = MAX(first_sequence, sequence > (uint64_t)capacity ? sequence - capacity : 0);
+	lock.unlock();
+	return ret;
+}
+
+bool LimboEventChannel::_read(uint64_t p_sequence, int &r_event_id, Variant &r_cargo) const {
+	lock.lock();
+	const bool available = p_sequence >= first_sequence && p_sequence < sequence && sequence - p_sequence <= (uint64_t)capacity;
+	if (available) {
+		const Message &msg = messages[p_sequence % capacity];
+		r_event_id = msg.event_id;
+		r_cargo = msg.cargo;
+	}
+	lock.unlock();
+	return available;
+}
+
+void LimboEventChannel::_post(int p_event_id, const Variant &p_cargo) {
+	lock.lock();
+	if (messages.size() < (uint32_t)capacity) {
+		messages.resize(capacity);
+	}
+	// * Overwrites the oldest message once the ring is full - subscribers that fall behind miss it.
+	Message &msg = messages[sequence % capacity];
+	msg.event_id = p_event_id;
+	msg.cargo = p_cargo;
+	sequence += 1;
+	lock.unlock();
+}
+
+void LimboEventChannel::post(const StringName &p_event, const Variant &p_cargo) {
+	ERR_FAIL_COND_MSG(p_event == StringName(), "LimboEventChannel: Unable to post an event with an empty name.");
+	_post(LimboEventRegistry::intern(p_event), p_cargo);
+}
+
+void LimboEventChannel::post_id(int p_event_id, const Variant &p_cargo) {
+	ERR_FAIL_COND_MSG(p_event_id < 0 || p_event_id >= LimboEventRegistry::get_count(), "LimboEventChannel: Invalid event ID.");
+	_post(p_event_id, p_cargo);
+}
+
+uint64_t LimboEventChannel::get_sequence() const {
+	lock.lock();
+	const uint64_t ret = sequence;
+	lock.unlock();
+	return ret;
+}
+
+void LimboEventChannel::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_capacity", "capacity"), &LimboEventChannel::set_capacity);
+	ClassDB::bind_method(D_METHOD("get_capacity"), &LimboEventChannel::get_capacity);
+	ClassDB::bind_method(D_METHOD("post", "event", "cargo"), &LimboEventChannel::post, Variant());
+	ClassDB::bind_method(D_METHOD("post_id", "event_id", "cargo"), &LimboEventChannel::post_id, Variant());
+	ClassDB::bind_method(D_METHOD("get_sequence"), &LimboEventChannel::get_sequence);
+
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "capacity", PROPERTY_HINT_RANGE, "1,1024,1,or_greater"), "set_capacity", "get_capacity");
+}
@@ -0,0 +1,73 @@
+/**
+ * limbo_event_channel.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef LIMBO_EVENT_CHANNEL_H
+#define LIMBO_EVENT_CHANNEL_H
+
+#include "limbo_event_registry.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/object/ref_counted.h"
+#include "core/os/spin_lock.h"
+#include "core/templates/local_vector.h"
+#include "core/variant/variant.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/templates/spin_lock.hpp>
+#include <godot_cpp/variant/variant.hpp>
+using namespace godot;
+#endif // LIMBOAI_GDEXTENSION
+
+// Broadcasts HSM events to every subscribed LimboHSM. Posting costs the same for any number of subscribers:
+// messages are kept in a bounded ring, and each subscriber reads the ones it hasn't seen yet during its own update.
+class LimboEventChannel : public RefCounted {
+	GDCLASS(LimboEventChannel, RefCounted);
+
+private:
+	friend class LimboHSM;
+
+	struct Message {
+		int event_id = LimboEventRegistry::INVALID_EVENT;
+		Variant cargo;
+	};
+
+	// Message with sequence number N is stored at N % capacity. Guarded by lock.
+	LocalVector<Message> messages;
+	int capacity = 64;
+	uint64_t sequence = 0; // Number of messages posted so far.
+	uint64_t first_sequence = 0; // Messages before it were cleared by set_capacity().
+	mutable SpinLock lock;
+
+	// Oldest message that can still be read.
+	uint64_t _get_oldest_sequence() const;
+	// Returns false if the message was already overwritten.
+	bool _read(uint64_t p_sequence, int &r_event_id, Variant &r_cargo) const;
+	void _post(int p_event_id, const Variant &p_cargo);
+
+protected:
+	static void _bind_methods();
+
+public:
+	// The number of messages kept for subscribers that haven't read them yet. Changing it drops unread messages.
+	void set_capacity(int p_capacity);
+	int get_capacity() const { return capacity; }
+
+	// Thread-safe. The event is dispatched to each subscriber on its next update.
+	void post(const StringName &p_event, const Variant &p_cargo = Variant());
+	void post_id(int p_event_id, const Variant &p_cargo = Variant());
+
+	uint64_t get_sequence() const;
+};
+
+#endif // LIMBO_EVENT_CHANNEL_H
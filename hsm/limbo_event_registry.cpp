@@ -0,0 +1,71 @@
+/**
+ * limbo_event_registry.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "limbo_event_registry.h"
+
+#include "../util/limbo_string_names.h"
+
+SpinLock LimboEventRegistry::lock;
+HashMap<StringName, int> LimboEventRegistry::ids;
+LocalVector<StringName> LimboEventRegistry::names;
+
+int LimboEventRegistry::intern(const StringName &p_event) {
+	ERR_FAIL_COND_V_MSG(p_event == StringName(), INVALID_EVENT, "LimboEventRegistry: Event name can't be empty.");
+	lock.lock();
+	const int *id = ids.getptr(p_event);
+	int ret;
+	if (id) {
+		ret = *id;
+	} else {
+		ret = names.size();
+		ids.insert(p_event, ret);
+		names.push_back(p_event);
+	}
+	lock.unlock();
+	return ret;
+}
+
+int LimboEventRegistry::find(const StringName &p_event) {
+	lock.lock();
+	const int *id = ids.getptr(p_event);
+	int ret = id ? *id : INVALID_EVENT;
+	lock.unlock();
+	return ret;
+}
+
+StringName LimboEventRegistry::get_name(int p_event_id) {
+	lock.lock();
+	StringName ret;
+	if (p_event_id >= 0 && p_event_id < (int)names.size()) {
+		ret = names[p_event_id];
+	}
+	lock.unlock();
+	return ret;
+}
+
+int LimboEventRegistry::get_count() {
+	lock.lock();
+	int ret = names.size();
+	lock.unlock();
+	return ret;
+}
+
+void LimboEventRegistry::initialize() {
+	int id = intern(LW_NAME(EVENT_FINISHED));
+	CRASH_COND(id != EVENT_FINISHED);
+}
+
+void LimboEventRegistry::deinitialize() {
+	lock.lock();
+	ids.clear();
+	names.clear();
+	lock.unlock();
+}
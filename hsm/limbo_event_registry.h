@@ -0,0 +1,54 @@
+/**
+ * limbo_event_registry.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef LIMBO_EVENT_REGISTRY_H
+#define LIMBO_EVENT_REGISTRY_H
+
+#ifdef LIMBOAI_MODULE
+#include "core/os/spin_lock.h"
+#include "core/string/string_name.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/templates/spin_lock.hpp>
+#include <godot_cpp/variant/string_name.hpp>
+using namespace godot;
+#endif // LIMBOAI_GDEXTENSION
+
+// Interns HSM event names as small integers shared by all state machines.
+// IDs are assigned in registration order and stay valid until the module is unloaded.
+class LimboEventRegistry {
+public:
+	static constexpr int INVALID_EVENT = -1;
+	static constexpr int EVENT_FINISHED = 0;
+
+private:
+	static SpinLock lock;
+	static HashMap<StringName, int> ids;
+	static LocalVector<StringName> names;
+
+public:
+	// Returns the ID of the event, registering it if needed.
+	static int intern(const StringName &p_event);
+	// Returns INVALID_EVENT if the event was never registered.
+	static int find(const StringName &p_event);
+	static StringName get_name(int p_event_id);
+	static int get_count();
+
+	static void initialize();
+	static void deinitialize();
+};
+
+#endif // LIMBO_EVENT_REGISTRY_H
@@ -11,6 +11,17 @@
 
 #include "limbo_hsm.h"
 
+#include "../bt/bt_scheduler.h"
+#include "../util/limbo_profiling.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/config/engine.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/engine.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
 VARIANT_ENUM_CAST(LimboHSM::UpdateMode);
 
 void LimboHSM::set_active(bool p_active) {
@@ -22,26 +33,60 @@ void LimboHSM::set_active(bool p_active) {
 	}
 
 	active = p_active;
+	_update_processing();
+
+	if (active) {
+		_enter();
+	} else {
+		_exit();
+	}
+}
+
+void LimboHSM::set_update_mode(UpdateMode p_mode) {
+	update_mode = p_mode;
+	if (active) {
+		_update_processing();
+	}
+}
+
+void LimboHSM::_update_processing() {
 	switch (update_mode) {
 		case UpdateMode::IDLE: {
-			set_process(p_active);
+			set_process(active);
 			set_physics_process(false);
 		} break;
 		case UpdateMode::PHYSICS: {
 			set_process(false);
-			set_physics_process(p_active);
+			set_physics_process(active);
 		} break;
-		case UpdateMode::MANUAL: {
+		case UpdateMode::MANUAL:
+		case UpdateMode::SCHEDULED: {
 			set_process(false);
 			set_physics_process(false);
 		} break;
 	}
-	set_process_input(p_active);
+	if (handles_input) {
+		set_process_input(active);
+	}
+	_update_scheduling();
+}
 
-	if (active) {
-		_enter();
+void LimboHSM::set_update_interval(double p_interval) {
+	update_interval = MAX(p_interval, 0.0);
+	// Random phase staggers state machines sharing the same interval across frames.
+	tick_countdown = update_interval * RANDF();
+}
+
+void LimboHSM::_update_scheduling() {
+	bool should_schedule = update_mode == UpdateMode::SCHEDULED && active && is_root() && is_inside_tree() && !Engine::get_singleton()->is_editor_hint();
+	if (should_schedule == scheduled || BTScheduler::get_singleton() == nullptr) {
+		return;
+	}
+	scheduled = should_schedule;
+	if (scheduled) {
+		BTScheduler::get_singleton()->register_hsm(this);
 	} else {
-		_exit();
+		BTScheduler::get_singleton()->unregister_hsm(this);
 	}
 }
 
@@ -52,15 +97,31 @@ void LimboHSM::change_active_state(LimboState *p_state) {
 
 	if (active_state) {
 		active_state->_exit();
-		active_state->set_process_input(false);
+		if (active_state->handles_input) {
+			active_state->set_process_input(false);
+		}
 		previous_active = active_state;
 	}
 
 	active_state = p_state;
 	active_state->_enter();
-	active_state->set_process_input(true);
+	if (active_state->handles_input) {
+		// * Toggling input processing changes SceneTree group membership - skipped for states that don't need it.
+		active_state->set_process_input(true);
+	}
 
-	emit_signal(LW_NAME(active_state_changed), active_state, previous_active);
+	if (native_state_changed_listener) {
+		native_state_changed_listener(this, active_state, previous_active, native_state_changed_userdata);
+	}
+	// * Changes happen often in large HSMs - skip boxing the states and looking up the signal when no one listens.
+	if (has_connections(LW_NAME(active_state_changed))) {
+		emit_signal(LW_NAME(active_state_changed), active_state, previous_active);
+	}
+}
+
+void LimboHSM::set_native_state_changed_listener(NativeStateChangedListener p_listener, void *p_userdata) {
+	native_state_changed_listener = p_listener;
+	native_state_changed_userdata = p_listener ? p_userdata : nullptr;
 }
 
 void LimboHSM::_enter() {
@@ -91,15 +152,163 @@ void LimboHSM::_update(double p_delta) {
 }
 
 void LimboHSM::update(double p_delta) {
+	LIMBO_PROFILE_ZONE("LimboHSM::update");
+	_drain_event_queue();
 	updating = true;
 	_update(p_delta);
 	updating = false;
 	if (next_active) {
 		change_active_state(next_active);
 		next_active = nullptr;
+		// * Transitions deferred during the update are evaluated against the new active state.
+		_drain_event_queue();
 	}
 }
 
+void LimboHSM::set_event_queue_capacity(int p_capacity) {
+	ERR_FAIL_COND_MSG(p_capacity < 1, "LimboHSM: Event queue capacity must be at least 1.");
+	queue_lock.lock();
+	if (queue_size > 0) {
+		queue_lock.unlock();
+		ERR_FAIL_MSG("LimboHSM: Unable to change event queue capacity while events are queued.");
+	}
+	event_queue_capacity = p_capacity;
+	event_queue.clear();
+	queue_head = 0;
+	queue_lock.unlock();
+}
+
+LimboHSM *LimboHSM::_get_root_hsm() {
+	return is_root() ? this : Object::cast_to<LimboHSM>(get_root());
+}
+
+bool LimboHSM::_push_event(int p_event_id, const Variant &p_cargo) {
+	if (!is_root()) {
+		// * Events are always dispatched from the root, so it owns the queue.
+		LimboHSM *root = _get_root_hsm();
+		ERR_FAIL_NULL_V_MSG(root, false, "LimboHSM: Unable to queue an event - root state is not a LimboHSM.");
+		return root->_push_event(p_event_id, p_cargo);
+	}
+	queue_lock.lock();
+	if (queue_size >= (uint32_t)event_queue_capacity) {
+		queue_lock.unlock();
+		ERR_PRINT_ONCE(vformat("LimboHSM: Event queue is full (capacity: %d). Event \"%s\" is dropped.", event_queue_capacity, LimboEventRegistry::get_name(p_event_id)));
+		return false;
+	}
+	if (event_queue.size() < (uint32_t)event_queue_capacity) {
+		event_queue.resize(event_queue_capacity);
+	}
+	QueuedEvent &qe = event_queue[(queue_head + queue_size) % event_queue_capacity];
+	qe.event_id = p_event_id;
+	qe.cargo = p_cargo;
+	queue_size++;
+	queue_lock.unlock();
+	return true;
+}
+
+void LimboHSM::_drain_event_queue() {
+	// * Only the events queued so far are dispatched - events queued while draining wait for the next update.
+	queue_lock.lock();
+	uint32_t count = queue_size;
+	queue_lock.unlock();
+
+	for (uint32_t i = 0; i < count; i++) {
+		QueuedEvent qe;
+		queue_lock.lock();
+		QueuedEvent &front = event_queue[queue_head];
+		qe.event_id = front.event_id;
+		qe.cargo = front.cargo;
+		front.cargo = Variant();
+		queue_head = (queue_head + 1) % event_queue_capacity;
+		queue_size--;
+		queue_lock.unlock();
+
+		if (active) {
+			_dispatch(qe.event_id, qe.cargo);
+		}
+	}
+
+	if (unlikely(!subscriptions.is_empty())) {
+		_drain_subscriptions();
+	}
+}
+
+void LimboHSM::_drain_subscriptions() {
+	for (uint32_t i = 0; i < subscriptions.size(); i++) {
+		const Ref<LimboEventChannel> channel = subscriptions[i].channel;
+		// * Same as with the queue: messages posted while draining wait for the next update.
+		const uint64_t end = channel->get_sequence();
+		const uint64_t oldest = channel->_get_oldest_sequence();
+		if (subscriptions[i].next_sequence < oldest) {
+			ERR_PRINT_ONCE(vformat("LimboHSM: Missed %d events posted to a LimboEventChannel - consider increasing its capacity.", oldest - subscriptions[i].next_sequence));
+			subscriptions[i].next_sequence = oldest;
+		}
+		// * Handlers may unsubscribe, shifting the list - the rest is picked up on the next update.
+		while (i < subscriptions.size() && subscriptions[i].channel == channel && subscriptions[i].next_sequence < end) {
+			int event_id;
+			Variant cargo;
+			const bool available = channel->_read(subscriptions[i].next_sequence, event_id, cargo);
+			subscriptions[i].next_sequence += 1;
+			if (available && active) {
+				_dispatch(event_id, cargo);
+			}
+		}
+	}
+}
+
+void LimboHSM::subscribe(const Ref<LimboEventChannel> &p_channel) {
+	ERR_FAIL_COND_MSG(p_channel.is_null(), "LimboHSM: Unable to subscribe to a null channel.");
+	LimboHSM *root = _get_root_hsm();
+	ERR_FAIL_NULL_MSG(root, "LimboHSM: Unable to subscribe - root state is not a LimboHSM.");
+	if (root->is_subscribed(p_channel)) {
+		return;
+	}
+	// * Events are dispatched from the root, so it holds the subscriptions of the whole state machine.
+	Subscription sub;
+	sub.channel = p_channel;
+	sub.next_sequence = p_channel->get_sequence();
+	root->subscriptions.push_back(sub);
+}
+
+void LimboHSM::unsubscribe(const Ref<LimboEventChannel> &p_channel) {
+	LimboHSM *root = _get_root_hsm();
+	ERR_FAIL_NULL(root);
+	for (uint32_t i = 0; i < root->subscriptions.size(); i++) {
+		if (root->subscriptions[i].channel == p_channel) {
+			root->subscriptions.remove_at(i);
+			return;
+		}
+	}
+}
+
+bool LimboHSM::is_subscribed(const Ref<LimboEventChannel> &p_channel) {
+	LimboHSM *root = _get_root_hsm();
+	ERR_FAIL_NULL_V(root, false);
+	for (const Subscription &sub : root->subscriptions) {
+		if (sub.channel == p_channel) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool LimboHSM::queue_event(const StringName &p_event, const Variant &p_cargo) {
+	ERR_FAIL_COND_V_MSG(p_event == StringName(), false, "LimboHSM: Unable to queue an event with an empty name.");
+	return _push_event(LimboEventRegistry::intern(p_event), p_cargo);
+}
+
+bool LimboHSM::queue_event_id(int p_event_id, const Variant &p_cargo) {
+	ERR_FAIL_COND_V_MSG(p_event_id < 0 || p_event_id >= LimboEventRegistry::get_count(), false, "LimboHSM: Invalid event ID.");
+	return _push_event(p_event_id, p_cargo);
+}
+
+int LimboHSM::get_queued_event_count() {
+	queue_lock.lock();
+	int ret = queue_size;
+	queue_lock.unlock();
+	return ret;
+}
+
 void LimboHSM::add_transition(LimboState *p_from_state, LimboState *p_to_state, const StringName &p_event) {
 	ERR_FAIL_COND_MSG(p_from_state != nullptr && p_from_state->get_parent() != this, "LimboHSM: Unable to add a transition from a state that is not an immediate child of mine.");
 	ERR_FAIL_COND_MSG(p_to_state == nullptr, "LimboHSM: Unable to add a transition to a null state.");
@@ -109,7 +318,9 @@ void LimboHSM::add_transition(LimboState *p_from_state, LimboState *p_to_state,
 	TransitionKey key = Transition::make_key(p_from_state, p_event);
 	ERR_FAIL_COND_MSG(transitions.has(key), "LimboHSM: Unable to add another transition with the same event and origin.");
 	// Note: Explicit casting needed for GDExtension.
-	transitions[key] = { p_from_state != nullptr ? ObjectID(p_from_state->get_instance_id()) : ObjectID(), ObjectID(p_to_state->get_instance_id()), p_event };
+	transitions[key] = { p_from_state != nullptr ? ObjectID(p_from_state->get_instance_id()) : ObjectID(), ObjectID(p_to_state->get_instance_id()), p_event, LimboEventRegistry::intern(p_event) };
+	transition_table_dirty = true;
+	routing_epoch += 1;
 }
 
 void LimboHSM::remove_transition(LimboState *p_from_state, const StringName &p_event) {
@@ -119,22 +330,64 @@ void LimboHSM::remove_transition(LimboState *p_from_state, const StringName &p_e
 	TransitionKey key = Transition::make_key(p_from_state, p_event);
 	ERR_FAIL_COND_MSG(!transitions.has(key), "LimboHSM: Unable to remove a transition that does not exist.");
 	transitions.erase(key);
+	transition_table_dirty = true;
+	routing_epoch += 1;
 }
 
-void LimboHSM::_get_transition(LimboState *p_from_state, const StringName &p_event, Transition &r_transition) const {
-	ERR_FAIL_COND_MSG(p_from_state != nullptr && p_from_state->get_parent() != this, "LimboHSM: Unable to get a transition from a state that is not an immediate child of this HSM.");
-	ERR_FAIL_COND_MSG(p_event == StringName(), "LimboHSM: Unable to get a transition with an empty event string.");
+void LimboHSM::_build_transition_table() {
+	event_columns.clear();
+	num_event_columns = 0;
+	for (const KeyValue<TransitionKey, Transition> &kv : transitions) {
+		const int event_id = kv.value.event_id;
+		if (event_id >= (int)event_columns.size()) {
+			int old_size = event_columns.size();
+			event_columns.resize(event_id + 1);
+			for (int i = old_size; i <= event_id; i++) {
+				event_columns[i] = -1;
+			}
+		}
+		if (event_columns[event_id] < 0) {
+			event_columns[event_id] = num_event_columns++;
+		}
+	}
 
-	TransitionKey key = Transition::make_key(p_from_state, p_event);
-	if (transitions.has(key)) {
-		r_transition = transitions[key];
+	const int anystate_row = get_child_count();
+	for (int i = 0; i < get_child_count(); i++) {
+		LimboState *c = Object::cast_to<LimboState>(get_child(i));
+		if (c) {
+			c->transition_row = i;
+		}
+	}
+
+	transition_table.resize((anystate_row + 1) * num_event_columns);
+	for (uint32_t i = 0; i < transition_table.size(); i++) {
+		transition_table[i] = nullptr;
 	}
+
+	for (const KeyValue<TransitionKey, Transition> &kv : transitions) {
+		const Transition &t = kv.value;
+		LimboState *to_state = Object::cast_to<LimboState>(OBJECT_DB_GET_INSTANCE(t.to_state));
+		if (to_state == nullptr || to_state->get_parent() != this) {
+			continue;
+		}
+		int row = anystate_row;
+		if (t.from_state != ObjectID()) {
+			LimboState *from_state = Object::cast_to<LimboState>(OBJECT_DB_GET_INSTANCE(t.from_state));
+			if (from_state == nullptr || from_state->get_parent() != this) {
+				continue;
+			}
+			row = from_state->transition_row;
+		}
+		transition_table[row * num_event_columns + event_columns[t.event_id]] = to_state;
+	}
+
+	transition_table_dirty = false;
 }
 
 LimboState *LimboHSM::get_leaf_state() const {
 	LimboHSM *hsm = const_cast<LimboHSM *>(this);
-	while (hsm->active_state != nullptr && hsm->active_state->is_class("LimboHSM")) {
-		hsm = Object::cast_to<LimboHSM>(hsm->active_state);
+	while (hsm->active_state != nullptr && hsm->active_state->is_hsm) {
+		hsm = static_cast<LimboHSM *>(hsm->active_state);
 	}
 	if (hsm->active_state) {
 		return hsm->active_state;
@@ -148,32 +401,111 @@ void LimboHSM::set_initial_state(LimboState *p_state) {
 	initial_state = Object::cast_to<LimboState>(p_state);
 }
 
-bool LimboHSM::_dispatch(const StringName &p_event, const Variant &p_cargo) {
-	ERR_FAIL_COND_V(p_event == StringName(), false);
+static void _mark_event_routes(LocalVector<uint8_t> &r_routes, const LocalVector<Callable> &p_handlers, uint8_t p_flags) {
+	if (r_routes.size() < p_handlers.size()) {
+		const uint32_t old_size = r_routes.size();
+		r_routes.resize(p_handlers.size());
+		for (uint32_t i = old_size; i < r_routes.size(); i++) {
+			r_routes[i] = 0;
+		}
+	}
+	for (uint32_t i = 0; i < p_handlers.size(); i++) {
+		if (p_handlers[i].is_valid()) {
+			r_routes[i] |= p_flags;
+		}
+	}
+}
+
+void LimboHSM::_build_event_routes() {
+	event_routes.clear();
+	_mark_event_routes(event_routes, handlers, ROUTE_LEVEL | ROUTE_SUBTREE);
+	for (const KeyValue<TransitionKey, Transition> &kv : transitions) {
+		const int event_id = kv.value.event_id;
+		if (event_id >= (int)event_routes.size()) {
+			const uint32_t old_size = event_routes.size();
+			event_routes.resize(event_id + 1);
+			for (uint32_t i = old_size; i < event_routes.size(); i++) {
+				event_routes[i] = 0;
+			}
+		}
+		event_routes[event_id] |= ROUTE_LEVEL | ROUTE_SUBTREE;
+	}
+	for (int i = 0; i < get_child_count(); i++) {
+		LimboState *child = Object::cast_to<LimboState>(get_child(i));
+		if (child == nullptr) {
+			continue;
+		}
+		_mark_event_routes(event_routes, child->handlers, ROUTE_SUBTREE);
+		LimboHSM *nested = Object::cast_to<LimboHSM>(child);
+		if (nested == nullptr) {
+			continue;
+		}
+		if (nested->event_routes_epoch != routing_epoch) {
+			nested->_build_event_routes();
+		}
+		if (event_routes.size() < nested->event_routes.size()) {
+			const uint32_t old_size = event_routes.size();
+			event_routes.resize(nested->event_routes.size());
+			for (uint32_t j = old_size; j < event_routes.size(); j++) {
+				event_routes[j] = 0;
+			}
+		}
+		for (uint32_t j = 0; j < nested->event_routes.size(); j++) {
+			if (nested->event_routes[j] & ROUTE_SUBTREE) {
+				event_routes[j] |= ROUTE_SUBTREE;
+			}
+		}
+	}
+	event_routes_epoch = routing_epoch;
+}
+
+bool LimboHSM::_dispatch(int p_event_id, const Variant &p_cargo) {
+	ERR_FAIL_COND_V(p_event_id < 0, false);
+	LIMBO_PROFILE_ZONE("LimboHSM::dispatch");
+
+	if (unlikely(next_active != nullptr)) {
+		// * A transition is pending until the end of the update: the event is dispatched after it takes place.
+		return _push_event(p_event_id, p_cargo);
+	}
+
+	if (!(_get_event_route(p_event_id) & ROUTE_SUBTREE)) {
+		// * Nothing in this state machine can consume the event.
+		if (p_event_id == LimboEventRegistry::EVENT_FINISHED && is_root()) {
+			_exit();
+		}
+		return false;
+	}
 
 	bool event_consumed = false;
 
 	if (active_state) {
-		event_consumed = active_state->_dispatch(p_event, p_cargo);
+		event_consumed = active_state->_dispatch(p_event_id, p_cargo);
 	}
 
 	if (!event_consumed) {
-		event_consumed = LimboState::_dispatch(p_event, p_cargo);
+		event_consumed = _handle_event(p_event_id, p_cargo);
 	}
 
-	if (!event_consumed && active_state) {
+	return event_consumed;
+}
+
+bool LimboHSM::_handle_event(int p_event_id, const Variant &p_cargo) {
+	const bool at_level = _get_event_route(p_event_id) & ROUTE_LEVEL;
+	bool event_consumed = at_level && LimboState::_dispatch(p_event_id, p_cargo);
+
+	if (!event_consumed && at_level && active_state) {
 		LimboState *to_state = nullptr;
 
-		Transition transition;
-		_get_transition(active_state, p_event, transition);
-		if (transition.is_valid()) {
-			to_state = Object::cast_to<LimboState>(ObjectDB::get_instance(transition.to_state));
+		if (unlikely(transition_table_dirty)) {
+			_build_transition_table();
 		}
-		if (to_state == nullptr) {
-			// Get ANYSTATE transition.
-			_get_transition(nullptr, p_event, transition);
-			if (transition.is_valid()) {
-				to_state = Object::cast_to<LimboState>(ObjectDB::get_instance(transition.to_state));
+		const int column = p_event_id < (int)event_columns.size() ? event_columns[p_event_id] : -1;
+		if (column >= 0) {
+			ERR_FAIL_COND_V(active_state->transition_row < 0, false);
+			to_state = transition_table[active_state->transition_row * num_event_columns + column];
+			if (to_state == nullptr) {
+				// Get ANYSTATE transition.
+				to_state = transition_table[get_child_count() * num_event_columns + column];
 				if (to_state == active_state) {
 					// Transitions to self are not allowed with ANYSTATE.
 					to_state = nullptr;
@@ -181,31 +513,12 @@ bool LimboHSM::_dispatch(const StringName &p_event, const Variant &p_cargo) {
 			}
 		}
 		if (to_state != nullptr) {
-			bool permitted = true;
-			if (to_state->guard_callable.is_valid()) {
-				Variant ret;
-
-#ifdef LIMBOAI_MODULE
-				Callable::CallError ce;
-				to_state->guard_callable.callp(nullptr, 0, ret, ce);
-				if (unlikely(ce.error != Callable::CallError::CALL_OK)) {
-					ERR_PRINT_ONCE("LimboHSM: Error calling substate's guard callable: " + Variant::get_callable_error_text(to_state->guard_callable, nullptr, 0, ce));
-				}
-#elif LIMBOAI_GDEXTENSION
-				ret = to_state->guard_callable.call();
-#endif
-
-				if (unlikely(ret.get_type() != Variant::BOOL)) {
-					ERR_PRINT_ONCE(vformat("State guard callable %s returned non-boolean value (%s).", to_state->guard_callable, to_state));
-				} else {
-					permitted = bool(ret);
-				}
-			}
+			// * Native and variable check guards are evaluated without Callable dispatch.
+			const bool permitted = !to_state->has_guard() || to_state->_evaluate_guard();
 			if (permitted) {
 				if (!updating) {
 					change_active_state(to_state);
-				} else if (!next_active) {
-					// Only set next_active if we are not already in the process of changing states.
+				} else {
 					next_active = to_state;
 				}
 				event_consumed = true;
@@ -213,13 +526,37 @@ bool LimboHSM::_dispatch(const StringName &p_event, const Variant &p_cargo) {
 		}
 	}
 
-	if (!event_consumed && p_event == LW_NAME(EVENT_FINISHED) && !(get_parent() && get_parent()->is_class("LimboState"))) {
+	if (!event_consumed && p_event_id == LimboEventRegistry::EVENT_FINISHED && is_root()) {
 		_exit();
 	}
 
 	return event_consumed;
 }
 
+bool LimboHSM::_dispatch_from_active(LimboState *p_state, int p_event_id, const Variant &p_cargo) {
+	ERR_FAIL_COND_V(p_event_id < 0, false);
+	ERR_FAIL_COND_V(!p_state->is_active(), false);
+	LIMBO_PROFILE_ZONE("LimboHSM::dispatch");
+
+	// * Pending transitions queue the event on the root, whichever level it would have reached first.
+	for (LimboState *state = p_state->parent_state; state != nullptr; state = state->parent_state) {
+		LimboHSM *hsm = static_cast<LimboHSM *>(state);
+		if (unlikely(hsm->next_active != nullptr)) {
+			return hsm->_push_event(p_event_id, p_cargo);
+		}
+	}
+
+	if (p_state->_dispatch(p_event_id, p_cargo)) {
+		return true;
+	}
+	for (LimboState *state = p_state->parent_state; state != nullptr; state = state->parent_state) {
+		if (static_cast<LimboHSM *>(state)->_handle_event(p_event_id, p_cargo)) {
+			return true;
+		}
+	}
+	return false;
+}
+
 void LimboHSM::initialize(Node *p_agent, const Ref<Blackboard> &p_parent_scope) {
 	ERR_FAIL_COND(p_agent == nullptr);
 	ERR_FAIL_COND_MSG(!is_root(), "LimboHSM: initialize() must be called on the root HSM.");
@@ -251,11 +588,13 @@ void LimboHSM::_initialize(Node *p_agent, const Ref<Blackboard> &p_blackboard) {
 			c->_initialize(agent, blackboard);
 		}
 	}
+
+	_build_transition_table();
 }
 
 void LimboHSM::_validate_property(PropertyInfo &p_property) const {
-	if (p_property.name == LW_NAME(update_mode) && !is_root()) {
-		// Hide update_mode for non-root HSMs.
+	if ((p_property.name == LW_NAME(update_mode) || p_property.name == LW_NAME(update_interval)) && !is_root()) {
+		// Hide update_mode and update_interval for non-root HSMs.
 		p_property.usage = PROPERTY_USAGE_NONE;
 	}
 }
@@ -264,10 +603,25 @@ void LimboHSM::_notification(int p_what) {
 	switch (p_what) {
 		case NOTIFICATION_POST_ENTER_TREE: {
 		} break;
+		case NOTIFICATION_ENTER_TREE: {
+			_update_scheduling();
+		} break;
+		case NOTIFICATION_EXIT_TREE: {
+			if (scheduled) {
+				scheduled = false;
+				BTScheduler::get_singleton()->unregister_hsm(this);
+			}
+		} break;
+		case NOTIFICATION_CHILD_ORDER_CHANGED: {
+			transition_table_dirty = true;
+			routing_epoch += 1;
+		} break;
 		case NOTIFICATION_PROCESS: {
+			_drain_event_queue();
 			_update(get_process_delta_time());
 		} break;
 		case NOTIFICATION_PHYSICS_PROCESS: {
+			_drain_event_queue();
 			_update(get_physics_process_delta_time());
 		} break;
 	}
@@ -277,6 +631,9 @@ void LimboHSM::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_update_mode", "mode"), &LimboHSM::set_update_mode);
 	ClassDB::bind_method(D_METHOD("get_update_mode"), &LimboHSM::get_update_mode);
 
+	ClassDB::bind_method(D_METHOD("set_update_interval", "interval"), &LimboHSM::set_update_interval);
+	ClassDB::bind_method(D_METHOD("get_update_interval"), &LimboHSM::get_update_interval);
+
 	ClassDB::bind_method(D_METHOD("set_initial_state", "state"), &LimboHSM::set_initial_state);
 	ClassDB::bind_method(D_METHOD("get_initial_state"), &LimboHSM::get_initial_state);
 
@@ -285,6 +642,14 @@ void LimboHSM::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_leaf_state"), &LimboHSM::get_leaf_state);
 	ClassDB::bind_method(D_METHOD("set_active", "active"), &LimboHSM::set_active);
 	ClassDB::bind_method(D_METHOD("update", "delta"), &LimboHSM::update);
+	ClassDB::bind_method(D_METHOD("set_event_queue_capacity", "capacity"), &LimboHSM::set_event_queue_capacity);
+	ClassDB::bind_method(D_METHOD("get_event_queue_capacity"), &LimboHSM::get_event_queue_capacity);
+	ClassDB::bind_method(D_METHOD("queue_event", "event", "cargo"), &LimboHSM::queue_event, Variant());
+	ClassDB::bind_method(D_METHOD("queue_event_id", "event_id", "cargo"), &LimboHSM::queue_event_id, Variant());
+	ClassDB::bind_method(D_METHOD("get_queued_event_count"), &LimboHSM::get_queued_event_count);
+	ClassDB::bind_method(D_METHOD("subscribe", "channel"), &LimboHSM::subscribe);
+	ClassDB::bind_method(D_METHOD("unsubscribe", "channel"), &LimboHSM::unsubscribe);
+	ClassDB::bind_method(D_METHOD("is_subscribed", "channel"), &LimboHSM::is_subscribed);
 	ClassDB::bind_method(D_METHOD("add_transition", "from_state", "to_state", "event"), &LimboHSM::add_transition);
 	ClassDB::bind_method(D_METHOD("remove_transition", "from_state", "event"), &LimboHSM::remove_transition);
 	ClassDB::bind_method(D_METHOD("has_transition", "from_state", "event"), &LimboHSM::has_transition);
@@ -295,8 +660,11 @@ void LimboHSM::_bind_methods() {
 	BIND_ENUM_CONSTANT(IDLE);
 	BIND_ENUM_CONSTANT(PHYSICS);
 	BIND_ENUM_CONSTANT(MANUAL);
+	BIND_ENUM_CONSTANT(SCHEDULED);
 
-	ADD_PROPERTY(PropertyInfo(Variant::INT, "update_mode", PROPERTY_HINT_ENUM, "Idle, Physics, Manual"), "set_update_mode", "get_update_mode");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "update_mode", PROPERTY_HINT_ENUM, "Idle, Physics, Manual, Scheduled"), "set_update_mode", "get_update_mode");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "update_interval", PROPERTY_HINT_RANGE, "0.0,10.0,0.001,or_greater,suffix:s"), "set_update_interval", "get_update_interval");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "event_queue_capacity", PROPERTY_HINT_RANGE, "1,1024,1,or_greater"), "set_event_queue_capacity", "get_event_queue_capacity");
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "ANYSTATE", PROPERTY_HINT_RESOURCE_TYPE, "LimboState", 0), "", "anystate");
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "initial_state", PROPERTY_HINT_RESOURCE_TYPE, "LimboState", 0), "set_initial_state", "get_initial_state");
 
@@ -306,9 +674,16 @@ void LimboHSM::_bind_methods() {
 }
 
 LimboHSM::LimboHSM() {
+	is_hsm = true;
 	update_mode = UpdateMode::PHYSICS;
 	active_state = nullptr;
 	previous_active = nullptr;
 	next_active = nullptr;
 	initial_state = nullptr;
 }
+
+LimboHSM::~LimboHSM() {
+	if (scheduled && BTScheduler::get_singleton()) {
+		BTScheduler::get_singleton()->unregister_hsm(this);
+	}
+}
@@ -12,8 +12,19 @@
 #ifndef LIMBO_HSM_H
 #define LIMBO_HSM_H
 
+#include "limbo_event_channel.h"
 #include "limbo_state.h"
 
+#ifdef LIMBOAI_MODULE
+#include "core/os/spin_lock.h"
+#include "core/templates/local_vector.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/templates/spin_lock.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
 #define TransitionKey Pair<uint64_t, StringName>
 
 class LimboHSM : public LimboState {
@@ -24,8 +35,12 @@ public:
 		IDLE, // automatically call update() during NOTIFICATION_PROCESS
 		PHYSICS, // automatically call update() during NOTIFICATION_PHYSICS
 		MANUAL, // manually update state machine: user must call update(delta)
+		SCHEDULED, // updated in batch by BTScheduler during physics frame
 	};
 
+	// Called on every change of the active state, without going through signals and Variant.
+	typedef void (*NativeStateChangedListener)(LimboHSM *p_hsm, LimboState *p_current, LimboState *p_previous, void *p_userdata);
+
 private:
 	struct TransitionKeyHasher {
 		static uint32_t hash(const TransitionKey &P) {
@@ -39,6 +54,7 @@ private:
 		ObjectID from_state;
 		ObjectID to_state;
 		StringName event;
+		int event_id = LimboEventRegistry::INVALID_EVENT;
 
 		inline bool is_valid() const { return to_state != ObjectID(); }
 
@@ -55,10 +71,97 @@ private:
 	LimboState *previous_active;
 	LimboState *next_active;
 	bool updating = false;
+	NativeStateChangedListener native_state_changed_listener = nullptr;
+	void *native_state_changed_userdata = nullptr;
+
+	double update_interval = 0.0;
+	double tick_countdown = 0.0;
+	double pending_delta = 0.0;
+	bool scheduled = false;
 
 	HashMap<TransitionKey, Transition, TransitionKeyHasher> transitions;
 
-	void _get_transition(LimboState *p_from_state, const StringName &p_event, Transition &r_transition) const;
+	// Transitions compiled into a dense table: one row per child (plus ANYSTATE row at the end),
+	// one column per event. Rebuilt lazily when transitions or children change.
+	LocalVector<int> event_columns; // Indexed by event ID, -1 if there is no column.
+	LocalVector<LimboState *> transition_table;
+	int num_event_columns = 0;
+	bool transition_table_dirty = true;
+
+	// Where an event can be consumed, indexed by event ID, so that levels without a handler or transition for it are
+	// skipped. Rebuilt when LimboState::routing_epoch changes.
+	enum RouteFlags : uint8_t {
+		ROUTE_LEVEL = 1, // By a handler of this state machine or one of its transitions.
+		ROUTE_SUBTREE = 2, // Anywhere in this state machine, including nested ones.
+	};
+	LocalVector<uint8_t> event_routes;
+	uint64_t event_routes_epoch = 0;
+
+	void _build_event_routes();
+	_FORCE_INLINE_ uint8_t _get_event_route(int p_event_id) {
+		if (unlikely(event_routes_epoch != routing_epoch)) {
+			_build_event_routes();
+		}
+		return p_event_id < (int)event_routes.size() ? event_routes[p_event_id] : 0;
+	}
+
+	void _build_transition_table();
+	void _update_processing();
+	void _update_scheduling();
+
+	friend class BTScheduler;
+	// Accumulates delta time and returns true when a scheduled update is due.
+	_FORCE_INLINE_ bool _advance(double p_delta) {
+		pending_delta += p_delta;
+		if (update_interval <= 0.0) {
+			return true;
+		}
+		tick_countdown -= p_delta;
+		return tick_countdown <= 0.0;
+	}
+	_FORCE_INLINE_ double _consume_pending_delta() {
+		double delta = pending_delta;
+		pending_delta = 0.0;
+		if (update_interval > 0.0) {
+			tick_countdown += update_interval;
+			if (tick_countdown <= 0.0) {
+				tick_countdown = update_interval;
+			}
+		}
+		return delta;
+	}
+
+	struct QueuedEvent {
+		int event_id = LimboEventRegistry::INVALID_EVENT;
+		Variant cargo;
+	};
+
+	// Bounded FIFO of events waiting to be dispatched on the next update. Guarded by queue_lock.
+	LocalVector<QueuedEvent> event_queue;
+	uint32_t queue_head = 0;
+	uint32_t queue_size = 0;
+	int event_queue_capacity = 64;
+	SpinLock queue_lock;
+
+	// Channels this state machine reads broadcast events from, with the next message to read in each.
+	struct Subscription {
+		Ref<LimboEventChannel> channel;
+		uint64_t next_sequence = 0;
+	};
+	LocalVector<Subscription> subscriptions;
+
+	bool _push_event(int p_event_id, const Variant &p_cargo);
+	void _drain_event_queue();
+	void _drain_subscriptions();
+	LimboHSM *_get_root_hsm();
+
+	// Handling of an event at this level, after the active state didn't consume it: own handlers, then transitions.
+	bool _handle_event(int p_event_id, const Variant &p_cargo);
+
+	friend class BTState;
+	// Same as get_root()->_dispatch() for an active state, but walks up the parent chain instead of descending
+	// through the active state of every level.
+	static bool _dispatch_from_active(LimboState *p_state, int p_event_id, const Variant &p_cargo);
 
 protected:
 	static void _bind_methods();
@@ -67,19 +170,24 @@ protected:
 	void _validate_property(PropertyInfo &p_property) const;
 
 	virtual void _initialize(Node *p_agent, const Ref<Blackboard> &p_blackboard) override;
-	virtual bool _dispatch(const StringName &p_event, const Variant &p_cargo = Variant()) override;
+	virtual bool _dispatch(int p_event_id, const Variant &p_cargo = Variant()) override;
 
 	virtual void _enter() override;
 	virtual void _exit() override;
 	virtual void _update(double p_delta) override;
 
 public:
-	void set_update_mode(UpdateMode p_mode) { update_mode = p_mode; }
+	void set_update_mode(UpdateMode p_mode);
 	UpdateMode get_update_mode() const { return update_mode; }
 
+	void set_update_interval(double p_interval);
+	double get_update_interval() const { return update_interval; }
+
 	void set_active(bool p_active);
 
 	void change_active_state(LimboState *p_state);
+	// Replaces the native listener of active state changes. Pass nullptr to remove it.
+	void set_native_state_changed_listener(NativeStateChangedListener p_listener, void *p_userdata = nullptr);
 
 	LimboState *get_active_state() const { return active_state; }
 	LimboState *get_previous_active_state() const { return previous_active; }
@@ -92,6 +200,18 @@ public:
 
 	void update(double p_delta);
 
+	void set_event_queue_capacity(int p_capacity);
+	int get_event_queue_capacity() const { return event_queue_capacity; }
+	// Thread-safe. The event is dispatched on the next update of this state machine.
+	bool queue_event(const StringName &p_event, const Variant &p_cargo = Variant());
+	bool queue_event_id(int p_event_id, const Variant &p_cargo = Variant());
+	int get_queued_event_count();
+
+	// Events posted to the channel after subscribing are dispatched on updates of this state machine, after queued events.
+	void subscribe(const Ref<LimboEventChannel> &p_channel);
+	void unsubscribe(const Ref<LimboEventChannel> &p_channel);
+	bool is_subscribed(const Ref<LimboEventChannel> &p_channel);
+
 	void add_transition(LimboState *p_from_state, LimboState *p_to_state, const StringName &p_event);
 	void remove_transition(LimboState *p_from_state, const StringName &p_event);
 	bool has_transition(LimboState *p_from_state, const StringName &p_event) const { return transitions.has(Transition::make_key(p_from_state, p_event)); }
@@ -99,6 +219,7 @@ public:
 	LimboState *anystate() const { return nullptr; }
 
 	LimboHSM();
+	~LimboHSM();
 };
 
 #endif // LIMBO_HSM_H
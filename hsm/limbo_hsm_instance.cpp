@@ -0,0 +1,298 @@
+/**
+ * limbo_hsm_instance.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "limbo_hsm_instance.h"
+
+#include "../util/limbo_compat.h"
+#include "../util/limbo_string_names.h"
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/core/class_db.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+Variant LimboHSMInstance::_call(const Callable &p_callable, const Variant *p_arg) {
+	Variant ret;
+#ifdef LIMBOAI_MODULE
+	Callable::CallError ce;
+	const Variant *argptrs[1] = { p_arg };
+	const int argcount = p_arg ? 1 : 0;
+	p_callable.callp(argptrs, argcount, ret, ce);
+	if (unlikely(ce.error != Callable::CallError::CALL_OK)) {
+		ERR_PRINT("LimboHSMInstance: Error calling " + Variant::get_callable_error_text(p_callable, argptrs, argcount, ce));
+	}
+#elif LIMBOAI_GDEXTENSION
+	if (p_arg == nullptr) {
+		ret = p_callable.call();
+	} else {
+		ret = p_callable.call(*p_arg);
+	}
+#endif
+	return ret;
+}
+
+void LimboHSMInstance::_build_transition_table(const LocalVector<CompiledTransition> &p_transitions) {
+	event_columns.clear();
+	num_event_columns = 0;
+	for (const CompiledTransition &t : p_transitions) {
+		if (t.event_id >= (int)event_columns.size()) {
+			int old_size = event_columns.size();
+			event_columns.resize(t.event_id + 1);
+			for (int i = old_size; i <= t.event_id; i++) {
+				event_columns[i] = -1;
+			}
+		}
+		if (event_columns[t.event_id] < 0) {
+			event_columns[t.event_id] = num_event_columns++;
+		}
+	}
+
+	const int num_rows = states.size() + 1;
+	transition_table.resize(num_rows * num_event_columns);
+	for (int &target : transition_table) {
+		target = -1;
+	}
+	for (const CompiledTransition &t : p_transitions) {
+		const int row = t.from_index >= 0 ? t.from_index : (int)states.size();
+		transition_table[row * num_event_columns + event_columns[t.event_id]] = t.to_index;
+	}
+}
+
+int LimboHSMInstance::_find_state(const StringName &p_state_name) const {
+	for (uint32_t i = 0; i < states.size(); i++) {
+		if (states[i].name == p_state_name) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+void LimboHSMInstance::_enter(int p_index) {
+	active_index = p_index;
+	const State &state = states[p_index];
+	if (state.enter_callable.is_valid()) {
+		_call(state.enter_callable, nullptr);
+	}
+}
+
+void LimboHSMInstance::_exit(int p_index) {
+	const State &state = states[p_index];
+	if (state.bt_instance.is_valid()) {
+		state.bt_instance->get_root_task()->abort();
+		state.bt_instance->wake();
+	}
+	if (state.exit_callable.is_valid()) {
+		_call(state.exit_callable, nullptr);
+	}
+}
+
+void LimboHSMInstance::_set_active_index(int p_index) {
+	const int prev = active_index;
+	if (prev >= 0) {
+		_exit(prev);
+		previous_index = prev;
+	}
+	_enter(p_index);
+	emit_signal(LW_NAME(active_state_changed), states[p_index].name, prev >= 0 ? states[prev].name : StringName());
+}
+
+void LimboHSMInstance::set_active(bool p_active) {
+	ERR_FAIL_COND_MSG(states.is_empty(), "LimboHSMInstance: Instance is not valid.");
+	if (p_active == is_active()) {
+		return;
+	}
+	if (p_active) {
+		_set_active_index(initial_index);
+	} else {
+		const int prev = active_index;
+		_exit(prev);
+		previous_index = prev;
+		active_index = -1;
+	}
+}
+
+void LimboHSMInstance::update(double p_delta) {
+	ERR_FAIL_COND_MSG(!is_active(), "LimboHSMInstance: Unable to update an inactive state machine.");
+	const int index = active_index;
+	const State &state = states[index];
+	if (state.update_callable.is_valid()) {
+		const Variant delta = p_delta;
+		_call(state.update_callable, &delta);
+		if (active_index != index) {
+			// Bail out if a transition happened in the meantime.
+			return;
+		}
+	}
+	if (state.bt_instance.is_valid() && state.bt_instance->advance(p_delta)) {
+		BT::Status status = state.bt_instance->update(state.bt_instance->consume_pending_delta());
+		if (status == BTTask::SUCCESS) {
+			dispatch_id(state.success_event_id);
+		} else if (status == BTTask::FAILURE) {
+			dispatch_id(state.failure_event_id);
+		}
+	}
+}
+
+bool LimboHSMInstance::dispatch(const StringName &p_event, const Variant &p_cargo) {
+	ERR_FAIL_COND_V(p_event == StringName(), false);
+	const int event_id = LimboEventRegistry::find(p_event);
+	if (event_id == LimboEventRegistry::INVALID_EVENT) {
+		// * Nothing can handle an event that was never registered.
+		return false;
+	}
+	return dispatch_id(event_id, p_cargo);
+}
+
+bool LimboHSMInstance::dispatch_id(int p_event_id, const Variant &p_cargo) {
+	if (p_event_id < 0 || !is_active()) {
+		return false;
+	}
+
+	bool event_consumed = false;
+	const State &state = states[active_index];
+	if (p_event_id < (int)state.handlers.size() && state.handlers[p_event_id].is_valid()) {
+		Variant ret = _call(state.handlers[p_event_id], p_cargo.get_type() == Variant::NIL ? nullptr : &p_cargo);
+		if (unlikely(ret.get_type() != Variant::BOOL)) {
+			ERR_PRINT("LimboHSMInstance: Event handler returned unexpected type: " + Variant::get_type_name(ret.get_type()));
+		} else {
+			event_consumed = ret;
+		}
+	}
+
+	if (!event_consumed && is_active()) {
+		const int column = p_event_id < (int)event_columns.size() ? event_columns[p_event_id] : -1;
+		int to_index = -1;
+		if (column >= 0) {
+			to_index = transition_table[active_index * num_event_columns + column];
+			if (to_index < 0) {
+				to_index = transition_table[states.size() * num_event_columns + column];
+				if (to_index == active_index) {
+					// Transitions to self are not allowed with ANYSTATE.
+					to_index = -1;
+				}
+			}
+		}
+		if (to_index >= 0) {
+			bool permitted = true;
+			const Callable &guard = states[to_index].guard_callable;
+			if (guard.is_valid()) {
+				Variant ret = _call(guard, nullptr);
+				if (unlikely(ret.get_type() != Variant::BOOL)) {
+					ERR_PRINT_ONCE(vformat("LimboHSMInstance: Guard callable of state \"%s\" returned non-boolean value.", states[to_index].name));
+				} else {
+					permitted = ret;
+				}
+			}
+			if (permitted) {
+				_set_active_index(to_index);
+				event_consumed = true;
+			}
+		}
+	}
+
+	if (!event_consumed && p_event_id == LimboEventRegistry::EVENT_FINISHED) {
+		set_active(false);
+	}
+
+	return event_consumed;
+}
+
+void LimboHSMInstance::change_active_state(const StringName &p_state_name) {
+	ERR_FAIL_COND_MSG(!is_active(), "LimboHSMInstance: Unable to change active state when the state machine is not active.");
+	const int index = _find_state(p_state_name);
+	ERR_FAIL_COND_MSG(index == -1, vformat("LimboHSMInstance: State \"%s\" not found.", p_state_name));
+	_set_active_index(index);
+}
+
+StringName LimboHSMInstance::get_active_state() const {
+	return active_index >= 0 ? states[active_index].name : StringName();
+}
+
+StringName LimboHSMInstance::get_previous_active_state() const {
+	return previous_index >= 0 ? states[previous_index].name : StringName();
+}
+
+Ref<BTInstance> LimboHSMInstance::get_bt_instance(const StringName &p_state_name) const {
+	const int index = _find_state(p_state_name);
+	ERR_FAIL_COND_V_MSG(index == -1, nullptr, vformat("LimboHSMInstance: State \"%s\" not found.", p_state_name));
+	return states[index].bt_instance;
+}
+
+void LimboHSMInstance::call_on_enter(const StringName &p_state_name, const Callable &p_callable) {
+	const int index = _find_state(p_state_name);
+	ERR_FAIL_COND_MSG(index == -1, vformat("LimboHSMInstance: State \"%s\" not found.", p_state_name));
+	states[index].enter_callable = p_callable;
+}
+
+void LimboHSMInstance::call_on_exit(const StringName &p_state_name, const Callable &p_callable) {
+	const int index = _find_state(p_state_name);
+	ERR_FAIL_COND_MSG(index == -1, vformat("LimboHSMInstance: State \"%s\" not found.", p_state_name));
+	states[index].exit_callable = p_callable;
+}
+
+void LimboHSMInstance::call_on_update(const StringName &p_state_name, const Callable &p_callable) {
+	const int index = _find_state(p_state_name);
+	ERR_FAIL_COND_MSG(index == -1, vformat("LimboHSMInstance: State \"%s\" not found.", p_state_name));
+	states[index].update_callable = p_callable;
+}
+
+void LimboHSMInstance::set_guard(const StringName &p_state_name, const Callable &p_guard_callable) {
+	const int index = _find_state(p_state_name);
+	ERR_FAIL_COND_MSG(index == -1, vformat("LimboHSMInstance: State \"%s\" not found.", p_state_name));
+	states[index].guard_callable = p_guard_callable;
+}
+
+void LimboHSMInstance::add_event_handler(const StringName &p_state_name, const StringName &p_event, const Callable &p_handler) {
+	ERR_FAIL_COND(p_event == StringName());
+	ERR_FAIL_COND(!p_handler.is_valid());
+	const int index = _find_state(p_state_name);
+	ERR_FAIL_COND_MSG(index == -1, vformat("LimboHSMInstance: State \"%s\" not found.", p_state_name));
+	LocalVector<Callable> &handlers = states[index].handlers;
+	const int event_id = LimboEventRegistry::intern(p_event);
+	if (event_id >= (int)handlers.size()) {
+		handlers.resize(event_id + 1);
+	}
+	handlers[event_id] = p_handler;
+}
+
+void LimboHSMInstance::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("get_agent"), &LimboHSMInstance::get_agent);
+	ClassDB::bind_method(D_METHOD("get_blackboard"), &LimboHSMInstance::get_blackboard);
+	ClassDB::bind_method(D_METHOD("is_active"), &LimboHSMInstance::is_active);
+	ClassDB::bind_method(D_METHOD("set_active", "active"), &LimboHSMInstance::set_active);
+	ClassDB::bind_method(D_METHOD("update", "delta"), &LimboHSMInstance::update);
+	ClassDB::bind_method(D_METHOD("dispatch", "event", "cargo"), &LimboHSMInstance::dispatch, DEFVAL(Variant()));
+	ClassDB::bind_method(D_METHOD("dispatch_id", "event_id", "cargo"), &LimboHSMInstance::dispatch_id, DEFVAL(Variant()));
+	ClassDB::bind_method(D_METHOD("change_active_state", "state_name"), &LimboHSMInstance::change_active_state);
+	ClassDB::bind_method(D_METHOD("get_active_state"), &LimboHSMInstance::get_active_state);
+	ClassDB::bind_method(D_METHOD("get_previous_active_state"), &LimboHSMInstance::get_previous_active_state);
+	ClassDB::bind_method(D_METHOD("get_state_count"), &LimboHSMInstance::get_state_count);
+	ClassDB::bind_method(D_METHOD("has_state", "state_name"), &LimboHSMInstance::has_state);
+	ClassDB::bind_method(D_METHOD("get_bt_instance", "state_name"), &LimboHSMInstance::get_bt_instance);
+	ClassDB::bind_method(D_METHOD("call_on_enter", "state_name", "callable"), &LimboHSMInstance::call_on_enter);
+	ClassDB::bind_method(D_METHOD("call_on_exit", "state_name", "callable"), &LimboHSMInstance::call_on_exit);
+	ClassDB::bind_method(D_METHOD("call_on_update", "state_name", "callable"), &LimboHSMInstance::call_on_update);
+	ClassDB::bind_method(D_METHOD("set_guard", "state_name", "guard_callable"), &LimboHSMInstance::set_guard);
+	ClassDB::bind_method(D_METHOD("add_event_handler", "state_name", "event", "handler"), &LimboHSMInstance::add_event_handler);
+
+	ADD_SIGNAL(MethodInfo("active_state_changed",
+			PropertyInfo(Variant::STRING_NAME, "current"),
+			PropertyInfo(Variant::STRING_NAME, "previous")));
+}
+
+LimboHSMInstance::~LimboHSMInstance() {
+#ifdef DEBUG_ENABLED
+	for (const State &state : states) {
+		if (state.bt_instance.is_valid()) {
+			state.bt_instance->unregister_with_debugger();
+		}
+	}
+#endif
+}
@@ -0,0 +1,108 @@
+/**
+ * limbo_hsm_instance.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef LIMBO_HSM_INSTANCE_H
+#define LIMBO_HSM_INSTANCE_H
+
+#include "../blackboard/blackboard.h"
+#include "../bt/bt_instance.h"
+#include "limbo_event_registry.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/object/ref_counted.h"
+#include "core/templates/local_vector.h"
+#include "core/variant/callable.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/ref_counted.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/variant/callable.hpp>
+using namespace godot;
+#endif // LIMBOAI_GDEXTENSION
+
+// Runtime state machine created by LimboHSMResource.instantiate().
+// States are plain structs indexed by position, so no nodes are added to the scene tree.
+class LimboHSMInstance : public RefCounted {
+	GDCLASS(LimboHSMInstance, RefCounted);
+	friend class LimboHSMResource;
+
+private:
+	struct State {
+		StringName name;
+		Ref<BTInstance> bt_instance;
+		int success_event_id = LimboEventRegistry::INVALID_EVENT;
+		int failure_event_id = LimboEventRegistry::INVALID_EVENT;
+		Callable enter_callable;
+		Callable exit_callable;
+		Callable update_callable;
+		Callable guard_callable;
+		LocalVector<Callable> handlers; // Indexed by event ID.
+	};
+
+	struct CompiledTransition {
+		int from_index; // -1 for ANYSTATE.
+		int to_index;
+		int event_id;
+	};
+
+	uint64_t agent_id = 0;
+	Ref<Blackboard> blackboard;
+	LocalVector<State> states;
+
+	// Target state index (or -1) per (from state, event column); the ANYSTATE row is the last one.
+	LocalVector<int> transition_table;
+	LocalVector<int> event_columns; // Indexed by event ID; -1 if no transition uses the event.
+	int num_event_columns = 0;
+
+	int initial_index = 0;
+	int active_index = -1;
+	int previous_index = -1;
+
+	void _build_transition_table(const LocalVector<CompiledTransition> &p_transitions);
+	int _find_state(const StringName &p_state_name) const;
+	void _set_active_index(int p_index);
+	void _enter(int p_index);
+	void _exit(int p_index);
+	static Variant _call(const Callable &p_callable, const Variant *p_arg);
+
+protected:
+	static void _bind_methods();
+
+public:
+	_FORCE_INLINE_ Node *get_agent() const { return agent_id ? Object::cast_to<Node>(OBJECT_DB_GET_INSTANCE(agent_id)) : nullptr; }
+	_FORCE_INLINE_ Ref<Blackboard> get_blackboard() const { return blackboard; }
+	_FORCE_INLINE_ bool is_active() const { return active_index >= 0; }
+
+	void set_active(bool p_active);
+	void update(double p_delta);
+
+	bool dispatch(const StringName &p_event, const Variant &p_cargo = Variant());
+	bool dispatch_id(int p_event_id, const Variant &p_cargo = Variant());
+
+	void change_active_state(const StringName &p_state_name);
+	StringName get_active_state() const;
+	StringName get_previous_active_state() const;
+	int get_state_count() const { return states.size(); }
+	bool has_state(const StringName &p_state_name) const { return _find_state(p_state_name) != -1; }
+	Ref<BTInstance> get_bt_instance(const StringName &p_state_name) const;
+
+	void call_on_enter(const StringName &p_state_name, const Callable &p_callable);
+	void call_on_exit(const StringName &p_state_name, const Callable &p_callable);
+	void call_on_update(const StringName &p_state_name, const Callable &p_callable);
+	void set_guard(const StringName &p_state_name, const Callable &p_guard_callable);
+	void add_event_handler(const StringName &p_state_name, const StringName &p_event, const Callable &p_handler);
+
+	LimboHSMInstance() = default;
+	~LimboHSMInstance();
+};
+
+#endif // LIMBO_HSM_INSTANCE_H
@@ -0,0 +1,184 @@
+/**
+ * limbo_hsm_resource.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "limbo_hsm_resource.h"
+
+#include "../util/limbo_compat.h"
+
+void LimboHSMResource::set_states(const TypedArray<LimboStateResource> &p_states) {
+	states = p_states;
+	emit_changed();
+}
+
+void LimboHSMResource::set_transitions(const TypedArray<Dictionary> &p_transitions) {
+	transitions = p_transitions;
+	emit_changed();
+}
+
+void LimboHSMResource::set_initial_state(const StringName &p_state_name) {
+	initial_state = p_state_name;
+	emit_changed();
+}
+
+void LimboHSMResource::set_blackboard_plan(const Ref<BlackboardPlan> &p_plan) {
+	blackboard_plan = p_plan;
+	emit_changed();
+}
+
+void LimboHSMResource::add_state(const Ref<LimboStateResource> &p_state) {
+	ERR_FAIL_COND(p_state.is_null());
+	ERR_FAIL_COND_MSG(p_state->get_state_name() == StringName(), "LimboHSMResource: Unable to add a state without a name.");
+	ERR_FAIL_COND_MSG(get_state(p_state->get_state_name()).is_valid(), vformat("LimboHSMResource: State \"%s\" already exists.", p_state->get_state_name()));
+	states.push_back(p_state);
+	emit_changed();
+}
+
+Ref<LimboStateResource> LimboHSMResource::get_state(const StringName &p_state_name) const {
+	for (int i = 0; i < states.size(); i++) {
+		Ref<LimboStateResource> state = states[i];
+		if (state.is_valid() && state->get_state_name() == p_state_name) {
+			return state;
+		}
+	}
+	return Ref<LimboStateResource>();
+}
+
+int LimboHSMResource::_find_transition(const StringName &p_from_state, const StringName &p_event) const {
+	for (int i = 0; i < transitions.size(); i++) {
+		Dictionary t = transitions[i];
+		if (StringName(t.get("from", StringName())) == p_from_state && StringName(t.get("event", StringName())) == p_event) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+void LimboHSMResource::add_transition(const StringName &p_from_state, const StringName &p_to_state, const StringName &p_event) {
+	ERR_FAIL_COND_MSG(p_to_state == StringName(), "LimboHSMResource: Unable to add a transition to an unnamed state.");
+	ERR_FAIL_COND_MSG(p_event == StringName(), "LimboHSMResource: Failed to add transition due to empty event string.");
+	ERR_FAIL_COND_MSG(has_transition(p_from_state, p_event), "LimboHSMResource: Unable to add another transition with the same event and origin.");
+	Dictionary t;
+	t["from"] = p_from_state;
+	t["to"] = p_to_state;
+	t["event"] = p_event;
+	transitions.push_back(t);
+	emit_changed();
+}
+
+void LimboHSMResource::remove_transition(const StringName &p_from_state, const StringName &p_event) {
+	int idx = _find_transition(p_from_state, p_event);
+	ERR_FAIL_COND_MSG(idx == -1, "LimboHSMResource: Unable to remove a transition that does not exist.");
+	transitions.remove_at(idx);
+	emit_changed();
+}
+
+Ref<LimboHSMInstance> LimboHSMResource::instantiate(Node *p_agent, const Ref<Blackboard> &p_parent_scope, Node *p_custom_scene_root) const {
+	ERR_FAIL_NULL_V_MSG(p_agent, nullptr, "LimboHSMResource: Instantiation failed - agent can't be null.");
+	ERR_FAIL_COND_V_MSG(states.is_empty(), nullptr, "LimboHSMResource: Instantiation failed - there are no states.");
+	Node *scene_root = p_custom_scene_root;
+	if (scene_root == nullptr) {
+		scene_root = p_agent->get_owner() ? p_agent->get_owner() : p_agent;
+	}
+
+	Ref<Blackboard> blackboard;
+	if (blackboard_plan.is_valid()) {
+		blackboard = blackboard_plan->create_blackboard(p_agent, p_parent_scope, scene_root);
+	} else {
+		blackboard = Ref<Blackboard>(memnew(Blackboard));
+		blackboard->set_parent(p_parent_scope);
+	}
+
+	Ref<LimboHSMInstance> inst = memnew(LimboHSMInstance);
+	inst->agent_id = p_agent->get_instance_id();
+	inst->blackboard = blackboard;
+
+	HashMap<StringName, int> state_indices;
+	for (int i = 0; i < states.size(); i++) {
+		Ref<LimboStateResource> def = states[i];
+		ERR_FAIL_COND_V_MSG(def.is_null(), nullptr, vformat("LimboHSMResource: Instantiation failed - state at index %d is null.", i));
+		ERR_FAIL_COND_V_MSG(state_indices.has(def->get_state_name()), nullptr, vformat("LimboHSMResource: Instantiation failed - duplicate state name \"%s\".", def->get_state_name()));
+		state_indices.insert(def->get_state_name(), i);
+
+		LimboHSMInstance::State state;
+		state.name = def->get_state_name();
+		if (def->get_behavior_tree().is_valid()) {
+			// * Each BT leaf gets its own scope, like BTState.
+			Ref<Blackboard> bt_scope;
+			Ref<BlackboardPlan> bt_plan = def->get_behavior_tree()->get_blackboard_plan();
+			if (bt_plan.is_valid()) {
+				bt_scope = bt_plan->create_blackboard(p_agent, blackboard, scene_root);
+			} else {
+				bt_scope = Ref<Blackboard>(memnew(Blackboard));
+				bt_scope->set_parent(blackboard);
+			}
+			state.bt_instance = def->get_behavior_tree()->instantiate(p_agent, bt_scope, p_agent, scene_root);
+			ERR_FAIL_COND_V_MSG(state.bt_instance.is_null(), nullptr, vformat("LimboHSMResource: Instantiation failed - unable to instantiate behavior tree of state \"%s\".", state.name));
+			state.bt_instance->set_update_interval(def->get_update_interval());
+			state.success_event_id = def->get_success_event() == StringName() ? LimboEventRegistry::INVALID_EVENT : LimboEventRegistry::intern(def->get_success_event());
+			state.failure_event_id = def->get_failure_event() == StringName() ? LimboEventRegistry::INVALID_EVENT : LimboEventRegistry::intern(def->get_failure_event());
+#ifdef DEBUG_ENABLED
+			state.bt_instance->register_with_debugger();
+#endif
+		}
+		inst->states.push_back(state);
+	}
+
+	inst->initial_index = 0;
+	if (initial_state != StringName()) {
+		const int *idx = state_indices.getptr(initial_state);
+		ERR_FAIL_NULL_V_MSG(idx, nullptr, vformat("LimboHSMResource: Instantiation failed - initial state \"%s\" not found.", initial_state));
+		inst->initial_index = *idx;
+	}
+
+	LocalVector<LimboHSMInstance::CompiledTransition> compiled;
+	for (int i = 0; i < transitions.size(); i++) {
+		Dictionary t = transitions[i];
+		StringName from = t.get("from", StringName());
+		StringName to = t.get("to", StringName());
+		StringName event = t.get("event", StringName());
+		const int *to_idx = state_indices.getptr(to);
+		ERR_CONTINUE_MSG(to_idx == nullptr, vformat("LimboHSMResource: Transition to unknown state \"%s\" is ignored.", to));
+		ERR_CONTINUE_MSG(event == StringName(), "LimboHSMResource: Transition with an empty event is ignored.");
+		int from_idx = -1;
+		if (from != StringName()) {
+			const int *idx = state_indices.getptr(from);
+			ERR_CONTINUE_MSG(idx == nullptr, vformat("LimboHSMResource: Transition from unknown state \"%s\" is ignored.", from));
+			from_idx = *idx;
+		}
+		compiled.push_back({ from_idx, *to_idx, LimboEventRegistry::intern(event) });
+	}
+	inst->_build_transition_table(compiled);
+
+	return inst;
+}
+
+void LimboHSMResource::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_states", "states"), &LimboHSMResource::set_states);
+	ClassDB::bind_method(D_METHOD("get_states"), &LimboHSMResource::get_states);
+	ClassDB::bind_method(D_METHOD("set_transitions", "transitions"), &LimboHSMResource::set_transitions);
+	ClassDB::bind_method(D_METHOD("get_transitions"), &LimboHSMResource::get_transitions);
+	ClassDB::bind_method(D_METHOD("set_initial_state", "state_name"), &LimboHSMResource::set_initial_state);
+	ClassDB::bind_method(D_METHOD("get_initial_state"), &LimboHSMResource::get_initial_state);
+	ClassDB::bind_method(D_METHOD("set_blackboard_plan", "plan"), &LimboHSMResource::set_blackboard_plan);
+	ClassDB::bind_method(D_METHOD("get_blackboard_plan"), &LimboHSMResource::get_blackboard_plan);
+
+	ClassDB::bind_method(D_METHOD("add_state", "state"), &LimboHSMResource::add_state);
+	ClassDB::bind_method(D_METHOD("get_state", "state_name"), &LimboHSMResource::get_state);
+	ClassDB::bind_method(D_METHOD("add_transition", "from_state", "to_state", "event"), &LimboHSMResource::add_transition);
+	ClassDB::bind_method(D_METHOD("remove_transition", "from_state", "event"), &LimboHSMResource::remove_transition);
+	ClassDB::bind_method(D_METHOD("has_transition", "from_state", "event"), &LimboHSMResource::has_transition);
+	ClassDB::bind_method(D_METHOD("instantiate", "agent", "parent_scope", "custom_scene_root"), &LimboHSMResource::instantiate, DEFVAL(Variant()), DEFVAL(Variant()));
+
+	ADD_PROPERTY(PropertyInfo(Variant::ARRAY, "states", PROPERTY_HINT_ARRAY_TYPE, RESOURCE_TYPE_HINT("LimboStateResource")), "set_states", "get_states");
+	ADD_PROPERTY(PropertyInfo(Variant::ARRAY, "transitions", PROPERTY_HINT_ARRAY_TYPE, "Dictionary"), "set_transitions", "get_transitions");
+	ADD_PROPERTY(PropertyInfo(Variant::STRING_NAME, "initial_state"), "set_initial_state", "get_initial_state");
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "blackboard_plan", PROPERTY_HINT_RESOURCE_TYPE, "BlackboardPlan", PROPERTY_USAGE_DEFAULT | PROPERTY_USAGE_ALWAYS_DUPLICATE), "set_blackboard_plan", "get_blackboard_plan");
+}
@@ -0,0 +1,69 @@
+/**
+ * limbo_hsm_resource.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef LIMBO_HSM_RESOURCE_H
+#define LIMBO_HSM_RESOURCE_H
+
+#include "../blackboard/blackboard_plan.h"
+#include "limbo_hsm_instance.h"
+#include "limbo_state_resource.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/io/resource.h"
+#include "core/variant/typed_array.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/resource.hpp>
+#include <godot_cpp/variant/typed_array.hpp>
+using namespace godot;
+#endif // LIMBOAI_GDEXTENSION
+
+// State machine defined as a resource. Unlike LimboHSM, the states of its instances are not scene nodes.
+class LimboHSMResource : public Resource {
+	GDCLASS(LimboHSMResource, Resource);
+
+private:
+	TypedArray<LimboStateResource> states;
+	// Each transition is a Dictionary with "from", "to" and "event" keys. Empty "from" stands for ANYSTATE.
+	TypedArray<Dictionary> transitions;
+	StringName initial_state;
+	Ref<BlackboardPlan> blackboard_plan;
+
+	int _find_transition(const StringName &p_from_state, const StringName &p_event) const;
+
+protected:
+	static void _bind_methods();
+
+public:
+	void set_states(const TypedArray<LimboStateResource> &p_states);
+	TypedArray<LimboStateResource> get_states() const { return states; }
+
+	void set_transitions(const TypedArray<Dictionary> &p_transitions);
+	TypedArray<Dictionary> get_transitions() const { return transitions; }
+
+	void set_initial_state(const StringName &p_state_name);
+	StringName get_initial_state() const { return initial_state; }
+
+	void set_blackboard_plan(const Ref<BlackboardPlan> &p_plan);
+	Ref<BlackboardPlan> get_blackboard_plan() const { return blackboard_plan; }
+
+	void add_state(const Ref<LimboStateResource> &p_state);
+	Ref<LimboStateResource> get_state(const StringName &p_state_name) const;
+
+	void add_transition(const StringName &p_from_state, const StringName &p_to_state, const StringName &p_event);
+	void remove_transition(const StringName &p_from_state, const StringName &p_event);
+	bool has_transition(const StringName &p_from_state, const StringName &p_event) const { return _find_transition(p_from_state, p_event) != -1; }
+
+	Ref<LimboHSMInstance> instantiate(Node *p_agent, const Ref<Blackboard> &p_parent_scope = Ref<Blackboard>(), Node *p_custom_scene_root = nullptr) const;
+};
+
+#endif // LIMBO_HSM_RESOURCE_H
@@ -40,9 +40,8 @@ Node *LimboState::_get_prefetch_root_for_base_plan() {
 Ref<BlackboardPlan> LimboState::_get_parent_scope_plan() const {
 	BlackboardPlan *parent_plan = nullptr;
 	const LimboState *state = this;
-	while (state->get_parent() && IS_CLASS(state->get_parent(), LimboState)) {
-		state = Object::cast_to<LimboState>(state->get_parent());
-		ERR_FAIL_NULL_V(state, parent_plan);
+	while (state->parent_state) {
+		state = state->parent_state;
 		if (state->blackboard_plan.is_valid()) {
 			parent_plan = state->blackboard_plan.ptr();
 			break;
@@ -52,11 +51,11 @@ Ref<BlackboardPlan> LimboState::_get_parent_scope_plan() const {
 }
 
 LimboState *LimboState::get_root() const {
-	const Node *state = this;
-	while (state->get_parent() && IS_CLASS(state->get_parent(), LimboState)) {
-		state = state->get_parent();
+	const LimboState *state = this;
+	while (state->parent_state) {
+		state = state->parent_state;
 	}
-	return const_cast<LimboState *>(Object::cast_to<LimboState>(state));
+	return const_cast<LimboState *>(state);
 }
 
 LimboState *LimboState::named(const String &p_name) {
@@ -65,6 +64,7 @@ LimboState *LimboState::named(const String &p_name) {
 }
 
 void LimboState::_enter() {
+	_ensure_blackboard();
 	active = true;
 	GDVIRTUAL_CALL(_enter);
 	emit_signal(LW_NAME(entered));
@@ -81,7 +81,7 @@ void LimboState::_exit() {
 
 void LimboState::_update(double p_delta) {
 	GDVIRTUAL_CALL(_update, p_delta);
-	emit_signal(LW_NAME(updated), p_delta);
+	_emit_updated(p_delta);
 }
 
 void LimboState::_setup() {
@@ -92,48 +92,66 @@ void LimboState::_setup() {
 void LimboState::_initialize(Node *p_agent, const Ref<Blackboard> &p_blackboard) {
 	ERR_FAIL_COND(p_agent == nullptr);
 	agent = p_agent;
+	handles_input = has_method(LW_NAME(_input));
+	if (guard_type == GUARD_VAR_CHECK) {
+		// * The handle is resolved against the blackboard of this state, which is replaced below.
+		const StringName guard_var = guard_var_handle.name;
+		guard_var_handle = BBVarHandle();
+		guard_var_handle.name = guard_var;
+	}
 
 	if (_should_use_new_scope()) {
 		blackboard->set_parent(p_blackboard);
 	} else {
 		blackboard = p_blackboard;
 	}
+	blackboard_pending = true;
+
+	_setup();
+}
+
+void LimboState::_populate_blackboard() const {
+	blackboard_pending = false;
+	// * Variables of the parent scopes must be there before the plan of this state is applied.
+	if (parent_state) {
+		parent_state->_ensure_blackboard();
+	}
 	if (blackboard_plan.is_valid() && !blackboard_plan->is_empty()) {
+		LimboState *self = const_cast<LimboState *>(this);
 		// Don't overwrite existing blackboard values as they may be initialized from code.
-		blackboard_plan->populate_blackboard(blackboard, false, this, _get_prefetch_root_for_base_plan());
+		blackboard_plan->populate_blackboard(blackboard, false, self, self->_get_prefetch_root_for_base_plan());
 	}
-
-	_setup();
 }
 
-bool LimboState::_dispatch(const StringName &p_event, const Variant &p_cargo) {
-	ERR_FAIL_COND_V(p_event == StringName(), false);
-	if (handlers.size() > 0 && handlers.has(p_event)) {
+bool LimboState::_dispatch(int p_event_id, const Variant &p_cargo) {
+	ERR_FAIL_COND_V(p_event_id < 0, false);
+	if (p_event_id < (int)handlers.size() && handlers[p_event_id].is_valid()) {
+		const Callable &handler = handlers[p_event_id];
 		Variant ret;
 
 #ifdef LIMBOAI_MODULE
 		Callable::CallError ce;
 		if (p_cargo.get_type() == Variant::NIL) {
-			handlers[p_event].callp(nullptr, 0, ret, ce);
+			handler.callp(nullptr, 0, ret, ce);
 			if (ce.error != Callable::CallError::CALL_OK) {
-				ERR_PRINT("Error calling event handler " + Variant::get_callable_error_text(handlers[p_event], nullptr, 0, ce));
+				ERR_PRINT("Error calling event handler " + Variant::get_callable_error_text(handler, nullptr, 0, ce));
 			}
 		} else {
 			const Variant *argptrs[1];
 			argptrs[0] = &p_cargo;
-			handlers[p_event].callp(argptrs, 1, ret, ce);
+			handler.callp(argptrs, 1, ret, ce);
 			if (ce.error != Callable::CallError::CALL_OK) {
-				ERR_PRINT("Error calling event handler " + Variant::get_callable_error_text(handlers[p_event], argptrs, 1, ce));
+				ERR_PRINT("Error calling event handler " + Variant::get_callable_error_text(handler, argptrs, 1, ce));
 			}
 		}
 
 #elif LIMBOAI_GDEXTENSION
 		if (p_cargo.get_type() == Variant::NIL) {
-			ret = handlers[p_event].call();
+			ret = handler.call();
 		} else {
 			Array args;
 			args.append(p_cargo);
-			ret = handlers[p_event].callv(args);
+			ret = handler.callv(args);
 		}
 #endif // LIMBOAI_GDEXTENSION
 
@@ -149,11 +167,27 @@ bool LimboState::_dispatch(const StringName &p_event, const Variant &p_cargo) {
 void LimboState::add_event_handler(const StringName &p_event, const Callable &p_handler) {
 	ERR_FAIL_COND(p_event == StringName());
 	ERR_FAIL_COND(!p_handler.is_valid());
-	handlers.insert(p_event, p_handler);
+	int event_id = LimboEventRegistry::intern(p_event);
+	if (event_id >= (int)handlers.size()) {
+		handlers.resize(event_id + 1);
+	}
+	handlers[event_id] = p_handler;
+	routing_epoch += 1;
 }
 
 bool LimboState::dispatch(const StringName &p_event, const Variant &p_cargo) {
-	return get_root()->_dispatch(p_event, p_cargo);
+	ERR_FAIL_COND_V(p_event == StringName(), false);
+	int event_id = LimboEventRegistry::find(p_event);
+	if (event_id == LimboEventRegistry::INVALID_EVENT) {
+		// * No handler or transition was ever registered for this event.
+		return false;
+	}
+	return get_root()->_dispatch(event_id, p_cargo);
+}
+
+bool LimboState::dispatch_id(int p_event_id, const Variant &p_cargo) {
+	ERR_FAIL_COND_V_MSG(p_event_id < 0 || p_event_id >= LimboEventRegistry::get_count(), false, "LimboState: Invalid event ID.");
+	return get_root()->_dispatch(p_event_id, p_cargo);
 }
 
 LimboState *LimboState::call_on_enter(const Callable &p_callable) {
@@ -174,13 +208,100 @@ LimboState *LimboState::call_on_update(const Callable &p_callable) {
 	return this;
 }
 
+void LimboState::set_native_update_listener(NativeUpdateListener p_listener, void *p_userdata) {
+	native_update_listener = p_listener;
+	native_update_userdata = p_listener ? p_userdata : nullptr;
+}
+
 void LimboState::set_guard(const Callable &p_guard_callable) {
 	ERR_FAIL_COND(!p_guard_callable.is_valid());
+	clear_guard();
+	guard_type = GUARD_CALLABLE;
 	guard_callable = p_guard_callable;
 }
 
+void LimboState::set_native_guard(NativeGuard p_guard, void *p_userdata) {
+	ERR_FAIL_NULL(p_guard);
+	clear_guard();
+	guard_type = GUARD_NATIVE;
+	native_guard = p_guard;
+	native_guard_userdata = p_userdata;
+}
+
+void LimboState::set_guard_var_check(const StringName &p_variable, LimboUtility::CheckType p_check_type, const Variant &p_value) {
+	ERR_FAIL_COND_MSG(p_variable == StringName(), "LimboState: Variable name can't be empty.");
+	clear_guard();
+	guard_type = GUARD_VAR_CHECK;
+	guard_var_handle.name = p_variable;
+	guard_check_type = p_check_type;
+	guard_value = p_value;
+}
+
+void LimboState::set_guard_expression(const String &p_expression) {
+	clear_guard();
+	ERR_FAIL_COND_MSG(guard_expression.parse(p_expression) != OK, "LimboState: Failed to parse guard expression: " + guard_expression.get_error_text());
+	guard_type = GUARD_EXPRESSION;
+}
+
 void LimboState::clear_guard() {
+	guard_type = GUARD_NONE;
 	guard_callable = Callable();
+	native_guard = nullptr;
+	native_guard_userdata = nullptr;
+	guard_var_handle = BBVarHandle();
+	guard_value = Variant();
+	guard_expression.clear();
+}
+
+bool LimboState::_evaluate_guard() {
+	_ensure_blackboard();
+	switch (guard_type) {
+		case GUARD_NONE: {
+			return true;
+		}
+		case GUARD_NATIVE: {
+			return native_guard(this, native_guard_userdata);
+		}
+		case GUARD_VAR_CHECK: {
+			ERR_FAIL_COND_V(blackboard.is_null(), false);
+			Variant var_value;
+			if (!blackboard->try_get_var_by_handle(guard_var_handle, var_value)) {
+				return false;
+			}
+			return LimboUtility::get_singleton()->perform_check(guard_check_type, var_value, guard_value);
+		}
+		case GUARD_EXPRESSION: {
+			bool result = false;
+			if (unlikely(!guard_expression.evaluate_bool(blackboard, agent, result))) {
+				ERR_PRINT_ONCE("LimboState: Failed to evaluate guard expression: " + guard_expression.get_error_text());
+				return false;
+			}
+			return result;
+		}
+		case GUARD_CALLABLE: {
+			if (unlikely(!guard_callable.is_valid())) {
+				return true;
+			}
+			Variant ret;
+
+#ifdef LIMBOAI_MODULE
+			Callable::CallError ce;
+			guard_callable.callp(nullptr, 0, ret, ce);
+			if (unlikely(ce.error != Callable::CallError::CALL_OK)) {
+				ERR_PRINT_ONCE("LimboHSM: Error calling substate's guard callable: " + Variant::get_callable_error_text(guard_callable, nullptr, 0, ce));
+			}
+#elif LIMBOAI_GDEXTENSION
+			ret = guard_callable.call();
+#endif
+
+			if (unlikely(ret.get_type() != Variant::BOOL)) {
+				ERR_PRINT_ONCE(vformat("State guard callable %s returned non-boolean value (%s).", guard_callable, this));
+				return true;
+			}
+			return ret;
+		}
+	}
+	return true;
 }
 
 void LimboState::_notification(int p_what) {
@@ -190,6 +311,12 @@ void LimboState::_notification(int p_what) {
 				_update_blackboard_plan();
 			}
 		} break;
+		case NOTIFICATION_PARENTED: {
+			parent_state = Object::cast_to<LimboState>(get_parent());
+		} break;
+		case NOTIFICATION_UNPARENTED: {
+			parent_state = nullptr;
+		} break;
 		case NOTIFICATION_PREDELETE: {
 			if (is_active()) {
 				_exit();
@@ -206,12 +333,18 @@ void LimboState::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_active"), &LimboState::is_active);
 	ClassDB::bind_method(D_METHOD("_initialize", "agent", "blackboard"), &LimboState::_initialize);
 	ClassDB::bind_method(D_METHOD("dispatch", "event", "cargo"), &LimboState::dispatch, Variant());
+	ClassDB::bind_method(D_METHOD("dispatch_id", "event_id", "cargo"), &LimboState::dispatch_id, Variant());
+	ClassDB::bind_static_method("LimboState", D_METHOD("get_event_id", "event"), &LimboState::get_event_id);
+	ClassDB::bind_static_method("LimboState", D_METHOD("get_event_name", "event_id"), &LimboState::get_event_name);
 	ClassDB::bind_method(D_METHOD("named", "name"), &LimboState::named);
 	ClassDB::bind_method(D_METHOD("add_event_handler", "event", "handler"), &LimboState::add_event_handler);
 	ClassDB::bind_method(D_METHOD("call_on_enter", "callable"), &LimboState::call_on_enter);
 	ClassDB::bind_method(D_METHOD("call_on_exit", "callable"), &LimboState::call_on_exit);
 	ClassDB::bind_method(D_METHOD("call_on_update", "callable"), &LimboState::call_on_update);
 	ClassDB::bind_method(D_METHOD("set_guard", "guard_callable"), &LimboState::set_guard);
+	ClassDB::bind_method(D_METHOD("set_guard_var_check", "variable", "check_type", "value"), &LimboState::set_guard_var_check);
+	ClassDB::bind_method(D_METHOD("set_guard_expression", "expression"), &LimboState::set_guard_expression);
+	ClassDB::bind_method(D_METHOD("has_guard"), &LimboState::has_guard);
 	ClassDB::bind_method(D_METHOD("clear_guard"), &LimboState::clear_guard);
 	ClassDB::bind_method(D_METHOD("get_blackboard"), &LimboState::get_blackboard);
 
@@ -234,6 +367,8 @@ void LimboState::_bind_methods() {
 	ADD_SIGNAL(MethodInfo("updated", PropertyInfo(Variant::FLOAT, "delta")));
 }
 
+uint64_t LimboState::routing_epoch = 1;
+
 LimboState::LimboState() {
 	agent = nullptr;
 	active = false;
@@ -16,15 +16,19 @@
 #include "../blackboard/blackboard_plan.h"
 
 #include "../util/limbo_compat.h"
+#include "../util/limbo_expression.h"
 #include "../util/limbo_string_names.h"
+#include "../util/limbo_utility.h"
+#include "limbo_event_registry.h"
 
 #ifdef LIMBOAI_MODULE
+#include "core/templates/local_vector.h"
 #include "scene/main/node.h"
 #endif // LIMBOAI_MODULE
 
 #ifdef LIMBOAI_GDEXTENSION
 #include <godot_cpp/core/gdvirtual.gen.inc>
-#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
 #endif // LIMBOAI_GDEXTENSION
 
 class LimboHSM;
@@ -32,15 +36,58 @@ class LimboHSM;
 class LimboState : public Node {
 	GDCLASS(LimboState, Node);
 
+public:
+	// Guard implemented in C++: evaluated without going through Callable and Variant.
+	typedef bool (*NativeGuard)(LimboState *p_state, void *p_userdata);
+	// Update listener implemented in C++: called on every update without going through signals and Variant.
+	typedef void (*NativeUpdateListener)(LimboState *p_state, double p_delta, void *p_userdata);
+
 private:
+	enum GuardType : uint8_t {
+		GUARD_NONE,
+		GUARD_CALLABLE,
+		GUARD_NATIVE,
+		GUARD_VAR_CHECK,
+		GUARD_EXPRESSION,
+	};
+
 	bool active;
 	Ref<BlackboardPlan> blackboard_plan;
 	Node *agent;
 	Ref<Blackboard> blackboard;
-	HashMap<StringName, Callable> handlers;
+	LocalVector<Callable> handlers; // Indexed by event ID.
+	// Bumped when handlers, transitions or the children of a state machine change, invalidating event routing in LimboHSM.
+	static uint64_t routing_epoch;
+	GuardType guard_type = GUARD_NONE;
 	Callable guard_callable;
+	NativeGuard native_guard = nullptr;
+	void *native_guard_userdata = nullptr;
+	NativeUpdateListener native_update_listener = nullptr;
+	void *native_update_userdata = nullptr;
+	// Variable check guard: compares a blackboard variable against guard_value.
+	BBVarHandle guard_var_handle;
+	LimboUtility::CheckType guard_check_type = LimboUtility::CHECK_EQUAL;
+	Variant guard_value;
+	LimboExpression guard_expression;
+	int transition_row = -1; // Row in the transition table of the parent HSM.
+
+	// Cached to avoid class checks by name: updated when the state is parented or unparented.
+	LimboState *parent_state = nullptr;
+	bool is_hsm = false; // Set by LimboHSM.
+	// Input processing is only toggled for states that implement _input(). Detected on initialization.
+	bool handles_input = true;
+	// The plan is applied to the blackboard when the state is first entered or its blackboard is accessed,
+	// so that initializing an HSM doesn't populate the scopes of states that never run.
+	mutable bool blackboard_pending = false;
 
 	Ref<BlackboardPlan> _get_parent_scope_plan() const;
+	void _populate_blackboard() const;
+	_FORCE_INLINE_ void _ensure_blackboard() const {
+		if (unlikely(blackboard_pending)) {
+			_populate_blackboard();
+		}
+	}
+	bool _evaluate_guard();
 
 protected:
 	friend LimboHSM;
@@ -50,7 +97,7 @@ protected:
 	void _notification(int p_what);
 
 	virtual void _initialize(Node *p_agent, const Ref<Blackboard> &p_blackboard);
-	virtual bool _dispatch(const StringName &p_event, const Variant &p_cargo = Variant());
+	virtual bool _dispatch(int p_event_id, const Variant &p_cargo = Variant());
 
 	virtual bool _should_use_new_scope() const { return blackboard_plan.is_valid() || is_root(); }
 	virtual void _update_blackboard_plan();
@@ -61,6 +108,16 @@ protected:
 	virtual void _exit();
 	virtual void _update(double p_delta);
 
+	// * Emitted on every update - skip boxing the delta and looking up the signal when no one listens.
+	_FORCE_INLINE_ void _emit_updated(double p_delta) {
+		if (native_update_listener) {
+			native_update_listener(this, p_delta, native_update_userdata);
+		}
+		if (has_connections(LW_NAME(updated))) {
+			emit_signal(LW_NAME(updated), p_delta);
+		}
+	}
+
 	GDVIRTUAL0(_setup);
 	GDVIRTUAL0(_enter);
 	GDVIRTUAL0(_exit);
@@ -74,7 +131,10 @@ public:
 	void set_blackboard_plan(const Ref<BlackboardPlan> &p_plan);
 	_FORCE_INLINE_ Ref<BlackboardPlan> get_blackboard_plan() const { return blackboard_plan; }
 
-	Ref<Blackboard> get_blackboard() const { return blackboard; }
+	Ref<Blackboard> get_blackboard() const {
+		_ensure_blackboard();
+		return blackboard;
+	}
 
 	Node *get_agent() const { return agent; }
 	void set_agent(Node *p_agent) { agent = p_agent; }
@@ -83,16 +143,26 @@ public:
 	LimboState *call_on_enter(const Callable &p_callable);
 	LimboState *call_on_exit(const Callable &p_callable);
 	LimboState *call_on_update(const Callable &p_callable);
+	// Replaces the native update listener. Pass nullptr to remove it.
+	void set_native_update_listener(NativeUpdateListener p_listener, void *p_userdata = nullptr);
 
 	void add_event_handler(const StringName &p_event, const Callable &p_handler);
 	bool dispatch(const StringName &p_event, const Variant &p_cargo = Variant());
+	bool dispatch_id(int p_event_id, const Variant &p_cargo = Variant());
+
+	static int get_event_id(const StringName &p_event) { return LimboEventRegistry::intern(p_event); }
+	static StringName get_event_name(int p_event_id) { return LimboEventRegistry::get_name(p_event_id); }
 
 	_FORCE_INLINE_ StringName event_finished() const { return LW_NAME(EVENT_FINISHED); }
 	LimboState *get_root() const;
-	_FORCE_INLINE_ bool is_root() const { return !(get_parent() && IS_CLASS(get_parent(), LimboState)); }
+	_FORCE_INLINE_ bool is_root() const { return parent_state == nullptr; }
 	_FORCE_INLINE_ bool is_active() const { return active; }
 
 	void set_guard(const Callable &p_guard_callable);
+	void set_native_guard(NativeGuard p_guard, void *p_userdata = nullptr);
+	void set_guard_var_check(const StringName &p_variable, LimboUtility::CheckType p_check_type, const Variant &p_value);
+	void set_guard_expression(const String &p_expression);
+	_FORCE_INLINE_ bool has_guard() const { return guard_type != GUARD_NONE; }
 	void clear_guard();
 
 	LimboState();
@@ -0,0 +1,64 @@
+/**
+ * limbo_state_resource.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "limbo_state_resource.h"
+
+#include "../util/limbo_compat.h"
+#include "../util/limbo_string_names.h"
+
+void LimboStateResource::set_state_name(const StringName &p_name) {
+	state_name = p_name;
+	emit_changed();
+}
+
+void LimboStateResource::set_behavior_tree(const Ref<BehaviorTree> &p_tree) {
+	behavior_tree = p_tree;
+	emit_changed();
+}
+
+void LimboStateResource::set_success_event(const StringName &p_event) {
+	success_event = p_event;
+	emit_changed();
+}
+
+void LimboStateResource::set_failure_event(const StringName &p_event) {
+	failure_event = p_event;
+	emit_changed();
+}
+
+void LimboStateResource::set_update_interval(double p_interval) {
+	update_interval = MAX(p_interval, 0.0);
+	emit_changed();
+}
+
+void LimboStateResource::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_state_name", "name"), &LimboStateResource::set_state_name);
+	ClassDB::bind_method(D_METHOD("get_state_name"), &LimboStateResource::get_state_name);
+	ClassDB::bind_method(D_METHOD("set_behavior_tree", "behavior_tree"), &LimboStateResource::set_behavior_tree);
+	ClassDB::bind_method(D_METHOD("get_behavior_tree"), &LimboStateResource::get_behavior_tree);
+	ClassDB::bind_method(D_METHOD("set_success_event", "event"), &LimboStateResource::set_success_event);
+	ClassDB::bind_method(D_METHOD("get_success_event"), &LimboStateResource::get_success_event);
+	ClassDB::bind_method(D_METHOD("set_failure_event", "event"), &LimboStateResource::set_failure_event);
+	ClassDB::bind_method(D_METHOD("get_failure_event"), &LimboStateResource::get_failure_event);
+	ClassDB::bind_method(D_METHOD("set_update_interval", "interval"), &LimboStateResource::set_update_interval);
+	ClassDB::bind_method(D_METHOD("get_update_interval"), &LimboStateResource::get_update_interval);
+
+	ADD_PROPERTY(PropertyInfo(Variant::STRING_NAME, "state_name"), "set_state_name", "get_state_name");
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "behavior_tree", PROPERTY_HINT_RESOURCE_TYPE, "BehaviorTree"), "set_behavior_tree", "get_behavior_tree");
+	ADD_PROPERTY(PropertyInfo(Variant::STRING_NAME, "success_event"), "set_success_event", "get_success_event");
+	ADD_PROPERTY(PropertyInfo(Variant::STRING_NAME, "failure_event"), "set_failure_event", "get_failure_event");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "update_interval", PROPERTY_HINT_RANGE, "0.0,10.0,0.001,or_greater,suffix:s"), "set_update_interval", "get_update_interval");
+}
+
+LimboStateResource::LimboStateResource() {
+	success_event = LW_NAME(EVENT_SUCCESS);
+	failure_event = LW_NAME(EVENT_FAILURE);
+}
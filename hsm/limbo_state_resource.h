@@ -0,0 +1,59 @@
+/**
+ * limbo_state_resource.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef LIMBO_STATE_RESOURCE_H
+#define LIMBO_STATE_RESOURCE_H
+
+#include "../bt/behavior_tree.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/io/resource.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/resource.hpp>
+using namespace godot;
+#endif // LIMBOAI_GDEXTENSION
+
+// Definition of a state in LimboHSMResource. Instantiated per agent as plain data, without a scene node.
+class LimboStateResource : public Resource {
+	GDCLASS(LimboStateResource, Resource);
+
+private:
+	StringName state_name;
+	Ref<BehaviorTree> behavior_tree;
+	StringName success_event;
+	StringName failure_event;
+	double update_interval = 0.0;
+
+protected:
+	static void _bind_methods();
+
+public:
+	void set_state_name(const StringName &p_name);
+	StringName get_state_name() const { return state_name; }
+
+	void set_behavior_tree(const Ref<BehaviorTree> &p_tree);
+	Ref<BehaviorTree> get_behavior_tree() const { return behavior_tree; }
+
+	void set_success_event(const StringName &p_event);
+	StringName get_success_event() const { return success_event; }
+
+	void set_failure_event(const StringName &p_event);
+	StringName get_failure_event() const { return failure_event; }
+
+	void set_update_interval(double p_interval);
+	double get_update_interval() const { return update_interval; }
+
+	LimboStateResource();
+};
+
+#endif // LIMBO_STATE_RESOURCE_H
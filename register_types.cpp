@@ -46,15 +46,31 @@
 #include "blackboard/bb_param/bb_vector3i.h"
 #include "blackboard/bb_param/bb_vector4.h"
 #include "blackboard/bb_param/bb_vector4i.h"
+#include "blackboard/bb_var_ref.h"
 #include "blackboard/blackboard.h"
 #include "blackboard/blackboard_plan.h"
+#include "blackboard/shared_blackboard.h"
 #include "bt/behavior_tree.h"
+#include "bt/behavior_tree_format.h"
+#include "bt/bt_crowd.h"
+#include "bt/bt_instance_pool.h"
 #include "bt/bt_player.h"
+#include "bt/bt_profile.h"
+#include "bt/bt_runner.h"
+#include "bt/bt_scheduler.h"
 #include "bt/bt_state.h"
+#include "bt/bt_stats.h"
+#include "bt/bt_telemetry.h"
+#include "bt/bt_template_cache.h"
+#include "bt/bt_validator.h"
+#include "bt/bt_trace.h"
+#include "bt/bt_tree_monitor.h"
+#include "bt/tasks/blackboard/bt_check_expression.h"
 #include "bt/tasks/blackboard/bt_check_trigger.h"
 #include "bt/tasks/blackboard/bt_check_var.h"
 #include "bt/tasks/blackboard/bt_set_var.h"
 #include "bt/tasks/bt_action.h"
+#include "bt/tasks/bt_async_action.h"
 #include "bt/tasks/bt_comment.h"
 #include "bt/tasks/bt_composite.h"
 #include "bt/tasks/bt_condition.h"
@@ -62,19 +78,24 @@
 #include "bt/tasks/bt_task.h"
 #include "bt/tasks/composites/bt_dynamic_selector.h"
 #include "bt/tasks/composites/bt_dynamic_sequence.h"
+#include "bt/tasks/composites/bt_event_selector.h"
 #include "bt/tasks/composites/bt_parallel.h"
+#include "bt/tasks/composites/bt_planner.h"
 #include "bt/tasks/composites/bt_probability_selector.h"
 #include "bt/tasks/composites/bt_random_selector.h"
 #include "bt/tasks/composites/bt_random_sequence.h"
 #include "bt/tasks/composites/bt_selector.h"
 #include "bt/tasks/composites/bt_sequence.h"
+#include "bt/tasks/composites/bt_utility_selector.h"
 #include "bt/tasks/decorators/bt_always_fail.h"
 #include "bt/tasks/decorators/bt_always_succeed.h"
+#include "bt/tasks/decorators/bt_cache.h"
 #include "bt/tasks/decorators/bt_cooldown.h"
 #include "bt/tasks/decorators/bt_delay.h"
 #include "bt/tasks/decorators/bt_for_each.h"
 #include "bt/tasks/decorators/bt_invert.h"
 #include "bt/tasks/decorators/bt_new_scope.h"
+#include "bt/tasks/decorators/bt_observer.h"
 #include "bt/tasks/decorators/bt_probability.h"
 #include "bt/tasks/decorators/bt_repeat.h"
 #include "bt/tasks/decorators/bt_repeat_until_failure.h"
@@ -84,8 +105,10 @@
 #include "bt/tasks/decorators/bt_time_limit.h"
 #include "bt/tasks/scene/bt_await_animation.h"
 #include "bt/tasks/scene/bt_check_agent_property.h"
+#include "bt/tasks/scene/bt_find_path.h"
 #include "bt/tasks/scene/bt_pause_animation.h"
 #include "bt/tasks/scene/bt_play_animation.h"
+#include "bt/tasks/scene/bt_query_nearby.h"
 #include "bt/tasks/scene/bt_set_agent_property.h"
 #include "bt/tasks/scene/bt_stop_animation.h"
 #include "bt/tasks/utility/bt_call_method.h"
@@ -101,8 +124,16 @@
 #include "editor/debugger/limbo_debugger.h"
 #include "editor/debugger/limbo_debugger_plugin.h"
 #include "editor/mode_switch_button.h"
+#include "hsm/limbo_event_channel.h"
+#include "hsm/limbo_event_registry.h"
 #include "hsm/limbo_hsm.h"
+#include "hsm/limbo_hsm_instance.h"
+#include "hsm/limbo_hsm_resource.h"
 #include "hsm/limbo_state.h"
+#include "hsm/limbo_state_resource.h"
+#include "util/limbo_error_reporter.h"
+#include "util/limbo_path_queries.h"
+#include "util/limbo_spatial_index.h"
 #include "util/limbo_string_names.h"
 #include "util/limbo_task_db.h"
 #include "util/limbo_utility.h"
@@ -120,12 +151,17 @@
 
 #ifdef LIMBOAI_GDEXTENSION
 #include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/resource_loader.hpp>
+#include <godot_cpp/classes/resource_saver.hpp>
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/core/memory.hpp>
 using namespace godot;
 #endif // LIMBOAI_GDEXTENSION
 
 static LimboUtility *_limbo_utility = nullptr;
+static BTScheduler *_bt_scheduler = nullptr;
+static Ref<ResourceFormatLoaderBehaviorTree> _bt_format_loader;
+static Ref<ResourceFormatSaverBehaviorTree> _bt_format_saver;
 
 void initialize_limboai_module(ModuleInitializationLevel p_level) {
 	if (p_level == MODULE_INITIALIZATION_LEVEL_SCENE) {
@@ -135,22 +171,37 @@ void initialize_limboai_module(ModuleInitializationLevel p_level) {
 		GDREGISTER_CLASS(BehaviorTreeData);
 #ifdef LIMBOAI_GDEXTENSION
 		GDREGISTER_CLASS(LimboDebugger);
+		GDREGISTER_INTERNAL_CLASS(ResourceFormatLoaderBehaviorTree);
+		GDREGISTER_INTERNAL_CLASS(ResourceFormatSaverBehaviorTree);
 #endif
 		LimboDebugger::initialize();
 
 		GDREGISTER_CLASS(LimboUtility);
 		GDREGISTER_CLASS(Blackboard);
+		GDREGISTER_CLASS(BBVarRef);
 		GDREGISTER_CLASS(BlackboardPlan);
+		GDREGISTER_CLASS(SharedBlackboard);
 
 		GDREGISTER_CLASS(LimboState);
 		GDREGISTER_CLASS(LimboHSM);
+		GDREGISTER_CLASS(LimboEventChannel);
+		GDREGISTER_CLASS(LimboStateResource);
+		GDREGISTER_CLASS(LimboHSMResource);
+		GDREGISTER_CLASS(LimboHSMInstance);
 
 		GDREGISTER_ABSTRACT_CLASS(BT);
 		GDREGISTER_ABSTRACT_CLASS(BTTask);
 		GDREGISTER_CLASS(BehaviorTree);
+		GDREGISTER_CLASS(BTCrowd);
 		GDREGISTER_CLASS(BTInstance);
+		GDREGISTER_CLASS(BTInstancePool);
 		GDREGISTER_CLASS(BTPlayer);
+		GDREGISTER_CLASS(BTProfile);
+		GDREGISTER_CLASS(BTRunner);
+		GDREGISTER_CLASS(BTScheduler);
 		GDREGISTER_CLASS(BTState);
+		GDREGISTER_CLASS(BTTelemetry);
+		GDREGISTER_CLASS(BTTrace);
 
 		LIMBO_REGISTER_TASK(BTComment);
 
@@ -160,7 +211,12 @@ void initialize_limboai_module(ModuleInitializationLevel p_level) {
 		LIMBO_REGISTER_TASK(BTParallel);
 		LIMBO_REGISTER_TASK(BTDynamicSequence);
 		LIMBO_REGISTER_TASK(BTDynamicSelector);
+		LIMBO_REGISTER_TASK(BTEventSelector);
 		LIMBO_REGISTER_TASK(BTProbabilitySelector);
+		LIMBO_REGISTER_TASK(BTUtilitySelector);
+		GDREGISTER_CLASS(BTConsideration);
+		LIMBO_REGISTER_TASK(BTPlanner);
+		GDREGISTER_CLASS(BTPlanAction);
 		LIMBO_REGISTER_TASK(BTRandomSequence);
 		LIMBO_REGISTER_TASK(BTRandomSelector);
 
@@ -175,20 +231,25 @@ void initialize_limboai_module(ModuleInitializationLevel p_level) {
 		LIMBO_REGISTER_TASK(BTRunLimit);
 		LIMBO_REGISTER_TASK(BTTimeLimit);
 		LIMBO_REGISTER_TASK(BTCooldown);
+		LIMBO_REGISTER_TASK(BTCache);
+		LIMBO_REGISTER_TASK(BTObserver);
 		LIMBO_REGISTER_TASK(BTProbability);
 		LIMBO_REGISTER_TASK(BTForEach);
 		LIMBO_REGISTER_TASK(BTNewScope);
 		LIMBO_REGISTER_TASK(BTSubtree);
 
 		GDREGISTER_CLASS(BTAction);
+		GDREGISTER_CLASS(BTAsyncAction);
 		GDREGISTER_CLASS(BTCondition);
 		LIMBO_REGISTER_TASK(BTAwaitAnimation);
 		LIMBO_REGISTER_TASK(BTCallMethod);
 		LIMBO_REGISTER_TASK(BTEvaluateExpression);
 		LIMBO_REGISTER_TASK(BTConsolePrint);
 		LIMBO_REGISTER_TASK(BTFail);
+		LIMBO_REGISTER_TASK(BTFindPath);
 		LIMBO_REGISTER_TASK(BTPauseAnimation);
 		LIMBO_REGISTER_TASK(BTPlayAnimation);
+		LIMBO_REGISTER_TASK(BTQueryNearby);
 		LIMBO_REGISTER_TASK(BTRandomWait);
 		LIMBO_REGISTER_TASK(BTSetAgentProperty);
 		LIMBO_REGISTER_TASK(BTSetVar);
@@ -196,6 +257,7 @@ void initialize_limboai_module(ModuleInitializationLevel p_level) {
 		LIMBO_REGISTER_TASK(BTWait);
 		LIMBO_REGISTER_TASK(BTWaitTicks);
 		LIMBO_REGISTER_TASK(BTCheckAgentProperty);
+		LIMBO_REGISTER_TASK(BTCheckExpression);
 		LIMBO_REGISTER_TASK(BTCheckTrigger);
 		LIMBO_REGISTER_TASK(BTCheckVar);
 
@@ -236,14 +298,33 @@ void initialize_limboai_module(ModuleInitializationLevel p_level) {
 		GDREGISTER_CLASS(BBVector4i);
 
 		_limbo_utility = memnew(LimboUtility);
+		_bt_scheduler = memnew(BTScheduler);
 
 #ifdef LIMBOAI_MODULE
 		Engine::get_singleton()->add_singleton(Engine::Singleton("LimboUtility", LimboUtility::get_singleton()));
+		Engine::get_singleton()->add_singleton(Engine::Singleton("BTScheduler", BTScheduler::get_singleton()));
 #elif LIMBOAI_GDEXTENSION
 		Engine::get_singleton()->register_singleton("LimboUtility", LimboUtility::get_singleton());
+		Engine::get_singleton()->register_singleton("BTScheduler", BTScheduler::get_singleton());
+#endif
+
+		_bt_format_loader.instantiate();
+		_bt_format_saver.instantiate();
+#ifdef LIMBOAI_MODULE
+		ResourceLoader::add_resource_format_loader(_bt_format_loader);
+		ResourceSaver::add_resource_format_saver(_bt_format_saver);
+#elif LIMBOAI_GDEXTENSION
+		ResourceLoader::get_singleton()->add_resource_format_loader(_bt_format_loader);
+		ResourceSaver::get_singleton()->add_resource_format_saver(_bt_format_saver);
 #endif
 
 		LimboStringNames::create();
+		LimboEventRegistry::initialize();
+		BTStats::initialize();
+		BTTreeMonitor::initialize();
+		BTValidator::initialize();
+		BTTemplateCache::initialize();
+		LimboErrorReporter::initialize();
 	}
 
 #ifdef TOOLS_ENABLED
@@ -265,7 +346,9 @@ void initialize_limboai_module(ModuleInitializationLevel p_level) {
 		GDREGISTER_CLASS(EditorPropertyVariableName);
 		GDREGISTER_CLASS(EditorInspectorPluginVariableName);
 		GDREGISTER_CLASS(OwnerPicker);
+		GDREGISTER_CLASS(BehaviorTreeIndex);
 		GDREGISTER_CLASS(LimboAIEditor);
+		GDREGISTER_CLASS(LimboAIExportPlugin);
 		GDREGISTER_CLASS(LimboAIEditorPlugin);
 #endif // LIMBOAI_GDEXTENSION
 
@@ -278,8 +361,23 @@ void initialize_limboai_module(ModuleInitializationLevel p_level) {
 void uninitialize_limboai_module(ModuleInitializationLevel p_level) {
 	if (p_level == MODULE_INITIALIZATION_LEVEL_SCENE) {
 		LimboDebugger::deinitialize();
+#ifdef LIMBOAI_MODULE
+		ResourceLoader::remove_resource_format_loader(_bt_format_loader);
+		ResourceSaver::remove_resource_format_saver(_bt_format_saver);
+#elif LIMBOAI_GDEXTENSION
+		ResourceLoader::get_singleton()->remove_resource_format_loader(_bt_format_loader);
+		ResourceSaver::get_singleton()->remove_resource_format_saver(_bt_format_saver);
+#endif
+		_bt_format_loader.unref();
+		_bt_format_saver.unref();
+		LimboEventRegistry::deinitialize();
+		LimboSpatialIndex::clear();
+		LimboPathQueries::clear();
+		BehaviorTree::free_async_operations();
+		SharedBlackboard::free_world();
 		LimboStringNames::free();
 		memdelete(_limbo_utility);
+		memdelete(_bt_scheduler);
 	}
 }
 
@@ -0,0 +1,208 @@
+/**
+ * test_allocations.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef TEST_ALLOCATIONS_H
+#define TEST_ALLOCATIONS_H
+
+#include "limbo_test.h"
+
+#include "modules/limboai/blackboard/bb_param/bb_node.h"
+#include "modules/limboai/blackboard/bb_param/bb_variant.h"
+#include "modules/limboai/bt/behavior_tree.h"
+#include "modules/limboai/bt/tasks/blackboard/bt_check_var.h"
+#include "modules/limboai/bt/tasks/blackboard/bt_set_var.h"
+#include "modules/limboai/bt/tasks/composites/bt_parallel.h"
+#include "modules/limboai/bt/tasks/composites/bt_selector.h"
+#include "modules/limboai/bt/tasks/composites/bt_sequence.h"
+#include "modules/limboai/bt/tasks/decorators/bt_always_succeed.h"
+#include "modules/limboai/bt/tasks/decorators/bt_for_each.h"
+#include "modules/limboai/bt/tasks/decorators/bt_invert.h"
+#include "modules/limboai/bt/tasks/decorators/bt_repeat.h"
+#include "modules/limboai/bt/tasks/utility/bt_call_method.h"
+#include "modules/limboai/bt/tasks/utility/bt_wait.h"
+#include "modules/limboai/bt/tasks/utility/bt_wait_ticks.h"
+#include "modules/limboai/hsm/limbo_hsm.h"
+#include "modules/limboai/hsm/limbo_state.h"
+
+#include "core/os/memory.h"
+#include "core/variant/array.h"
+
+// Checks that steady-state ticking doesn't allocate. Relies on the memory usage tracking of debug builds.
+
+namespace TestAllocations {
+
+#ifdef DEBUG_ENABLED
+
+// Detects allocations made through Godot's allocator while the guard is alive. The tracked usage is padded up to
+// the recorded peak, so that any allocation, even one freed right away, raises the peak.
+struct AllocationGuard {
+	void *padding = nullptr;
+	uint64_t peak = 0;
+
+	AllocationGuard() {
+		const uint64_t usage = Memory::get_mem_usage();
+		const uint64_t max_usage = Memory::get_mem_max_usage();
+		if (max_usage > usage) {
+			padding = Memory::alloc_static(max_usage - usage);
+		}
+		peak = Memory::get_mem_max_usage();
+	}
+
+	~AllocationGuard() {
+		if (padding) {
+			Memory::free_static(padding);
+		}
+	}
+
+	bool has_allocated() const { return Memory::get_mem_max_usage() > peak; }
+};
+
+// Warm-up ticks fill caches and grow reusable buffers, which is fine - only ticks after that must not allocate.
+template <typename F>
+static void _check_steady_state(F p_tick) {
+	for (int i = 0; i < 16; i++) {
+		p_tick();
+	}
+	bool allocated = false;
+	{
+		AllocationGuard guard;
+		for (int i = 0; i < 64; i++) {
+			p_tick();
+		}
+		allocated = guard.has_allocated();
+	}
+	CHECK_FALSE(allocated);
+}
+
+static void _check_task(const Ref<BTTask> &p_root, const Ref<Blackboard> &p_blackboard) {
+	Node *dummy = memnew(Node);
+	p_root->initialize(dummy, p_blackboard, dummy);
+	_check_steady_state([&]() { p_root->execute(0.01666); });
+	memdelete(dummy);
+}
+
+TEST_CASE("[Modules][LimboAI] Steady-state ticks don't allocate") {
+	ClassDB::register_class<BTTestAction>();
+	Ref<Blackboard> bb = memnew(Blackboard);
+
+	SUBCASE("Composites with running children") {
+		Ref<BTParallel> root = memnew(BTParallel);
+		Ref<BTSequence> seq = memnew(BTSequence);
+		Ref<BTWait> wait = memnew(BTWait);
+		wait->set_duration(1000.0);
+		seq->add_child(wait);
+		Ref<BTSelector> sel = memnew(BTSelector);
+		sel->add_child(memnew(BTTestAction(BTTask::FAILURE)));
+		sel->add_child(memnew(BTTestAction(BTTask::RUNNING)));
+		root->add_child(seq);
+		root->add_child(sel);
+		_check_task(root, bb);
+	}
+
+	SUBCASE("Decorators restarting their children") {
+		Ref<BTRepeat> root = memnew(BTRepeat);
+		root->set_forever(true);
+		Ref<BTSequence> seq = memnew(BTSequence);
+		Ref<BTInvert> invert = memnew(BTInvert);
+		invert->add_child(memnew(BTTestAction(BTTask::FAILURE)));
+		Ref<BTAlwaysSucceed> always_succeed = memnew(BTAlwaysSucceed);
+		always_succeed->add_child(memnew(BTTestAction(BTTask::FAILURE)));
+		Ref<BTWaitTicks> wait_ticks = memnew(BTWaitTicks);
+		wait_ticks->set_num_ticks(0);
+		seq->add_child(invert);
+		seq->add_child(always_succeed);
+		seq->add_child(wait_ticks);
+		root->add_child(seq);
+		_check_task(root, bb);
+	}
+
+	SUBCASE("Blackboard tasks") {
+		Ref<BTRepeat> root = memnew(BTRepeat);
+		root->set_forever(true);
+		Ref<BTSequence> seq = memnew(BTSequence);
+		Ref<BBVariant> value = memnew(BBVariant);
+		value->set_saved_value(1);
+		Ref<BTSetVar> set_var = memnew(BTSetVar);
+		set_var->set_variable("value");
+		set_var->set_value(value);
+		Ref<BTCheckVar> check_var = memnew(BTCheckVar);
+		check_var->set_variable("value");
+		check_var->set_value(value);
+		seq->add_child(set_var);
+		seq->add_child(check_var);
+		root->add_child(seq);
+		_check_task(root, bb);
+	}
+
+	SUBCASE("BTCallMethod") {
+		Ref<CallbackCounter> counter = memnew(CallbackCounter);
+		bb->set_var("object", counter);
+		Ref<BBNode> node_param = memnew(BBNode);
+		node_param->set_value_source(BBParam::BLACKBOARD_VAR);
+		node_param->set_variable("object");
+		Ref<BTCallMethod> cm = memnew(BTCallMethod);
+		cm->set_node_param(node_param);
+		cm->set_method("callback_delta");
+		cm->set_include_delta(true);
+		_check_task(cm, bb);
+		CHECK(counter->num_callbacks == 80);
+	}
+
+	SUBCASE("BTForEach") {
+		Array arr;
+		for (int i = 0; i < 100; i++) {
+			arr.push_back(i);
+		}
+		bb->set_var("array", arr);
+		Ref<BTForEach> fe = memnew(BTForEach);
+		fe->set_array_var("array");
+		fe->set_save_var("element");
+		fe->add_child(memnew(BTTestAction(BTTask::SUCCESS)));
+		_check_task(fe, bb);
+	}
+
+	SUBCASE("BTInstance::update()") {
+		Ref<BehaviorTree> bt = memnew(BehaviorTree);
+		Ref<BTSequence> seq = memnew(BTSequence);
+		seq->add_child(memnew(BTTestAction(BTTask::SUCCESS)));
+		seq->add_child(memnew(BTTestAction(BTTask::RUNNING)));
+		bt->set_root_task(seq);
+		Node *dummy = memnew(Node);
+		Ref<BTInstance> inst = bt->instantiate(dummy, bb, dummy, dummy);
+		REQUIRE(inst.is_valid());
+		_check_steady_state([&]() { inst->update(0.01666); });
+		inst.unref();
+		memdelete(dummy);
+	}
+}
+
+TEST_CASE("[Modules][LimboAI] Steady-state HSM updates don't allocate") {
+	Node *agent = memnew(Node);
+	LimboHSM *hsm = memnew(LimboHSM);
+	LimboHSM *nested = memnew(LimboHSM);
+	LimboState *state = memnew(LimboState);
+	hsm->add_child(nested);
+	nested->add_child(state);
+	hsm->initialize(agent, memnew(Blackboard));
+	hsm->set_active(true);
+
+	_check_steady_state([&]() { hsm->update(0.01666); });
+	CHECK(state->is_active());
+
+	memdelete(hsm);
+	memdelete(agent);
+}
+
+#endif // DEBUG_ENABLED
+
+} //namespace TestAllocations
+
+#endif // TEST_ALLOCATIONS_H
@@ -15,6 +15,8 @@
 #include "limbo_test.h"
 
 #include "modules/limboai/blackboard/blackboard.h"
+#include "modules/limboai/bt/behavior_tree.h"
+#include "modules/limboai/bt/bt_instance.h"
 #include "modules/limboai/bt/tasks/bt_task.h"
 #include "modules/limboai/bt/tasks/scene/bt_await_animation.h"
 
@@ -85,6 +87,30 @@ TEST_CASE("[SceneTree][LimboAI] BTAwaitAnimation") {
 		}
 	}
 
+	SUBCASE("With signals in a reactive instance") {
+		player_param->set_saved_value(player->get_path());
+		awa->set_use_signals(true);
+		awa->set_max_time(10.0);
+		Ref<BehaviorTree> bt = memnew(BehaviorTree);
+		bt->set_root_task(awa);
+		Ref<BTInstance> inst = bt->instantiate(dummy, bb, dummy, dummy);
+		REQUIRE(inst.is_valid());
+		inst->set_reactive(true);
+
+		player->play("test");
+		CHECK(inst->update(0.01666) == BTTask::RUNNING);
+		// * Sleeps until the expected end of the animation.
+		CHECK(inst->is_sleeping());
+		CHECK_FALSE(inst->advance(0.01666));
+
+		// * Woken up by animation_finished.
+		player->seek(888.0, true);
+		player->notification(Node::NOTIFICATION_INTERNAL_PROCESS);
+		CHECK(inst->advance(0.01666));
+		CHECK_FALSE(inst->is_sleeping());
+		CHECK(inst->update(0.01666) == BTTask::SUCCESS);
+	}
+
 	memdelete(dummy);
 	memdelete(player);
 }
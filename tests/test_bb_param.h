@@ -25,8 +25,11 @@
 #include "modules/limboai/blackboard/bb_param/bb_string.h"
 #include "modules/limboai/blackboard/bb_param/bb_variant.h"
 #include "modules/limboai/blackboard/bb_param/bb_vector2.h"
+#include "modules/limboai/blackboard/bb_param/bb_vector3.h"
 #include "modules/limboai/blackboard/blackboard.h"
+#include "modules/limboai/bt/tasks/blackboard/bt_set_var.h"
 #include "modules/limboai/bt/tasks/bt_task.h"
+#include "modules/limboai/bt/tasks/utility/bt_call_method.h"
 #include "tests/test_macros.h"
 
 namespace TestBBParam {
@@ -89,6 +92,31 @@ TEST_CASE("[Modules][LimboAI] BBNode") {
 		CHECK(param->get_value(dummy, bb).get_type() == Variant::Type::OBJECT);
 		CHECK(param->get_value(dummy, bb) == Variant(other));
 	}
+	SUBCASE("With a cached path") {
+		param->set_value_source(BBParam::SAVED_VALUE);
+		param->set_saved_value(NodePath("./Replaced"));
+		ERR_PRINT_OFF;
+		CHECK(param->get_value(dummy, bb).is_null());
+		ERR_PRINT_ON;
+
+		// * Found once added, and resolved again after it is freed.
+		Node *first = memnew(Node);
+		first->set_name("Replaced");
+		dummy->add_child(first);
+		CHECK(param->get_value(dummy, bb) == Variant(first));
+		CHECK(param->get_value(dummy, bb) == Variant(first));
+		memdelete(first);
+		Node *second = memnew(Node);
+		second->set_name("Replaced");
+		dummy->add_child(second);
+		CHECK(param->get_value(dummy, bb) == Variant(second));
+
+		// * Keyed by the scene root.
+		ERR_PRINT_OFF;
+		CHECK(param->get_value(other, bb).is_null());
+		ERR_PRINT_ON;
+		memdelete(second);
+	}
 	SUBCASE("With an invalid path") {
 		param->set_value_source(BBParam::SAVED_VALUE);
 		param->set_saved_value(NodePath("./SomeOther"));
@@ -128,6 +156,42 @@ TEST_CASE("[Modules][LimboAI] BBNode") {
 	memdelete(dummy);
 }
 
+TEST_CASE("[Modules][LimboAI] BBParam typed accessors") {
+	Node *dummy = memnew(Node);
+	Ref<Blackboard> bb = memnew(Blackboard);
+
+	SUBCASE("With a saved value") {
+		Ref<BBFloat> param = memnew(BBFloat);
+		param->set_value_source(BBParam::SAVED_VALUE);
+		CHECK(param->get_float(bb) == 0.0);
+		param->set_saved_value(2.5);
+		CHECK(param->get_float(bb) == 2.5);
+	}
+	SUBCASE("With a blackboard variable") {
+		Ref<BBVector3> param = memnew(BBVector3);
+		param->set_value_source(BBParam::BLACKBOARD_VAR);
+		param->set_variable("vec");
+		ERR_PRINT_OFF;
+		CHECK(param->get_typed<Vector3>(bb, Vector3(1, 1, 1)) == Vector3(1, 1, 1));
+		ERR_PRINT_ON;
+
+		bb->set_var("vec", Vector3(1, 2, 3));
+		CHECK(param->get_vector3(bb) == Vector3(1, 2, 3));
+		// * Read again after the variable changes.
+		bb->set_var("vec", Vector3(4, 5, 6));
+		CHECK(param->get_vector3(bb) == Vector3(4, 5, 6));
+		CHECK(param->get_value(dummy, bb) == Variant(Vector3(4, 5, 6)));
+
+		// * Resolved separately for another blackboard.
+		Ref<Blackboard> other_bb = memnew(Blackboard);
+		other_bb->set_var("vec", Vector3(7, 8, 9));
+		CHECK(param->get_vector3(other_bb) == Vector3(7, 8, 9));
+		CHECK(param->get_vector3(bb) == Vector3(4, 5, 6));
+	}
+
+	memdelete(dummy);
+}
+
 TEST_CASE("[Modules][LimboAI] BBParam default values") {
 	Node *dummy = memnew(Node);
 	Ref<Blackboard> bb = memnew(Blackboard);
@@ -190,6 +254,95 @@ TEST_CASE("[Modules][LimboAI] BBParam default values") {
 	memdelete(dummy);
 }
 
+TEST_CASE("[Modules][LimboAI] BBParam of runtime clones") {
+	Ref<BTSetVar> task = memnew(BTSetVar);
+	Ref<BBVariant> value = memnew(BBVariant);
+	value->set_saved_value(1);
+	task->set_value(value);
+
+	SUBCASE("Saved values are shared") {
+		Ref<BTSetVar> clone1 = task->clone();
+		Ref<BTSetVar> clone2 = task->clone();
+		CHECK(clone1->get_value() == value);
+		CHECK(clone2->get_value() == value);
+	}
+
+	SUBCASE("Variables get a parameter per clone, for their cache") {
+		value->set_value_source(BBParam::BLACKBOARD_VAR);
+		value->set_variable("source");
+		Ref<BTSetVar> clone1 = task->clone();
+		Ref<BTSetVar> clone2 = task->clone();
+		REQUIRE(clone1->get_value().is_valid());
+		CHECK_FALSE(clone1->get_value() == value);
+		CHECK_FALSE(clone1->get_value() == clone2->get_value());
+		CHECK(clone1->get_value()->get_variable() == StringName("source"));
+	}
+
+	SUBCASE("Node parameters get a parameter per clone, for their node cache") {
+		Ref<BTCallMethod> call = memnew(BTCallMethod);
+		Ref<BBNode> node_param = memnew(BBNode);
+		node_param->set_saved_value(NodePath("Target"));
+		call->set_node_param(node_param);
+		Ref<BTCallMethod> clone1 = call->clone();
+		Ref<BTCallMethod> clone2 = call->clone();
+		REQUIRE(clone1->get_node_param().is_valid());
+		CHECK(clone1->get_node_param() != node_param);
+		CHECK(clone1->get_node_param() != clone2->get_node_param());
+
+		// * Agents with different scene roots resolve their own nodes.
+		Node *root1 = memnew(Node);
+		Node *root2 = memnew(Node);
+		Node *target1 = memnew(Node);
+		Node *target2 = memnew(Node);
+		target1->set_name("Target");
+		target2->set_name("Target");
+		root1->add_child(target1);
+		root2->add_child(target2);
+		Ref<Blackboard> bb = memnew(Blackboard);
+		for (int i = 0; i < 2; i++) {
+			CHECK(clone1->get_node_param()->get_value(root1, bb) == Variant(target1));
+			CHECK(clone2->get_node_param()->get_value(root2, bb) == Variant(target2));
+		}
+		memdelete(root1);
+		memdelete(root2);
+	}
+
+	SUBCASE("Variables in arrays get a parameter per clone") {
+		Ref<BTCallMethod> call = memnew(BTCallMethod);
+		Ref<BBVariant> var_arg = memnew(BBVariant);
+		var_arg->set_value_source(BBParam::BLACKBOARD_VAR);
+		var_arg->set_variable("arg");
+		TypedArray<BBVariant> args;
+		args.push_back(value);
+		args.push_back(var_arg);
+		call->set_args(args);
+
+		Ref<BTCallMethod> clone1 = call->clone();
+		Ref<BTCallMethod> clone2 = call->clone();
+		REQUIRE(clone1->get_args().size() == 2);
+		REQUIRE(clone2->get_args().size() == 2);
+		CHECK(clone1->get_args()[0] == Variant(value));
+		Ref<BBVariant> arg1 = clone1->get_args()[1];
+		Ref<BBVariant> arg2 = clone2->get_args()[1];
+		CHECK(arg1 != var_arg);
+		CHECK(arg1 != arg2);
+		CHECK(call->get_args()[1] == Variant(var_arg));
+
+		// * Interleaved reads on different blackboards keep their own cached values.
+		Ref<Blackboard> bb1 = memnew(Blackboard);
+		Ref<Blackboard> bb2 = memnew(Blackboard);
+		bb1->set_var("arg", 1);
+		bb2->set_var("arg", 2);
+		for (int i = 0; i < 3; i++) {
+			CHECK(arg1->get_value(nullptr, bb1) == Variant(1));
+			CHECK(arg2->get_value(nullptr, bb2) == Variant(2));
+		}
+		bb1->set_var("arg", 3);
+		CHECK(arg1->get_value(nullptr, bb1) == Variant(3));
+		CHECK(arg2->get_value(nullptr, bb2) == Variant(2));
+	}
+}
+
 } //namespace TestBBParam
 
 #endif // TEST_BB_PARAM_H
@@ -0,0 +1,291 @@
+/**
+ * test_behavior_tree.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef TEST_BEHAVIOR_TREE_H
+#define TEST_BEHAVIOR_TREE_H
+
+#include "limbo_test.h"
+
+#include "modules/limboai/blackboard/bb_param/bb_variant.h"
+#include "modules/limboai/bt/behavior_tree.h"
+#include "modules/limboai/bt/bt_validator.h"
+#include "modules/limboai/bt/tasks/blackboard/bt_check_var.h"
+#include "modules/limboai/bt/tasks/blackboard/bt_set_var.h"
+#include "modules/limboai/bt/tasks/bt_comment.h"
+#include "modules/limboai/bt/tasks/composites/bt_selector.h"
+#include "modules/limboai/bt/tasks/composites/bt_sequence.h"
+#include "modules/limboai/bt/tasks/decorators/bt_always_fail.h"
+#include "modules/limboai/bt/tasks/decorators/bt_always_succeed.h"
+#include "modules/limboai/bt/tasks/decorators/bt_invert.h"
+#include "modules/limboai/bt/tasks/utility/bt_fail.h"
+
+namespace TestBehaviorTree {
+
+TEST_CASE("[Modules][LimboAI] BehaviorTree optimize") {
+	ClassDB::register_class<BTTestAction>();
+
+	Ref<BehaviorTree> bt = memnew(BehaviorTree);
+	Ref<BTSequence> root = memnew(BTSequence);
+	Ref<BTTestAction> action1 = memnew(BTTestAction(BTTask::SUCCESS));
+	Ref<BTTestAction> action2 = memnew(BTTestAction(BTTask::FAILURE));
+	bt->set_root_task(root);
+
+	SUBCASE("Comments are stripped, and a single-child root sequence is replaced") {
+		Ref<BTComment> comment = memnew(BTComment);
+		comment->add_child(memnew(BTComment));
+		root->add_child(comment);
+		root->add_child(action1);
+
+		CHECK(bt->optimize() == 3);
+		CHECK(bt->get_root_task() == action1);
+		CHECK(action1->get_parent().is_null());
+	}
+
+	SUBCASE("Nested single-child composites are folded") {
+		Ref<BTSelector> sel = memnew(BTSelector);
+		Ref<BTSequence> seq = memnew(BTSequence);
+		seq->add_child(action2);
+		sel->add_child(seq);
+		root->add_child(sel);
+		root->add_child(action1);
+
+		CHECK(bt->optimize() == 2);
+		CHECK(bt->get_root_task() == root);
+		REQUIRE(root->get_child_count() == 2);
+		CHECK(root->get_child(0) == action2);
+		CHECK(action2->get_parent() == root);
+		CHECK(root->get_child(1) == action1);
+	}
+
+	SUBCASE("Double inversion cancels out") {
+		Ref<BTInvert> outer = memnew(BTInvert);
+		Ref<BTInvert> inner = memnew(BTInvert);
+		inner->add_child(action1);
+		outer->add_child(inner);
+		root->add_child(outer);
+		root->add_child(action2);
+
+		CHECK(bt->optimize() == 2);
+		CHECK(root->get_child(0) == action1);
+	}
+
+	SUBCASE("Status overrides absorb inner decorators") {
+		Ref<BTAlwaysSucceed> outer = memnew(BTAlwaysSucceed);
+		Ref<BTAlwaysFail> middle = memnew(BTAlwaysFail);
+		Ref<BTInvert> inner = memnew(BTInvert);
+		inner->add_child(action2);
+		middle->add_child(inner);
+		outer->add_child(middle);
+		root->add_child(outer);
+		root->add_child(action1);
+
+		CHECK(bt->optimize() == 2);
+		REQUIRE(root->get_child(0) == outer);
+		REQUIRE(outer->get_child_count() == 1);
+		CHECK(outer->get_child(0) == action2);
+
+		Node *dummy = memnew(Node);
+		Ref<Blackboard> bb = memnew(Blackboard);
+		Ref<BTInstance> inst = bt->instantiate(dummy, bb, dummy);
+		REQUIRE(inst.is_valid());
+		CHECK(inst->update(0.01666) == BTTask::SUCCESS);
+		memdelete(dummy);
+	}
+
+	SUBCASE("Composites with several children are kept") {
+		Ref<BTSelector> sel = memnew(BTSelector);
+		sel->add_child(action1);
+		sel->add_child(action2);
+		root->add_child(sel);
+		root->add_child(memnew(BTTestAction));
+
+		CHECK(bt->optimize() == 0);
+		CHECK(bt->get_root_task() == root);
+		CHECK(root->get_child(0) == sel);
+	}
+}
+
+TEST_CASE("[Modules][LimboAI] BehaviorTree warm_up") {
+	ClassDB::register_class<BTTestAction>();
+
+	Ref<BehaviorTree> bt = memnew(BehaviorTree);
+	Ref<BTSequence> root = memnew(BTSequence);
+	root->add_child(memnew(BTTestAction(BTTask::SUCCESS)));
+	bt->set_root_task(root);
+	bt->set_cache_template(true);
+
+	bt->warm_up();
+	Ref<BTTask> tmpl = bt->get_instance_template();
+	REQUIRE(tmpl.is_valid());
+	CHECK(tmpl != root);
+	CHECK(tmpl->get_child_count() == 1);
+
+	// * Warming up again reuses the template.
+	bt->warm_up();
+	CHECK(bt->get_instance_template() == tmpl);
+
+	Node *dummy = memnew(Node);
+	Ref<BTInstance> inst = bt->instantiate(dummy, memnew(Blackboard), dummy);
+	REQUIRE(inst.is_valid());
+	CHECK(inst->update(0.01666) == BTTask::SUCCESS);
+	memdelete(dummy);
+}
+
+TEST_CASE("[Modules][LimboAI] BehaviorTree instantiate_many") {
+	ClassDB::register_class<BTTestAction>();
+
+	Ref<BehaviorTree> bt = memnew(BehaviorTree);
+	Ref<BTSequence> root = memnew(BTSequence);
+	root->add_child(memnew(BTTestAction(BTTask::SUCCESS)));
+	root->add_child(memnew(BTTestAction(BTTask::RUNNING)));
+	bt->set_root_task(root);
+
+	Node *owner = memnew(Node);
+	TypedArray<Node> agents;
+	for (int i = 0; i < 3; i++) {
+		agents.push_back(memnew(Node));
+	}
+
+	SUBCASE("With blackboards created from the plan") {
+		TypedArray<BTInstance> instances = bt->instantiate_many(agents, TypedArray<Blackboard>(), owner, owner);
+		REQUIRE(instances.size() == 3);
+		for (int i = 0; i < 3; i++) {
+			Ref<BTInstance> inst = instances[i];
+			REQUIRE(inst.is_valid());
+			CHECK(inst->get_agent() == Object::cast_to<Node>(agents[i]));
+			CHECK(inst->get_blackboard().is_valid());
+			CHECK(inst->get_root_task() != root);
+			CHECK(inst->update(0.01666) == BTTask::RUNNING);
+			if (i > 0) {
+				CHECK(inst->get_root_task() != Ref<BTInstance>(instances[i - 1])->get_root_task());
+				CHECK(inst->get_blackboard() != Ref<BTInstance>(instances[i - 1])->get_blackboard());
+			}
+		}
+	}
+
+	SUBCASE("With one blackboard per agent") {
+		TypedArray<Blackboard> blackboards;
+		for (int i = 0; i < 3; i++) {
+			blackboards.push_back(memnew(Blackboard));
+		}
+		TypedArray<BTInstance> instances = bt->instantiate_many(agents, blackboards, owner, owner);
+		REQUIRE(instances.size() == 3);
+		for (int i = 0; i < 3; i++) {
+			CHECK(Ref<BTInstance>(instances[i])->get_blackboard() == Ref<Blackboard>(blackboards[i]));
+		}
+	}
+
+	SUBCASE("With task classes that were never cloned before") {
+		// * The property cache is filled concurrently by the worker threads.
+		Ref<BehaviorTree> cold_bt = memnew(BehaviorTree);
+		Ref<BTSequence> cold_root = memnew(BTSequence);
+		Ref<BTInvert> invert = memnew(BTInvert);
+		invert->add_child(memnew(BTAlwaysFail));
+		cold_root->add_child(invert);
+		Ref<BTCheckVar> check = memnew(BTCheckVar);
+		check->set_variable("flag");
+		Ref<BBVariant> value = memnew(BBVariant);
+		value->set_value_source(BBParam::BLACKBOARD_VAR);
+		value->set_variable("expected");
+		check->set_value(value);
+		cold_root->add_child(check);
+		cold_bt->set_root_task(cold_root);
+
+		TypedArray<Node> many_agents;
+		TypedArray<Blackboard> blackboards;
+		for (int i = 0; i < 32; i++) {
+			many_agents.push_back(memnew(Node));
+			Ref<Blackboard> bb = memnew(Blackboard);
+			bb->set_var("flag", i);
+			bb->set_var("expected", i % 2 == 0 ? i : -1);
+			blackboards.push_back(bb);
+		}
+		BTTask::clear_property_cache();
+		TypedArray<BTInstance> instances = cold_bt->instantiate_many(many_agents, blackboards, owner, owner);
+		REQUIRE(instances.size() == 32);
+		for (int i = 0; i < 32; i++) {
+			Ref<BTInstance> inst = instances[i];
+			REQUIRE(inst.is_valid());
+			Ref<BTCheckVar> check_copy = inst->get_root_task()->get_child(1);
+			REQUIRE(check_copy.is_valid());
+			CHECK(check_copy->get_value() != value);
+			CHECK(inst->update(0.01666) == (i % 2 == 0 ? BTTask::SUCCESS : BTTask::FAILURE));
+		}
+		for (int i = 0; i < many_agents.size(); i++) {
+			memdelete(Object::cast_to<Node>(many_agents[i]));
+		}
+	}
+
+	SUBCASE("With a mismatched number of blackboards") {
+		TypedArray<Blackboard> blackboards;
+		blackboards.push_back(memnew(Blackboard));
+		ERR_PRINT_OFF;
+		CHECK(bt->instantiate_many(agents, blackboards, owner, owner).is_empty());
+		ERR_PRINT_ON;
+	}
+
+	for (int i = 0; i < agents.size(); i++) {
+		memdelete(Object::cast_to<Node>(agents[i]));
+	}
+	memdelete(owner);
+}
+
+TEST_CASE("[Modules][LimboAI] BehaviorTree runtime validation") {
+	ClassDB::register_class<BTTestAction>();
+
+	Ref<BehaviorTree> bt = memnew(BehaviorTree);
+	Ref<BTSequence> root = memnew(BTSequence);
+	Ref<BTCheckVar> check = memnew(BTCheckVar);
+	check->set_variable("missing");
+	Ref<BBVariant> value = memnew(BBVariant);
+	value->set_saved_value(1);
+	check->set_value(value);
+	root->add_child(check);
+	bt->set_root_task(root);
+
+	Node *dummy = memnew(Node);
+	Ref<Blackboard> bb = memnew(Blackboard);
+
+	SUBCASE("Tasks reading a missing variable are replaced") {
+		ERR_PRINT_OFF;
+		Ref<BTTask> copy = root->clone();
+		copy->initialize(dummy, bb, dummy);
+		CHECK(BTValidator::validate(copy, "res://test.tres") == 1);
+		ERR_PRINT_ON;
+		REQUIRE(copy->get_child_count() == 1);
+		Ref<BTFail> stub = copy->get_child(0);
+		REQUIRE(stub.is_valid());
+		CHECK(stub->get_parent() == copy);
+		CHECK(copy->execute(0.01666) == BTTask::FAILURE);
+	}
+
+	SUBCASE("Variables written by the tree or present in the blackboard are accepted") {
+		Ref<BTSetVar> set_var = memnew(BTSetVar);
+		set_var->set_variable("missing");
+		set_var->set_value(value);
+		root->add_child_at_index(set_var, 0);
+		Ref<BTTask> copy = root->clone();
+		copy->initialize(dummy, bb, dummy);
+		CHECK(BTValidator::validate(copy, "res://test.tres") == 0);
+
+		root->remove_child(set_var);
+		bb->set_var("missing", 1);
+		copy = root->clone();
+		copy->initialize(dummy, bb, dummy);
+		CHECK(BTValidator::validate(copy, "res://test.tres") == 0);
+	}
+
+	memdelete(dummy);
+}
+
+} //namespace TestBehaviorTree
+
+#endif // TEST_BEHAVIOR_TREE_H
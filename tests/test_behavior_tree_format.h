@@ -0,0 +1,137 @@
+/**
+ * test_behavior_tree_format.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef TEST_BEHAVIOR_TREE_FORMAT_H
+#define TEST_BEHAVIOR_TREE_FORMAT_H
+
+#include "limbo_test.h"
+
+#include "modules/limboai/blackboard/bb_param/bb_variant.h"
+#include "modules/limboai/blackboard/blackboard_plan.h"
+#include "modules/limboai/bt/behavior_tree.h"
+#include "modules/limboai/bt/behavior_tree_format.h"
+#include "modules/limboai/bt/tasks/blackboard/bt_set_var.h"
+#include "modules/limboai/bt/tasks/composites/bt_sequence.h"
+#include "modules/limboai/bt/tasks/utility/bt_wait.h"
+
+namespace TestBehaviorTreeFormat {
+
+TEST_CASE("[Modules][LimboAI] BehaviorTree binary format") {
+	Ref<BehaviorTree> bt = memnew(BehaviorTree);
+	bt->set_description("Patrol");
+	Ref<BlackboardPlan> plan = memnew(BlackboardPlan);
+	BBVariable speed(Variant::FLOAT);
+	speed.set_value(4.5);
+	plan->add_var("speed", speed);
+	bt->set_blackboard_plan(plan);
+
+	Ref<BTSequence> seq = memnew(BTSequence);
+	seq->set_custom_name("Main");
+	Ref<BTWait> wait = memnew(BTWait);
+	wait->set_duration(2.5);
+	Ref<BTSetVar> set_var = memnew(BTSetVar);
+	set_var->set_variable("target");
+	Array saved_array;
+	saved_array.push_back(1);
+	saved_array.push_back("two");
+	saved_array.push_back(3.0);
+	Ref<BBVariant> value = memnew(BBVariant);
+	value->set_saved_value(saved_array);
+	set_var->set_value(value);
+	seq->add_child(wait);
+	seq->add_child(set_var);
+	bt->set_root_task(seq);
+
+	PackedByteArray data;
+	REQUIRE(ResourceFormatSaverBehaviorTree::save_to_bytes(bt, data) == OK);
+	REQUIRE(data.size() > 0);
+
+	SUBCASE("Round trip should restore tasks, parameters and the plan") {
+		Error err = FAILED;
+		Ref<BehaviorTree> loaded = ResourceFormatLoaderBehaviorTree::load_from_bytes(data, &err);
+		REQUIRE(err == OK);
+		REQUIRE(loaded.is_valid());
+		CHECK(loaded != bt);
+		CHECK(loaded->get_description() == "Patrol");
+
+		Ref<BTSequence> loaded_seq = loaded->get_root_task();
+		REQUIRE(loaded_seq.is_valid());
+		CHECK(loaded_seq != seq);
+		CHECK(loaded_seq->get_custom_name() == "Main");
+		REQUIRE(loaded_seq->get_child_count() == 2);
+
+		Ref<BTWait> loaded_wait = loaded_seq->get_child(0);
+		REQUIRE(loaded_wait.is_valid());
+		CHECK(loaded_wait->get_duration() == 2.5);
+		CHECK(loaded_wait->get_parent() == loaded_seq);
+
+		Ref<BTSetVar> loaded_set_var = loaded_seq->get_child(1);
+		REQUIRE(loaded_set_var.is_valid());
+		CHECK(loaded_set_var->get_variable() == StringName("target"));
+		CHECK(loaded_set_var->get_parent() == loaded_seq);
+		REQUIRE(loaded_set_var->get_value().is_valid());
+		CHECK(loaded_set_var->get_value() != value);
+		CHECK(loaded_set_var->get_value()->get_saved_value() == Variant(saved_array));
+
+		Ref<BlackboardPlan> loaded_plan = loaded->get_blackboard_plan();
+		REQUIRE(loaded_plan.is_valid());
+		REQUIRE(loaded_plan->has_var("speed"));
+		CHECK(loaded_plan->get_var("speed").get_value() == Variant(4.5));
+	}
+
+	SUBCASE("Shared parameters should stay shared") {
+		Ref<BTSetVar> other = memnew(BTSetVar);
+		other->set_value(value);
+		seq->add_child(other);
+		REQUIRE(ResourceFormatSaverBehaviorTree::save_to_bytes(bt, data) == OK);
+
+		Ref<BehaviorTree> loaded = ResourceFormatLoaderBehaviorTree::load_from_bytes(data);
+		REQUIRE(loaded.is_valid());
+		Ref<BTSetVar> first = loaded->get_root_task()->get_child(1);
+		Ref<BTSetVar> second = loaded->get_root_task()->get_child(2);
+		REQUIRE(first.is_valid());
+		REQUIRE(second.is_valid());
+		CHECK(first->get_value() == second->get_value());
+	}
+
+	SUBCASE("Data should be decoded in place, at any position") {
+		// * Mapped files may start at any address - the format has no alignment requirements.
+		PackedByteArray shifted;
+		shifted.resize(data.size() + 3);
+		memcpy(shifted.ptrw() + 3, data.ptr(), data.size());
+		const PackedByteArray before = shifted;
+		Error err = FAILED;
+		Ref<BehaviorTree> loaded = ResourceFormatLoaderBehaviorTree::load_from_buffer(shifted.ptr() + 3, data.size(), &err);
+		REQUIRE(err == OK);
+		REQUIRE(loaded.is_valid());
+		CHECK(loaded->get_description() == "Patrol");
+		CHECK(loaded->get_root_task()->get_child_count() == 2);
+		CHECK(shifted == before);
+	}
+
+	SUBCASE("Corrupt data should fail to load") {
+		ERR_PRINT_OFF;
+		Error err = OK;
+		PackedByteArray truncated = data.slice(0, data.size() / 2);
+		CHECK(ResourceFormatLoaderBehaviorTree::load_from_bytes(truncated, &err).is_null());
+		CHECK(err == ERR_FILE_CORRUPT);
+
+		PackedByteArray garbage = data;
+		garbage.set(0, 0);
+		CHECK(ResourceFormatLoaderBehaviorTree::load_from_bytes(garbage, &err).is_null());
+		CHECK(err == ERR_FILE_CORRUPT);
+		ERR_PRINT_ON;
+	}
+}
+
+} //namespace TestBehaviorTreeFormat
+
+#endif // TEST_BEHAVIOR_TREE_FORMAT_H
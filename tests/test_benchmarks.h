@@ -0,0 +1,340 @@
+/**
+ * test_benchmarks.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef TEST_BENCHMARKS_H
+#define TEST_BENCHMARKS_H
+
+#include "limbo_test.h"
+
+#include "modules/limboai/blackboard/blackboard.h"
+#include "modules/limboai/blackboard/blackboard_plan.h"
+#include "modules/limboai/bt/behavior_tree.h"
+#include "modules/limboai/bt/tasks/bt_task.h"
+#include "modules/limboai/bt/tasks/composites/bt_parallel.h"
+#include "modules/limboai/bt/tasks/composites/bt_selector.h"
+#include "modules/limboai/bt/tasks/composites/bt_sequence.h"
+#include "modules/limboai/bt/tasks/decorators/bt_subtree.h"
+#include "modules/limboai/bt/tasks/utility/bt_fail.h"
+#include "modules/limboai/bt/tasks/utility/bt_wait.h"
+#include "modules/limboai/hsm/limbo_hsm.h"
+#include "modules/limboai/hsm/limbo_state.h"
+
+#include "core/io/json.h"
+#include "core/os/time.h"
+
+// Benchmarks are skipped by default. Run them with:
+//   godot --test --test-case="*[Benchmark]*" --no-skip
+// Each benchmark prints a JSON line: {"benchmark": name, "iterations": n, "usec": total, "ops_per_sec": rate}.
+
+namespace TestBenchmarks {
+
+#define BENCHMARK_CASE(m_name) TEST_CASE("[Modules][LimboAI][Benchmark] " m_name * doctest::skip())
+
+struct BenchmarkTimer {
+	String name;
+	int iterations;
+	uint64_t start;
+
+	BenchmarkTimer(const String &p_name, int p_iterations) :
+			name(p_name), iterations(p_iterations), start(Time::get_singleton()->get_ticks_usec()) {}
+
+	~BenchmarkTimer() {
+		uint64_t usec = MAX(Time::get_singleton()->get_ticks_usec() - start, (uint64_t)1);
+		Dictionary result;
+		result["benchmark"] = name;
+		result["iterations"] = iterations;
+		result["usec"] = usec;
+		result["ops_per_sec"] = double(iterations) * 1000000.0 / double(usec);
+		print_line(JSON::stringify(result));
+	}
+};
+
+static void _tick_benchmark(const String &p_name, const Ref<BTTask> &p_root, int p_iterations) {
+	Node *dummy = memnew(Node);
+	Ref<Blackboard> bb = memnew(Blackboard);
+	p_root->initialize(dummy, bb, dummy);
+	{
+		BenchmarkTimer timer(p_name, p_iterations);
+		for (int i = 0; i < p_iterations; i++) {
+			p_root->execute(0.01666);
+		}
+	}
+	memdelete(dummy);
+}
+
+BENCHMARK_CASE("Tick deep sequence") {
+	Ref<BTSequence> root = memnew(BTSequence);
+	Ref<BTTask> parent = root;
+	for (int i = 0; i < 63; i++) {
+		Ref<BTSequence> seq = memnew(BTSequence);
+		parent->add_child(seq);
+		parent = seq;
+	}
+	parent->add_child(memnew(BTTestAction(BTTask::SUCCESS)));
+	_tick_benchmark("tick_deep_sequence_64", root, 100000);
+}
+
+BENCHMARK_CASE("Tick wide selector") {
+	Ref<BTSelector> root = memnew(BTSelector);
+	for (int i = 0; i < 256; i++) {
+		root->add_child(memnew(BTTestAction(BTTask::FAILURE)));
+	}
+	root->add_child(memnew(BTTestAction(BTTask::SUCCESS)));
+	_tick_benchmark("tick_wide_selector_257", root, 20000);
+}
+
+BENCHMARK_CASE("Tick parallel") {
+	Ref<BTParallel> root = memnew(BTParallel);
+	for (int i = 0; i < 256; i++) {
+		root->add_child(memnew(BTTestAction(BTTask::RUNNING)));
+	}
+	_tick_benchmark("tick_parallel_256", root, 20000);
+}
+
+BENCHMARK_CASE("Tick subtrees") {
+	if (!ClassDB::class_exists("BTTestAction")) {
+		ClassDB::register_class<BTTestAction>(); // * Needed to clone subtrees.
+	}
+	Ref<BehaviorTree> sub = memnew(BehaviorTree);
+	Ref<BTSequence> sub_root = memnew(BTSequence);
+	for (int i = 0; i < 4; i++) {
+		sub_root->add_child(memnew(BTTestAction(BTTask::SUCCESS)));
+	}
+	sub->set_root_task(sub_root);
+
+	Ref<BTSequence> root = memnew(BTSequence);
+	for (int i = 0; i < 32; i++) {
+		Ref<BTSubtree> subtree = memnew(BTSubtree);
+		subtree->set_subtree(sub);
+		root->add_child(subtree);
+	}
+	_tick_benchmark("tick_subtrees_32x4", root, 20000);
+}
+
+BENCHMARK_CASE("Blackboard access") {
+	const int depths[] = { 1, 4, 16 };
+	const int iterations = 1000000;
+	for (int depth : depths) {
+		Ref<Blackboard> top = memnew(Blackboard);
+		top->set_var("var", 1);
+		Ref<Blackboard> bb = top;
+		for (int i = 1; i < depth; i++) {
+			Ref<Blackboard> scope = memnew(Blackboard);
+			scope->set_parent(bb);
+			bb = scope;
+		}
+		const StringName var_name = "var";
+		const StringName local_name = "local";
+		int64_t sum = 0;
+		{
+			BenchmarkTimer timer(vformat("bb_get_var_depth_%d", depth), iterations);
+			for (int i = 0; i < iterations; i++) {
+				sum += (int64_t)bb->get_var(var_name, 0);
+			}
+		}
+		{
+			BBVarHandle handle = bb->get_var_handle(var_name);
+			BenchmarkTimer timer(vformat("bb_get_var_by_handle_depth_%d", depth), iterations);
+			for (int i = 0; i < iterations; i++) {
+				sum += (int64_t)bb->get_var_by_handle(handle, 0);
+			}
+		}
+		{
+			BenchmarkTimer timer(vformat("bb_set_var_depth_%d", depth), iterations);
+			for (int i = 0; i < iterations; i++) {
+				bb->set_var(local_name, i);
+			}
+		}
+		CHECK(sum == 2 * iterations);
+	}
+}
+
+BENCHMARK_CASE("BehaviorTree instantiate") {
+	Ref<BehaviorTree> bt = memnew(BehaviorTree);
+	Ref<BTSelector> root = memnew(BTSelector);
+	for (int i = 0; i < 8; i++) {
+		Ref<BTSequence> seq = memnew(BTSequence);
+		for (int j = 0; j < 4; j++) {
+			seq->add_child(memnew(BTFail));
+		}
+		seq->add_child(memnew(BTWait));
+		root->add_child(seq);
+	}
+	bt->set_root_task(root);
+
+	Node *dummy = memnew(Node);
+	const int iterations = 2000;
+	{
+		BenchmarkTimer timer("bt_instantiate_49_tasks", iterations);
+		for (int i = 0; i < iterations; i++) {
+			Ref<Blackboard> bb = memnew(Blackboard);
+			Ref<BTInstance> inst = bt->instantiate(dummy, bb, dummy, dummy);
+		}
+	}
+	memdelete(dummy);
+}
+
+BENCHMARK_CASE("BlackboardPlan create_blackboard") {
+	Ref<BlackboardPlan> plan = memnew(BlackboardPlan);
+	for (int i = 0; i < 32; i++) {
+		BBVariable var(Variant::FLOAT);
+		var.set_value(double(i));
+		plan->add_var(vformat("var_%d", i), var);
+	}
+
+	Node *dummy = memnew(Node);
+	const int iterations = 20000;
+	{
+		BenchmarkTimer timer("plan_create_blackboard_32_vars", iterations);
+		for (int i = 0; i < iterations; i++) {
+			Ref<Blackboard> bb = plan->create_blackboard(dummy);
+		}
+	}
+	memdelete(dummy);
+}
+
+class BenchmarkHSMCallbacks : public RefCounted {
+	GDCLASS(BenchmarkHSMCallbacks, RefCounted);
+
+protected:
+	static void _bind_methods() {}
+
+public:
+	int calls = 0;
+	bool pass_event() {
+		calls += 1;
+		return false;
+	}
+	bool permit() {
+		calls += 1;
+		return true;
+	}
+};
+
+// Builds "p_depth" nested HSMs, with two leaf states in the innermost one.
+static LimboHSM *_make_hsm(int p_depth, LimboState **r_leaf_a, LimboState **r_leaf_b) {
+	LimboHSM *root = memnew(LimboHSM);
+	LimboHSM *parent = root;
+	for (int i = 1; i < p_depth; i++) {
+		LimboHSM *nested = memnew(LimboHSM);
+		parent->add_child(nested);
+		parent = nested;
+	}
+	*r_leaf_a = memnew(LimboState);
+	*r_leaf_b = memnew(LimboState);
+	parent->add_child(*r_leaf_a);
+	parent->add_child(*r_leaf_b);
+	parent->add_transition(*r_leaf_a, *r_leaf_b, "to_b");
+	parent->add_transition(*r_leaf_b, *r_leaf_a, "to_a");
+	return root;
+}
+
+static void _start_hsm(LimboHSM *p_hsm, Node *p_agent) {
+	p_hsm->initialize(p_agent, memnew(Blackboard));
+	p_hsm->set_active(true);
+}
+
+BENCHMARK_CASE("HSM update") {
+	const int depths[] = { 1, 4 };
+	const int iterations = 200000;
+	Node *agent = memnew(Node);
+	for (int depth : depths) {
+		LimboState *leaf_a = nullptr;
+		LimboState *leaf_b = nullptr;
+		LimboHSM *hsm = _make_hsm(depth, &leaf_a, &leaf_b);
+		_start_hsm(hsm, agent);
+		{
+			BenchmarkTimer timer(vformat("hsm_update_depth_%d", depth), iterations);
+			for (int i = 0; i < iterations; i++) {
+				hsm->update(0.01666);
+			}
+		}
+		CHECK(leaf_a->is_active());
+		memdelete(hsm);
+	}
+	memdelete(agent);
+}
+
+BENCHMARK_CASE("HSM dispatch") {
+	const int depths[] = { 1, 4 };
+	const int iterations = 200000;
+	Node *agent = memnew(Node);
+	Ref<BenchmarkHSMCallbacks> callbacks = memnew(BenchmarkHSMCallbacks);
+	for (int depth : depths) {
+		LimboState *leaf_a = nullptr;
+		LimboState *leaf_b = nullptr;
+		LimboHSM *hsm = _make_hsm(depth, &leaf_a, &leaf_b);
+		_start_hsm(hsm, agent);
+		LimboHSM *leaf_hsm = Object::cast_to<LimboHSM>(leaf_a->get_parent());
+		const StringName to_a = "to_a";
+		const StringName to_b = "to_b";
+		const StringName unhandled = "unhandled";
+
+		{
+			// * Bubbles from the leaf up to the root without being consumed.
+			BenchmarkTimer timer(vformat("hsm_dispatch_unhandled_depth_%d", depth), iterations);
+			for (int i = 0; i < iterations; i++) {
+				leaf_a->dispatch(unhandled);
+			}
+		}
+		{
+			BenchmarkTimer timer(vformat("hsm_dispatch_transition_depth_%d", depth), iterations);
+			for (int i = 0; i < iterations; i++) {
+				leaf_hsm->dispatch((i & 1) ? to_a : to_b);
+			}
+		}
+		REQUIRE(leaf_a->is_active());
+
+		leaf_a->add_event_handler(unhandled, callable_mp(callbacks.ptr(), &BenchmarkHSMCallbacks::pass_event));
+		{
+			BenchmarkTimer timer(vformat("hsm_dispatch_with_handler_depth_%d", depth), iterations);
+			for (int i = 0; i < iterations; i++) {
+				leaf_a->dispatch(unhandled);
+			}
+		}
+		leaf_a->set_guard(callable_mp(callbacks.ptr(), &BenchmarkHSMCallbacks::permit));
+		leaf_b->set_guard(callable_mp(callbacks.ptr(), &BenchmarkHSMCallbacks::permit));
+		{
+			BenchmarkTimer timer(vformat("hsm_dispatch_transition_guarded_depth_%d", depth), iterations);
+			for (int i = 0; i < iterations; i++) {
+				leaf_hsm->dispatch((i & 1) ? to_a : to_b);
+			}
+		}
+		CHECK(leaf_a->is_active());
+		memdelete(hsm);
+	}
+	CHECK(callbacks->calls > 0);
+	memdelete(agent);
+}
+
+BENCHMARK_CASE("HSM change_active_state") {
+	const int iterations = 200000;
+	Node *agent = memnew(Node);
+	LimboState *leaf_a = nullptr;
+	LimboState *leaf_b = nullptr;
+	LimboHSM *hsm = _make_hsm(1, &leaf_a, &leaf_b);
+	_start_hsm(hsm, agent);
+	{
+		BenchmarkTimer timer("hsm_change_active_state", iterations);
+		for (int i = 0; i < iterations; i++) {
+			hsm->change_active_state((i & 1) ? leaf_a : leaf_b);
+		}
+	}
+	CHECK(leaf_a->is_active());
+	memdelete(hsm);
+	memdelete(agent);
+}
+
+#undef BENCHMARK_CASE
+
+} //namespace TestBenchmarks
+
+#endif // TEST_BENCHMARKS_H
@@ -4,7 +4,10 @@
 #include "core/variant/variant.h"
 #include "limbo_test.h"
 
+#include "modules/limboai/blackboard/bb_typed_var.h"
+#include "modules/limboai/blackboard/bb_var_ref.h"
 #include "modules/limboai/blackboard/blackboard.h"
+#include "modules/limboai/util/limbo_timer_wheel.h"
 
 namespace TestBlackboard {
 
@@ -54,6 +57,22 @@ TEST_CASE("[Modules][LimboAI] Test Blackboard") {
 		CHECK(blackboard->has_var("c"));
 	}
 
+	SUBCASE("Test erase_var() compacting storage") {
+		for (int i = 0; i < 40; i++) {
+			blackboard->set_var(vformat("v%d", i), i);
+		}
+		for (int i = 0; i < 40; i++) {
+			if (i % 4 != 3) {
+				blackboard->erase_var(vformat("v%d", i));
+			}
+		}
+		for (int i = 0; i < 40; i++) {
+			CHECK(blackboard->has_var(vformat("v%d", i)) == (i % 4 == 3));
+		}
+		CHECK_EQ(blackboard->get_var("v39", Variant()), Variant(39));
+		CHECK_EQ(blackboard->get_var("c", Variant()), Variant("3"));
+	}
+
 	SUBCASE("Test clear()") {
 		blackboard->clear();
 		CHECK_FALSE(blackboard->has_var("a"));
@@ -143,6 +162,184 @@ TEST_CASE("[Modules][LimboAI] Test Blackboard") {
 		CHECK_EQ(grand_parent_scope->get_var("d", not_found, false), not_found);
 		CHECK_EQ(parent_scope->get_var("a", not_found), Variant(5));
 		CHECK_EQ(blackboard->get_var("a", not_found), Variant(1));
+
+		// * Outer lookups are cached, and stay correct when scopes change.
+		grand_parent_scope->set_var("e", 1);
+		CHECK_EQ(blackboard->get_var("e", not_found), Variant(1));
+		CHECK_EQ(blackboard->get_var("f", not_found, false), not_found);
+		parent_scope->set_var("e", 2);
+		grand_parent_scope->set_var("f", 3);
+		CHECK_EQ(blackboard->get_var("e", not_found), Variant(2));
+		CHECK_EQ(blackboard->get_var("f", not_found), Variant(3));
+		parent_scope->erase_var("e");
+		CHECK_EQ(blackboard->get_var("e", not_found), Variant(1));
+		grand_parent_scope->set_var("e", 4);
+		CHECK(blackboard->has_var("e"));
+		CHECK_EQ(blackboard->get_var("e", not_found), Variant(4));
+	}
+
+	SUBCASE("Test handles") {
+		BBVarHandle handle_b = blackboard->get_var_handle("b");
+		CHECK(blackboard->has_var_by_handle(handle_b));
+		CHECK_EQ(blackboard->get_var_by_handle(handle_b, not_found), Variant(Vector2(2, 2)));
+		blackboard->set_var_by_handle(handle_b, Vector2(3, 3));
+		CHECK_EQ(blackboard->get_var("b", not_found), Variant(Vector2(3, 3)));
+
+		// * Handles stay correct after structural changes.
+		blackboard->erase_var("a");
+		CHECK_EQ(blackboard->get_var_by_handle(handle_b, not_found), Variant(Vector2(3, 3)));
+		blackboard->erase_var("b");
+		CHECK_FALSE(blackboard->has_var_by_handle(handle_b));
+		CHECK_EQ(blackboard->get_var_by_handle(handle_b, not_found, false), not_found);
+		blackboard->set_var_by_handle(handle_b, 5);
+		CHECK_EQ(blackboard->get_var("b", not_found), Variant(5));
+
+		// * Resolved through parent scopes.
+		Ref<Blackboard> parent_scope = memnew(Blackboard);
+		parent_scope->set_var("d", 123);
+		blackboard->set_parent(parent_scope);
+		BBVarHandle handle_d = blackboard->get_var_handle("d");
+		CHECK_EQ(blackboard->get_var_by_handle(handle_d, not_found), Variant(123));
+		blackboard->set_var_by_handle(handle_d, 456); // * should shadow, same as set_var()
+		CHECK_EQ(blackboard->get_var_by_handle(handle_d, not_found), Variant(456));
+		CHECK_EQ(parent_scope->get_var("d", not_found), Variant(123));
+
+		// * Writes that don't insert: only existing variables of this scope.
+		CHECK(blackboard->try_set_var_by_handle(handle_d, 789));
+		CHECK_EQ(blackboard->get_var("d", not_found), Variant(789));
+		parent_scope->set_var("e", 1);
+		BBVarHandle handle_e = blackboard->get_var_handle("e");
+		CHECK_FALSE(blackboard->try_set_var_by_handle(handle_e, 2));
+		BBVarHandle handle_f = blackboard->get_var_handle("f");
+		CHECK_FALSE(blackboard->try_set_var_by_handle(handle_f, 3));
+		CHECK_FALSE(blackboard->has_local_var("e"));
+		CHECK_FALSE(blackboard->has_var("f"));
+
+		// * Handles follow changes anywhere in their own scope chain, and only there.
+		Ref<Blackboard> unrelated = memnew(Blackboard);
+		CHECK_EQ(blackboard->get_var_by_handle(handle_e, not_found), Variant(1));
+		unrelated->set_var("e", 2);
+		CHECK_EQ(blackboard->get_var_by_handle(handle_e, not_found), Variant(1));
+		Ref<Blackboard> grandparent = memnew(Blackboard);
+		grandparent->set_var("e", 3);
+		parent_scope->set_parent(grandparent);
+		parent_scope->erase_var("e");
+		CHECK_EQ(blackboard->get_var_by_handle(handle_e, not_found), Variant(3));
+		grandparent->erase_var("e");
+		CHECK_EQ(blackboard->get_var_by_handle(handle_e, not_found, false), not_found);
+		CHECK_EQ(blackboard->get_var("e", not_found, false), not_found);
+
+		// * Sibling chains can have the same stamp - a handle resolved in one of them stays correct in the other.
+		Ref<Blackboard> shared_parent = memnew(Blackboard);
+		Ref<Blackboard> sibling1 = memnew(Blackboard);
+		Ref<Blackboard> sibling2 = memnew(Blackboard);
+		sibling1->set_var("x", 1);
+		sibling2->set_var("y", 2);
+		sibling1->set_parent(shared_parent);
+		sibling2->set_parent(shared_parent);
+		shared_parent->set_var("z", 0);
+		BBVarHandle handle_x = sibling1->get_var_handle("x");
+		CHECK_EQ(sibling1->get_var_by_handle(handle_x, not_found), Variant(1));
+		CHECK_EQ(sibling2->get_var_by_handle(handle_x, not_found, false), not_found);
+	}
+
+	SUBCASE("Test typed variables") {
+		BBTypedVar<int> typed_c;
+		CHECK_FALSE(typed_c.resolve(blackboard, "typed"));
+		CHECK(typed_c.get_name() == StringName("typed"));
+		CHECK(typed_c.get(blackboard, -1) == -1);
+		typed_c.set(blackboard, 7);
+		CHECK(typed_c.exists(blackboard));
+		CHECK(typed_c.get(blackboard) == 7);
+		CHECK_EQ(blackboard->get_var("typed", not_found), Variant(7));
+
+		// * Conversions are applied on read, same as Variant.
+		BBTypedVar<double> typed_double;
+		typed_double.resolve(blackboard, "typed");
+		CHECK(typed_double.get(blackboard) == 7.0);
+		int64_t version = typed_c.get_version(blackboard);
+		typed_double.set(blackboard, 2.5);
+		CHECK(typed_c.get_version(blackboard) > version);
+		CHECK(typed_c.get(blackboard) == 2);
+
+		// * Variables bound to properties are read through the binding.
+		Ref<TestPropertyHolder> holder = memnew(TestPropertyHolder);
+		holder->set_property(42);
+		blackboard->bind_var_to_property("bound", holder.ptr(), "property", true);
+		BBTypedVar<int> typed_bound;
+		typed_bound.resolve(blackboard, "bound");
+		CHECK(typed_bound.get(blackboard) == 42);
+	}
+
+	SUBCASE("Test batch duplicate") {
+		LocalVector<BBVariable> src;
+		src.push_back(BBVariable(Variant::INT));
+		src.push_back(BBVariable(Variant::STRING, PROPERTY_HINT_MULTILINE_TEXT));
+		src[0].set_value(5);
+		src[1].set_value("text");
+
+		LocalVector<BBVariable> dst;
+		BBVariable::duplicate_batch(src, dst);
+		REQUIRE(dst.size() == 2);
+		CHECK_EQ(dst[0].get_value(), Variant(5));
+		CHECK_EQ(dst[1].get_value(), Variant("text"));
+		CHECK(dst[1].get_hint() == PROPERTY_HINT_MULTILINE_TEXT);
+
+		// * Runtime duplicates don't carry the editor info.
+		LocalVector<BBVariable> stripped;
+		BBVariable::duplicate_batch(src, stripped, false, true);
+		CHECK(stripped[1].get_hint() == PROPERTY_HINT_NONE);
+		CHECK(stripped[1].get_memory_usage() < dst[1].get_memory_usage());
+		CHECK(src[1].get_hint() == PROPERTY_HINT_MULTILINE_TEXT);
+
+		// * Duplicates are independent, and outlive each other.
+		dst[0].set_value(6);
+		CHECK_EQ(src[0].get_value(), Variant(5));
+		blackboard->assign_var("kept", dst[1]);
+		dst.clear();
+		CHECK_EQ(blackboard->get_var("kept", not_found), Variant("text"));
+	}
+
+	SUBCASE("Test change tracking") {
+		BBVarHandle handle_a = blackboard->get_var_handle("a");
+		int64_t version = blackboard->get_var_version(handle_a);
+		CHECK(version >= 0);
+		blackboard->get_var("a");
+		CHECK(blackboard->get_var_version(handle_a) == version);
+		blackboard->set_var("a", 2);
+		CHECK(blackboard->get_var_version(handle_a) > version);
+
+		Ref<TestPropertyHolder> holder = memnew(TestPropertyHolder);
+		Callable listener = callable_mp(holder.ptr(), &TestPropertyHolder::set_property);
+		blackboard->add_var_listener("a", listener);
+		blackboard->set_var("a", 3);
+		CHECK_EQ(holder->get_property(), 3);
+		blackboard->remove_var_listener("a", listener);
+		blackboard->set_var("a", 4);
+		CHECK_EQ(holder->get_property(), 3);
+
+		BBVarHandle handle_missing = blackboard->get_var_handle("missing");
+		CHECK(blackboard->get_var_version(handle_missing) == -1);
+
+		Ref<BBVarRef> ref_a = blackboard->get_var_ref("a");
+		CHECK(ref_a->exists());
+		CHECK_EQ(ref_a->get_value(), Variant(4));
+		ref_a->set_value(5);
+		CHECK_EQ(blackboard->get_var("a", not_found), Variant(5));
+		CHECK(ref_a->get_version() == blackboard->get_var_version(handle_a));
+		Ref<BBVarRef> ref_new = blackboard->get_var_ref("new");
+		CHECK_FALSE(ref_new->exists());
+		blackboard->set_var("new", 1);
+		CHECK(ref_new->exists());
+		CHECK_EQ(ref_new->get_value(), Variant(1));
+		blackboard->set_var("a", 4);
+
+		Variant value = not_found;
+		CHECK(blackboard->try_get_var_by_handle(handle_a, value));
+		CHECK_EQ(value, Variant(4));
+		value = not_found;
+		CHECK_FALSE(blackboard->try_get_var_by_handle(handle_missing, value));
+		CHECK_EQ(value, not_found);
 	}
 
 	SUBCASE("Test binding") {
@@ -179,6 +376,134 @@ TEST_CASE("[Modules][LimboAI] Test Blackboard") {
 		CHECK_EQ(blackboard->get_var("a", not_found), Variant(333));
 		CHECK_EQ(target_blackboard->get_var("aa", not_found), Variant(333));
 	}
+
+	SUBCASE("Test snapshots") {
+		Ref<Blackboard> parent_scope = memnew(Blackboard);
+		parent_scope->set_var("p", 10);
+		blackboard->set_parent(parent_scope);
+		PackedByteArray snapshot = blackboard->create_snapshot();
+		REQUIRE_FALSE(snapshot.is_empty());
+
+		blackboard->set_var("a", 111);
+		blackboard->set_var("c", "changed");
+		parent_scope->set_var("p", 20);
+		blackboard->set_var("added", true);
+		CHECK(blackboard->restore_snapshot(snapshot) == OK);
+		CHECK_EQ(blackboard->get_var("a", not_found), Variant(1));
+		CHECK_EQ(blackboard->get_var("b", not_found), Variant(Vector2(2, 2)));
+		CHECK_EQ(blackboard->get_var("c", not_found), Variant("3"));
+		CHECK_EQ(parent_scope->get_var("p", not_found), Variant(10));
+		CHECK_EQ(blackboard->get_var("added", not_found), Variant(true)); // * Not in the snapshot - kept.
+
+		// * Erased variables are recreated.
+		blackboard->erase_var("b");
+		CHECK(blackboard->restore_snapshot(snapshot) == OK);
+		CHECK_EQ(blackboard->get_var("b", not_found), Variant(Vector2(2, 2)));
+
+		// * Local scope only.
+		PackedByteArray local_snapshot = blackboard->create_snapshot(false);
+		parent_scope->set_var("p", 30);
+		CHECK(blackboard->restore_snapshot(local_snapshot) == OK);
+		CHECK_EQ(parent_scope->get_var("p", not_found), Variant(30));
+
+		ERR_PRINT_OFF;
+		CHECK(blackboard->restore_snapshot(snapshot.slice(0, snapshot.size() - 3)) == ERR_INVALID_DATA);
+		CHECK(blackboard->restore_snapshot(PackedByteArray()) == ERR_INVALID_DATA);
+		ERR_PRINT_ON;
+	}
+
+	SUBCASE("Test delta export") {
+		Dictionary delta = blackboard->export_delta();
+		CHECK_EQ(int64_t(delta["sequence"]), 1);
+		CHECK_EQ(Dictionary(delta["values"]).size(), 3);
+		CHECK(Array(delta["erased"]).is_empty());
+
+		delta = blackboard->export_delta();
+		CHECK_EQ(blackboard->get_delta_sequence(), 2);
+		CHECK(Dictionary(delta["values"]).is_empty());
+
+		Ref<Blackboard> target_blackboard = memnew(Blackboard);
+		target_blackboard->set_var("aa", 1);
+		blackboard->link_var("a", target_blackboard, "aa");
+		blackboard->export_delta();
+		target_blackboard->set_var("aa", 5); // * Written through the link.
+		blackboard->set_var("d", true);
+		blackboard->erase_var("b");
+		delta = blackboard->export_delta();
+		Dictionary values = delta["values"];
+		CHECK_EQ(values.size(), 2);
+		CHECK_EQ(values["a"], Variant(5));
+		CHECK_EQ(values["d"], Variant(true));
+		Array erased = delta["erased"];
+		REQUIRE_EQ(erased.size(), 1);
+		CHECK_EQ(erased[0], Variant(StringName("b")));
+
+		blackboard->reset_delta();
+		delta = blackboard->export_delta();
+		CHECK_EQ(Dictionary(delta["values"]).size(), 3);
+		CHECK(Array(delta["erased"]).is_empty());
+	}
+
+	SUBCASE("Test diff_vars() is independent of delta export") {
+		LocalVector<StringName> names;
+		LocalVector<int64_t> versions;
+		Array changed;
+		Array erased;
+		blackboard->diff_vars(names, versions, changed, erased);
+		CHECK_EQ(changed.size(), 6); // * Three name/value pairs.
+		CHECK(erased.is_empty());
+
+		blackboard->export_delta();
+		changed.clear();
+		blackboard->diff_vars(names, versions, changed, erased);
+		CHECK(changed.is_empty());
+
+		blackboard->set_var("a", 7);
+		blackboard->erase_var("b");
+		changed.clear();
+		blackboard->diff_vars(names, versions, changed, erased);
+		REQUIRE_EQ(changed.size(), 2);
+		CHECK_EQ(changed[0], Variant(StringName("a")));
+		CHECK_EQ(changed[1], Variant(7));
+		REQUIRE_EQ(erased.size(), 1);
+		CHECK_EQ(erased[0], Variant(StringName("b")));
+		CHECK_EQ(Dictionary(blackboard->export_delta()["values"]).size(), 1);
+	}
+}
+
+TEST_CASE("[Modules][LimboAI] Blackboard variables with time-to-live") {
+	Ref<Blackboard> blackboard = memnew(Blackboard);
+	Ref<TestPropertyHolder> holder = memnew(TestPropertyHolder);
+	blackboard->set_var("seen", 5);
+	blackboard->add_var_listener("seen", callable_mp(holder.ptr(), &TestPropertyHolder::set_property));
+
+	CHECK(blackboard->get_var_ttl("seen") == -1.0);
+	blackboard->set_var_ttl("seen", 1.0);
+	CHECK(blackboard->get_var_ttl("seen") == doctest::Approx(1.0));
+
+	SUBCASE("Expires after the delay") {
+		LimboTimerWheel::process(0.5, false);
+		CHECK(blackboard->get_var("seen") == Variant(5));
+		LimboTimerWheel::process(0.6, false);
+		CHECK(blackboard->get_var("seen") == Variant(0));
+		CHECK(blackboard->get_var_ttl("seen") == -1.0);
+		CHECK(holder->get_property() == 0);
+	}
+	SUBCASE("Setting the time-to-live again restarts it") {
+		LimboTimerWheel::process(0.5, false);
+		blackboard->set_var_with_ttl("seen", 7, 1.0, false);
+		holder->set_property(7);
+		LimboTimerWheel::process(0.6, false);
+		CHECK(blackboard->get_var("seen") == Variant(7));
+		LimboTimerWheel::process(0.5, false);
+		CHECK(blackboard->get_var("seen") == Variant(0));
+		CHECK(holder->get_property() == 7); // * Not notified.
+	}
+	SUBCASE("Cleared time-to-live") {
+		blackboard->clear_var_ttl("seen");
+		LimboTimerWheel::process(1.1, false);
+		CHECK(blackboard->get_var("seen") == Variant(5));
+	}
 }
 
 } //namespace TestBlackboard
@@ -0,0 +1,201 @@
+/**
+ * test_blackboard_plan.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef TEST_BLACKBOARD_PLAN_H
+#define TEST_BLACKBOARD_PLAN_H
+
+#include "limbo_test.h"
+
+#include "modules/limboai/blackboard/blackboard_plan.h"
+
+namespace TestBlackboardPlan {
+
+static PackedStringArray _var_names(const Ref<BlackboardPlan> &p_plan) {
+	PackedStringArray names;
+	for (int i = 0; i < p_plan->get_var_count(); i++) {
+		names.push_back(p_plan->get_var_by_index(i).first);
+	}
+	return names;
+}
+
+static BBVariable _int_var(int p_value) {
+	BBVariable var(Variant::INT);
+	var.set_value(p_value);
+	return var;
+}
+
+TEST_CASE("[Modules][LimboAI] BlackboardPlan") {
+	Ref<BlackboardPlan> plan = memnew(BlackboardPlan);
+	plan->add_var("a", _int_var(1));
+	plan->add_var("b", _int_var(2));
+	plan->add_var("c", _int_var(3));
+	plan->add_var("d", _int_var(4));
+
+	SUBCASE("Order of variables") {
+		plan->move_var(0, 2);
+		CHECK(_var_names(plan) == PackedStringArray({ "b", "c", "a", "d" }));
+		plan->move_var(3, 0);
+		CHECK(_var_names(plan) == PackedStringArray({ "d", "b", "c", "a" }));
+		CHECK_EQ(plan->get_var("a").get_value(), Variant(1));
+
+		plan->remove_var("b");
+		CHECK(_var_names(plan) == PackedStringArray({ "d", "c", "a" }));
+		CHECK_EQ(plan->get_var("c").get_value(), Variant(3));
+
+		plan->rename_var("c", "e");
+		CHECK(_var_names(plan) == PackedStringArray({ "d", "e", "a" }));
+		CHECK(plan->has_var("e"));
+		CHECK_FALSE(plan->has_var("c"));
+	}
+
+	SUBCASE("Syncing with base plan") {
+		Ref<BlackboardPlan> derived = memnew(BlackboardPlan);
+		derived->add_var("x", _int_var(0));
+		derived->add_var("d", _int_var(40));
+		derived->set_base_plan(plan);
+		CHECK(_var_names(derived) == PackedStringArray({ "a", "b", "c", "d" }));
+
+		plan->move_var(3, 0);
+		derived->sync_with_base_plan();
+		CHECK(_var_names(derived) == PackedStringArray({ "d", "a", "b", "c" }));
+		CHECK_EQ(derived->get_var("b").get_value(), Variant(2));
+	}
+
+	SUBCASE("Populating blackboard") {
+		Node *dummy = memnew(Node);
+		Ref<Blackboard> bb = plan->create_blackboard(dummy);
+		CHECK_EQ(bb->list_vars().size(), 4);
+		CHECK_EQ(bb->get_var("d", Variant()), Variant(4));
+
+		// * Plan changes after the first population are picked up.
+		BBVariable array_var(Variant::ARRAY);
+		array_var.set_value(Array());
+		plan->add_var("arr", array_var);
+		plan->get_var("a").set_value(10);
+		Ref<Blackboard> bb1 = plan->create_blackboard(dummy);
+		Ref<Blackboard> bb2 = plan->create_blackboard(dummy);
+		CHECK_EQ(bb1->get_var("a", Variant()), Variant(10));
+		Array arr = bb1->get_var("arr", Variant());
+		arr.push_back(1);
+		CHECK(Array(bb2->get_var("arr", Variant())).is_empty()); // * Not shared between blackboards.
+		CHECK(Array(plan->get_var("arr").get_value()).is_empty());
+
+		// * Existing variables are kept when not overwriting.
+		Ref<Blackboard> existing = memnew(Blackboard);
+		existing->set_var("b", 20);
+		plan->populate_blackboard(existing, false, dummy);
+		CHECK_EQ(existing->get_var("b", Variant()), Variant(20));
+		CHECK_EQ(existing->get_var("c", Variant()), Variant(3));
+		memdelete(dummy);
+	}
+
+	SUBCASE("Shared container defaults") {
+		Array route;
+		route.push_back(Vector2(1, 1));
+		BBVariable route_var(Variant::ARRAY);
+		route_var.set_value(route);
+		plan->add_var("route", route_var);
+		plan->set_share_container_defaults(true);
+
+		Node *dummy = memnew(Node);
+		Ref<Blackboard> bb1 = plan->create_blackboard(dummy);
+		Ref<Blackboard> bb2 = plan->create_blackboard(dummy);
+		Array route1 = bb1->get_var("route", Variant());
+		Array route2 = bb2->get_var("route", Variant());
+		CHECK(route1.is_read_only());
+		CHECK(route1.id() == route2.id());
+		CHECK_EQ(route1.size(), 1);
+		CHECK_FALSE(Array(plan->get_var("route").get_value()).is_read_only());
+
+		// * Assigning replaces the value in one blackboard only.
+		bb1->set_var("route", Array());
+		CHECK_EQ(Array(bb2->get_var("route", Variant())).size(), 1);
+
+		// * Plan value changes are picked up.
+		route.push_back(Vector2(2, 2));
+		plan->get_var("route").set_value(route);
+		Ref<Blackboard> bb3 = plan->create_blackboard(dummy);
+		CHECK_EQ(Array(bb3->get_var("route", Variant())).size(), 2);
+		memdelete(dummy);
+	}
+
+	SUBCASE("Prefetching for many roots") {
+		TypedArray<Node> roots;
+		for (int i = 0; i < 2; i++) {
+			Node *root = memnew(Node);
+			Node *body = memnew(Node);
+			body->set_name("Body");
+			root->add_child(body);
+			Node *arm = memnew(Node);
+			arm->set_name("Arm");
+			body->add_child(arm);
+			Node *leg = memnew(Node);
+			leg->set_name("Leg");
+			body->add_child(leg);
+			roots.push_back(root);
+		}
+		BBVariable arm_var(Variant::NODE_PATH);
+		arm_var.set_value(NodePath("Body/Arm"));
+		plan->add_var("arm", arm_var);
+		BBVariable leg_var(Variant::NODE_PATH);
+		leg_var.set_value(NodePath("./Body/Leg"));
+		plan->add_var("leg", leg_var);
+		BBVariable self_var(Variant::NODE_PATH);
+		self_var.set_value(NodePath("."));
+		plan->add_var("self", self_var);
+
+		TypedArray<Blackboard> bbs = plan->create_blackboards(roots);
+		REQUIRE_EQ(bbs.size(), 2);
+		for (int i = 0; i < 2; i++) {
+			Node *root = Object::cast_to<Node>(roots[i]);
+			Ref<Blackboard> bb = bbs[i];
+			CHECK_EQ(bb->get_var("arm", Variant()), Variant(root->get_node(NodePath("Body/Arm"))));
+			CHECK_EQ(bb->get_var("leg", Variant()), Variant(root->get_node(NodePath("Body/Leg"))));
+			CHECK_EQ(bb->get_var("self", Variant()), Variant(root));
+			CHECK_EQ(bb->get_var("a", Variant()), Variant(1));
+		}
+
+		// * Changing a path through the variable is noticed.
+		plan->get_var("arm").set_value(NodePath("Body"));
+		Ref<Blackboard> bb = plan->create_blackboard(Object::cast_to<Node>(roots[0]));
+		CHECK_EQ(bb->get_var("arm", Variant()), Variant(Object::cast_to<Node>(roots[0])->get_node(NodePath("Body"))));
+
+		for (int i = 0; i < roots.size(); i++) {
+			memdelete(Object::cast_to<Node>(roots[i]));
+		}
+	}
+
+	SUBCASE("Planned bindings") {
+		Node *root = memnew(Node);
+		root->set_name("Root");
+		Node *body = memnew(Node);
+		body->set_name("Body");
+		root->add_child(body);
+		plan->add_var("body_name", BBVariable(Variant::STRING_NAME));
+		plan->set("var/body_name/binding", NodePath("Body:name"));
+		plan->add_var("root_name", BBVariable(Variant::STRING_NAME));
+		plan->set("var/root_name/binding", NodePath(":name"));
+		CHECK_EQ(plan->get("var/body_name/binding"), Variant(NodePath("Body:name")));
+
+		Ref<Blackboard> bb = plan->create_blackboard(root);
+		CHECK_EQ(bb->get_var("body_name", Variant()), Variant(StringName("Body")));
+		CHECK_EQ(bb->get_var("root_name", Variant()), Variant(StringName("Root")));
+		bb->set_var("body_name", StringName("Torso"));
+		CHECK_EQ(body->get_name(), StringName("Torso"));
+		CHECK_EQ(bb->get_var("a", Variant()), Variant(1));
+
+		memdelete(root);
+	}
+}
+
+} //namespace TestBlackboardPlan
+
+#endif // TEST_BLACKBOARD_PLAN_H
@@ -0,0 +1,855 @@
+/**
+ * test_bt_instance.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef TEST_BT_INSTANCE_H
+#define TEST_BT_INSTANCE_H
+
+#include "limbo_test.h"
+
+#include "modules/limboai/blackboard/bb_param/bb_variant.h"
+#include "modules/limboai/bt/behavior_tree.h"
+#include "modules/limboai/bt/bt_instance.h"
+#include "modules/limboai/bt/bt_instance_pool.h"
+#include "modules/limboai/bt/bt_memory_stats.h"
+#include "modules/limboai/bt/bt_stats.h"
+#include "modules/limboai/bt/tasks/blackboard/bt_set_var.h"
+#include "modules/limboai/bt/tasks/composites/bt_selector.h"
+#include "modules/limboai/bt/tasks/composites/bt_sequence.h"
+#include "modules/limboai/bt/tasks/decorators/bt_always_fail.h"
+#include "modules/limboai/bt/tasks/decorators/bt_invert.h"
+#include "modules/limboai/bt/tasks/decorators/bt_probability.h"
+#include "modules/limboai/bt/tasks/utility/bt_fail.h"
+#include "modules/limboai/bt/tasks/utility/bt_wait.h"
+#include "modules/limboai/bt/tasks/utility/bt_wait_ticks.h"
+
+#include "core/io/json.h"
+
+namespace TestBTInstance {
+
+class TestInstanceReceiver : public RefCounted {
+	GDCLASS(TestInstanceReceiver, RefCounted);
+
+public:
+	Ref<BTInstance> instance;
+	int num_received = 0;
+
+	void receive(const Ref<BTInstance> &p_instance) {
+		instance = p_instance;
+		num_received += 1;
+	}
+};
+
+class BTTestBudgetProbe : public BTAction {
+	GDCLASS(BTTestBudgetProbe, BTAction);
+
+public:
+	int64_t remaining_usec = -2;
+
+protected:
+	static void _bind_methods() {}
+
+	virtual Status _tick(double p_delta) override {
+		remaining_usec = get_remaining_budget_usec();
+		return SUCCESS;
+	}
+};
+
+TEST_CASE("[Modules][LimboAI] BTInstance") {
+	ClassDB::register_class<BTTestAction>();
+
+	Ref<BehaviorTree> bt = memnew(BehaviorTree);
+	Ref<BTSequence> seq = memnew(BTSequence);
+	Ref<BTSelector> sel = memnew(BTSelector);
+	Ref<BTTestAction> task1 = memnew(BTTestAction(BTTask::FAILURE));
+	Ref<BTTestAction> task2 = memnew(BTTestAction(BTTask::SUCCESS));
+	Ref<BTTestAction> task3 = memnew(BTTestAction(BTTask::RUNNING));
+	sel->add_child(task1);
+	sel->add_child(task2);
+	seq->add_child(sel);
+	seq->add_child(task3);
+	bt->set_root_task(seq);
+
+	Ref<Blackboard> bb = memnew(Blackboard);
+	Node *dummy = memnew(Node);
+
+	SUBCASE("Test compiled instance") {
+		bt->set_compile_instances(true);
+		Ref<BTInstance> inst = bt->instantiate(dummy, bb, dummy, dummy);
+		REQUIRE(inst.is_valid());
+		REQUIRE(inst->is_compiled());
+
+		/** Hierarchy:
+		 *      seq (0)
+		 *          -> sel (1)
+		 *              -> task1 (2)
+		 *              -> task2 (3)
+		 *          -> task3 (4)
+		 */
+		REQUIRE(inst->get_compiled_node_count() == 5);
+		CHECK(inst->get_compiled_node(0).task == inst->get_root_task().ptr());
+		CHECK(inst->get_compiled_node(0).child_count == 2);
+		CHECK(inst->get_compiled_node(0).first_child == 0);
+		CHECK(inst->get_compiled_node(1).task == inst->get_root_task()->get_child(0).ptr());
+		CHECK(inst->get_compiled_node(1).child_count == 2);
+		CHECK(inst->get_compiled_node(1).first_child == 2);
+		CHECK(inst->get_compiled_node(2).child_count == 0);
+		CHECK(inst->get_compiled_node(4).task == inst->get_root_task()->get_child(1).ptr());
+		CHECK(inst->get_compiled_node(0).kind == BTInstance::NODE_SEQUENCE);
+		CHECK(inst->get_compiled_node(1).kind == BTInstance::NODE_SELECTOR);
+		CHECK(inst->get_compiled_node(2).kind == BTInstance::NODE_TASK);
+
+		CHECK(inst->update(0.01666) == BTTask::RUNNING);
+		Ref<BTTestAction> t1 = inst->get_root_task()->get_child(0)->get_child(0);
+		Ref<BTTestAction> t2 = inst->get_root_task()->get_child(0)->get_child(1);
+		Ref<BTTestAction> t3 = inst->get_root_task()->get_child(1);
+		CHECK_STATUS_ENTRIES_TICKS_EXITS(t1, BTTask::FAILURE, 1, 1, 1);
+		CHECK_STATUS_ENTRIES_TICKS_EXITS(t2, BTTask::SUCCESS, 1, 1, 1);
+		CHECK_STATUS_ENTRIES_TICKS_EXITS(t3, BTTask::RUNNING, 1, 1, 0);
+
+		// * Task states live in the instance, in depth-first order.
+		CHECK(inst->get_compiled_status(0) == BTTask::RUNNING);
+		CHECK(inst->get_compiled_status(1) == BTTask::SUCCESS);
+		CHECK(inst->get_compiled_status(2) == BTTask::FAILURE);
+		CHECK(inst->get_compiled_status(4) == BTTask::RUNNING);
+		CHECK(inst->update(0.125) == BTTask::RUNNING);
+		CHECK(inst->get_compiled_elapsed_time(4) == doctest::Approx(0.125));
+		CHECK(t3->get_elapsed_time() == doctest::Approx(0.125));
+
+		// * Recompiling carries the states over.
+		inst->compile();
+		CHECK(inst->get_compiled_status(4) == BTTask::RUNNING);
+		CHECK(t3->get_status() == BTTask::RUNNING);
+		CHECK(t3->get_elapsed_time() == doctest::Approx(0.125));
+	}
+
+	SUBCASE("Test decorators ticked from compiled records") {
+		Ref<BTInvert> inv = memnew(BTInvert);
+		Ref<BTAlwaysFail> always_fail = memnew(BTAlwaysFail);
+		sel->remove_child(task1);
+		inv->add_child(task1);
+		always_fail->add_child(inv);
+		sel->add_child_at_index(always_fail, 0);
+		bt->set_compile_instances(true);
+		Ref<BTInstance> inst = bt->instantiate(dummy, bb, dummy, dummy);
+		REQUIRE(inst->is_compiled());
+
+		/** Hierarchy:
+		 *      seq (0)
+		 *          -> sel (1)
+		 *              -> always_fail (2)
+		 *                  -> inv (3)
+		 *                      -> task1 (4)
+		 *              -> task2 (5)
+		 *          -> task3 (6)
+		 */
+		REQUIRE(inst->get_compiled_node_count() == 7);
+		CHECK(inst->get_compiled_node(2).kind == BTInstance::NODE_ALWAYS_FAIL);
+		CHECK(inst->get_compiled_node(3).kind == BTInstance::NODE_INVERT);
+
+		CHECK(inst->update(0.01666) == BTTask::RUNNING);
+		CHECK(inst->get_compiled_status(2) == BTTask::FAILURE);
+		CHECK(inst->get_compiled_status(3) == BTTask::SUCCESS);
+		CHECK(inst->get_compiled_status(4) == BTTask::FAILURE);
+		CHECK(inst->get_compiled_status(5) == BTTask::SUCCESS);
+		Ref<BTTestAction> t2 = inst->get_root_task()->get_child(0)->get_child(1);
+		CHECK_STATUS_ENTRIES_TICKS_EXITS(t2, BTTask::SUCCESS, 1, 1, 1);
+	}
+
+	SUBCASE("Test removing a child from a compiled instance") {
+		bt->set_compile_instances(true);
+		Ref<BTInstance> inst = bt->instantiate(dummy, bb, dummy, dummy);
+		REQUIRE(inst->is_compiled());
+		CHECK(inst->update(0.01666) == BTTask::RUNNING);
+
+		// * Removed tasks stay valid while the compiled table refers to them.
+		Ref<BTTask> sel_inst = inst->get_root_task()->get_child(0);
+		sel_inst->remove_child_at_index(1);
+		inst->get_root_task()->remove_child(sel_inst);
+		sel_inst.unref();
+		CHECK(inst->get_root_task()->get_child_count() == 1);
+		inst->update(0.01666);
+		inst->compile();
+		CHECK(inst->get_compiled_node_count() == 2);
+		inst.unref();
+	}
+
+	SUBCASE("Test elapsed time follows the instance clock") {
+		Ref<BTInstance> inst = bt->instantiate(dummy, bb, dummy, dummy);
+		REQUIRE(inst.is_valid());
+		Ref<BTTask> root = inst->get_root_task();
+		Ref<BTTestAction> t3 = root->get_child(1);
+
+		CHECK(inst->update(0.25) == BTTask::RUNNING);
+		CHECK(t3->get_elapsed_time() == 0.0);
+		CHECK(inst->update(0.25) == BTTask::RUNNING);
+		CHECK(inst->update(0.5) == BTTask::RUNNING);
+		CHECK(t3->get_elapsed_time() == 0.75);
+		CHECK(root->get_elapsed_time() == 0.75);
+		CHECK(root->get_child(0)->get_elapsed_time() == 0.0); // * Finished tasks don't age.
+
+		// * Tasks that outlive the instance keep their elapsed time and accumulate it on their own.
+		inst.unref();
+		CHECK(t3->get_elapsed_time() == 0.75);
+		CHECK(t3->execute(0.25) == BTTask::RUNNING);
+		CHECK(t3->get_elapsed_time() == 1.0);
+	}
+
+	SUBCASE("Test work counters") {
+		Ref<BTInstance> inst = bt->instantiate(dummy, bb, dummy, dummy);
+		REQUIRE(inst.is_valid());
+		Ref<BTTestAction> t3 = inst->get_root_task()->get_child(1);
+
+		CHECK(inst->update(0.25) == BTTask::RUNNING);
+		CHECK(inst->get_last_update_task_count() == 5);
+		CHECK(inst->get_task_count_average() == doctest::Approx(5.0));
+		CHECK(inst->update(0.25) == BTTask::RUNNING);
+		CHECK(inst->get_tick_count() == 2);
+		CHECK(inst->get_status_change_count() == 1);
+		CHECK(inst->get_time_since_last_result() == doctest::Approx(0.5));
+
+		t3->ret_status = BTTask::SUCCESS;
+		CHECK(inst->update(0.25) == BTTask::SUCCESS);
+		CHECK(inst->get_status_change_count() == 2);
+		CHECK(inst->get_time_since_last_result() == 0.0);
+	}
+
+	SUBCASE("Test resume running") {
+		Ref<BTInstance> inst = bt->instantiate(dummy, bb, dummy, dummy);
+		REQUIRE(inst.is_valid());
+		inst->set_resume_running(true);
+		Ref<BTTask> root = inst->get_root_task();
+		Ref<BTTestAction> t3 = root->get_child(1);
+
+		CHECK(inst->update(0.01666) == BTTask::RUNNING);
+		CHECK_STATUS_ENTRIES_TICKS_EXITS(t3, BTTask::RUNNING, 1, 1, 0);
+
+		// * Resumed directly at t3, parents still accumulate elapsed time.
+		CHECK(inst->update(0.01666) == BTTask::RUNNING);
+		CHECK_STATUS_ENTRIES_TICKS_EXITS(t3, BTTask::RUNNING, 1, 2, 0);
+		CHECK(root->get_status() == BTTask::RUNNING);
+		CHECK(root->get_elapsed_time() == doctest::Approx(0.01666));
+
+		// * When t3 completes, the result is reported through the regular path.
+		t3->ret_status = BTTask::SUCCESS;
+		CHECK(inst->update(0.01666) == BTTask::SUCCESS);
+		CHECK_STATUS_ENTRIES_TICKS_EXITS(t3, BTTask::SUCCESS, 1, 3, 1);
+		CHECK(root->get_status() == BTTask::SUCCESS);
+	}
+
+	SUBCASE("Test update interval") {
+		Ref<BTInstance> inst = bt->instantiate(dummy, bb, dummy, dummy);
+		REQUIRE(inst.is_valid());
+		CHECK(inst->advance(0.01));
+		CHECK(inst->consume_pending_delta() == doctest::Approx(0.01));
+
+		inst->set_update_interval(0.1);
+		int num_updates = 0;
+		double total_delta = 0.0;
+		for (int i = 0; i < 50; i++) {
+			if (inst->advance(0.01)) {
+				num_updates += 1;
+				total_delta += inst->consume_pending_delta();
+			}
+		}
+		// * Starting phase is randomized, but the rate is not.
+		CHECK(num_updates >= 4);
+		CHECK(num_updates <= 6);
+		CHECK(total_delta <= doctest::Approx(0.5));
+	}
+
+	SUBCASE("Test tick budget") {
+		ClassDB::register_class<BTTestBudgetProbe>();
+		Ref<BTTestBudgetProbe> probe = memnew(BTTestBudgetProbe);
+		Ref<BTInstance> inst = BTInstance::create(probe, "", dummy);
+		probe->initialize(dummy, bb, dummy);
+		CHECK(BTInstance::get_remaining_budget_usec() == -1);
+
+		inst->update(0.01);
+		CHECK(probe->remaining_usec == -1); // * Not limited.
+
+		inst->set_tick_budget_usec(1000000);
+		inst->update(0.01);
+		CHECK(probe->remaining_usec > 0);
+		CHECK(probe->remaining_usec <= 1000000);
+		CHECK(BTInstance::get_remaining_budget_usec() == -1); // * Restored after the update.
+	}
+
+	SUBCASE("Test thread safety classification") {
+		Ref<BTInstance> inst = bt->instantiate(dummy, bb, dummy, dummy);
+		REQUIRE(inst.is_valid());
+		// * BTTestAction is not classified as thread-safe.
+		CHECK_FALSE(inst->is_thread_safe());
+
+		Ref<BehaviorTree> safe_bt = memnew(BehaviorTree);
+		Ref<BTSequence> safe_seq = memnew(BTSequence);
+		safe_seq->add_child(memnew(BTFail));
+		safe_bt->set_root_task(safe_seq);
+		Ref<BTInstance> safe_inst = safe_bt->instantiate(dummy, bb, dummy, dummy);
+		REQUIRE(safe_inst.is_valid());
+		CHECK(safe_inst->is_thread_safe());
+
+		// * Shared outer scopes must not be written, and listeners rule out worker threads.
+		Ref<BTSetVar> set_var = memnew(BTSetVar);
+		set_var->set_variable("x");
+		Ref<BBVariant> value = memnew(BBVariant);
+		value->set_saved_value(1);
+		set_var->set_value(value);
+		safe_seq->add_child(set_var);
+		Ref<Blackboard> outer = memnew(Blackboard);
+		outer->set_var("x", 0);
+		Ref<Blackboard> scope = memnew(Blackboard);
+		scope->set_parent(outer);
+		Ref<BTInstance> outer_inst = safe_bt->instantiate(dummy, scope, dummy, dummy);
+		REQUIRE(outer_inst.is_valid());
+		CHECK_FALSE(outer_inst->is_thread_safe());
+
+		scope->set_var("x", 0);
+		CHECK(outer_inst->is_thread_safe());
+		scope->add_var_listener("x", callable_mp(dummy, &Node::queue_free));
+		CHECK_FALSE(outer_inst->is_thread_safe());
+		scope->remove_var_listener("x", callable_mp(dummy, &Node::queue_free));
+	}
+
+	SUBCASE("Test purity classification") {
+		Ref<BehaviorTree> pure_bt = memnew(BehaviorTree);
+		Ref<BTSequence> pure_seq = memnew(BTSequence);
+		pure_seq->add_child(memnew(BTWait));
+		pure_seq->add_child(memnew(BTFail));
+		pure_bt->set_root_task(pure_seq);
+		Ref<BTInstance> pure_inst = pure_bt->instantiate(dummy, bb, dummy, dummy);
+		REQUIRE(pure_inst.is_valid());
+		CHECK(pure_inst->is_pure());
+
+		// * Random decisions depend on the random stream, which isn't shared.
+		Ref<BTProbability> probability = memnew(BTProbability);
+		probability->add_child(memnew(BTFail));
+		pure_seq->add_child(probability);
+		Ref<BTInstance> impure_inst = pure_bt->instantiate(dummy, bb, dummy, dummy);
+		REQUIRE(impure_inst.is_valid());
+		CHECK_FALSE(impure_inst->is_pure());
+	}
+
+	SUBCASE("Test reactive mode") {
+		Ref<BehaviorTree> wait_bt = memnew(BehaviorTree);
+		Ref<BTSequence> wait_seq = memnew(BTSequence);
+		Ref<BTWait> wait = memnew(BTWait);
+		wait->set_duration(1.0);
+		wait_seq->add_child(wait);
+		wait_bt->set_root_task(wait_seq);
+		Ref<BTInstance> inst = wait_bt->instantiate(dummy, bb, dummy, dummy);
+		REQUIRE(inst.is_valid());
+		inst->set_reactive(true);
+
+		CHECK(inst->update(0.25) == BTTask::RUNNING);
+		CHECK(inst->is_sleeping());
+		// * Not ticked until the wait is over, and then receives the whole delta.
+		for (int i = 0; i < 3; i++) {
+			CHECK_FALSE(inst->advance(0.25));
+		}
+		CHECK(inst->advance(0.25));
+		CHECK_FALSE(inst->is_sleeping());
+		CHECK(inst->update(inst->consume_pending_delta()) == BTTask::SUCCESS);
+
+		// * Woken early by a blackboard change, or explicitly.
+		CHECK(inst->update(0.25) == BTTask::RUNNING);
+		CHECK_FALSE(inst->advance(0.25));
+		bb->set_var("changed", true);
+		CHECK(inst->advance(0.25));
+		CHECK(inst->update(inst->consume_pending_delta()) == BTTask::RUNNING);
+		CHECK(inst->is_sleeping());
+		inst->wake();
+		CHECK(inst->advance(0.25));
+
+		// * Posted events request a wake-up, which is picked up by the next advance().
+		CHECK(inst->update(inst->consume_pending_delta()) == BTTask::RUNNING);
+		CHECK(inst->is_sleeping());
+		inst->post_event("test_event");
+		CHECK(inst->advance(0.25));
+		CHECK_FALSE(inst->is_sleeping());
+
+		// * Tasks that don't request a wake-up time keep the instance awake.
+		Ref<BTInstance> busy_inst = bt->instantiate(dummy, bb, dummy, dummy);
+		busy_inst->set_reactive(true);
+		CHECK(busy_inst->update(0.25) == BTTask::RUNNING);
+		CHECK_FALSE(busy_inst->is_sleeping());
+	}
+
+	SUBCASE("Test snapshots") {
+		Ref<BehaviorTree> ticks_bt = memnew(BehaviorTree);
+		Ref<BTSequence> ticks_seq = memnew(BTSequence);
+		Ref<BTWaitTicks> wait_ticks = memnew(BTWaitTicks);
+		wait_ticks->set_num_ticks(2);
+		ticks_seq->add_child(wait_ticks);
+		ticks_seq->add_child(memnew(BTWaitTicks));
+		ticks_bt->set_root_task(ticks_seq);
+		Ref<BTInstance> inst = ticks_bt->instantiate(dummy, bb, dummy, dummy);
+		REQUIRE(inst.is_valid());
+
+		bb->set_var("counter", 1);
+		CHECK(inst->update(0.1) == BTTask::RUNNING);
+		PackedByteArray snapshot = inst->create_snapshot();
+		REQUIRE_FALSE(snapshot.is_empty());
+
+		CHECK(inst->update(0.1) == BTTask::RUNNING);
+		CHECK(inst->update(0.1) == BTTask::RUNNING); // * Second BTWaitTicks.
+		bb->set_var("counter", 2);
+
+		CHECK(inst->restore_snapshot(snapshot) == OK);
+		CHECK(inst->get_last_status() == BTTask::RUNNING);
+		CHECK(bb->get_var("counter") == Variant(1));
+		Ref<BTTask> root = inst->get_root_task();
+		CHECK(root->get_child(0)->get_status() == BTTask::RUNNING);
+		CHECK(root->get_child(0)->get_elapsed_time() == 0.0);
+		CHECK(root->get_child(1)->get_status() == BTTask::FRESH);
+		// * Continues from the restored tick count.
+		CHECK(inst->update(0.1) == BTTask::RUNNING);
+		CHECK(root->get_child(0)->get_elapsed_time() == doctest::Approx(0.1));
+		CHECK(inst->update(0.1) == BTTask::RUNNING);
+		CHECK(root->get_child(0)->get_status() == BTTask::SUCCESS);
+
+		// * Rejected by an instance of a different tree.
+		Ref<BTInstance> other_inst = bt->instantiate(dummy, bb, dummy, dummy);
+		ERR_PRINT_OFF;
+		CHECK(other_inst->restore_snapshot(snapshot) == ERR_INVALID_DATA);
+		ERR_PRINT_ON;
+
+		// * Truncated snapshots are rejected before anything is restored.
+		CHECK(root->get_child(1)->get_status() == BTTask::RUNNING);
+		ERR_PRINT_OFF;
+		CHECK(inst->restore_snapshot(snapshot.slice(0, snapshot.size() - 3)) == ERR_INVALID_DATA);
+		ERR_PRINT_ON;
+		CHECK(inst->get_last_status() == BTTask::RUNNING);
+		CHECK(root->get_child(0)->get_status() == BTTask::SUCCESS);
+		CHECK(root->get_child(1)->get_status() == BTTask::RUNNING);
+	}
+
+	SUBCASE("Test populations") {
+		Ref<BehaviorTree> ticks_bt = memnew(BehaviorTree);
+		Ref<BTSequence> ticks_seq = memnew(BTSequence);
+		Ref<BTWaitTicks> wait_ticks = memnew(BTWaitTicks);
+		wait_ticks->set_num_ticks(2);
+		ticks_seq->add_child(wait_ticks);
+		ticks_seq->add_child(memnew(BTWaitTicks));
+		ticks_bt->set_root_task(ticks_seq);
+
+		TypedArray<BTInstance> saved;
+		TypedArray<BTInstance> loaded;
+		int snapshots_size = 0;
+		for (int i = 0; i < 32; i++) {
+			Ref<Blackboard> agent_bb = memnew(Blackboard);
+			agent_bb->set_var("counter", i < 30 ? 0 : i);
+			Ref<BTInstance> inst = ticks_bt->instantiate(dummy, agent_bb, dummy, dummy);
+			REQUIRE(inst.is_valid());
+			inst->update(0.1);
+			if (i == 31) {
+				inst->update(0.1);
+				inst->update(0.1); // * Second BTWaitTicks.
+			}
+			saved.push_back(inst);
+			snapshots_size += inst->create_snapshot().size();
+
+			Ref<Blackboard> fresh_bb = memnew(Blackboard);
+			fresh_bb->set_var("counter", -1);
+			loaded.push_back(ticks_bt->instantiate(dummy, fresh_bb, dummy, dummy));
+		}
+		PackedByteArray data = BTInstance::save_population(saved);
+		REQUIRE_FALSE(data.is_empty());
+		// * Equal instances collapse into runs.
+		CHECK(data.size() < snapshots_size / 2);
+
+		REQUIRE(BTInstance::load_population(loaded, data) == OK);
+		for (int i = 0; i < 32; i++) {
+			Ref<BTInstance> inst = loaded[i];
+			Ref<BTTask> root = inst->get_root_task();
+			CHECK(inst->get_blackboard()->get_var("counter") == Variant(i < 30 ? 0 : i));
+			CHECK(root->get_child(0)->get_status() == (i == 31 ? BTTask::SUCCESS : BTTask::RUNNING));
+			CHECK(root->get_child(1)->get_status() == (i == 31 ? BTTask::RUNNING : BTTask::FRESH));
+		}
+		// * Continues from the restored tick count.
+		Ref<BTInstance> first = loaded[0];
+		first->update(0.1);
+		CHECK(first->get_root_task()->get_child(0)->get_status() == BTTask::RUNNING);
+		first->update(0.1);
+		CHECK(first->get_root_task()->get_child(0)->get_status() == BTTask::SUCCESS);
+
+		// * Corrupted data is rejected before any instance is touched.
+		PackedByteArray truncated = data.slice(0, data.size() - 1);
+		PackedByteArray long_run = data;
+		long_run.set(4 + 1 + 4 + 4 + 32 * 16, 200); // Run of statuses, longer than the population.
+		ERR_PRINT_OFF;
+		CHECK(BTInstance::load_population(loaded, truncated) == ERR_INVALID_DATA);
+		CHECK(BTInstance::load_population(loaded, long_run) == ERR_INVALID_DATA);
+		ERR_PRINT_ON;
+		CHECK(first->get_root_task()->get_child(0)->get_status() == BTTask::SUCCESS);
+		CHECK(Ref<BTInstance>(loaded[1])->get_root_task()->get_child(0)->get_status() == BTTask::RUNNING);
+
+		loaded.resize(31);
+		ERR_PRINT_OFF;
+		CHECK(BTInstance::load_population(loaded, data) == ERR_INVALID_PARAMETER);
+		ERR_PRINT_ON;
+	}
+
+	SUBCASE("Test hot swap") {
+		Ref<BehaviorTree> old_bt = memnew(BehaviorTree);
+		Ref<BTSequence> old_seq = memnew(BTSequence);
+		Ref<BTWaitTicks> wait_ticks = memnew(BTWaitTicks);
+		wait_ticks->set_num_ticks(3);
+		old_seq->add_child(wait_ticks);
+		old_seq->add_child(memnew(BTWaitTicks));
+		old_bt->set_root_task(old_seq);
+		Ref<BTInstance> inst = old_bt->instantiate(dummy, bb, dummy, dummy);
+		REQUIRE(inst.is_valid());
+		bb->set_var("counter", 5);
+		CHECK(inst->update(0.1) == BTTask::RUNNING);
+		Ref<BTTask> old_root = inst->get_root_task();
+
+		// * The second task is replaced, and the running one keeps its state.
+		Ref<BehaviorTree> new_bt = memnew(BehaviorTree);
+		Ref<BTSequence> new_seq = memnew(BTSequence);
+		Ref<BTWaitTicks> new_wait_ticks = memnew(BTWaitTicks);
+		new_wait_ticks->set_num_ticks(3);
+		new_seq->add_child(new_wait_ticks);
+		new_seq->add_child(memnew(BTFail));
+		new_bt->set_root_task(new_seq);
+		CHECK(inst->hot_swap(new_bt) == 2);
+
+		Ref<BTTask> root = inst->get_root_task();
+		CHECK(root != old_root);
+		CHECK(inst->get_blackboard() == bb);
+		CHECK(bb->get_var("counter") == Variant(5));
+		CHECK(root->get_child(0)->get_status() == BTTask::RUNNING);
+		CHECK(root->get_child(1)->get_status() == BTTask::FRESH);
+		CHECK(IS_CLASS(root->get_child(1).ptr(), BTFail));
+		// * Continues from the carried over tick count.
+		CHECK(inst->update(0.1) == BTTask::RUNNING);
+		CHECK(inst->update(0.1) == BTTask::RUNNING);
+		CHECK(inst->update(0.1) == BTTask::FAILURE);
+
+		// * Tasks that don't match start fresh.
+		Ref<BehaviorTree> other_bt = memnew(BehaviorTree);
+		other_bt->set_root_task(memnew(BTWaitTicks));
+		CHECK(inst->hot_swap(other_bt) == 0);
+		CHECK(inst->get_root_task()->get_status() == BTTask::FRESH);
+
+		// * Headless instances have no agent to keep.
+		Ref<BTInstance> headless = old_bt->instantiate_headless(bb);
+		REQUIRE(headless.is_valid());
+		CHECK(headless->update(0.1) == BTTask::RUNNING);
+		CHECK(headless->hot_swap(new_bt) == 2);
+		CHECK(headless->get_root_task()->get_agent() == nullptr);
+		CHECK(headless->update(0.1) == BTTask::RUNNING);
+	}
+
+#ifdef DEBUG_ENABLED
+	SUBCASE("Test profiling") {
+		bt->set_profiling_enabled(true);
+		Ref<BTInstance> inst1 = bt->instantiate(dummy, bb, dummy, dummy);
+		Ref<BTInstance> inst2 = bt->instantiate(dummy, bb, dummy, dummy);
+		CHECK(inst1->update(0.01666) == BTTask::RUNNING);
+		CHECK(inst2->update(0.01666) == BTTask::RUNNING);
+
+		// * Aggregated over both instances, in depth-first order.
+		Ref<BTProfile> profile = bt->get_profile();
+		REQUIRE(profile.is_valid());
+		REQUIRE(profile->get_task_count() == 5);
+		for (int i = 0; i < profile->get_task_count(); i++) {
+			CHECK(profile->get_tick_count(i) == 2);
+			CHECK(profile->get_self_time_usec(i) <= profile->get_inclusive_time_usec(i));
+		}
+		CHECK(profile->get_inclusive_time_usec(0) >= profile->get_inclusive_time_usec(1));
+
+		profile->reset();
+		CHECK(profile->get_tick_count(0) == 0);
+
+		// * Same number of tasks, but a different layout.
+		bt->instantiate(dummy, bb, dummy, dummy);
+		CHECK(bt->get_profile() == profile);
+		seq->remove_child(task3);
+		seq->add_child(memnew(BTFail));
+		bt->instantiate(dummy, bb, dummy, dummy);
+		REQUIRE(bt->get_profile().is_valid());
+		CHECK(bt->get_profile() != profile);
+		CHECK(bt->get_profile()->get_task_count() == 5);
+		bt->set_profiling_enabled(false);
+	}
+#endif // DEBUG_ENABLED
+
+	SUBCASE("Test telemetry") {
+		bt->set_telemetry_enabled(true);
+		Ref<BTInstance> inst1 = bt->instantiate(dummy, bb, dummy, dummy);
+		Ref<BTInstance> inst2 = bt->instantiate(dummy, bb, dummy, dummy);
+		CHECK(inst1->update(0.01666) == BTTask::RUNNING);
+		CHECK(inst1->update(0.01666) == BTTask::RUNNING);
+		CHECK(inst2->update(0.01666) == BTTask::RUNNING);
+		inst2->get_root_task()->abort();
+
+		// * Tasks in depth-first order: seq, sel, task1, task2, task3.
+		Ref<BTTelemetry> telemetry = bt->get_telemetry();
+		REQUIRE(telemetry.is_valid());
+		REQUIRE(telemetry->get_task_count() == 5);
+		CHECK(telemetry->get_counter(0, BTTelemetry::COUNTER_ENTERED) == 2);
+		CHECK(telemetry->get_counter(0, BTTelemetry::COUNTER_TICKS) == 3);
+		CHECK(telemetry->get_counter(0, BTTelemetry::COUNTER_ABORTED) == 1);
+		CHECK(telemetry->get_counter(1, BTTelemetry::COUNTER_SUCCEEDED) == 2);
+		CHECK(telemetry->get_counter(2, BTTelemetry::COUNTER_FAILED) == 2);
+		CHECK(telemetry->get_counter(3, BTTelemetry::COUNTER_SUCCEEDED) == 2);
+		CHECK(telemetry->get_counter(4, BTTelemetry::COUNTER_TICKS) == 3);
+		CHECK(telemetry->get_counter(4, BTTelemetry::COUNTER_ABORTED) == 1);
+		CHECK(telemetry->get_counters().size() == 5 * BTTelemetry::COUNTER_MAX);
+
+		// * Pooled tasks stop counting once released.
+		Ref<BTInstancePool> pool = memnew(BTInstancePool);
+		pool->release(inst1);
+		bt->set_telemetry_enabled(false);
+		Ref<BTInstance> inst3 = pool->acquire(bt, dummy, dummy, dummy);
+		REQUIRE(inst3.is_valid());
+		inst3->update(0.01666);
+		CHECK(telemetry->get_counter(0, BTTelemetry::COUNTER_TICKS) == 3);
+
+		telemetry->reset();
+		CHECK(telemetry->get_counter(0, BTTelemetry::COUNTER_ENTERED) == 0);
+	}
+
+	SUBCASE("Test instance pool") {
+		Ref<BTInstancePool> pool = memnew(BTInstancePool);
+		Ref<BTInstance> inst = pool->acquire(bt, dummy, dummy, dummy);
+		REQUIRE(inst.is_valid());
+		Ref<BTTask> root = inst->get_root_task();
+		CHECK(inst->update(0.01666) == BTTask::RUNNING);
+		inst->get_blackboard()->set_var("runtime_var", 1);
+
+		pool->release(inst);
+		CHECK_FALSE(inst->is_instance_valid());
+		CHECK(pool->get_pooled_count(bt) == 1);
+		CHECK(root->get_status() == BTTask::FRESH);
+
+		// * Recycled tree and blackboard are reset.
+		Ref<BTInstance> reused = pool->acquire(bt, dummy, dummy, dummy);
+		REQUIRE(reused.is_valid());
+		CHECK(reused->get_root_task() == root);
+		CHECK(pool->get_pooled_count(bt) == 0);
+		CHECK_FALSE(reused->get_blackboard()->has_var("runtime_var"));
+		CHECK(reused->update(0.01666) == BTTask::RUNNING);
+
+		pool->set_max_pooled_per_tree(2);
+		pool->prewarm(bt, 5);
+		CHECK(pool->get_pooled_count(bt) == 2);
+		pool->clear();
+		CHECK(pool->get_pooled_count(bt) == 0);
+
+		// * Pooled trees cloned from an outdated root task are dropped.
+		pool->prewarm(bt, 1);
+		pool->release(reused);
+		CHECK(pool->get_pooled_count(bt) == 2);
+		Ref<BTFail> new_root = memnew(BTFail);
+		bt->set_root_task(new_root);
+		CHECK(pool->get_pooled_count(bt) == 0);
+		Ref<BTInstance> fresh = pool->acquire(bt, dummy, dummy, dummy);
+		REQUIRE(fresh.is_valid());
+		CHECK(fresh->get_root_task() != root);
+		CHECK(fresh->update(0.01666) == BTTask::FAILURE);
+		pool->release(fresh);
+		CHECK(pool->get_pooled_count(bt) == 1);
+		bt->set_root_task(seq);
+	}
+
+	SUBCASE("Test async instantiation") {
+		Ref<TestInstanceReceiver> receiver = memnew(TestInstanceReceiver);
+		bt->instantiate_async(dummy, bb, dummy, callable_mp(receiver.ptr(), &TestInstanceReceiver::receive), dummy);
+		CHECK(receiver->num_received == 0);
+		BehaviorTree::finish_async_instantiations();
+		REQUIRE(receiver->num_received == 1);
+		REQUIRE(receiver->instance.is_valid());
+		CHECK(receiver->instance->get_root_task() != bt->get_root_task());
+		CHECK(receiver->instance->update(0.01666) == BTTask::RUNNING);
+
+		// * Finished with a null instance if the agent is freed before the instantiation finishes.
+		Node *agent = memnew(Node);
+		bt->instantiate_async(agent, bb, dummy, callable_mp(receiver.ptr(), &TestInstanceReceiver::receive), dummy);
+		memdelete(agent);
+		ERR_PRINT_OFF;
+		BehaviorTree::finish_async_instantiations();
+		ERR_PRINT_ON;
+		CHECK(receiver->num_received == 2);
+		CHECK(receiver->instance.is_null());
+
+		// * Pending instantiations are freed without calling back.
+		bt->instantiate_async(dummy, bb, dummy, callable_mp(receiver.ptr(), &TestInstanceReceiver::receive), dummy);
+		BehaviorTree::free_async_operations();
+		BehaviorTree::finish_async_instantiations();
+		CHECK(receiver->num_received == 2);
+	}
+
+	SUBCASE("Test runtime stats") {
+		if (BTStats::is_enabled()) {
+			Ref<BTInstance> inst = bt->instantiate(dummy, bb, dummy, dummy);
+			BTStats::merge(1.0);
+			inst->update(0.01666);
+			inst->update(0.01666);
+			BTStats::merge(1.0);
+			CHECK(BTStats::get_frame_instances_updated() == 2);
+			// * 5 tasks on the first update, then the sequence resumes on its running child.
+			CHECK(BTStats::get_frame_tasks_executed() >= 7);
+			BTStats::merge(1.0);
+			CHECK(BTStats::get_frame_instances_updated() == 0);
+		}
+
+		// * Same task count with profiling and telemetry as without them.
+		Ref<BTInstance> plain = bt->instantiate(dummy, bb, dummy, dummy);
+		bt->set_profiling_enabled(true);
+		bt->set_telemetry_enabled(true);
+		Ref<BTInstance> recorded = bt->instantiate(dummy, bb, dummy, dummy);
+		bt->set_profiling_enabled(false);
+		bt->set_telemetry_enabled(false);
+		for (int i = 0; i < 3; i++) {
+			uint64_t start = BTStats::get_thread_task_count();
+			plain->update(0.01666);
+			const uint64_t plain_count = BTStats::get_thread_task_count() - start;
+			start = BTStats::get_thread_task_count();
+			recorded->update(0.01666);
+			CHECK(BTStats::get_thread_task_count() - start == plain_count);
+			CHECK(plain_count > 0);
+		}
+	}
+
+	SUBCASE("Test memory usage") {
+		const uint64_t total_before = BTMemoryStats::get_total_memory_usage();
+		bb->set_var("route", PackedVector2Array({ Vector2(1, 1), Vector2(2, 2) }));
+		Ref<BTInstance> inst = bt->instantiate(dummy, bb, dummy, dummy);
+		Dictionary usage = inst->get_memory_usage();
+		CHECK(int64_t(usage["tasks"]) >= int64_t(5 * sizeof(BTTask)));
+		CHECK(int64_t(usage["blackboard"]) >= int64_t(2 * sizeof(Vector2)));
+		CHECK(int64_t(usage["total"]) >= int64_t(usage["tasks"]) + int64_t(usage["blackboard"]));
+
+		Dictionary tree_usage = bt->get_memory_usage();
+		CHECK(int(tree_usage["instances"]) == 1);
+		CHECK(int64_t(tree_usage["total"]) > 0);
+		CHECK(BTMemoryStats::get_total_memory_usage() == total_before + uint64_t(int64_t(tree_usage["total"])));
+
+		inst.unref();
+		CHECK(int(Dictionary(bt->get_memory_usage())["instances"]) == 0);
+		CHECK(BTMemoryStats::get_total_memory_usage() == total_before);
+	}
+
+	SUBCASE("Test spike capture") {
+		if (BTStats::is_enabled()) {
+			Ref<BTInstance> inst = bt->instantiate(dummy, bb, dummy, dummy);
+			BTStats::set_spike_capture(true);
+			BTStats::merge(1.0);
+			inst->update(0.01666);
+			inst->update(0.01666);
+			BTStats::merge(1.0);
+			REQUIRE(BTStats::get_frame_spikes().size() == 2);
+			CHECK(BTStats::get_frame_spikes()[0].instance_id == inst->get_instance_id());
+			CHECK(BTStats::get_frame_spikes()[0].usec >= BTStats::get_frame_spikes()[1].usec);
+			uint64_t histogram_total = 0;
+			for (int b = 0; b < BTStats::HISTOGRAM_BUCKETS; b++) {
+				histogram_total += BTStats::get_frame_histogram_bucket(b);
+			}
+			CHECK(histogram_total == 2);
+			BTStats::set_spike_capture(false);
+			CHECK(BTStats::get_frame_spikes().is_empty());
+		}
+	}
+
+#ifdef DEBUG_ENABLED
+	SUBCASE("Test trace") {
+		Ref<BTInstance> inst = bt->instantiate(dummy, bb, dummy, dummy);
+		inst->set_trace_enabled(true);
+		Ref<BTTrace> trace = inst->get_trace();
+		REQUIRE(trace.is_valid());
+		REQUIRE(trace->get_task_count() == 5);
+
+		inst->update(0.01666);
+		// * Children finish before their parents.
+		REQUIRE(trace->get_record_count() == 5);
+		CHECK(trace->get_record_unchecked(0).task_index == 2);
+		CHECK(trace->get_record_unchecked(0).new_status == BTTask::FAILURE);
+		CHECK(trace->get_record_unchecked(4).task_index == 0);
+		CHECK(trace->get_record_unchecked(4).old_status == BTTask::FRESH);
+		CHECK(trace->get_record_unchecked(4).new_status == BTTask::RUNNING);
+
+		inst->update(0.01666);
+		CHECK(trace->get_record_count() == 5); // Still running - no transitions.
+
+		PackedInt32Array statuses = trace->get_statuses_at(5);
+		CHECK(statuses[0] == BTTask::RUNNING);
+		CHECK(statuses[1] == BTTask::SUCCESS);
+		CHECK(statuses[4] == BTTask::RUNNING);
+		CHECK(trace->get_statuses_at(1)[0] == BTTask::FRESH);
+
+		Ref<BTTrace> copy = memnew(BTTrace);
+		REQUIRE(copy->from_bytes(trace->to_bytes()) == OK);
+		CHECK(copy->get_task_count() == 5);
+		CHECK(copy->get_record_count() == 5);
+		CHECK(copy->get_task_name(4) == trace->get_task_name(4));
+		CHECK(copy->get_statuses_at(5) == statuses);
+		CHECK(copy->get_start_usec() == trace->get_start_usec());
+
+		// * Three tasks finished in the first tick, two are still running, and the track is named.
+		TypedArray<BTTrace> traces;
+		traces.push_back(copy);
+		Dictionary chrome_trace = JSON::parse_string(BTTrace::to_chrome_trace(traces, PackedStringArray({ "agent" })));
+		Array events = chrome_trace["traceEvents"];
+		REQUIRE(events.size() == 6);
+		CHECK(Dictionary(Dictionary(events[0])["args"])["name"] == Variant("agent"));
+		CHECK(Dictionary(events[1])["name"] == Variant(trace->get_task_name(2)));
+		CHECK(Dictionary(events[5])["ph"] == Variant("X"));
+
+		trace->set_capacity(2);
+		inst->get_root_task()->abort();
+		CHECK(trace->get_record_count() == 2); // Ring buffer keeps the newest records.
+		CHECK(trace->get_record_unchecked(1).task_index == 0);
+		CHECK(trace->get_record_unchecked(1).new_status == BTTask::FRESH);
+
+		inst->set_trace_enabled(false);
+		CHECK_FALSE(inst->is_trace_enabled());
+		CHECK(inst->get_trace() == trace);
+	}
+#endif // DEBUG_ENABLED
+
+	SUBCASE("Test seeded instances") {
+		Ref<BehaviorTree> random_bt = memnew(BehaviorTree);
+		Ref<BTProbability> prob = memnew(BTProbability);
+		prob->set_run_chance(0.5);
+		prob->add_child(memnew(BTTestAction(BTTask::SUCCESS)));
+		random_bt->set_root_task(prob);
+
+		// Returns outcomes of a number of updates as bits.
+		auto run = [&](int64_t p_seed) {
+			Ref<BTInstance> inst = random_bt->instantiate(dummy, memnew(Blackboard), dummy, dummy);
+			inst->set_seed(p_seed);
+			uint64_t outcomes = 0;
+			for (int i = 0; i < 64; i++) {
+				outcomes |= uint64_t(inst->update(0.01666) == BTTask::SUCCESS) << i;
+			}
+			return outcomes;
+		};
+
+		const uint64_t outcomes = run(1234);
+		CHECK(outcomes != 0);
+		CHECK(outcomes == run(1234));
+		CHECK(outcomes != run(4321));
+	}
+
+	SUBCASE("Test uncompiled instance") {
+		Ref<BTInstance> inst = bt->instantiate(dummy, bb, dummy, dummy);
+		REQUIRE(inst.is_valid());
+		CHECK_FALSE(inst->is_compiled());
+		CHECK(inst->update(0.01666) == BTTask::RUNNING);
+	}
+
+	memdelete(dummy);
+}
+
+} //namespace TestBTInstance
+
+#endif // TEST_BT_INSTANCE_H
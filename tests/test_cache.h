@@ -0,0 +1,102 @@
+/**
+ * test_cache.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef TEST_CACHE_H
+#define TEST_CACHE_H
+
+#include "limbo_test.h"
+
+#include "modules/limboai/bt/tasks/bt_task.h"
+#include "modules/limboai/bt/tasks/decorators/bt_cache.h"
+#include "modules/limboai/util/limbo_timer_wheel.h"
+
+namespace TestCache {
+
+TEST_CASE("[Modules][LimboAI] BTCache") {
+	Ref<BTCache> cache = memnew(BTCache);
+	Ref<BTTestAction> task = memnew(BTTestAction(BTTask::SUCCESS));
+	cache->add_child(task);
+
+	Ref<Blackboard> bb = memnew(Blackboard);
+	Node *dummy = memnew(Node);
+
+	SUBCASE("Expires with time") {
+		cache->set_duration(1.0);
+		cache->initialize(dummy, bb, dummy);
+		CHECK(cache->execute(0.01666) == BTTask::SUCCESS);
+		CHECK_ENTRIES_TICKS_EXITS(task, 1, 1, 1);
+
+		task->ret_status = BTTask::FAILURE;
+		CHECK(cache->execute(0.01666) == BTTask::SUCCESS); // * cached
+		CHECK_ENTRIES_TICKS_EXITS(task, 1, 1, 1);
+		LimboTimerWheel::process(0.5, false);
+		CHECK(cache->execute(0.01666) == BTTask::SUCCESS);
+		LimboTimerWheel::process(0.6, false);
+		CHECK(cache->execute(0.01666) == BTTask::FAILURE);
+		CHECK_ENTRIES_TICKS_EXITS(task, 2, 2, 2);
+
+		cache->invalidate();
+		CHECK_FALSE(cache->has_cached_result());
+		task->ret_status = BTTask::SUCCESS;
+		CHECK(cache->execute(0.01666) == BTTask::SUCCESS);
+		CHECK_ENTRIES_TICKS_EXITS(task, 3, 3, 3);
+	}
+
+	SUBCASE("Expires after max_ticks") {
+		cache->set_duration(0.0);
+		cache->set_max_ticks(2);
+		cache->initialize(dummy, bb, dummy);
+		CHECK(cache->execute(0.01666) == BTTask::SUCCESS);
+		CHECK(cache->execute(0.01666) == BTTask::SUCCESS);
+		CHECK(cache->execute(0.01666) == BTTask::SUCCESS);
+		CHECK_ENTRIES_TICKS_EXITS(task, 1, 1, 1);
+		CHECK(cache->execute(0.01666) == BTTask::SUCCESS);
+		CHECK_ENTRIES_TICKS_EXITS(task, 2, 2, 2);
+	}
+
+	SUBCASE("Expires when inputs are written") {
+		cache->set_duration(0.0);
+		TypedArray<StringName> inputs;
+		inputs.push_back("target");
+		cache->set_input_vars(inputs);
+		bb->set_var("target", 1);
+		cache->initialize(dummy, bb, dummy);
+		CHECK(cache->execute(0.01666) == BTTask::SUCCESS);
+		CHECK(cache->execute(0.01666) == BTTask::SUCCESS);
+		CHECK_ENTRIES_TICKS_EXITS(task, 1, 1, 1);
+
+		bb->set_var("other", 2);
+		CHECK(cache->execute(0.01666) == BTTask::SUCCESS);
+		CHECK_ENTRIES_TICKS_EXITS(task, 1, 1, 1);
+
+		bb->set_var("target", 2);
+		CHECK(cache->execute(0.01666) == BTTask::SUCCESS);
+		CHECK_ENTRIES_TICKS_EXITS(task, 2, 2, 2);
+	}
+
+	SUBCASE("RUNNING is not cached") {
+		task->ret_status = BTTask::RUNNING;
+		cache->initialize(dummy, bb, dummy);
+		CHECK(cache->execute(0.01666) == BTTask::RUNNING);
+		CHECK_FALSE(cache->has_cached_result());
+		task->ret_status = BTTask::FAILURE;
+		CHECK(cache->execute(0.01666) == BTTask::FAILURE);
+		CHECK_ENTRIES_TICKS_EXITS(task, 1, 2, 1);
+		CHECK(cache->execute(0.01666) == BTTask::FAILURE);
+		CHECK_ENTRIES_TICKS_EXITS(task, 1, 2, 1);
+	}
+
+	memdelete(dummy);
+}
+
+} //namespace TestCache
+
+#endif // TEST_CACHE_H
@@ -65,6 +65,29 @@ TEST_CASE("[Modules][LimboAI] BTCallMethod") {
 			CHECK(cm->execute(0.01666) == BTTask::SUCCESS);
 			CHECK(callback_counter->num_callbacks == 1);
 		}
+		SUBCASE("When ticking on worker threads") {
+			// * Objects on the blackboard can be called from a worker thread, node paths must be resolved on the main thread.
+			CHECK(cm->can_tick_on_worker_thread());
+			cm->set_result_var("result");
+			CHECK_FALSE(cm->can_tick_on_worker_thread());
+			cm->set_result_var(StringName());
+			bb->set_var("object", NodePath("."));
+			CHECK_FALSE(cm->can_tick_on_worker_thread());
+			node_param->set_value_source(BBParam::SAVED_VALUE);
+			node_param->set_saved_value(NodePath("."));
+			CHECK_FALSE(cm->can_tick_on_worker_thread());
+		}
+		SUBCASE("When target object changes") {
+			CHECK(cm->execute(0.01666) == BTTask::SUCCESS);
+			CHECK(cm->execute(0.01666) == BTTask::SUCCESS);
+			CHECK(callback_counter->num_callbacks == 2);
+
+			Ref<CallbackCounter> other_counter = memnew(CallbackCounter);
+			bb->set_var("object", other_counter);
+			CHECK(cm->execute(0.01666) == BTTask::SUCCESS);
+			CHECK(callback_counter->num_callbacks == 2);
+			CHECK(other_counter->num_callbacks == 1);
+		}
 		SUBCASE("With arguments") {
 			cm->set_method("callback_delta");
 
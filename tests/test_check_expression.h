@@ -0,0 +1,122 @@
+/**
+ * test_check_expression.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef TEST_CHECK_EXPRESSION_H
+#define TEST_CHECK_EXPRESSION_H
+
+#include "limbo_test.h"
+
+#include "modules/limboai/bt/tasks/blackboard/bt_check_expression.h"
+#include "modules/limboai/bt/tasks/bt_task.h"
+#include "modules/limboai/util/limbo_expression.h"
+
+namespace TestCheckExpression {
+
+TEST_CASE("[Modules][LimboAI] LimboExpression") {
+	LimboExpression expr;
+	Ref<Blackboard> bb = memnew(Blackboard);
+	LimboExpression::Value result;
+
+	SUBCASE("Test arithmetic and precedence") {
+		REQUIRE(expr.parse("1 + 2 * 3 - -4") == OK);
+		REQUIRE(expr.evaluate(bb, nullptr, result));
+		CHECK(result.type == LimboExpression::Value::INT);
+		CHECK(result.i == 11);
+
+		REQUIRE(expr.parse("(1 + 2) * 0.5") == OK);
+		REQUIRE(expr.evaluate(bb, nullptr, result));
+		CHECK(result.type == LimboExpression::Value::FLOAT);
+		CHECK(result.f == doctest::Approx(1.5));
+
+		REQUIRE(expr.parse("7 / 2 + 7 % 4") == OK);
+		REQUIRE(expr.evaluate(bb, nullptr, result));
+		CHECK(result.i == 6);
+	}
+	SUBCASE("Test logic") {
+		bool b = false;
+		REQUIRE(expr.parse("1 < 2 and not (3 >= 4) && true") == OK);
+		REQUIRE(expr.evaluate_bool(bb, nullptr, b));
+		CHECK(b);
+		REQUIRE(expr.parse("false or 2 == 3 || !true") == OK);
+		REQUIRE(expr.evaluate_bool(bb, nullptr, b));
+		CHECK_FALSE(b);
+	}
+	SUBCASE("Test blackboard variables") {
+		bb->set_var("health", 25);
+		bb->set_var("max_health", 100.0);
+		REQUIRE(expr.parse("health / max_health < 0.3") == OK);
+		bool b = false;
+		REQUIRE(expr.evaluate_bool(bb, nullptr, b));
+		CHECK(b);
+		bb->set_var("health", 50);
+		REQUIRE(expr.evaluate_bool(bb, nullptr, b));
+		CHECK_FALSE(b);
+
+		bb->set_var("health", "not a number");
+		CHECK_FALSE(expr.evaluate_bool(bb, nullptr, b));
+		bb->erase_var("health");
+		CHECK_FALSE(expr.evaluate_bool(bb, nullptr, b));
+	}
+	SUBCASE("Test agent properties") {
+		Node *agent = memnew(Node);
+		agent->set_process_priority(5);
+		REQUIRE(expr.parse("agent.process_priority * 2") == OK);
+		REQUIRE(expr.evaluate(bb, agent, result));
+		CHECK(result.i == 10);
+		CHECK_FALSE(expr.evaluate(bb, nullptr, result));
+		memdelete(agent);
+	}
+	SUBCASE("Test errors") {
+		CHECK(expr.parse("") == ERR_PARSE_ERROR);
+		CHECK_FALSE(expr.is_valid());
+		CHECK(expr.parse("1 +") == ERR_PARSE_ERROR);
+		CHECK(expr.parse("(1 + 2") == ERR_PARSE_ERROR);
+		CHECK(expr.parse("1 2") == ERR_PARSE_ERROR);
+		CHECK(expr.parse("a $ b") == ERR_PARSE_ERROR);
+		CHECK_FALSE(expr.get_error_text().is_empty());
+
+		REQUIRE(expr.parse("1 / 0") == OK);
+		CHECK_FALSE(expr.evaluate(bb, nullptr, result));
+	}
+}
+
+TEST_CASE("[Modules][LimboAI] BTCheckExpression") {
+	Ref<BTCheckExpression> ce = memnew(BTCheckExpression);
+	Ref<Blackboard> bb = memnew(Blackboard);
+	Node *dummy = memnew(Node);
+	ce->initialize(dummy, bb, dummy);
+
+	SUBCASE("When expression is empty") {
+		ERR_PRINT_OFF;
+		CHECK(ce->execute(0.01666) == BTTask::FAILURE);
+		ERR_PRINT_ON;
+	}
+	SUBCASE("When expression is valid") {
+		ce->set_expression_string("ammo > 0 and cooldown <= 0.0");
+		bb->set_var("ammo", 3);
+		bb->set_var("cooldown", 0.0);
+		CHECK(ce->execute(0.01666) == BTTask::SUCCESS);
+		bb->set_var("cooldown", 0.5);
+		CHECK(ce->execute(0.01666) == BTTask::FAILURE);
+	}
+	SUBCASE("When variable is missing") {
+		ce->set_expression_string("missing == 1");
+		ERR_PRINT_OFF;
+		CHECK(ce->execute(0.01666) == BTTask::FAILURE);
+		ERR_PRINT_ON;
+	}
+
+	memdelete(dummy);
+}
+
+} //namespace TestCheckExpression
+
+#endif // TEST_CHECK_EXPRESSION_H
@@ -60,6 +60,42 @@ TEST_CASE("[Modules][LimboAI] BTCheckTrigger") {
 	memdelete(dummy);
 }
 
+TEST_CASE("[Modules][LimboAI] BTCheckTrigger with declared triggers") {
+	Ref<BTCheckTrigger> ct = memnew(BTCheckTrigger);
+	Node *dummy = memnew(Node);
+	Ref<Blackboard> parent = memnew(Blackboard);
+	parent->add_trigger("alarm");
+	Ref<Blackboard> bb = memnew(Blackboard);
+	bb->set_parent(parent);
+	CHECK(bb->has_trigger("alarm"));
+	CHECK_FALSE(bb->has_var("alarm"));
+
+	ct->set_variable("alarm");
+	ct->initialize(dummy, bb, dummy);
+
+	CHECK(ct->execute(0.01666) == BTTask::FAILURE);
+	bb->fire_trigger("alarm");
+	CHECK(parent->is_trigger_set("alarm"));
+	CHECK(ct->execute(0.01666) == BTTask::SUCCESS);
+	CHECK_FALSE(parent->is_trigger_set("alarm"));
+	CHECK(ct->execute(0.01666) == BTTask::FAILURE);
+
+	SUBCASE("Consuming clears the trigger once") {
+		parent->fire_trigger("alarm");
+		parent->fire_trigger("alarm");
+		CHECK(bb->consume_trigger("alarm"));
+		CHECK_FALSE(bb->consume_trigger("alarm"));
+	}
+	SUBCASE("Undeclared triggers") {
+		ERR_PRINT_OFF;
+		bb->fire_trigger("unknown");
+		CHECK_FALSE(bb->consume_trigger("unknown"));
+		ERR_PRINT_ON;
+	}
+
+	memdelete(dummy);
+}
+
 } //namespace TestCheckTrigger
 
 #endif // TEST_CHECK_TRIGGER_H
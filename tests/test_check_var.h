@@ -16,6 +16,7 @@
 #include "modules/limboai/blackboard/bb_param/bb_param.h"
 #include "modules/limboai/bt/tasks/blackboard/bt_check_var.h"
 #include "modules/limboai/bt/tasks/bt_task.h"
+#include "modules/limboai/util/limbo_error_reporter.h"
 #include "modules/limboai/util/limbo_utility.h"
 #include "tests/test_macros.h"
 
@@ -91,6 +92,16 @@ TEST_CASE("[Modules][LimboAI] BTCheckVar") {
 			TC_CHECK_VALUES(cv, 3.0, 4.0, "3.0", LimboUtility::CHECK_LESS_THAN, 3.14);
 			TC_CHECK_VALUES(cv, 3.0, 3.14, "3.0", LimboUtility::CHECK_NOT_EQUAL, 3.14);
 		}
+		SUBCASE("With Vector2") {
+			value->set_type(Variant::VECTOR2);
+			TC_CHECK_VALUES(cv, Vector2(1, 2), Vector2(2, 1), 1, LimboUtility::CHECK_EQUAL, Vector2(1, 2));
+			TC_CHECK_VALUES(cv, Vector2(1, 3), Vector2(1, 1), 1, LimboUtility::CHECK_GREATER_THAN, Vector2(1, 2));
+		}
+		SUBCASE("With value type not matching the variable") {
+			value->set_type(Variant::FLOAT);
+			TC_CHECK_VALUES(cv, 3, 2, "3", LimboUtility::CHECK_EQUAL, 3.0);
+			TC_CHECK_VALUES(cv, 4, 3, "4", LimboUtility::CHECK_GREATER_THAN, 3.5);
+		}
 		SUBCASE("With string") {
 			TC_CHECK_VALUES(cv, "AAA", "AAC", 123, LimboUtility::CHECK_EQUAL, "AAA");
 			TC_CHECK_VALUES(cv, "AAC", "AAA", 123, LimboUtility::CHECK_GREATER_THAN_OR_EQUAL, "AAB");
@@ -104,6 +115,30 @@ TEST_CASE("[Modules][LimboAI] BTCheckVar") {
 	memdelete(dummy);
 }
 
+TEST_CASE("[Modules][LimboAI] BTCheckVar errors are reported once for all clones") {
+	Ref<BTCheckVar> cv = memnew(BTCheckVar);
+	cv->set_variable("not_found");
+	cv->set_value(memnew(BBVariant));
+	Node *dummy = memnew(Node);
+	Ref<BTTask> clone1 = cv->clone();
+	Ref<BTTask> clone2 = cv->clone();
+	clone1->initialize(dummy, memnew(Blackboard), dummy);
+	clone2->initialize(dummy, memnew(Blackboard), dummy);
+
+	LimboErrorReporter::clear();
+	const uint64_t errors = LimboErrorReporter::get_error_count();
+	const uint64_t suppressed = LimboErrorReporter::get_suppressed_count();
+	ERR_PRINT_OFF;
+	CHECK(clone1->execute(0.01666) == BTTask::FAILURE);
+	CHECK(clone2->execute(0.01666) == BTTask::FAILURE);
+	CHECK(clone1->execute(0.01666) == BTTask::FAILURE);
+	ERR_PRINT_ON;
+	CHECK(LimboErrorReporter::get_error_count() - errors == 3);
+	CHECK(LimboErrorReporter::get_suppressed_count() - suppressed == 2);
+
+	memdelete(dummy);
+}
+
 } //namespace TestCheckVar
 
 #endif // TEST_CHECK_VAR_H
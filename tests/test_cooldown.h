@@ -0,0 +1,118 @@
+/**
+ * test_cooldown.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef TEST_COOLDOWN_H
+#define TEST_COOLDOWN_H
+
+#include "limbo_test.h"
+
+#include "modules/limboai/bt/behavior_tree.h"
+#include "modules/limboai/bt/tasks/bt_task.h"
+#include "modules/limboai/bt/tasks/decorators/bt_cooldown.h"
+#include "modules/limboai/util/limbo_timer_wheel.h"
+
+namespace TestCooldown {
+
+TEST_CASE("[Modules][LimboAI] BTCooldown") {
+	Ref<BTCooldown> cd = memnew(BTCooldown);
+	Ref<BTTestAction> task = memnew(BTTestAction(BTTask::SUCCESS));
+	cd->add_child(task);
+	cd->set_duration(1.0);
+
+	Ref<Blackboard> bb = memnew(Blackboard);
+	Node *dummy = memnew(Node);
+
+	SUBCASE("Without state variable") {
+		cd->initialize(dummy, bb, dummy);
+		CHECK(cd->execute(0.01666) == BTTask::SUCCESS);
+		CHECK_ENTRIES_TICKS_EXITS(task, 1, 1, 1);
+		CHECK(cd->execute(0.01666) == BTTask::FAILURE); // * cooling down
+		CHECK_ENTRIES_TICKS_EXITS(task, 1, 1, 1);
+		CHECK(bb->list_vars().is_empty()); // * no synthesized variables
+
+		LimboTimerWheel::process(0.5, false);
+		CHECK(cd->execute(0.01666) == BTTask::FAILURE);
+		LimboTimerWheel::process(0.5, true); // * paused
+		CHECK(cd->execute(0.01666) == BTTask::FAILURE);
+		LimboTimerWheel::process(0.5, false);
+		CHECK(cd->execute(0.01666) == BTTask::SUCCESS);
+		CHECK_ENTRIES_TICKS_EXITS(task, 2, 2, 2);
+	}
+
+	SUBCASE("With state variable") {
+		cd->set_cooldown_state_var("cooling");
+		cd->set_process_pause(true);
+		cd->initialize(dummy, bb, dummy);
+		CHECK(bb->get_var("cooling", Variant()) == Variant(false));
+
+		CHECK(cd->execute(0.01666) == BTTask::SUCCESS);
+		CHECK(bb->get_var("cooling", Variant()) == Variant(true));
+		CHECK(cd->execute(0.01666) == BTTask::FAILURE);
+
+		LimboTimerWheel::process(0.5, true); // * processed while paused
+		CHECK(bb->get_var("cooling", Variant()) == Variant(true));
+		LimboTimerWheel::process(0.6, true);
+		CHECK(bb->get_var("cooling", Variant()) == Variant(false));
+		CHECK(cd->execute(0.01666) == BTTask::SUCCESS);
+	}
+
+	SUBCASE("With instance clock") {
+		ClassDB::register_class<BTTestAction>();
+		cd->set_use_instance_clock(true);
+		Ref<BehaviorTree> bt = memnew(BehaviorTree);
+		bt->set_root_task(cd);
+		Ref<BTInstance> inst = bt->instantiate(dummy, bb, dummy, dummy);
+		REQUIRE(inst.is_valid());
+
+		CHECK(inst->update(0.25) == BTTask::SUCCESS);
+		CHECK(inst->update(0.25) == BTTask::FAILURE); // * cooling down until 1.25
+		LimboTimerWheel::process(2.0, false); // * global time doesn't matter
+		CHECK(inst->update(0.25) == BTTask::FAILURE);
+		inst->set_time_scale(0.5);
+		CHECK(inst->update(0.25) == BTTask::FAILURE);
+		CHECK(inst->get_clock_time() == 0.875);
+		inst->advance_clock(0.5);
+		CHECK(inst->update(0.25) == BTTask::SUCCESS);
+	}
+
+	memdelete(dummy);
+}
+
+TEST_CASE("[Modules][LimboAI] LimboTimerWheel") {
+	LimboTimerWheel *wheel = LimboTimerWheel::get(false);
+	Ref<RefCounted> owner = memnew(RefCounted);
+	static int num_fired;
+	num_fired = 0;
+	LimboTimerWheel::TimeoutFunc func = [](Object *p_owner, uint32_t p_timer_id) { num_fired += 1; };
+	uint32_t prev_count = wheel->get_timer_count();
+
+	// * Spanning several levels of the wheel.
+	wheel->schedule(0.5, owner.ptr(), func);
+	wheel->schedule(30.0, owner.ptr(), func);
+	wheel->schedule(5000.0, owner.ptr(), func);
+	CHECK(wheel->get_timer_count() == prev_count + 3);
+
+	LimboTimerWheel::process(0.4, false);
+	CHECK(num_fired == 0);
+	LimboTimerWheel::process(0.2, false);
+	CHECK(num_fired == 1);
+	LimboTimerWheel::process(29.0, false);
+	CHECK(num_fired == 1);
+	LimboTimerWheel::process(1.0, false);
+	CHECK(num_fired == 2);
+	LimboTimerWheel::process(5000.0, false);
+	CHECK(num_fired == 3);
+	CHECK(wheel->get_timer_count() == prev_count);
+}
+
+} //namespace TestCooldown
+
+#endif // TEST_COOLDOWN_H
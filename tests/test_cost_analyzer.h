@@ -0,0 +1,111 @@
+/**
+ * test_cost_analyzer.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef TEST_COST_ANALYZER_H
+#define TEST_COST_ANALYZER_H
+
+#include "limbo_test.h"
+
+#include "modules/limboai/bt/behavior_tree.h"
+#include "modules/limboai/bt/bt_cost_analyzer.h"
+#include "modules/limboai/bt/tasks/bt_comment.h"
+#include "modules/limboai/bt/tasks/composites/bt_dynamic_selector.h"
+#include "modules/limboai/bt/tasks/composites/bt_parallel.h"
+#include "modules/limboai/bt/tasks/composites/bt_selector.h"
+#include "modules/limboai/bt/tasks/composites/bt_sequence.h"
+#include "modules/limboai/bt/tasks/decorators/bt_repeat.h"
+#include "modules/limboai/bt/tasks/decorators/bt_subtree.h"
+#include "modules/limboai/bt/tasks/utility/bt_call_method.h"
+#include "modules/limboai/bt/tasks/utility/bt_evaluate_expression.h"
+
+namespace TestCostAnalyzer {
+
+TEST_CASE("[Modules][LimboAI] BTCostAnalyzer estimates the cost of a tick") {
+	ClassDB::register_class<BTTestAction>();
+
+	Ref<BTSequence> seq = memnew(BTSequence);
+	seq->add_child(memnew(BTTestAction(BTTask::SUCCESS)));
+	seq->add_child(memnew(BTComment));
+	Ref<BTCallMethod> call = memnew(BTCallMethod);
+	seq->add_child(call);
+	CHECK(BTCostAnalyzer::estimate_tick_cost(seq.ptr()) == doctest::Approx(1.0 + 1.0 + 4.0));
+
+	SUBCASE("Repeating decorators count each iteration of a tick") {
+		Ref<BTRepeat> repeat = memnew(BTRepeat);
+		repeat->set_max_iterations_per_tick(3);
+		repeat->add_child(seq);
+		CHECK(BTCostAnalyzer::estimate_tick_cost(repeat.ptr()) == doctest::Approx(1.0 + 3 * 6.0));
+	}
+
+	SUBCASE("Subtrees are included") {
+		Ref<BehaviorTree> sub_bt = memnew(BehaviorTree);
+		sub_bt->set_root_task(seq);
+		Ref<BTSubtree> subtree = memnew(BTSubtree);
+		subtree->set_subtree(sub_bt);
+		CHECK(BTCostAnalyzer::estimate_tick_cost(subtree.ptr()) == doctest::Approx(1.0 + 6.0));
+	}
+}
+
+TEST_CASE("[Modules][LimboAI] BTCostAnalyzer warnings") {
+	ClassDB::register_class<BTTestAction>();
+
+	SUBCASE("BTEvaluateExpression under a dynamic composite") {
+		Ref<BTEvaluateExpression> expr = memnew(BTEvaluateExpression);
+		Ref<BTSequence> seq = memnew(BTSequence);
+		seq->add_child(expr);
+		CHECK(BTCostAnalyzer::get_task_warnings(expr.ptr()).is_empty());
+
+		Ref<BTDynamicSelector> dyn = memnew(BTDynamicSelector);
+		dyn->add_child(seq);
+		CHECK(BTCostAnalyzer::get_task_warnings(expr.ptr()).size() == 1);
+	}
+
+	SUBCASE("BTCallMethod under a repeating BTParallel") {
+		Ref<BTCallMethod> call = memnew(BTCallMethod);
+		Ref<BTParallel> parallel = memnew(BTParallel);
+		parallel->add_child(call);
+		CHECK(BTCostAnalyzer::get_task_warnings(call.ptr()).is_empty());
+		parallel->set_repeat(true);
+		CHECK(BTCostAnalyzer::get_task_warnings(call.ptr()).size() == 1);
+	}
+
+	SUBCASE("Subtree including itself") {
+		Ref<BehaviorTree> bt = memnew(BehaviorTree);
+		Ref<BTSelector> sel = memnew(BTSelector);
+		Ref<BTSubtree> subtree = memnew(BTSubtree);
+		sel->add_child(subtree);
+		bt->set_root_task(sel);
+		subtree->set_subtree(bt);
+
+		CHECK(BTCostAnalyzer::get_task_warnings(subtree.ptr()).size() == 1);
+		Dictionary report = BTCostAnalyzer::analyze(bt.ptr());
+		PackedStringArray warnings = report["warnings"];
+		REQUIRE(warnings.size() == 1);
+		CHECK(warnings[0].begins_with(sel->get_task_name() + "/" + subtree->get_task_name() + ": "));
+		CHECK(double(report["estimated_cost"]) == doctest::Approx(1.0 + 1.0 + 1.0 + 1.0));
+
+		// * Breaks the reference cycle.
+		subtree->set_subtree(Ref<BehaviorTree>());
+	}
+
+	SUBCASE("Expensive trees") {
+		Ref<BTSequence> seq = memnew(BTSequence);
+		for (int i = 0; i < 30; i++) {
+			seq->add_child(memnew(BTCallMethod));
+		}
+		CHECK(BTCostAnalyzer::get_task_warnings(seq.ptr()).size() == 1);
+		CHECK(BTCostAnalyzer::get_task_warnings(seq->get_child(0).ptr()).is_empty());
+	}
+}
+
+} //namespace TestCostAnalyzer
+
+#endif // TEST_COST_ANALYZER_H
@@ -0,0 +1,159 @@
+/**
+ * test_crowd.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef TEST_CROWD_H
+#define TEST_CROWD_H
+
+#include "limbo_test.h"
+
+#include "modules/limboai/blackboard/bb_param/bb_variant.h"
+#include "modules/limboai/bt/behavior_tree.h"
+#include "modules/limboai/bt/bt_crowd.h"
+#include "modules/limboai/bt/tasks/blackboard/bt_check_var.h"
+#include "modules/limboai/bt/tasks/blackboard/bt_set_var.h"
+#include "modules/limboai/bt/tasks/composites/bt_selector.h"
+#include "modules/limboai/bt/tasks/composites/bt_sequence.h"
+#include "modules/limboai/bt/tasks/utility/bt_wait.h"
+
+namespace TestCrowd {
+
+TEST_CASE("[Modules][LimboAI] BTCrowd") {
+	ClassDB::register_class<BTTestAction>();
+
+	// * Agents with "go" set run the action, the others fall back to the selector's second branch.
+	Ref<BehaviorTree> bt = memnew(BehaviorTree);
+	Ref<BTSelector> sel = memnew(BTSelector);
+	Ref<BTSequence> seq = memnew(BTSequence);
+	Ref<BTCheckVar> check = memnew(BTCheckVar);
+	check->set_variable("go");
+	Ref<BBVariant> value = memnew(BBVariant);
+	value->set_saved_value(true);
+	check->set_value(value);
+	seq->add_child(check);
+	seq->add_child(memnew(BTTestAction(BTTask::RUNNING)));
+	sel->add_child(seq);
+	sel->add_child(memnew(BTTestAction(BTTask::FAILURE)));
+	bt->set_root_task(sel);
+
+	BTCrowd *crowd = memnew(BTCrowd);
+	crowd->set_update_mode(BTCrowd::MANUAL);
+	crowd->set_behavior_tree(bt);
+
+	LocalVector<Node *> agents;
+	for (int i = 0; i < 4; i++) {
+		Node *agent = memnew(Node);
+		Ref<Blackboard> bb = memnew(Blackboard);
+		bb->set_var("go", i % 2 == 0);
+		CHECK(crowd->add_agent(agent, bb) == i);
+		agents.push_back(agent);
+	}
+	REQUIRE(crowd->get_agent_count() == 4);
+
+	crowd->update(0.5);
+	crowd->update(0.5);
+	for (int i = 0; i < 4; i++) {
+		CHECK(crowd->get_agent_status(i) == (i % 2 == 0 ? BTTask::RUNNING : BTTask::FAILURE));
+		Ref<BTTask> root = crowd->get_agent_instance(i)->get_root_task();
+		Ref<BTTestAction> running = root->get_child(0)->get_child(1);
+		Ref<BTTestAction> fallback = root->get_child(1);
+		CHECK(running->num_ticks == (i % 2 == 0 ? 2 : 0));
+		CHECK(fallback->num_ticks == (i % 2 == 0 ? 0 : 2));
+	}
+	CHECK(crowd->get_agent_elapsed_time(0) == doctest::Approx(0.5));
+
+	SUBCASE("Removal keeps the columns dense") {
+		crowd->remove_agent(agents[0]);
+		CHECK(crowd->get_agent_count() == 3);
+		CHECK_FALSE(crowd->has_agent(agents[0]));
+		CHECK(crowd->get_agent(0) == agents[3]);
+		CHECK(crowd->get_agent_status(0) == BTTask::FAILURE);
+
+		crowd->get_agent_blackboard(0)->set_var("go", true);
+		crowd->update(0.5);
+		CHECK(crowd->get_agent_status(0) == BTTask::RUNNING);
+		CHECK(crowd->get_agent_status(1) == BTTask::FAILURE);
+		CHECK(crowd->get_agent_status(2) == BTTask::RUNNING);
+	}
+
+	SUBCASE("Freed agents are removed before the next update") {
+		memdelete(agents[0]);
+		agents[0] = memnew(Node);
+		crowd->update(0.5);
+		CHECK(crowd->get_agent_count() == 3);
+		for (int i = 0; i < crowd->get_agent_count(); i++) {
+			CHECK(crowd->get_agent(i) != nullptr);
+		}
+	}
+
+	SUBCASE("Agents can't be added twice") {
+		ERR_PRINT_OFF;
+		CHECK(crowd->add_agent(agents[1]) == -1);
+		ERR_PRINT_ON;
+		CHECK(crowd->get_agent_count() == 4);
+	}
+
+	crowd->clear_agents();
+	CHECK(crowd->get_agent_count() == 0);
+	memdelete(crowd);
+	for (Node *agent : agents) {
+		memdelete(agent);
+	}
+}
+
+TEST_CASE("[Modules][LimboAI] BTCrowd batched leaves") {
+	// * Sequence of leaves with batched ticks: set "done" after waiting for one second.
+	Ref<BehaviorTree> bt = memnew(BehaviorTree);
+	Ref<BTSequence> seq = memnew(BTSequence);
+	Ref<BTWait> wait = memnew(BTWait);
+	wait->set_duration(1.0);
+	Ref<BTSetVar> set_var = memnew(BTSetVar);
+	set_var->set_variable("done");
+	Ref<BBVariant> value = memnew(BBVariant);
+	value->set_saved_value(true);
+	set_var->set_value(value);
+	seq->add_child(wait);
+	seq->add_child(set_var);
+	bt->set_root_task(seq);
+
+	BTCrowd *crowd = memnew(BTCrowd);
+	crowd->set_update_mode(BTCrowd::MANUAL);
+	crowd->set_behavior_tree(bt);
+	LocalVector<Node *> agents;
+	for (int i = 0; i < 3; i++) {
+		Node *agent = memnew(Node);
+		Ref<Blackboard> bb = memnew(Blackboard);
+		bb->set_var("done", false);
+		crowd->add_agent(agent, bb);
+		agents.push_back(agent);
+	}
+
+	crowd->update(0.6);
+	crowd->update(0.6);
+	for (int i = 0; i < 3; i++) {
+		CHECK(crowd->get_agent_status(i) == BTTask::RUNNING);
+		CHECK(crowd->get_agent_blackboard(i)->get_var("done", Variant()) == Variant(false));
+	}
+	crowd->update(0.6);
+	for (int i = 0; i < 3; i++) {
+		CHECK(crowd->get_agent_status(i) == BTTask::SUCCESS);
+		CHECK(crowd->get_agent_blackboard(i)->get_var("done", Variant()) == Variant(true));
+	}
+
+	crowd->clear_agents();
+	memdelete(crowd);
+	for (Node *agent : agents) {
+		memdelete(agent);
+	}
+}
+
+} //namespace TestCrowd
+
+#endif // TEST_CROWD_H
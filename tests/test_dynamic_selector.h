@@ -116,6 +116,50 @@ TEST_CASE("[Modules][LimboAI] BTDynamicSelector") {
 	}
 }
 
+TEST_CASE("[Modules][LimboAI] BTDynamicSelector reevaluation interval") {
+	Ref<BTDynamicSelector> sel = memnew(BTDynamicSelector);
+	Ref<BTTestAction> task1 = memnew(BTTestAction(BTTask::FAILURE));
+	Ref<BTTestAction> task2 = memnew(BTTestAction(BTTask::RUNNING));
+	sel->add_child(task1);
+	sel->add_child(task2);
+
+	Node *dummy = memnew(Node);
+	Ref<Blackboard> bb = memnew(Blackboard);
+	bb->set_var("alert", false);
+	sel->initialize(dummy, bb, dummy);
+
+	SUBCASE("Preceding tasks are skipped until the interval elapses") {
+		sel->set_reevaluation_interval(0.5);
+		CHECK(sel->execute(0.125) == BTTask::RUNNING);
+		CHECK_ENTRIES_TICKS_EXITS(task1, 1, 1, 1);
+		CHECK_ENTRIES_TICKS_EXITS(task2, 1, 1, 0);
+
+		CHECK(sel->execute(0.125) == BTTask::RUNNING);
+		CHECK_ENTRIES_TICKS_EXITS(task1, 1, 1, 1); // * skipped
+		CHECK_ENTRIES_TICKS_EXITS(task2, 1, 2, 0);
+
+		task1->ret_status = BTTask::SUCCESS;
+		CHECK(sel->execute(0.125) == BTTask::RUNNING); // * elapsed: 0.375
+		CHECK(sel->execute(0.125) == BTTask::SUCCESS); // * elapsed: 0.5 - reevaluated
+		CHECK_ENTRIES_TICKS_EXITS(task1, 2, 2, 2);
+		CHECK_STATUS_ENTRIES_TICKS_EXITS(task2, BTTask::FRESH, 1, 3, 1); // * aborted
+	}
+
+	SUBCASE("Preceding tasks are reevaluated when the blackboard changes") {
+		sel->set_reevaluate_on_change(true);
+		CHECK(sel->execute(0.1) == BTTask::RUNNING);
+		CHECK(sel->execute(0.1) == BTTask::RUNNING);
+		CHECK_ENTRIES_TICKS_EXITS(task1, 1, 1, 1); // * skipped
+
+		bb->set_var("alert", true);
+		CHECK(sel->execute(0.1) == BTTask::RUNNING);
+		CHECK_ENTRIES_TICKS_EXITS(task1, 2, 2, 2);
+		CHECK_ENTRIES_TICKS_EXITS(task2, 1, 3, 0);
+	}
+
+	memdelete(dummy);
+}
+
 } //namespace TestDynamicSelector
 
 #endif // TEST_DYNAMIC_SELECTOR_H
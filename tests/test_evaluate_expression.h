@@ -152,6 +152,33 @@ TEST_CASE("[Modules][LimboAI] BTEvaluateExpression") {
 			}
 		}
 
+		SUBCASE("With evaluate_on_input_change") {
+			ee->set_expression_string("callback_delta(x)");
+			ee->set_evaluate_on_input_change(true);
+			PackedStringArray input_names;
+			input_names.push_back("x");
+			ee->set_input_names(input_names);
+			CHECK(ee->parse() == OK);
+			Ref<BBVariant> x_param = memnew(BBVariant);
+			x_param->set_value_source(BBParam::BLACKBOARD_VAR);
+			x_param->set_variable("x");
+			TypedArray<BBVariant> input_values;
+			input_values.push_back(x_param);
+			ee->set_input_values(input_values);
+			bb->set_var("x", 0.5);
+
+			CHECK(ee->execute(0.01666) == BTTask::SUCCESS);
+			CHECK(ee->execute(0.01666) == BTTask::SUCCESS);
+			CHECK(callback_counter->num_callbacks == 1); // * Input didn't change.
+			bb->set_var("x", 1.0);
+			CHECK(ee->execute(0.01666) == BTTask::SUCCESS);
+			CHECK(callback_counter->num_callbacks == 2);
+
+			ee->set_evaluate_on_input_change(false);
+			CHECK(ee->execute(0.01666) == BTTask::SUCCESS);
+			CHECK(callback_counter->num_callbacks == 3);
+		}
+
 		SUBCASE("Should fail with too many method arguments") {
 			ee->set_expression_string("callback_delta(delta, extra)");
 			ee->set_input_include_delta(true);
@@ -0,0 +1,106 @@
+/**
+ * test_event_selector.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef TEST_EVENT_SELECTOR_H
+#define TEST_EVENT_SELECTOR_H
+
+#include "limbo_test.h"
+
+#include "modules/limboai/bt/behavior_tree.h"
+#include "modules/limboai/bt/tasks/composites/bt_event_selector.h"
+
+namespace TestEventSelector {
+
+TEST_CASE("[Modules][LimboAI] BTEventSelector") {
+	ClassDB::register_class<BTTestAction>();
+
+	Ref<BehaviorTree> bt = memnew(BehaviorTree);
+	Ref<BTEventSelector> sel = memnew(BTEventSelector);
+	sel->add_child(memnew(BTTestAction(BTTask::RUNNING)));
+	sel->add_child(memnew(BTTestAction(BTTask::SUCCESS)));
+	sel->add_child(memnew(BTTestAction(BTTask::RUNNING)));
+	TypedArray<StringName> events;
+	events.push_back("hit");
+	events.push_back("heal");
+	events.push_back(StringName());
+	sel->set_events(events);
+	sel->set_cargo_var("cargo");
+	bt->set_root_task(sel);
+
+	Ref<Blackboard> bb = memnew(Blackboard);
+	Ref<BTInstance> inst = bt->instantiate_headless(bb);
+	REQUIRE(inst.is_valid());
+	Ref<BTTask> root = inst->get_root_task();
+	Ref<BTTestAction> hit = root->get_child(0);
+	Ref<BTTestAction> heal = root->get_child(1);
+	Ref<BTTestAction> idle = root->get_child(2);
+
+	// * No events - the default branch runs.
+	inst->update(0.1);
+	CHECK(inst->get_last_status() == BTTask::RUNNING);
+	CHECK(idle->num_ticks == 1);
+
+	SUBCASE("Events interrupt the running branch") {
+		CHECK(inst->post_event("hit", 5));
+		CHECK(inst->get_posted_event_count() == 1);
+		inst->update(0.1);
+		CHECK(inst->get_posted_event_count() == 0);
+		CHECK(idle->num_exits == 1);
+		CHECK(hit->get_status() == BTTask::RUNNING);
+		CHECK(bb->get_var("cargo", Variant()) == Variant(5));
+
+		// * A repeated event doesn't restart the branch.
+		inst->post_event("hit");
+		inst->update(0.1);
+		CHECK(hit->num_entries == 1);
+		CHECK(hit->num_ticks == 2);
+
+		// * Events are consumed once.
+		inst->update(0.1);
+		CHECK(hit->num_ticks == 3);
+	}
+
+	SUBCASE("The first keyed child wins") {
+		inst->post_event("heal");
+		inst->post_event("hit");
+		inst->update(0.1);
+		CHECK(hit->get_status() == BTTask::RUNNING);
+		CHECK(heal->num_ticks == 0);
+	}
+
+	SUBCASE("Finished branches fall back to the default") {
+		inst->post_event("heal");
+		CHECK(inst->update(0.1) == BTTask::SUCCESS);
+		CHECK(heal->num_ticks == 1);
+		inst->update(0.1);
+		CHECK(idle->get_status() == BTTask::RUNNING);
+	}
+
+	SUBCASE("Unknown events are dropped") {
+		inst->post_event("unknown");
+		inst->update(0.1);
+		CHECK(idle->num_ticks == 2);
+		CHECK(inst->get_posted_event_count() == 0);
+	}
+
+	SUBCASE("Queue is bounded") {
+		inst->set_event_queue_capacity(1);
+		CHECK(inst->post_event("hit"));
+		ERR_PRINT_OFF;
+		CHECK_FALSE(inst->post_event("heal"));
+		ERR_PRINT_ON;
+		CHECK(inst->get_posted_event_count() == 1);
+	}
+}
+
+} //namespace TestEventSelector
+
+#endif // TEST_EVENT_SELECTOR_H
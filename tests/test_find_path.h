@@ -0,0 +1,74 @@
+/**
+ * test_find_path.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef TEST_FIND_PATH_H
+#define TEST_FIND_PATH_H
+
+#include "limbo_test.h"
+
+#include "modules/limboai/bt/tasks/bt_task.h"
+#include "modules/limboai/bt/tasks/scene/bt_find_path.h"
+#include "modules/limboai/util/limbo_path_queries.h"
+
+#include "scene/2d/node_2d.h"
+#include "scene/main/window.h"
+
+namespace TestFindPath {
+
+TEST_CASE("[SceneTree][LimboAI] BTFindPath") {
+	Node *root = SceneTree::get_singleton()->get_root();
+	Node2D *agent = memnew(Node2D);
+	root->add_child(agent);
+
+	Ref<BTFindPath> fp = memnew(BTFindPath);
+	fp->set_target_var("target");
+	fp->set_path_var("path");
+	Ref<Blackboard> bb = memnew(Blackboard);
+	fp->initialize(agent, bb, agent);
+
+	SUBCASE("Waits for the batched query") {
+		bb->set_var("target", Vector2(100, 0));
+		CHECK(fp->execute(0.01666) == BTTask::RUNNING);
+		CHECK(LimboPathQueries::get_pending_count() == 1);
+		CHECK(fp->execute(0.01666) == BTTask::RUNNING);
+		CHECK(LimboPathQueries::get_pending_count() == 1);
+		CHECK_FALSE(bb->has_var("path"));
+	}
+	SUBCASE("Aborting cancels the query") {
+		bb->set_var("target", Vector2(100, 0));
+		CHECK(fp->execute(0.01666) == BTTask::RUNNING);
+		fp->abort();
+		CHECK(LimboPathQueries::get_pending_count() == 0);
+	}
+	SUBCASE("Fails if the target is of the wrong kind") {
+		bb->set_var("target", Vector3(1, 2, 3));
+		ERR_PRINT_OFF;
+		CHECK(fp->execute(0.01666) == BTTask::FAILURE);
+		ERR_PRINT_ON;
+		CHECK(LimboPathQueries::get_pending_count() == 0);
+	}
+	SUBCASE("Fails if the agent is not a Node2D or Node3D") {
+		Node *dummy = memnew(Node);
+		bb->set_var("target", Vector2(100, 0));
+		fp->initialize(dummy, bb, dummy);
+		ERR_PRINT_OFF;
+		CHECK(fp->execute(0.01666) == BTTask::FAILURE);
+		ERR_PRINT_ON;
+		memdelete(dummy);
+	}
+
+	LimboPathQueries::clear();
+	memdelete(agent);
+}
+
+} //namespace TestFindPath
+
+#endif // TEST_FIND_PATH_H
@@ -42,6 +42,27 @@ TEST_CASE("[Modules][LimboAI] BTForEach") {
 	fe->set_array_var("array");
 	fe->set_save_var("element");
 
+	SUBCASE("Ticks on worker threads only if the save variable exists in its scope") {
+		CHECK_FALSE(fe->can_tick_on_worker_thread());
+		blackboard->set_var("element", Variant());
+		CHECK(fe->can_tick_on_worker_thread());
+		Ref<Blackboard> scope = memnew(Blackboard);
+		scope->set_parent(blackboard);
+		fe->initialize(dummy, scope, dummy);
+		CHECK_FALSE(fe->can_tick_on_worker_thread());
+	}
+
+	SUBCASE("With multiple iterations per tick") {
+		fe->set_max_iterations_per_tick(2);
+		CHECK(fe->execute(0.01666) == BTTask::RUNNING);
+		CHECK_ENTRIES_TICKS_EXITS(task, 2, 2, 2);
+		CHECK(blackboard->get_var("element", "wetgoop") == "raspberry");
+
+		CHECK(fe->execute(0.01666) == BTTask::SUCCESS);
+		CHECK_ENTRIES_TICKS_EXITS(task, 3, 3, 3);
+		CHECK(blackboard->get_var("element", "wetgoop") == "mushroom");
+	}
+
 	SUBCASE("When child returns SUCCESS") {
 		CHECK(fe->execute(0.01666) == BTTask::RUNNING);
 		CHECK(task->get_status() == BTTask::SUCCESS);
@@ -112,6 +133,47 @@ TEST_CASE("[Modules][LimboAI] BTForEach") {
 		CHECK_ENTRIES_TICKS_EXITS(task, 1, 1, 1); // Task is not re-executed as there is not enough elements to continue iteration.
 		CHECK(blackboard->get_var("element", "wetgoop") == "apple"); // Not changed.
 	}
+
+	SUBCASE("When iterating over a packed array") {
+		PackedVector3Array waypoints;
+		waypoints.push_back(Vector3(1, 0, 0));
+		waypoints.push_back(Vector3(2, 0, 0));
+		blackboard->set_var("array", waypoints);
+
+		CHECK(fe->execute(0.01666) == BTTask::RUNNING);
+		CHECK(blackboard->get_var("element", Variant()) == Variant(Vector3(1, 0, 0)));
+		CHECK(fe->execute(0.01666) == BTTask::SUCCESS);
+		CHECK(blackboard->get_var("element", Variant()) == Variant(Vector3(2, 0, 0)));
+		CHECK_ENTRIES_TICKS_EXITS(task, 2, 2, 2);
+	}
+
+	SUBCASE("When variable doesn't hold an array") {
+		blackboard->set_var("array", 42);
+		ERR_PRINT_OFF;
+		CHECK(fe->execute(0.01666) == BTTask::FAILURE);
+		ERR_PRINT_ON;
+		CHECK_ENTRIES_TICKS_EXITS(task, 0, 0, 0);
+	}
+
+	SUBCASE("With ITERATE_SNAPSHOT mode") {
+		fe->set_iteration_mode(BTForEach::ITERATE_SNAPSHOT);
+		PackedInt32Array numbers;
+		numbers.push_back(1);
+		numbers.push_back(2);
+		blackboard->set_var("array", numbers);
+
+		CHECK(fe->execute(0.01666) == BTTask::RUNNING);
+		CHECK(blackboard->get_var("element", 0) == Variant(1));
+
+		// Reassigning the variable doesn't affect the ongoing iteration.
+		blackboard->set_var("array", PackedInt32Array());
+		CHECK(fe->execute(0.01666) == BTTask::SUCCESS);
+		CHECK(blackboard->get_var("element", 0) == Variant(2));
+
+		// Next run picks up the new value.
+		CHECK(fe->execute(0.01666) == BTTask::SUCCESS);
+		CHECK_ENTRIES_TICKS_EXITS(task, 2, 2, 2);
+	}
 }
 
 } //namespace TestForEach
@@ -14,8 +14,13 @@
 
 #include "limbo_test.h"
 
+#include "modules/limboai/bt/bt_state.h"
+#include "modules/limboai/bt/tasks/composites/bt_sequence.h"
+#include "modules/limboai/hsm/limbo_event_channel.h"
 #include "modules/limboai/hsm/limbo_hsm.h"
+#include "modules/limboai/hsm/limbo_hsm_resource.h"
 #include "modules/limboai/hsm/limbo_state.h"
+#include "modules/limboai/util/limbo_timer_wheel.h"
 
 #include "core/object/object.h"
 #include "core/object/ref_counted.h"
@@ -38,6 +43,19 @@ public:
 	bool can_enter() { return permitted_to_enter; }
 };
 
+class TestDispatcher : public RefCounted {
+	GDCLASS(TestDispatcher, RefCounted);
+
+public:
+	LimboState *state = nullptr;
+	Vector<StringName> events;
+	void dispatch_events(double p_delta) {
+		for (const StringName &event : events) {
+			state->dispatch(event);
+		}
+	}
+};
+
 TEST_CASE("[Modules][LimboAI] HSM") {
 	Node *agent = memnew(Node);
 	LimboHSM *hsm = memnew(LimboHSM);
@@ -234,6 +252,55 @@ TEST_CASE("[Modules][LimboAI] HSM") {
 			CHECK(beta_entries->num_callbacks == 0);
 		}
 	}
+	SUBCASE("Test native guard") {
+		bool permitted = false;
+		state_beta->set_native_guard([](LimboState *p_state, void *p_userdata) { return *(bool *)p_userdata; }, &permitted);
+		CHECK(state_beta->has_guard());
+		hsm->dispatch("event_one");
+		CHECK(hsm->get_active_state() == state_alpha);
+		permitted = true;
+		hsm->dispatch("event_one");
+		CHECK(hsm->get_active_state() == state_beta);
+	}
+	SUBCASE("Test native listeners") {
+		int updates = 0;
+		state_alpha->set_native_update_listener([](LimboState *p_state, double p_delta, void *p_userdata) { *(int *)p_userdata += 1; }, &updates);
+		hsm->update(0.01666);
+		CHECK(updates == 1);
+		state_alpha->set_native_update_listener(nullptr);
+		hsm->update(0.01666);
+		CHECK(updates == 1);
+
+		LimboState *changed_to = nullptr;
+		hsm->set_native_state_changed_listener([](LimboHSM *p_hsm, LimboState *p_current, LimboState *p_previous, void *p_userdata) { *(LimboState **)p_userdata = p_current; }, &changed_to);
+		hsm->dispatch("event_one");
+		CHECK(hsm->get_active_state() == state_beta);
+		CHECK(changed_to == state_beta);
+		hsm->set_native_state_changed_listener(nullptr);
+	}
+	SUBCASE("Test variable check guard") {
+		state_beta->set_guard_var_check("ammo", LimboUtility::CHECK_GREATER_THAN, 0);
+		hsm->dispatch("event_one");
+		CHECK(hsm->get_active_state() == state_alpha); // * Variable doesn't exist.
+		hsm->get_blackboard()->set_var("ammo", 0);
+		hsm->dispatch("event_one");
+		CHECK(hsm->get_active_state() == state_alpha);
+		hsm->get_blackboard()->set_var("ammo", 5);
+		hsm->dispatch("event_one");
+		CHECK(hsm->get_active_state() == state_beta);
+
+		state_beta->clear_guard();
+		CHECK_FALSE(state_beta->has_guard());
+	}
+	SUBCASE("Test expression guard") {
+		state_beta->set_guard_expression("ammo > 0 and ammo < 10");
+		hsm->get_blackboard()->set_var("ammo", 10);
+		hsm->dispatch("event_one");
+		CHECK(hsm->get_active_state() == state_alpha);
+		hsm->get_blackboard()->set_var("ammo", 5);
+		hsm->dispatch("event_one");
+		CHECK(hsm->get_active_state() == state_beta);
+	}
 	SUBCASE("When there is no transition for given event") {
 		hsm->dispatch("not_found");
 		CHECK(alpha_exits->num_callbacks == 0);
@@ -241,6 +308,127 @@ TEST_CASE("[Modules][LimboAI] HSM") {
 		CHECK(hsm->is_active());
 		CHECK(hsm->get_active_state() == state_alpha);
 	}
+	SUBCASE("Test transitions changed after initialization") {
+		hsm->remove_transition(state_alpha, "event_one");
+		hsm->dispatch("event_one");
+		CHECK(hsm->get_active_state() == state_alpha);
+
+		hsm->add_transition(state_alpha, state_beta, "event_three");
+		hsm->dispatch("event_three");
+		CHECK(hsm->get_active_state() == state_beta);
+
+		LimboState *state_epsilon = memnew(LimboState);
+		hsm->add_child(state_epsilon);
+		hsm->move_child(state_epsilon, 0);
+		hsm->add_transition(state_epsilon, state_alpha, "event_two");
+		hsm->dispatch("event_two");
+		CHECK(hsm->get_active_state() == state_alpha); // * beta's row is still valid after the move
+
+		hsm->add_transition(state_alpha, state_epsilon, "goto_epsilon");
+		hsm->remove_child(state_epsilon);
+		hsm->dispatch("goto_epsilon");
+		CHECK(hsm->get_active_state() == state_alpha); // * removed child is no longer a target
+		memdelete(state_epsilon);
+	}
+	SUBCASE("Test dispatch by event ID") {
+		const int event_one = LimboState::get_event_id("event_one");
+		CHECK(event_one == LimboState::get_event_id("event_one"));
+		CHECK(LimboState::get_event_name(event_one) == StringName("event_one"));
+		CHECK(LimboState::get_event_id(hsm->event_finished()) == LimboEventRegistry::EVENT_FINISHED);
+
+		hsm->dispatch_id(event_one);
+		CHECK(hsm->get_active_state() == state_beta);
+		hsm->dispatch_id(LimboState::get_event_id("event_two"));
+		CHECK(hsm->get_active_state() == state_alpha);
+	}
+	SUBCASE("Test event routing") {
+		hsm->dispatch("goto_nested");
+		REQUIRE(hsm->get_leaf_state() == state_gamma);
+		CHECK_FALSE(hsm->dispatch("unhandled"));
+
+		// * Handlers added after events were routed are picked up.
+		Ref<TestGuard> handler = memnew(TestGuard);
+		handler->permitted_to_enter = true;
+		state_gamma->add_event_handler("unhandled", callable_mp(handler.ptr(), &TestGuard::can_enter));
+		CHECK(hsm->dispatch("unhandled"));
+
+		state_alpha->add_event_handler("alpha_only", callable_mp(handler.ptr(), &TestGuard::can_enter));
+		CHECK_FALSE(hsm->dispatch("alpha_only")); // * alpha is not active
+		nested_hsm->dispatch("goto_delta");
+		CHECK(hsm->get_leaf_state() == state_delta);
+	}
+	SUBCASE("Test queued events") {
+		CHECK(hsm->queue_event("event_one"));
+		CHECK(hsm->queue_event("event_two"));
+		CHECK(hsm->get_queued_event_count() == 2);
+		CHECK(hsm->get_active_state() == state_alpha); // * nothing happens until update
+
+		hsm->update(0.01666);
+		CHECK(hsm->get_queued_event_count() == 0);
+		CHECK(hsm->get_active_state() == state_alpha); // * alpha -> beta -> alpha, in order
+		CHECK(beta_entries->num_callbacks == 1);
+		CHECK(beta_exits->num_callbacks == 1);
+		CHECK(alpha_updates->num_callbacks == 1);
+
+		hsm->set_event_queue_capacity(1);
+		CHECK(hsm->queue_event("event_one"));
+		ERR_PRINT_OFF;
+		CHECK_FALSE(hsm->queue_event("event_two")); // * queue is full
+		ERR_PRINT_ON;
+		hsm->update(0.01666);
+		CHECK(hsm->get_active_state() == state_beta);
+
+		// * Queued from a nested state: the root owns the queue.
+		CHECK(state_beta->is_active());
+		CHECK(nested_hsm->queue_event("goto_nested"));
+		CHECK(hsm->get_queued_event_count() == 1);
+		hsm->update(0.01666);
+		CHECK(hsm->get_active_state() == nested_hsm);
+	}
+	SUBCASE("Test event channels") {
+		Ref<LimboEventChannel> channel = memnew(LimboEventChannel);
+		channel->post("event_one"); // * posted before subscribing - not dispatched
+		hsm->subscribe(channel);
+		CHECK(hsm->is_subscribed(channel));
+		channel->post("event_one");
+		CHECK(hsm->get_active_state() == state_alpha); // * nothing happens until update
+		hsm->update(0.01666);
+		CHECK(hsm->get_active_state() == state_beta);
+
+		// * Subscribing from a nested state machine subscribes the root.
+		nested_hsm->unsubscribe(channel);
+		CHECK_FALSE(hsm->is_subscribed(channel));
+		nested_hsm->subscribe(channel);
+		CHECK(hsm->is_subscribed(channel));
+
+		// * Subscribers that fall behind miss the oldest events.
+		channel->set_capacity(2);
+		channel->post("goto_nested");
+		channel->post("event_two");
+		channel->post("event_two");
+		ERR_PRINT_OFF;
+		hsm->update(0.01666);
+		ERR_PRINT_ON;
+		CHECK(hsm->get_active_state() == state_alpha);
+		CHECK(channel->get_sequence() == 5);
+
+		hsm->unsubscribe(channel);
+		channel->post("event_one");
+		hsm->update(0.01666);
+		CHECK(hsm->get_active_state() == state_alpha);
+	}
+	SUBCASE("Test transitions dispatched during an update") {
+		Ref<TestDispatcher> dispatcher = memnew(TestDispatcher);
+		dispatcher->state = state_alpha;
+		dispatcher->events.push_back("event_one");
+		dispatcher->events.push_back("event_two");
+		state_alpha->call_on_update(callable_mp(dispatcher.ptr(), &TestDispatcher::dispatch_events));
+		hsm->update(0.01666);
+		// * First transition happens after the update, the second event is re-dispatched against the new state.
+		CHECK(hsm->get_active_state() == state_alpha);
+		CHECK(beta_entries->num_callbacks == 1);
+		CHECK(beta_exits->num_callbacks == 1);
+	}
 	SUBCASE("Check if parent scope is accessible") {
 		parent_scope->set_var("parent_var", 100);
 		CHECK(state_alpha->get_blackboard()->get_parent() == parent_scope);
@@ -290,6 +478,15 @@ TEST_CASE("[Modules][LimboAI] HSM") {
 		CHECK(hsm->is_active() == false);
 		CHECK(hsm->get_leaf_state() == hsm);
 	}
+	SUBCASE("Test reparenting") {
+		CHECK_FALSE(nested_hsm->is_root());
+		hsm->remove_child(nested_hsm);
+		CHECK(nested_hsm->is_root());
+		CHECK(state_gamma->get_root() == nested_hsm);
+		hsm->add_child(nested_hsm);
+		CHECK_FALSE(nested_hsm->is_root());
+		CHECK(state_gamma->get_root() == hsm);
+	}
 	SUBCASE("Test get_root()") {
 		CHECK(hsm->get_root() == hsm);
 		CHECK(state_alpha->get_root() == hsm);
@@ -303,6 +500,217 @@ TEST_CASE("[Modules][LimboAI] HSM") {
 	memdelete(hsm);
 }
 
+TEST_CASE("[Modules][LimboAI] BTState events in nested HSMs") {
+	ClassDB::register_class<BTTestAction>();
+	Node *agent = memnew(Node);
+	LimboHSM *hsm = memnew(LimboHSM);
+	LimboHSM *nested_hsm = memnew(LimboHSM);
+	LimboState *state_other = memnew(LimboState);
+	BTState *bt_state = memnew(BTState);
+	hsm->add_child(nested_hsm);
+	hsm->add_child(state_other);
+	nested_hsm->add_child(bt_state);
+
+	Ref<BehaviorTree> bt = memnew(BehaviorTree);
+	Ref<BTSequence> root = memnew(BTSequence);
+	root->add_child(memnew(BTTestAction(BTTask::SUCCESS)));
+	bt->set_root_task(root);
+	bt_state->set_behavior_tree(bt);
+	bt_state->set_scene_root_hint(agent);
+	bt_state->set_success_event("bt_done");
+
+	// * Handled two levels up from the BTState.
+	hsm->add_transition(nested_hsm, state_other, "bt_done");
+	hsm->set_initial_state(nested_hsm);
+	hsm->initialize(agent);
+	hsm->set_active(true);
+	REQUIRE(hsm->get_leaf_state() == bt_state);
+
+	hsm->update(0.01666);
+	CHECK(hsm->get_active_state() == state_other);
+	CHECK_FALSE(bt_state->is_active());
+
+	memdelete(hsm);
+	memdelete(agent);
+}
+
+TEST_CASE("[Modules][LimboAI] BTState lazy instantiation") {
+	if (!ClassDB::class_exists("BTTestAction")) {
+		ClassDB::register_class<BTTestAction>();
+	}
+	Node *agent = memnew(Node);
+	LimboHSM *hsm = memnew(LimboHSM);
+	LimboState *state_idle = memnew(LimboState);
+	BTState *bt_state = memnew(BTState);
+	hsm->add_child(state_idle);
+	hsm->add_child(bt_state);
+
+	Ref<BehaviorTree> bt = memnew(BehaviorTree);
+	bt->set_root_task(memnew(BTTestAction(BTTask::RUNNING)));
+	bt_state->set_behavior_tree(bt);
+	bt_state->set_scene_root_hint(agent);
+	bt_state->set_lazy_instantiation(true);
+	bt_state->set_release_delay(1.0);
+	Ref<BTInstancePool> pool = memnew(BTInstancePool);
+	bt_state->set_instance_pool(pool);
+
+	hsm->add_transition(state_idle, bt_state, "go");
+	hsm->add_transition(bt_state, state_idle, "stop");
+	hsm->set_initial_state(state_idle);
+	hsm->initialize(agent);
+	hsm->set_active(true);
+	CHECK(bt_state->get_bt_instance().is_null());
+
+	hsm->dispatch("go");
+	REQUIRE(bt_state->get_bt_instance().is_valid());
+	hsm->update(0.01666);
+	CHECK(bt_state->get_bt_instance()->get_root_task()->get_status() == BTTask::RUNNING);
+
+	hsm->dispatch("stop");
+	CHECK(bt_state->get_bt_instance().is_valid()); // * released after the delay
+	LimboTimerWheel::process(0.5, false);
+	hsm->dispatch("go"); // * entered again before the release
+	hsm->dispatch("stop");
+	LimboTimerWheel::process(0.75, false);
+	CHECK(bt_state->get_bt_instance().is_valid());
+	LimboTimerWheel::process(0.5, false);
+	CHECK(bt_state->get_bt_instance().is_null());
+	CHECK(pool->get_pooled_count(bt) == 1);
+
+	hsm->dispatch("go");
+	CHECK(bt_state->get_bt_instance().is_valid());
+	CHECK(pool->get_pooled_count(bt) == 0);
+
+	memdelete(hsm);
+	memdelete(agent);
+}
+
+TEST_CASE("[Modules][LimboAI] HSM populates blackboard scopes on demand") {
+	Node *agent = memnew(Node);
+	LimboHSM *hsm = memnew(LimboHSM);
+	LimboState *state_a = memnew(LimboState);
+	LimboState *state_b = memnew(LimboState);
+	hsm->add_child(state_a);
+	hsm->add_child(state_b);
+
+	Ref<BlackboardPlan> hsm_plan = memnew(BlackboardPlan);
+	BBVariable hsm_var(Variant::INT);
+	hsm_var.set_value(1);
+	hsm_plan->add_var("shared", hsm_var);
+	hsm->set_blackboard_plan(hsm_plan);
+	Ref<BlackboardPlan> plan_b = memnew(BlackboardPlan);
+	BBVariable var_b(Variant::INT);
+	var_b.set_value(2);
+	plan_b->add_var("local", var_b);
+	state_b->set_blackboard_plan(plan_b);
+
+	// * Obtained before initialization, as get_blackboard() would apply the plan.
+	Ref<Blackboard> bb_b = state_b->get_blackboard();
+	hsm->add_transition(state_a, state_b, "go");
+	hsm->initialize(agent);
+	CHECK_FALSE(bb_b->has_var("local"));
+
+	hsm->set_active(true);
+	CHECK(state_a->get_blackboard()->get_var("shared", 0) == Variant(1));
+	CHECK_FALSE(bb_b->has_var("local"));
+
+	hsm->dispatch("go");
+	CHECK(bb_b->get_var("local", 0) == Variant(2));
+	CHECK(bb_b->get_var("shared", 0) == Variant(1));
+
+	memdelete(hsm);
+	memdelete(agent);
+}
+
+TEST_CASE("[Modules][LimboAI] HSM resource") {
+	if (!ClassDB::class_exists("BTTestAction")) {
+		ClassDB::register_class<BTTestAction>(); // * Needed to clone the behavior tree.
+	}
+	Node *agent = memnew(Node);
+	Ref<LimboHSMResource> hsm_res = memnew(LimboHSMResource);
+
+	Ref<LimboStateResource> alpha_res = memnew(LimboStateResource);
+	alpha_res->set_state_name("alpha");
+	hsm_res->add_state(alpha_res);
+
+	Ref<BehaviorTree> bt = memnew(BehaviorTree);
+	bt->set_root_task(memnew(BTTestAction(BTTask::RUNNING)));
+	Ref<LimboStateResource> beta_res = memnew(LimboStateResource);
+	beta_res->set_state_name("beta");
+	beta_res->set_behavior_tree(bt);
+	hsm_res->add_state(beta_res);
+
+	hsm_res->add_transition("alpha", "beta", "event_one");
+	hsm_res->add_transition("beta", "alpha", "success");
+	hsm_res->add_transition(StringName(), "alpha", "event_reset");
+	CHECK(hsm_res->has_transition("alpha", "event_one"));
+	CHECK_FALSE(hsm_res->has_transition("beta", "event_one"));
+
+	Ref<LimboHSMInstance> inst = hsm_res->instantiate(agent);
+	REQUIRE(inst.is_valid());
+	CHECK(inst->get_state_count() == 2);
+	CHECK(inst->get_agent() == agent);
+	CHECK_FALSE(inst->is_active());
+
+	Ref<CallbackCounter> alpha_entries = memnew(CallbackCounter);
+	Ref<CallbackCounter> alpha_updates = memnew(CallbackCounter);
+	Ref<CallbackCounter> alpha_exits = memnew(CallbackCounter);
+	inst->call_on_enter("alpha", callable_mp(alpha_entries.ptr(), &CallbackCounter::callback));
+	inst->call_on_update("alpha", callable_mp(alpha_updates.ptr(), &CallbackCounter::callback_delta));
+	inst->call_on_exit("alpha", callable_mp(alpha_exits.ptr(), &CallbackCounter::callback));
+
+	inst->set_active(true);
+	CHECK(inst->is_active());
+	CHECK(inst->get_active_state() == StringName("alpha"));
+	CHECK(alpha_entries->num_callbacks == 1);
+
+	SUBCASE("Test update and transitions") {
+		inst->update(0.01666);
+		CHECK(alpha_updates->num_callbacks == 1);
+		CHECK(inst->dispatch("event_one"));
+		CHECK(inst->get_active_state() == StringName("beta"));
+		CHECK(inst->get_previous_active_state() == StringName("alpha"));
+		CHECK(alpha_exits->num_callbacks == 1);
+
+		Ref<BTInstance> bt_inst = inst->get_bt_instance("beta");
+		REQUIRE(bt_inst.is_valid());
+		CHECK(bt_inst->get_agent() == agent);
+		CHECK(bt_inst->get_blackboard()->get_parent() == inst->get_blackboard());
+		Ref<BTTestAction> action = bt_inst->get_root_task();
+
+		inst->update(0.01666);
+		CHECK(action->num_ticks == 1);
+		CHECK(inst->get_active_state() == StringName("beta"));
+
+		action->ret_status = BTTask::SUCCESS;
+		inst->update(0.01666);
+		CHECK(inst->get_active_state() == StringName("alpha"));
+		CHECK(alpha_entries->num_callbacks == 2);
+	}
+	SUBCASE("Test ANYSTATE transition") {
+		CHECK_FALSE(inst->dispatch("event_reset")); // * No transitions to self from ANYSTATE.
+		inst->change_active_state("beta");
+		CHECK(inst->dispatch("event_reset"));
+		CHECK(inst->get_active_state() == StringName("alpha"));
+	}
+	SUBCASE("Test guard") {
+		Ref<TestGuard> guard = memnew(TestGuard);
+		inst->set_guard("beta", callable_mp(guard.ptr(), &TestGuard::can_enter));
+		CHECK_FALSE(inst->dispatch("event_one"));
+		CHECK(inst->get_active_state() == StringName("alpha"));
+		guard->permitted_to_enter = true;
+		CHECK(inst->dispatch("event_one"));
+		CHECK(inst->get_active_state() == StringName("beta"));
+	}
+	SUBCASE("Test finished event") {
+		CHECK_FALSE(inst->dispatch("finished"));
+		CHECK_FALSE(inst->is_active());
+		CHECK(alpha_exits->num_callbacks == 1);
+	}
+
+	memdelete(agent);
+}
+
 } //namespace TestHSM
 
 #endif // TEST_HSM_H
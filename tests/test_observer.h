@@ -0,0 +1,94 @@
+/**
+ * test_observer.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef TEST_OBSERVER_H
+#define TEST_OBSERVER_H
+
+#include "limbo_test.h"
+
+#include "modules/limboai/blackboard/bb_param/bb_variant.h"
+#include "modules/limboai/bt/behavior_tree.h"
+#include "modules/limboai/bt/tasks/blackboard/bt_check_var.h"
+#include "modules/limboai/bt/tasks/composites/bt_selector.h"
+#include "modules/limboai/bt/tasks/composites/bt_sequence.h"
+#include "modules/limboai/bt/tasks/decorators/bt_observer.h"
+
+namespace TestObserver {
+
+TEST_CASE("[Modules][LimboAI] BTObserver") {
+	ClassDB::register_class<BTTestAction>();
+
+	// * Selector: the observed branch runs while "go" is true, the fallback runs otherwise.
+	Ref<BehaviorTree> bt = memnew(BehaviorTree);
+	Ref<BTSelector> sel = memnew(BTSelector);
+	Ref<BTObserver> observer = memnew(BTObserver);
+	Ref<BTSequence> seq = memnew(BTSequence);
+	Ref<BTCheckVar> check = memnew(BTCheckVar);
+	check->set_variable("go");
+	Ref<BBVariant> value = memnew(BBVariant);
+	value->set_saved_value(true);
+	check->set_value(value);
+	seq->add_child(check);
+	seq->add_child(memnew(BTTestAction(BTTask::RUNNING)));
+	observer->add_child(seq);
+	sel->add_child(observer);
+	sel->add_child(memnew(BTTestAction(BTTask::RUNNING)));
+	bt->set_root_task(sel);
+
+	Ref<Blackboard> bb = memnew(Blackboard);
+	bb->set_var("go", false);
+	Ref<BTInstance> inst = bt->instantiate_headless(bb);
+	REQUIRE(inst.is_valid());
+	Ref<BTTask> root = inst->get_root_task();
+	Ref<BTTestAction> action = root->get_child(0)->get_child(0)->get_child(1);
+	Ref<BTTestAction> fallback = root->get_child(1);
+
+	inst->update(0.1);
+	CHECK(fallback->get_status() == BTTask::RUNNING);
+	CHECK(action->num_ticks == 0);
+
+	SUBCASE("Lower priority branches are aborted") {
+		bb->set_var("go", true);
+		inst->update(0.1);
+		CHECK(fallback->get_status() == BTTask::FRESH);
+		CHECK(fallback->num_exits == 1);
+		CHECK(action->get_status() == BTTask::RUNNING);
+
+		SUBCASE("The running branch is aborted") {
+			bb->set_var("go", false);
+			inst->update(0.1);
+			CHECK(action->get_status() == BTTask::FRESH);
+			CHECK(action->num_exits == 1);
+			CHECK(fallback->get_status() == BTTask::RUNNING);
+		}
+	}
+
+	SUBCASE("Writing the same value doesn't abort") {
+		bb->set_var("go", false);
+		inst->update(0.1);
+		CHECK(fallback->get_status() == BTTask::RUNNING);
+		CHECK(fallback->num_exits == 0);
+		CHECK(fallback->num_ticks == 2);
+	}
+
+	SUBCASE("Abort self only") {
+		Ref<BTObserver> runtime_observer = root->get_child(0);
+		runtime_observer->set_abort_mode(BTObserver::ABORT_SELF);
+		bb->set_var("go", true);
+		inst->update(0.1);
+		CHECK(fallback->get_status() == BTTask::RUNNING);
+		CHECK(action->num_ticks == 0);
+	}
+}
+
+} //namespace TestObserver
+
+#endif // TEST_OBSERVER_H
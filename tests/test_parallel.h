@@ -14,6 +14,8 @@
 
 #include "limbo_test.h"
 
+#include "modules/limboai/blackboard/bb_param/bb_variant.h"
+#include "modules/limboai/bt/tasks/blackboard/bt_set_var.h"
 #include "modules/limboai/bt/tasks/bt_task.h"
 #include "modules/limboai/bt/tasks/composites/bt_parallel.h"
 
@@ -205,6 +207,99 @@ TEST_CASE("[Modules][LimboAI] BTParallel with num_required_successes: 1 and num_
 		CHECK_ENTRIES_TICKS_EXITS(task2, 1, 3, 0); // * continued
 		CHECK_ENTRIES_TICKS_EXITS(task3, 2, 2, 2); // * repeated
 	}
+
+	SUBCASE("BTParallel composition {SUCCESS, RUNNING, RUNNING} with successes/failures required 2/2 (not repeating)") {
+		// * Case #6: Children that finished on earlier ticks still count toward the required number.
+		task1->ret_status = BTTask::SUCCESS;
+		task2->ret_status = BTTask::RUNNING;
+		task3->ret_status = BTTask::RUNNING;
+		par->set_num_successes_required(2);
+		par->set_num_failures_required(2);
+		par->set_repeat(false);
+		CHECK(par->execute(0.01666) == BTTask::RUNNING);
+		CHECK(par->execute(0.01666) == BTTask::RUNNING);
+
+		task3->ret_status = BTTask::SUCCESS;
+		CHECK(par->execute(0.01666) == BTTask::SUCCESS);
+
+		CHECK_ENTRIES_TICKS_EXITS(task1, 1, 1, 1); // * not ticked after finishing
+		CHECK_ENTRIES_TICKS_EXITS(task2, 1, 3, 0); // * still running
+		CHECK_ENTRIES_TICKS_EXITS(task3, 1, 3, 1);
+	}
+}
+
+Ref<BTSetVar> make_set_var(const StringName &p_variable) {
+	Ref<BTSetVar> set_var = memnew(BTSetVar);
+	set_var->set_variable(p_variable);
+	Ref<BBVariant> value = memnew(BBVariant);
+	value->set_saved_value(1);
+	set_var->set_value(value);
+	return set_var;
+}
+
+TEST_CASE("[Modules][LimboAI] BTParallel concurrent") {
+	Ref<BTParallel> par = memnew(BTParallel);
+	par->set_concurrent(true);
+	Node *dummy = memnew(Node);
+	Ref<Blackboard> bb = memnew(Blackboard);
+	bb->set_var("a", 0);
+	bb->set_var("b", 0);
+
+	SUBCASE("Independent thread-safe branches run concurrently") {
+		par->add_child(make_set_var("a"));
+		par->add_child(make_set_var("b"));
+		par->initialize(dummy, bb, dummy);
+		CHECK(par->is_running_concurrently());
+	}
+
+	SUBCASE("Branches writing the same variable run sequentially") {
+		par->add_child(make_set_var("a"));
+		par->add_child(make_set_var("a"));
+		ERR_PRINT_OFF;
+		par->initialize(dummy, bb, dummy);
+		ERR_PRINT_ON;
+		CHECK_FALSE(par->is_running_concurrently());
+	}
+
+	SUBCASE("Branches creating a variable run sequentially") {
+		par->add_child(make_set_var("a"));
+		par->add_child(make_set_var("c"));
+		ERR_PRINT_OFF;
+		par->initialize(dummy, bb, dummy);
+		ERR_PRINT_ON;
+		CHECK_FALSE(par->is_running_concurrently());
+	}
+
+	SUBCASE("Branches writing a variable of the parent scope run sequentially") {
+		Ref<Blackboard> scope = memnew(Blackboard);
+		scope->set_parent(bb);
+		par->add_child(make_set_var("a"));
+		par->add_child(make_set_var("b"));
+		ERR_PRINT_OFF;
+		par->initialize(dummy, scope, dummy);
+		ERR_PRINT_ON;
+		CHECK_FALSE(par->is_running_concurrently());
+	}
+
+	SUBCASE("Blackboard scopes with listeners report them") {
+		Ref<Blackboard> scope = memnew(Blackboard);
+		scope->set_parent(bb);
+		CHECK_FALSE(scope->has_var_listeners());
+		bb->add_var_listener("a", callable_mp(dummy, &Node::queue_free));
+		CHECK(scope->has_var_listeners());
+		CHECK(bb->has_var_listeners());
+		bb->remove_var_listener("a", callable_mp(dummy, &Node::queue_free));
+		CHECK_FALSE(scope->has_var_listeners());
+	}
+
+	SUBCASE("Branches that aren't thread-safe run sequentially") {
+		par->add_child(make_set_var("a"));
+		par->add_child(memnew(BTTestAction));
+		par->initialize(dummy, bb, dummy);
+		CHECK_FALSE(par->is_running_concurrently());
+	}
+
+	memdelete(dummy);
 }
 
 } //namespace TestParallel
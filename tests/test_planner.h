@@ -0,0 +1,147 @@
+/**
+ * test_planner.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef TEST_PLANNER_H
+#define TEST_PLANNER_H
+
+#include "limbo_test.h"
+
+#include "modules/limboai/bt/tasks/bt_task.h"
+#include "modules/limboai/bt/tasks/composites/bt_plan_action.h"
+#include "modules/limboai/bt/tasks/composites/bt_planner.h"
+
+namespace TestPlanner {
+
+Ref<BTPlanAction> make_action(const Dictionary &p_preconditions, const Dictionary &p_effects, double p_cost) {
+	Ref<BTPlanAction> action = memnew(BTPlanAction);
+	action->set_preconditions(p_preconditions);
+	action->set_effects(p_effects);
+	action->set_cost(p_cost);
+	return action;
+}
+
+Dictionary make_facts(const StringName &p_var, const Variant &p_value) {
+	Dictionary facts;
+	facts[p_var] = p_value;
+	return facts;
+}
+
+// * Getting wood: fetch an axe and chop a tree nearby (cost 3), or gather branches (cost 5).
+Ref<BTPlanner> make_planner(const Ref<BTTestAction> &p_get_axe, const Ref<BTTestAction> &p_chop, const Ref<BTTestAction> &p_gather) {
+	Ref<BTPlanner> planner = memnew(BTPlanner);
+	planner->add_child(p_get_axe);
+	planner->add_child(p_chop);
+	planner->add_child(p_gather);
+	Dictionary chop_preconditions = make_facts("has_axe", true);
+	chop_preconditions["tree_nearby"] = true;
+	planner->set_plan_action(0, make_action(Dictionary(), make_facts("has_axe", true), 2.0));
+	planner->set_plan_action(1, make_action(chop_preconditions, make_facts("has_wood", true), 1.0));
+	planner->set_plan_action(2, make_action(Dictionary(), make_facts("has_wood", true), 5.0));
+	planner->set_goal(make_facts("has_wood", true));
+	return planner;
+}
+
+TEST_CASE("[Modules][LimboAI] BTPlanner") {
+	Ref<BTTestAction> get_axe = memnew(BTTestAction(BTTask::SUCCESS));
+	Ref<BTTestAction> chop = memnew(BTTestAction(BTTask::RUNNING));
+	Ref<BTTestAction> gather = memnew(BTTestAction(BTTask::SUCCESS));
+	Ref<BTPlanner> planner = make_planner(get_axe, chop, gather);
+
+	Node *dummy = memnew(Node);
+	Ref<Blackboard> bb = memnew(Blackboard);
+	bb->set_var("has_axe", false);
+	bb->set_var("has_wood", false);
+	bb->set_var("tree_nearby", true);
+	planner->initialize(dummy, bb, dummy);
+
+	SUBCASE("Executes the cheapest plan") {
+		CHECK(planner->execute(0.01666) == BTTask::RUNNING);
+		CHECK(planner->get_plan() == PackedInt32Array({ 0, 1 }));
+		CHECK(planner->get_plan_position() == 1);
+		CHECK_STATUS_ENTRIES_TICKS_EXITS(get_axe, BTTask::SUCCESS, 1, 1, 1);
+		CHECK_STATUS_ENTRIES_TICKS_EXITS(chop, BTTask::RUNNING, 1, 1, 0);
+		CHECK_STATUS_ENTRIES_TICKS_EXITS(gather, BTTask::FRESH, 0, 0, 0);
+	}
+	SUBCASE("Succeeds right away if the goal is met") {
+		bb->set_var("has_wood", true);
+		CHECK(planner->execute(0.01666) == BTTask::SUCCESS);
+		CHECK_STATUS_ENTRIES_TICKS_EXITS(get_axe, BTTask::FRESH, 0, 0, 0);
+	}
+	SUBCASE("Keeps the plan if a change doesn't affect it") {
+		get_axe->ret_status = BTTask::RUNNING;
+		CHECK(planner->execute(0.01666) == BTTask::RUNNING);
+		bb->set_var("has_axe", true); // * Expected effect of the running step.
+		CHECK(planner->execute(0.01666) == BTTask::RUNNING);
+		CHECK(planner->get_plan() == PackedInt32Array({ 0, 1 }));
+		CHECK_STATUS_ENTRIES_TICKS_EXITS(get_axe, BTTask::RUNNING, 1, 2, 0);
+	}
+	SUBCASE("Replans when the rest of the plan becomes invalid") {
+		get_axe->ret_status = BTTask::RUNNING;
+		gather->ret_status = BTTask::RUNNING;
+		CHECK(planner->execute(0.01666) == BTTask::RUNNING);
+		bb->set_var("tree_nearby", false);
+		CHECK(planner->execute(0.01666) == BTTask::RUNNING);
+		CHECK(planner->get_plan() == PackedInt32Array({ 2 }));
+		CHECK_STATUS_ENTRIES_TICKS_EXITS(get_axe, BTTask::FRESH, 1, 1, 1); // * Aborted.
+		CHECK_STATUS_ENTRIES_TICKS_EXITS(gather, BTTask::RUNNING, 1, 1, 0);
+	}
+	SUBCASE("Succeeds when the goal is reached while a step is running") {
+		CHECK(planner->execute(0.01666) == BTTask::RUNNING);
+		bb->set_var("has_wood", true);
+		CHECK(planner->execute(0.01666) == BTTask::SUCCESS);
+		CHECK_STATUS_ENTRIES_TICKS_EXITS(chop, BTTask::FRESH, 1, 1, 1);
+	}
+	SUBCASE("Fails if the plan doesn't reach the goal") {
+		chop->ret_status = BTTask::SUCCESS; // * Doesn't produce "has_wood".
+		CHECK(planner->execute(0.01666) == BTTask::FAILURE);
+	}
+	SUBCASE("Fails if there is no plan") {
+		Dictionary goal = make_facts("has_wood", true);
+		goal["has_stone"] = true;
+		planner->set_goal(goal);
+		CHECK(planner->execute(0.01666) == BTTask::FAILURE);
+		CHECK_STATUS_ENTRIES_TICKS_EXITS(get_axe, BTTask::FRESH, 0, 0, 0);
+	}
+
+	memdelete(dummy);
+}
+
+TEST_CASE("[Modules][LimboAI] BTPlanner shares plans between clones") {
+	Ref<BTPlanner> planner = make_planner(memnew(BTTestAction(BTTask::RUNNING)), memnew(BTTestAction(BTTask::RUNNING)), memnew(BTTestAction(BTTask::RUNNING)));
+
+	Node *dummy = memnew(Node);
+	LocalVector<Ref<BTPlanner>> agents;
+	for (int i = 0; i < 3; i++) {
+		Ref<Blackboard> bb = memnew(Blackboard);
+		bb->set_var("has_axe", false);
+		bb->set_var("has_wood", false);
+		bb->set_var("tree_nearby", i != 2);
+		Ref<BTPlanner> agent = planner->clone();
+		agent->initialize(dummy, bb, dummy);
+		agents.push_back(agent);
+	}
+
+	CHECK(agents[0]->execute(0.01666) == BTTask::RUNNING);
+	CHECK_FALSE(agents[0]->is_plan_cached());
+	CHECK(agents[1]->execute(0.01666) == BTTask::RUNNING);
+	CHECK(agents[1]->is_plan_cached());
+	CHECK(agents[1]->get_plan() == PackedInt32Array({ 0, 1 }));
+	CHECK(agents[2]->execute(0.01666) == BTTask::RUNNING);
+	CHECK_FALSE(agents[2]->is_plan_cached()); // * Different world state.
+	CHECK(agents[2]->get_plan() == PackedInt32Array({ 2 }));
+	CHECK(agents[0]->get_cached_plan_count() == 2);
+
+	memdelete(dummy);
+}
+
+} //namespace TestPlanner
+
+#endif // TEST_PLANNER_H
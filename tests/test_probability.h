@@ -14,6 +14,8 @@
 
 #include "limbo_test.h"
 
+#include "modules/limboai/bt/behavior_tree.h"
+#include "modules/limboai/bt/bt_instance.h"
 #include "modules/limboai/bt/tasks/bt_task.h"
 #include "modules/limboai/bt/tasks/decorators/bt_probability.h"
 
@@ -84,6 +86,30 @@ TEST_CASE("[Modules][LimboAI] BTProbability") {
 		CHECK(prob->execute(0.01666) == BTTask::FAILURE);
 		CHECK_STATUS_ENTRIES_TICKS_EXITS(task, BTTask::FAILURE, 2, 3, 2);
 	}
+
+	SUBCASE("Test resume running") {
+		prob->set_run_chance(1.0);
+		task->ret_status = BTTask::RUNNING;
+		Ref<BehaviorTree> bt = memnew(BehaviorTree);
+		bt->set_root_task(prob);
+		Node *dummy = memnew(Node);
+		Ref<Blackboard> bb = memnew(Blackboard);
+		Ref<BTInstance> inst = bt->instantiate(dummy, bb, dummy, dummy);
+		REQUIRE(inst.is_valid());
+		inst->set_resume_running(true);
+		Ref<BTProbability> prob_copy = inst->get_root_task();
+		Ref<BTTestAction> task_copy = prob_copy->get_child(0);
+
+		CHECK(inst->update(0.01666) == BTTask::RUNNING);
+		// * Rolling again would fail - the running child must be continued and its result reported.
+		prob_copy->set_run_chance(0.0);
+		CHECK(inst->update(0.01666) == BTTask::RUNNING);
+		task_copy->ret_status = BTTask::SUCCESS;
+		CHECK(inst->update(0.01666) == BTTask::SUCCESS);
+		CHECK_STATUS_ENTRIES_TICKS_EXITS(task_copy, BTTask::SUCCESS, 1, 3, 1);
+
+		memdelete(dummy);
+	}
 }
 
 } //namespace TestProbability
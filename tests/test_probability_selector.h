@@ -157,6 +157,31 @@ TEST_CASE("[Modules][LimboAI] BTProbabilitySelector") {
 		CHECK(task3->num_ticks > 5750);
 		CHECK(task3->num_ticks < 6750);
 	}
+	SUBCASE("With many children failing") {
+		task1->ret_status = BTTask::FAILURE;
+		task2->ret_status = BTTask::FAILURE;
+		task3->ret_status = BTTask::FAILURE;
+		LocalVector<Ref<BTTestAction>> tasks;
+		for (int i = 0; i < 70; i++) {
+			Ref<BTTestAction> task = memnew(BTTestAction(BTTask::FAILURE));
+			sel->add_child(task);
+			sel->set_weight(sel->get_child_count() - 1, 1.0 + (i % 5));
+			tasks.push_back(task);
+		}
+		tasks[42]->ret_status = BTTask::SUCCESS;
+
+		for (int run = 0; run < 10; run++) {
+			CHECK(sel->execute(0.01666) == BTTask::SUCCESS);
+		}
+		// Each child is tried at most once per run.
+		CHECK(tasks[42]->num_ticks == 10);
+		int num_ticks = task1->num_ticks + task2->num_ticks + task3->num_ticks;
+		for (const Ref<BTTestAction> &task : tasks) {
+			CHECK(task->num_ticks <= 10);
+			num_ticks += task->num_ticks;
+		}
+		CHECK(num_ticks <= 10 * 73);
+	}
 	SUBCASE("Test abort_on_failure") {
 		task1->ret_status = BTTask::FAILURE;
 		task2->ret_status = BTTask::FAILURE;
@@ -0,0 +1,84 @@
+/**
+ * test_query_nearby.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef TEST_QUERY_NEARBY_H
+#define TEST_QUERY_NEARBY_H
+
+#include "limbo_test.h"
+
+#include "modules/limboai/bt/tasks/bt_task.h"
+#include "modules/limboai/bt/tasks/scene/bt_query_nearby.h"
+#include "modules/limboai/util/limbo_spatial_index.h"
+
+#include "scene/2d/node_2d.h"
+#include "scene/main/window.h"
+
+namespace TestQueryNearby {
+
+TEST_CASE("[SceneTree][LimboAI] BTQueryNearby") {
+	Node *root = SceneTree::get_singleton()->get_root();
+	Node2D *agent = memnew(Node2D);
+	agent->add_to_group("query_nearby_test");
+	root->add_child(agent);
+
+	Node2D *near = memnew(Node2D);
+	near->set_position(Vector2(30, 0));
+	Node2D *far = memnew(Node2D);
+	far->set_position(Vector2(-80, 40));
+	Node2D *ignored = memnew(Node2D); // Not in the group.
+	ignored->set_position(Vector2(5, 5));
+	for (Node2D *node : { near, far }) {
+		node->add_to_group("query_nearby_test");
+		root->add_child(node);
+	}
+	root->add_child(ignored);
+
+	Ref<BTQueryNearby> qn = memnew(BTQueryNearby);
+	qn->set_group("query_nearby_test");
+	qn->set_output_var("target");
+	Ref<Blackboard> bb = memnew(Blackboard);
+	qn->initialize(agent, bb, agent);
+
+	SUBCASE("Finds the nearest member, excluding the agent") {
+		qn->set_radius(100.0);
+		CHECK(qn->execute(0.01666) == BTTask::SUCCESS);
+		CHECK(bb->get_var("target", Variant()) == Variant(near));
+	}
+	SUBCASE("Fails if no member is within the radius") {
+		qn->set_radius(20.0);
+		CHECK(qn->execute(0.01666) == BTTask::FAILURE);
+		CHECK_FALSE(bb->has_var("target"));
+	}
+	SUBCASE("Queries from the current position of the agent") {
+		agent->set_position(Vector2(-200, 0));
+		qn->set_radius(150.0);
+		CHECK(qn->execute(0.01666) == BTTask::SUCCESS);
+		CHECK(bb->get_var("target", Variant()) == Variant(far));
+	}
+	SUBCASE("Fails if the agent is not a Node2D or Node3D") {
+		Node *dummy = memnew(Node);
+		qn->initialize(dummy, bb, dummy);
+		ERR_PRINT_OFF;
+		CHECK(qn->execute(0.01666) == BTTask::FAILURE);
+		ERR_PRINT_ON;
+		memdelete(dummy);
+	}
+
+	LimboSpatialIndex::clear(); // * Built for this frame - would be reused by the next subcase.
+	memdelete(ignored);
+	memdelete(far);
+	memdelete(near);
+	memdelete(agent);
+}
+
+} //namespace TestQueryNearby
+
+#endif // TEST_QUERY_NEARBY_H
@@ -100,6 +100,35 @@ TEST_CASE("[Modules][LimboAI] BTRandomSelector") {
 	}
 }
 
+TEST_CASE("[Modules][LimboAI] BTRandomSelector with seed") {
+	// Returns the sequence of first picks over several runs.
+	auto first_picks = [](int64_t p_seed) {
+		Ref<BTRandomSelector> sel = memnew(BTRandomSelector);
+		sel->set_seed(p_seed);
+		LocalVector<Ref<BTTestAction>> tasks;
+		for (int i = 0; i < 8; i++) {
+			tasks.push_back(memnew(BTTestAction(BTTask::SUCCESS)));
+			sel->add_child(tasks[i]);
+		}
+		Vector<int> picks;
+		for (int run = 0; run < 16; run++) {
+			CHECK(sel->execute(0.01666) == BTTask::SUCCESS);
+			for (int i = 0; i < 8; i++) {
+				if (tasks[i]->get_status() == BTTask::SUCCESS && tasks[i]->num_ticks > 0) {
+					tasks[i]->num_ticks = 0;
+					picks.push_back(i);
+				}
+			}
+		}
+		return picks;
+	};
+
+	const Vector<int> picks = first_picks(42);
+	CHECK(picks.size() == 16);
+	CHECK(picks == first_picks(42)); // * same seed, same order
+	CHECK(picks != first_picks(43));
+}
+
 TEST_CASE("[Modules][LimboAI] Empty BTRandomSelector returns FAILURE") {
 	Ref<BTRandomSelector> seq = memnew(BTRandomSelector);
 	CHECK(seq->execute(0.01666) == BTTask::FAILURE);
@@ -76,6 +76,26 @@ TEST_CASE("[Modules][LimboAI] BTRepeat") {
 		CHECK_STATUS_ENTRIES_TICKS_EXITS(task, BTTask::SUCCESS, 2, 4, 2);
 	}
 
+	SUBCASE("With multiple iterations per tick") {
+		rep->set_times(5);
+		rep->set_forever(false);
+		rep->set_max_iterations_per_tick(3);
+		task->ret_status = BTTask::SUCCESS;
+
+		CHECK(rep->execute(0.01666) == BTTask::RUNNING);
+		CHECK_STATUS_ENTRIES_TICKS_EXITS(task, BTTask::SUCCESS, 3, 3, 3);
+		CHECK(rep->execute(0.01666) == BTTask::SUCCESS);
+		CHECK_STATUS_ENTRIES_TICKS_EXITS(task, BTTask::SUCCESS, 5, 5, 5);
+
+		// * Running children end the tick.
+		task->ret_status = BTTask::RUNNING;
+		CHECK(rep->execute(0.01666) == BTTask::RUNNING);
+		CHECK_STATUS_ENTRIES_TICKS_EXITS(task, BTTask::RUNNING, 6, 6, 5);
+
+		rep->set_max_iterations_per_tick(1000000);
+		CHECK(rep->get_max_iterations_per_tick() == 1024);
+	}
+
 	SUBCASE("When the child task fails") {
 		rep->set_times(2);
 		rep->set_forever(false);
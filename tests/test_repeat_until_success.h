@@ -44,6 +44,13 @@ TEST_CASE("[Modules][LimboAI] BTRepeatUntilSuccess") {
 		CHECK(rep->execute(0.01666) == BTTask::SUCCESS);
 		CHECK_STATUS_ENTRIES_TICKS_EXITS(task, BTTask::SUCCESS, 2, 3, 2);
 	}
+
+	SUBCASE("With multiple iterations per tick") {
+		rep->set_max_iterations_per_tick(4);
+		task->ret_status = BTTask::FAILURE;
+		CHECK(rep->execute(0.01666) == BTTask::RUNNING);
+		CHECK_STATUS_ENTRIES_TICKS_EXITS(task, BTTask::FAILURE, 4, 4, 4);
+	}
 }
 
 } //namespace TestRepeatUntilSuccess
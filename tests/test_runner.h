@@ -0,0 +1,103 @@
+/**
+ * test_runner.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef TEST_RUNNER_H
+#define TEST_RUNNER_H
+
+#include "limbo_test.h"
+
+#include "modules/limboai/blackboard/bb_param/bb_variant.h"
+#include "modules/limboai/bt/behavior_tree.h"
+#include "modules/limboai/bt/bt_runner.h"
+#include "modules/limboai/bt/tasks/blackboard/bt_set_var.h"
+#include "modules/limboai/bt/tasks/composites/bt_sequence.h"
+#include "modules/limboai/bt/tasks/scene/bt_check_agent_property.h"
+
+namespace TestRunner {
+
+TEST_CASE("[Modules][LimboAI] BTRunner") {
+	ClassDB::register_class<BTTestAction>();
+
+	// * Runs once, then stays in the running action.
+	Ref<BehaviorTree> bt = memnew(BehaviorTree);
+	Ref<BTSequence> seq = memnew(BTSequence);
+	Ref<BTSetVar> set_var = memnew(BTSetVar);
+	set_var->set_variable("done");
+	Ref<BBVariant> value = memnew(BBVariant);
+	value->set_saved_value(true);
+	set_var->set_value(value);
+	seq->add_child(set_var);
+	seq->add_child(memnew(BTTestAction(BTTask::RUNNING)));
+	bt->set_root_task(seq);
+
+	Ref<BTRunner> runner = memnew(BTRunner);
+	LocalVector<Ref<BTInstance>> instances;
+	for (int i = 0; i < 3; i++) {
+		Ref<Blackboard> bb = memnew(Blackboard);
+		bb->set_var("done", false);
+		Ref<BTInstance> inst = runner->add_tree(bt, bb);
+		REQUIRE(inst.is_valid());
+		CHECK(inst->get_agent() == nullptr);
+		CHECK(inst->get_owner_node() == nullptr);
+		instances.push_back(inst);
+	}
+	REQUIRE(runner->get_instance_count() == 3);
+
+	runner->update(0.1);
+	runner->update(0.1);
+	for (const Ref<BTInstance> &inst : instances) {
+		CHECK(inst->get_last_status() == BTTask::RUNNING);
+		CHECK(inst->get_blackboard()->get_var("done", Variant()) == Variant(true));
+		Ref<BTTestAction> action = inst->get_root_task()->get_child(1);
+		CHECK(action->num_ticks == 2);
+	}
+
+	SUBCASE("Removal aborts the running tree") {
+		Ref<BTTestAction> action = instances[0]->get_root_task()->get_child(1);
+		runner->remove_instance(instances[0]);
+		CHECK(runner->get_instance_count() == 2);
+		CHECK_FALSE(runner->has_instance(instances[0]));
+		CHECK(runner->get_instance(0) == instances[2]);
+		CHECK(action->num_exits == 1);
+		CHECK(action->get_status() == BTTask::FRESH);
+
+		runner->update(0.1);
+		CHECK(action->num_ticks == 2);
+	}
+
+	SUBCASE("Instances can't be added twice") {
+		ERR_PRINT_OFF;
+		runner->add_instance(instances[1]);
+		ERR_PRINT_ON;
+		CHECK(runner->get_instance_count() == 3);
+	}
+
+	SUBCASE("Tasks that need an agent fail") {
+		Ref<BehaviorTree> agent_bt = memnew(BehaviorTree);
+		Ref<BTCheckAgentProperty> check = memnew(BTCheckAgentProperty);
+		check->set_property("process_mode");
+		check->set_value(value);
+		agent_bt->set_root_task(check);
+		ERR_PRINT_OFF;
+		Ref<BTInstance> inst = runner->add_tree(agent_bt);
+		REQUIRE(inst.is_valid());
+		runner->update(0.1);
+		ERR_PRINT_ON;
+		CHECK(inst->get_last_status() == BTTask::FAILURE);
+	}
+
+	runner->clear();
+	CHECK(runner->get_instance_count() == 0);
+}
+
+} //namespace TestRunner
+
+#endif // TEST_RUNNER_H
@@ -0,0 +1,411 @@
+/**
+ * test_scheduler.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef TEST_SCHEDULER_H
+#define TEST_SCHEDULER_H
+
+#include "limbo_test.h"
+
+#include "modules/limboai/blackboard/bb_param/bb_variant.h"
+#include "modules/limboai/bt/behavior_tree.h"
+#include "modules/limboai/bt/bt_player.h"
+#include "modules/limboai/bt/bt_scheduler.h"
+#include "modules/limboai/bt/tasks/blackboard/bt_check_var.h"
+#include "modules/limboai/bt/tasks/composites/bt_sequence.h"
+#include "modules/limboai/bt/tasks/utility/bt_call_method.h"
+#include "modules/limboai/bt/tasks/utility/bt_wait.h"
+#include "modules/limboai/util/limbo_task_db.h"
+
+#include "core/os/os.h"
+#include "core/templates/safe_refcount.h"
+#include "scene/main/window.h"
+
+namespace TestScheduler {
+
+// Takes long enough to exceed any frame budget used by the tests.
+class BTSlowTestAction : public BTAction {
+	GDCLASS(BTSlowTestAction, BTAction);
+
+public:
+	static constexpr int DURATION_USEC = 2000;
+
+	int num_ticks = 0;
+
+protected:
+	static void _bind_methods() {}
+
+	virtual Status _tick(double p_delta) override {
+		num_ticks += 1;
+		OS::get_singleton()->delay_usec(DURATION_USEC);
+		return SUCCESS;
+	}
+};
+
+// Counts the ticks made on worker threads and on the main thread.
+class BTThreadProbe : public BTAction {
+	GDCLASS(BTThreadProbe, BTAction);
+	TASK_CATEGORY(Utility);
+	TASK_THREAD_SAFE();
+
+public:
+	static inline SafeNumeric<uint32_t> worker_ticks;
+	static inline SafeNumeric<uint32_t> main_ticks;
+
+protected:
+	static void _bind_methods() {}
+
+	virtual Status _tick(double p_delta) override {
+		if (BTScheduler::is_deferring_calls()) {
+			worker_ticks.increment();
+		} else {
+			main_ticks.increment();
+		}
+		return SUCCESS;
+	}
+};
+
+inline BTPlayer *_add_scheduled_player(Node *p_parent, const Ref<BehaviorTree> &p_bt, const Ref<Blackboard> &p_blackboard = Ref<Blackboard>()) {
+	BTPlayer *player = memnew(BTPlayer);
+	if (p_blackboard.is_valid()) {
+		player->set_blackboard(p_blackboard);
+	}
+	player->set_behavior_tree(p_bt);
+	player->set_update_mode(BTPlayer::UpdateMode::SCHEDULED);
+	p_parent->add_child(player);
+	player->set_owner(p_parent);
+	return player;
+}
+
+inline void _free_object(Object *p_object) {
+	memdelete(p_object);
+}
+
+inline int _get_slow_ticks(BTPlayer *p_player) {
+	Ref<BTSlowTestAction> task = p_player->get_bt_instance()->get_root_task();
+	return task.is_valid() ? task->num_ticks : -1;
+}
+
+TEST_CASE("[SceneTree][LimboAI] BTScheduler") {
+	REQUIRE(BTScheduler::get_singleton() != nullptr);
+
+	// * Pure tree that reads a variable of the outer scope.
+	Ref<BehaviorTree> bt = memnew(BehaviorTree);
+	Ref<BTCheckVar> check = memnew(BTCheckVar);
+	check->set_variable("go");
+	Ref<BBVariant> value = memnew(BBVariant);
+	value->set_saved_value(true);
+	check->set_value(value);
+	bt->set_root_task(check);
+	bt->set_share_identical_updates(true);
+
+	Ref<Blackboard> outer = memnew(Blackboard);
+	outer->set_var("go", true);
+
+	Node *agent = memnew(Node);
+	SceneTree::get_singleton()->get_root()->add_child(agent);
+	LocalVector<BTPlayer *> players;
+	for (int i = 0; i < 2; i++) {
+		BTPlayer *player = memnew(BTPlayer);
+		Ref<Blackboard> bb = memnew(Blackboard);
+		bb->set_parent(outer);
+		player->set_blackboard(bb);
+		player->set_behavior_tree(bt);
+		player->set_update_mode(BTPlayer::UpdateMode::SCHEDULED);
+		agent->add_child(player);
+		player->set_owner(agent);
+		players.push_back(player);
+	}
+	REQUIRE(players[0]->get_bt_instance().is_valid());
+	REQUIRE(players[1]->get_bt_instance().is_valid());
+	REQUIRE(players[0]->get_bt_instance()->is_pure());
+
+	SUBCASE("Identical players share an update") {
+		BTScheduler::get_singleton()->update(0.1);
+		CHECK(BTScheduler::get_singleton()->get_shared_count() == 1);
+		CHECK(players[0]->get_bt_instance()->get_last_status() == BTTask::SUCCESS);
+		CHECK(players[1]->get_bt_instance()->get_last_status() == BTTask::SUCCESS);
+	}
+
+	SUBCASE("Writes to the outer scope between updates aren't shared") {
+		// * Whichever player updates first turns the variable off for the other one.
+		for (BTPlayer *player : players) {
+			player->connect("updated", callable_mp(outer.ptr(), &Blackboard::set_var).bind("go", false).unbind(1));
+		}
+		BTScheduler::get_singleton()->update(0.1);
+		CHECK(BTScheduler::get_singleton()->get_shared_count() == 0);
+		const BT::Status first = players[0]->get_bt_instance()->get_last_status();
+		const BT::Status second = players[1]->get_bt_instance()->get_last_status();
+		CHECK(first != second);
+	}
+
+	SUBCASE("Players are registered once and can register again after compaction") {
+		BTScheduler *scheduler = BTScheduler::get_singleton();
+		const int count = scheduler->get_player_count();
+		scheduler->register_player(players[0]);
+		CHECK(scheduler->get_player_count() == count);
+		scheduler->unregister_player(players[0]);
+		scheduler->unregister_player(players[0]);
+		CHECK(scheduler->get_player_count() == count - 1);
+		scheduler->update(0.1); // * Compacts the entries.
+		scheduler->register_player(players[0]);
+		CHECK(scheduler->get_player_count() == count);
+		scheduler->unregister_player(players[1]);
+		CHECK(scheduler->get_player_count() == count - 1);
+		scheduler->register_player(players[1]);
+		CHECK(scheduler->get_player_count() == count);
+	}
+
+	memdelete(agent);
+}
+
+TEST_CASE("[SceneTree][LimboAI] BTScheduler shared updates of running tasks") {
+	BTScheduler *scheduler = BTScheduler::get_singleton();
+	REQUIRE(scheduler != nullptr);
+
+	Ref<BehaviorTree> bt = memnew(BehaviorTree);
+	Ref<BTWait> wait = memnew(BTWait);
+	wait->set_duration(10.0);
+	bt->set_root_task(wait);
+	bt->set_share_identical_updates(true);
+	bt->set_telemetry_enabled(true);
+
+	Node *agent = memnew(Node);
+	SceneTree::get_singleton()->get_root()->add_child(agent);
+	BTPlayer *first = _add_scheduled_player(agent, bt);
+	BTPlayer *second = _add_scheduled_player(agent, bt);
+	REQUIRE(first->get_bt_instance()->is_pure());
+
+	for (int i = 0; i < 3; i++) {
+		scheduler->update(0.1);
+		CHECK(scheduler->get_shared_count() == 1);
+	}
+	// * Taking over the state of a running task doesn't abort it, and counts the same work as ticking it.
+	CHECK(second->get_bt_instance()->get_root_task()->get_status() == BTTask::RUNNING);
+	CHECK(second->get_bt_instance()->get_root_task()->get_elapsed_time() == doctest::Approx(first->get_bt_instance()->get_root_task()->get_elapsed_time()));
+	CHECK(bt->get_telemetry()->get_counter(0, BTTelemetry::COUNTER_ABORTED) == 0);
+	CHECK(second->get_bt_instance()->get_last_update_task_count() == first->get_bt_instance()->get_last_update_task_count());
+	CHECK(second->get_bt_instance()->get_tick_count() == 3);
+
+	memdelete(agent);
+}
+
+TEST_CASE("[SceneTree][LimboAI] BTScheduler frame budget") {
+	ClassDB::register_class<BTSlowTestAction>();
+	BTScheduler *scheduler = BTScheduler::get_singleton();
+	REQUIRE(scheduler != nullptr);
+
+	Ref<BehaviorTree> bt = memnew(BehaviorTree);
+	bt->set_root_task(memnew(BTSlowTestAction));
+
+	Node *agent = memnew(Node);
+	SceneTree::get_singleton()->get_root()->add_child(agent);
+	// * A single slow update exceeds the budget.
+	scheduler->set_frame_budget_usec(BTSlowTestAction::DURATION_USEC / 2);
+
+	SUBCASE("Deferred players are updated in round-robin order") {
+		LocalVector<BTPlayer *> players;
+		for (int i = 0; i < 3; i++) {
+			BTPlayer *player = _add_scheduled_player(agent, bt);
+			player->set_priority(-1);
+			players.push_back(player);
+		}
+		for (int n = 1; n <= 3; n++) {
+			scheduler->update(0.1);
+			CHECK(scheduler->get_deferred_count() == 2);
+			int total = 0;
+			for (BTPlayer *player : players) {
+				CHECK(_get_slow_ticks(player) <= 1);
+				total += _get_slow_ticks(player);
+			}
+			CHECK(total == n);
+		}
+	}
+
+	SUBCASE("Guaranteed priority players are never deferred") {
+		BTPlayer *guaranteed = _add_scheduled_player(agent, bt);
+		BTPlayer *deferrable = _add_scheduled_player(agent, bt);
+		deferrable->set_priority(-1);
+		scheduler->update(0.1);
+		CHECK(_get_slow_ticks(guaranteed) == 1);
+		CHECK(_get_slow_ticks(deferrable) == 0);
+		CHECK(scheduler->get_deferred_count() == 1);
+		scheduler->update(0.1);
+		CHECK(_get_slow_ticks(guaranteed) == 2);
+		CHECK(_get_slow_ticks(deferrable) == 0);
+
+		// * Lowering the threshold makes the player guaranteed too.
+		scheduler->set_min_guaranteed_priority(-1);
+		scheduler->update(0.1);
+		CHECK(_get_slow_ticks(deferrable) == 1);
+		CHECK(scheduler->get_deferred_count() == 0);
+	}
+
+	SUBCASE("Players are deferred a limited number of times") {
+		scheduler->set_max_skipped_updates(1);
+		_add_scheduled_player(agent, bt);
+		BTPlayer *deferrable = _add_scheduled_player(agent, bt);
+		deferrable->set_priority(-1);
+		scheduler->update(0.1);
+		CHECK(_get_slow_ticks(deferrable) == 0);
+		scheduler->update(0.1);
+		CHECK(_get_slow_ticks(deferrable) == 1);
+		scheduler->update(0.1);
+		CHECK(_get_slow_ticks(deferrable) == 1);
+	}
+
+	scheduler->set_frame_budget_usec(0);
+	scheduler->set_min_guaranteed_priority(0);
+	scheduler->set_max_skipped_updates(0);
+	memdelete(agent);
+}
+
+TEST_CASE("[SceneTree][LimboAI] BTScheduler groups") {
+	ClassDB::register_class<BTSlowTestAction>();
+	BTScheduler *scheduler = BTScheduler::get_singleton();
+	REQUIRE(scheduler != nullptr);
+
+	Ref<BehaviorTree> bt = memnew(BehaviorTree);
+	bt->set_root_task(memnew(BTSlowTestAction));
+	Node *agent = memnew(Node);
+	SceneTree::get_singleton()->get_root()->add_child(agent);
+	BTPlayer *member = _add_scheduled_player(agent, bt);
+	member->add_to_group("scheduler_test_cell");
+	BTPlayer *other = _add_scheduled_player(agent, bt);
+	const int count = scheduler->get_player_count();
+
+	CHECK(scheduler->sleep_group("scheduler_test_cell") == 1);
+	CHECK(member->is_sleeping());
+	CHECK_FALSE(other->is_sleeping());
+	CHECK(scheduler->get_player_count() == count - 1);
+	// * Already sleeping players are not counted again.
+	CHECK(scheduler->sleep_group("scheduler_test_cell") == 0);
+	scheduler->update(0.1);
+	CHECK(_get_slow_ticks(member) == 0);
+	CHECK(_get_slow_ticks(other) == 1);
+
+	CHECK(scheduler->wake_group("scheduler_test_cell") == 1);
+	CHECK_FALSE(member->is_sleeping());
+	CHECK(scheduler->get_player_count() == count);
+	scheduler->update(0.1);
+	CHECK(_get_slow_ticks(member) == 1);
+	CHECK(_get_slow_ticks(other) == 2);
+
+	memdelete(agent);
+}
+
+TEST_CASE("[SceneTree][LimboAI] BTScheduler threads") {
+	if (!ClassDB::class_exists(BTThreadProbe::get_class_static())) {
+		LimboTaskDB::register_task<BTThreadProbe>();
+	}
+	BTScheduler *scheduler = BTScheduler::get_singleton();
+	REQUIRE(scheduler != nullptr);
+	scheduler->set_use_threads(true);
+	BTThreadProbe::worker_ticks.set(0);
+	BTThreadProbe::main_ticks.set(0);
+
+	Ref<BehaviorTree> bt = memnew(BehaviorTree);
+	bt->set_root_task(memnew(BTThreadProbe));
+	Node *agent = memnew(Node);
+	SceneTree::get_singleton()->get_root()->add_child(agent);
+
+	SUBCASE("Players with their own blackboards are ticked on worker threads") {
+		for (int i = 0; i < 3; i++) {
+			BTPlayer *player = _add_scheduled_player(agent, bt, memnew(Blackboard));
+			REQUIRE(player->get_bt_instance()->is_thread_safe());
+		}
+		scheduler->update(0.1);
+		CHECK(BTThreadProbe::worker_ticks.get() == 3);
+		CHECK(BTThreadProbe::main_ticks.get() == 0);
+	}
+
+	SUBCASE("Players sharing a blackboard are ticked by a single thread") {
+		Ref<Blackboard> shared = memnew(Blackboard);
+		for (int i = 0; i < 3; i++) {
+			_add_scheduled_player(agent, bt, shared);
+		}
+		scheduler->update(0.1);
+		CHECK(BTThreadProbe::worker_ticks.get() == 1);
+		CHECK(BTThreadProbe::main_ticks.get() == 2);
+	}
+
+	SUBCASE("Players with blackboard listeners stay on the main thread") {
+		Ref<Blackboard> bb = memnew(Blackboard);
+		bb->set_var("x", 0);
+		_add_scheduled_player(agent, bt, bb);
+		// * Added after the player was classified.
+		bb->add_var_listener("x", callable_mp(agent, &Node::queue_free));
+		scheduler->update(0.1);
+		CHECK(BTThreadProbe::worker_ticks.get() == 0);
+		CHECK(BTThreadProbe::main_ticks.get() == 1);
+		bb->remove_var_listener("x", callable_mp(agent, &Node::queue_free));
+	}
+
+	SUBCASE("Players with bound variables stay on the main thread") {
+		Ref<Blackboard> bb = memnew(Blackboard);
+		_add_scheduled_player(agent, bt, bb);
+		// * Bound after the player was classified - the property is accessed with Object::get() and set().
+		bb->bind_var_to_property("agent_name", agent, "name", true);
+		scheduler->update(0.1);
+		CHECK(BTThreadProbe::worker_ticks.get() == 0);
+		CHECK(BTThreadProbe::main_ticks.get() == 1);
+	}
+
+	SUBCASE("Queued players freed by a signal handler are not ticked") {
+		BTPlayer *threaded = _add_scheduled_player(agent, bt, memnew(Blackboard));
+		REQUIRE(threaded->get_bt_instance()->is_thread_safe());
+		// * Created after bt, so that the threaded player is queued before this one is updated on the main thread.
+		Ref<BehaviorTree> main_bt = memnew(BehaviorTree);
+		main_bt->set_root_task(memnew(BTThreadProbe));
+		Ref<Blackboard> bb = memnew(Blackboard);
+		bb->set_var("x", 0);
+		bb->add_var_listener("x", callable_mp(agent, &Node::queue_free));
+		BTPlayer *main_player = _add_scheduled_player(agent, main_bt, bb);
+		REQUIRE_FALSE(main_player->get_bt_instance()->is_thread_safe());
+		main_player->connect("updated", callable_mp_static(&_free_object).bind(threaded).unbind(1), Object::CONNECT_ONE_SHOT);
+
+		scheduler->update(0.1);
+		CHECK(BTThreadProbe::worker_ticks.get() == 0);
+		CHECK(BTThreadProbe::main_ticks.get() == 1);
+		bb->remove_var_listener("x", callable_mp(agent, &Node::queue_free));
+	}
+
+	SUBCASE("Calls made on worker threads are applied after the batches") {
+		Ref<BehaviorTree> call_bt = memnew(BehaviorTree);
+		Ref<BTSequence> seq = memnew(BTSequence);
+		seq->add_child(memnew(BTThreadProbe));
+		Ref<BTCallMethod> call = memnew(BTCallMethod);
+		Ref<BBNode> node_param = memnew(BBNode);
+		node_param->set_value_source(BBParam::BLACKBOARD_VAR);
+		node_param->set_variable("object");
+		call->set_node_param(node_param);
+		call->set_method("callback");
+		seq->add_child(call);
+		call_bt->set_root_task(seq);
+
+		Ref<CallbackCounter> counter = memnew(CallbackCounter);
+		for (int i = 0; i < 3; i++) {
+			Ref<Blackboard> bb = memnew(Blackboard);
+			bb->set_var("object", counter);
+			BTPlayer *player = _add_scheduled_player(agent, call_bt, bb);
+			REQUIRE(player->get_bt_instance()->is_thread_safe());
+		}
+		scheduler->update(0.1);
+		CHECK(BTThreadProbe::worker_ticks.get() == 3);
+		CHECK(counter->num_callbacks == 3);
+	}
+
+	scheduler->set_use_threads(false);
+	memdelete(agent);
+}
+
+} //namespace TestScheduler
+
+#endif // TEST_SCHEDULER_H
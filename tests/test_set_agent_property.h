@@ -21,6 +21,7 @@
 #include "modules/limboai/bt/tasks/scene/bt_set_agent_property.h"
 
 #include "core/os/memory.h"
+#include "scene/2d/node_2d.h"
 
 namespace TestSetAgentProperty {
 
@@ -40,6 +41,11 @@ TEST_CASE("[Modules][LimboAI] BTSetAgentProperty") {
 		CHECK(sap->execute(0.01666) == BTTask::SUCCESS);
 		CHECK(agent->get_process_priority() == 7);
 	}
+	SUBCASE("Only plain assignments can be ticked on worker threads") {
+		CHECK(sap->can_tick_on_worker_thread());
+		sap->set_operation(LimboUtility::OPERATION_ADDITION);
+		CHECK_FALSE(sap->can_tick_on_worker_thread());
+	}
 	SUBCASE("When value is not set") {
 		sap->set_value(nullptr);
 		ERR_PRINT_OFF;
@@ -64,6 +70,24 @@ TEST_CASE("[Modules][LimboAI] BTSetAgentProperty") {
 		CHECK(sap->execute(0.01666) == BTTask::SUCCESS);
 		CHECK(agent->get_name() == "TestName");
 	}
+	SUBCASE("With indexed property") {
+		Node2D *agent_2d = memnew(Node2D);
+		sap->initialize(agent_2d, bb, agent_2d);
+		sap->set_property("position:y");
+		value->set_saved_value(5.0);
+		CHECK(sap->execute(0.01666) == BTTask::SUCCESS);
+		CHECK(agent_2d->get_position() == Vector2(0, 5));
+
+		sap->set_operation(LimboUtility::OPERATION_ADDITION);
+		CHECK(sap->execute(0.01666) == BTTask::SUCCESS);
+		CHECK(agent_2d->get_position() == Vector2(0, 10));
+
+		sap->set_property("position:w");
+		ERR_PRINT_OFF;
+		CHECK(sap->execute(0.01666) == BTTask::FAILURE);
+		ERR_PRINT_ON;
+		memdelete(agent_2d);
+	}
 	SUBCASE("With blackboard variable") {
 		value->set_value_source(BBParam::BLACKBOARD_VAR);
 		value->set_variable("priority");
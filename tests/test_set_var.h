@@ -43,6 +43,14 @@ TEST_CASE("[Modules][LimboAI] BTSetVar") {
 		sv->set_value(value);
 		sv->set_variable("var");
 
+		SUBCASE("When cloned at runtime") {
+			// * Task configuration, such as a parameter with a saved value, is shared between runtime clones.
+			Ref<BTSetVar> cloned = sv->clone();
+			REQUIRE(cloned.is_valid());
+			CHECK_FALSE(cloned == sv);
+			CHECK(cloned->get_value() == value);
+			CHECK(cloned->get_variable() == sv->get_variable());
+		}
 		SUBCASE("When assigning a raw value") {
 			value->set_value_source(BBParam::SAVED_VALUE);
 			value->set_saved_value(123);
@@ -159,6 +167,38 @@ TEST_CASE("[Modules][LimboAI] BTSetVar") {
 			ERR_PRINT_ON;
 			CHECK(bb->get_var("var", 0) == Variant(2));
 		}
+		SUBCASE("Performing element-wise operations on packed arrays.") {
+			PackedFloat32Array scores;
+			scores.push_back(1.0);
+			scores.push_back(2.0);
+			bb->set_var("var", scores);
+			value->set_value_source(BBParam::SAVED_VALUE);
+
+			value->set_saved_value(2.0);
+			sv->set_operation(LimboUtility::OPERATION_MULTIPLICATION);
+			CHECK(sv->execute(0.01666) == BTTask::SUCCESS);
+			PackedFloat32Array result = bb->get_var("var");
+			REQUIRE(result.size() == 2);
+			CHECK(result[0] == doctest::Approx(2.0));
+			CHECK(result[1] == doctest::Approx(4.0));
+			CHECK(scores[0] == doctest::Approx(1.0)); // * Copy-on-write: the original array is not modified.
+
+			value->set_saved_value(scores);
+			sv->set_operation(LimboUtility::OPERATION_ADDITION);
+			CHECK(sv->execute(0.01666) == BTTask::SUCCESS);
+			result = bb->get_var("var");
+			REQUIRE(result.size() == 2);
+			CHECK(result[0] == doctest::Approx(3.0));
+			CHECK(result[1] == doctest::Approx(6.0));
+
+			PackedVector3Array positions;
+			positions.push_back(Vector3(1, 2, 3));
+			bb->set_var("var", positions);
+			value->set_saved_value(Vector3(1, 1, 1));
+			sv->set_operation(LimboUtility::OPERATION_SUBTRACTION);
+			CHECK(sv->execute(0.01666) == BTTask::SUCCESS);
+			CHECK(PackedVector3Array(bb->get_var("var"))[0] == Vector3(0, 1, 2));
+		}
 	}
 }
 
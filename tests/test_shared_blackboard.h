@@ -0,0 +1,107 @@
+/**
+ * test_shared_blackboard.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef TEST_SHARED_BLACKBOARD_H
+#define TEST_SHARED_BLACKBOARD_H
+
+#include "limbo_test.h"
+
+#include "modules/limboai/blackboard/blackboard.h"
+#include "modules/limboai/blackboard/shared_blackboard.h"
+
+namespace TestSharedBlackboard {
+
+TEST_CASE("[Modules][LimboAI] SharedBlackboard") {
+	Ref<SharedBlackboard> shared = memnew(SharedBlackboard);
+	Variant not_found("not_found");
+
+	SUBCASE("Writes are visible only after publishing") {
+		shared->set_var("target", 1);
+		shared->set_var("target", 2);
+		CHECK_FALSE(shared->has_var("target"));
+		CHECK(shared->get_pending_write_count() == 2);
+
+		CHECK(shared->publish() == 2);
+		CHECK(shared->get_var("target", not_found) == Variant(2));
+		CHECK(shared->get_pending_write_count() == 0);
+		CHECK(shared->get_publish_count() == 1);
+
+		shared->set_var("target", 3);
+		CHECK(shared->get_var("target", not_found) == Variant(2));
+		shared->publish();
+		CHECK(shared->get_var("target", not_found) == Variant(3));
+		CHECK(shared->list_vars().size() == 1);
+
+		// * Nothing to apply.
+		CHECK(shared->publish() == 0);
+		CHECK(shared->get_publish_count() == 2);
+	}
+
+	SUBCASE("Bound blackboard variables read published values") {
+		shared->set_var("alert", false);
+		shared->publish();
+		Ref<Blackboard> bb = memnew(Blackboard);
+		shared->bind_to(bb, "alert");
+		CHECK(bb->get_var("alert", not_found) == Variant(false));
+
+		shared->set_var("alert", true);
+		CHECK(bb->get_var("alert", not_found) == Variant(false));
+		shared->publish();
+		CHECK(bb->get_var("alert", not_found) == Variant(true));
+
+		// * Writes through the blackboard are queued.
+		bb->set_var("alert", false);
+		CHECK(shared->get_pending_write_count() == 1);
+		shared->publish();
+		CHECK(shared->get_var("alert", not_found) == Variant(false));
+	}
+
+	SUBCASE("Versions count the applied writes") {
+		CHECK(shared->get_var_version("alarm") == -1);
+		CHECK(shared->get_var_slot("alarm") == -1);
+		shared->set_var("alarm", false);
+		shared->publish();
+		CHECK(shared->get_var_version("alarm") == 1);
+		const int slot = shared->get_var_slot("alarm");
+		REQUIRE(slot != -1);
+
+		shared->set_var("time", 0.5);
+		shared->set_var("alarm", true);
+		shared->publish();
+		CHECK(shared->get_var_version("alarm") == 2);
+		CHECK(shared->get_var_version("time") == 1);
+		CHECK(shared->get_var_slot("alarm") == slot);
+		CHECK(shared->get_var_by_slot(slot) == Variant(true));
+		CHECK(shared->get_version_by_slot(slot) == 2);
+	}
+
+	SUBCASE("World blackboard is a single instance") {
+		Ref<SharedBlackboard> world = SharedBlackboard::get_world();
+		REQUIRE(world.is_valid());
+		CHECK(SharedBlackboard::get_world() == world);
+		world->set_var("is_night", true);
+		world->publish();
+		CHECK(SharedBlackboard::get_world()->get_var("is_night", not_found) == Variant(true));
+		SharedBlackboard::free_world();
+	}
+
+	SUBCASE("Binding a variable that is not published fails") {
+		Ref<Blackboard> bb = memnew(Blackboard);
+		ERR_PRINT_OFF;
+		shared->bind_to(bb, "missing");
+		ERR_PRINT_ON;
+		CHECK_FALSE(bb->has_var("missing"));
+	}
+}
+
+} //namespace TestSharedBlackboard
+
+#endif // TEST_SHARED_BLACKBOARD_H
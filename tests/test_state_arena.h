@@ -0,0 +1,79 @@
+/**
+ * test_state_arena.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef TEST_STATE_ARENA_H
+#define TEST_STATE_ARENA_H
+
+#include "limbo_test.h"
+
+#include "modules/limboai/bt/bt_state_arena.h"
+
+namespace TestStateArena {
+
+TEST_CASE("[Modules][LimboAI] BTStateArena") {
+	BTStateArena *arena = BTStateArena::create(3);
+	REQUIRE(arena != nullptr);
+
+	BTTask::State *a = arena->allocate();
+	BTTask::State *b = arena->allocate();
+	BTTask::State *c = arena->allocate();
+	CHECK(b == a + 3);
+	CHECK(c == b + 3);
+	CHECK(arena->get_allocated_blocks() == 3);
+
+	SUBCASE("Freed blocks are reused lowest first, reset to defaults") {
+		b[1].status = BTTask::RUNNING;
+		arena->free(c);
+		arena->free(b);
+		BTTask::State *d = arena->allocate();
+		CHECK(d == b);
+		CHECK(d[1].status == BTTask::FRESH);
+		arena->free(d);
+	}
+
+	SUBCASE("New slabs are added when full") {
+		LocalVector<BTTask::State *> blocks;
+		for (uint32_t i = 3; i < BTStateArena::BLOCKS_PER_SLAB + 1; i++) {
+			blocks.push_back(arena->allocate());
+		}
+		CHECK(arena->get_slab_count() == 2);
+		for (BTTask::State *block : blocks) {
+			arena->free(block);
+		}
+		arena->free(c);
+		arena->free(b);
+	}
+
+	SUBCASE("Empty slabs are released, except for one") {
+		LocalVector<BTTask::State *> blocks;
+		for (uint32_t i = 3; i < 3 * BTStateArena::BLOCKS_PER_SLAB; i++) {
+			blocks.push_back(arena->allocate());
+		}
+		CHECK(arena->get_slab_count() == 3);
+		for (BTTask::State *block : blocks) {
+			arena->free(block);
+		}
+		// * The first slab still holds a, b and c.
+		CHECK(arena->get_slab_count() == 2);
+		CHECK(arena->allocate() == c + 3);
+		arena->free(c + 3);
+		arena->free(c);
+		arena->free(b);
+	}
+
+	arena->free(a);
+	CHECK(arena->get_allocated_blocks() == 0);
+	arena->unreference();
+}
+
+} //namespace TestStateArena
+
+#endif // TEST_STATE_ARENA_H
@@ -68,6 +68,34 @@ TEST_CASE("[SceneTree][LimboAI] BTStopAnimation") {
 		}
 	}
 
+	SUBCASE("When AnimationPlayer is in a blackboard variable") {
+		player_param->set_value_source(BBParam::BLACKBOARD_VAR);
+		player_param->set_variable("player");
+		bb->set_var("player", player);
+		sa->initialize(dummy, bb, dummy);
+
+		player->play("test");
+		CHECK(sa->execute(0.01666) == BTTask::SUCCESS);
+		CHECK_FALSE(player->is_playing());
+
+		// * Resolved again after the variable changes.
+		AnimationPlayer *other = memnew(AnimationPlayer);
+		SceneTree::get_singleton()->get_root()->add_child(other);
+		REQUIRE(other->add_animation_library("", anim_lib) == OK);
+		bb->set_var("player", other);
+		other->play("test");
+		player->play("test");
+		CHECK(sa->execute(0.01666) == BTTask::SUCCESS);
+		CHECK_FALSE(other->is_playing());
+		CHECK(player->is_playing());
+
+		// * Fails instead of accessing a freed player.
+		memdelete(other);
+		ERR_PRINT_OFF;
+		CHECK(sa->execute(0.01666) == BTTask::FAILURE);
+		ERR_PRINT_ON;
+	}
+
 	memdelete(dummy);
 	memdelete(player);
 }
@@ -16,7 +16,9 @@
 
 #include "modules/limboai/bt/behavior_tree.h"
 #include "modules/limboai/bt/tasks/bt_task.h"
+#include "modules/limboai/bt/tasks/composites/bt_sequence.h"
 #include "modules/limboai/bt/tasks/decorators/bt_subtree.h"
+#include "modules/limboai/util/limbo_timer_wheel.h"
 
 namespace TestSubtree {
 
@@ -65,6 +67,74 @@ TEST_CASE("[Modules][LimboAI] BTSubtree") {
 		}
 	}
 
+	SUBCASE("With a cached template") {
+		Ref<BehaviorTree> shared = memnew(BehaviorTree);
+		shared->set_root_task(memnew(BTTestAction(BTTask::SUCCESS)));
+		shared->set_cache_template(true);
+
+		Ref<BehaviorTree> bt = memnew(BehaviorTree);
+		Ref<BTSequence> seq = memnew(BTSequence);
+		for (int i = 0; i < 2; i++) {
+			Ref<BTSubtree> ref = memnew(BTSubtree);
+			ref->set_subtree(shared);
+			seq->add_child(ref);
+		}
+		bt->set_root_task(seq);
+		bt->set_cache_template(true);
+
+		// * Built once, with the subtrees already expanded.
+		Ref<BTTask> tmpl = bt->get_instance_template();
+		CHECK(tmpl == bt->get_instance_template());
+		CHECK(tmpl != seq);
+		CHECK(tmpl->get_child(0)->get_child_count() == 1);
+
+		Ref<BTInstance> inst1 = bt->instantiate(dummy, bb, dummy, dummy);
+		Ref<BTInstance> inst2 = bt->instantiate(dummy, bb, dummy, dummy);
+		Ref<BTTask> leaf1 = inst1->get_root_task()->get_child(0)->get_child(0);
+		Ref<BTTask> leaf2 = inst2->get_root_task()->get_child(0)->get_child(0);
+		REQUIRE(leaf1.is_valid());
+		REQUIRE(leaf2.is_valid());
+		CHECK(leaf1 != leaf2);
+		CHECK(inst1->get_root_task()->get_child(1)->get_child_count() == 1);
+		CHECK(inst1->update(0.01666) == BTTask::SUCCESS);
+
+		bt->set_root_task(memnew(BTSequence));
+		CHECK(bt->get_instance_template() != tmpl); // * invalidated
+	}
+
+	SUBCASE("Lazy") {
+		Ref<BehaviorTree> bt = memnew(BehaviorTree);
+		Ref<BTTestAction> task = memnew(BTTestAction(BTTask::SUCCESS));
+		bt->set_root_task(task);
+		st->set_subtree(bt);
+		st->set_lazy(true);
+		st->set_release_delay(1.0);
+
+		st->initialize(dummy, bb, dummy);
+		CHECK(st->get_child_count() == 0); // * not cloned until ticked
+
+		CHECK(st->execute(0.01666) == BTTask::SUCCESS);
+		REQUIRE(st->get_child_count() == 1);
+		Ref<BTTestAction> ta = st->get_child(0);
+		REQUIRE(ta.is_valid());
+		CHECK(ta->get_agent() == dummy);
+		CHECK_ENTRIES_TICKS_EXITS(ta, 1, 1, 1);
+
+		// * Entering again before the delay elapses keeps the clone.
+		LimboTimerWheel::process(0.5, false);
+		CHECK(st->execute(0.01666) == BTTask::SUCCESS);
+		LimboTimerWheel::process(0.6, false);
+		CHECK(st->get_child_count() == 1);
+		CHECK(st->get_child(0) == ta);
+
+		LimboTimerWheel::process(0.5, false);
+		CHECK(st->get_child_count() == 0); // * released
+
+		CHECK(st->execute(0.01666) == BTTask::SUCCESS);
+		CHECK(st->get_child_count() == 1);
+		CHECK(st->get_child(0) != ta);
+	}
+
 	memdelete(dummy);
 }
 
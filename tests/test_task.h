@@ -15,7 +15,9 @@
 #include "limbo_test.h"
 
 #include "modules/limboai/blackboard/blackboard.h"
+#include "modules/limboai/bt/bt_instance.h"
 #include "modules/limboai/bt/tasks/bt_task.h"
+#include "modules/limboai/bt/tasks/utility/bt_wait.h"
 #include "tests/test_macros.h"
 
 namespace TestTask {
@@ -172,11 +174,39 @@ TEST_CASE("[Modules][LimboAI] BTTask") {
 				CHECK(child3->get_agent() == dummy);
 				CHECK(child3->get_blackboard() == bb);
 			}
+			SUBCASE("With set_agent() on a task sharing the context") {
+				Node *other = memnew(Node);
+				task->initialize(dummy, bb, dummy);
+				child2->set_agent(other);
+				CHECK(child2->get_agent() == other);
+				CHECK(child2->get_blackboard() == bb);
+				CHECK(child2->get_scene_root() == dummy);
+				CHECK(task->get_agent() == dummy);
+				CHECK(child1->get_agent() == dummy);
+				CHECK(child3->get_agent() == dummy);
+				memdelete(other);
+			}
+			SUBCASE("With a new scope in a child") {
+				Ref<Blackboard> scope = memnew(Blackboard);
+				scope->set_parent(bb);
+				task->initialize(dummy, bb, dummy);
+				child1->initialize(dummy, scope, dummy);
+				CHECK(child1->get_blackboard() == scope);
+				CHECK(task->get_blackboard() == bb);
+				CHECK(child2->get_blackboard() == bb);
+			}
 			SUBCASE("Test if not crashes when agent is null") {
 				ERR_PRINT_OFF;
 				task->initialize(nullptr, bb, dummy);
 				ERR_PRINT_ON;
 			}
+			SUBCASE("Headless, without agent and scene root") {
+				task->initialize(nullptr, bb, nullptr);
+				CHECK(task->get_agent() == nullptr);
+				CHECK(task->get_scene_root() == nullptr);
+				CHECK(task->get_blackboard() == bb);
+				CHECK(child3->get_blackboard() == bb);
+			}
 			SUBCASE("Test if not crashes when scene_owner is null") {
 				ERR_PRINT_OFF;
 				task->initialize(dummy, bb, nullptr);
@@ -233,6 +263,82 @@ TEST_CASE("[Modules][LimboAI] BTTask") {
 		CHECK_FALSE(cloned->get_child(0) == child1);
 		CHECK_FALSE(cloned->get_child(1) == child2);
 	}
+	SUBCASE("Test get_task_name() caching") {
+		Ref<BTWait> wait = memnew(BTWait);
+		wait->set_duration(1.0);
+		const String name = wait->get_task_name();
+		CHECK(wait->get_task_name() == name);
+
+		// * Setters emit "changed", which invalidates the cached name.
+		wait->set_duration(2.0);
+		CHECK(wait->get_task_name() != name);
+
+		wait->set_custom_name("Pause");
+		CHECK(wait->get_task_name() == "Pause");
+		wait->set_custom_name("");
+		CHECK(wait->get_task_name() != "Pause");
+	}
+	SUBCASE("Test children property with shared tasks") {
+		Ref<BTTestAction> parent1 = memnew(BTTestAction);
+		Ref<BTTestAction> parent2 = memnew(BTTestAction);
+		Ref<BTTestAction> shared = memnew(BTTestAction);
+		Array children;
+		children.push_back(shared);
+		parent1->set("children", children);
+		parent2->set("children", children);
+
+		// * At runtime, the task is shared and remains owned by its first parent.
+		REQUIRE(parent2->get_child_count() == 1);
+		CHECK(parent2->get_child(0) == shared);
+		CHECK(shared->get_parent() == parent1);
+		CHECK(shared->get_index() == 0);
+
+		// * Removing it from a parent that doesn't own it keeps the owner.
+		parent2->remove_child_at_index(0);
+		CHECK(shared->get_parent() == parent1);
+
+		// * Clones get their own copies.
+		parent2->set("children", children);
+		Ref<BTTestAction> cloned = parent2->clone();
+		REQUIRE(cloned->get_child_count() == 1);
+		CHECK_FALSE(cloned->get_child(0) == shared);
+		CHECK(cloned->get_child(0)->get_parent() == cloned);
+
+		// * Only clones can be executed by an instance.
+		ERR_PRINT_OFF;
+		CHECK(BTInstance::create(parent2, "", nullptr).is_null());
+		ERR_PRINT_ON;
+		CHECK(BTInstance::create(cloned, "", nullptr).is_valid());
+
+		// * Replaced children are released and can be adopted without cloning.
+		parent1->set("children", Array());
+		CHECK(shared->get_parent() == nullptr);
+		Ref<BTTestAction> parent3 = memnew(BTTestAction);
+		parent3->set("children", children);
+		CHECK(parent3->get_child(0) == shared);
+		CHECK(shared->get_parent() == parent3);
+	}
+
+	SUBCASE("Runtime clones skip the changed signal") {
+		Ref<BTWait> wait = memnew(BTWait);
+		wait->set_duration(1.0);
+		Ref<BTTask> seq = memnew(BTTask);
+		seq->add_child(wait);
+		Ref<BTTask> cloned = seq->clone();
+		CHECK(cloned->is_runtime_clone());
+		Ref<BTWait> cloned_wait = cloned->get_child(0);
+		REQUIRE(cloned_wait.is_valid());
+		CHECK(cloned_wait->is_runtime_clone());
+		CHECK_FALSE(wait->is_runtime_clone());
+
+		// * The cached name is still invalidated by setters.
+		const String name = cloned_wait->get_task_name();
+		cloned_wait->set_duration(2.0);
+		CHECK(cloned_wait->get_task_name() != name);
+		List<Object::Connection> connections;
+		cloned_wait->get_signal_connection_list("changed", &connections);
+		CHECK(connections.is_empty());
+	}
 }
 
 } //namespace TestTask
@@ -0,0 +1,177 @@
+/**
+ * test_utility_selector.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef TEST_UTILITY_SELECTOR_H
+#define TEST_UTILITY_SELECTOR_H
+
+#include "limbo_test.h"
+
+#include "modules/limboai/bt/behavior_tree.h"
+#include "modules/limboai/bt/bt_player.h"
+#include "modules/limboai/bt/bt_scheduler.h"
+#include "modules/limboai/bt/tasks/bt_task.h"
+#include "modules/limboai/bt/tasks/composites/bt_consideration.h"
+#include "modules/limboai/bt/tasks/composites/bt_utility_selector.h"
+
+#include "scene/main/window.h"
+
+namespace TestUtilitySelector {
+
+TypedArray<BTConsideration> make_considerations(const StringName &p_variable) {
+	Ref<BTConsideration> consideration = memnew(BTConsideration);
+	consideration->set_variable(p_variable);
+	TypedArray<BTConsideration> considerations;
+	considerations.push_back(consideration);
+	return considerations;
+}
+
+TEST_CASE("[Modules][LimboAI] BTUtilitySelector") {
+	Ref<BTUtilitySelector> sel = memnew(BTUtilitySelector);
+	Ref<BTTestAction> eat = memnew(BTTestAction);
+	Ref<BTTestAction> sleep = memnew(BTTestAction);
+	Ref<BTTestAction> idle = memnew(BTTestAction); // * No considerations - never selected.
+	sel->add_child(eat);
+	sel->add_child(sleep);
+	sel->add_child(idle);
+	sel->set_considerations(0, make_considerations("hunger"));
+	sel->set_considerations(1, make_considerations("fatigue"));
+	sel->set_reevaluation_interval(0.5);
+
+	Node *dummy = memnew(Node);
+	Ref<Blackboard> bb = memnew(Blackboard);
+	bb->set_var("hunger", 0.8);
+	bb->set_var("fatigue", 0.3);
+	sel->initialize(dummy, bb, dummy);
+
+	SUBCASE("Executes the child with the highest score") {
+		eat->ret_status = BTTask::SUCCESS;
+		CHECK(sel->execute(0.1) == BTTask::SUCCESS);
+		CHECK(sel->get_score(0) == doctest::Approx(0.8));
+		CHECK(sel->get_score(1) == doctest::Approx(0.3));
+		CHECK(sel->get_score(2) == 0.0);
+		CHECK_STATUS_ENTRIES_TICKS_EXITS(eat, BTTask::SUCCESS, 1, 1, 1);
+		CHECK_STATUS_ENTRIES_TICKS_EXITS(sleep, BTTask::FRESH, 0, 0, 0);
+	}
+
+	SUBCASE("Considerations are mapped through the curve") {
+		Ref<Curve> inverse = memnew(Curve);
+		inverse->add_point(Vector2(0.0, 1.0), 0.0, -1.0);
+		inverse->add_point(Vector2(1.0, 0.0), -1.0, 0.0);
+		TypedArray<BTConsideration> considerations = make_considerations("hunger");
+		Ref<BTConsideration>(considerations[0])->set_curve(inverse);
+		sel->set_considerations(0, considerations);
+		CHECK(Ref<BTConsideration>(considerations[0])->evaluate(0.8) == doctest::Approx(0.2).epsilon(0.01));
+
+		sleep->ret_status = BTTask::SUCCESS;
+		CHECK(sel->execute(0.1) == BTTask::SUCCESS);
+		CHECK(sel->get_score(0) == doctest::Approx(0.2).epsilon(0.01));
+		CHECK_STATUS_ENTRIES_TICKS_EXITS(sleep, BTTask::SUCCESS, 1, 1, 1);
+	}
+
+	SUBCASE("Switches to a better child only when reevaluating") {
+		eat->ret_status = BTTask::RUNNING;
+		sleep->ret_status = BTTask::RUNNING;
+		CHECK(sel->execute(0.1) == BTTask::RUNNING);
+		CHECK(sel->get_selected_index() == 0);
+
+		bb->set_var("fatigue", 0.9);
+		CHECK(sel->execute(0.1) == BTTask::RUNNING);
+		CHECK(sel->get_selected_index() == 0);
+		CHECK_STATUS_ENTRIES_TICKS_EXITS(sleep, BTTask::FRESH, 0, 0, 0);
+
+		CHECK(sel->execute(0.4) == BTTask::RUNNING);
+		CHECK(sel->get_selected_index() == 1);
+		CHECK(eat->get_status() == BTTask::FRESH);
+		CHECK_STATUS_ENTRIES_TICKS_EXITS(sleep, BTTask::RUNNING, 1, 1, 0);
+	}
+
+	SUBCASE("Falls back to the next best child on failure") {
+		eat->ret_status = BTTask::FAILURE;
+		sleep->ret_status = BTTask::SUCCESS;
+		CHECK(sel->execute(0.1) == BTTask::SUCCESS);
+		CHECK_STATUS_ENTRIES_TICKS_EXITS(eat, BTTask::FAILURE, 1, 1, 1);
+		CHECK_STATUS_ENTRIES_TICKS_EXITS(sleep, BTTask::SUCCESS, 1, 1, 1);
+		CHECK_STATUS_ENTRIES_TICKS_EXITS(idle, BTTask::FRESH, 0, 0, 0);
+
+		sleep->ret_status = BTTask::FAILURE;
+		CHECK(sel->execute(0.1) == BTTask::FAILURE);
+	}
+
+	memdelete(dummy);
+}
+
+TEST_CASE("[SceneTree][LimboAI] BTUtilitySelector batches") {
+	BTScheduler *scheduler = BTScheduler::get_singleton();
+	REQUIRE(scheduler != nullptr);
+
+	Ref<BTUtilitySelector> sel = memnew(BTUtilitySelector);
+	sel->add_child(memnew(BTTestAction(BTTask::RUNNING)));
+	sel->add_child(memnew(BTTestAction(BTTask::RUNNING)));
+	sel->set_considerations(0, make_considerations("hunger"));
+	sel->set_considerations(1, make_considerations("fatigue"));
+	sel->set_reevaluation_interval(0.5);
+	Ref<BehaviorTree> bt = memnew(BehaviorTree);
+	bt->set_root_task(sel);
+
+	Node *agent = memnew(Node);
+	SceneTree::get_singleton()->get_root()->add_child(agent);
+	LocalVector<BTPlayer *> players;
+	const BTPlayer::UpdateMode modes[] = { BTPlayer::UpdateMode::SCHEDULED, BTPlayer::UpdateMode::SCHEDULED, BTPlayer::UpdateMode::MANUAL };
+	for (const BTPlayer::UpdateMode mode : modes) {
+		BTPlayer *player = memnew(BTPlayer);
+		Ref<Blackboard> bb = memnew(Blackboard);
+		bb->set_var("hunger", 0.8);
+		bb->set_var("fatigue", 0.3);
+		player->set_blackboard(bb);
+		player->set_behavior_tree(bt);
+		player->set_update_mode(mode);
+		agent->add_child(player);
+		player->set_owner(agent);
+		REQUIRE(player->get_bt_instance().is_valid());
+		players.push_back(player);
+	}
+	Ref<BTUtilitySelector> scheduled1 = players[0]->get_bt_instance()->get_root_task();
+	Ref<BTUtilitySelector> scheduled2 = players[1]->get_bt_instance()->get_root_task();
+	Ref<BTUtilitySelector> manual = players[2]->get_bt_instance()->get_root_task();
+	REQUIRE(scheduled1.is_valid());
+
+	// * Reevaluated every update from now on.
+	scheduler->update(0.5);
+	players[2]->update(0.5);
+	CHECK(scheduled1->get_selected_index() == 0);
+	CHECK(scheduled2->get_selected_index() == 0);
+	CHECK(manual->get_selected_index() == 0);
+
+	// * The scheduled players are due on the next update: scores are computed in one batch at its start, before any
+	// tree is ticked. The manual one isn't part of the batch.
+	for (BTPlayer *player : players) {
+		player->get_blackboard()->set_var("fatigue", 0.9);
+	}
+	BTUtilitySelector::prepare_batches();
+	CHECK(scheduled1->get_score(1) == doctest::Approx(0.9));
+	CHECK(scheduled2->get_score(1) == doctest::Approx(0.9));
+	CHECK(manual->get_score(1) == doctest::Approx(0.3));
+	BTUtilitySelector::finish_batches();
+
+	// * Manual trees are scored on tick, even if the scheduler prepared a batch before.
+	scheduler->update(0.5);
+	players[2]->update(0.5);
+	CHECK(scheduled1->get_selected_index() == 1);
+	CHECK(scheduled2->get_selected_index() == 1);
+	CHECK(manual->get_selected_index() == 1);
+	CHECK(manual->get_score(1) == doctest::Approx(0.9));
+
+	memdelete(agent);
+}
+
+} //namespace TestUtilitySelector
+
+#endif // TEST_UTILITY_SELECTOR_H
@@ -0,0 +1,99 @@
+/**
+ * limbo_error_reporter.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "limbo_error_reporter.h"
+
+#include "limbo_compat.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/config/project_settings.h"
+#include "core/os/time.h"
+#include "core/templates/hashfuncs.h"
+#include "main/performance.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/performance.hpp>
+#include <godot_cpp/classes/project_settings.hpp>
+#include <godot_cpp/classes/time.hpp>
+#include <godot_cpp/templates/hashfuncs.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+SpinLock LimboErrorReporter::lock;
+HashMap<uint64_t, LimboErrorReporter::Entry> LimboErrorReporter::entries;
+SafeNumeric<uint64_t> LimboErrorReporter::error_count;
+SafeNumeric<uint64_t> LimboErrorReporter::suppressed_count;
+uint32_t LimboErrorReporter::max_per_second = 10;
+uint64_t LimboErrorReporter::window_start_msec = 0;
+uint32_t LimboErrorReporter::window_reports = 0;
+bool LimboErrorReporter::monitors_added = false;
+
+void LimboErrorReporter::initialize() {
+	max_per_second = MAX(0, int(GLOBAL_DEF(PropertyInfo(Variant::INT, "limbo_ai/behavior_tree/max_errors_per_second", PROPERTY_HINT_RANGE, "0,1000,1,or_greater"), 10)));
+}
+
+void LimboErrorReporter::ensure_monitors() {
+	Performance *perf = Performance::get_singleton();
+	if (likely(monitors_added) || perf == nullptr) {
+		return;
+	}
+	monitors_added = true;
+	if (!perf->has_custom_monitor("LimboAI/task_errors")) {
+		PERFORMANCE_ADD_CUSTOM_MONITOR("LimboAI/task_errors", callable_mp_static(&LimboErrorReporter::_get_error_count));
+		PERFORMANCE_ADD_CUSTOM_MONITOR("LimboAI/task_errors_suppressed", callable_mp_static(&LimboErrorReporter::_get_suppressed_count));
+	}
+}
+
+bool LimboErrorReporter::should_report(uint64_t p_source_key, const char *p_file, int p_line, uint64_t &r_repeats) {
+	error_count.increment();
+	const uint64_t key = hash_murmur3_one_64(uint64_t(p_line), hash_murmur3_one_64(uint64_t(p_file), hash_murmur3_one_64(p_source_key)));
+	const uint64_t now = Time::get_singleton()->get_ticks_msec();
+
+	lock.lock();
+	Entry &entry = entries[key];
+	entry.unreported += 1;
+	bool report = !entry.reported || now - entry.last_report_msec >= REPEAT_INTERVAL_MSEC;
+	if (report) {
+		if (now - window_start_msec >= 1000) {
+			window_start_msec = now;
+			window_reports = 0;
+		}
+		report = window_reports < max_per_second;
+	}
+	if (report) {
+		window_reports += 1;
+		r_repeats = entry.unreported;
+		entry.unreported = 0;
+		entry.last_report_msec = now;
+		entry.reported = true;
+	}
+	lock.unlock();
+
+	if (!report) {
+		suppressed_count.increment();
+	}
+	return report;
+}
+
+void LimboErrorReporter::print(const char *p_function, const char *p_file, int p_line, const String &p_message, uint64_t p_repeats) {
+	if (p_repeats > 1) {
+		_err_print_error(p_function, p_file, p_line, vformat("%s (repeated %d times)", p_message, p_repeats));
+	} else {
+		_err_print_error(p_function, p_file, p_line, p_message);
+	}
+}
+
+void LimboErrorReporter::clear() {
+	lock.lock();
+	entries.clear();
+	window_reports = 0;
+	lock.unlock();
+}
@@ -0,0 +1,116 @@
+/**
+ * limbo_error_reporter.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef LIMBO_ERROR_REPORTER_H
+#define LIMBO_ERROR_REPORTER_H
+
+#ifdef LIMBOAI_MODULE
+#include "core/object/object.h"
+#include "core/os/spin_lock.h"
+#include "core/string/ustring.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/safe_refcount.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/core/object.hpp>
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/safe_refcount.hpp>
+#include <godot_cpp/templates/spin_lock.hpp>
+#include <godot_cpp/variant/string.hpp>
+using namespace godot;
+#endif // LIMBOAI_GDEXTENSION
+
+// Reports errors that can repeat on every tick of every agent, e.g. a missing blackboard variable.
+// Errors are deduplicated by their source and call site: the first occurrence is printed, and later ones
+// are only counted, with a reminder at most every REPEAT_INTERVAL_MSEC. The total output is limited by
+// limbo_ai/behavior_tree/max_errors_per_second. Counters are exposed as LimboAI/task_errors* monitors.
+// Use LIMBO_ERR_* macros below: the message is evaluated only when it is going to be printed.
+class LimboErrorReporter {
+public:
+	static constexpr uint64_t REPEAT_INTERVAL_MSEC = 10000;
+
+private:
+	struct Entry {
+		uint64_t unreported = 0;
+		uint64_t last_report_msec = 0;
+		bool reported = false;
+	};
+
+	static SpinLock lock;
+	static HashMap<uint64_t, Entry> entries;
+	static SafeNumeric<uint64_t> error_count;
+	static SafeNumeric<uint64_t> suppressed_count;
+	static uint32_t max_per_second;
+	static uint64_t window_start_msec;
+	static uint32_t window_reports;
+	static bool monitors_added;
+
+	static int64_t _get_error_count() { return error_count.get(); }
+	static int64_t _get_suppressed_count() { return suppressed_count.get(); }
+
+public:
+	static void initialize();
+	// Adds the monitors. Call on the main thread.
+	static void ensure_monitors();
+
+	// Counts an occurrence, and returns true if it should be printed now, along with the number of occurrences since the last print.
+	static bool should_report(uint64_t p_source_key, const char *p_file, int p_line, uint64_t &r_repeats);
+	static void print(const char *p_function, const char *p_file, int p_line, const String &p_message, uint64_t p_repeats);
+	// Forgets the reported errors, so that they are printed again.
+	static void clear();
+
+	static uint64_t get_error_count() { return error_count.get(); }
+	static uint64_t get_suppressed_count() { return suppressed_count.get(); }
+};
+
+// Errors are deduplicated by this key of their source object. Sources that are cloned per agent, such as tasks,
+// provide an overload that is the same for all clones.
+_FORCE_INLINE_ uint64_t limbo_error_key(const Object *p_source) {
+	return uint64_t(p_source->get_instance_id());
+}
+
+#define _LIMBO_ERR_REPORT(m_msg)                                                                                 \
+	{                                                                                                             \
+		uint64_t _repeats = 0;                                                                                    \
+		if (LimboErrorReporter::should_report(limbo_error_key(this), __FILE__, __LINE__, _repeats)) {             \
+			LimboErrorReporter::print(__FUNCTION__, __FILE__, __LINE__, m_msg, _repeats);                         \
+		}                                                                                                         \
+	}
+
+#define LIMBO_ERR_FAIL_COND_V_MSG(m_cond, m_retval, m_msg) \
+	if (unlikely(m_cond)) {                                 \
+		_LIMBO_ERR_REPORT(m_msg);                           \
+		return m_retval;                                    \
+	} else                                                  \
+		((void)0)
+
+#define LIMBO_ERR_FAIL_COND_MSG(m_cond, m_msg) \
+	if (unlikely(m_cond)) {                    \
+		_LIMBO_ERR_REPORT(m_msg);              \
+		return;                                \
+	} else                                     \
+		((void)0)
+
+#define LIMBO_ERR_FAIL_NULL_V_MSG(m_param, m_retval, m_msg) LIMBO_ERR_FAIL_COND_V_MSG(m_param == nullptr, m_retval, m_msg)
+
+#define LIMBO_ERR_FAIL_V_MSG(m_retval, m_msg) \
+	{                                         \
+		_LIMBO_ERR_REPORT(m_msg);             \
+		return m_retval;                      \
+	}                                         \
+	((void)0)
+
+#define LIMBO_ERR_PRINT(m_msg) \
+	_LIMBO_ERR_REPORT(m_msg);  \
+	((void)0)
+
+#endif // LIMBO_ERROR_REPORTER_H
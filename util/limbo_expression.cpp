@@ -0,0 +1,574 @@
+/**
+ * limbo_expression.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "limbo_expression.h"
+
+#include "limbo_compat.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/math/math_funcs.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/core/math.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+Variant LimboExpression::Value::to_variant() const {
+	switch (type) {
+		case BOOL:
+			return i != 0;
+		case INT:
+			return i;
+		case FLOAT:
+			return f;
+	}
+	return Variant();
+}
+
+static _FORCE_INLINE_ bool _is_identifier_start(char32_t c) {
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+static _FORCE_INLINE_ bool _is_digit(char32_t c) {
+	return c >= '0' && c <= '9';
+}
+
+bool LimboExpression::_set_error(const String &p_text) {
+	error_text = p_text;
+	return false;
+}
+
+bool LimboExpression::_tokenize(const String &p_expression) {
+	const int len = p_expression.length();
+	int pos = 0;
+	while (pos < len) {
+		const char32_t c = p_expression[pos];
+		if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+			pos++;
+			continue;
+		}
+
+		Token tk;
+		const int start = pos;
+		if (_is_digit(c) || (c == '.' && pos + 1 < len && _is_digit(p_expression[pos + 1]))) {
+			bool is_float = false;
+			while (pos < len && _is_digit(p_expression[pos])) {
+				pos++;
+			}
+			if (pos < len && p_expression[pos] == '.') {
+				is_float = true;
+				pos++;
+				while (pos < len && _is_digit(p_expression[pos])) {
+					pos++;
+				}
+			}
+			if (pos < len && (p_expression[pos] == 'e' || p_expression[pos] == 'E')) {
+				is_float = true;
+				pos++;
+				if (pos < len && (p_expression[pos] == '+' || p_expression[pos] == '-')) {
+					pos++;
+				}
+				if (pos >= len || !_is_digit(p_expression[pos])) {
+					return _set_error(vformat("Malformed number at position %d.", start));
+				}
+				while (pos < len && _is_digit(p_expression[pos])) {
+					pos++;
+				}
+			}
+			tk.text = p_expression.substr(start, pos - start);
+			if (is_float) {
+				tk.type = TK_FLOAT;
+				tk.value.type = Value::FLOAT;
+				tk.value.f = tk.text.to_float();
+			} else {
+				tk.type = TK_INT;
+				tk.value.type = Value::INT;
+				tk.value.i = tk.text.to_int();
+			}
+		} else if (_is_identifier_start(c)) {
+			while (pos < len && (_is_identifier_start(p_expression[pos]) || _is_digit(p_expression[pos]))) {
+				pos++;
+			}
+			tk.type = TK_IDENTIFIER;
+			tk.text = p_expression.substr(start, pos - start);
+		} else if (c == '(') {
+			tk.type = TK_PAREN_OPEN;
+			pos++;
+		} else if (c == ')') {
+			tk.type = TK_PAREN_CLOSE;
+			pos++;
+		} else if (c == '.') {
+			tk.type = TK_DOT;
+			pos++;
+		} else {
+			static const char *operators[] = { "==", "!=", "<=", ">=", "&&", "||", "<", ">", "+", "-", "*", "/", "%", "!" };
+			for (const char *op : operators) {
+				const int op_len = op[1] ? 2 : 1;
+				if (p_expression.substr(pos, op_len) == op) {
+					tk.type = TK_OPERATOR;
+					tk.text = op;
+					pos += op_len;
+					break;
+				}
+			}
+			if (tk.type != TK_OPERATOR) {
+				return _set_error(vformat("Unexpected character '%s' at position %d.", String::chr(c), pos));
+			}
+		}
+		tokens.push_back(tk);
+	}
+	tokens.push_back(Token());
+	return true;
+}
+
+bool LimboExpression::_match_operator(const char *p_op) {
+	if (_peek().type == TK_OPERATOR && _peek().text == p_op) {
+		current++;
+		return true;
+	}
+	return false;
+}
+
+bool LimboExpression::_match_keyword(const char *p_keyword) {
+	if (_peek().type == TK_IDENTIFIER && _peek().text == p_keyword) {
+		current++;
+		return true;
+	}
+	return false;
+}
+
+void LimboExpression::_emit(Opcode p_op, uint32_t p_index, const Value &p_constant) {
+	Instruction ins;
+	ins.op = p_op;
+	ins.index = p_index;
+	ins.constant = p_constant;
+	code.push_back(ins);
+
+	switch (p_op) {
+		case OP_CONSTANT:
+		case OP_VARIABLE:
+		case OP_PROPERTY: {
+			depth++;
+			max_stack = MAX(max_stack, depth);
+		} break;
+		case OP_NEGATE:
+		case OP_NOT: {
+		} break;
+		default: {
+			depth--;
+		} break;
+	}
+}
+
+bool LimboExpression::_parse_or() {
+	if (!_parse_and()) {
+		return false;
+	}
+	while (_match_operator("||") || _match_keyword("or")) {
+		if (!_parse_and()) {
+			return false;
+		}
+		_emit(OP_OR);
+	}
+	return true;
+}
+
+bool LimboExpression::_parse_and() {
+	if (!_parse_not()) {
+		return false;
+	}
+	while (_match_operator("&&") || _match_keyword("and")) {
+		if (!_parse_not()) {
+			return false;
+		}
+		_emit(OP_AND);
+	}
+	return true;
+}
+
+bool LimboExpression::_parse_not() {
+	if (_match_operator("!") || _match_keyword("not")) {
+		if (!_parse_not()) {
+			return false;
+		}
+		_emit(OP_NOT);
+		return true;
+	}
+	return _parse_comparison();
+}
+
+bool LimboExpression::_parse_comparison() {
+	if (!_parse_sum()) {
+		return false;
+	}
+	static const struct {
+		const char *text;
+		Opcode op;
+	} comparisons[] = {
+		{ "==", OP_EQUAL },
+		{ "!=", OP_NOT_EQUAL },
+		{ "<=", OP_LESS_EQUAL },
+		{ ">=", OP_GREATER_EQUAL },
+		{ "<", OP_LESS },
+		{ ">", OP_GREATER },
+	};
+	for (const auto &cmp : comparisons) {
+		if (_match_operator(cmp.text)) {
+			if (!_parse_sum()) {
+				return false;
+			}
+			_emit(cmp.op);
+			break;
+		}
+	}
+	return true;
+}
+
+bool LimboExpression::_parse_sum() {
+	if (!_parse_product()) {
+		return false;
+	}
+	while (true) {
+		Opcode op;
+		if (_match_operator("+")) {
+			op = OP_ADD;
+		} else if (_match_operator("-")) {
+			op = OP_SUBTRACT;
+		} else {
+			return true;
+		}
+		if (!_parse_product()) {
+			return false;
+		}
+		_emit(op);
+	}
+}
+
+bool LimboExpression::_parse_product() {
+	if (!_parse_unary()) {
+		return false;
+	}
+	while (true) {
+		Opcode op;
+		if (_match_operator("*")) {
+			op = OP_MULTIPLY;
+		} else if (_match_operator("/")) {
+			op = OP_DIVIDE;
+		} else if (_match_operator("%")) {
+			op = OP_MODULO;
+		} else {
+			return true;
+		}
+		if (!_parse_unary()) {
+			return false;
+		}
+		_emit(op);
+	}
+}
+
+bool LimboExpression::_parse_unary() {
+	if (_match_operator("-")) {
+		if (!_parse_unary()) {
+			return false;
+		}
+		_emit(OP_NEGATE);
+		return true;
+	}
+	return _parse_primary();
+}
+
+bool LimboExpression::_parse_primary() {
+	const Token &tk = _peek();
+	switch (tk.type) {
+		case TK_INT:
+		case TK_FLOAT: {
+			current++;
+			_emit(OP_CONSTANT, 0, tk.value);
+			return true;
+		}
+		case TK_PAREN_OPEN: {
+			current++;
+			if (!_parse_or()) {
+				return false;
+			}
+			if (_peek().type != TK_PAREN_CLOSE) {
+				return _set_error("Expected ')'.");
+			}
+			current++;
+			return true;
+		}
+		case TK_IDENTIFIER: {
+			current++;
+			if (tk.text == "true" || tk.text == "false") {
+				Value value;
+				value.type = Value::BOOL;
+				value.i = tk.text == "true";
+				_emit(OP_CONSTANT, 0, value);
+				return true;
+			}
+			if (tk.text == "agent" && _peek().type == TK_DOT) {
+				current++;
+				if (_peek().type != TK_IDENTIFIER) {
+					return _set_error("Expected property name after 'agent.'.");
+				}
+				const StringName property = _peek().text;
+				current++;
+				uint32_t idx = 0;
+				while (idx < properties.size() && properties[idx].get_property() != property) {
+					idx++;
+				}
+				if (idx == properties.size()) {
+					LimboPropertyAccessor accessor;
+					accessor.set_path(property);
+					properties.push_back(accessor);
+				}
+				_emit(OP_PROPERTY, idx);
+				return true;
+			}
+			if (tk.text == "and" || tk.text == "or" || tk.text == "not") {
+				return _set_error(vformat("Unexpected '%s'.", tk.text));
+			}
+			const StringName var_name = tk.text;
+			uint32_t idx = 0;
+			while (idx < variables.size() && variables[idx].name != var_name) {
+				idx++;
+			}
+			if (idx == variables.size()) {
+				BBVarHandle handle;
+				handle.name = var_name;
+				variables.push_back(handle);
+			}
+			_emit(OP_VARIABLE, idx);
+			return true;
+		}
+		case TK_END: {
+			return _set_error("Unexpected end of expression.");
+		}
+		default: {
+			return _set_error(vformat("Unexpected token '%s'.", tk.text));
+		}
+	}
+}
+
+Error LimboExpression::parse(const String &p_expression) {
+	clear();
+	if (!_tokenize(p_expression) || !_parse_or()) {
+		clear(false);
+		return ERR_PARSE_ERROR;
+	}
+	if (max_stack > MAX_STACK) {
+		_set_error("Expression is too deeply nested.");
+		clear(false);
+		return ERR_PARSE_ERROR;
+	}
+	if (_peek().type != TK_END) {
+		_set_error(vformat("Unexpected token '%s'.", _peek().text));
+		clear(false);
+		return ERR_PARSE_ERROR;
+	}
+	tokens.clear();
+	return OK;
+}
+
+void LimboExpression::clear(bool p_clear_error) {
+	code.clear();
+	variables.clear();
+	properties.clear();
+	tokens.clear();
+	blackboard_id = 0;
+	max_stack = 0;
+	current = 0;
+	depth = 0;
+	if (p_clear_error) {
+		error_text = String();
+	}
+}
+
+bool LimboExpression::_from_variant(const Variant &p_value, Value &r_value) {
+	switch (p_value.get_type()) {
+		case Variant::BOOL: {
+			r_value.type = Value::BOOL;
+			r_value.i = bool(p_value);
+		} break;
+		case Variant::INT: {
+			r_value.type = Value::INT;
+			r_value.i = p_value;
+		} break;
+		case Variant::FLOAT: {
+			r_value.type = Value::FLOAT;
+			r_value.f = p_value;
+		} break;
+		default: {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool LimboExpression::_binary(Opcode p_op, Value &r_left, const Value &p_right) {
+	const bool both_int = r_left.type != Value::FLOAT && p_right.type != Value::FLOAT;
+	switch (p_op) {
+		case OP_ADD:
+		case OP_SUBTRACT:
+		case OP_MULTIPLY: {
+			if (both_int) {
+				r_left.i = p_op == OP_ADD ? r_left.i + p_right.i : (p_op == OP_SUBTRACT ? r_left.i - p_right.i : r_left.i * p_right.i);
+				r_left.type = Value::INT;
+			} else {
+				const double a = r_left.as_float();
+				const double b = p_right.as_float();
+				r_left.f = p_op == OP_ADD ? a + b : (p_op == OP_SUBTRACT ? a - b : a * b);
+				r_left.type = Value::FLOAT;
+			}
+		} break;
+		case OP_DIVIDE:
+		case OP_MODULO: {
+			if (both_int) {
+				if (unlikely(p_right.i == 0)) {
+					return _set_error("Division by zero.");
+				}
+				r_left.i = p_op == OP_DIVIDE ? r_left.i / p_right.i : r_left.i % p_right.i;
+				r_left.type = Value::INT;
+			} else {
+				const double a = r_left.as_float();
+				const double b = p_right.as_float();
+				r_left.f = p_op == OP_DIVIDE ? a / b : Math::fmod(a, b);
+				r_left.type = Value::FLOAT;
+			}
+		} break;
+		case OP_EQUAL:
+		case OP_NOT_EQUAL:
+		case OP_LESS:
+		case OP_LESS_EQUAL:
+		case OP_GREATER:
+		case OP_GREATER_EQUAL: {
+			int cmp;
+			if (both_int) {
+				cmp = r_left.i < p_right.i ? -1 : (r_left.i > p_right.i ? 1 : 0);
+			} else {
+				const double a = r_left.as_float();
+				const double b = p_right.as_float();
+				cmp = a < b ? -1 : (a > b ? 1 : 0);
+			}
+			bool result = false;
+			switch (p_op) {
+				case OP_EQUAL:
+					result = cmp == 0;
+					break;
+				case OP_NOT_EQUAL:
+					result = cmp != 0;
+					break;
+				case OP_LESS:
+					result = cmp < 0;
+					break;
+				case OP_LESS_EQUAL:
+					result = cmp <= 0;
+					break;
+				case OP_GREATER:
+					result = cmp > 0;
+					break;
+				default:
+					result = cmp >= 0;
+					break;
+			}
+			r_left.type = Value::BOOL;
+			r_left.i = result;
+		} break;
+		case OP_AND: {
+			r_left.i = r_left.is_true() && p_right.is_true();
+			r_left.type = Value::BOOL;
+		} break;
+		case OP_OR: {
+			r_left.i = r_left.is_true() || p_right.is_true();
+			r_left.type = Value::BOOL;
+		} break;
+		default: {
+			return _set_error("Invalid instruction.");
+		}
+	}
+	return true;
+}
+
+bool LimboExpression::evaluate(const Ref<Blackboard> &p_blackboard, Object *p_agent, Value &r_result) {
+	if (unlikely(code.is_empty())) {
+		return _set_error("Expression is not parsed.");
+	}
+	if (!variables.is_empty()) {
+		ERR_FAIL_COND_V(p_blackboard.is_null(), false);
+		if (unlikely(p_blackboard->get_instance_id() != blackboard_id)) {
+			// * Handles are only meaningful for the blackboard they were resolved against.
+			blackboard_id = p_blackboard->get_instance_id();
+			for (BBVarHandle &handle : variables) {
+				const StringName name = handle.name;
+				handle = BBVarHandle();
+				handle.name = name;
+			}
+		}
+	}
+
+	Value stack[MAX_STACK];
+	int sp = 0;
+	for (const Instruction &ins : code) {
+		switch (ins.op) {
+			case OP_CONSTANT: {
+				stack[sp++] = ins.constant;
+			} break;
+			case OP_VARIABLE: {
+				BBVarHandle &handle = variables[ins.index];
+				if (unlikely(!_from_variant(p_blackboard->get_var_by_handle(handle, Variant(), false), stack[sp]))) {
+					return _set_error(vformat("Blackboard variable \"%s\" doesn't exist or is not a number.", handle.name));
+				}
+				sp++;
+			} break;
+			case OP_PROPERTY: {
+				if (unlikely(p_agent == nullptr)) {
+					return _set_error("Agent is null.");
+				}
+				Variant value;
+				if (unlikely(!properties[ins.index].get(p_agent, value) || !_from_variant(value, stack[sp]))) {
+					return _set_error(vformat("Agent property \"%s\" doesn't exist or is not a number.", properties[ins.index].get_property()));
+				}
+				sp++;
+			} break;
+			case OP_NEGATE: {
+				Value &v = stack[sp - 1];
+				if (v.type == Value::FLOAT) {
+					v.f = -v.f;
+				} else {
+					v.i = -v.i;
+					v.type = Value::INT;
+				}
+			} break;
+			case OP_NOT: {
+				Value &v = stack[sp - 1];
+				v.i = !v.is_true();
+				v.type = Value::BOOL;
+			} break;
+			default: {
+				sp--;
+				if (unlikely(!_binary(ins.op, stack[sp - 1], stack[sp]))) {
+					return false;
+				}
+			} break;
+		}
+	}
+	r_result = stack[0];
+	return true;
+}
+
+bool LimboExpression::evaluate_bool(const Ref<Blackboard> &p_blackboard, Object *p_agent, bool &r_result) {
+	Value result;
+	if (!evaluate(p_blackboard, p_agent, result)) {
+		return false;
+	}
+	r_result = result.is_true();
+	return true;
+}
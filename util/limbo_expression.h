@@ -0,0 +1,150 @@
+/**
+ * limbo_expression.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef LIMBO_EXPRESSION_H
+#define LIMBO_EXPRESSION_H
+
+#include "../blackboard/blackboard.h"
+#include "limbo_property_accessor.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/object/object.h"
+#include "core/string/ustring.h"
+#include "core/templates/local_vector.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/core/object.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/variant/string.hpp>
+using namespace godot;
+#endif // LIMBOAI_GDEXTENSION
+
+// Restricted arithmetic and comparison language over blackboard variables and agent properties,
+// compiled into postfix bytecode. Only booleans, integers and floats are supported, and they are
+// evaluated natively instead of through Variant operators.
+//
+//   expr    := and (("or" | "||") and)*
+//   and     := not (("and" | "&&") not)*
+//   not     := ("not" | "!") not | cmp
+//   cmp     := sum (("==" | "!=" | "<" | "<=" | ">" | ">=") sum)?
+//   sum     := product (("+" | "-") product)*
+//   product := unary (("*" | "/" | "%") unary)*
+//   unary   := "-" unary | primary
+//   primary := number | "true" | "false" | variable | "agent." property | "(" expr ")"
+//
+// Variable handles are cached, so an instance should be evaluated against one blackboard at a time.
+class LimboExpression {
+public:
+	struct Value {
+		enum Type : uint8_t {
+			BOOL,
+			INT,
+			FLOAT,
+		};
+		Type type = INT;
+		int64_t i = 0; // Also holds BOOL.
+		double f = 0.0;
+
+		_FORCE_INLINE_ bool is_true() const { return type == FLOAT ? f != 0.0 : i != 0; }
+		_FORCE_INLINE_ double as_float() const { return type == FLOAT ? f : double(i); }
+		Variant to_variant() const;
+	};
+
+private:
+	static constexpr int MAX_STACK = 32;
+
+	enum Opcode : uint8_t {
+		OP_CONSTANT,
+		OP_VARIABLE,
+		OP_PROPERTY,
+		OP_NEGATE,
+		OP_NOT,
+		OP_ADD,
+		OP_SUBTRACT,
+		OP_MULTIPLY,
+		OP_DIVIDE,
+		OP_MODULO,
+		OP_EQUAL,
+		OP_NOT_EQUAL,
+		OP_LESS,
+		OP_LESS_EQUAL,
+		OP_GREATER,
+		OP_GREATER_EQUAL,
+		OP_AND,
+		OP_OR,
+	};
+
+	struct Instruction {
+		Opcode op = OP_CONSTANT;
+		uint32_t index = 0; // Into variables or properties.
+		Value constant;
+	};
+
+	enum TokenType : uint8_t {
+		TK_INT,
+		TK_FLOAT,
+		TK_IDENTIFIER,
+		TK_OPERATOR,
+		TK_PAREN_OPEN,
+		TK_PAREN_CLOSE,
+		TK_DOT,
+		TK_END,
+	};
+
+	struct Token {
+		TokenType type = TK_END;
+		String text;
+		Value value;
+	};
+
+	LocalVector<Instruction> code;
+	LocalVector<BBVarHandle> variables;
+	LocalVector<LimboPropertyAccessor> properties;
+	uint64_t blackboard_id = 0; // Blackboard the handles were resolved against.
+	int max_stack = 0;
+	String error_text;
+
+	// Compilation state.
+	LocalVector<Token> tokens;
+	uint32_t current = 0;
+	int depth = 0;
+
+	bool _tokenize(const String &p_expression);
+	_FORCE_INLINE_ const Token &_peek() const { return tokens[current]; }
+	bool _match_operator(const char *p_op);
+	bool _match_keyword(const char *p_keyword);
+	void _emit(Opcode p_op, uint32_t p_index = 0, const Value &p_constant = Value());
+	bool _parse_or();
+	bool _parse_and();
+	bool _parse_not();
+	bool _parse_comparison();
+	bool _parse_sum();
+	bool _parse_product();
+	bool _parse_unary();
+	bool _parse_primary();
+	bool _set_error(const String &p_text);
+
+	static bool _from_variant(const Variant &p_value, Value &r_value);
+	bool _binary(Opcode p_op, Value &r_left, const Value &p_right);
+
+public:
+	Error parse(const String &p_expression);
+	_FORCE_INLINE_ bool is_valid() const { return !code.is_empty(); }
+	String get_error_text() const { return error_text; }
+	void clear(bool p_clear_error = true);
+
+	// Returns false and sets the error text if evaluation failed, e.g. a variable is missing or not a number.
+	bool evaluate(const Ref<Blackboard> &p_blackboard, Object *p_agent, Value &r_result);
+	bool evaluate_bool(const Ref<Blackboard> &p_blackboard, Object *p_agent, bool &r_result);
+};
+
+#endif // LIMBO_EXPRESSION_H
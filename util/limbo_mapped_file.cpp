@@ -0,0 +1,121 @@
+/**
+ * limbo_mapped_file.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "limbo_mapped_file.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/config/project_settings.h"
+#include "core/io/file_access.h"
+#include "core/io/file_access_pack.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/project_settings.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+#if defined(__unix__) || defined(__APPLE__)
+#define LIMBO_MAPPED_FILE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef LIMBO_MAPPED_FILE_MMAP
+// True if FileAccess would read p_path from a file of the OS, rather than from a resource pack, which may be
+// encrypted or shadow a file on disk with the same path.
+static bool _is_os_file(const String &p_path) {
+	if (p_path.begins_with("user://") || (p_path.is_absolute_path() && !p_path.contains("://"))) {
+		return true;
+	}
+	if (!p_path.begins_with("res://")) {
+		return false;
+	}
+#ifdef LIMBOAI_MODULE
+	PackedData *packed = PackedData::get_singleton();
+	return packed == nullptr || packed->is_disabled() || !packed->has_path(p_path);
+#elif LIMBOAI_GDEXTENSION
+	// * Packs can't be queried from an extension, and exported projects serve res:// from them.
+	return false;
+#endif
+}
+#endif // LIMBO_MAPPED_FILE_MMAP
+
+bool LimboMappedFile::_map(const String &p_path) {
+#ifdef LIMBO_MAPPED_FILE_MMAP
+	// * Only plain files are mapped - the others go through FileAccess.
+	if (!_is_os_file(p_path)) {
+		return false;
+	}
+	const String path = ProjectSettings::get_singleton()->globalize_path(p_path);
+	const int fd = ::open(path.utf8().get_data(), O_RDONLY | O_CLOEXEC);
+	if (fd == -1) {
+		return false;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0 || uint64_t(st.st_size) > UINT32_MAX) {
+		::close(fd);
+		return false;
+	}
+	void *addr = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+	// * The mapping stays valid after the descriptor is closed.
+	::close(fd);
+	if (addr == MAP_FAILED) {
+		return false;
+	}
+	mapping = addr;
+	mapping_size = size_t(st.st_size);
+	data = (const uint8_t *)addr;
+	size = uint32_t(st.st_size);
+	return true;
+#else
+	return false;
+#endif
+}
+
+void LimboMappedFile::_unmap() {
+#ifdef LIMBO_MAPPED_FILE_MMAP
+	if (mapping) {
+		munmap(mapping, mapping_size);
+	}
+#endif
+	mapping = nullptr;
+	mapping_size = 0;
+}
+
+Error LimboMappedFile::open(const String &p_path) {
+	close();
+	if (_map(p_path)) {
+		return OK;
+	}
+	Error err = OK;
+#ifdef LIMBOAI_MODULE
+	buffer = FileAccess::get_file_as_bytes(p_path, &err);
+#elif LIMBOAI_GDEXTENSION
+	buffer = FileAccess::get_file_as_bytes(p_path);
+	err = FileAccess::get_open_error();
+#endif
+	if (err != OK) {
+		buffer.clear();
+		return err;
+	}
+	data = buffer.ptr();
+	size = buffer.size();
+	return OK;
+}
+
+void LimboMappedFile::close() {
+	_unmap();
+	buffer.clear();
+	data = nullptr;
+	size = 0;
+}
@@ -0,0 +1,58 @@
+/**
+ * limbo_mapped_file.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef LIMBO_MAPPED_FILE_H
+#define LIMBO_MAPPED_FILE_H
+
+#ifdef LIMBOAI_MODULE
+#include "core/error/error_list.h"
+#include "core/string/ustring.h"
+#include "core/variant/variant.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/string.hpp>
+using namespace godot;
+#endif // LIMBOAI_GDEXTENSION
+
+// Read-only view of the contents of a file, for decoding it once. Files on disk are mapped into memory read-only,
+// which only avoids copying them into a buffer - the pages are read from the page cache either way, and nothing
+// is kept mapped beyond the lifetime of the view. Where the file can't be mapped (e.g., served by a resource pack,
+// or on platforms without mmap), its contents are read into a buffer instead.
+// Like FileAccess, paths aren't remapped - pass the path that ResourceLoader resolved, if needed.
+// Files must be replaced (written to a new file and renamed) rather than rewritten in place while mapped.
+class LimboMappedFile {
+private:
+	const uint8_t *data = nullptr;
+	uint32_t size = 0;
+	void *mapping = nullptr;
+	size_t mapping_size = 0;
+	PackedByteArray buffer;
+
+	bool _map(const String &p_path);
+	void _unmap();
+
+public:
+	Error open(const String &p_path);
+	void close();
+
+	_FORCE_INLINE_ const uint8_t *ptr() const { return data; }
+	_FORCE_INLINE_ uint32_t get_size() const { return size; }
+	_FORCE_INLINE_ bool is_mapped() const { return mapping != nullptr; }
+
+	LimboMappedFile() {}
+	~LimboMappedFile() { close(); }
+	LimboMappedFile(const LimboMappedFile &) = delete;
+	LimboMappedFile &operator=(const LimboMappedFile &) = delete;
+};
+
+#endif // LIMBO_MAPPED_FILE_H
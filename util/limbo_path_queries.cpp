@@ -0,0 +1,147 @@
+/**
+ * limbo_path_queries.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "limbo_path_queries.h"
+
+#include "../bt/bt_instance.h"
+#include "limbo_compat.h"
+#include "limbo_profiling.h"
+#include "limbo_string_names.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/object/worker_thread_pool.h"
+#include "scene/main/scene_tree.h"
+#include "servers/navigation_server_2d.h"
+#include "servers/navigation_server_3d.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/navigation_server2d.hpp>
+#include <godot_cpp/classes/navigation_server3d.hpp>
+#include <godot_cpp/classes/scene_tree.hpp>
+#include <godot_cpp/classes/worker_thread_pool.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+uint64_t LimboPathQueries::next_ticket = 1;
+LocalVector<LimboPathQueries::Query> LimboPathQueries::submitted;
+LimboPathQueries::Batch *LimboPathQueries::running = nullptr;
+HashSet<uint64_t> LimboPathQueries::in_flight;
+HashMap<uint64_t, Variant> LimboPathQueries::results;
+uint64_t LimboPathQueries::connected_tree_id = 0;
+
+uint64_t LimboPathQueries::submit(const RID &p_map, const Vector3 &p_from, const Vector3 &p_to, uint32_t p_navigation_layers, bool p_2d, uint64_t p_wake_instance_id) {
+	Query query;
+	query.ticket = next_ticket++;
+	query.map = p_map;
+	query.from = p_from;
+	query.to = p_to;
+	query.navigation_layers = p_navigation_layers;
+	query.is_2d = p_2d;
+	query.wake_instance_id = p_wake_instance_id;
+	submitted.push_back(query);
+	in_flight.insert(query.ticket);
+	_connect_processing();
+	return query.ticket;
+}
+
+LimboPathQueries::QueryState LimboPathQueries::poll(uint64_t p_ticket, Variant &r_path) {
+	HashMap<uint64_t, Variant>::Iterator E = results.find(p_ticket);
+	if (E) {
+		r_path = E->value;
+		results.remove(E);
+		return QUERY_READY;
+	}
+	return in_flight.has(p_ticket) ? QUERY_PENDING : QUERY_INVALID;
+}
+
+void LimboPathQueries::cancel(uint64_t p_ticket) {
+	// * Queries already sent to the navigation server are computed anyway - their results are dropped.
+	in_flight.erase(p_ticket);
+	results.erase(p_ticket);
+}
+
+void LimboPathQueries::_compute(void *p_userdata, uint32_t p_index) {
+	Query &query = ((Batch *)p_userdata)->queries[p_index];
+	if (query.is_2d) {
+		const PackedVector2Array path = NavigationServer2D::get_singleton()->map_get_path(query.map, Vector2(query.from.x, query.from.y), Vector2(query.to.x, query.to.y), true, query.navigation_layers);
+		query.path = path;
+	} else {
+		const PackedVector3Array path = NavigationServer3D::get_singleton()->map_get_path(query.map, query.from, query.to, true, query.navigation_layers);
+		query.path = path;
+	}
+}
+
+void LimboPathQueries::_finish_batch() {
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(running->group_id);
+	for (Query &query : running->queries) {
+		if (!in_flight.has(query.ticket)) {
+			continue; // Cancelled.
+		}
+		in_flight.erase(query.ticket);
+		results.insert(query.ticket, query.path);
+		if (query.wake_instance_id != 0) {
+			BTInstance *instance = Object::cast_to<BTInstance>(OBJECT_DB_GET_INSTANCE(query.wake_instance_id));
+			if (instance) {
+				instance->wake();
+			}
+		}
+	}
+	memdelete(running);
+	running = nullptr;
+}
+
+void LimboPathQueries::_process_frame() {
+	LIMBO_PROFILE_ZONE("LimboPathQueries::_process_frame");
+	if (running && WorkerThreadPool::get_singleton()->is_group_task_completed(running->group_id)) {
+		_finish_batch();
+	}
+	if (running || submitted.is_empty()) {
+		return;
+	}
+
+	// * All queries submitted since the last batch go out together.
+	running = memnew(Batch);
+	for (const Query &query : submitted) {
+		if (in_flight.has(query.ticket)) {
+			running->queries.push_back(query);
+		}
+	}
+	submitted.clear();
+	if (running->queries.is_empty()) {
+		memdelete(running);
+		running = nullptr;
+		return;
+	}
+#ifdef LIMBOAI_MODULE
+	running->group_id = WorkerThreadPool::get_singleton()->add_native_group_task(&LimboPathQueries::_compute, running, running->queries.size(), -1, false, "LimboAI path queries");
+#elif LIMBOAI_GDEXTENSION
+	running->group_id = WorkerThreadPool::get_singleton()->add_group_task(callable_mp_static(&LimboPathQueries::_compute_bound).bind(uint64_t(running)), running->queries.size(), -1, false, "LimboAI path queries");
+#endif
+}
+
+void LimboPathQueries::_connect_processing() {
+	SceneTree *tree = SCENE_TREE();
+	if (tree && uint64_t(tree->get_instance_id()) != connected_tree_id) {
+		tree->connect(LW_NAME(process_frame), callable_mp_static(&LimboPathQueries::_process_frame));
+		connected_tree_id = tree->get_instance_id();
+	}
+}
+
+void LimboPathQueries::clear() {
+	if (running) {
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(running->group_id);
+		memdelete(running);
+		running = nullptr;
+	}
+	submitted.clear();
+	in_flight.clear();
+	results.clear();
+}
@@ -0,0 +1,90 @@
+/**
+ * limbo_path_queries.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef LIMBO_PATH_QUERIES_H
+#define LIMBO_PATH_QUERIES_H
+
+#ifdef LIMBOAI_MODULE
+#include "core/math/vector3.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/hash_set.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/rid.h"
+#include "core/variant/variant.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/hash_set.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/variant/rid.hpp>
+#include <godot_cpp/variant/variant.hpp>
+#include <godot_cpp/variant/vector3.hpp>
+using namespace godot;
+#endif // LIMBOAI_GDEXTENSION
+
+// Navigation path queries of all agents, computed in batches. Queries submitted during a frame are sent to the
+// navigation server together at the start of the next frame, on the WorkerThreadPool, and their results can be
+// polled from the frame after that. Reactive instances waiting for a result are woken up when it arrives.
+// 2D queries use z = 0. Main thread only.
+class LimboPathQueries {
+public:
+	enum QueryState {
+		QUERY_PENDING,
+		QUERY_READY,
+		QUERY_INVALID, // Unknown ticket, e.g. already polled or cancelled.
+	};
+
+private:
+	struct Query {
+		uint64_t ticket = 0;
+		RID map;
+		Vector3 from;
+		Vector3 to;
+		uint32_t navigation_layers = 1;
+		bool is_2d = false;
+		uint64_t wake_instance_id = 0;
+		Variant path; // PackedVector2Array or PackedVector3Array.
+	};
+
+	struct Batch {
+		LocalVector<Query> queries;
+		int64_t group_id = -1;
+	};
+
+	static uint64_t next_ticket;
+	static LocalVector<Query> submitted; // Waiting for the next batch.
+	static Batch *running; // Computed on the WorkerThreadPool.
+	static HashSet<uint64_t> in_flight; // Submitted or running, and not cancelled.
+	static HashMap<uint64_t, Variant> results; // Finished, waiting to be polled.
+	static uint64_t connected_tree_id;
+
+	static void _compute(void *p_userdata, uint32_t p_index);
+#ifdef LIMBOAI_GDEXTENSION
+	static void _compute_bound(uint32_t p_index, uint64_t p_batch) { _compute((void *)p_batch, p_index); }
+#endif
+	static void _finish_batch();
+	static void _process_frame();
+	static void _connect_processing();
+
+public:
+	// Returns a ticket to poll the result with. p_wake_instance_id is the BTInstance to wake up when the result arrives (or 0).
+	static uint64_t submit(const RID &p_map, const Vector3 &p_from, const Vector3 &p_to, uint32_t p_navigation_layers, bool p_2d, uint64_t p_wake_instance_id = 0);
+	// Once a query is ready, returns its path and forgets the ticket. The path is empty if there is none.
+	static QueryState poll(uint64_t p_ticket, Variant &r_path);
+	static void cancel(uint64_t p_ticket);
+
+	_FORCE_INLINE_ static uint32_t get_pending_count() { return in_flight.size(); }
+
+	static void clear();
+};
+
+#endif // LIMBO_PATH_QUERIES_H
@@ -0,0 +1,41 @@
+/**
+ * limbo_profiling.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef LIMBO_PROFILING_H
+#define LIMBO_PROFILING_H
+
+// Zones for an external frame profiler, so that AI work shows up in the same timeline as the rest of the frame.
+// Build with "limboai_tracy=yes" (module) or "tracy=yes" (GDExtension) and Tracy's public headers in the include
+// path to emit Tracy zones. Otherwise, the macros compile to nothing.
+//
+// LIMBO_PROFILE_ZONE(name) - scoped zone with a static name (a string literal).
+// LIMBO_PROFILE_ZONE_DYNAMIC(string) - scoped zone named from a String at runtime; keep it off the common paths.
+
+#ifdef LIMBOAI_TRACY
+
+#include <tracy/Tracy.hpp>
+
+#define LIMBO_PROFILE_ZONE(m_name) ZoneScopedN(m_name)
+#define LIMBO_PROFILE_ZONE_DYNAMIC(m_string)                                      \
+	ZoneScoped;                                                                   \
+	{                                                                             \
+		const CharString _limbo_zone_name = String(m_string).utf8();              \
+		ZoneName(_limbo_zone_name.get_data(), (size_t)_limbo_zone_name.length()); \
+	}
+
+#else
+
+#define LIMBO_PROFILE_ZONE(m_name)
+#define LIMBO_PROFILE_ZONE_DYNAMIC(m_string)
+
+#endif // LIMBOAI_TRACY
+
+#endif // LIMBO_PROFILING_H
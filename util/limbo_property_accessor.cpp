@@ -0,0 +1,165 @@
+/**
+ * limbo_property_accessor.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "limbo_property_accessor.h"
+
+#include "limbo_compat.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/object/class_db.h"
+#include "core/object/method_bind.h"
+#include "core/object/script_language.h"
+#endif // LIMBOAI_MODULE
+
+void LimboPropertyAccessor::set_path(const String &p_path) {
+	const PackedStringArray parts = p_path.split(":");
+	property = parts.is_empty() ? StringName() : StringName(parts[0]);
+	subnames.clear();
+	for (int i = 1; i < parts.size(); i++) {
+		subnames.push_back(parts[i]);
+	}
+	reset();
+}
+
+void LimboPropertyAccessor::reset() {
+#ifdef LIMBOAI_MODULE
+	object_id = 0;
+	getter = nullptr;
+	setter = nullptr;
+	script_instance = nullptr;
+#endif
+}
+
+#ifdef LIMBOAI_MODULE
+void LimboPropertyAccessor::_resolve(Object *p_object) {
+	object_id = p_object->get_instance_id();
+	getter = nullptr;
+	setter = nullptr;
+	script_instance = p_object->get_script_instance();
+
+	// Script can intercept any property with _get/_set - use the generic path in that case.
+	if (script_instance && (script_instance->has_method(SNAME("_get")) || script_instance->has_method(SNAME("_set")))) {
+		return;
+	}
+
+	const StringName class_name = p_object->get_class_name();
+	bool is_valid = false;
+	int index = ClassDB::get_property_index(class_name, property, &is_valid);
+	if (!is_valid || index != -1) {
+		// Script property, or indexed property that needs extra arguments.
+		return;
+	}
+	StringName getter_name = ClassDB::get_property_getter(class_name, property);
+	StringName setter_name = ClassDB::get_property_setter(class_name, property);
+	if (getter_name != StringName()) {
+		getter = ClassDB::get_method(class_name, getter_name);
+	}
+	if (setter_name != StringName()) {
+		setter = ClassDB::get_method(class_name, setter_name);
+	}
+}
+#endif // LIMBOAI_MODULE
+
+bool LimboPropertyAccessor::_get_property(Object *p_object, Variant &r_value) {
+#ifdef LIMBOAI_MODULE
+	if (unlikely(uint64_t(p_object->get_instance_id()) != object_id || p_object->get_script_instance() != script_instance)) {
+		_resolve(p_object);
+	}
+	if (likely(getter != nullptr)) {
+		Callable::CallError ce;
+		Variant ret = getter->call(p_object, nullptr, 0, ce);
+		if (ce.error == Callable::CallError::CALL_OK) {
+			r_value = ret;
+			return true;
+		}
+	}
+	bool r_valid = false;
+	r_value = p_object->get(property, &r_valid);
+	return r_valid;
+#elif LIMBOAI_GDEXTENSION
+	r_value = p_object->get(property);
+	return true;
+#endif
+}
+
+bool LimboPropertyAccessor::_set_property(Object *p_object, const Variant &p_value) {
+#ifdef LIMBOAI_MODULE
+	if (unlikely(uint64_t(p_object->get_instance_id()) != object_id || p_object->get_script_instance() != script_instance)) {
+		_resolve(p_object);
+	}
+	if (likely(setter != nullptr)) {
+		const Variant *args[1] = { &p_value };
+		Callable::CallError ce;
+		setter->call(p_object, args, 1, ce);
+		if (ce.error == Callable::CallError::CALL_OK) {
+			return true;
+		}
+	}
+	bool r_valid = false;
+	p_object->set(property, p_value, &r_valid);
+	return r_valid;
+#elif LIMBOAI_GDEXTENSION
+	p_object->set(property, p_value);
+	return true;
+#endif
+}
+
+bool LimboPropertyAccessor::get(Object *p_object, Variant &r_value) {
+	ERR_FAIL_NULL_V(p_object, false);
+	if (!_get_property(p_object, r_value)) {
+		return false;
+	}
+	for (const StringName &subname : subnames) {
+		bool valid = false;
+		r_value = r_value.get_named(subname, valid);
+		if (!valid) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool LimboPropertyAccessor::set(Object *p_object, const Variant &p_value) {
+	ERR_FAIL_NULL_V(p_object, false);
+	if (subnames.is_empty()) {
+		return _set_property(p_object, p_value);
+	}
+
+	// Values are copies: modify the innermost one, then write each back into its container.
+	Variant base;
+	if (!_get_property(p_object, base)) {
+		return false;
+	}
+	bool valid = false;
+	if (subnames.size() == 1) {
+		base.set_named(subnames[0], p_value, valid);
+		return valid && _set_property(p_object, base);
+	}
+
+	LocalVector<Variant> chain;
+	chain.resize(subnames.size());
+	chain[0] = base;
+	for (uint32_t i = 1; i < subnames.size(); i++) {
+		chain[i] = chain[i - 1].get_named(subnames[i - 1], valid);
+		if (!valid) {
+			return false;
+		}
+	}
+	Variant value = p_value;
+	for (int i = subnames.size() - 1; i >= 0; i--) {
+		chain[i].set_named(subnames[i], value, valid);
+		if (!valid) {
+			return false;
+		}
+		value = chain[i];
+	}
+	return _set_property(p_object, value);
+}
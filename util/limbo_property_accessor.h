@@ -0,0 +1,66 @@
+/**
+ * limbo_property_accessor.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef LIMBO_PROPERTY_ACCESSOR_H
+#define LIMBO_PROPERTY_ACCESSOR_H
+
+#ifdef LIMBOAI_MODULE
+#include "core/object/object.h"
+#include "core/string/string_name.h"
+#include "core/templates/local_vector.h"
+
+class MethodBind;
+class ScriptInstance;
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/core/object.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/variant/string_name.hpp>
+using namespace godot;
+#endif // LIMBOAI_GDEXTENSION
+
+// Reads and writes a property of an object, such as "position" or an indexed path like "velocity:x".
+// The path is split once, and native accessors are resolved on first use with an object and reused
+// for as long as the same object (and script instance) is accessed.
+class LimboPropertyAccessor {
+private:
+	StringName property;
+	LocalVector<StringName> subnames; // Indexed into the property value, e.g. "x" in "velocity:x".
+
+#ifdef LIMBOAI_MODULE
+	uint64_t object_id = 0; // Object the accessors were resolved for.
+	MethodBind *getter = nullptr;
+	MethodBind *setter = nullptr;
+	ScriptInstance *script_instance = nullptr;
+
+	void _resolve(Object *p_object);
+#endif
+
+	bool _get_property(Object *p_object, Variant &r_value);
+	bool _set_property(Object *p_object, const Variant &p_value);
+
+public:
+	void set_path(const String &p_path);
+	_FORCE_INLINE_ StringName get_property() const { return property; }
+	_FORCE_INLINE_ bool is_indexed() const { return !subnames.is_empty(); }
+	_FORCE_INLINE_ bool is_empty() const { return property == StringName(); }
+
+	// Forget resolved accessors, e.g. after the object has changed its script.
+	void reset();
+
+	// Return false if the property (or sub-property) doesn't exist. In GDExtension, access to a base
+	// property that doesn't exist can't be detected.
+	bool get(Object *p_object, Variant &r_value);
+	bool set(Object *p_object, const Variant &p_value);
+};
+
+#endif // LIMBO_PROPERTY_ACCESSOR_H
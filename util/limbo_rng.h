@@ -0,0 +1,81 @@
+/**
+ * limbo_rng.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef LIMBO_RNG_H
+#define LIMBO_RNG_H
+
+#ifdef LIMBOAI_MODULE
+#include "core/templates/local_vector.h"
+#include "core/typedefs.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/core/defs.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+using namespace godot;
+#endif // LIMBOAI_GDEXTENSION
+
+// Minimal PCG32 generator for tasks and instances that need their own random stream: the same seed
+// always produces the same sequence, independently of other users of the global RNG.
+struct LimboRNG {
+	uint64_t state = 0x853c49e6748fea9bULL;
+	uint64_t inc = 0xda3e39cb94b95bdbULL;
+
+	void seed(uint64_t p_seed) {
+		state = 0;
+		inc = (p_seed << 1u) | 1u;
+		next();
+		state += p_seed;
+		next();
+	}
+
+	_FORCE_INLINE_ uint32_t next() {
+		const uint64_t old = state;
+		state = old * 6364136223846793005ULL + inc;
+		const uint32_t xorshifted = uint32_t(((old >> 18u) ^ old) >> 27u);
+		const uint32_t rot = uint32_t(old >> 59u);
+		return (xorshifted >> rot) | (xorshifted << ((~rot + 1u) & 31));
+	}
+
+	// Uniform in [0, 1), with 53 bits of precision.
+	_FORCE_INLINE_ double randf() {
+		// Separate statements: evaluation order of operands is unspecified, and must not vary between compilers.
+		const uint64_t high = next();
+		const uint64_t low = next();
+		return double(((high << 32) | low) >> 11) * (1.0 / 9007199254740992.0);
+	}
+
+	_FORCE_INLINE_ double randf_range(double p_from, double p_to) {
+		return p_from + (p_to - p_from) * randf();
+	}
+
+	// Uniform in [0, p_bound), without modulo bias.
+	_FORCE_INLINE_ uint32_t bounded(uint32_t p_bound) {
+		const uint32_t threshold = (~p_bound + 1u) % p_bound;
+		while (true) {
+			const uint32_t r = next();
+			if (r >= threshold) {
+				return r % p_bound;
+			}
+		}
+	}
+
+	// Fisher-Yates shuffle in place.
+	template <typename T>
+	void shuffle(LocalVector<T> &p_array) {
+		for (uint32_t i = p_array.size(); i > 1; i--) {
+			const uint32_t j = bounded(i);
+			SWAP(p_array[i - 1], p_array[j]);
+		}
+	}
+};
+
+#endif // LIMBO_RNG_H
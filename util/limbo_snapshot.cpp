@@ -0,0 +1,210 @@
+/**
+ * limbo_snapshot.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "limbo_snapshot.h"
+
+#include "limbo_compat.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/io/marshalls.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/variant/utility_functions.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+namespace {
+
+enum ValueKind : uint8_t {
+	VALUE_ENCODED,
+	VALUE_OBJECT_ID,
+};
+
+} // namespace
+
+//**** LimboSnapshotWriter
+
+void LimboSnapshotWriter::put_u32(uint32_t p_value) {
+	uint8_t bytes[4];
+	for (int i = 0; i < 4; i++) {
+		bytes[i] = uint8_t(p_value >> (i * 8));
+	}
+	_put_bytes(bytes, 4);
+}
+
+void LimboSnapshotWriter::put_u64(uint64_t p_value) {
+	uint8_t bytes[8];
+	for (int i = 0; i < 8; i++) {
+		bytes[i] = uint8_t(p_value >> (i * 8));
+	}
+	_put_bytes(bytes, 8);
+}
+
+void LimboSnapshotWriter::put_double(double p_value) {
+	uint64_t bits;
+	memcpy(&bits, &p_value, sizeof(bits));
+	put_u64(bits);
+}
+
+void LimboSnapshotWriter::put_string_name(const StringName &p_value) {
+	const CharString utf8 = String(p_value).utf8();
+	put_u32(utf8.length());
+	_put_bytes((const uint8_t *)utf8.get_data(), utf8.length());
+}
+
+void LimboSnapshotWriter::put_bytes(const PackedByteArray &p_bytes) {
+	put_u32(p_bytes.size());
+	_put_bytes(p_bytes.ptr(), p_bytes.size());
+}
+
+void LimboSnapshotWriter::put_variant(const Variant &p_value) {
+	if (p_value.get_type() == Variant::OBJECT) {
+		put_u8(VALUE_OBJECT_ID);
+#ifdef LIMBOAI_MODULE
+		const Object *obj = p_value.get_validated_object();
+#elif LIMBOAI_GDEXTENSION
+		const Object *obj = p_value;
+#endif
+		put_u64(obj ? uint64_t(obj->get_instance_id()) : 0);
+		return;
+	}
+
+	put_u8(VALUE_ENCODED);
+#ifdef LIMBOAI_MODULE
+	int len = 0;
+	Error err = encode_variant(p_value, nullptr, len, false);
+	ERR_FAIL_COND_MSG(err != OK, "LimboSnapshotWriter: Failed to encode value.");
+	put_u32(len);
+	const uint32_t pos = buffer.size();
+	buffer.resize(pos + len);
+	encode_variant(p_value, buffer.ptr() + pos, len, false);
+#elif LIMBOAI_GDEXTENSION
+	const PackedByteArray bytes = UtilityFunctions::var_to_bytes(p_value);
+	put_u32(bytes.size());
+	_put_bytes(bytes.ptr(), bytes.size());
+#endif
+}
+
+void LimboSnapshotWriter::patch_u32(uint32_t p_position, uint32_t p_value) {
+	ERR_FAIL_COND(p_position + 4 > buffer.size());
+	for (int i = 0; i < 4; i++) {
+		buffer[p_position + i] = uint8_t(p_value >> (i * 8));
+	}
+}
+
+PackedByteArray LimboSnapshotWriter::to_bytes() const {
+	PackedByteArray bytes;
+	bytes.resize(buffer.size());
+	if (buffer.size() > 0) {
+		memcpy(bytes.ptrw(), buffer.ptr(), buffer.size());
+	}
+	return bytes;
+}
+
+//**** LimboSnapshotReader
+
+uint8_t LimboSnapshotReader::get_u8() {
+	if (!_require(1)) {
+		return 0;
+	}
+	return data[position++];
+}
+
+uint32_t LimboSnapshotReader::get_u32() {
+	if (!_require(4)) {
+		return 0;
+	}
+	uint32_t value = 0;
+	for (int i = 0; i < 4; i++) {
+		value |= uint32_t(data[position + i]) << (i * 8);
+	}
+	position += 4;
+	return value;
+}
+
+uint64_t LimboSnapshotReader::get_u64() {
+	if (!_require(8)) {
+		return 0;
+	}
+	uint64_t value = 0;
+	for (int i = 0; i < 8; i++) {
+		value |= uint64_t(data[position + i]) << (i * 8);
+	}
+	position += 8;
+	return value;
+}
+
+double LimboSnapshotReader::get_double() {
+	const uint64_t bits = get_u64();
+	double value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+StringName LimboSnapshotReader::get_string_name() {
+	const uint32_t len = get_u32();
+	if (!_require(len)) {
+		return StringName();
+	}
+	String str = String::utf8((const char *)data + position, len);
+	position += len;
+	return StringName(str);
+}
+
+PackedByteArray LimboSnapshotReader::get_bytes() {
+	PackedByteArray bytes;
+	const uint32_t len = get_u32();
+	if (!_require(len)) {
+		return bytes;
+	}
+	bytes.resize(len);
+	if (len > 0) {
+		memcpy(bytes.ptrw(), data + position, len);
+	}
+	position += len;
+	return bytes;
+}
+
+Variant LimboSnapshotReader::get_variant() {
+	const uint8_t kind = get_u8();
+	if (kind == VALUE_OBJECT_ID) {
+		const uint64_t id = get_u64();
+		return id ? Variant(OBJECT_DB_GET_INSTANCE(id)) : Variant();
+	}
+	if (kind != VALUE_ENCODED) {
+		failed = true;
+		return Variant();
+	}
+	const uint32_t len = get_u32();
+	if (!_require(len)) {
+		return Variant();
+	}
+	Variant value;
+#ifdef LIMBOAI_MODULE
+	Error err = decode_variant(value, data + position, len, nullptr, false);
+	if (err != OK) {
+		failed = true;
+		return Variant();
+	}
+#elif LIMBOAI_GDEXTENSION
+	PackedByteArray bytes;
+	bytes.resize(len);
+	memcpy(bytes.ptrw(), data + position, len);
+	value = UtilityFunctions::bytes_to_var(bytes);
+#endif
+	position += len;
+	return value;
+}
+
+LimboSnapshotReader::LimboSnapshotReader(const PackedByteArray &p_data) {
+	data = p_data.ptr();
+	size = p_data.size();
+}
@@ -0,0 +1,97 @@
+/**
+ * limbo_snapshot.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef LIMBO_SNAPSHOT_H
+#define LIMBO_SNAPSHOT_H
+
+#ifdef LIMBOAI_MODULE
+#include "core/string/string_name.h"
+#include "core/templates/local_vector.h"
+#include "core/variant/variant.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/string_name.hpp>
+#include <godot_cpp/variant/variant.hpp>
+using namespace godot;
+#endif // LIMBOAI_GDEXTENSION
+
+// Binary encoding of blackboard and task runtime state (see Blackboard::create_snapshot() and
+// BTInstance::create_snapshot()). Numbers are stored in little-endian order. Objects are stored by
+// instance ID and only restored if they still exist - a snapshot is not a serialization of objects.
+class LimboSnapshotWriter {
+private:
+	LocalVector<uint8_t> buffer;
+
+	_FORCE_INLINE_ void _put_bytes(const uint8_t *p_bytes, uint32_t p_size) {
+		const uint32_t pos = buffer.size();
+		buffer.resize(pos + p_size);
+		memcpy(buffer.ptr() + pos, p_bytes, p_size);
+	}
+
+public:
+	_FORCE_INLINE_ void put_u8(uint8_t p_value) { buffer.push_back(p_value); }
+	void put_u32(uint32_t p_value);
+	void put_u64(uint64_t p_value);
+	_FORCE_INLINE_ void put_i64(int64_t p_value) { put_u64(uint64_t(p_value)); }
+	void put_double(double p_value);
+	void put_string_name(const StringName &p_value);
+	void put_variant(const Variant &p_value);
+	// Prefixed with the size.
+	void put_bytes(const PackedByteArray &p_bytes);
+
+	_FORCE_INLINE_ uint32_t get_position() const { return buffer.size(); }
+	// Overwrites a value written earlier, e.g. a size that is known only after writing the data.
+	void patch_u32(uint32_t p_position, uint32_t p_value);
+
+	PackedByteArray to_bytes() const;
+};
+
+class LimboSnapshotReader {
+private:
+	const uint8_t *data = nullptr;
+	uint32_t size = 0;
+	uint32_t position = 0;
+	bool failed = false;
+
+	_FORCE_INLINE_ bool _require(uint32_t p_bytes) {
+		if (unlikely(failed || size - position < p_bytes)) {
+			failed = true;
+			return false;
+		}
+		return true;
+	}
+
+public:
+	uint8_t get_u8();
+	uint32_t get_u32();
+	uint64_t get_u64();
+	_FORCE_INLINE_ int64_t get_i64() { return int64_t(get_u64()); }
+	double get_double();
+	StringName get_string_name();
+	Variant get_variant();
+	PackedByteArray get_bytes();
+
+	_FORCE_INLINE_ uint32_t get_position() const { return position; }
+	_FORCE_INLINE_ bool is_at_end() const { return position == size; }
+	// Set once a read goes past the end or finds malformed data. Further reads return zero values.
+	_FORCE_INLINE_ bool has_failed() const { return failed; }
+	_FORCE_INLINE_ void set_failed() { failed = true; }
+
+	// p_data must outlive the reader.
+	LimboSnapshotReader(const PackedByteArray &p_data);
+	LimboSnapshotReader(const uint8_t *p_data, uint32_t p_size) :
+			data(p_data), size(p_size) {}
+};
+
+#endif // LIMBO_SNAPSHOT_H
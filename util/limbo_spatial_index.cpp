@@ -0,0 +1,154 @@
+/**
+ * limbo_spatial_index.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "limbo_spatial_index.h"
+
+#include "limbo_compat.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/config/engine.h"
+#include "core/templates/sort_array.h"
+#include "scene/2d/node_2d.h"
+#include "scene/3d/node_3d.h"
+#include "scene/main/scene_tree.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/node2d.hpp>
+#include <godot_cpp/classes/node3d.hpp>
+#include <godot_cpp/classes/scene_tree.hpp>
+#include <godot_cpp/templates/sort_array.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+HashMap<StringName, HashMap<int, LimboSpatialIndex>> LimboSpatialIndex::indices;
+
+bool LimboSpatialIndex::get_node_position(const Node *p_node, Vector3 &r_position) {
+	if (const Node3D *node_3d = Object::cast_to<Node3D>(p_node)) {
+		r_position = node_3d->get_global_position();
+		return true;
+	}
+	if (const Node2D *node_2d = Object::cast_to<Node2D>(p_node)) {
+		const Vector2 position = node_2d->get_global_position();
+		r_position = Vector3(position.x, position.y, 0.0);
+		return true;
+	}
+	return false;
+}
+
+LimboSpatialIndex *LimboSpatialIndex::get(const StringName &p_group, real_t p_radius) {
+	ERR_FAIL_COND_V(p_radius <= 0.0, nullptr);
+	// Cell sizes are rounded up to a power of two, so that queries with similar radii share an index,
+	// and a query never needs more than the 3x3x3 block of cells around its position.
+	const int exponent = int(Math::ceil(Math::log(double(p_radius)) / Math_LN2));
+
+	HashMap<StringName, HashMap<int, LimboSpatialIndex>>::Iterator E = indices.find(p_group);
+	if (!E) {
+		E = indices.insert(p_group, HashMap<int, LimboSpatialIndex>());
+	}
+	HashMap<int, LimboSpatialIndex>::Iterator I = E->value.find(exponent);
+	if (!I) {
+		I = E->value.insert(exponent, LimboSpatialIndex());
+		I->value.cell_size = Math::pow(2.0, double(exponent));
+	}
+
+	LimboSpatialIndex *index = &I->value;
+	const uint64_t process_frame = Engine::get_singleton()->get_process_frames();
+	const uint64_t physics_frame = Engine::get_singleton()->get_physics_frames();
+	if (index->built_process_frame != process_frame || index->built_physics_frame != physics_frame) {
+		index->_build(p_group);
+		index->built_process_frame = process_frame;
+		index->built_physics_frame = physics_frame;
+	}
+	return index;
+}
+
+void LimboSpatialIndex::clear() {
+	indices.clear();
+}
+
+void LimboSpatialIndex::_build(const StringName &p_group) {
+	entries.clear();
+	cells.clear();
+	flat = true;
+
+	SceneTree *tree = SCENE_TREE();
+	ERR_FAIL_NULL(tree);
+#ifdef LIMBOAI_MODULE
+	List<Node *> members;
+	tree->get_nodes_in_group(p_group, &members);
+	for (const Node *member : members) {
+#elif LIMBOAI_GDEXTENSION
+	TypedArray<Node> members = tree->get_nodes_in_group(p_group);
+	for (int i = 0; i < members.size(); i++) {
+		const Node *member = Object::cast_to<Node>(members[i]);
+#endif
+		Entry entry;
+		if (get_node_position(member, entry.position)) {
+			entry.node_id = member->get_instance_id();
+			flat = flat && entry.position.z == 0.0;
+			entries.push_back(entry);
+		}
+	}
+
+	// Entries of a cell are kept contiguous, so that queries scan short runs of memory.
+	struct EntryCellCompare {
+		real_t cell_size = 1.0;
+		_FORCE_INLINE_ Vector3i cell_of(const Vector3 &p_position) const {
+			return Vector3i(Math::floor(p_position.x / cell_size), Math::floor(p_position.y / cell_size), Math::floor(p_position.z / cell_size));
+		}
+		_FORCE_INLINE_ bool operator()(const Entry &p_a, const Entry &p_b) const {
+			return cell_of(p_a.position) < cell_of(p_b.position);
+		}
+	};
+	SortArray<Entry, EntryCellCompare> sorter;
+	sorter.compare.cell_size = cell_size;
+	sorter.sort(entries.ptr(), entries.size());
+
+	for (uint32_t i = 0; i < entries.size(); i++) {
+		const Vector3i cell = _cell_of(entries[i].position);
+		HashMap<Vector3i, Cell>::Iterator C = cells.find(cell);
+		if (C) {
+			C->value.count += 1;
+		} else {
+			cells.insert(cell, Cell{ i, 1 });
+		}
+	}
+}
+
+Node *LimboSpatialIndex::find_nearest(const Vector3 &p_position, real_t p_radius, const Node *p_exclude) const {
+	const uint64_t exclude_id = p_exclude ? uint64_t(p_exclude->get_instance_id()) : 0;
+	const Vector3i center = _cell_of(p_position);
+	const int reach = int(Math::ceil(p_radius / cell_size));
+
+	real_t best_distance = p_radius * p_radius;
+	uint64_t best_id = 0;
+	for (int x = center.x - reach; x <= center.x + reach; x++) {
+		for (int y = center.y - reach; y <= center.y + reach; y++) {
+			for (int z = flat ? 0 : center.z - reach; z <= (flat ? 0 : center.z + reach); z++) {
+				const Cell *cell = cells.getptr(Vector3i(x, y, z));
+				if (cell == nullptr) {
+					continue;
+				}
+				for (uint32_t i = cell->start; i < cell->start + cell->count; i++) {
+					const Entry &entry = entries[i];
+					const real_t distance = p_position.distance_squared_to(entry.position);
+					if (distance <= best_distance && entry.node_id != exclude_id) {
+						best_distance = distance;
+						best_id = entry.node_id;
+					}
+				}
+			}
+		}
+	}
+	// Members freed since the index was built are skipped by the ObjectDB lookup.
+	return best_id ? Object::cast_to<Node>(OBJECT_DB_GET_INSTANCE(best_id)) : nullptr;
+}
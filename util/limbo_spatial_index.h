@@ -0,0 +1,77 @@
+/**
+ * limbo_spatial_index.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef LIMBO_SPATIAL_INDEX_H
+#define LIMBO_SPATIAL_INDEX_H
+
+#ifdef LIMBOAI_MODULE
+#include "core/math/vector3.h"
+#include "core/math/vector3i.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "scene/main/node.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/node.hpp>
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/variant/vector3.hpp>
+#include <godot_cpp/variant/vector3i.hpp>
+using namespace godot;
+#endif // LIMBOAI_GDEXTENSION
+
+// Spatial hash of the Node2D and Node3D members of a SceneTree group, shared by perception tasks.
+// Built at most once per frame for each group and cell size, on the first query, so that all agents
+// querying the same group in a frame share one pass over the group instead of issuing their own queries.
+// 2D positions are stored with z = 0. Main thread only.
+class LimboSpatialIndex {
+private:
+	struct Entry {
+		Vector3 position;
+		uint64_t node_id = 0;
+	};
+
+	struct Cell {
+		uint32_t start = 0;
+		uint32_t count = 0;
+	};
+
+	// Indices per group, by the exponent of their cell size.
+	static HashMap<StringName, HashMap<int, LimboSpatialIndex>> indices;
+
+	real_t cell_size = 1.0;
+	uint64_t built_process_frame = UINT64_MAX;
+	uint64_t built_physics_frame = UINT64_MAX;
+	LocalVector<Entry> entries; // Sorted by cell.
+	HashMap<Vector3i, Cell> cells;
+	bool flat = true; // All entries are in the z = 0 layer, e.g. 2D nodes.
+
+	void _build(const StringName &p_group);
+	_FORCE_INLINE_ Vector3i _cell_of(const Vector3 &p_position) const {
+		return Vector3i(Math::floor(p_position.x / cell_size), Math::floor(p_position.y / cell_size), Math::floor(p_position.z / cell_size));
+	}
+
+public:
+	// Returns false if the node is neither a Node2D nor a Node3D.
+	static bool get_node_position(const Node *p_node, Vector3 &r_position);
+
+	// Returns the index of the group, suitable for queries with radii up to p_radius. Rebuilt if it is out of date.
+	static LimboSpatialIndex *get(const StringName &p_group, real_t p_radius);
+	static void clear();
+
+	// Nearest member within p_radius of p_position, ignoring p_exclude. Returns nullptr if there is none.
+	Node *find_nearest(const Vector3 &p_position, real_t p_radius, const Node *p_exclude = nullptr) const;
+
+	_FORCE_INLINE_ uint32_t get_entry_count() const { return entries.size(); }
+};
+
+#endif // LIMBO_SPATIAL_INDEX_H
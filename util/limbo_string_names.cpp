@@ -24,11 +24,25 @@
 
 #endif // ! LIMBOAI_GDEXTENSION
 
-LimboStringNames *LimboStringNames::singleton = nullptr;
+alignas(LimboStringNames) uint8_t limbo_string_names_storage[sizeof(LimboStringNames)];
+
+void LimboStringNames::create() {
+	memnew_placement(limbo_string_names_storage, LimboStringNames);
+}
+
+void LimboStringNames::free() {
+	get_singleton()->~LimboStringNames();
+}
 
 LimboStringNames::LimboStringNames() {
+	_considerations_ = SN("_considerations_");
+	_enter = SN("_enter");
+	_exit = SN("_exit");
 	_generate_name = SN("_generate_name");
+	_input = SN("_input");
+	_plan_action_ = SN("_plan_action_");
 	_replace_task = SN("_replace_task");
+	_tick = SN("_tick");
 	_update_task_tree = SN("_update_task_tree");
 	_weight_ = SN("_weight_");
 	accent_color = SN("accent_color");
@@ -39,6 +53,8 @@ LimboStringNames::LimboStringNames() {
 	Add = SN("Add");
 	add_child = SN("add_child");
 	add_child_at_index = SN("add_child_at_index");
+	animation_changed = SN("animation_changed");
+	animation_finished = SN("animation_finished");
 	AnimationFilter = SN("AnimationFilter");
 	behavior_tree_finished = SN("behavior_tree_finished");
 	bold = SN("bold");
@@ -46,6 +62,7 @@ LimboStringNames::LimboStringNames() {
 	button_up = SN("button_up");
 	call_deferred = SN("call_deferred");
 	changed = SN("changed");
+	completed = SN("completed");
 	dark_color_2 = SN("dark_color_2");
 	Debug = SN("Debug");
 	disabled_font_color = SN("disabled_font_color");
@@ -59,6 +76,8 @@ LimboStringNames::LimboStringNames() {
 	EditorIcons = SN("EditorIcons");
 	EditorStyles = SN("EditorStyles");
 	entered = SN("entered");
+	erased = SN("erased");
+	error_color = SN("error_color");
 	error_value = SN("error_value");
 	EVENT_FAILURE = SN("failure");
 	EVENT_FINISHED = SN("finished");
@@ -66,6 +85,7 @@ LimboStringNames::LimboStringNames() {
 	exited = SN("exited");
 	favorite_tasks_changed = SN("favorite_tasks_changed");
 	Favorites = SN("Favorites");
+	filesystem_changed = SN("filesystem_changed");
 	focus_exited = SN("focus_exited");
 	font = SN("font");
 	font_color = SN("font_color");
@@ -80,7 +100,10 @@ LimboStringNames::LimboStringNames() {
 	icon_max_width = SN("icon_max_width");
 	class_icon_size = SN("class_icon_size");
 	id_pressed = SN("id_pressed");
+	index_updated = SN("index_updated");
 	Info = SN("Info");
+	instantiated = SN("instantiated");
+	item_activated = SN("item_activated");
 	item_collapsed = SN("item_collapsed");
 	item_selected = SN("item_selected");
 	LimboVarAdd = SN("LimboVarAdd");
@@ -91,6 +114,7 @@ LimboStringNames::LimboStringNames() {
 	LimboVarPrivate = SN("LimboVarPrivate");
 	LineEdit = SN("LineEdit");
 	Load = SN("Load");
+	lod_changed = SN("lod_changed");
 	managed = SN("managed");
 	mode_changed = SN("mode_changed");
 	mouse_entered = SN("mouse_entered");
@@ -103,22 +127,28 @@ LimboStringNames::LimboStringNames() {
 	NonFavorite = SN("NonFavorite");
 	normal = SN("normal");
 	panel = SN("panel");
+	physics_frame = SN("physics_frame");
 	plan_changed = SN("plan_changed");
 	popup_hide = SN("popup_hide");
 	pressed = SN("pressed");
 	probability_clicked = SN("probability_clicked");
+	process_frame = SN("process_frame");
 	Reload = SN("Reload");
 	Remove = SN("Remove");
 	remove_child = SN("remove_child");
 	Rename = SN("Rename");
 	request_open_in_screen = SN("request_open_in_screen");
+	resized = SN("resized");
 	rmb_pressed = SN("rmb_pressed");
 	Save = SN("Save");
 	Script = SN("Script");
 	ScriptCreate = SN("ScriptCreate");
 	Search = SN("Search");
 	separation = SN("separation");
+	sequence = SN("sequence");
+	set = SN("set");
 	set_custom_name = SN("set_custom_name");
+	set_indexed = SN("set_indexed");
 	set_root_task = SN("set_root_task");
 	set_v_scroll = SN("set_v_scroll");
 	setup = SN("setup");
@@ -128,6 +158,7 @@ LimboStringNames::LimboStringNames() {
 	task_activated = SN("task_activated");
 	task_button_pressed = SN("task_button_pressed");
 	task_button_rmb = SN("task_button_rmb");
+	task_costs_changed = SN("task_costs_changed");
 	tasks_dragged = SN("tasks_dragged");
 	task_meta = SN("task_meta");
 	task_selected = SN("task_selected");
@@ -137,9 +168,13 @@ LimboStringNames::LimboStringNames() {
 	toggled = SN("toggled");
 	Tools = SN("Tools");
 	Tree = SN("Tree");
+	tree_exited = SN("tree_exited");
 	TripleBar = SN("TripleBar");
+	update_interval = SN("update_interval");
 	update_mode = SN("update_mode");
 	updated = SN("updated");
+	value_changed = SN("value_changed");
+	values = SN("values");
 	visibility_changed = SN("visibility_changed");
 	window_visibility_changed = SN("window_visibility_changed");
 
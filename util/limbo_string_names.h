@@ -30,21 +30,22 @@ class LimboStringNames {
 	friend void initialize_limboai_module(ModuleInitializationLevel p_level);
 	friend void uninitialize_limboai_module(ModuleInitializationLevel p_level);
 
-	static LimboStringNames *singleton;
-
-	static void create() { singleton = memnew(LimboStringNames); }
-	static void free() {
-		memdelete(singleton);
-		singleton = nullptr;
-	}
+	static void create();
+	static void free();
 
 	LimboStringNames();
 
 public:
-	_FORCE_INLINE_ static LimboStringNames *get_singleton() { return singleton; }
+	_FORCE_INLINE_ static LimboStringNames *get_singleton();
 
+	StringName _considerations_;
+	StringName _enter;
+	StringName _exit;
 	StringName _generate_name;
+	StringName _input;
+	StringName _plan_action_;
 	StringName _replace_task;
+	StringName _tick;
 	StringName _update_task_tree;
 	StringName _weight_;
 	StringName accent_color;
@@ -55,6 +56,8 @@ public:
 	StringName add_child_at_index;
 	StringName add_child;
 	StringName Add;
+	StringName animation_changed;
+	StringName animation_finished;
 	StringName AnimationFilter;
 	StringName behavior_tree_finished;
 	StringName bold;
@@ -62,6 +65,7 @@ public:
 	StringName button_up;
 	StringName call_deferred;
 	StringName changed;
+	StringName completed;
 	StringName dark_color_2;
 	StringName Debug;
 	StringName disabled_font_color;
@@ -75,6 +79,8 @@ public:
 	StringName EditorIcons;
 	StringName EditorStyles;
 	StringName entered;
+	StringName erased;
+	StringName error_color;
 	StringName error_value;
 	StringName EVENT_FAILURE;
 	StringName EVENT_FINISHED;
@@ -82,6 +88,7 @@ public:
 	StringName exited;
 	StringName favorite_tasks_changed;
 	StringName Favorites;
+	StringName filesystem_changed;
 	StringName focus_exited;
 	StringName font_color;
 	StringName font_size;
@@ -96,7 +103,10 @@ public:
 	StringName icon_max_width;
 	StringName class_icon_size;
 	StringName id_pressed;
+	StringName index_updated;
 	StringName Info;
+	StringName instantiated;
+	StringName item_activated;
 	StringName item_collapsed;
 	StringName item_selected;
 	StringName LimboVarAdd;
@@ -107,6 +117,7 @@ public:
 	StringName LimboVarPrivate;
 	StringName LineEdit;
 	StringName Load;
+	StringName lod_changed;
 	StringName managed;
 	StringName mode_changed;
 	StringName mouse_entered;
@@ -119,22 +130,28 @@ public:
 	StringName NonFavorite;
 	StringName normal;
 	StringName panel;
+	StringName physics_frame;
 	StringName plan_changed;
 	StringName popup_hide;
 	StringName pressed;
 	StringName probability_clicked;
+	StringName process_frame;
 	StringName Reload;
 	StringName remove_child;
 	StringName Remove;
 	StringName Rename;
 	StringName request_open_in_screen;
+	StringName resized;
 	StringName rmb_pressed;
 	StringName Save;
 	StringName Script;
 	StringName ScriptCreate;
 	StringName Search;
 	StringName separation;
+	StringName sequence;
+	StringName set;
 	StringName set_custom_name;
+	StringName set_indexed;
 	StringName set_root_task;
 	StringName set_v_scroll;
 	StringName setup;
@@ -144,6 +161,7 @@ public:
 	StringName task_activated;
 	StringName task_button_pressed;
 	StringName task_button_rmb;
+	StringName task_costs_changed;
 	StringName tasks_dragged;
 	StringName task_meta;
 	StringName task_selected;
@@ -153,9 +171,13 @@ public:
 	StringName toggled;
 	StringName Tools;
 	StringName Tree;
+	StringName tree_exited;
 	StringName TripleBar;
+	StringName update_interval;
 	StringName update_mode;
 	StringName updated;
+	StringName value_changed;
+	StringName values;
 	StringName visibility_changed;
 	StringName window_visibility_changed;
 
@@ -165,6 +187,15 @@ public:
 	NodePath node_pp;
 };
 
+// The names are constructed in place at module initialization. With a fixed address, LW_NAME() compiles to
+// a direct reference instead of loading a singleton pointer first. Names are returned by reference - bind them
+// to "const StringName &" rather than copying, as copies touch the atomic refcount.
+alignas(LimboStringNames) extern uint8_t limbo_string_names_storage[sizeof(LimboStringNames)];
+
+_FORCE_INLINE_ LimboStringNames *LimboStringNames::get_singleton() {
+	return reinterpret_cast<LimboStringNames *>(limbo_string_names_storage);
+}
+
 #define LW_NAME(m_arg) LimboStringNames::get_singleton()->m_arg
 
 #endif // LIMBO_STRING_NAMES_H
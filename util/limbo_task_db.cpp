@@ -19,13 +19,34 @@
 #endif // LIMBOAI_MODULE
 
 #ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/class_db_singleton.hpp>
 #include <godot_cpp/classes/dir_access.hpp>
 #include <godot_cpp/classes/project_settings.hpp>
 using namespace godot;
 #endif // LIMBOAI_GDEXTENSION
 
+LocalVector<LimboTaskDB::CoreTask> LimboTaskDB::registered_tasks;
 HashMap<String, List<String>> LimboTaskDB::core_tasks;
 HashMap<String, List<String>> LimboTaskDB::tasks_cache;
+HashSet<StringName> LimboTaskDB::thread_safe_tasks;
+HashSet<StringName> LimboTaskDB::pure_tasks;
+HashMap<StringName, uint32_t> LimboTaskDB::task_sizes;
+HashMap<String, PackedStringArray> LimboTaskDB::user_tasks;
+PackedStringArray LimboTaskDB::user_task_dirs;
+bool LimboTaskDB::user_tasks_dirty = true;
+uint32_t LimboTaskDB::tasks_version = 0;
+
+namespace {
+
+// Sort key is computed once per entry, not on every comparison.
+struct TaskSortEntry {
+	String name;
+	String class_or_path;
+
+	bool operator<(const TaskSortEntry &p_other) const { return name < p_other.name; }
+};
+
+} // namespace
 
 _FORCE_INLINE_ void _populate_scripted_tasks_from_dir(String p_path, List<String> *p_task_classes) {
 	if (p_path.is_empty()) {
@@ -88,21 +109,105 @@ _FORCE_INLINE_ void _populate_from_user_dir(String p_path, HashMap<String, List<
 	}
 }
 
-void LimboTaskDB::scan_user_tasks() {
-	tasks_cache = HashMap<String, List<String>>(core_tasks);
+List<String> LimboTaskDB::_sort_by_task_name(const List<String> *p_core, const PackedStringArray &p_user) {
+	LocalVector<TaskSortEntry> entries;
+	if (p_core) {
+		for (const String &task : *p_core) {
+			entries.push_back({ get_task_name(task), task });
+		}
+	}
+	for (int i = 0; i < p_user.size(); i++) {
+		entries.push_back({ get_task_name(p_user[i]), p_user[i] });
+	}
+	entries.sort();
+
+	List<String> r_tasks;
+	for (const TaskSortEntry &entry : entries) {
+		r_tasks.push_back(entry.class_or_path);
+	}
+	return r_tasks;
+}
 
-	if (!tasks_cache.has(LimboTaskDB::get_misc_category())) {
-		tasks_cache[LimboTaskDB::get_misc_category()] = List<String>();
+void LimboTaskDB::_build_core_tasks() {
+	for (const CoreTask &task : registered_tasks) {
+		const String category = task.get_category();
+		HashMap<String, List<String>>::Iterator E = core_tasks.find(category);
+		if (E) {
+			E->value.push_back(task.class_name);
+		} else {
+			List<String> tasks;
+			tasks.push_back(task.class_name);
+			core_tasks.insert(category, tasks);
+		}
+		// * Rebuilt by the scan.
+		tasks_cache.erase(category);
 	}
+	registered_tasks.clear();
+}
 
+bool LimboTaskDB::scan_user_tasks() {
+	if (!registered_tasks.is_empty()) {
+		_build_core_tasks();
+	}
+	PackedStringArray dirs;
 	for (int i = 1; i < 4; i++) {
-		String dir1 = ProjectSettings::get_singleton()->get_setting_with_override("limbo_ai/behavior_tree/user_task_dir_" + itos(i));
-		_populate_from_user_dir(dir1, &tasks_cache);
+		dirs.push_back(ProjectSettings::get_singleton()->get_setting_with_override("limbo_ai/behavior_tree/user_task_dir_" + itos(i)));
+	}
+	if (!user_tasks_dirty && dirs == user_task_dirs) {
+		return false;
+	}
+	user_tasks_dirty = false;
+	user_task_dirs = dirs;
+
+	HashMap<String, List<String>> found;
+	found[LimboTaskDB::get_misc_category()] = List<String>();
+	for (int i = 0; i < dirs.size(); i++) {
+		_populate_from_user_dir(dirs[i], &found);
 	}
 
-	for (KeyValue<String, List<String>> &E : tasks_cache) {
-		E.value.sort_custom<ComparatorByTaskName>();
+	HashMap<String, PackedStringArray> new_user_tasks;
+	for (const KeyValue<String, List<String>> &E : found) {
+		PackedStringArray paths;
+		for (const String &path : E.value) {
+			paths.push_back(path);
+		}
+		paths.sort();
+		new_user_tasks.insert(E.key, paths);
+	}
+
+	bool changed = false;
+	for (const KeyValue<String, PackedStringArray> &E : new_user_tasks) {
+		const PackedStringArray *prev = user_tasks.getptr(E.key);
+		if (prev && *prev == E.value && tasks_cache.has(E.key)) {
+			continue;
+		}
+		tasks_cache[E.key] = _sort_by_task_name(core_tasks.getptr(E.key), E.value);
+		changed = true;
+	}
+	for (const KeyValue<String, PackedStringArray> &E : user_tasks) {
+		if (new_user_tasks.has(E.key)) {
+			continue;
+		}
+		// * Category directory is gone: keep only core tasks, if there are any.
+		if (core_tasks.has(E.key)) {
+			tasks_cache[E.key] = _sort_by_task_name(core_tasks.getptr(E.key), PackedStringArray());
+		} else {
+			tasks_cache.erase(E.key);
+		}
+		changed = true;
+	}
+	for (const KeyValue<String, List<String>> &E : core_tasks) {
+		if (!tasks_cache.has(E.key)) {
+			tasks_cache[E.key] = _sort_by_task_name(&E.value, PackedStringArray());
+			changed = true;
+		}
+	}
+
+	user_tasks = new_user_tasks;
+	if (changed) {
+		tasks_version++;
 	}
+	return changed;
 }
 
 List<String> LimboTaskDB::get_categories() {
@@ -117,3 +222,19 @@ List<String> LimboTaskDB::get_categories() {
 List<String> LimboTaskDB::get_tasks_in_category(const String &p_category) {
 	return List<String>(tasks_cache[p_category]);
 }
+
+uint32_t LimboTaskDB::get_task_size(const StringName &p_class) {
+	StringName class_name = p_class;
+	while (class_name != StringName()) {
+		const uint32_t *size = task_sizes.getptr(class_name);
+		if (size) {
+			return *size;
+		}
+#ifdef LIMBOAI_MODULE
+		class_name = ClassDB::get_parent_class(class_name);
+#elif LIMBOAI_GDEXTENSION
+		class_name = ClassDBSingleton::get_singleton()->get_parent_class(class_name);
+#endif
+	}
+	return 0;
+}
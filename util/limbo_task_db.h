@@ -15,43 +15,77 @@
 #ifdef LIMBOAI_MODULE
 #include "core/object/class_db.h"
 #include "core/templates/hash_map.h"
+#include "core/templates/hash_set.h"
 #include "core/templates/list.h"
+#include "core/templates/local_vector.h"
+#include "core/variant/variant.h"
 #endif // LIMBOAI_MODULE
 
 #ifdef LIMBOAI_GDEXTENSION
 #include <godot_cpp/core/class_db.hpp>
 #include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/hash_set.hpp>
 #include <godot_cpp/templates/list.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/variant/packed_string_array.hpp>
 #include <godot_cpp/variant/string.hpp>
 using namespace godot;
 #endif // LIMBOAI_GDEXTENSION
 
 class LimboTaskDB {
 private:
+	struct CoreTask {
+		StringName class_name;
+		String (*get_category)();
+	};
+
+	// * Categories are only needed by the editor - core_tasks is built from this list on the first scan.
+	static LocalVector<CoreTask> registered_tasks;
 	static HashMap<String, List<String>> core_tasks;
 	static HashMap<String, List<String>> tasks_cache;
+	static HashSet<StringName> thread_safe_tasks;
+	static HashSet<StringName> pure_tasks;
+	static HashMap<StringName, uint32_t> task_sizes;
 
-	struct ComparatorByTaskName {
-		bool operator()(const String &p_left, const String &p_right) const {
-			return get_task_name(p_left) < get_task_name(p_right);
-		}
-	};
+	// Scripts found in user task directories during the last scan, per category, sorted by path.
+	static HashMap<String, PackedStringArray> user_tasks;
+	static PackedStringArray user_task_dirs;
+	static bool user_tasks_dirty;
+	static uint32_t tasks_version;
+
+	static List<String> _sort_by_task_name(const List<String> *p_core, const PackedStringArray &p_user);
+	static void _build_core_tasks();
 
 public:
 	template <class T>
 	static void register_task() {
 		GDREGISTER_CLASS(T);
-		HashMap<String, List<String>>::Iterator E = core_tasks.find(T::get_task_category());
-		if (E) {
-			E->value.push_back(T::get_class_static());
-		} else {
-			List<String> tasks;
-			tasks.push_back(T::get_class_static());
-			core_tasks.insert(T::get_task_category(), tasks);
+		registered_tasks.push_back({ T::get_class_static(), &T::get_task_category });
+		if (T::is_task_thread_safe()) {
+			thread_safe_tasks.insert(T::get_class_static());
+		}
+		if (T::is_task_pure()) {
+			pure_tasks.insert(T::get_class_static());
 		}
+		task_sizes.insert(T::get_class_static(), sizeof(T));
 	}
 
-	static void scan_user_tasks();
+	// Size of a task object of this class, or of its closest registered base class (e.g. for scripted tasks).
+	static uint32_t get_task_size(const StringName &p_class);
+
+	// Returns true if tasks of this class can be ticked outside of the main thread.
+	static _FORCE_INLINE_ bool is_task_thread_safe(const StringName &p_class) { return thread_safe_tasks.has(p_class); }
+
+	// Returns true if the outcome of ticking tasks of this class depends only on their saved state and the blackboard.
+	static _FORCE_INLINE_ bool is_task_pure(const StringName &p_class) { return pure_tasks.has(p_class); }
+
+	// Rescans user task directories if they were invalidated or changed in the project settings.
+	// Task category lists are built on the first call, so games that never show them don't pay for them.
+	// Only categories whose scripts were added or removed are rebuilt. Returns true if any task list changed.
+	static bool scan_user_tasks();
+	static void invalidate_user_tasks() { user_tasks_dirty = true; }
+	// Incremented every time a scan changes the task lists.
+	static _FORCE_INLINE_ uint32_t get_tasks_version() { return tasks_version; }
 	static _FORCE_INLINE_ String get_misc_category() { return "Misc"; }
 	static List<String> get_categories();
 	static List<String> get_tasks_in_category(const String &p_category);
@@ -81,4 +115,25 @@ public:                                                \
                                                        \
 private:
 
+// Marks a task class as safe to tick on a worker thread: it doesn't touch the scene
+// directly and only mutates its own state and the blackboard.
+#define TASK_THREAD_SAFE()                             \
+public:                                                \
+	static _FORCE_INLINE_ bool is_task_thread_safe() { \
+		return true;                                   \
+	}                                                  \
+                                                       \
+private:
+
+// Marks a task class as pure: it reads and writes nothing but the blackboard and the runtime state
+// that it saves in snapshots, so two instances in the same state produce the same result.
+// Pure tasks must also be thread-safe.
+#define TASK_PURE()                             \
+public:                                         \
+	static _FORCE_INLINE_ bool is_task_pure() { \
+		return true;                            \
+	}                                           \
+                                                \
+private:
+
 #endif // LIMBO_TASK_DB_H
@@ -0,0 +1,58 @@
+/**
+ * limbo_ticks.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "limbo_ticks.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/os/os.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/time.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+double LimboTicks::usec_per_tick = 1.0;
+uint64_t LimboTicks::origin_ticks = 0;
+uint64_t LimboTicks::origin_usec = 0;
+
+uint64_t LimboTicks::_get_os_usec() {
+#ifdef LIMBOAI_MODULE
+	return OS::get_singleton()->get_ticks_usec();
+#elif LIMBOAI_GDEXTENSION
+	return Time::get_singleton()->get_ticks_usec();
+#endif
+}
+
+void LimboTicks::initialize() {
+#ifdef LIMBO_TICKS_TSC
+	origin_usec = _get_os_usec();
+	origin_ticks = now();
+	uint64_t usec = origin_usec;
+	while (usec - origin_usec < 500) {
+		usec = _get_os_usec();
+	}
+	const uint64_t ticks = now() - origin_ticks;
+	if (ticks > 0) {
+		usec_per_tick = double(usec - origin_usec) / double(ticks);
+	}
+#endif
+}
+
+void LimboTicks::calibrate() {
+#ifdef LIMBO_TICKS_TSC
+	const uint64_t ticks = now() - origin_ticks;
+	const uint64_t usec = _get_os_usec() - origin_usec;
+	// * A longer base makes the rate more precise - skip until the OS clock granularity no longer matters.
+	if (origin_ticks != 0 && usec > 100000 && ticks > 0) {
+		usec_per_tick = double(usec) / double(ticks);
+	}
+#endif
+}
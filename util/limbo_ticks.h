@@ -0,0 +1,68 @@
+/**
+ * limbo_ticks.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef LIMBO_TICKS_H
+#define LIMBO_TICKS_H
+
+#ifdef LIMBOAI_MODULE
+#include "core/typedefs.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/core/defs.hpp>
+using namespace godot;
+#endif // LIMBOAI_GDEXTENSION
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define LIMBO_TICKS_TSC
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+// Cheap monotonic counter for timing updates. On x86, it reads the time-stamp counter, converted to microseconds
+// at a rate calibrated against the OS clock. Elsewhere, ticks are microseconds of the OS clock.
+// Measure intervals with now() and convert their length with to_usec().
+class LimboTicks {
+private:
+	// * Written on the main thread between frames, read by updates during the frame.
+	static double usec_per_tick;
+	static uint64_t origin_ticks;
+	static uint64_t origin_usec;
+
+	static uint64_t _get_os_usec();
+
+public:
+	_FORCE_INLINE_ static uint64_t now() {
+#ifdef LIMBO_TICKS_TSC
+		return __rdtsc();
+#else
+		return _get_os_usec();
+#endif
+	}
+
+	_FORCE_INLINE_ static uint64_t to_usec(uint64_t p_ticks) {
+#ifdef LIMBO_TICKS_TSC
+		return uint64_t(double(p_ticks) * usec_per_tick);
+#else
+		return p_ticks;
+#endif
+	}
+
+	// Estimates the rate from a short spin. Call once at startup.
+	static void initialize();
+	// Refines the rate over the time since initialize(). Call on the main thread, e.g. once per frame.
+	static void calibrate();
+};
+
+#endif // LIMBO_TICKS_H
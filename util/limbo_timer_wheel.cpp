@@ -0,0 +1,148 @@
+/**
+ * limbo_timer_wheel.cpp
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#include "limbo_timer_wheel.h"
+
+#include "limbo_compat.h"
+#include "limbo_string_names.h"
+
+#ifdef LIMBOAI_MODULE
+#include "core/math/math_funcs.h"
+#include "scene/main/scene_tree.h"
+#include "scene/main/window.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/classes/scene_tree.hpp>
+#include <godot_cpp/classes/window.hpp>
+#include <godot_cpp/core/math.hpp>
+#endif // LIMBOAI_GDEXTENSION
+
+LimboTimerWheel LimboTimerWheel::game_wheel;
+LimboTimerWheel LimboTimerWheel::realtime_wheel;
+uint64_t LimboTimerWheel::connected_tree_id = 0;
+uint32_t LimboTimerWheel::last_timer_id = 0;
+
+LimboTimerWheel *LimboTimerWheel::get(bool p_process_always) {
+	return p_process_always ? &realtime_wheel : &game_wheel;
+}
+
+void LimboTimerWheel::_insert(const Timer &p_timer) {
+	if (p_timer.expiry_tick <= current_tick) {
+		// Only happens while cascading - the current tick slot is processed right after.
+		slots[0][current_tick & (NUM_SLOTS - 1)].push_back(p_timer);
+		return;
+	}
+	uint64_t delta = p_timer.expiry_tick - current_tick;
+	uint64_t expiry_tick = p_timer.expiry_tick;
+	int level = 0;
+	while (delta >= (uint64_t(1) << (SLOT_BITS * (level + 1)))) {
+		level += 1;
+		if (level == NUM_LEVELS - 1) {
+			break;
+		}
+	}
+	if (level == NUM_LEVELS - 1 && delta >= (uint64_t(1) << (SLOT_BITS * NUM_LEVELS))) {
+		// Too far in the future: park it in the last slot of the top level, it will be reinserted from there.
+		expiry_tick = current_tick + (uint64_t(1) << (SLOT_BITS * NUM_LEVELS)) - 1;
+	}
+	slots[level][(expiry_tick >> (SLOT_BITS * level)) & (NUM_SLOTS - 1)].push_back(p_timer);
+}
+
+void LimboTimerWheel::_cascade(int p_level) {
+	LocalVector<Timer> &slot = slots[p_level][(current_tick >> (SLOT_BITS * p_level)) & (NUM_SLOTS - 1)];
+	if (slot.is_empty()) {
+		return;
+	}
+	// Swapping buffers instead of copying, so that no slot loses its capacity.
+	firing.clear();
+	SWAP(firing, slot);
+	for (const Timer &timer : firing) {
+		_insert(timer);
+	}
+}
+
+void LimboTimerWheel::_advance(double p_delta) {
+	time += p_delta;
+	const uint64_t target_tick = uint64_t(time * TICKS_PER_SECOND);
+	if (num_timers == 0) {
+		// Positions are relative to the current tick - nothing to move.
+		current_tick = MAX(current_tick, target_tick);
+		return;
+	}
+	while (current_tick < target_tick) {
+		current_tick += 1;
+		for (int level = NUM_LEVELS - 1; level > 0; level--) {
+			if ((current_tick & ((uint64_t(1) << (SLOT_BITS * level)) - 1)) == 0) {
+				_cascade(level);
+			}
+		}
+
+		LocalVector<Timer> &slot = slots[0][current_tick & (NUM_SLOTS - 1)];
+		if (slot.is_empty()) {
+			continue;
+		}
+		firing.clear();
+		SWAP(firing, slot);
+		num_timers -= firing.size();
+		for (const Timer &timer : firing) {
+			Object *owner = OBJECT_DB_GET_INSTANCE(timer.owner_id);
+			if (owner) {
+				timer.func(owner, timer.id);
+			}
+		}
+		if (num_timers == 0) {
+			current_tick = target_tick;
+		}
+	}
+}
+
+uint32_t LimboTimerWheel::schedule(double p_delay, Object *p_owner, TimeoutFunc p_func) {
+	ERR_FAIL_NULL_V(p_owner, 0);
+	ERR_FAIL_NULL_V(p_func, 0);
+	_ensure_processing();
+
+	Timer timer;
+	// Rounding up, so that a timer never expires early.
+	timer.expiry_tick = MAX(uint64_t(Math::ceil((time + MAX(p_delay, 0.0)) * TICKS_PER_SECOND)), current_tick + 1);
+	timer.owner_id = p_owner->get_instance_id();
+	timer.func = p_func;
+	last_timer_id += 1;
+	if (last_timer_id == 0) {
+		last_timer_id = 1; // Zero is reserved for "no timer".
+	}
+	timer.id = last_timer_id;
+	_insert(timer);
+	num_timers += 1;
+	return timer.id;
+}
+
+void LimboTimerWheel::process(double p_delta, bool p_paused) {
+	realtime_wheel._advance(p_delta);
+	if (!p_paused) {
+		game_wheel._advance(p_delta);
+	}
+}
+
+void LimboTimerWheel::_ensure_processing() {
+	SceneTree *tree = SCENE_TREE();
+	if (tree == nullptr || uint64_t(tree->get_instance_id()) == connected_tree_id) {
+		return;
+	}
+	tree->connect(LW_NAME(process_frame), callable_mp_static(&LimboTimerWheel::_on_process_frame));
+	connected_tree_id = tree->get_instance_id();
+}
+
+void LimboTimerWheel::_on_process_frame() {
+	SceneTree *tree = SCENE_TREE();
+	ERR_FAIL_NULL(tree);
+	process(tree->get_root()->get_process_delta_time(), tree->is_paused());
+}
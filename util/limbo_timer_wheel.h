@@ -0,0 +1,84 @@
+/**
+ * limbo_timer_wheel.h
+ * =============================================================================
+ * Copyright 2021-2024 Serhii Snitsaruk
+ *
+ * Use of this source code is governed by an MIT-style
+ * license that can be found in the LICENSE file or at
+ * https://opensource.org/licenses/MIT.
+ * =============================================================================
+ */
+
+#ifndef LIMBO_TIMER_WHEEL_H
+#define LIMBO_TIMER_WHEEL_H
+
+#ifdef LIMBOAI_MODULE
+#include "core/object/object.h"
+#include "core/templates/local_vector.h"
+#endif // LIMBOAI_MODULE
+
+#ifdef LIMBOAI_GDEXTENSION
+#include <godot_cpp/core/object.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+using namespace godot;
+#endif // LIMBOAI_GDEXTENSION
+
+// Hierarchical timer wheel shared by LimboAI tasks, advanced once per process frame.
+// There are two clocks: one stops while the SceneTree is paused, the other one doesn't.
+// Scheduling a timer doesn't allocate once the wheel has warmed up. Main thread only.
+class LimboTimerWheel {
+public:
+	// Called on expiry with the owner that scheduled the timer, unless the owner was freed.
+	typedef void (*TimeoutFunc)(Object *p_owner, uint32_t p_timer_id);
+
+private:
+	static constexpr int TICKS_PER_SECOND = 64;
+	static constexpr int SLOT_BITS = 6;
+	static constexpr int NUM_SLOTS = 1 << SLOT_BITS;
+	static constexpr int NUM_LEVELS = 4;
+
+	struct Timer {
+		uint64_t expiry_tick = 0;
+		uint64_t owner_id = 0;
+		TimeoutFunc func = nullptr;
+		uint32_t id = 0;
+	};
+
+	static LimboTimerWheel game_wheel;
+	static LimboTimerWheel realtime_wheel;
+	static uint64_t connected_tree_id;
+	static uint32_t last_timer_id;
+
+	double time = 0.0;
+	uint64_t current_tick = 0;
+	uint32_t num_timers = 0;
+	LocalVector<Timer> slots[NUM_LEVELS][NUM_SLOTS];
+	LocalVector<Timer> firing;
+
+	void _insert(const Timer &p_timer);
+	void _cascade(int p_level);
+	void _advance(double p_delta);
+
+	static void _ensure_processing();
+	static void _on_process_frame();
+
+public:
+	// Returns the wheel that keeps running while the SceneTree is paused if p_process_always is true.
+	static LimboTimerWheel *get(bool p_process_always);
+
+	// Seconds elapsed on this clock. Use as a timestamp, e.g. to store an expiry time.
+	_FORCE_INLINE_ double get_time() const {
+		_ensure_processing();
+		return time;
+	}
+	_FORCE_INLINE_ uint32_t get_timer_count() const { return num_timers; }
+
+	// Schedules p_func to be called after p_delay seconds. Returns an id passed to the callback.
+	// Timers can't be cancelled - owners should ignore callbacks with an id they no longer expect.
+	uint32_t schedule(double p_delay, Object *p_owner, TimeoutFunc p_func);
+
+	// Advances both clocks. Normally called by the SceneTree on every process frame.
+	static void process(double p_delta, bool p_paused);
+};
+
+#endif // LIMBO_TIMER_WHEEL_H
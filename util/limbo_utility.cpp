@@ -80,6 +80,28 @@ String LimboUtility::get_status_name(int p_status) const {
 Ref<Texture2D> LimboUtility::get_task_icon(String p_class_or_script_path) const {
 	ERR_FAIL_COND_V_MSG(p_class_or_script_path.is_empty(), Variant(), "BTTask: script path or class cannot be empty.");
 
+#if defined(TOOLS_ENABLED) && defined(LIMBOAI_MODULE)
+	if (Engine::get_singleton()->is_editor_hint()) {
+		// * Editor theme is recreated when editor settings change, invalidating its icons.
+		Ref<Theme> theme = EditorNode::get_singleton()->get_editor_theme();
+		const uint64_t theme_id = theme.is_valid() ? uint64_t(theme->get_instance_id()) : 0;
+		if (theme_id != icon_cache_theme_id) {
+			icon_cache.clear();
+			icon_cache_theme_id = theme_id;
+		}
+	}
+#endif // TOOLS_ENABLED && LIMBOAI_MODULE
+
+	HashMap<String, Ref<Texture2D>>::ConstIterator E = icon_cache.find(p_class_or_script_path);
+	if (E) {
+		return E->value;
+	}
+	Ref<Texture2D> icon = _find_task_icon(p_class_or_script_path);
+	icon_cache.insert(p_class_or_script_path, icon);
+	return icon;
+}
+
+Ref<Texture2D> LimboUtility::_find_task_icon(const String &p_class_or_script_path) const {
 #if defined(TOOLS_ENABLED) && defined(LIMBOAI_MODULE)
 	// * Using editor theme
 	if (Engine::get_singleton()->is_editor_hint()) {
@@ -297,6 +319,257 @@ Variant LimboUtility::perform_operation(Operation p_operation, const Variant &le
 	return ret;
 }
 
+template <typename T, Variant::Type V>
+static bool _check_typed(LimboUtility::CheckType p_check_type, const Variant &p_left, const Variant &p_right) {
+	if (unlikely(p_left.get_type() != V || p_right.get_type() != V)) {
+		return LimboUtility::get_singleton()->perform_check(p_check_type, p_left, p_right);
+	}
+	const T left = p_left;
+	const T right = p_right;
+	switch (p_check_type) {
+		case LimboUtility::CheckType::CHECK_EQUAL: {
+			return left == right;
+		}
+		case LimboUtility::CheckType::CHECK_LESS_THAN: {
+			return left < right;
+		}
+		case LimboUtility::CheckType::CHECK_LESS_THAN_OR_EQUAL: {
+			return left <= right;
+		}
+		case LimboUtility::CheckType::CHECK_GREATER_THAN: {
+			return left > right;
+		}
+		case LimboUtility::CheckType::CHECK_GREATER_THAN_OR_EQUAL: {
+			return left >= right;
+		}
+		case LimboUtility::CheckType::CHECK_NOT_EQUAL: {
+			return left != right;
+		}
+		default: {
+			return false;
+		}
+	}
+}
+
+static bool _check_variant(LimboUtility::CheckType p_check_type, const Variant &p_left, const Variant &p_right) {
+	return LimboUtility::get_singleton()->perform_check(p_check_type, p_left, p_right);
+}
+
+LimboUtility::CheckFunc LimboUtility::get_check_func(Variant::Type p_type) {
+	switch (p_type) {
+		case Variant::BOOL: {
+			return &_check_typed<bool, Variant::BOOL>;
+		}
+		case Variant::INT: {
+			return &_check_typed<int64_t, Variant::INT>;
+		}
+		case Variant::FLOAT: {
+			return &_check_typed<double, Variant::FLOAT>;
+		}
+		case Variant::VECTOR2: {
+			return &_check_typed<Vector2, Variant::VECTOR2>;
+		}
+		case Variant::VECTOR3: {
+			return &_check_typed<Vector3, Variant::VECTOR3>;
+		}
+		default: {
+			return &_check_variant;
+		}
+	}
+}
+
+// Only the arithmetic that can't fail is specialized; division and the rest keep Variant error handling.
+template <typename T, Variant::Type V>
+static Variant _operate_typed(LimboUtility::Operation p_operation, const Variant &p_left, const Variant &p_right) {
+	if (likely(p_left.get_type() == V && p_right.get_type() == V)) {
+		const T left = p_left;
+		const T right = p_right;
+		switch (p_operation) {
+			case LimboUtility::OPERATION_NONE: {
+				return p_right;
+			}
+			case LimboUtility::OPERATION_ADDITION: {
+				return left + right;
+			}
+			case LimboUtility::OPERATION_SUBTRACTION: {
+				return left - right;
+			}
+			case LimboUtility::OPERATION_MULTIPLICATION: {
+				return left * right;
+			}
+			default: {
+			} break;
+		}
+	}
+	return LimboUtility::get_singleton()->perform_operation(p_operation, p_left, p_right);
+}
+
+static Variant _operate_variant(LimboUtility::Operation p_operation, const Variant &p_left, const Variant &p_right) {
+	return LimboUtility::get_singleton()->perform_operation(p_operation, p_left, p_right);
+}
+
+LimboUtility::OperationFunc LimboUtility::get_operation_func(Variant::Type p_type) {
+	switch (p_type) {
+		case Variant::INT: {
+			return &_operate_typed<int64_t, Variant::INT>;
+		}
+		case Variant::FLOAT: {
+			return &_operate_typed<double, Variant::FLOAT>;
+		}
+		case Variant::VECTOR2: {
+			return &_operate_typed<Vector2, Variant::VECTOR2>;
+		}
+		case Variant::VECTOR3: {
+			return &_operate_typed<Vector3, Variant::VECTOR3>;
+		}
+		default: {
+			return &_operate_variant;
+		}
+	}
+}
+
+// Element-wise kernels: plain loops over contiguous memory, so that the compiler vectorizes them.
+template <typename T, typename R>
+static void _element_wise_value(LimboUtility::Operation p_operation, T *p_dst, int64_t p_count, const R p_right) {
+	switch (p_operation) {
+		case LimboUtility::OPERATION_ADDITION: {
+			for (int64_t i = 0; i < p_count; i++) {
+				p_dst[i] += p_right;
+			}
+		} break;
+		case LimboUtility::OPERATION_SUBTRACTION: {
+			for (int64_t i = 0; i < p_count; i++) {
+				p_dst[i] -= p_right;
+			}
+		} break;
+		case LimboUtility::OPERATION_MULTIPLICATION: {
+			for (int64_t i = 0; i < p_count; i++) {
+				p_dst[i] *= p_right;
+			}
+		} break;
+		case LimboUtility::OPERATION_DIVISION: {
+			for (int64_t i = 0; i < p_count; i++) {
+				p_dst[i] /= p_right;
+			}
+		} break;
+		default: {
+		} break;
+	}
+}
+
+// Vectors scaled by a number - only multiplication and division are defined.
+template <typename T>
+static void _element_wise_scale(LimboUtility::Operation p_operation, T *p_dst, int64_t p_count, const real_t p_right) {
+	if (p_operation == LimboUtility::OPERATION_MULTIPLICATION) {
+		for (int64_t i = 0; i < p_count; i++) {
+			p_dst[i] *= p_right;
+		}
+	} else {
+		for (int64_t i = 0; i < p_count; i++) {
+			p_dst[i] /= p_right;
+		}
+	}
+}
+
+template <typename T>
+static void _element_wise_array(LimboUtility::Operation p_operation, T *p_dst, const T *p_right, int64_t p_count) {
+	switch (p_operation) {
+		case LimboUtility::OPERATION_ADDITION: {
+			for (int64_t i = 0; i < p_count; i++) {
+				p_dst[i] += p_right[i];
+			}
+		} break;
+		case LimboUtility::OPERATION_SUBTRACTION: {
+			for (int64_t i = 0; i < p_count; i++) {
+				p_dst[i] -= p_right[i];
+			}
+		} break;
+		case LimboUtility::OPERATION_MULTIPLICATION: {
+			for (int64_t i = 0; i < p_count; i++) {
+				p_dst[i] *= p_right[i];
+			}
+		} break;
+		case LimboUtility::OPERATION_DIVISION: {
+			for (int64_t i = 0; i < p_count; i++) {
+				p_dst[i] /= p_right[i];
+			}
+		} break;
+		default: {
+		} break;
+	}
+}
+
+// A: packed array type, T: its element type and E its Variant type. Numbers are accepted as elements of numeric arrays, and scale
+// the elements of vector arrays. Integer arrays can't be divided, as elements may be zero.
+template <typename A, typename T, Variant::Type E, bool CAN_DIVIDE>
+static bool _perform_element_wise(LimboUtility::Operation p_operation, Variant &r_array, const Variant &p_right) {
+	if (!CAN_DIVIDE && p_operation == LimboUtility::OPERATION_DIVISION) {
+		return false;
+	}
+	constexpr bool IS_VECTOR = E != Variant::INT && E != Variant::FLOAT;
+	const Variant::Type right_type = p_right.get_type();
+	const bool is_number = right_type == Variant::INT || right_type == Variant::FLOAT;
+	const bool is_array = right_type == r_array.get_type();
+	const bool is_element = IS_VECTOR ? right_type == E : is_number;
+	const bool is_scale = IS_VECTOR && is_number && p_operation != LimboUtility::OPERATION_ADDITION && p_operation != LimboUtility::OPERATION_SUBTRACTION;
+	if (!is_array && !is_element && !is_scale) {
+		return false;
+	}
+
+	A array = r_array;
+	A right_array;
+	if (is_array) {
+		right_array = p_right;
+		if (right_array.size() != array.size()) {
+			return false;
+		}
+	}
+	// * Drops the stored reference, so that ptrw() doesn't copy the array (unless the operand shares it).
+	r_array = Variant();
+	T *dst = array.ptrw();
+	const int64_t count = array.size();
+	if (is_array) {
+		_element_wise_array(p_operation, dst, right_array.ptr(), count);
+	} else if (is_element) {
+		const T value = p_right;
+		_element_wise_value(p_operation, dst, count, value);
+	} else {
+		const real_t scale = p_right;
+		_element_wise_scale(p_operation, dst, count, scale);
+	}
+	r_array = array;
+	return true;
+}
+
+bool LimboUtility::perform_element_wise_operation(Operation p_operation, Variant &r_array, const Variant &p_right) {
+	if (p_operation < OPERATION_ADDITION || p_operation > OPERATION_DIVISION) {
+		return false;
+	}
+	switch (r_array.get_type()) {
+		case Variant::PACKED_FLOAT32_ARRAY: {
+			return _perform_element_wise<PackedFloat32Array, float, Variant::FLOAT, true>(p_operation, r_array, p_right);
+		}
+		case Variant::PACKED_FLOAT64_ARRAY: {
+			return _perform_element_wise<PackedFloat64Array, double, Variant::FLOAT, true>(p_operation, r_array, p_right);
+		}
+		case Variant::PACKED_INT32_ARRAY: {
+			return _perform_element_wise<PackedInt32Array, int32_t, Variant::INT, false>(p_operation, r_array, p_right);
+		}
+		case Variant::PACKED_INT64_ARRAY: {
+			return _perform_element_wise<PackedInt64Array, int64_t, Variant::INT, false>(p_operation, r_array, p_right);
+		}
+		case Variant::PACKED_VECTOR2_ARRAY: {
+			return _perform_element_wise<PackedVector2Array, Vector2, Variant::VECTOR2, true>(p_operation, r_array, p_right);
+		}
+		case Variant::PACKED_VECTOR3_ARRAY: {
+			return _perform_element_wise<PackedVector3Array, Vector3, Variant::VECTOR3, true>(p_operation, r_array, p_right);
+		}
+		default: {
+			return false;
+		}
+	}
+}
+
 String LimboUtility::get_property_hint_text(PropertyHint p_hint) const {
 	switch (p_hint) {
 		case PROPERTY_HINT_NONE: {
@@ -19,6 +19,7 @@
 
 #include "core/input/shortcut.h"
 #include "core/object/class_db.h"
+#include "core/templates/hash_map.h"
 #include "core/variant/binder_common.h"
 #include "core/variant/variant.h"
 #include "scene/resources/texture.h"
@@ -44,6 +45,12 @@ private:
 	HashMap<String, Ref<Shortcut>> shortcuts;
 #endif // TOOLS_ENABLED
 
+	// Resolved icons by class name or script path, including misses.
+	mutable HashMap<String, Ref<Texture2D>> icon_cache;
+	mutable uint64_t icon_cache_theme_id = 0;
+
+	Ref<Texture2D> _find_task_icon(const String &p_class_or_script_path) const;
+
 public:
 	enum CheckType : unsigned int {
 		CHECK_EQUAL,
@@ -69,6 +76,11 @@ public:
 		OPERATION_BIT_XOR,
 	};
 
+	// Specialized check/operation, selected once for the expected operand type.
+	// Falls back to perform_check()/perform_operation() if the operands don't match that type.
+	typedef bool (*CheckFunc)(CheckType p_check_type, const Variant &p_left, const Variant &p_right);
+	typedef Variant (*OperationFunc)(Operation p_operation, const Variant &p_left, const Variant &p_right);
+
 protected:
 	static LimboUtility *singleton;
 	static void _bind_methods();
@@ -80,6 +92,8 @@ public:
 	String decorate_output_var(String p_variable) const;
 	String get_status_name(int p_status) const;
 	Ref<Texture2D> get_task_icon(String p_class_or_script_path) const;
+	// Must be called when scripts change, as they may declare different icons or base types.
+	void clear_task_icon_cache() { icon_cache.clear(); }
 
 	String get_check_operator_string(CheckType p_check_type) const;
 	bool perform_check(CheckType p_check_type, const Variant &left_value, const Variant &right_value);
@@ -87,6 +101,13 @@ public:
 	String get_operation_string(Operation p_operation) const;
 	Variant perform_operation(Operation p_operation, const Variant &left_value, const Variant &right_value);
 
+	static CheckFunc get_check_func(Variant::Type p_type);
+	static OperationFunc get_operation_func(Variant::Type p_type);
+	// Applies addition, subtraction, multiplication or division to each element of a packed numeric or vector array,
+	// modifying r_array's storage in place. p_right is an array of the same type and size, a single element, or a number
+	// scaling vectors. Returns false, leaving r_array untouched, if the operands aren't supported.
+	static bool perform_element_wise_operation(Operation p_operation, Variant &r_array, const Variant &p_right);
+
 	String get_property_hint_text(PropertyHint p_hint) const;
 	PackedInt32Array get_property_hints_allowed_for_type(Variant::Type p_type) const;
 